@@ -132,6 +132,10 @@ public:
 
   bool IsHardware() const;
 
+  void SetFastTrace(bool fast_trace);
+
+  bool IsFastTrace() const;
+
   // Can only be called from a ScriptedBreakpointResolver...
   SBError
   AddLocation(SBAddress &address);
@@ -41,6 +41,10 @@ public:
 
   uint32_t GetHitCount();
 
+  uint64_t GetFastTraceHitCount();
+
+  lldb::SBStructuredData GetFastTraceRecords();
+
   uint32_t GetIgnoreCount();
 
   void SetIgnoreCount(uint32_t n);
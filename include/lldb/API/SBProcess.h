@@ -354,6 +354,20 @@ public:
 
   lldb::SBThreadCollection GetHistoryThreads(addr_t addr);
 
+  /// Unwind the stacks of all threads at once.
+  ///
+  /// The threads are unwound concurrently, see the "parallel-unwind"
+  /// process setting. Their frames can then be inspected without further
+  /// unwinding.
+  ///
+  /// \param[in] max_frames
+  ///   The number of frames to unwind per thread, or zero for all frames.
+  ///
+  /// \return
+  ///   All threads of the process, or an empty collection if the process
+  ///   isn't stopped.
+  lldb::SBThreadCollection GetThreadsWithBacktraces(uint32_t max_frames);
+
   bool IsInstrumentationRuntimePresent(InstrumentationRuntimeType type);
 
   /// Save the state of the process in a core file (or mini dump on Windows).
@@ -90,6 +90,7 @@ public:
 protected:
   friend class SBTraceOptions;
   friend class SBDebugger;
+  friend class SBBreakpointLocation;
   friend class SBTarget;
 
   StructuredDataImplUP m_impl_up;
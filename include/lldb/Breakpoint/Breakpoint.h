@@ -510,6 +510,12 @@ public:
 
   bool IsHardware() const { return m_hardware; }
 
+  /// Implement the locations of this breakpoint with fast tracepoints, which
+  /// record the hits without stopping the process. See FastTracepoint.
+  void SetFastTrace(bool fast_trace);
+
+  bool IsFastTrace() const { return m_fast_trace; }
+
   lldb::BreakpointResolverSP GetResolver() { return m_resolver_sp; }
 
   lldb::SearchFilterSP GetSearchFilter() { return m_filter_sp; }
@@ -637,6 +643,7 @@ private:
   bool m_being_created;
   bool
       m_hardware; // If this breakpoint is required to use a hardware breakpoint
+  bool m_fast_trace = false; // If this breakpoint uses fast tracepoints.
   Target &m_target; // The target that holds this breakpoint.
   std::unordered_set<std::string> m_name_list; // If not empty, this is the name
                                                // of this breakpoint (many
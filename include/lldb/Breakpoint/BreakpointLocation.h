@@ -13,6 +13,7 @@
 #include <mutex>
 
 #include "lldb/Breakpoint/BreakpointOptions.h"
+#include "lldb/Breakpoint/FastTracepoint.h"
 #include "lldb/Breakpoint/StoppointLocation.h"
 #include "lldb/Core/Address.h"
 #include "lldb/Utility/UserID.h"
@@ -177,6 +178,14 @@ public:
 
   lldb::BreakpointSiteSP GetBreakpointSite() const;
 
+  /// Read the number of hits the trampoline of this fast tracepoint counted.
+  /// Fast tracepoint hits aren't included in GetHitCount().
+  llvm::Expected<uint64_t> GetFastTraceHitCount();
+
+  /// Read the records of the hits of this fast tracepoint since the last
+  /// call and append them to \a records.
+  llvm::Error ReadFastTraceRecords(std::vector<FastTraceRecord> &records);
+
   // The next section are generic report functions.
 
   /// Print a description of this breakpoint location to the stream \a s.
@@ -341,6 +350,8 @@ private:
                                 /// multiple processes.
   size_t m_condition_hash; ///< For testing whether the condition source code
                            ///changed.
+  uint64_t m_fast_trace_next_record = 0; ///< The index of the first fast
+                                         ///tracepoint hit that wasn't read.
 
   void SetShouldResolveIndirectFunctions(bool do_resolve) {
     m_should_resolve_indirect_functions = do_resolve;
@@ -40,9 +40,25 @@ public:
                // m_saved_opcode
                // and m_trap_opcode contain the saved and written opcode.
     eHardware, // Breakpoint site is set as a hardware breakpoint
-    eExternal  // Breakpoint site is managed by an external debug nub or
+    eExternal, // Breakpoint site is managed by an external debug nub or
                // debug interface where memory reads transparently will not
                // display any breakpoint opcodes.
+    eFastTrace // The instructions at the site were replaced with a jump to a
+               // trampoline that records the hit without stopping, see
+               // FastTracepoint. m_saved_opcode contains the displaced
+               // instructions and m_trap_opcode the jump.
+  };
+
+  /// The inferior memory used by a fast tracepoint at this site.
+  struct FastTraceMemory {
+    /// The start of the allocation, where the trampoline is.
+    lldb::addr_t addr = LLDB_INVALID_ADDRESS;
+    /// The size of the allocation.
+    size_t size = 0;
+    /// The size of the trampoline.
+    size_t trampoline_size = 0;
+    /// The address of the buffer the trampoline records the hits in.
+    lldb::addr_t buffer_addr = LLDB_INVALID_ADDRESS;
   };
 
   ~BreakpointSite() override;
@@ -189,6 +205,12 @@ public:
 
   void SetType(BreakpointSite::Type type) { m_type = type; }
 
+  FastTraceMemory &GetFastTraceMemory() { return m_fast_trace_memory; }
+
+  const FastTraceMemory &GetFastTraceMemory() const {
+    return m_fast_trace_memory;
+  }
+
 private:
   friend class Process;
   friend class BreakpointLocation;
@@ -207,10 +229,12 @@ private:
   size_t RemoveOwner(lldb::break_id_t break_id, lldb::break_id_t break_loc_id);
 
   BreakpointSite::Type m_type; ///< The type of this breakpoint site.
-  uint8_t m_saved_opcode[8]; ///< The saved opcode bytes if this breakpoint site
-                             ///uses trap opcodes.
-  uint8_t m_trap_opcode[8];  ///< The opcode that was used to create the
-                             ///breakpoint if it is a software breakpoint site.
+  uint8_t m_saved_opcode[16]; ///< The saved opcode bytes if this breakpoint
+                              ///site uses trap opcodes.
+  uint8_t m_trap_opcode[16];  ///< The opcode that was used to create the
+                              ///breakpoint if it is a software breakpoint site.
+  FastTraceMemory m_fast_trace_memory; ///< The memory used if this is a fast
+                                       ///tracepoint.
   bool
       m_enabled; ///< Boolean indicating if this breakpoint site enabled or not.
 
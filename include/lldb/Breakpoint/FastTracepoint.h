@@ -0,0 +1,112 @@
+//===-- FastTracepoint.h ----------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_FastTracepoint_h_
+#define liblldb_FastTracepoint_h_
+
+#include <vector>
+
+#include "lldb/lldb-private.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/Error.h"
+
+namespace lldb_private {
+
+/// A hit recorded by a fast tracepoint.
+struct FastTraceRecord {
+  /// The number of hits of the tracepoint before this one.
+  uint64_t index;
+  /// The registers when the tracepoint was hit, in the order of
+  /// FastTracepoint::GetRegisterNames().
+  std::vector<uint64_t> registers;
+};
+
+/// \class FastTracepoint FastTracepoint.h "lldb/Breakpoint/FastTracepoint.h"
+/// Code generation and buffer layout of fast tracepoints.
+///
+/// A fast tracepoint replaces the instructions at a breakpoint site with a
+/// jump to a trampoline in the inferior. The trampoline counts the hit,
+/// records the registers in a ring buffer, runs the displaced instructions
+/// and jumps back, so the inferior never stops. The trampoline and the
+/// buffer share one allocation near the site, see
+/// Process::EnableFastTracepoint().
+///
+/// The buffer starts with a header of four 64-bit values: the number of
+/// hits, the number of records written, the number of records the buffer
+/// holds and the size of a record. The records follow. Each one starts with
+/// the number of hits up to and including its own, followed by the
+/// registers. The number is written last, a record whose number doesn't
+/// match its slot is incomplete or was overwritten.
+class FastTracepoint {
+public:
+  /// Whether fast tracepoints can be used in processes of \a arch.
+  static bool IsSupported(const ArchSpec &arch);
+
+  /// The names of the registers stored in a record.
+  static llvm::ArrayRef<const char *> GetRegisterNames();
+
+  /// Find the instructions at \a addr the jump to the trampoline replaces.
+  ///
+  /// \param[in] bytes
+  ///     The code at \a addr, at least GetMaxDisplacedSize() bytes unless
+  ///     the function ends earlier.
+  ///
+  /// \return
+  ///     The size of the instructions, or an error if they can't run at
+  ///     another address.
+  static llvm::Expected<size_t> GetDisplacedSize(const ArchSpec &arch,
+                                                 lldb::addr_t addr,
+                                                 llvm::ArrayRef<uint8_t> bytes);
+
+  /// The maximum number of bytes the jump to the trampoline can displace.
+  static size_t GetMaxDisplacedSize();
+
+  /// The maximum distance between the site and its trampoline.
+  static lldb::addr_t GetMaxDistance();
+
+  /// The jump to \a trampoline_addr that replaces \a displaced_size bytes at
+  /// \a addr.
+  static std::vector<uint8_t> BuildJump(lldb::addr_t addr,
+                                        size_t displaced_size,
+                                        lldb::addr_t trampoline_addr);
+
+  /// The trampoline for a tracepoint at \a addr.
+  ///
+  /// \param[in] trampoline_addr
+  ///     Where the trampoline will be written.
+  ///
+  /// \param[in] buffer_addr
+  ///     The address of the buffer header.
+  ///
+  /// \param[in] displaced
+  ///     The instructions the jump replaces.
+  static std::vector<uint8_t>
+  BuildTrampoline(lldb::addr_t addr, lldb::addr_t trampoline_addr,
+                  lldb::addr_t buffer_addr, llvm::ArrayRef<uint8_t> displaced);
+
+  /// The initial contents of the buffer header.
+  static std::vector<uint8_t> BuildBufferHeader();
+
+  /// The size of the buffer, including the header.
+  static size_t GetBufferSize();
+
+  /// Read the number of hits from the buffer at \a buffer_addr.
+  static llvm::Expected<uint64_t> ReadHitCount(Process &process,
+                                               lldb::addr_t buffer_addr);
+
+  /// Read the records of the hits from \a next_index on, and update \a
+  /// next_index to the first hit that wasn't read. Records that were
+  /// already overwritten are skipped.
+  static llvm::Error ReadRecords(Process &process, lldb::addr_t buffer_addr,
+                                 uint64_t &next_index,
+                                 std::vector<FastTraceRecord> &records);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_FastTracepoint_h_
@@ -0,0 +1,109 @@
+//===-- DataFileCache.h -----------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_DataFileCache_h_
+#define liblldb_DataFileCache_h_
+
+#include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/FileSpec.h"
+#include "lldb/lldb-forward.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <string>
+
+namespace lldb_private {
+
+/// \class DataFileCache DataFileCache.h "lldb/Core/DataFileCache.h"
+/// A directory of files that persist data derived from modules, like symbol
+/// tables or debug info indexes, across debug sessions.
+///
+/// Every file is named after a key chosen by the client, usually derived from
+/// the UUID of the module, and an extension identifying the kind of data.
+/// Clients are responsible for storing anything beyond the key that they need
+/// to validate the data.
+class DataFileCache {
+public:
+  /// \param[in] cache_dir
+  ///     The directory holding the cache files, created on demand.
+  ///
+  /// \param[in] extension
+  ///     The extension of the files of this cache, including the dot.
+  ///
+  /// \param[in] max_byte_size
+  ///     When a file is written, the least recently written files with the
+  ///     same extension are removed until they take up at most this many
+  ///     bytes. Zero means no limit.
+  DataFileCache(const FileSpec &cache_dir, llvm::StringRef extension,
+                uint64_t max_byte_size);
+
+  /// Get the path of the cache file for \a key, or an invalid FileSpec if
+  /// \a key is empty.
+  FileSpec GetCacheFile(llvm::StringRef key) const;
+
+  /// Map the cache file for \a key into memory.
+  ///
+  /// \return
+  ///     The contents of the file, or nullptr if there is no such file.
+  lldb::DataBufferSP GetCachedData(llvm::StringRef key) const;
+
+  /// Replace the cache file for \a key with \a data.
+  ///
+  /// The data is written to a temporary file first which is then renamed
+  /// into place, so concurrent debug sessions never see partially written
+  /// files.
+  ///
+  /// \return
+  ///     True if the file was written.
+  bool SetCachedData(llvm::StringRef key, llvm::StringRef data);
+
+private:
+  void Prune();
+
+  FileSpec m_cache_dir;
+  std::string m_extension;
+  uint64_t m_max_byte_size;
+};
+
+/// \class ConstStringTable DataFileCache.h "lldb/Core/DataFileCache.h"
+/// Assigns every distinct string an offset into a blob of NUL-terminated
+/// strings, so that data written to a cache file can refer to strings by
+/// offset and every string is stored only once.
+class ConstStringTable {
+public:
+  uint32_t Add(ConstString s);
+
+  llvm::StringRef GetData() const { return m_data; }
+
+private:
+  llvm::DenseMap<const char *, uint32_t> m_offsets;
+  std::string m_data;
+};
+
+/// \class ConstStringTableReader DataFileCache.h "lldb/Core/DataFileCache.h"
+/// Interns all strings of a string table written by a ConstStringTable at
+/// once, so that looking up a string by offset is only a hash table lookup.
+class ConstStringTableReader {
+public:
+  /// \param[in] data
+  ///     The contents of ConstStringTable::GetData().
+  ConstStringTableReader(llvm::StringRef data);
+
+  /// Get the string at \a offset.
+  ///
+  /// \return
+  ///     True if a string starts at \a offset.
+  bool GetString(uint32_t offset, ConstString &s) const;
+
+private:
+  llvm::DenseMap<uint32_t, ConstString> m_strings;
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_DataFileCache_h_
@@ -162,6 +162,13 @@ public:
   ConstString GetDisplayDemangledName(lldb::LanguageType language,
                                       const SymbolContext *sc = nullptr) const;
 
+  /// Demangled name get accessor that doesn't demangle the mangled name.
+  ///
+  /// \return
+  ///     The demangled name if it was already computed, an empty string if
+  ///     demangling failed, and a null string otherwise.
+  ConstString GetCachedDemangledName() const { return m_demangled; }
+
   void SetDemangledName(ConstString name) { m_demangled = name; }
 
   void SetMangledName(ConstString name) { m_mangled = name; }
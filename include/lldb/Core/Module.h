@@ -26,6 +26,7 @@
 #include "lldb/lldb-types.h"
 
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Chrono.h"
 
@@ -519,7 +520,7 @@ public:
     return m_file;
   }
 
-  void SetPlatformFileSpec(const FileSpec &file) { m_platform_file = file; }
+  void SetPlatformFileSpec(const FileSpec &file);
 
   const FileSpec &GetRemoteInstallFileSpec() const {
     return m_remote_install_file;
@@ -1032,6 +1033,11 @@ protected:
       m_first_file_changed_log : 1; /// See if the module was modified after it
                                     /// was initially opened.
 
+  /// The module lists that index this module by its file, platform file and
+  /// UUID. They are told when one of those changes.
+  std::mutex m_index_lists_mutex;
+  llvm::SmallVector<ModuleList *, 2> m_index_lists;
+
   /// Resolve a file or load virtual address.
   ///
   /// Tries to resolve \a vm_addr as a file address (if \a
@@ -1079,6 +1085,12 @@ protected:
 
   SectionList *GetUnifiedSectionList();
 
+  void AddIndexList(ModuleList *list);
+
+  void RemoveIndexList(ModuleList *list);
+
+  void NotifyIndexLists();
+
   friend class ModuleList;
   friend class ObjectFile;
   friend class SymbolFile;
@@ -15,11 +15,15 @@
 #include "lldb/Utility/FileSpec.h"
 #include "lldb/Utility/Iterable.h"
 #include "lldb/Utility/Status.h"
+#include "lldb/Utility/UUID.h"
 #include "lldb/lldb-enumerations.h"
 #include "lldb/lldb-forward.h"
 #include "lldb/lldb-types.h"
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 
 #include <functional>
 #include <list>
@@ -56,6 +60,13 @@ public:
   bool SetSwiftModuleLoadingMode(SwiftModuleLoadingMode);
   bool GetEnableExternalLookup() const;
   bool SetEnableExternalLookup(bool new_value);
+  FileSpec GetSymtabCachePath() const;
+  uint64_t GetSymtabCacheMaxByteSize() const;
+  uint64_t GetTaskPoolThreadCount() const;
+
+private:
+  static void TaskPoolThreadCountChangedCallback(void *baton,
+                                                 OptionValue *option_value);
 }; 
 
 /// \class ModuleList ModuleList.h "lldb/Core/ModuleList.h"
@@ -523,12 +534,80 @@ protected:
 
   void ClearImpl(bool use_notifier = true);
 
+  // The lookup indexes map UUIDs, file names and paths of the modules to the
+  // modules that may match them. Candidates still need to be checked with
+  // Module::MatchesModuleSpec(). All functions below expect m_modules_mutex
+  // to be locked, except for IndexPendingUUIDs().
+  typedef llvm::SmallVector<Module *, 1> ModuleVector;
+  typedef std::pair<const char *, const char *> PathKey;
+
+  struct IndexedKeys {
+    /// The position of the first copy of the module in m_modules relative to
+    /// the other modules.
+    uint64_t order = 0;
+    /// The number of times the module appears in m_modules.
+    uint32_t copies = 0;
+    FileSpec file;
+    FileSpec platform_file;
+    /// Computing the UUID may require parsing the object file, so modules are
+    /// only added to the UUID index by the first UUID lookup.
+    bool uuid_indexed = false;
+    UUID uuid;
+  };
+
+  void AddToIndexes(Module *module);
+
+  /// Called after one copy of \a module was erased from m_modules. The module
+  /// is only removed from the indexes when that was its last copy.
+  void RemoveFromIndexes(Module *module);
+
+  /// Re-number the modules in the order of their first copy in m_modules.
+  void UpdateOrder();
+
+  void BuildIndexes();
+
+  void AddFileKeys(Module *module, const FileSpec &file) const;
+
+  void RemoveFileKeys(Module *module, const FileSpec &file) const;
+
+  /// Called by \a module when its file, platform file or UUID changed. This
+  /// doesn't lock m_modules_mutex, so it can be called while the module is
+  /// being looked up.
+  void ModuleIdentityChanged(Module *module);
+
+  /// Re-key the modules whose file, platform file or UUID changed since they
+  /// were indexed.
+  void UpdateIndexes() const;
+
+  void IndexPendingUUIDs() const;
+
+  /// Collect the modules that may match \a module_spec in the order of the
+  /// module list.
+  ///
+  /// \return
+  ///     False if the spec cannot be looked up in the indexes, in which case
+  ///     all modules need to be checked.
+  bool GetIndexedCandidates(const ModuleSpec &module_spec,
+                            collection &candidates) const;
+
   // Member variables.
   collection m_modules; ///< The collection of modules.
   mutable std::recursive_mutex m_modules_mutex;
 
   Notifier *m_notifier;
 
+  uint64_t m_next_order = 0;
+  mutable llvm::DenseMap<Module *, IndexedKeys> m_index_keys;
+  mutable llvm::DenseMap<const char *, ModuleVector> m_basename_index;
+  mutable llvm::DenseMap<PathKey, ModuleVector> m_path_index;
+  mutable llvm::StringMap<ModuleVector> m_uuid_index;
+  mutable llvm::DenseSet<Module *> m_pending_uuids;
+  /// The modules that need to be re-keyed, guarded by m_changed_mutex.
+  mutable std::mutex m_changed_mutex;
+  mutable llvm::DenseSet<Module *> m_changed_modules;
+
+  friend class Module;
+
 public:
   typedef LockingAdaptedIterable<collection, lldb::ModuleSP, vector_adapter,
                                  std::recursive_mutex>
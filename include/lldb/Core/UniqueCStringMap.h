@@ -163,6 +163,16 @@ public:
   // my_map.Sort();
   void Sort() { llvm::sort(m_map.begin(), m_map.end(), Compare()); }
 
+  // Append the contents of another sorted map to this sorted map and keep the
+  // result sorted. This is cheaper than calling Sort() on all entries when
+  // the entries were sorted in separate maps, e.g. on separate threads.
+  void AppendSorted(const UniqueCStringMap &rhs) {
+    const size_t lhs_size = m_map.size();
+    m_map.insert(m_map.end(), rhs.m_map.begin(), rhs.m_map.end());
+    std::inplace_merge(m_map.begin(), m_map.begin() + lhs_size, m_map.end(),
+                       Compare());
+  }
+
   // Since we are using a vector to contain our items it will always double its
   // memory consumption as things are added to the vector, so if you intend to
   // keep a UniqueCStringMap around and have a lot of entries in the map, you
@@ -27,6 +27,7 @@
 #include "lldb/lldb-types.h"
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -37,6 +38,7 @@
 #include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <stddef.h>
 #include <stdint.h>
@@ -326,6 +328,16 @@ public:
 
   virtual ~ValueObject();
 
+  /// Root ValueObjects are allocated on the heap. ValueObjects created for a
+  /// parent should be allocated from the arena of the parent's cluster with
+  /// "new (parent) ValueObjectChild(parent, ...)", which makes building big
+  /// trees cheap and releases them in one go with the cluster. Deleting works
+  /// the same for both.
+  static void *operator new(size_t size);
+  static void *operator new(size_t size, ValueObject &parent);
+  static void operator delete(void *ptr);
+  static void operator delete(void *ptr, ValueObject &parent);
+
   const EvaluationPoint &GetUpdatePoint() const { return m_update_point; }
 
   EvaluationPoint &GetUpdatePoint() { return m_update_point; }
@@ -463,6 +475,13 @@ public:
 
   virtual lldb::ValueObjectSP GetChildAtIndex(size_t idx, bool can_create);
 
+  /// Get the children at indexes [start, start + count), stopping at the
+  /// number of children. Entries of children that can't be made are null.
+  /// Synthetic values fetch the missing ones from their front end in one go,
+  /// so prefer this to GetChildAtIndex() when walking many children.
+  virtual std::vector<lldb::ValueObjectSP>
+  GetChildrenAtIndexRange(size_t start, size_t count, bool can_create);
+
   // this will always create the children if necessary
   lldb::ValueObjectSP GetChildAtIndexPath(llvm::ArrayRef<size_t> idxs,
                                           size_t *index_of_error = nullptr);
@@ -799,20 +818,23 @@ protected:
 
     bool HasChildAtIndex(size_t idx) {
       std::lock_guard<std::recursive_mutex> guard(m_mutex);
-      return (m_children.find(idx) != m_children.end());
+      return idx < m_children.size() && m_children[idx] != nullptr;
     }
 
     ValueObject *GetChildAtIndex(size_t idx) {
       std::lock_guard<std::recursive_mutex> guard(m_mutex);
-      const auto iter = m_children.find(idx);
-      return ((iter == m_children.end()) ? nullptr : iter->second);
+      return idx < m_children.size() ? m_children[idx] : nullptr;
     }
 
     void SetChildAtIndex(size_t idx, ValueObject *valobj) {
-      // we do not need to be mutex-protected to make a pair
-      ChildrenPair pair(idx, valobj);
       std::lock_guard<std::recursive_mutex> guard(m_mutex);
-      m_children.insert(pair);
+      // Grow only up to the child that is set, a value with many children
+      // may only ever have a few of them fetched.
+      if (idx >= m_children.size())
+        m_children.resize(idx + 1, nullptr);
+      // Like inserting into a map, keep a child that is already there.
+      if (!m_children[idx])
+        m_children[idx] = valobj;
     }
 
     void SetChildrenCount(size_t count) { Clear(count); }
@@ -826,11 +848,11 @@ protected:
     }
 
   private:
-    typedef std::map<size_t, ValueObject *> ChildrenMap;
-    typedef ChildrenMap::iterator ChildrenIterator;
-    typedef ChildrenMap::value_type ChildrenPair;
+    // Indexed by child index, entries of children that weren't created yet
+    // are null.
+    typedef std::vector<ValueObject *> ChildrenVector;
     std::recursive_mutex m_mutex;
-    ChildrenMap m_children;
+    ChildrenVector m_children;
     size_t m_children_count;
   };
 
@@ -876,7 +898,8 @@ protected:
   // pointers to value objects must always be made with the GetSP method.
 
   ChildrenManager m_children;
-  std::map<ConstString, ValueObject *> m_synthetic_children;
+  // Keyed by the ConstString pointer of the child's key.
+  llvm::DenseMap<const char *, ValueObject *> m_synthetic_children;
 
   ValueObject *m_dynamic_value;
   ValueObject *m_synthetic_value;
@@ -54,6 +54,10 @@ public:
 
   lldb::ValueObjectSP GetChildAtIndex(size_t idx, bool can_create) override;
 
+  std::vector<lldb::ValueObjectSP>
+  GetChildrenAtIndexRange(size_t start, size_t count,
+                          bool can_create) override;
+
   lldb::ValueObjectSP GetChildMemberWithName(ConstString name,
                                              bool can_create) override;
 
@@ -177,6 +181,8 @@ private:
 
   void CopyValueData(ValueObject *source);
 
+  void CacheChild(size_t idx, lldb::ValueObjectSP &child_sp);
+
   DISALLOW_COPY_AND_ASSIGN(ValueObjectSynthetic);
 };
 
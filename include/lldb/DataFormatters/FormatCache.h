@@ -10,91 +10,136 @@
 #ifndef lldb_FormatCache_h_
 #define lldb_FormatCache_h_
 
-#include <map>
-#include <mutex>
+#include <atomic>
+#include <deque>
 
 #include "lldb/Utility/ConstString.h"
 #include "lldb/lldb-public.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/Support/RWMutex.h"
 
 namespace lldb_private {
-class FormatCache {
-private:
-  struct Entry {
-  private:
-    bool m_format_cached : 1;
-    bool m_summary_cached : 1;
-    bool m_synthetic_cached : 1;
-    bool m_validator_cached : 1;
-
-    lldb::TypeFormatImplSP m_format_sp;
-    lldb::TypeSummaryImplSP m_summary_sp;
-    lldb::SyntheticChildrenSP m_synthetic_sp;
-    lldb::TypeValidatorImplSP m_validator_sp;
-
-  public:
-    Entry();
-    Entry(lldb::TypeFormatImplSP);
-    Entry(lldb::TypeSummaryImplSP);
-    Entry(lldb::SyntheticChildrenSP);
-    Entry(lldb::TypeValidatorImplSP);
-    Entry(lldb::TypeFormatImplSP, lldb::TypeSummaryImplSP,
-          lldb::SyntheticChildrenSP, lldb::TypeValidatorImplSP);
-
-    bool IsFormatCached();
-
-    bool IsSummaryCached();
-
-    bool IsSyntheticCached();
-
-    bool IsValidatorCached();
+class FormattersMatchData;
+
+/// Identifies the type of a value by the TypeSystem that owns it and its
+/// opaque type, which is much cheaper to get than the name of the type.
+struct FormatCacheTypeKey {
+  uint64_t type_system_id;
+  void *opaque_type;
+  uint32_t bitfield_bit_size;
+};
+} // namespace lldb_private
 
-    lldb::TypeFormatImplSP GetFormat();
+namespace llvm {
+template <> struct DenseMapInfo<lldb_private::FormatCacheTypeKey> {
+  static lldb_private::FormatCacheTypeKey getEmptyKey() {
+    return {0, DenseMapInfo<void *>::getEmptyKey(), 0};
+  }
+  static lldb_private::FormatCacheTypeKey getTombstoneKey() {
+    return {0, DenseMapInfo<void *>::getTombstoneKey(), 0};
+  }
+  static unsigned getHashValue(const lldb_private::FormatCacheTypeKey &key) {
+    return hash_combine(key.type_system_id, key.opaque_type,
+                        key.bitfield_bit_size);
+  }
+  static bool isEqual(const lldb_private::FormatCacheTypeKey &lhs,
+                      const lldb_private::FormatCacheTypeKey &rhs) {
+    return lhs.type_system_id == rhs.type_system_id &&
+           lhs.opaque_type == rhs.opaque_type &&
+           lhs.bitfield_bit_size == rhs.bitfield_bit_size;
+  }
+};
+} // namespace llvm
 
-    lldb::TypeSummaryImplSP GetSummary();
+namespace lldb_private {
+/// Remembers the formatters found for each type.
+///
+/// Entries are found by the type key of a value first and by its type name
+/// only when the key is not known yet, so that a type is named once. The
+/// name keeps entries shared between types of the same name, across
+/// TypeSystems and targets. Lookups only take the lock shared.
+///
+/// Each formatter remembers the position of the enabled category it came
+/// from, so that a change to one category only drops the formatters that
+/// category could now override.
+class FormatCache {
+private:
+  template <typename ImplSP> struct CachedFormatter {
+    bool m_cached = false;
+    ImplSP m_formatter_sp;
+    /// The position of the enabled category the formatter was found in, or
+    /// UINT32_MAX if no enabled category provided it.
+    uint32_t m_category_index = UINT32_MAX;
+  };
 
-    lldb::SyntheticChildrenSP GetSynthetic();
+  struct Entry {
+    CachedFormatter<lldb::TypeFormatImplSP> m_format;
+    CachedFormatter<lldb::TypeSummaryImplSP> m_summary;
+    CachedFormatter<lldb::SyntheticChildrenSP> m_synthetic;
+    CachedFormatter<lldb::TypeValidatorImplSP> m_validator;
+  };
 
-    lldb::TypeValidatorImplSP GetValidator();
+  /// Keys of destroyed TypeSystems are never looked up again, this bounds
+  /// how many of them can pile up.
+  static const size_t k_max_type_keys = 1 << 18;
 
-    void SetFormat(lldb::TypeFormatImplSP);
+  std::deque<Entry> m_entries;
+  llvm::DenseMap<FormatCacheTypeKey, Entry *> m_type_map;
+  llvm::DenseMap<const char *, Entry *> m_name_map;
+  llvm::sys::SmartRWMutex<false> m_mutex;
 
-    void SetSummary(lldb::TypeSummaryImplSP);
+  std::atomic<uint64_t> m_cache_hits;
+  std::atomic<uint64_t> m_cache_misses;
 
-    void SetSynthetic(lldb::SyntheticChildrenSP);
+  template <typename ImplSP>
+  bool Get(FormattersMatchData &match_data,
+           CachedFormatter<ImplSP> Entry::*formatter, ImplSP &formatter_sp);
 
-    void SetValidator(lldb::TypeValidatorImplSP);
-  };
-  typedef std::map<ConstString, Entry> CacheMap;
-  CacheMap m_map;
-  std::recursive_mutex m_mutex;
+  template <typename ImplSP>
+  void Set(FormattersMatchData &match_data,
+           CachedFormatter<ImplSP> Entry::*formatter,
+           const ImplSP &formatter_sp, uint32_t category_index);
 
-  uint64_t m_cache_hits;
-  uint64_t m_cache_misses;
+  template <typename ImplSP>
+  bool Found(const CachedFormatter<ImplSP> &cached, ImplSP &formatter_sp);
 
-  Entry &GetEntry(ConstString type);
 
 public:
   FormatCache();
 
-  bool GetFormat(ConstString type, lldb::TypeFormatImplSP &format_sp);
+  bool GetFormat(FormattersMatchData &match_data,
+                 lldb::TypeFormatImplSP &format_sp);
 
-  bool GetSummary(ConstString type, lldb::TypeSummaryImplSP &summary_sp);
+  bool GetSummary(FormattersMatchData &match_data,
+                  lldb::TypeSummaryImplSP &summary_sp);
 
-  bool GetSynthetic(ConstString type,
+  bool GetSynthetic(FormattersMatchData &match_data,
                     lldb::SyntheticChildrenSP &synthetic_sp);
 
-  bool GetValidator(ConstString type,
-                    lldb::TypeValidatorImplSP &summary_sp);
+  bool GetValidator(FormattersMatchData &match_data,
+                    lldb::TypeValidatorImplSP &validator_sp);
 
-  void SetFormat(ConstString type, lldb::TypeFormatImplSP &format_sp);
+  void SetFormat(FormattersMatchData &match_data,
+                 const lldb::TypeFormatImplSP &format_sp,
+                 uint32_t category_index = UINT32_MAX);
 
-  void SetSummary(ConstString type, lldb::TypeSummaryImplSP &summary_sp);
+  void SetSummary(FormattersMatchData &match_data,
+                  const lldb::TypeSummaryImplSP &summary_sp,
+                  uint32_t category_index = UINT32_MAX);
 
-  void SetSynthetic(ConstString type,
-                    lldb::SyntheticChildrenSP &synthetic_sp);
+  void SetSynthetic(FormattersMatchData &match_data,
+                    const lldb::SyntheticChildrenSP &synthetic_sp,
+                    uint32_t category_index = UINT32_MAX);
+
+  void SetValidator(FormattersMatchData &match_data,
+                    const lldb::TypeValidatorImplSP &validator_sp,
+                    uint32_t category_index = UINT32_MAX);
 
-  void SetValidator(ConstString type,
-                    lldb::TypeValidatorImplSP &synthetic_sp);
+  /// Forget the formatters found in the enabled category at \a
+  /// category_index or any category after it, and the ones no enabled
+  /// category provided.
+  void Invalidate(uint32_t category_index);
 
   void Clear();
 
@@ -14,6 +14,7 @@
 #include <string>
 #include <vector>
 
+#include "lldb/DataFormatters/FormatCache.h"
 #include "lldb/DataFormatters/TypeFormat.h"
 #include "lldb/DataFormatters/TypeSummary.h"
 #include "lldb/DataFormatters/TypeSynthetic.h"
@@ -22,6 +23,7 @@
 #include "lldb/Symbol/Type.h"
 #include "lldb/lldb-enumerations.h"
 #include "lldb/lldb-public.h"
+#include "llvm/ADT/Optional.h"
 
 namespace lldb_private {
 
@@ -94,6 +96,11 @@ public:
 
   ConstString GetTypeForCache();
 
+  /// Get the key of the type of the value in the FormatCache, which is
+  /// cheaper than its name. Values whose type name might not come from
+  /// their CompilerType, like dynamic values, have no key.
+  bool GetTypeKeyForCache(FormatCacheTypeKey &key);
+
   CandidateLanguagesVector GetCandidateLanguages();
 
   ValueObject &GetValueObject();
@@ -104,10 +111,30 @@ private:
   ValueObject &m_valobj;
   lldb::DynamicValueType m_dynamic_value_type;
   std::pair<FormattersMatchVector, bool> m_formatters_match_vector;
-  ConstString m_type_for_cache;
+  std::pair<ConstString, bool> m_type_for_cache;
+  std::pair<llvm::Optional<FormatCacheTypeKey>, bool> m_type_key_for_cache;
   CandidateLanguagesVector m_candidate_languages;
 };
 
+/// The literal text that every match of a regular expression for type names
+/// contains, in order. Looking for it is much cheaper than running the
+/// regular expression, and rules out most type names a regex formatter is
+/// tried on.
+class RegexLiteralFilter {
+public:
+  RegexLiteralFilter() = default;
+
+  explicit RegexLiteralFilter(llvm::StringRef regex);
+
+  /// Returns false if \a name can't match the regular expression.
+  bool MayMatch(llvm::StringRef name) const;
+
+private:
+  std::vector<std::string> m_literals;
+  /// Whether the first literal starts the match, after a leading '^'.
+  bool m_anchored = false;
+};
+
 class TypeNameSpecifierImpl {
 public:
   TypeNameSpecifierImpl() : m_is_regex(false), m_type() {}
@@ -179,6 +179,9 @@ public:
 
   void Changed() override;
 
+  void CategoryChanged(TypeCategoryImpl &category,
+                       uint32_t category_index) override;
+
   uint32_t GetCurrentRevision() override { return m_last_revision; }
 
   static FormattersMatchVector
@@ -192,6 +195,9 @@ public:
 
   static ConstString GetTypeForCache(ValueObject &, lldb::DynamicValueType);
 
+  static llvm::Optional<FormatCacheTypeKey>
+  GetTypeKeyForCache(ValueObject &, lldb::DynamicValueType);
+
   LanguageCategory *GetCategoryForLanguage(lldb::LanguageType lang_type);
 
   static std::vector<lldb::LanguageType>
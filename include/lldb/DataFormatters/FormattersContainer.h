@@ -14,6 +14,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "lldb/lldb-public.h"
 
@@ -35,6 +36,15 @@ public:
 
   virtual void Changed() = 0;
 
+  /// Called when the formatters of \a category changed, or it got enabled
+  /// or disabled. \a category_index is its position among the enabled
+  /// categories, or the one it had before being disabled, and UINT32_MAX if
+  /// it wasn't enabled.
+  virtual void CategoryChanged(TypeCategoryImpl &category,
+                               uint32_t category_index) {
+    Changed();
+  }
+
   virtual uint32_t GetCurrentRevision() = 0;
 };
 
@@ -80,6 +90,7 @@ public:
 
     std::lock_guard<std::recursive_mutex> guard(m_map_mutex);
     m_map[std::move(name)] = entry;
+    m_generation++;
     if (listener)
       listener->Changed();
   }
@@ -90,6 +101,7 @@ public:
     if (iter == m_map.end())
       return false;
     m_map.erase(iter);
+    m_generation++;
     if (listener)
       listener->Changed();
     return true;
@@ -98,6 +110,7 @@ public:
   void Clear() {
     std::lock_guard<std::recursive_mutex> guard(m_map_mutex);
     m_map.clear();
+    m_generation++;
     if (listener)
       listener->Changed();
   }
@@ -156,6 +169,8 @@ protected:
   MapType m_map;
   std::recursive_mutex m_map_mutex;
   IFormatChangeListener *listener;
+  /// Bumped whenever the keys of the map change.
+  uint32_t m_generation = 0;
 
   MapType &map() { return m_map; }
 
@@ -231,6 +246,10 @@ public:
 protected:
   BackEndType m_format_map;
   std::string m_name;
+  /// The literal prefilters of the regex keys, in map order, which let
+  /// lookups skip most regexes without running them.
+  std::vector<RegexLiteralFilter> m_regex_filters;
+  uint32_t m_regex_filters_generation = UINT32_MAX;
 
   DISALLOW_COPY_AND_ASSIGN(FormattersContainer);
 
@@ -255,6 +274,7 @@ protected:
       const RegularExpression &regex = pos->first;
       if (type.GetStringRef() == regex.GetText()) {
         m_format_map.map().erase(pos);
+        m_format_map.m_generation++;
         if (m_format_map.listener)
           m_format_map.listener->Changed();
         return true;
@@ -291,12 +311,27 @@ protected:
         new TypeNameSpecifierImpl(regex.GetText().str().c_str(), true));
   }
 
+  // Must be called with the map mutex held.
+  void UpdateRegexFilters() {
+    if (m_regex_filters_generation == m_format_map.m_generation)
+      return;
+    m_regex_filters.clear();
+    m_regex_filters.reserve(m_format_map.map().size());
+    for (const auto &pos : m_format_map.map())
+      m_regex_filters.emplace_back(pos.first.GetText());
+    m_regex_filters_generation = m_format_map.m_generation;
+  }
+
   bool Get_Impl(ConstString key, MapValueType &value,
                 RegularExpression *dummy) {
     llvm::StringRef key_str = key.GetStringRef();
     std::lock_guard<std::recursive_mutex> guard(m_format_map.mutex());
+    UpdateRegexFilters();
     MapIterator pos, end = m_format_map.map().end();
-    for (pos = m_format_map.map().begin(); pos != end; pos++) {
+    size_t index = 0;
+    for (pos = m_format_map.map().begin(); pos != end; pos++, index++) {
+      if (!m_regex_filters[index].MayMatch(key_str))
+        continue;
       const RegularExpression &regex = pos->first;
       if (regex.Execute(key_str)) {
         value = pos->second;
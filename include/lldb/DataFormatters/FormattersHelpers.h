@@ -18,6 +18,10 @@
 #include "lldb/DataFormatters/TypeSummary.h"
 #include "lldb/DataFormatters/TypeSynthetic.h"
 
+#include "llvm/ADT/ArrayRef.h"
+
+#include <vector>
+
 namespace lldb_private {
 namespace formatters {
 void AddFormat(TypeCategoryImpl::SharedPointer category_sp, lldb::Format format,
@@ -56,6 +60,14 @@ size_t ExtractIndexFromString(const char *item_name);
 
 lldb::addr_t GetArrayAddressOrPointerValue(ValueObject &valobj);
 
+/// Read \a size bytes at each of \a addrs into \a data, the bytes at
+/// addrs[i] going to offset i * size. Blocks that are close to each other,
+/// like container nodes that were allocated one after the other, are read
+/// with a single memory read. Returns false if any block can't be read.
+bool ReadMemoryBlocks(Process &process, llvm::ArrayRef<lldb::addr_t> addrs,
+                      size_t size, std::vector<uint8_t> &data,
+                      Status &error);
+
 time_t GetOSXEpoch();
 
 struct InferiorSizedWord {
@@ -9,6 +9,7 @@
 #ifndef lldb_TypeCategory_h_
 #define lldb_TypeCategory_h_
 
+#include <atomic>
 #include <initializer_list>
 #include <memory>
 #include <mutex>
@@ -62,7 +63,7 @@ private:
   RegexMatchContainerSP m_regex_sp;
 };
 
-class TypeCategoryImpl {
+class TypeCategoryImpl : public IFormatChangeListener {
 private:
   typedef FormatterContainerPair<TypeFormatImpl> FormatContainer;
   typedef FormatterContainerPair<TypeSummaryImpl> SummaryContainer;
@@ -363,6 +364,12 @@ public:
 
   std::string GetDescription();
 
+  /// Pass a change to the formatters of this category on to the listener
+  /// of the category, along with its position.
+  void Changed() override;
+
+  uint32_t GetCurrentRevision() override;
+
   bool AnyMatches(ConstString type_name,
                   FormatCategoryItems items = ALL_ITEM_TYPES,
                   bool only_enabled = true,
@@ -390,6 +397,10 @@ private:
 
   uint32_t m_enabled_position;
 
+  /// The position of this category among the enabled ones, kept up to date
+  /// by the TypeCategoryMap, or UINT32_MAX if it isn't enabled.
+  std::atomic<uint32_t> m_active_index;
+
   void Enable(bool value, uint32_t position);
 
   void Disable() { Enable(false, UINT32_MAX); }
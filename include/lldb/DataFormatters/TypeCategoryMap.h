@@ -77,14 +77,21 @@ public:
 
   uint32_t GetCount() { return m_map.size(); }
 
-  lldb::TypeFormatImplSP GetFormat(FormattersMatchData &match_data);
+  /// Find the formatter of a value in the enabled categories. \a
+  /// category_index is set to the position of the category the formatter was
+  /// found in, or UINT32_MAX if no category has one.
+  lldb::TypeFormatImplSP GetFormat(FormattersMatchData &match_data,
+                                   uint32_t &category_index);
 
-  lldb::TypeSummaryImplSP GetSummaryFormat(FormattersMatchData &match_data);
+  lldb::TypeSummaryImplSP GetSummaryFormat(FormattersMatchData &match_data,
+                                           uint32_t &category_index);
 
   lldb::SyntheticChildrenSP
-  GetSyntheticChildren(FormattersMatchData &match_data);
+  GetSyntheticChildren(FormattersMatchData &match_data,
+                       uint32_t &category_index);
 
-  lldb::TypeValidatorImplSP GetValidator(FormattersMatchData &match_data);
+  lldb::TypeValidatorImplSP GetValidator(FormattersMatchData &match_data,
+                                         uint32_t &category_index);
 
 private:
   class delete_matching_categories {
@@ -108,6 +115,8 @@ private:
 
   ActiveCategoriesList &active_list() { return m_active_categories; }
 
+  void UpdateActiveIndexes();
+
   std::recursive_mutex &mutex() { return m_map_mutex; }
 
   friend class FormattersContainer<KeyType, ValueType>;
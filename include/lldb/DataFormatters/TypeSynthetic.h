@@ -47,6 +47,13 @@ public:
 
   virtual lldb::ValueObjectSP GetChildAtIndex(size_t idx) = 0;
 
+  /// Get the children at indexes [start, start + count), which must all be
+  /// less than CalculateNumChildren(). Entries of children that can't be made
+  /// are null. Front ends of big containers override this to fetch a window
+  /// of children with fewer memory reads than one GetChildAtIndex() each.
+  virtual std::vector<lldb::ValueObjectSP>
+  GetChildrenAtIndexRange(size_t start, size_t count);
+
   virtual size_t GetIndexOfChildWithName(ConstString name) = 0;
 
   // this function is assumed to always succeed and it if fails, the front-end
@@ -298,6 +298,9 @@ protected:
                            lldb::StackFrameSP &frame_sp);
 
   Address m_address;       ///< The address the process is stopped in.
+  /// The innermost block at m_address. Stops anywhere in the same block see
+  /// the same variables, so they can run the expression as well.
+  Block *m_block = nullptr;
   std::string m_expr_text; ///< The text of the expression, as typed by the user
   std::string m_expr_prefix; ///< The text of the translation-level definitions,
                              ///as provided by the user
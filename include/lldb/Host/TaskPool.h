@@ -10,6 +10,7 @@
 #define utility_TaskPool_h_
 
 #include "llvm/ADT/STLExtras.h"
+#include <chrono>
 #include <functional>
 #include <future>
 #include <list>
@@ -20,12 +21,18 @@
 namespace lldb_private {
 
 // Global TaskPool class for running tasks in parallel on a set of worker
-// thread created the first time the task pool is used. The TaskPool provide no
-// guarantee about the order the task will be run and about what tasks will run
-// in parallel. None of the task added to the task pool should block on
-// something (mutex, future, condition variable) what will be set only by the
-// completion of an other task on the task pool as they may run on the same
-// thread sequentally.
+// threads created the first time the task pool is used. The TaskPool provides
+// no guarantee about the order the tasks will be run and about what tasks will
+// run in parallel.
+//
+// Every worker thread owns a deque of tasks. Tasks added by a worker go to the
+// back of its own deque and are run from there, while idle workers steal
+// tasks from the front of the other deques. Tasks added from other threads go
+// to a shared queue that every worker checks. A task that needs the result of
+// other tasks should wait for them with TaskPool::Wait(), which runs the
+// pending tasks the caller added itself on the calling thread before it
+// blocks. Tasks must not block on anything else (mutex, condition variable)
+// that will be set only by the completion of another task on the task pool.
 class TaskPool {
 public:
   // Add a new task to the task pool and return a std::future belonging to the
@@ -39,15 +46,34 @@ public:
   // are finished before returning. This method is intended to be used for
   // small number tasks where listing them as function arguments is acceptable.
   // For running large number of tasks you should use AddTask for each task and
-  // then call wait() on each returned future.
+  // then call Wait() on each returned future.
   template <typename... T> static void RunTasks(T &&... tasks);
 
+  // Wait until the task belonging to \a future has finished. The calling
+  // thread first runs the tasks it added that no other thread started yet,
+  // so this can be called from a task on the pool without waiting for a free
+  // worker. Tasks added by anyone else are never run here, they may need
+  // locks the caller holds.
+  template <typename T> static void Wait(const std::future<T> &future);
+
+  // Limit the number of worker threads of the task pool. Defaults to
+  // GetHardwareConcurrencyHint(), the symbols.task-pool-thread-count setting
+  // changes it. Lowering the limit does not stop workers that are already
+  // running.
+  static void SetMaxThreadCount(unsigned count);
+
+  static unsigned GetMaxThreadCount();
+
 private:
   TaskPool() = delete;
 
   template <typename... T> struct RunTaskImpl;
 
   static void AddTaskImpl(std::function<void()> &&task_fn);
+
+  // Run one pending task that was added by the calling thread, in the task
+  // it is currently running if any. Returns false if there was no such task.
+  static bool RunOwnPendingTask();
 };
 
 template <typename F, typename... Args>
@@ -66,12 +92,24 @@ template <typename... T> void TaskPool::RunTasks(T &&... tasks) {
   RunTaskImpl<T...>::Run(std::forward<T>(tasks)...);
 }
 
+template <typename T> void TaskPool::Wait(const std::future<T> &future) {
+  while (future.wait_for(std::chrono::seconds(0)) !=
+         std::future_status::ready) {
+    // Everything we added is running on other threads, and nothing new can
+    // be added while we wait.
+    if (!RunOwnPendingTask()) {
+      future.wait();
+      return;
+    }
+  }
+}
+
 template <typename Head, typename... Tail>
 struct TaskPool::RunTaskImpl<Head, Tail...> {
   static void Run(Head &&h, Tail &&... t) {
     auto f = AddTask(std::forward<Head>(h));
     RunTaskImpl<Tail...>::Run(std::forward<Tail>(t)...);
-    f.wait();
+    Wait(f);
   }
 };
 
@@ -79,9 +117,9 @@ template <> struct TaskPool::RunTaskImpl<> {
   static void Run() {}
 };
 
-// Run 'func' on every value from begin .. end-1.  Each worker will grab
-// 'batch_size' numbers at a time to work on, so for very fast functions, batch
-// should be large enough to avoid too much cache line contention.
+// Run 'func' on every value from begin .. end-1 on the task pool. The calling
+// thread takes part in the work, so this may be called from a task on the
+// pool.
 void TaskMapOverInt(size_t begin, size_t end,
                     const llvm::function_ref<void(size_t)> &func);
 
@@ -14,7 +14,9 @@
 #include "NativeWatchpointList.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/MainLoop.h"
+#include "lldb/Utility/AgentExpression.h"
 #include "lldb/Utility/ArchSpec.h"
+#include "lldb/Utility/RangeMap.h"
 #include "lldb/Utility/Status.h"
 #include "lldb/Utility/TraceOptions.h"
 #include "lldb/lldb-private-forward.h"
@@ -43,6 +45,8 @@ struct SVR4LibraryInfo {
 // NativeProcessProtocol
 class NativeProcessProtocol {
 public:
+  typedef Range<lldb::addr_t, size_t> MemoryRange;
+
   virtual ~NativeProcessProtocol() {}
 
   virtual Status Resume(const ResumeActionList &resume_actions) = 0;
@@ -69,6 +73,19 @@ public:
 
   virtual Status Kill() = 0;
 
+  /// Enables or disables non-stop mode.
+  ///
+  /// In non-stop mode a thread that stops doesn't stop the other threads of
+  /// the process. Every thread stop is reported on its own through
+  /// NativeDelegate::ThreadStopped, Resume() leaves threads that are already
+  /// running alone and an eStateStopped resume action stops a running thread.
+  ///
+  /// \return
+  ///     Returns an error object if the process doesn't support the mode.
+  virtual Status SetNonStopMode(bool enabled);
+
+  bool IsNonStopMode() const { return m_non_stop_mode; }
+
   // Tells a process not to stop the inferior on given signals and just
   // reinject them back.
   virtual Status IgnoreSignals(llvm::ArrayRef<int> signals);
@@ -84,6 +101,27 @@ public:
   Status ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t size,
                                size_t &bytes_read);
 
+  /// Reads several ranges of memory at once.
+  ///
+  /// The default implementation calls ReadMemory() for every range.
+  ///
+  /// \param[in] ranges
+  ///     The address and size of every range to read.
+  ///
+  /// \param[out] buf
+  ///     A buffer that is large enough for all ranges. The bytes of every
+  ///     range are stored right after the bytes of the previous range.
+  ///
+  /// \param[out] bytes_read
+  ///     Receives the number of bytes read from each range, which is less
+  ///     than the size of the range if it could only be read partially.
+  virtual void ReadMemoryRanges(llvm::ArrayRef<MemoryRange> ranges, void *buf,
+                                llvm::MutableArrayRef<size_t> bytes_read);
+
+  void ReadMemoryRangesWithoutTrap(llvm::ArrayRef<MemoryRange> ranges,
+                                   void *buf,
+                                   llvm::MutableArrayRef<size_t> bytes_read);
+
   /// Reads a null terminated string from memory.
   ///
   /// Reads up to \p max_size bytes of memory until it finds a '\0'.
@@ -137,6 +175,12 @@ public:
 
   virtual Status RemoveBreakpoint(lldb::addr_t addr, bool hardware = false);
 
+  /// Set the conditions under which hits of the software breakpoint at \a
+  /// addr get reported. A hit is reported if any of the conditions is true
+  /// or cannot be evaluated. An empty list reports every hit.
+  Status SetBreakpointConditions(lldb::addr_t addr,
+                                 std::vector<AgentExpression> conditions);
+
   // Hardware Breakpoint functions
   virtual const HardwareBreakpointMap &GetHardwareBreakpointMap() const;
 
@@ -215,6 +259,11 @@ public:
                                      lldb::StateType state) = 0;
 
     virtual void DidExec(NativeProcessProtocol *process) = 0;
+
+    /// Called in non-stop mode when \a thread stopped. Other threads of the
+    /// process may still be running.
+    virtual void ThreadStopped(NativeProcessProtocol *process,
+                               NativeThreadProtocol &thread) {}
   };
 
   /// Register a native delegate.
@@ -398,6 +447,7 @@ protected:
     uint32_t ref_count;
     llvm::SmallVector<uint8_t, 4> saved_opcodes;
     llvm::ArrayRef<uint8_t> breakpoint_opcodes;
+    std::vector<AgentExpression> conditions;
   };
 
   std::unordered_map<lldb::addr_t, SoftwareBreakpoint> m_software_breakpoints;
@@ -418,6 +468,7 @@ protected:
   HardwareBreakpointMap m_hw_breakpoints_map;
   int m_terminal_fd;
   uint32_t m_stop_id = 0;
+  bool m_non_stop_mode = false;
 
   // Set of signal numbers that LLDB directly injects back to inferior without
   // stopping it.
@@ -460,16 +511,30 @@ protected:
   // resets it to point to the breakpoint itself.
   void FixupBreakpointPCAsNeeded(NativeThreadProtocol &thread);
 
+  /// Evaluate the conditions of the software breakpoint at \a addr that \a
+  /// thread stopped at.
+  ///
+  /// \return
+  ///     False if the breakpoint has conditions and none of them is true, in
+  ///     which case the hit need not be reported.
+  bool ShouldReportBreakpointHit(NativeThreadProtocol &thread,
+                                 lldb::addr_t addr);
+
   /// Notify the delegate that an exec occurred.
   ///
   /// Provide a mechanism for a delegate to clear out any exec-
   /// sensitive data.
   void NotifyDidExec();
 
+  /// Notify the delegate that \a thread stopped in non-stop mode.
+  void NotifyThreadStopped(NativeThreadProtocol &thread);
+
   NativeThreadProtocol *GetThreadByIDUnlocked(lldb::tid_t tid);
 
 private:
   void SynchronouslyNotifyProcessStateChanged(lldb::StateType state);
+  void RemoveSoftwareBreakpointOpcodes(lldb::addr_t addr,
+                                       llvm::MutableArrayRef<uint8_t> data);
   llvm::Expected<SoftwareBreakpoint>
   EnableSoftwareBreakpoint(lldb::addr_t addr, uint32_t size_hint);
 };
@@ -9,6 +9,7 @@
 #ifndef liblldb_DWARFCallFrameInfo_h_
 #define liblldb_DWARFCallFrameInfo_h_
 
+#include <atomic>
 #include <map>
 #include <mutex>
 
@@ -34,7 +35,11 @@ class DWARFCallFrameInfo {
 public:
   enum Type { EH, DWARF };
 
-  DWARFCallFrameInfo(ObjectFile &objfile, lldb::SectionSP &section, Type type);
+  /// \param[in] eh_frame_hdr_sp
+  ///     The .eh_frame_hdr section of an eh_frame section. Its binary search
+  ///     table is used to find FDEs until the FDE index is built.
+  DWARFCallFrameInfo(ObjectFile &objfile, lldb::SectionSP &section, Type type,
+                     const lldb::SectionSP &eh_frame_hdr_sp = lldb::SectionSP());
 
   ~DWARFCallFrameInfo() = default;
 
@@ -75,6 +80,10 @@ public:
   void ForEachFDEEntries(
       const std::function<bool(lldb::addr_t, uint32_t, dw_offset_t)> &callback);
 
+  /// Scan the section and build the index of all FDEs now, rather than the
+  /// first time it is needed.
+  void PreloadFDEIndex() { GetFDEIndex(); }
+
 private:
   enum { CFI_AUG_MAX_SIZE = 8, CFI_HEADER_SIZE = 8 };
   enum CFIVersion {
@@ -126,6 +135,23 @@ private:
 
   void GetFDEIndex();
 
+  /// Parse the header of .eh_frame_hdr and check whether its binary search
+  /// table can be used. Returns true if it can.
+  bool GetEHFrameHdrTable();
+
+  /// Find the FDE that contains \a file_addr, or the first one after it, with
+  /// a binary search in the table of .eh_frame_hdr.
+  llvm::Optional<FDEEntryMap::Entry>
+  FindFDEInEHFrameHdr(lldb::addr_t file_addr);
+
+  /// Read the start address of the function at \a index of the table of
+  /// .eh_frame_hdr, and the offset of its FDE in the eh_frame section.
+  lldb::addr_t GetEHFrameHdrTableEntry(uint32_t index,
+                                       dw_offset_t &fde_offset);
+
+  /// Read the address range an FDE covers.
+  bool ParseFDEAddressRange(dw_offset_t fde_offset, FDEEntryMap::Entry &entry);
+
   bool FDEToUnwindPlan(uint32_t offset, Address startaddr,
                        UnwindPlan &unwind_plan);
 
@@ -146,14 +172,26 @@ private:
   lldb::SectionSP m_section_sp;
   Flags m_flags = 0;
   cie_map_t m_cie_map;
+  std::mutex m_cie_map_mutex; // CIEs are parsed when FDEs are found without
+                              // the index, maybe by several threads
 
   DataExtractor m_cfi_data;
   bool m_cfi_data_initialized = false; // only copy the section into the DE once
 
   FDEEntryMap m_fde_index;
-  bool m_fde_index_initialized = false; // only scan the section for FDEs once
+  std::atomic<bool> m_fde_index_initialized{
+      false};                   // only scan the section for FDEs once
   std::mutex m_fde_index_mutex; // and isolate the thread that does it
 
+  lldb::SectionSP m_eh_frame_hdr_sp;
+  DataExtractor m_eh_frame_hdr_data;
+  std::atomic<bool> m_eh_frame_hdr_initialized{false};
+  lldb::offset_t m_eh_frame_hdr_table_offset = 0;
+  uint32_t m_eh_frame_hdr_fde_count = 0;    // 0 if the table can't be used
+  uint8_t m_eh_frame_hdr_table_encoding = 0;
+  uint8_t m_eh_frame_hdr_entry_size = 0;
+  bool m_clear_address_zeroth_bit = false;
+
   Type m_type;
 
   CIESP
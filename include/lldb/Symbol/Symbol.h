@@ -15,8 +15,15 @@
 #include "lldb/Utility/UserID.h"
 #include "lldb/lldb-private.h"
 
+namespace llvm {
+class raw_ostream;
+}
+
 namespace lldb_private {
 
+class ConstStringTable;
+class ConstStringTableReader;
+
 class Symbol : public SymbolContextScope {
 public:
   // ObjectFile readers can classify their symbol table entries and searches
@@ -224,6 +231,26 @@ public:
 
   bool ContainsFileAddress(lldb::addr_t file_addr) const;
 
+  /// Write this symbol to \a os for the symbol table cache.
+  ///
+  /// Names are added to \a strtab and sections are referred to by their ID.
+  void Encode(llvm::raw_ostream &os, ConstStringTable &strtab) const;
+
+  /// Replace the contents of this symbol with a symbol written by Encode().
+  ///
+  /// \param[in] strtab
+  ///     The strings of the string table written alongside.
+  ///
+  /// \param[in] section_list
+  ///     The sections the section IDs written by Encode() refer to.
+  ///
+  /// \return
+  ///     False if the data is truncated or refers to unknown strings or
+  ///     sections.
+  bool Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
+              const ConstStringTableReader &strtab,
+              const SectionList *section_list);
+
 protected:
   // This is the internal guts of ResolveReExportedSymbol, it assumes
   // reexport_name is not null, and that module_spec is valid.  We track the
@@ -13,7 +13,9 @@
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Utility/RangeMap.h"
 #include "lldb/lldb-private.h"
+#include "llvm/ADT/StringRef.h"
 #include <mutex>
+#include <string>
 #include <vector>
 
 namespace lldb_private {
@@ -139,6 +141,34 @@ public:
 
   ObjectFile *GetObjectFile() { return m_objfile; }
 
+  /// Replace the contents of this symbol table with the one cached for \a
+  /// objfile in the symbol table cache, see
+  /// ModuleListProperties::GetSymtabCachePath().
+  ///
+  /// The name and file address indexes are loaded as well, so no symbol
+  /// needs to be demangled again.
+  ///
+  /// \param[in] objfile
+  ///     The object file this symbol table is created for.
+  ///
+  /// \param[out] objfile_data
+  ///     If not null, receives the data \a objfile passed to SaveToCache().
+  ///
+  /// \return
+  ///     True if the cache had an up-to-date entry for \a objfile.
+  bool LoadFromCache(ObjectFile &objfile, std::string *objfile_data = nullptr);
+
+  /// Write this symbol table and its indexes to the symbol table cache if it
+  /// is enabled, computing the name indexes first if needed.
+  ///
+  /// \param[in] objfile
+  ///     The object file this symbol table was created for.
+  ///
+  /// \param[in] objfile_data
+  ///     Additional data the object file needs to restore its own state when
+  ///     the symbol table is loaded from the cache.
+  void SaveToCache(ObjectFile &objfile, llvm::StringRef objfile_data = {});
+
 protected:
   typedef std::vector<Symbol> collection;
   typedef collection::iterator iterator;
@@ -193,14 +223,10 @@ private:
   void SymbolIndicesToSymbolContextList(std::vector<uint32_t> &symbol_indexes,
                                         SymbolContextList &sc_list);
 
-  void RegisterMangledNameEntry(
-      uint32_t value, std::set<const char *> &class_contexts,
-      std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-      RichManglingContext &rmc);
+  void Encode(llvm::raw_ostream &os, ConstStringTable &strtab) const;
 
-  void RegisterBacklogEntry(const NameToIndexMap::Entry &entry,
-                            const char *decl_context,
-                            const std::set<const char *> &class_contexts);
+  bool Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
+              const ConstStringTableReader &strtab);
 
   DISALLOW_COPY_AND_ASSIGN(Symtab);
 };
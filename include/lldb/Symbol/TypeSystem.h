@@ -94,6 +94,11 @@ public:
 
   LLVMCastKind getKind() const { return m_kind; }
 
+  /// Unlike the address of a TypeSystem, this ID is never reused by a later
+  /// one, so together with an opaque type it identifies a type even after
+  /// its TypeSystem was destroyed.
+  uint64_t GetUniqueID() const { return m_unique_id; }
+
   static lldb::TypeSystemSP CreateInstance(lldb::LanguageType language,
                                            Module *module);
 
@@ -533,6 +538,7 @@ public:
   virtual void DiagnoseWarnings(Process &process, Module &module) const;
 protected:
   const LLVMCastKind m_kind; // Support for llvm casting
+  const uint64_t m_unique_id;
   SymbolFile *m_sym_file;
 };
 
@@ -9,11 +9,16 @@
 #ifndef liblldb_UnwindTable_h
 #define liblldb_UnwindTable_h
 
-#include <map>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include "lldb/lldb-private.h"
 
+namespace llvm {
+template <typename T> class SpecificBumpPtrAllocator;
+}
+
 namespace lldb_private {
 
 // A class which holds all the FuncUnwinders objects for a given ObjectFile.
@@ -54,6 +59,10 @@ public:
 
   ArchSpec GetArchitecture();
 
+  /// Build the indexes of the unwind information now, rather than the first
+  /// time a function is unwound.
+  void Preload();
+
 private:
   void Dump(Stream &s);
 
@@ -61,13 +70,32 @@ private:
   llvm::Optional<AddressRange> GetAddressRange(const Address &addr,
                                                SymbolContext &sc);
 
-  typedef std::map<lldb::addr_t, lldb::FuncUnwindersSP> collection;
+  // The FuncUnwinders sorted by the file address of their function.
+  typedef std::vector<std::pair<lldb::addr_t, lldb::FuncUnwindersSP>>
+      collection;
   typedef collection::iterator iterator;
   typedef collection::const_iterator const_iterator;
 
+  static lldb::FuncUnwindersSP FindContainingAddress(const collection &unwinds,
+                                                     const Address &addr);
+
+  // Move the FuncUnwinders of m_new_unwinds into m_unwinds.
+  void MergeNewUnwinds();
+
   Module &m_module;
   collection m_unwinds;
 
+  // The FuncUnwinders created since m_unwinds was last merged with them, also
+  // sorted. Inserting into the short list and merging the two in batches keeps
+  // a new FuncUnwinders from moving the whole of m_unwinds.
+  collection m_new_unwinds;
+
+  // The FuncUnwinders in m_unwinds are allocated from this arena. The shared
+  // pointers to them share ownership of the arena, so it is freed with the
+  // last of them.
+  std::shared_ptr<llvm::SpecificBumpPtrAllocator<FuncUnwinders>>
+      m_unwinds_allocator_sp;
+
   bool m_initialized; // delay some initialization until ObjectFile is set up
   std::mutex m_mutex;
 
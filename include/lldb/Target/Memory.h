@@ -11,15 +11,43 @@
 
 #include "lldb/Utility/RangeMap.h"
 #include "lldb/lldb-private.h"
+#include <list>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace lldb_private {
 // A class to track memory that was read from a live process between
 // runs.
+//
+// Memory is cached in lines of a fixed size (the "memory-cache-line-size"
+// process setting) in the L2 cache. Its total size is bounded by the
+// "memory-cache-max-byte-size" setting, when the limit is reached the least
+// recently used lines are dropped. When lines are read in ascending order,
+// the number of lines read ahead with each miss grows up to the
+// "memory-cache-prefetch-max-lines" setting, so that walking a large data
+// structure results in a few large reads instead of one per line.
 class MemoryCache {
 public:
+  struct Statistics {
+    /// Number of cache lines a read found in the cache.
+    uint64_t hits = 0;
+    /// Number of cache lines a read had to read from the process.
+    uint64_t misses = 0;
+    /// Number of cache lines read ahead of a read.
+    uint64_t prefetched_lines = 0;
+    /// Number of reads from the process.
+    uint64_t process_reads = 0;
+    /// Number of bytes read from the process.
+    uint64_t process_bytes_read = 0;
+    /// Number of cache lines dropped because the cache was full.
+    uint64_t evictions = 0;
+    /// Number of cache lines of read-only sections kept across a stop.
+    uint64_t retained_lines = 0;
+  };
+
   // Constructors and Destructors
   MemoryCache(Process &process);
 
@@ -27,6 +55,11 @@ public:
 
   void Clear(bool clear_invalid_ranges = false);
 
+  /// Clear all cached memory that the process may have modified while it was
+  /// running. Lines that belong to loaded sections which are not writable,
+  /// like .text or .rodata, are kept.
+  void ClearWritableMemory();
+
   void Flush(lldb::addr_t addr, size_t size);
 
   size_t Read(lldb::addr_t addr, void *dst, size_t dst_len, Status &error);
@@ -43,20 +76,61 @@ public:
   void AddL1CacheData(lldb::addr_t addr,
                       const lldb::DataBufferSP &data_buffer_sp);
 
+  /// Add memory that was read from the process to the cache lines. Only the
+  /// lines that lie entirely within [addr, addr + src_len) are added.
+  void AddL2CacheData(lldb::addr_t addr, const void *src, size_t src_len);
+
+  Statistics GetStatistics();
+
 protected:
+  struct CacheLine {
+    lldb::DataBufferSP data;
+    // The position of the line in m_L2_lru.
+    std::list<lldb::addr_t>::iterator lru_pos;
+    // The section the line belongs to if the section is not writable, and the
+    // address the section was loaded at when the line was read.
+    std::weak_ptr<Section> read_only_section;
+    lldb::addr_t section_load_addr = LLDB_INVALID_ADDRESS;
+  };
+
   typedef std::map<lldb::addr_t, lldb::DataBufferSP> BlockMap;
+  typedef std::unordered_map<lldb::addr_t, CacheLine> LineMap;
   typedef RangeArray<lldb::addr_t, lldb::addr_t, 4> InvalidRanges;
   typedef Range<lldb::addr_t, lldb::addr_t> AddrRange;
+
+  void ReadSettings();
+
+  /// Read the line at \a line_addr and the lines that are needed to read \a
+  /// byte_size bytes from there, plus the lines to prefetch, from the
+  /// process into the cache.
+  ///
+  /// \return
+  ///     The number of bytes read from the process.
+  size_t FillLines(lldb::addr_t line_addr, size_t byte_size, Status &error);
+
+  void AddLine(lldb::addr_t line_addr, lldb::DataBufferSP data_sp);
+
+  void RemoveLine(LineMap::iterator pos);
+
   // Classes that inherit from MemoryCache can see and modify these
   std::recursive_mutex m_mutex;
   BlockMap m_L1_cache; // A first level memory cache whose chunk sizes vary that
                        // will be used only if the memory read fits entirely in
                        // a chunk
-  BlockMap m_L2_cache; // A memory cache of fixed size chinks
+  LineMap m_L2_cache;  // A memory cache of fixed size chinks
                        // (m_L2_cache_line_byte_size bytes in size each)
+  std::list<lldb::addr_t> m_L2_lru; // Most recently used line first.
+  uint64_t m_L2_cache_byte_size = 0;
   InvalidRanges m_invalid_ranges;
   Process &m_process;
   uint32_t m_L2_cache_line_byte_size;
+  uint64_t m_L2_cache_max_byte_size = 0;
+  uint32_t m_prefetch_max_lines = 0;
+  // The number of lines to read with the next miss, and the address after the
+  // last line read, to detect sequential reads.
+  uint32_t m_prefetch_lines = 1;
+  lldb::addr_t m_prefetch_next_addr = LLDB_INVALID_ADDRESS;
+  Statistics m_stats;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(MemoryCache);
@@ -50,6 +50,7 @@
 #include "lldb/lldb-private.h"
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/VersionTuple.h"
 
@@ -68,6 +69,8 @@ public:
 
   bool GetDisableMemoryCache() const;
   uint64_t GetMemoryCacheLineSize() const;
+  uint64_t GetMemoryCacheMaxByteSize() const;
+  uint64_t GetMemoryCachePrefetchMaxLines() const;
   Args GetExtraStartupCommands() const;
   void SetExtraStartupCommands(const Args &args);
   FileSpec GetPythonOSPluginPath() const;
@@ -83,6 +86,8 @@ public:
   bool GetWarningsOptimization() const;
   bool GetStopOnExec() const;
   std::chrono::seconds GetUtilityExpressionTimeout() const;
+  bool GetParallelUnwind() const;
+  uint64_t GetStackPrefetchSize() const;
 
 protected:
   static void OptionValueChangedCallback(void *baton,
@@ -1433,6 +1438,26 @@ public:
   virtual size_t DoReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                               Status &error) = 0;
 
+  /// Actually do the reading of several ranges of memory from a process.
+  ///
+  /// The default implementation reads the ranges one after the other with
+  /// DoReadMemory(). Subclasses can override this to read all ranges with a
+  /// single request.
+  ///
+  /// \param[in] ranges
+  ///     The load address and size of every range to read.
+  ///
+  /// \param[out] buf
+  ///     A byte buffer that is large enough for all ranges. The bytes of
+  ///     every range are stored right after the bytes of the previous range.
+  ///
+  /// \param[out] bytes_read
+  ///     Receives the number of bytes read from each range, which is less
+  ///     than the size of the range if it could only be read partially.
+  virtual void DoReadMemoryRanges(llvm::ArrayRef<LoadRange> ranges,
+                                  uint8_t *buf,
+                                  llvm::MutableArrayRef<size_t> bytes_read);
+
   /// Read of memory from a process.
   ///
   /// This function will read memory from the current process's address space
@@ -1499,6 +1524,86 @@ public:
   size_t ReadMemoryFromInferior(lldb::addr_t vm_addr, void *buf, size_t size,
                                 Status &error);
 
+  /// Read several ranges of memory from a process.
+  ///
+  /// This is much faster than reading the ranges one by one when every read
+  /// is a round trip to a remote debug server. Like ReadMemoryFromInferior,
+  /// this bypasses caching and removes any traps that may have been
+  /// inserted into the memory.
+  ///
+  /// \param[in] ranges
+  ///     The load address and size of every range to read.
+  ///
+  /// \param[out] buf
+  ///     A byte buffer that is large enough for all ranges. The bytes of
+  ///     every range are stored right after the bytes of the previous range.
+  ///
+  /// \param[out] bytes_read
+  ///     Receives the number of bytes read from each range, which is less
+  ///     than the size of the range if it could only be read partially.
+  ///
+  /// \return
+  ///     The number of bytes read from all ranges.
+  size_t ReadMemoryRanges(llvm::ArrayRef<LoadRange> ranges, void *buf,
+                          std::vector<size_t> &bytes_read);
+
+  /// Get the hit, miss and traffic counters of the memory cache used by
+  /// ReadMemory().
+  MemoryCache::Statistics GetMemoryCacheStatistics() {
+    return m_memory_cache.GetStatistics();
+  }
+
+  /// Get the number of requests that had to wait for a reply from the remote
+  /// debug server, or zero if the process plugin doesn't use one.
+  virtual uint64_t GetRemoteRoundTripCount() { return 0; }
+
+  /// Counters of the stack frames the unwinders of the threads computed and
+  /// kept from the previous stop.
+  struct UnwindStatistics {
+    /// Number of frames unwound from the frame below them.
+    uint64_t frames_unwound = 0;
+    /// Number of unwound frames that matched a frame of the previous stop.
+    uint64_t frames_matched = 0;
+    /// Number of frames kept from the previous stop.
+    uint64_t frames_reused = 0;
+    /// Number of frames of the previous stop that couldn't be kept because
+    /// the values they were unwound from changed.
+    uint64_t frames_rejected = 0;
+    /// Number of stack frames that took their symbol context from the
+    /// previous stop.
+    uint64_t symbol_contexts_reused = 0;
+  };
+
+  UnwindStatistics GetUnwindStatistics();
+
+  /// Add \a stats to the unwind counters. Threads unwind concurrently and
+  /// this takes a lock, so the unwinders count the frames of an unwind
+  /// locally and add them in one go when it is done.
+  void AddUnwindStatistics(const UnwindStatistics &stats);
+
+  /// Unwind the stacks of \a threads on the task pool.
+  ///
+  /// The top of every stack is read into the memory cache with one request
+  /// first, then the threads are unwound concurrently and the symbol
+  /// contexts of their frames are looked up. Threads are unwound one after
+  /// the other if the "parallel-unwind" setting is off or an operating
+  /// system plug-in provides the threads.
+  ///
+  /// \param[in] threads
+  ///     The threads to unwind. Null entries are skipped, but still handed
+  ///     to \a callback.
+  ///
+  /// \param[in] max_frames
+  ///     The number of frames to unwind per thread, UINT32_MAX for all.
+  ///
+  /// \param[in] callback
+  ///     Called on the calling thread with the index of every thread in \a
+  ///     threads, in order, as soon as that thread is unwound. Returning
+  ///     false skips the remaining threads.
+  void UnwindThreads(llvm::ArrayRef<lldb::ThreadSP> threads,
+                     uint32_t max_frames,
+                     llvm::function_ref<bool(size_t)> callback);
+
   /// Read a NULL terminated string from memory
   ///
   /// This function will read a cache page at a time until a NULL string
@@ -1689,6 +1794,27 @@ public:
     return LLDB_INVALID_ADDRESS;
   }
 
+  /// Actually allocate memory in the process, preferably at \a hint.
+  ///
+  /// \param[in] size
+  ///     The size of the allocation requested.
+  ///
+  /// \param[in] hint
+  ///     The address the allocation should start at. The memory can be
+  ///     allocated elsewhere if \a hint isn't available.
+  ///
+  /// \return
+  ///     The address of the allocated buffer in the process, or
+  ///     LLDB_INVALID_ADDRESS if the allocation failed. The memory is
+  ///     released with DoDeallocateMemory().
+  virtual lldb::addr_t DoAllocateMemoryAt(size_t size, uint32_t permissions,
+                                          lldb::addr_t hint, Status &error) {
+    error.SetErrorStringWithFormat(
+        "error: %s does not support allocating memory at an address",
+        GetPluginName().GetCString());
+    return LLDB_INVALID_ADDRESS;
+  }
+
   virtual Status WriteObjectFile(std::vector<ObjectFile::LoadableData> entries);
 
   /// The public interface to allocating memory in the process.
@@ -1714,6 +1840,36 @@ public:
   ///     LLDB_INVALID_ADDRESS if the allocation failed.
   lldb::addr_t AllocateMemory(size_t size, uint32_t permissions, Status &error);
 
+  /// Allocate memory in the process within \a max_distance bytes of \a
+  /// near_addr.
+  ///
+  /// The memory doesn't come from the allocated memory cache, it is searched
+  /// for in the unmapped regions around \a near_addr and must be released
+  /// with DoDeallocateMemory().
+  ///
+  /// \param[in] size
+  ///     The size of the allocation requested.
+  ///
+  /// \param[in] permissions
+  ///     Or together any of the lldb::Permissions bits.
+  ///
+  /// \param[in] near_addr
+  ///     The address the memory should be close to.
+  ///
+  /// \param[in] max_distance
+  ///     The maximum distance between \a near_addr and any byte of the
+  ///     allocation.
+  ///
+  /// \param[in,out] error
+  ///     An error object to fill in if things go wrong.
+  ///
+  /// \return
+  ///     The address of the allocated buffer in the process, or
+  ///     LLDB_INVALID_ADDRESS if the allocation failed.
+  lldb::addr_t AllocateMemoryNear(size_t size, uint32_t permissions,
+                                  lldb::addr_t near_addr,
+                                  lldb::addr_t max_distance, Status &error);
+
   /// The public interface to allocating memory in the process, this also
   /// clears the allocated memory.
   ///
@@ -2020,6 +2176,15 @@ public:
     return error;
   }
 
+  /// Whether a thread that is resumed at \a bp_site is moved past the
+  /// breakpoint by the process plug-in itself.
+  ///
+  /// Otherwise the breakpoint site is disabled while the thread single steps
+  /// over it, and other threads that run meanwhile miss its hits.
+  virtual bool StepsOverBreakpointSite(BreakpointSite &bp_site) {
+    return false;
+  }
+
   // This is implemented completely using the lldb::Process API. Subclasses
   // don't need to implement this function unless the standard flow of read
   // existing opcode, write breakpoint opcode, verify breakpoint opcode doesn't
@@ -2032,6 +2197,15 @@ public:
   // doesn't work for a specific process plug-in.
   virtual Status DisableSoftwareBreakpoint(BreakpointSite *bp_site);
 
+  // Replace the instructions at the site with a jump to a trampoline that
+  // records the hit and continues, see FastTracepoint. The process must be
+  // stopped.
+  Status EnableFastTracepoint(BreakpointSite *bp_site);
+
+  // Restore the instructions at a fast tracepoint site. The trampoline is
+  // freed if no thread can still be executing it.
+  Status DisableFastTracepoint(BreakpointSite *bp_site);
+
   BreakpointSiteList &GetBreakpointSiteList();
 
   const BreakpointSiteList &GetBreakpointSiteList() const;
@@ -2724,6 +2898,8 @@ protected:
   Predicate<uint32_t> m_iohandler_sync;
   MemoryCache m_memory_cache;
   AllocatedMemoryCache m_allocated_memory_cache;
+  std::mutex m_unwind_stats_mutex;
+  UnwindStatistics m_unwind_stats;
   bool m_should_detach; /// Should we detach if the process object goes away
                         /// with an explicit call to Kill or Detach?
   LanguageRuntimeCollection m_language_runtimes;
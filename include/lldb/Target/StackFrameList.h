@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "lldb/Target/StackFrame.h"
+#include "llvm/ADT/DenseMap.h"
 
 namespace lldb_private {
 
@@ -98,6 +99,15 @@ protected:
 
   void SynthesizeTailCallFrames(StackFrame &next_frame);
 
+  /// Find the symbol context of the concrete frame of the previous stop with
+  /// the same CFA and pc, which describes the same code.
+  ///
+  /// \return
+  ///     The symbol context, or nullptr if there is no such frame.
+  const SymbolContext *GetPreviousSymbolContext(lldb::addr_t cfa,
+                                                lldb::addr_t pc,
+                                                bool behaves_like_zeroth_frame);
+
   bool GetAllFramesFetched() { return m_concrete_frames_fetched == UINT32_MAX; }
 
   void SetAllFramesFetched() { m_concrete_frames_fetched = UINT32_MAX; }
@@ -124,6 +134,11 @@ protected:
   // source of information.
   lldb::StackFrameListSP m_prev_frames_sp;
 
+  /// The concrete frames of the old stack frame list by CFA and pc, built
+  /// when it is first needed.
+  llvm::DenseMap<std::pair<lldb::addr_t, lldb::addr_t>, StackFrame *>
+      m_prev_concrete_frames;
+
   /// A mutex for this frame list.
   // TODO: This mutex may not always be held when required. In particular, uses
   // of the StackFrameList APIs in lldb_private::Thread look suspect. Consider
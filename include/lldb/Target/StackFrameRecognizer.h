@@ -129,7 +129,8 @@ public:
 class ValueObjectRecognizerSynthesizedValue : public ValueObject {
  public:
   static lldb::ValueObjectSP Create(ValueObject &parent, lldb::ValueType type) {
-    return (new ValueObjectRecognizerSynthesizedValue(parent, type))->GetSP();
+    return (new (parent) ValueObjectRecognizerSynthesizedValue(parent, type))
+        ->GetSP();
   }
   ValueObjectRecognizerSynthesizedValue(ValueObject &parent,
                                         lldb::ValueType type)
@@ -43,6 +43,8 @@
 #include "lldb/Utility/LLDBAssert.h"
 #include "lldb/Utility/Timeout.h"
 #include "lldb/lldb-public.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringMap.h"
 
 namespace lldb_private {
 
@@ -157,6 +159,8 @@ public:
 
   bool GetEnableNotifyAboutFixIts() const;
 
+  uint64_t GetExpressionCacheSize() const;
+
   bool GetEnableSaveObjects() const;
 
   bool GetEnableSyntheticValue() const;
@@ -572,6 +576,26 @@ public:
   lldb::ModuleSP GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
                                    Status *error_ptr = nullptr);
 
+  /// Find or create the Modules for a list of binaries at once.
+  ///
+  /// This behaves like calling GetOrCreateModule for each element of
+  /// \a module_specs, but the symbols of all Modules that are new to this
+  /// Target are preloaded in parallel before the Modules are added to the
+  /// Target's image list, in the order of \a module_specs. Dynamic loaders
+  /// should use this when they learn about many binaries at the same time.
+  ///
+  /// \param[in] module_specs
+  ///     The criteria that must be matched for each binary being loaded.
+  ///
+  /// \param[in] notify
+  ///     See GetOrCreateModule.
+  ///
+  /// \return
+  ///     One ModuleSP per element of \a module_specs, empty where no
+  ///     matching file was found.
+  std::vector<lldb::ModuleSP>
+  GetOrCreateModules(llvm::ArrayRef<ModuleSpec> module_specs, bool notify);
+
   // Settings accessors
 
   static const lldb::TargetPropertiesSP &GetGlobalProperties();
@@ -1092,6 +1116,19 @@ public:
                                const EvaluateExpressionOptions &options,
                                ValueObject *ctx_obj, Status &error);
 
+  /// Get an expression that UserExpression::Evaluate prepared before under
+  /// \a key, or null if there is none.
+  lldb::UserExpressionSP GetCachedUserExpression(llvm::StringRef key);
+
+  /// Keep a parsed expression for reuse, dropping the least recently used
+  /// one when there are more than "target.expression-cache-size".
+  void CacheUserExpression(llvm::StringRef key,
+                           const lldb::UserExpressionSP &expr_sp);
+
+  /// Drop all cached expressions, e.g. because the code or the symbols they
+  /// were compiled against changed.
+  void ClearUserExpressionCache();
+
   // Creates a FunctionCaller for the given language, the rest of the
   // parameters have the same meaning as for the FunctionCaller constructor.
   // Since a FunctionCaller can't be
@@ -1433,6 +1470,16 @@ protected:
   /// Guards the scratch typesystem from being re-initialized.
   SharedMutex m_scratch_typesystem_lock;
 
+  struct CachedUserExpression {
+    lldb::UserExpressionSP expr_sp;
+    /// The position of the entry in m_user_expression_lru.
+    std::list<llvm::StringRef>::iterator lru_pos;
+  };
+  std::mutex m_user_expression_cache_mutex;
+  llvm::StringMap<CachedUserExpression> m_user_expression_cache;
+  /// The keys of m_user_expression_cache, most recently used first.
+  std::list<llvm::StringRef> m_user_expression_lru;
+
   static void ImageSearchPathsChanged(const PathMappingList &path_list,
                                       void *baton);
 
@@ -1470,6 +1517,18 @@ private:
   // Helper function.
   bool ProcessIsValid();
 
+  /// Find or create the Module for \a module_spec without adding it to the
+  /// image list. \a is_new is set if the returned Module is not in the image
+  /// list yet, in which case \a old_module_sp may be set to a Module it
+  /// replaces.
+  lldb::ModuleSP FindOrCreateModule(const ModuleSpec &module_spec,
+                                    lldb::ModuleSP &old_module_sp,
+                                    bool &is_new, Status *error_ptr);
+
+  /// Add a Module returned by FindOrCreateModule to the image list.
+  void AddNewModule(const lldb::ModuleSP &module_sp,
+                    lldb::ModuleSP old_module_sp, bool notify);
+
   // Copy breakpoints, stop hooks and so forth from the dummy target:
   void PrimeFromDummyTarget(Target *dummy_target);
 
@@ -0,0 +1,125 @@
+//===-- AgentExpression.h ---------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLDB_UTILITY_AGENTEXPRESSION_H
+#define LLDB_UTILITY_AGENTEXPRESSION_H
+
+#include "lldb/lldb-types.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Error.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace lldb_private {
+
+/// \class AgentExpression AgentExpression.h "lldb/Utility/AgentExpression.h"
+/// A GDB agent expression.
+///
+/// Agent expressions are the stack machine bytecode GDB remote stubs use to
+/// evaluate breakpoint conditions without reporting every hit to the
+/// debugger. The debugger builds them with the Append methods, the stub
+/// evaluates them with Evaluate(). Only the subset of the opcodes that deals
+/// with integers is supported, tracing and floating point opcodes are
+/// rejected.
+class AgentExpression {
+public:
+  enum Opcode : uint8_t {
+    eOpAdd = 0x02,
+    eOpSub = 0x03,
+    eOpMul = 0x04,
+    eOpDivSigned = 0x05,
+    eOpDivUnsigned = 0x06,
+    eOpRemSigned = 0x07,
+    eOpRemUnsigned = 0x08,
+    eOpLsh = 0x09,
+    eOpRshSigned = 0x0a,
+    eOpRshUnsigned = 0x0b,
+    eOpLogNot = 0x0e,
+    eOpBitAnd = 0x0f,
+    eOpBitOr = 0x10,
+    eOpBitXor = 0x11,
+    eOpBitNot = 0x12,
+    eOpEqual = 0x13,
+    eOpLessSigned = 0x14,
+    eOpLessUnsigned = 0x15,
+    eOpExt = 0x16,
+    eOpRef8 = 0x17,
+    eOpRef16 = 0x18,
+    eOpRef32 = 0x19,
+    eOpRef64 = 0x1a,
+    eOpIfGoto = 0x20,
+    eOpGoto = 0x21,
+    eOpConst8 = 0x22,
+    eOpConst16 = 0x23,
+    eOpConst32 = 0x24,
+    eOpConst64 = 0x25,
+    eOpReg = 0x26,
+    eOpEnd = 0x27,
+    eOpDup = 0x28,
+    eOpPop = 0x29,
+    eOpZeroExt = 0x2a,
+    eOpSwap = 0x2b,
+    eOpPick = 0x32,
+    eOpRot = 0x33,
+  };
+
+  /// Reads the value of the register with the given stub register number.
+  typedef llvm::function_ref<llvm::Expected<uint64_t>(uint32_t reg_num)>
+      ReadRegisterCallback;
+
+  /// Reads \a size bytes of memory at \a addr as a target-endian integer.
+  typedef llvm::function_ref<llvm::Expected<uint64_t>(lldb::addr_t addr,
+                                                      uint32_t size)>
+      ReadMemoryCallback;
+
+  AgentExpression() = default;
+
+  explicit AgentExpression(std::vector<uint8_t> bytecode)
+      : m_bytecode(std::move(bytecode)) {}
+
+  llvm::ArrayRef<uint8_t> GetBytecode() const { return m_bytecode; }
+
+  bool IsEmpty() const { return m_bytecode.empty(); }
+
+  void AppendOpcode(Opcode op) { m_bytecode.push_back(op); }
+
+  /// Appends the shortest const opcode that can push \a value.
+  void AppendConstant(uint64_t value);
+
+  /// Appends a reg opcode for the stub register \a reg_num.
+  void AppendRegister(uint32_t reg_num);
+
+  /// Appends the ref opcode reading \a byte_size bytes, followed by an ext
+  /// opcode if the value is signed and narrower than 64 bits.
+  ///
+  /// \return
+  ///     False if \a byte_size is not 1, 2, 4 or 8.
+  bool AppendMemoryRead(uint32_t byte_size, bool is_signed);
+
+  /// Appends an ext or zero_ext opcode that truncates the value on top of
+  /// the stack to \a bits bits.
+  void AppendExtend(uint8_t bits, bool is_signed);
+
+  /// Evaluates the expression.
+  ///
+  /// \return
+  ///     The value on top of the stack when the end opcode is reached, or an
+  ///     error if the bytecode is malformed, uses an unsupported opcode, or
+  ///     a register or memory read fails.
+  llvm::Expected<uint64_t> Evaluate(ReadRegisterCallback read_register,
+                                    ReadMemoryCallback read_memory) const;
+
+private:
+  std::vector<uint8_t> m_bytecode;
+};
+
+} // namespace lldb_private
+
+#endif // LLDB_UTILITY_AGENTEXPRESSION_H
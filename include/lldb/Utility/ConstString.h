@@ -9,10 +9,14 @@
 #ifndef liblldb_ConstString_h_
 #define liblldb_ConstString_h_
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/FormatVariadic.h"
 
+#include <vector>
+
 #include <stddef.h>
+#include <stdint.h>
 
 namespace lldb_private {
 class Stream;
@@ -436,11 +440,82 @@ public:
   ///     in memory.
   static size_t StaticMemorySize();
 
+  /// Add many strings to the global string pool at once.
+  ///
+  /// This is equivalent to constructing a ConstString from every string in \a
+  /// strings, but the strings are grouped by string pool shard first so that
+  /// the lock of every shard is taken at most once per call. Use this when
+  /// many strings are created together, e.g. while indexing debug info from
+  /// several threads.
+  ///
+  /// \param[in] strings
+  ///     The strings to add to the string pool.
+  ///
+  /// \return
+  ///     The uniqued strings, in the same order as \a strings.
+  static std::vector<ConstString>
+  FromStrings(llvm::ArrayRef<llvm::StringRef> strings);
+
+  /// Counters describing the size and usage of the global string pool.
+  struct PoolStatistics {
+    /// Number of unique strings in the pool.
+    uint64_t num_strings = 0;
+    /// Bytes used by the pool, see ConstString::StaticMemorySize().
+    uint64_t memory_size = 0;
+    /// Number of strings that were looked up to be added to the pool.
+    uint64_t lookups = 0;
+    /// Number of lookups that added a new string to the pool.
+    uint64_t insertions = 0;
+    /// Number of times a shard lock was taken to intern strings.
+    uint64_t lock_acquisitions = 0;
+    /// Number of lock acquisitions during which another thread was using the
+    /// same shard. Only counted in debug builds, counting them needs every
+    /// thread to update the same shared counter.
+    uint64_t lock_contentions = 0;
+  };
+
+  /// Get a snapshot of the global string pool counters.
+  static PoolStatistics GetPoolStatistics();
+
 protected:
   // Member variables
   const char *m_string;
 };
 
+/// \class ConstStringBatch ConstString.h "lldb/Utility/ConstString.h"
+/// Collects strings and adds them to the global string pool in one go.
+///
+/// Every thread that creates many ConstStrings, like a debug info indexing
+/// task, can stage its strings in its own batch and intern them all with a
+/// single call to ConstString::FromStrings() instead of taking a string pool
+/// lock for every string.
+class ConstStringBatch {
+public:
+  /// Stage \a s to be added to the string pool.
+  ///
+  /// The data \a s refers to must stay valid until Flush() is called.
+  ///
+  /// \return
+  ///     The index of the uniqued string in the result of Flush().
+  size_t Add(llvm::StringRef s) {
+    m_strings.push_back(s);
+    return m_strings.size() - 1;
+  }
+
+  size_t GetSize() const { return m_strings.size(); }
+
+  bool IsEmpty() const { return m_strings.empty(); }
+
+  /// Add all staged strings to the string pool and empty the batch.
+  ///
+  /// \return
+  ///     The uniqued strings, indexed by the values returned by Add().
+  std::vector<ConstString> Flush();
+
+private:
+  std::vector<llvm::StringRef> m_strings;
+};
+
 /// Stream the string value \a str to the stream \a s
 Stream &operator<<(Stream &s, ConstString str);
 
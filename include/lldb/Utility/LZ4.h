@@ -0,0 +1,45 @@
+//===-- LZ4.h ---------------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLDB_UTILITY_LZ4_H
+#define LLDB_UTILITY_LZ4_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/Error.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace lldb_private {
+
+/// Compression in the LZ4 block format.
+///
+/// This is the format remote stubs use for the "lz4" packet compression,
+/// libcompression calls it COMPRESSION_LZ4_RAW. It is implemented here so
+/// that lldb and lldb-server can use it on hosts without libcompression.
+/// Blocks don't record their uncompressed size, the caller has to know it.
+namespace lz4 {
+
+/// Compress \a input into a single block and append it to \a output.
+///
+/// The compressor looks for matches with a small hash table and takes the
+/// first one it finds, which favors speed over the compression ratio.
+void Compress(llvm::ArrayRef<uint8_t> input, std::vector<uint8_t> &output);
+
+/// Decompress the block \a input into \a output.
+///
+/// \return
+///     The number of bytes written to \a output, or an error if the block
+///     is malformed or doesn't fit into \a output.
+llvm::Expected<size_t> Decompress(llvm::ArrayRef<uint8_t> input,
+                                  llvm::MutableArrayRef<uint8_t> output);
+
+} // namespace lz4
+} // namespace lldb_private
+
+#endif // LLDB_UTILITY_LZ4_H
@@ -13,6 +13,7 @@
 #include "lldb/Utility/SharingPtr.h"
 
 #include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Support/Allocator.h"
 
 #include <mutex>
 
@@ -60,6 +61,14 @@ public:
     m_objects.insert(new_object);
   }
 
+  /// Allocate memory for an object of the cluster. The memory is only
+  /// released, all at once, when the cluster is destroyed, so objects placed
+  /// in it must not free it when they are deleted.
+  void *Allocate(size_t size, size_t alignment) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_allocator.Allocate(size, alignment);
+  }
+
   typename lldb_private::SharingPtr<T> GetSharedPointer(T *desired_object) {
     {
       std::lock_guard<std::mutex> guard(m_mutex);
@@ -86,6 +95,7 @@ private:
   friend class imp::shared_ptr_refcount<ClusterManager>;
 
   llvm::SmallPtrSet<T *, 16> m_objects;
+  llvm::BumpPtrAllocator m_allocator;
   int m_external_ref;
   std::mutex m_mutex;
 };
@@ -73,6 +73,7 @@ public:
     eServerPacketType_qFileLoadAddress,
     eServerPacketType_QEnvironment,
     eServerPacketType_QEnableErrorStrings,
+    eServerPacketType_QEnableCompression,
     eServerPacketType_QLaunchArch,
     eServerPacketType_QSetDisableASLR,
     eServerPacketType_QSetDetachOnError,
@@ -98,6 +99,7 @@ public:
     // debug server packages
     eServerPacketType_QEnvironmentHexEncoded,
     eServerPacketType_QListThreadsInStopReply,
+    eServerPacketType_QNonStop,
     eServerPacketType_QPassSignals,
     eServerPacketType_QRestoreRegisterState,
     eServerPacketType_QSaveRegisterState,
@@ -125,6 +127,7 @@ public:
     eServerPacketType_qSyncThreadStateSupported,
     eServerPacketType_qThreadExtraInfo,
     eServerPacketType_qThreadStopInfo,
+    eServerPacketType_qThreadsInfoBinary,
     eServerPacketType_qVAttachOrWaitSupported,
     eServerPacketType_qWatchpointSupportInfo,
     eServerPacketType_qWatchpointSupportInfoSupported,
@@ -139,6 +142,7 @@ public:
     eServerPacketType_vAttachName,
     eServerPacketType_vCont,
     eServerPacketType_vCont_actions, // vCont?
+    eServerPacketType_vStopped,
 
     eServerPacketType_stop_reason, // '?'
 
@@ -171,6 +175,8 @@ public:
     eServerPacketType_jTraceMetaRead,
     eServerPacketType_jTraceStop,
     eServerPacketType_jTraceConfigRead,
+
+    eServerPacketType_MultiMemRead,
   };
 
   ServerPacketType GetServerPacketType() const;
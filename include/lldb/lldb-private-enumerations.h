@@ -236,7 +236,9 @@ enum StatisticKind {
   ExpressionFailure = 1,
   FrameVarSuccess = 2,
   FrameVarFailure = 3,
-  StatisticMax = 4
+  ExpressionCacheHit = 4,
+  ExpressionCacheMiss = 5,
+  StatisticMax = 6
 };
 
 
@@ -250,6 +252,10 @@ inline std::string GetStatDescription(lldb_private::StatisticKind K) {
      return "Number of frame var successes";
    case StatisticKind::FrameVarFailure:
      return "Number of frame var failures";
+   case StatisticKind::ExpressionCacheHit:
+     return "Number of expr evaluations reusing a parsed expression";
+   case StatisticKind::ExpressionCacheMiss:
+     return "Number of expr evaluations parsing the expression";
    case StatisticKind::StatisticMax:
      return "";
    }
@@ -0,0 +1,41 @@
+# Test that the address classes the ARM mapping symbols give to code are
+# restored when the symbol table comes from the symbol table cache, so Thumb
+# code is still disassembled as Thumb.
+
+# REQUIRES: lld, arm
+
+# RUN: llvm-mc -triple=armv7-linux-gnueabihf %s -filetype=obj -o %t.o
+# RUN: ld.lld %t.o --build-id -o %t
+# RUN: rm -rf %t.cache
+# RUN: %lldb %t -b -O "settings set symbols.symtab-cache-path %t.cache" \
+# RUN:   -o "disassemble -n _start" -o "disassemble -n thumb_func" \
+# RUN:   | FileCheck %s
+# RUN: ls %t.cache | FileCheck --check-prefix=CACHE %s
+# RUN: %lldb %t -b -O "settings set symbols.symtab-cache-path %t.cache" \
+# RUN:   -o "disassemble -n _start" -o "disassemble -n thumb_func" \
+# RUN:   | FileCheck %s
+
+# CHECK-LABEL: disassemble -n _start
+# CHECK: <+0>: mov r0, #0x1
+# CHECK-NEXT: <+4>: bx lr
+# CHECK-LABEL: disassemble -n thumb_func
+# CHECK: <+0>: movs r0, #0x2
+# CHECK-NEXT: <+2>: bx lr
+# CACHE: {{[0-9A-F]+}}-symtab-cache-arm.s.tmp.symtab
+
+        .syntax unified
+        .text
+        .arm
+        .globl  _start
+        .type   _start,%function
+_start:
+        mov     r0, #1
+        bx      lr
+
+        .thumb
+        .globl  thumb_func
+        .type   thumb_func,%function
+        .thumb_func
+thumb_func:
+        movs    r0, #2
+        bx      lr
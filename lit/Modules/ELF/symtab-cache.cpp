@@ -0,0 +1,25 @@
+// Test that symbol tables are written to and read back from the symbol table
+// cache, together with their name indexes.
+
+// REQUIRES: lld
+
+// RUN: %clang %s -c -o %t.o --target=x86_64-pc-linux
+// RUN: ld.lld %t.o --build-id -o %t
+// RUN: rm -rf %t.cache
+// RUN: %lldb %t -b -O "settings set symbols.symtab-cache-path %t.cache" \
+// RUN:   -o "image lookup -n foo" -o "image lookup -s _start" | FileCheck %s
+// RUN: ls %t.cache | FileCheck --check-prefix=CACHE %s
+// RUN: %lldb %t -b -O "settings set symbols.symtab-cache-path %t.cache" \
+// RUN:   -o "image lookup -n foo" -o "image lookup -s _start" | FileCheck %s
+
+// CHECK-LABEL: image lookup -n foo
+// CHECK: Summary: {{.*}}`ns::foo(int)
+// CHECK-LABEL: image lookup -s _start
+// CHECK: Summary: {{.*}}`_start
+// CACHE: {{[0-9A-F]+}}-symtab-cache.cpp.tmp.symtab
+
+namespace ns {
+int foo(int x) { return x; }
+} // namespace ns
+
+extern "C" void _start() { ns::foo(47); }
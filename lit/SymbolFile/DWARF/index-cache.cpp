@@ -0,0 +1,20 @@
+// Test that manually built DWARF indexes are written to and read back from
+// the index cache.
+
+// REQUIRES: lld
+
+// RUN: %clang %s -g -c -o %t.o --target=x86_64-pc-linux -mllvm -accel-tables=Disable
+// RUN: ld.lld %t.o --build-id -o %t
+// RUN: rm -rf %t.cache
+// RUN: %lldb %t -b -O "settings set plugin.symbol-file.dwarf.index-cache-path %t.cache" \
+// RUN:   -o "target variable foo" | FileCheck %s
+// RUN: ls %t.cache | FileCheck --check-prefix=CACHE %s
+// RUN: %lldb %t -b -O "settings set plugin.symbol-file.dwarf.index-cache-path %t.cache" \
+// RUN:   -o "target variable foo" | FileCheck %s
+
+// CHECK: (int) foo = 47
+// CACHE: {{[0-9A-F]+}}.dwarfindex
+
+int foo = 47;
+
+extern "C" void _start() {}
@@ -4,9 +4,16 @@
 
 # RUN: llvm-mc -triple x86_64-pc-linux %s -o %t -filetype=obj
 # RUN: %lldb %t -o "target variable A" -b | FileCheck %s
+# RUN: lldb-test symbols --benchmark-index %t | FileCheck --check-prefix=BENCH %s
 
 # CHECK-COUNT-256: A = 47
 
+# BENCH: Indexed symbols in {{[0-9.]+}} sec.
+# BENCH-DAG: for ManualDWARFIndex::Index - extract unit DIEs
+# BENCH-DAG: for ManualDWARFIndex::Index - extract DIEs
+# BENCH-DAG: for ManualDWARFIndex::Index - index units
+# BENCH-DAG: for ManualDWARFIndex::Index - finalize
+
 	.section	.debug_str,"MS",@progbits,1
 .Linfo_string0:
 	.asciz	"Hand-written DWARF"
@@ -0,0 +1,71 @@
+# Look up the unwind information of random addresses, both through the
+# .eh_frame_hdr search table and through the eagerly built FDE index.
+
+# REQUIRES: x86, lld
+
+# RUN: llvm-mc -triple x86_64-pc-linux %s -filetype=obj > %t.o
+# RUN: ld.lld --eh-frame-hdr %t.o -o %t
+# RUN: lldb-test unwind --count 1000 %t | FileCheck %s
+# RUN: lldb-test unwind --count 1000 --preload %t \
+# RUN:   | FileCheck --check-prefixes=CHECK,PRELOAD %s
+# RUN: lldb-test unwind --count 1000 --dump-ranges %t \
+# RUN:   | FileCheck --check-prefixes=CHECK,RANGES %s
+
+# PRELOAD: Preloaded module in {{[0-9.]+}} sec.
+# CHECK: Looked up 1000 addresses in {{[0-9.]+}} sec.
+# CHECK-NEXT: 1000 addresses are in a function with unwind info.
+# CHECK-NEXT: 1000 addresses have an eh_frame unwind plan.
+
+# Every function was hit, and each range ends where the next function starts.
+# RANGES-NEXT: 0 addresses have unwind info of another function.
+# RANGES-NEXT: [0x[[START:[0-9a-f]+]], 0x[[FOO:[0-9a-f]+]]) 12 bytes
+# RANGES-NEXT: [0x[[FOO]], 0x[[BAR:[0-9a-f]+]]) 11 bytes
+# RANGES-NEXT: [0x[[BAR]], 0x[[BAZ:[0-9a-f]+]]) 14 bytes
+# RANGES-NEXT: [0x[[BAZ]], 0x{{[0-9a-f]+}}) 6 bytes
+# RANGES-NOT: {{.}}
+
+        .text
+        .globl  _start
+        .type   _start, @function
+_start:
+        .cfi_startproc
+        callq   foo
+        callq   bar
+        ud2
+        .cfi_endproc
+        .size   _start, .-_start
+
+        .type   foo, @function
+foo:
+        .cfi_startproc
+        pushq   %rbp
+        .cfi_def_cfa_offset 16
+        .cfi_offset %rbp, -16
+        movq    %rsp, %rbp
+        .cfi_def_cfa_register %rbp
+        callq   baz
+        popq    %rbp
+        .cfi_def_cfa %rsp, 8
+        retq
+        .cfi_endproc
+        .size   foo, .-foo
+
+        .type   bar, @function
+bar:
+        .cfi_startproc
+        subq    $24, %rsp
+        .cfi_def_cfa_offset 32
+        callq   baz
+        addq    $24, %rsp
+        .cfi_def_cfa_offset 8
+        retq
+        .cfi_endproc
+        .size   bar, .-bar
+
+        .type   baz, @function
+baz:
+        .cfi_startproc
+        movl    $47, %eax
+        retq
+        .cfi_endproc
+        .size   baz, .-baz
@@ -0,0 +1,72 @@
+"""Benchmark a hot conditional breakpoint evaluated by lldb and by the stub."""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestBenchmarkBreakpointCondition(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    ITERATIONS = 20000
+
+    def setUp(self):
+        BenchBase.setUp(self)
+
+    @benchmarks_test
+    @no_debug_info_test
+    @skipUnlessPlatform(["linux"])
+    def test_run_with_conditional_breakpoint(self):
+        """Time a loop over a conditional breakpoint with and without stub side evaluation."""
+        self.build()
+        print()
+        self.addTearDownHook(lambda: self.runCmd(
+            "settings clear plugin.process.gdb-remote.use-stub-breakpoint-conditions"))
+        for use_stub in [False, True]:
+            self.run_with_setting(use_stub)
+
+    def run_with_setting(self, use_stub):
+        self.runCmd(
+            "settings set plugin.process.gdb-remote.use-stub-breakpoint-conditions %s" %
+            ("true" if use_stub else "false"))
+
+        exe = self.getBuildArtifact("a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        # The condition is true once, every other hit only costs the time it
+        # takes to evaluate it and resume.
+        hot_bkpt = target.BreakpointCreateBySourceRegex(
+            "// hot breakpoint", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(hot_bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+        hot_bkpt.SetCondition("i == %d" % (self.ITERATIONS - 1))
+        done_bkpt = target.BreakpointCreateBySourceRegex(
+            "// break here", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(done_bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        sw = Stopwatch()
+        with sw:
+            process = target.LaunchSimple(
+                [str(self.ITERATIONS)], None,
+                self.get_process_working_directory())
+            self.assertTrue(process, PROCESS_IS_VALID)
+            thread = lldbutil.get_one_thread_stopped_at_breakpoint(
+                process, hot_bkpt)
+            self.assertTrue(thread, "stopped where the condition is true")
+            process.Continue()
+            thread = lldbutil.get_one_thread_stopped_at_breakpoint(
+                process, done_bkpt)
+            self.assertTrue(thread, "stopped at the end of the run")
+
+        print("%s: %d iterations, %s" %
+              ("stub conditions" if use_stub else "lldb conditions",
+               self.ITERATIONS, sw))
+
+        process.Kill()
+        self.dbg.DeleteTarget(target)
@@ -0,0 +1,12 @@
+#include <cstdlib>
+
+void hot_spot(int i) {
+  (void)i; // hot breakpoint
+}
+
+int main(int argc, char const *argv[]) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 10000;
+  for (int i = 0; i < iterations; ++i)
+    hot_spot(i);
+  return 0; // break here
+}
@@ -0,0 +1,187 @@
+"""Benchmark stops of a process with many threads over a slow link, with and
+without packet compression and the binary thread info packet."""
+
+from __future__ import print_function
+
+
+import os
+import socket
+import subprocess
+import threading
+import time
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbtest_config
+from lldbsuite.test import lldbutil
+
+from six.moves import queue
+
+
+class DelayingProxy(object):
+    """Forwards a connection from lldb-server to lldb, delaying the data in
+    each direction to simulate the round trip time of a remote link."""
+
+    def __init__(self, delay):
+        self.delay = delay
+        self.server_listener = self._listen()
+        self.client_listener = self._listen()
+        self.bytes_from_server = 0
+
+    def _listen(self):
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        sock.bind(("127.0.0.1", 0))
+        sock.listen(1)
+        return sock
+
+    def server_port(self):
+        return self.server_listener.getsockname()[1]
+
+    def client_port(self):
+        return self.client_listener.getsockname()[1]
+
+    def start(self):
+        thread = threading.Thread(target=self._accept)
+        thread.daemon = True
+        thread.start()
+
+    def _accept(self):
+        server, _ = self.server_listener.accept()
+        client, _ = self.client_listener.accept()
+        for sock in [server, client]:
+            sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self._forward(server, client, True)
+        self._forward(client, server, False)
+
+    def _forward(self, src, dst, from_server):
+        chunks = queue.Queue()
+
+        def read():
+            while True:
+                data = src.recv(65536)
+                chunks.put((time.time() + self.delay, data))
+                if not data:
+                    return
+                if from_server:
+                    self.bytes_from_server += len(data)
+
+        def write():
+            while True:
+                deadline, data = chunks.get()
+                delay = deadline - time.time()
+                if delay > 0:
+                    time.sleep(delay)
+                if not data:
+                    dst.shutdown(socket.SHUT_WR)
+                    return
+                dst.sendall(data)
+
+        for target in [read, write]:
+            thread = threading.Thread(target=target)
+            thread.daemon = True
+            thread.start()
+
+
+class TestBenchmarkCompressedStop(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NUM_THREADS = 1000
+    NUM_STOPS = 10
+    # Half of a 50ms round trip.
+    LINK_DELAY = 0.025
+
+    def setUp(self):
+        BenchBase.setUp(self)
+
+    @benchmarks_test
+    @no_debug_info_test
+    @skipIfRemote
+    @skipUnlessPlatform(["linux"])
+    def test_stop_latency_over_slow_link(self):
+        """Measure stop latency over a 50ms link with and without compression and binary thread info."""
+        self.build()
+        print()
+        self.addTearDownHook(lambda: self.runCmd(
+            "settings clear plugin.process.gdb-remote.packet-compression"))
+        self.addTearDownHook(lambda: self.runCmd(
+            "settings clear plugin.process.gdb-remote.use-binary-threads-info"))
+        for compression in ["none", "zlib-deflate", "lz4"]:
+            for binary_threads_info in [False, True]:
+                self.run_with_settings(compression, binary_threads_info)
+
+    def get_lldb_server(self):
+        if "LLDB_DEBUGSERVER_PATH" in os.environ:
+            return os.environ["LLDB_DEBUGSERVER_PATH"]
+        lldb_server = os.path.join(
+            os.path.dirname(lldbtest_config.lldbExec), "lldb-server")
+        if not os.path.exists(lldb_server):
+            self.skipTest("lldb-server not found")
+        return lldb_server
+
+    def wait_for_state(self, listener, process, state):
+        lldbutil.expect_state_changes(self, listener, process, [state],
+                                      timeout=120)
+
+    def run_with_settings(self, compression, binary_threads_info):
+        self.runCmd(
+            "settings set plugin.process.gdb-remote.packet-compression " +
+            compression)
+        self.runCmd(
+            "settings set plugin.process.gdb-remote.use-binary-threads-info " +
+            ("true" if binary_threads_info else "false"))
+
+        proxy = DelayingProxy(self.LINK_DELAY)
+        proxy.start()
+        exe = self.getBuildArtifact("a.out")
+        server = subprocess.Popen(
+            [self.get_lldb_server(), "gdbserver", "--reverse-connect",
+             "127.0.0.1:%d" % proxy.server_port(), "--", exe,
+             str(self.NUM_THREADS), str(self.NUM_STOPS)])
+        self.addTearDownHook(server.kill)
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        listener = self.dbg.GetListener()
+        error = lldb.SBError()
+        process = target.ConnectRemote(
+            listener, "connect://127.0.0.1:%d" % proxy.client_port(),
+            "gdb-remote", error)
+        self.assertTrue(error.Success() and process, PROCESS_IS_VALID)
+        self.assertEqual(process.GetState(), lldb.eStateStopped)
+
+        bkpt = target.BreakpointCreateBySourceRegex(
+            "// break here", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        # Get to the first breakpoint hit, after all threads were started.
+        process.Continue()
+        self.assertEqual(process.GetState(), lldb.eStateStopped)
+        self.assertEqual(process.GetNumThreads(), self.NUM_THREADS + 1)
+
+        # A stop is only complete once lldb knows the stop reason and the pc
+        # of every thread.
+        self.dbg.SetAsync(True)
+        stop_sw = Stopwatch()
+        bytes_before = proxy.bytes_from_server
+        for i in range(2, self.NUM_STOPS):
+            process.Continue()
+            self.wait_for_state(listener, process, lldb.eStateRunning)
+            with stop_sw:
+                self.wait_for_state(listener, process, lldb.eStateStopped)
+                for thread in process:
+                    thread.GetStopReason()
+                    thread.GetFrameAtIndex(0).GetPC()
+        bytes_per_stop = ((proxy.bytes_from_server - bytes_before) //
+                          (self.NUM_STOPS - 2))
+
+        print("compression %s, %s thread info:\n  stop: %s\n"
+              "  %d bytes received per stop" %
+              (compression, "binary" if binary_threads_info else "JSON",
+               stop_sw, bytes_per_stop))
+
+        self.dbg.SetAsync(False)
+        process.Kill()
+        self.dbg.DeleteTarget(target)
@@ -0,0 +1,50 @@
+"""Benchmark backtraces of a deep stack while stepping in its top frame."""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestBenchmarkDeepStack(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    DEPTH = 2000
+    STEPS = 8
+
+    def setUp(self):
+        BenchBase.setUp(self)
+
+    @benchmarks_test
+    @no_debug_info_test
+    def test_backtrace_while_stepping(self):
+        """Time full backtraces of a deep stack after each step in its top frame."""
+        self.build()
+        (target, process, thread, bkpt) = lldbutil.run_to_source_breakpoint(
+            self, "// break at leaf", lldb.SBFileSpec("main.cpp"),
+            launch_info=lldb.SBLaunchInfo([str(self.DEPTH)]))
+
+        expected_frames = thread.GetNumFrames()
+        self.assertTrue(expected_frames > self.DEPTH)
+
+        sw = Stopwatch()
+        for i in range(self.STEPS):
+            thread.StepOver()
+            with sw:
+                self.assertEqual(thread.GetNumFrames(), expected_frames)
+
+        print()
+        print("backtraces of %d frames after %d steps: %s" %
+              (expected_frames, self.STEPS, sw))
+
+        self.runCmd("statistics dump")
+        output = self.res.GetOutput()
+        self.assertTrue("unwind frames reused from the previous stop" in output)
+        for line in output.splitlines():
+            if "unwind" in line or "symbol contexts" in line:
+                print(line)
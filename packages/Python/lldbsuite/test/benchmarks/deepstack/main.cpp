@@ -0,0 +1,26 @@
+#include <cstdlib>
+
+int leaf(int i) {
+  int value = i * 3; // break at leaf
+  value += 1;
+  value *= 2;
+  value -= 5;
+  value ^= 7;
+  value += i;
+  value *= 3;
+  value -= 11;
+  value ^= 13;
+  value += 17;
+  return value;
+}
+
+int recurse(int depth) {
+  if (depth == 0)
+    return leaf(depth);
+  return recurse(depth - 1) + 1;
+}
+
+int main(int argc, char const *argv[]) {
+  int depth = argc > 1 ? atoi(argv[1]) : 1000;
+  return recurse(depth) == 0;
+}
@@ -0,0 +1,72 @@
+"""Benchmark counting the hits of a hot location with a fast tracepoint."""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestBenchmarkFastTrace(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    ITERATIONS = 20000
+
+    def setUp(self):
+        BenchBase.setUp(self)
+
+    @benchmarks_test
+    @no_debug_info_test
+    @skipUnlessPlatform(["linux"])
+    @skipIf(archs=no_match(["x86_64"]))
+    def test_count_hits(self):
+        """Time counting the hits of a location with an auto-continue breakpoint and with a fast tracepoint."""
+        self.build()
+        print()
+        for fast_trace in [False, True]:
+            self.run_with_fast_trace(fast_trace)
+
+    def run_with_fast_trace(self, fast_trace):
+        (target, process, thread, start_bkpt) = lldbutil.run_to_source_breakpoint(
+            self, "// break at start", lldb.SBFileSpec("main.cpp"),
+            launch_info=lldb.SBLaunchInfo([str(self.ITERATIONS)]))
+        target.BreakpointDelete(start_bkpt.GetID())
+
+        hot_bkpt = target.BreakpointCreateBySourceRegex(
+            "// hot breakpoint", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(hot_bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+        if fast_trace:
+            hot_bkpt.SetFastTrace(True)
+            self.assertTrue(hot_bkpt.IsFastTrace())
+        else:
+            hot_bkpt.SetAutoContinue(True)
+        done_bkpt = target.BreakpointCreateBySourceRegex(
+            "// break here", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(done_bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        sw = Stopwatch()
+        with sw:
+            process.Continue()
+            thread = lldbutil.get_one_thread_stopped_at_breakpoint(
+                process, done_bkpt)
+            self.assertTrue(thread, "stopped at the end of the run")
+
+        location = hot_bkpt.GetLocationAtIndex(0)
+        if fast_trace:
+            self.assertEqual(location.GetFastTraceHitCount(), self.ITERATIONS)
+            records = location.GetFastTraceRecords()
+            self.assertTrue(records.IsValid())
+            self.assertTrue(records.GetSize() > 0)
+        else:
+            self.assertEqual(location.GetHitCount(), self.ITERATIONS)
+
+        print("%s: %d hits, %s" %
+              ("fast tracepoint" if fast_trace else "auto-continue breakpoint",
+               self.ITERATIONS, sw))
+
+        process.Kill()
+        self.dbg.DeleteTarget(target)
@@ -0,0 +1,13 @@
+#include <cstdlib>
+
+int hot_spot(int i) {
+  return i * 3; // hot breakpoint
+}
+
+int main(int argc, char const *argv[]) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 10000;
+  int sum = 0; // break at start
+  for (int i = 0; i < iterations; ++i)
+    sum += hot_spot(i);
+  return sum == 0; // break here
+}
@@ -0,0 +1,52 @@
+"""Benchmark formatter lookups for many values of a few types and a few
+values of many types."""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestBenchmarkFormatterCache(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    COUNT = 5
+
+    def setUp(self):
+        BenchBase.setUp(self)
+
+    def frame_variable(self, name):
+        result = lldb.SBCommandReturnObject()
+        self.dbg.GetCommandInterpreter().HandleCommand(
+            "frame variable " + name, result)
+        self.assertTrue(result.Succeeded(), result.GetError())
+
+    @benchmarks_test
+    @no_debug_info_test
+    def test_formatter_lookups(self):
+        """Time 'frame variable' with a cold and a warm formatter cache."""
+        self.build()
+        lldbutil.run_to_source_breakpoint(
+            self, "// break here", lldb.SBFileSpec("main.cpp"))
+        self.runCmd("settings set target.max-children-count 100000")
+        self.addTearDownHook(lambda: self.runCmd(
+            "settings clear target.max-children-count"))
+        self.addTearDownHook(lambda: self.runCmd("type summary clear"))
+
+        print()
+        for name in ["records", "tags"]:
+            cold_sw = Stopwatch()
+            warm_sw = Stopwatch()
+            for i in range(self.COUNT):
+                # Adding a formatter drops the cached lookups.
+                self.runCmd("type summary add -s cold Unused%d" % i)
+                with cold_sw:
+                    self.frame_variable(name)
+                with warm_sw:
+                    self.frame_variable(name)
+            print("%s\n  cold: %s\n  warm: %s" % (name, cold_sw, warm_sw))
@@ -0,0 +1,47 @@
+#include <cstdint>
+
+// Many distinct types, so that a cold lookup has to run through the regex
+// formatters once per type.
+template <int N> struct Tag {
+  int value;
+};
+
+template <int N> struct Tags {
+  Tag<N> tag;
+  Tags<N - 1> rest;
+};
+
+template <> struct Tags<0> {
+  Tag<0> tag;
+};
+
+typedef int Counter;
+
+struct Flags {
+  unsigned ready : 1;
+  unsigned mode : 3;
+};
+
+struct Record {
+  Counter count;
+  Flags flags;
+  double weight;
+  const char *name;
+  Record *next;
+};
+
+static Tags<200> tags;
+static Record records[20000];
+
+int main(int argc, char const *argv[]) {
+  for (int i = 0; i < 20000; ++i) {
+    records[i].count = i;
+    records[i].flags.ready = i & 1;
+    records[i].flags.mode = i & 7;
+    records[i].weight = i / 2.0;
+    records[i].name = "record";
+    records[i].next = &records[(i + 1) % 20000];
+  }
+  tags.tag.value = argc;
+  return records[argc].count; // break here
+}
@@ -0,0 +1,81 @@
+"""Benchmark typical watch expressions evaluated by the IR interpreter
+against the same expressions run as JIT code in the process."""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestBenchmarkIRInterpreter(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    COUNT = 50
+
+    # Expressions of the kind people put in watch windows and breakpoint
+    # conditions.
+    WATCH_EXPRESSIONS = [
+        "list->value",
+        "list->next->value + counters[index]",
+        "list->next->weight * ratio",
+        "flags & 0x10 ? counters[1] : counters[2]",
+        "index >= 0 && index < 8 && counters[index] > 1",
+        "(int)(list->weight * 100)",
+        "__builtin_popcount(flags)",
+        "(int)strlen(name)",
+        "(int)strncmp(name, list->next ? name : name + 1, 5)",
+        "int sum = 0; for (int i = 0; i < 8; ++i) sum += counters[i]; sum",
+        "int kind; switch (flags & 3) { case 0: kind = 1; break; "
+        "case 2: kind = 2; break; default: kind = 3; } kind",
+    ]
+
+    def setUp(self):
+        BenchBase.setUp(self)
+
+    @benchmarks_test
+    @no_debug_info_test
+    @skipUnlessPlatform(["linux", "darwin"])
+    def test_interpreter_vs_jit(self):
+        """Time watch expressions interpreted and JITted."""
+        self.build()
+        (target, process, thread, bkpt) = lldbutil.run_to_source_breakpoint(
+            self, "// break here", lldb.SBFileSpec("main.c"))
+        frame = thread.GetFrameAtIndex(0)
+
+        interp_options = lldb.SBExpressionOptions()
+        interp_options.SetAllowJIT(False)
+        jit_options = lldb.SBExpressionOptions()
+
+        print()
+        interp_total = Stopwatch()
+        jit_total = Stopwatch()
+        for expression in self.WATCH_EXPRESSIONS:
+            # The getpid() call can't be interpreted, which makes the whole
+            # expression run in the process.
+            interp_sw = self.time_expression(frame, expression,
+                                             interp_options, interp_total)
+            jit_sw = self.time_expression(frame,
+                                          "(int)getpid(); " + expression,
+                                          jit_options, jit_total)
+            print("%s\n  interpreted: %s\n  JIT: %s" %
+                  (expression, interp_sw, jit_sw))
+
+        print("all expressions\n  interpreted: %s\n  JIT: %s" %
+              (interp_total, jit_total))
+        print("JIT avg/interpreted avg: %f" %
+              (jit_total.avg() / interp_total.avg()))
+
+    def time_expression(self, frame, expression, options, total):
+        sw = Stopwatch()
+        for i in range(self.COUNT):
+            with sw:
+                with total:
+                    value = frame.EvaluateExpression(expression, options)
+            self.assertTrue(value.GetError().Success(),
+                            "%s: %s" % (expression, value.GetError()))
+        return sw
@@ -0,0 +1,23 @@
+#include <stdio.h>
+#include <string.h>
+
+struct node {
+  int value;
+  double weight;
+  struct node *next;
+};
+
+int main(int argc, char **argv) {
+  struct node tail = {20, 0.75, NULL};
+  struct node head = {10, 1.5, &tail};
+  struct node *list = &head;
+  const char *name = "watched";
+  int counters[8] = {0, 1, 2, 3, 5, 8, 13, 21};
+  unsigned flags = 0x5a;
+  double ratio = 0.25;
+  int index = argc + 2;
+
+  printf("%s %d %d %u %f\n", name, list->value, counters[index], flags,
+         ratio); // break here
+  return (int)strlen(name);
+}
@@ -0,0 +1,62 @@
+"""Benchmark paging through the children of libc++ containers with 1M
+elements, as IDE variable views do."""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestBenchmarkLibcxxContainers(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NUM_ELEMENTS = 1000000
+    PAGE_SIZE = 100
+    # Pages at the start, in the middle and at the end of the containers.
+    PAGE_STARTS = [0, NUM_ELEMENTS // 2, NUM_ELEMENTS - PAGE_SIZE]
+
+    def setUp(self):
+        BenchBase.setUp(self)
+
+    @benchmarks_test
+    @no_debug_info_test
+    @add_test_categories(["libc++"])
+    @skipUnlessPlatform(["linux", "darwin"])
+    def test_page_children(self):
+        """Time fetching pages of children one by one and as a range."""
+        self.build()
+        (target, process, thread, bkpt) = lldbutil.run_to_source_breakpoint(
+            self, "// break here", lldb.SBFileSpec("main.cpp"))
+        frame = thread.GetFrameAtIndex(0)
+
+        print()
+        for name in ["map", "list", "unordered_map"]:
+            variable = frame.FindVariable(name)
+            self.assertEqual(variable.GetNumChildren(), self.NUM_ELEMENTS)
+            for page_start in self.PAGE_STARTS:
+                # Every page is fetched from a new value, like an IDE that
+                # jumps to a page after a stop.
+                single_sw = Stopwatch()
+                with single_sw:
+                    value = self.new_value(target, variable)
+                    for i in range(page_start, page_start + self.PAGE_SIZE):
+                        self.assertTrue(value.GetChildAtIndex(i).IsValid())
+                range_sw = Stopwatch()
+                with range_sw:
+                    value = self.new_value(target, variable)
+                    children = value.GetChildrenAtIndexRange(
+                        page_start, self.PAGE_SIZE)
+                    for child in children:
+                        self.assertTrue(child.IsValid())
+                print("%s children [%d, %d)\n  one by one: %s\n  range: %s" %
+                      (name, page_start, page_start + self.PAGE_SIZE,
+                       single_sw, range_sw))
+
+    def new_value(self, target, variable):
+        return target.CreateValueFromAddress(
+            variable.GetName(), variable.GetAddress(), variable.GetType())
@@ -0,0 +1,15 @@
+#include <list>
+#include <map>
+#include <unordered_map>
+
+int main() {
+  std::map<int, int> map;
+  std::list<int> list;
+  std::unordered_map<int, int> unordered_map;
+  for (int i = 0; i < 1000000; ++i) {
+    map[i] = i;
+    list.push_back(i);
+    unordered_map[i] = i;
+  }
+  return 0; // break here
+}
@@ -0,0 +1,70 @@
+"""Benchmark inferior throughput under a hot conditional breakpoint."""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestBenchmarkNonStop(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NUM_WORKERS = 4
+    SECONDS = 5
+
+    def setUp(self):
+        BenchBase.setUp(self)
+
+    @benchmarks_test
+    @no_debug_info_test
+    @skipUnlessPlatform(["linux"])
+    def test_conditional_breakpoint_throughput(self):
+        """Compare worker thread progress in all-stop and non-stop mode."""
+        self.build()
+        print()
+        self.addTearDownHook(
+            lambda: self.runCmd("settings clear target.non-stop-mode"))
+        for non_stop in [False, True]:
+            self.run_with_mode(non_stop)
+
+    def run_with_mode(self, non_stop):
+        self.runCmd("settings set target.non-stop-mode %s" %
+                    ("true" if non_stop else "false"))
+
+        exe = self.getBuildArtifact("a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        # The condition is never true, every hit only costs the time it takes
+        # to evaluate it and resume.
+        hot_bkpt = target.BreakpointCreateBySourceRegex(
+            "// hot breakpoint", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(hot_bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+        hot_bkpt.SetCondition("i < 0")
+        done_bkpt = target.BreakpointCreateBySourceRegex(
+            "// break here", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(done_bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        sw = Stopwatch()
+        with sw:
+            process = target.LaunchSimple(
+                [str(self.NUM_WORKERS), str(self.SECONDS)], None,
+                self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        thread = lldbutil.get_one_thread_stopped_at_breakpoint(
+            process, done_bkpt)
+        self.assertTrue(thread, "stopped at the end of the run")
+
+        total = thread.GetFrameAtIndex(0).FindVariable(
+            "total").GetValueAsUnsigned()
+        print("%s: %d worker iterations, %d conditional breakpoint hits, "
+              "%s" % ("non-stop" if non_stop else "all-stop", total,
+                      hot_bkpt.GetHitCount(), sw))
+
+        process.Kill()
+        self.dbg.DeleteTarget(target)
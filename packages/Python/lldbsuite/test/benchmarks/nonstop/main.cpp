@@ -0,0 +1,49 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+std::atomic<bool> g_stop(false);
+
+void hot_spot(int i) {
+  (void)i; // hot breakpoint
+}
+
+void hot_loop() {
+  for (int i = 0; !g_stop; ++i) {
+    hot_spot(i);
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+}
+
+void worker(volatile unsigned long *counter) {
+  while (!g_stop)
+    ++*counter;
+}
+
+void done(unsigned long total) {
+  (void)total; // break here
+}
+
+int main(int argc, char const *argv[]) {
+  int num_workers = argc > 1 ? atoi(argv[1]) : 4;
+  int seconds = argc > 2 ? atoi(argv[2]) : 5;
+
+  std::vector<unsigned long> counters(num_workers);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_workers; ++i)
+    threads.emplace_back(worker, &counters[i]);
+  threads.emplace_back(hot_loop);
+
+  std::this_thread::sleep_for(std::chrono::seconds(seconds));
+  g_stop = true;
+  for (std::thread &t : threads)
+    t.join();
+
+  unsigned long total = 0;
+  for (unsigned long count : counters)
+    total += count;
+  done(total);
+  return 0;
+}
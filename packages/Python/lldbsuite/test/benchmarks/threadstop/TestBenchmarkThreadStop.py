@@ -0,0 +1,79 @@
+"""Benchmark stopping and resuming processes with many threads."""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestBenchmarkThreadStop(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NUM_STOPS = 10
+
+    def setUp(self):
+        BenchBase.setUp(self)
+
+    @benchmarks_test
+    @no_debug_info_test
+    def test_stop_and_resume_latency(self):
+        """Measure stop and resume latency against the thread count."""
+        self.build()
+        print()
+        for num_threads in [1, 100, 1000, 3000]:
+            self.run_with_threads(num_threads)
+
+    def wait_for_state(self, listener, process, state):
+        lldbutil.expect_state_changes(self, listener, process, [state],
+                                      timeout=60)
+
+    def run_with_threads(self, num_threads):
+        exe = self.getBuildArtifact("a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        bkpt = target.BreakpointCreateBySourceRegex(
+            "// break here", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(
+            [str(num_threads), str(self.NUM_STOPS)], None,
+            self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        self.assertEqual(process.GetState(), lldb.eStateStopped)
+
+        listener = self.dbg.GetListener()
+        self.dbg.SetAsync(True)
+
+        # A breakpoint stop has to stop all the other threads before it is
+        # reported, resuming has to resume all of them.
+        resume_sw = Stopwatch()
+        stop_sw = Stopwatch()
+        for i in range(1, self.NUM_STOPS):
+            with resume_sw:
+                process.Continue()
+                self.wait_for_state(listener, process, lldb.eStateRunning)
+            with stop_sw:
+                self.wait_for_state(listener, process, lldb.eStateStopped)
+
+        # Let the program run past the last breakpoint and interrupt it.
+        bkpt.SetEnabled(False)
+        process.Continue()
+        self.wait_for_state(listener, process, lldb.eStateRunning)
+        interrupt_sw = Stopwatch()
+        with interrupt_sw:
+            process.Stop()
+            self.wait_for_state(listener, process, lldb.eStateStopped)
+
+        self.assertEqual(process.GetNumThreads(), num_threads + 1)
+        print("%d threads:\n  resume: %s\n  breakpoint stop: %s\n"
+              "  interrupt: %s" % (num_threads, resume_sw, stop_sw,
+                                   interrupt_sw))
+
+        self.dbg.SetAsync(False)
+        process.Kill()
+        self.dbg.DeleteTarget(target)
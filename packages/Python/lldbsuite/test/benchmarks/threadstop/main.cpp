@@ -0,0 +1,38 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+std::mutex g_mutex;
+std::condition_variable g_cv;
+bool g_done = false;
+
+void worker() {
+  std::unique_lock<std::mutex> lock(g_mutex);
+  g_cv.wait(lock, [] { return g_done; });
+}
+
+int g_count = 0;
+
+void stop_here() {
+  ++g_count; // break here
+}
+
+int main(int argc, char const *argv[]) {
+  int num_threads = argc > 1 ? atoi(argv[1]) : 1;
+  int num_stops = argc > 2 ? atoi(argv[2]) : 10;
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i)
+    threads.emplace_back(worker);
+
+  for (int i = 0; i < num_stops; ++i)
+    stop_here();
+
+  // Keep running until the debugger interrupts and kills us.
+  while (true)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  return 0;
+}
@@ -0,0 +1,72 @@
+"""Benchmark building and releasing the value tree of a variable with 100k
+children."""
+
+from __future__ import print_function
+
+
+import ctypes
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbbench import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class MallInfo(ctypes.Structure):
+    _fields_ = [(name, ctypes.c_int) for name in
+                ["arena", "ordblks", "smblks", "hblks", "hblkhd", "usmblks",
+                 "fsmblks", "uordblks", "fordblks", "keepcost"]]
+
+
+class TestBenchmarkValueObjectTree(BenchBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NUM_CHILDREN = 100000
+    COUNT = 5
+
+    def setUp(self):
+        BenchBase.setUp(self)
+
+    def heap_in_use(self):
+        libc = ctypes.CDLL(None)
+        libc.mallinfo.restype = MallInfo
+        return libc.mallinfo().uordblks
+
+    @benchmarks_test
+    @no_debug_info_test
+    @skipUnlessPlatform(["linux"])
+    def test_value_tree_with_many_children(self):
+        """Time fetching every child and grandchild of a 100k element array."""
+        self.build()
+        (target, process, thread, bkpt) = lldbutil.run_to_source_breakpoint(
+            self, "// break here", lldb.SBFileSpec("main.cpp"))
+        frame = thread.GetFrameAtIndex(0)
+
+        # The frame keeps the tree of its own variables, make a new root for
+        # every iteration instead.
+        variable = frame.FindVariable("points")
+        address = variable.GetAddress()
+        points_type = variable.GetType()
+
+        print()
+        build_sw = Stopwatch()
+        release_sw = Stopwatch()
+        for i in range(self.COUNT):
+            heap_before = self.heap_in_use()
+            with build_sw:
+                points = target.CreateValueFromAddress("points", address,
+                                                       points_type)
+                num_children = points.GetNumChildren()
+                for index in range(num_children):
+                    points.GetChildAtIndex(index).GetChildAtIndex(1)
+            heap_used = self.heap_in_use() - heap_before
+            self.assertEqual(num_children, self.NUM_CHILDREN)
+            # Dropping the root releases the whole tree.
+            with release_sw:
+                del points
+        print("%d children\n  build: %s\n  release: %s\n"
+              "  %d heap bytes per child" %
+              (num_children, build_sw, release_sw,
+               heap_used // num_children))
@@ -0,0 +1,14 @@
+struct Point {
+  int x;
+  int y;
+};
+
+static Point points[100000];
+
+int main(int argc, char const *argv[]) {
+  for (int i = 0; i < 100000; ++i) {
+    points[i].x = i;
+    points[i].y = -i;
+  }
+  return points[argc].x; // break here
+}
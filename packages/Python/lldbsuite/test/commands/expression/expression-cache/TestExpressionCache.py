@@ -0,0 +1,81 @@
+"""
+Test that evaluating the same expression again in the same scope reuses the
+parsed expression and still sees the current values of the variables.
+"""
+
+from __future__ import print_function
+
+
+import lldb
+import lldbsuite.test.lldbutil as lldbutil
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+
+
+class ExpressionCacheTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def expect_stats(self, hits, misses):
+        self.expect("statistics dump", substrs=[
+            "reusing a parsed expression : %d" % hits,
+            "parsing the expression : %d" % misses])
+
+    def block_start(self, frame):
+        return frame.GetBlock().GetRangeStartAddress(0).GetFileAddress()
+
+    @skipIfRemote
+    def test(self):
+        """Test reusing parsed expressions across stops."""
+        self.build()
+        (target, process, thread, bkpt) = lldbutil.run_to_source_breakpoint(
+            self, "// break here", lldb.SBFileSpec("main.c"))
+        self.runCmd("statistics enable")
+        self.addTearDownHook(lambda: self.runCmd("statistics disable"))
+
+        frame = thread.GetFrameAtIndex(0)
+        first_pc = frame.GetPC()
+        loop_block = self.block_start(frame)
+        self.expect("expr square(i + 1) + total", substrs=["= 1"])
+        self.expect_stats(hits=0, misses=1)
+
+        # A different pc in the same block reuses the parsed expression.
+        thread.StepOver()
+        frame = thread.GetFrameAtIndex(0)
+        self.assertEqual(frame.GetLineEntry().GetLine(),
+                         line_number("main.c", "// same block"))
+        self.assertNotEqual(frame.GetPC(), first_pc)
+        self.assertEqual(self.block_start(frame), loop_block)
+        self.expect("expr square(i + 1) + total", substrs=["= 1"])
+        self.expect_stats(hits=1, misses=1)
+
+        self.runCmd("continue")
+        self.expect("expr square(i + 1) + total", substrs=["= 4"])
+        self.expect_stats(hits=2, misses=1)
+
+        # Different expression text doesn't hit.
+        self.expect("expr square(i + 2) + total", substrs=["= 9"])
+        self.expect_stats(hits=2, misses=2)
+
+        # Expressions with different options don't share a parsed expression.
+        self.expect("expr --unwind-on-error 0 -- square(i)", substrs=["= 1"])
+        self.expect_stats(hits=2, misses=2)
+
+        # A different block has its own variables, so the expression is parsed
+        # again and sees the i of that block.
+        target.BreakpointDelete(bkpt.GetID())
+        other_bkpt = target.BreakpointCreateBySourceRegex(
+            "// other block", lldb.SBFileSpec("main.c"))
+        threads = lldbutil.continue_to_breakpoint(process, other_bkpt)
+        self.assertEqual(len(threads), 1)
+        frame = threads[0].GetFrameAtIndex(0)
+        self.assertNotEqual(self.block_start(frame), loop_block)
+        self.expect("expr square(i + 1) + total", substrs=["= 129"])
+        self.expect_stats(hits=2, misses=3)
+
+        # Without a cache nothing is reused.
+        self.runCmd("settings set target.expression-cache-size 0")
+        self.addTearDownHook(lambda: self.runCmd(
+            "settings clear target.expression-cache-size"))
+        self.expect("expr square(i + 1) + total", substrs=["= 129"])
+        self.expect_stats(hits=2, misses=3)
@@ -0,0 +1,14 @@
+int square(int x) { return x * x; }
+
+int main(void) {
+  int total = 0;
+  for (int i = 0; i < 3; ++i) {
+    total += square(i); // break here
+    total += i; // same block
+  }
+  {
+    int i = 10;
+    total += i; // other block
+  }
+  return total;
+}
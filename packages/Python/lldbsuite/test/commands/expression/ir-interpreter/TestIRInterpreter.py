@@ -86,6 +86,69 @@ class IRInterpreterTestCase(TestBase):
                 "While evaluating " +
                 expression)
 
+    # Expressions the interpreter handles without JITting code: floating point
+    # math, control flow that becomes select, PHI and switch instructions,
+    # loops, aggregate copies, vectors and calls it emulates. Library calls on
+    # more memory than the host emulates call the function in the process.
+    no_jit_expressions = [
+        "ratio * 2 + 1.5",
+        "(int)(ratio * 4)",
+        "(float)ratio / 3",
+        "ratio > 2.0 ? values[1] : values[2]",
+        "values[1] > 1 && values[2] < 4",
+        "int r = 0; switch (values[3]) { case 4: r = 40; break; "
+        "default: r = -1; } r",
+        "int a = 0, b = 1; for (int i = 0; i < values[3] + 6 && b > 0; ++i) "
+        "{ int t = a + b; a = b; b = t; } a * 1000 + b",
+        "struct S { int a[4]; }; struct S s = *(struct S *)values; s.a[3]",
+        "typedef int v4 __attribute__((ext_vector_type(4))); "
+        "v4 v = {values[0], values[1], values[2], values[3]}; "
+        "v = v * 2 + v; v.w",
+        "__builtin_popcount(values[3] | 0x30)",
+        "(int)strlen(greeting)",
+        "(int)strncmp(greeting, greeting + 1, 2)",
+        "(int)abs(values[0] - values[3])",
+        "(int)strlen(big_string)",
+        "(int)memcmp(big_string, big_string + 1, sizeof(big_string) - 2)"]
+
+    @add_test_categories(['pyapi'])
+    # getpid() is POSIX, among other problems, see bug
+    @expectedFailureAll(
+        oslist=['windows'],
+        bugnumber="http://llvm.org/pr21765")
+    @expectedFailureNetBSD
+    @expectedFailureAll(
+        oslist=['linux'],
+        archs=['arm'],
+        bugnumber="llvm.org/pr27868")
+    def test_ir_interpreter_without_jit(self):
+        self.build_and_run()
+
+        interp_options = lldb.SBExpressionOptions()
+        interp_options.SetLanguage(lldb.eLanguageTypeC_plus_plus)
+        interp_options.SetAllowJIT(False)
+
+        jit_options = lldb.SBExpressionOptions()
+        jit_options.SetLanguage(lldb.eLanguageTypeC_plus_plus)
+
+        for expression in self.no_jit_expressions:
+            interp_value = self.frame().EvaluateExpression(
+                expression, interp_options)
+            self.assertTrue(interp_value.GetError().Success(),
+                            "Interpreted " + expression + ": " +
+                            str(interp_value.GetError()))
+
+            jit_value = self.frame().EvaluateExpression(
+                "(int)getpid(); " + expression, jit_options)
+            self.assertTrue(jit_value.GetError().Success(),
+                            "JITted " + expression)
+
+            self.assertEqual(
+                interp_value.GetValue(),
+                jit_value.GetValue(),
+                "While evaluating " +
+                expression)
+
     def test_type_conversions(self):
         target = self.dbg.GetDummyTarget()
         short_val = target.EvaluateExpression("(short)-1")
@@ -1,7 +1,15 @@
 #include <stdio.h>
+#include <string.h>
+
+// Longer than the strings the interpreter reads on the host.
+char big_string[2 * 1024 * 1024 + 1];
 
 int main()
 {
+    const char *greeting = "hello";
+    double ratio = 2.5;
+    int values[4] = {1, 2, 3, 4};
+    memset(big_string, 'a', sizeof(big_string) - 1);
     printf("This is a dummy\n"); // Set breakpoint here   
     return 0;
 }
@@ -0,0 +1,180 @@
+"""
+Test fast tracepoints, which count the hits of a location without stopping.
+"""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.lldbutil as lldbutil
+
+
+class FastTracepointTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+    NO_DEBUG_INFO_TESTCASE = True
+
+    ITERATIONS = 100
+
+    def run_to_start(self):
+        (target, process, thread, start_bkpt) = lldbutil.run_to_source_breakpoint(
+            self, "// break at start", lldb.SBFileSpec("main.cpp"))
+        target.BreakpointDelete(start_bkpt.GetID())
+        return (target, process)
+
+    def create_done_breakpoint(self, target):
+        done_bkpt = target.BreakpointCreateBySourceRegex(
+            "// break here", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(done_bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+        return done_bkpt
+
+    def continue_to_done(self, process, done_bkpt):
+        process.Continue()
+        thread = lldbutil.get_one_thread_stopped_at_breakpoint(
+            process, done_bkpt)
+        self.assertTrue(thread, "stopped at the end of the run, not before")
+
+    @skipUnlessPlatform(["linux"])
+    @skipIf(archs=no_match(["x86_64"]))
+    def test_sb_api(self):
+        """Count and record the hits of a location with SBBreakpoint.SetFastTrace."""
+        self.build()
+        (target, process) = self.run_to_start()
+
+        hot_bkpt = target.BreakpointCreateBySourceRegex(
+            "// hot breakpoint", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(hot_bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+        self.assertFalse(hot_bkpt.IsFastTrace())
+        hot_bkpt.SetFastTrace(True)
+        self.assertTrue(hot_bkpt.IsFastTrace())
+        location = hot_bkpt.GetLocationAtIndex(0)
+        self.assertTrue(location.IsResolved())
+        self.assertEqual(location.GetFastTraceHitCount(), 0)
+
+        done_bkpt = self.create_done_breakpoint(target)
+        self.continue_to_done(process, done_bkpt)
+
+        # The hits were counted in the inferior, none of them stopped.
+        self.assertEqual(location.GetFastTraceHitCount(), self.ITERATIONS)
+        self.assertEqual(hot_bkpt.GetHitCount(), 0)
+
+        records = location.GetFastTraceRecords()
+        self.assertTrue(records.IsValid())
+        self.assertTrue(0 < records.GetSize() <= self.ITERATIONS)
+        last_index = -1
+        for i in range(records.GetSize()):
+            record = records.GetItemAtIndex(i)
+            index = record.GetValueForKey("index").GetIntegerValue()
+            self.assertTrue(last_index < index < self.ITERATIONS)
+            last_index = index
+            registers = record.GetValueForKey("registers")
+            for name in ["rax", "rdi", "rsp", "rflags"]:
+                self.assertTrue(registers.GetValueForKey(name).IsValid(),
+                                "record has %s" % name)
+
+        # Turning the tracepoint back into a breakpoint makes it stop.
+        hot_bkpt.SetFastTrace(False)
+        self.assertFalse(hot_bkpt.IsFastTrace())
+        process.Kill()
+
+    @skipUnlessPlatform(["linux"])
+    @skipIf(archs=no_match(["x86_64"]))
+    def test_command(self):
+        """Count the hits of a location with breakpoint set --fast-trace."""
+        self.build()
+        (target, process) = self.run_to_start()
+
+        self.expect("breakpoint set --fast-trace -p '// hot breakpoint'",
+                    substrs=["Breakpoint 2:"])
+        self.assertTrue(target.FindBreakpointByID(2).IsFastTrace())
+        self.expect("breakpoint list -v 2",
+                    substrs=["resolved = true", "fast trace hit count = 0"])
+
+        done_bkpt = self.create_done_breakpoint(target)
+        self.continue_to_done(process, done_bkpt)
+
+        self.expect("breakpoint list -v 2",
+                    substrs=["fast trace hit count = %d" % self.ITERATIONS])
+        process.Kill()
+
+    @skipUnlessPlatform(["linux"])
+    @skipIf(archs=no_match(["x86_64"]))
+    def test_overlapping_breakpoints(self):
+        """Check that breakpoints and fast tracepoints don't share instructions."""
+        self.build()
+        (target, process) = self.run_to_start()
+
+        hot_bkpt = target.BreakpointCreateBySourceRegex(
+            "// hot breakpoint", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(hot_bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+        hot_addr = hot_bkpt.GetLocationAtIndex(0).GetLoadAddress()
+        hot_bkpt.SetFastTrace(True)
+        self.assertTrue(hot_bkpt.GetLocationAtIndex(0).IsResolved())
+
+        # The jump of the tracepoint takes 5 bytes, breakpoints at the same
+        # address or in the instructions it replaces are rejected.
+        for offset in [0, 1, 4]:
+            bkpt = target.BreakpointCreateByAddress(hot_addr + offset)
+            self.assertEqual(bkpt.GetNumLocations(), 1)
+            self.assertFalse(bkpt.GetLocationAtIndex(0).IsResolved(),
+                             "breakpoint at +%d is rejected" % offset)
+            target.BreakpointDelete(bkpt.GetID())
+
+        # In the other direction, a tracepoint is rejected if it would replace
+        # the instructions of a breakpoint.
+        hot_bkpt.SetFastTrace(False)
+        self.assertTrue(hot_bkpt.GetLocationAtIndex(0).IsResolved())
+        inner_bkpt = target.BreakpointCreateByAddress(hot_addr + 1)
+        self.assertTrue(inner_bkpt.GetLocationAtIndex(0).IsResolved())
+        target.BreakpointDelete(hot_bkpt.GetID())
+
+        trace_bkpt = target.BreakpointCreateByAddress(hot_addr)
+        trace_bkpt.SetFastTrace(True)
+        self.assertFalse(trace_bkpt.GetLocationAtIndex(0).IsResolved(),
+                         "tracepoint over a breakpoint is rejected")
+
+        # Once the breakpoint is gone, the tracepoint can be set.
+        target.BreakpointDelete(inner_bkpt.GetID())
+        trace_bkpt.SetEnabled(False)
+        trace_bkpt.SetEnabled(True)
+        self.assertTrue(trace_bkpt.GetLocationAtIndex(0).IsResolved())
+
+        # Nothing corrupted the code, the run finishes with every hit counted.
+        done_bkpt = self.create_done_breakpoint(target)
+        self.continue_to_done(process, done_bkpt)
+        self.assertEqual(
+            trace_bkpt.GetLocationAtIndex(0).GetFastTraceHitCount(),
+            self.ITERATIONS)
+        process.Kill()
+
+    @skipUnlessPlatform(["linux"])
+    @skipIf(archs=no_match(["x86_64"]))
+    def test_sites_covering_other_entries(self):
+        """Check that a tracepoint is rejected if its jump covers the start of another line table entry."""
+        self.build()
+        (target, process) = self.run_to_start()
+
+        main_bkpt = target.BreakpointCreateByName("main")
+        comp_unit = main_bkpt.GetLocationAtIndex(
+            0).GetAddress().GetCompileUnit()
+        target.BreakpointDelete(main_bkpt.GetID())
+        addrs = sorted(set(
+            comp_unit.GetLineEntryAtIndex(i).GetStartAddress().GetLoadAddress(
+                target) for i in range(comp_unit.GetNumLineEntries())))
+
+        # The jump of the tracepoint takes 5 bytes, anything jumping to a
+        # line closer than that would land in the middle of it.
+        num_checked = 0
+        for addr, next_addr in zip(addrs, addrs[1:]):
+            if next_addr - addr >= 5:
+                continue
+            bkpt = target.BreakpointCreateByAddress(addr)
+            bkpt.SetFastTrace(True)
+            self.assertFalse(bkpt.GetLocationAtIndex(0).IsResolved(),
+                             "tracepoint at 0x%x is rejected" % addr)
+            target.BreakpointDelete(bkpt.GetID())
+            num_checked += 1
+        self.assertTrue(num_checked > 0, "the loop has short line entries")
+        process.Kill()
@@ -0,0 +1,10 @@
+int hot_spot(int i) {
+  return i * 3; // hot breakpoint
+}
+
+int main(int argc, char const *argv[]) {
+  int sum = 0; // break at start
+  for (int i = 0; i < 100; ++i)
+    sum += hot_spot(i);
+  return sum == 0; // break here
+}
@@ -0,0 +1,100 @@
+"""
+Test that a breakpoint condition the remote stub evaluates skips the hits
+where it is false and reports the ones where it is true.
+"""
+
+from __future__ import print_function
+
+
+import re
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.lldbutil as lldbutil
+
+
+class StubBreakpointConditionTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # The condition refers to an argument and to a global.
+    CONDITION = "i % 10 == 3 && g_total > 100"
+
+    def setUp(self):
+        TestBase.setUp(self)
+        self.addTearDownHook(lambda: self.runCmd(
+            "settings clear plugin.process.gdb-remote.use-stub-breakpoint-conditions"))
+
+    def expected_hits(self):
+        hits = []
+        total = 0
+        for i in range(100):
+            if i % 10 == 3 and total > 100:
+                hits.append(i)
+            total += i
+        return hits
+
+    @skipUnlessPlatform(["linux"])
+    def test_stub_conditions(self):
+        """Check the hits of a breakpoint whose condition the stub evaluates."""
+        self.build()
+        self.check_hits(True)
+
+    @skipUnlessPlatform(["linux"])
+    def test_lldb_conditions(self):
+        """Check the hits of the same breakpoint with lldb evaluating the
+        condition."""
+        self.build()
+        self.check_hits(False)
+
+    def check_hits(self, use_stub):
+        self.runCmd(
+            "settings set plugin.process.gdb-remote.use-stub-breakpoint-conditions %s" %
+            ("true" if use_stub else "false"))
+        log_file = self.getBuildArtifact("packets.log")
+        self.runCmd("log enable -f %s gdb-remote packets" % log_file)
+        self.addTearDownHook(
+            lambda: self.runCmd("log disable gdb-remote packets"))
+
+        exe = self.getBuildArtifact("a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        hot_bkpt = target.BreakpointCreateBySourceRegex(
+            "// hot breakpoint", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(hot_bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+        hot_bkpt.SetCondition(self.CONDITION)
+        done_bkpt = target.BreakpointCreateBySourceRegex(
+            "// break here", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(done_bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(
+            None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        # Every reported hit has a true condition, and no true hit is missed.
+        hits = []
+        while True:
+            thread = lldbutil.get_one_thread_stopped_at_breakpoint(
+                process, hot_bkpt)
+            if not thread:
+                break
+            frame = thread.GetFrameAtIndex(0)
+            hits.append(frame.FindVariable("i").GetValueAsSigned())
+            process.Continue()
+
+        thread = lldbutil.get_one_thread_stopped_at_breakpoint(
+            process, done_bkpt)
+        self.assertTrue(thread, "stopped at the end of the run")
+        self.assertEqual(hits, self.expected_hits())
+        self.assertEqual(hot_bkpt.GetHitCount(), len(hits))
+
+        process.Kill()
+        self.runCmd("log disable gdb-remote packets")
+
+        # The condition went to the stub only if it was asked to.
+        with open(log_file, "r") as f:
+            sent_condition = re.search(r"\$Z0,[0-9a-f]+,[0-9a-f]+;X",
+                                       f.read()) is not None
+        self.assertEqual(sent_condition, use_stub)
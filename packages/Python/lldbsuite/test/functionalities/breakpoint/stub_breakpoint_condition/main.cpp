@@ -0,0 +1,11 @@
+int g_total = 0;
+
+void hot_spot(int i) {
+  g_total += i; // hot breakpoint
+}
+
+int main(int argc, char const *argv[]) {
+  for (int i = 0; i < 100; ++i)
+    hot_spot(i);
+  return 0; // break here
+}
@@ -0,0 +1,99 @@
+"""
+Test that changing a category only invalidates the cached formatters it can
+affect, and that every lookup still finds the formatter of the first enabled
+category that has one.
+"""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.lldbutil as lldbutil
+
+
+class DataFormatterCategoryInvalidationTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    CATEGORIES = ["after", "last", "middle", "first", "disabled"]
+
+    def create_category(self, name):
+        category = self.dbg.CreateCategory(name)
+        self.assertTrue(category.IsValid())
+        self.addTearDownHook(lambda: self.dbg.DeleteCategory(name))
+        return category
+
+    def add_summary(self, category, type_name, summary):
+        self.assertTrue(category.AddTypeSummary(
+            lldb.SBTypeNameSpecifier(type_name),
+            lldb.SBTypeSummary.CreateWithSummaryString(summary)))
+
+    def delete_summary(self, category, type_name):
+        self.assertTrue(category.DeleteTypeSummary(
+            lldb.SBTypeNameSpecifier(type_name)))
+
+    def check_summaries(self, point, size):
+        frame = self.thread.GetSelectedFrame()
+        self.assertEqual(frame.FindVariable("p").GetSummary(), point)
+        self.assertEqual(frame.FindVariable("s").GetSummary(), size)
+
+    def test(self):
+        """Test the cached formatters across changes of each category."""
+        self.build()
+        (_, _, self.thread, _) = lldbutil.run_to_source_breakpoint(
+            self, "// break here", lldb.SBFileSpec("main.cpp"))
+
+        categories = {}
+        for name in self.CATEGORIES:
+            categories[name] = self.create_category(name)
+        # An enabled category goes before the ones enabled earlier, this
+        # orders them first, middle, last, after.
+        for name in ["after", "last", "middle", "first"]:
+            categories[name].SetEnabled(True)
+
+        self.add_summary(categories["last"], "Point", "last")
+        self.add_summary(categories["after"], "Point", "after")
+        # Point is cached from "last", Size as not having a summary.
+        self.check_summaries("last", None)
+
+        # A change after the cached category can only affect the types that
+        # had no formatter.
+        self.add_summary(categories["after"], "Size", "after")
+        self.check_summaries("last", "after")
+        self.delete_summary(categories["after"], "Point")
+        self.check_summaries("last", "after")
+
+        # A change before it takes over.
+        self.add_summary(categories["first"], "Point", "first")
+        self.check_summaries("first", "after")
+        self.delete_summary(categories["first"], "Point")
+        self.check_summaries("last", "after")
+
+        # A disabled category doesn't count until it is enabled.
+        self.add_summary(categories["disabled"], "Point", "disabled")
+        self.add_summary(categories["disabled"], "Size", "disabled")
+        self.check_summaries("last", "after")
+        categories["disabled"].SetEnabled(True)
+        self.check_summaries("disabled", "disabled")
+        categories["disabled"].SetEnabled(False)
+        self.check_summaries("last", "after")
+
+        # Disabling and enabling a category in the middle moves the ones
+        # after it.
+        self.add_summary(categories["middle"], "Point", "middle")
+        self.check_summaries("middle", "after")
+        categories["middle"].SetEnabled(False)
+        self.check_summaries("last", "after")
+        self.add_summary(categories["middle"], "Size", "middle")
+        self.check_summaries("last", "after")
+        categories["middle"].SetEnabled(True)
+        self.check_summaries("middle", "middle")
+
+        # Disabling a category after the cached one keeps the result, enabling
+        # it again puts it before.
+        categories["last"].SetEnabled(False)
+        self.check_summaries("middle", "middle")
+        categories["last"].SetEnabled(True)
+        self.check_summaries("last", "middle")
@@ -0,0 +1,15 @@
+struct Point {
+  int x;
+  int y;
+};
+
+struct Size {
+  int width;
+  int height;
+};
+
+int main() {
+  Point p = {1, 2};
+  Size s = {3, 4};
+  return p.x + s.width; // break here
+}
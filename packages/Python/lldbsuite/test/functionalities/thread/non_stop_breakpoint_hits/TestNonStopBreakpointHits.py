@@ -0,0 +1,67 @@
+"""
+Test that no breakpoint hit is lost while other threads keep running in
+non-stop mode.
+"""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.lldbutil as lldbutil
+
+
+class NonStopBreakpointHitsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+    NO_DEBUG_INFO_TESTCASE = True
+
+    def setUp(self):
+        TestBase.setUp(self)
+        self.addTearDownHook(
+            lambda: self.runCmd("settings clear target.non-stop-mode"))
+
+    @skipUnlessPlatform(["linux"])
+    def test_all_stop(self):
+        """Count the hits of a breakpoint in all-stop mode."""
+        self.build()
+        self.count_hits(False)
+
+    @skipUnlessPlatform(["linux"])
+    def test_non_stop(self):
+        """Count the hits of a breakpoint while the threads that don't step
+        over it keep running."""
+        self.build()
+        self.count_hits(True)
+
+    def count_hits(self, non_stop):
+        self.runCmd("settings set target.non-stop-mode %s" %
+                    ("true" if non_stop else "false"))
+
+        exe = self.getBuildArtifact("a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        # Every thread stops at the breakpoint and steps over it many times
+        # while the other threads run through the same code.
+        hot_bkpt = target.BreakpointCreateBySourceRegex(
+            "// hot breakpoint", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(hot_bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+        hot_bkpt.SetAutoContinue(True)
+        done_bkpt = target.BreakpointCreateBySourceRegex(
+            "// break here", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(done_bkpt.GetNumLocations() > 0, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(
+            None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        thread = lldbutil.get_one_thread_stopped_at_breakpoint(
+            process, done_bkpt)
+        self.assertTrue(thread, "stopped at the end of the run")
+
+        total = thread.GetFrameAtIndex(0).FindVariable(
+            "total").GetValueAsUnsigned()
+        self.assertEqual(total, hot_bkpt.GetHitCount())
+
+        process.Kill()
@@ -0,0 +1,28 @@
+#include <thread>
+#include <vector>
+
+const int num_threads = 4;
+const int num_iterations = 200;
+
+void hit(int i) {
+  (void)i; // hot breakpoint
+}
+
+void loop() {
+  for (int i = 0; i < num_iterations; ++i)
+    hit(i);
+}
+
+void done(int total) {
+  (void)total; // break here
+}
+
+int main() {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i)
+    threads.emplace_back(loop);
+  for (std::thread &t : threads)
+    t.join();
+  done(num_threads * num_iterations);
+  return 0;
+}
@@ -0,0 +1,81 @@
+"""
+Test that unwinding all threads concurrently gives the same backtraces as
+unwinding them one after the other.
+"""
+
+from __future__ import print_function
+
+
+import re
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+import lldbsuite.test.lldbutil as lldbutil
+
+
+class ParallelBacktraceTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+    NO_DEBUG_INFO_TESTCASE = True
+
+    def launch(self):
+        self.build()
+        (target, process, thread, bkpt) = lldbutil.run_to_source_breakpoint(
+            self, "// Set break point at this line.", lldb.SBFileSpec("main.cpp"))
+        return process
+
+    def backtrace_all(self, parallel):
+        """Launch the program and return the frames 'thread backtrace all'
+        prints, without the addresses that change from run to run."""
+        self.runCmd("settings set target.process.parallel-unwind " +
+                    ("true" if parallel else "false"))
+        process = self.launch()
+        result = lldb.SBCommandReturnObject()
+        self.dbg.GetCommandInterpreter().HandleCommand(
+            "thread backtrace all", result)
+        self.assertTrue(result.Succeeded(), result.GetError())
+        process.Kill()
+        # Only the frames in the program are compared, the frames in the
+        # system libraries depend on where the threads wait exactly.
+        return re.findall(r"frame #\d+: 0x[0-9a-f]+ (.*main\.cpp:.*)",
+                          result.GetOutput())
+
+    @skipIfWindows
+    @expectedFailureNetBSD
+    def test_backtrace_all(self):
+        """Test that 'thread backtrace all' prints the same backtraces when the
+        threads are unwound concurrently."""
+        self.addTearDownHook(lambda: self.runCmd(
+            "settings clear target.process.parallel-unwind"))
+        serial = self.backtrace_all(False)
+        parallel = self.backtrace_all(True)
+
+        self.assertEqual(serial, parallel)
+        functions = "\n".join(parallel)
+        for depth in range(16):
+            self.assertIn("wait_for_main(depth=%d)" % depth, functions)
+
+    @skipIfWindows
+    @expectedFailureNetBSD
+    def test_get_threads_with_backtraces(self):
+        """Test SBProcess.GetThreadsWithBacktraces."""
+        process = self.launch()
+
+        threads = process.GetThreadsWithBacktraces(0)
+        self.assertEqual(threads.GetSize(), process.GetNumThreads())
+
+        depths = []
+        for i in range(threads.GetSize()):
+            thread = threads.GetThreadAtIndex(i)
+            self.assertEqual(thread.GetThreadID(),
+                             process.GetThreadAtIndex(i).GetThreadID())
+            frames = [frame.GetFunctionName() for frame in thread]
+            num_recursive = len([name for name in frames
+                                 if name and "wait_for_main" in name])
+            if num_recursive:
+                depths.append(num_recursive - 1)
+        self.assertEqual(sorted(depths), list(range(16)))
+
+        # Limiting the number of frames still returns all threads.
+        threads = process.GetThreadsWithBacktraces(1)
+        self.assertEqual(threads.GetSize(), process.GetNumThreads())
@@ -0,0 +1,46 @@
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+const int num_threads = 16;
+std::mutex mutex;
+std::condition_variable cond;
+int num_waiting = 0;
+bool done = false;
+
+int wait_for_main(int depth) {
+  if (depth > 0)
+    return wait_for_main(depth - 1) + 1;
+
+  std::unique_lock<std::mutex> lock(mutex);
+  ++num_waiting;
+  cond.wait(lock, [] { return done; });
+  return 0;
+}
+
+void stop_here() {}
+
+int main() {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i)
+    threads.push_back(std::thread(wait_for_main, i));
+
+  // Wait until every thread is blocked in cond.wait, so that all stacks are
+  // the same in every run.
+  while (true) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (num_waiting == num_threads)
+      break;
+  }
+  stop_here(); // Set break point at this line.
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+  }
+  cond.notify_all();
+  for (std::thread &thread : threads)
+    thread.join();
+  return 0;
+}
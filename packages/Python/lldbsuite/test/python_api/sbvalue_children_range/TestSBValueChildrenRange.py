@@ -0,0 +1,64 @@
+"""Test SBValue.GetChildrenAtIndexRange against GetChildAtIndex."""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class SBValueChildrenRangeTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NUM_CHILDREN = 300
+
+    @add_test_categories(["pyapi", "libc++"])
+    def test(self):
+        """Test that windows of children match the children fetched one by one."""
+        self.build()
+        (target, process, thread, bkpt) = lldbutil.run_to_source_breakpoint(
+            self, "// break here", lldb.SBFileSpec("main.cpp"))
+        frame = thread.GetFrameAtIndex(0)
+
+        # std::forward_list only counts children up to this limit.
+        self.runCmd("settings set target.max-children-count 1000")
+        self.addTearDownHook(lambda: self.runCmd(
+            "settings clear target.max-children-count"))
+
+        for name in ["map", "list", "forward_list", "unordered_map",
+                     "array"]:
+            variable = frame.FindVariable(name)
+            self.assertTrue(variable.IsValid(), name)
+            self.assertEqual(variable.GetNumChildren(), self.NUM_CHILDREN,
+                             name)
+            expected = [self.describe(variable.GetChildAtIndex(i))
+                        for i in range(self.NUM_CHILDREN)]
+
+            # Start with a window in the middle, then fill in the rest, on a
+            # new value that hasn't made any of its children yet.
+            fresh = target.CreateValueFromAddress(
+                name, variable.GetAddress(), variable.GetType())
+            actual = [None] * self.NUM_CHILDREN
+            for start, count in [(150, 50), (0, 100), (100, 50), (200, 200)]:
+                children = fresh.GetChildrenAtIndexRange(start, count)
+                self.assertEqual(
+                    children.GetSize(),
+                    min(count, self.NUM_CHILDREN - start), name)
+                for i in range(children.GetSize()):
+                    actual[start + i] = self.describe(
+                        children.GetValueAtIndex(i))
+            self.assertEqual(actual, expected, name)
+
+            # Windows that start past the end are empty.
+            self.assertEqual(
+                fresh.GetChildrenAtIndexRange(self.NUM_CHILDREN, 10).GetSize(),
+                0, name)
+
+    def describe(self, value):
+        self.assertTrue(value.IsValid())
+        stream = lldb.SBStream()
+        value.GetDescription(stream)
+        return stream.GetData()
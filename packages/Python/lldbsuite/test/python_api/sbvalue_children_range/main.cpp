@@ -0,0 +1,21 @@
+#include <forward_list>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+int main() {
+  std::map<int, std::string> map;
+  std::list<int> list;
+  std::forward_list<long> forward_list;
+  std::unordered_map<int, int> unordered_map;
+  int array[300];
+  for (int i = 0; i < 300; ++i) {
+    map[i * 7 % 300] = std::to_string(i);
+    list.push_back(i * 3);
+    forward_list.push_front(i);
+    unordered_map[i] = -i;
+    array[i] = i;
+  }
+  return 0; // break here
+}
@@ -0,0 +1,158 @@
+from __future__ import print_function
+
+
+import gdbremote_testcase
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestGdbRemoteBreakpointConditions(
+        gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def start_inferior_and_get_hello_address(self):
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=[
+                "get-code-address-hex:hello",
+                "sleep:1",
+                "call-function:hello"])
+
+        self.add_register_info_collection_packets()
+        self.test_sequence.add_log_lines(
+            [  # Start running after initial stop.
+                "read packet: $c#63",
+                {"type": "output_match", "regex": self.maybe_strict_output_regex(r"code address: 0x([0-9a-fA-F]+)\r\n"),
+                 "capture": {1: "function_address"}},
+                # Now stop the inferior before it calls hello().
+                "read packet: {}".format(chr(3)),
+                {"direction": "send", "regex": r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);"}],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        reg_infos = self.parse_register_info_packets(context)
+        (pc_lldb_reg_index, pc_reg_info) = self.find_pc_reg_info(reg_infos)
+        self.assertIsNotNone(pc_lldb_reg_index)
+        self.assertIsNotNone(context.get("function_address"))
+        self.pc_reg = pc_lldb_reg_index
+        self.function_address = int(context.get("function_address"), 16)
+        self.reset_test_sequence()
+
+    def pc_equals(self, address):
+        # An agent expression for "pc == address": reg, const64, equal, end.
+        bytecode = "26{:04x}25{:016x}1327".format(self.pc_reg, address)
+        return "X{:x},{}".format(len(bytecode) // 2, bytecode)
+
+    def add_set_conditional_breakpoint_packets(self, conditions,
+                                               response="OK"):
+        if self.getArchitecture() in ["arm", "aarch64"]:
+            breakpoint_kind = 4
+        else:
+            breakpoint_kind = 1
+        self.test_sequence.add_log_lines(
+            ["read packet: $Z0,{:x},{};{}#00".format(
+                self.function_address, breakpoint_kind,
+                ";".join(conditions)),
+             "send packet: ${}#00".format(response)],
+            True)
+
+    def add_continue_until_exit_packets(self):
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             # The breakpoint didn't stop hello().
+             {"type": "output_match", "regex": r"^hello, world\r\n$"},
+             {"direction": "send", "regex": r"^\$W00(.*)#[0-9a-fA-F]{2}$"}],
+            True)
+
+    def add_continue_until_breakpoint_packets(self):
+        self.test_sequence.add_log_lines(
+            ["read packet: $c#63",
+             {"direction": "send",
+              "regex": r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);",
+              "capture": {1: "stop_signo"}}],
+            True)
+
+    def check_breakpoint_stop(self, context):
+        self.assertIsNotNone(context)
+        self.assertEqual(int(context.get("stop_signo"), 16),
+                         lldbutil.get_signal_number('SIGTRAP'))
+        # hello() didn't get to print.
+        self.assertEqual(len(context["O_content"]), 0)
+
+    @skipIfWindows # No pty support to test any inferior output
+    @llgs_test
+    # Only targets with hardware single stepping evaluate the conditions.
+    @skipIf(archs=no_match(["i386", "x86_64"]))
+    def test_false_condition_skips_hit_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.start_inferior_and_get_hello_address()
+
+        self.add_set_conditional_breakpoint_packets(
+            [self.pc_equals(self.function_address + 1)])
+        self.add_continue_until_exit_packets()
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+    @skipIfWindows # No pty support to test any inferior output
+    @llgs_test
+    def test_true_condition_reports_hit_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.start_inferior_and_get_hello_address()
+
+        self.add_set_conditional_breakpoint_packets(
+            [self.pc_equals(self.function_address)])
+        self.add_continue_until_breakpoint_packets()
+        self.check_breakpoint_stop(self.expect_gdbremote_sequence())
+
+    @skipIfWindows # No pty support to test any inferior output
+    @llgs_test
+    def test_any_true_condition_reports_hit_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.start_inferior_and_get_hello_address()
+
+        self.add_set_conditional_breakpoint_packets(
+            [self.pc_equals(self.function_address + 1),
+             self.pc_equals(self.function_address)])
+        self.add_continue_until_breakpoint_packets()
+        self.check_breakpoint_stop(self.expect_gdbremote_sequence())
+
+    @skipIfWindows # No pty support to test any inferior output
+    @llgs_test
+    # Only targets with hardware single stepping evaluate the conditions.
+    @skipIf(archs=no_match(["i386", "x86_64"]))
+    def test_reinserting_replaces_conditions_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.start_inferior_and_get_hello_address()
+
+        self.add_set_conditional_breakpoint_packets(
+            [self.pc_equals(self.function_address)])
+        self.add_set_conditional_breakpoint_packets(
+            [self.pc_equals(self.function_address + 1)])
+        self.add_continue_until_exit_packets()
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
+
+    @skipIfWindows # No pty support to test any inferior output
+    @llgs_test
+    def test_malformed_conditions_are_rejected_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.start_inferior_and_get_hello_address()
+
+        # No length, a zero length, no comma after the length and fewer bytes
+        # than the length.
+        for condition in ["X", "X0,", "X3", "X3,2200"]:
+            self.add_set_conditional_breakpoint_packets([condition],
+                                                        response="E03")
+        # A rejected packet doesn't leave a breakpoint behind.
+        self.add_continue_until_exit_packets()
+        self.assertIsNotNone(self.expect_gdbremote_sequence())
@@ -247,6 +247,12 @@ public:
     bool
     IsHardware ();
 
+    void
+    SetFastTrace (bool fast_trace);
+
+    bool
+    IsFastTrace ();
+
     %pythoncode %{
 
         class locations_access(object):
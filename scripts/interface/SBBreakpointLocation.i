@@ -51,6 +51,17 @@ public:
     uint32_t
     GetHitCount ();
 
+    %feature("docstring", "
+    Return the number of hits the trampoline of a fast tracepoint counted.") GetFastTraceHitCount;
+    uint64_t
+    GetFastTraceHitCount ();
+
+    %feature("docstring", "
+    Return the hits of a fast tracepoint recorded since the last call, as an
+    array of dictionaries with the index of the hit and the registers.") GetFastTraceRecords;
+    lldb::SBStructuredData
+    GetFastTraceRecords ();
+
     uint32_t
     GetIgnoreCount ();
 
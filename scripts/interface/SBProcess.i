@@ -388,6 +388,14 @@ public:
     lldb::SBThreadCollection
     GetHistoryThreads (addr_t addr);
 
+    %feature("autodoc", "
+    Unwinds the stacks of all threads concurrently and returns the threads.
+    max_frames is the number of frames to unwind per thread, zero unwinds all
+    frames. Returns an empty collection if the process isn't stopped.") GetThreadsWithBacktraces;
+
+    lldb::SBThreadCollection
+    GetThreadsWithBacktraces (uint32_t max_frames);
+
     bool
     IsInstrumentationRuntimePresent(lldb::InstrumentationRuntimeType type);
 
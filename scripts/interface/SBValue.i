@@ -248,6 +248,26 @@ public:
                      lldb::DynamicValueType use_dynamic,
                      bool can_create_synthetic);
 
+    %feature("docstring", "
+    Get the child values at indexes [start, start + count).
+
+    Children made by synthetic child providers, like the elements of big
+    standard library containers, are fetched much faster this way than
+    with a GetChildAtIndex() call each.
+
+    @param[in] start
+        The index of the first child value to get.
+
+    @param[in] count
+        The number of child values to get, fewer are returned if there are
+        no more children.
+
+    @return
+        A list with a value for each index, the values of children that
+        couldn't be made are invalid.") GetChildrenAtIndexRange;
+    lldb::SBValueList
+    GetChildrenAtIndexRange (uint32_t start, uint32_t count);
+
     lldb::SBValue
     CreateChildAtOffset (const char *name, uint32_t offset, lldb::SBType type);
 
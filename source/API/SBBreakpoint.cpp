@@ -764,6 +764,26 @@ bool SBBreakpoint::IsHardware() const {
   return false;
 }
 
+void SBBreakpoint::SetFastTrace(bool fast_trace) {
+  LLDB_RECORD_METHOD(void, SBBreakpoint, SetFastTrace, (bool), fast_trace);
+
+  BreakpointSP bkpt_sp = GetSP();
+  if (bkpt_sp) {
+    std::lock_guard<std::recursive_mutex> guard(
+        bkpt_sp->GetTarget().GetAPIMutex());
+    bkpt_sp->SetFastTrace(fast_trace);
+  }
+}
+
+bool SBBreakpoint::IsFastTrace() const {
+  LLDB_RECORD_METHOD_CONST_NO_ARGS(bool, SBBreakpoint, IsFastTrace);
+
+  BreakpointSP bkpt_sp = GetSP();
+  if (bkpt_sp)
+    return bkpt_sp->IsFastTrace();
+  return false;
+}
+
 BreakpointSP SBBreakpoint::GetSP() const { return m_opaque_wp.lock(); }
 
 // This is simple collection of breakpoint id's and their target.
@@ -1013,6 +1033,8 @@ void RegisterMethods<SBBreakpoint>(Registry &R) {
                               GetNumBreakpointLocationsFromEvent,
                               (const lldb::SBEvent &));
   LLDB_REGISTER_METHOD_CONST(bool, SBBreakpoint, IsHardware, ());
+  LLDB_REGISTER_METHOD(void, SBBreakpoint, SetFastTrace, (bool));
+  LLDB_REGISTER_METHOD_CONST(bool, SBBreakpoint, IsFastTrace, ());
 }
 
 template <>
@@ -13,11 +13,13 @@
 #include "lldb/API/SBDefines.h"
 #include "lldb/API/SBStream.h"
 #include "lldb/API/SBStringList.h"
+#include "lldb/API/SBStructuredData.h"
 
 #include "lldb/Breakpoint/Breakpoint.h"
 #include "lldb/Breakpoint/BreakpointLocation.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/StreamFile.h"
+#include "lldb/Core/StructuredDataImpl.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/ScriptInterpreter.h"
 #include "lldb/Target/Target.h"
@@ -135,6 +137,55 @@ uint32_t SBBreakpointLocation::GetHitCount() {
     return 0;
 }
 
+uint64_t SBBreakpointLocation::GetFastTraceHitCount() {
+  LLDB_RECORD_METHOD_NO_ARGS(uint64_t, SBBreakpointLocation,
+                             GetFastTraceHitCount);
+
+  BreakpointLocationSP loc_sp = GetSP();
+  if (!loc_sp)
+    return 0;
+  std::lock_guard<std::recursive_mutex> guard(
+      loc_sp->GetTarget().GetAPIMutex());
+  llvm::Expected<uint64_t> count = loc_sp->GetFastTraceHitCount();
+  if (!count) {
+    llvm::consumeError(count.takeError());
+    return 0;
+  }
+  return *count;
+}
+
+SBStructuredData SBBreakpointLocation::GetFastTraceRecords() {
+  LLDB_RECORD_METHOD_NO_ARGS(lldb::SBStructuredData, SBBreakpointLocation,
+                             GetFastTraceRecords);
+
+  SBStructuredData data;
+  BreakpointLocationSP loc_sp = GetSP();
+  if (!loc_sp)
+    return LLDB_RECORD_RESULT(data);
+  std::lock_guard<std::recursive_mutex> guard(
+      loc_sp->GetTarget().GetAPIMutex());
+
+  std::vector<FastTraceRecord> records;
+  if (llvm::Error error = loc_sp->ReadFastTraceRecords(records)) {
+    llvm::consumeError(std::move(error));
+    return LLDB_RECORD_RESULT(data);
+  }
+
+  llvm::ArrayRef<const char *> names = FastTracepoint::GetRegisterNames();
+  auto array_sp = std::make_shared<StructuredData::Array>();
+  for (const FastTraceRecord &record : records) {
+    auto record_sp = std::make_shared<StructuredData::Dictionary>();
+    record_sp->AddIntegerItem("index", record.index);
+    auto registers_sp = std::make_shared<StructuredData::Dictionary>();
+    for (size_t i = 0; i < names.size() && i < record.registers.size(); ++i)
+      registers_sp->AddIntegerItem(names[i], record.registers[i]);
+    record_sp->AddItem("registers", registers_sp);
+    array_sp->AddItem(record_sp);
+  }
+  data.m_impl_up->SetObjectSP(array_sp);
+  return LLDB_RECORD_RESULT(data);
+}
+
 uint32_t SBBreakpointLocation::GetIgnoreCount() {
   LLDB_RECORD_METHOD_NO_ARGS(uint32_t, SBBreakpointLocation, GetIgnoreCount);
 
@@ -472,6 +523,10 @@ void RegisterMethods<SBBreakpointLocation>(Registry &R) {
   LLDB_REGISTER_METHOD(void, SBBreakpointLocation, SetEnabled, (bool));
   LLDB_REGISTER_METHOD(bool, SBBreakpointLocation, IsEnabled, ());
   LLDB_REGISTER_METHOD(uint32_t, SBBreakpointLocation, GetHitCount, ());
+  LLDB_REGISTER_METHOD(uint64_t, SBBreakpointLocation, GetFastTraceHitCount,
+                       ());
+  LLDB_REGISTER_METHOD(lldb::SBStructuredData, SBBreakpointLocation,
+                       GetFastTraceRecords, ());
   LLDB_REGISTER_METHOD(uint32_t, SBBreakpointLocation, GetIgnoreCount, ());
   LLDB_REGISTER_METHOD(void, SBBreakpointLocation, SetIgnoreCount,
                        (uint32_t));
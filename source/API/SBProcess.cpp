@@ -1171,6 +1171,30 @@ SBThreadCollection SBProcess::GetHistoryThreads(addr_t addr) {
   return LLDB_RECORD_RESULT(threads);
 }
 
+SBThreadCollection SBProcess::GetThreadsWithBacktraces(uint32_t max_frames) {
+  LLDB_RECORD_METHOD(lldb::SBThreadCollection, SBProcess,
+                     GetThreadsWithBacktraces, (uint32_t), max_frames);
+
+  SBThreadCollection threads;
+  ProcessSP process_sp(GetSP());
+  if (process_sp) {
+    Process::StopLocker stop_locker;
+    if (stop_locker.TryLock(&process_sp->GetRunLock())) {
+      std::lock_guard<std::recursive_mutex> guard(
+          process_sp->GetTarget().GetAPIMutex());
+      ThreadCollection::collection thread_list;
+      for (ThreadSP thread_sp : process_sp->Threads())
+        thread_list.push_back(thread_sp);
+      process_sp->UnwindThreads(thread_list,
+                                max_frames ? max_frames : UINT32_MAX,
+                                [](size_t) { return true; });
+      threads = SBThreadCollection(
+          std::make_shared<ThreadCollection>(std::move(thread_list)));
+    }
+  }
+  return LLDB_RECORD_RESULT(threads);
+}
+
 bool SBProcess::IsInstrumentationRuntimePresent(
     InstrumentationRuntimeType type) {
   LLDB_RECORD_METHOD(bool, SBProcess, IsInstrumentationRuntimePresent,
@@ -1393,6 +1417,8 @@ void RegisterMethods<SBProcess>(Registry &R) {
                        GetExtendedBacktraceTypeAtIndex, (uint32_t));
   LLDB_REGISTER_METHOD(lldb::SBThreadCollection, SBProcess, GetHistoryThreads,
                        (lldb::addr_t));
+  LLDB_REGISTER_METHOD(lldb::SBThreadCollection, SBProcess,
+                       GetThreadsWithBacktraces, (uint32_t));
   LLDB_REGISTER_METHOD(bool, SBProcess, IsInstrumentationRuntimePresent,
                        (lldb::InstrumentationRuntimeType));
   LLDB_REGISTER_METHOD(lldb::SBError, SBProcess, SaveCore, (const char *));
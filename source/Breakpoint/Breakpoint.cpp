@@ -57,7 +57,8 @@ Breakpoint::Breakpoint(Target &target, SearchFilterSP &filter_sp,
 
 Breakpoint::Breakpoint(Target &new_target, Breakpoint &source_bp)
     : m_being_created(true), m_hardware(source_bp.m_hardware),
-      m_target(new_target), m_name_list(source_bp.m_name_list),
+      m_fast_trace(source_bp.m_fast_trace), m_target(new_target),
+      m_name_list(source_bp.m_name_list),
       m_options_up(new BreakpointOptions(*source_bp.m_options_up)),
       m_locations(*this),
       m_resolve_indirect_symbols(source_bp.m_resolve_indirect_symbols),
@@ -301,6 +302,17 @@ void Breakpoint::SetEnabled(bool enable) {
 
 bool Breakpoint::IsEnabled() { return m_options_up->IsEnabled(); }
 
+void Breakpoint::SetFastTrace(bool fast_trace) {
+  if (fast_trace == m_fast_trace)
+    return;
+
+  // Replace the sites of the locations that are already resolved.
+  m_fast_trace = fast_trace;
+  m_locations.ClearAllBreakpointSites();
+  if (IsEnabled())
+    m_locations.ResolveAllBreakpointSites();
+}
+
 void Breakpoint::SetIgnoreCount(uint32_t n) {
   if (m_options_up->GetIgnoreCount() == n)
     return;
@@ -439,6 +439,39 @@ lldb::BreakpointSiteSP BreakpointLocation::GetBreakpointSite() const {
   return m_bp_site_sp;
 }
 
+static llvm::Error CheckFastTraceSite(const BreakpointSiteSP &bp_site_sp) {
+  if (!bp_site_sp ||
+      bp_site_sp->GetType() != BreakpointSite::eFastTrace ||
+      bp_site_sp->GetFastTraceMemory().buffer_addr == LLDB_INVALID_ADDRESS)
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "location is not a fast tracepoint");
+  return llvm::Error::success();
+}
+
+llvm::Expected<uint64_t> BreakpointLocation::GetFastTraceHitCount() {
+  if (llvm::Error error = CheckFastTraceSite(m_bp_site_sp))
+    return std::move(error);
+  ProcessSP process_sp = m_owner.GetTarget().GetProcessSP();
+  if (!process_sp)
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "no process");
+  return FastTracepoint::ReadHitCount(
+      *process_sp, m_bp_site_sp->GetFastTraceMemory().buffer_addr);
+}
+
+llvm::Error
+BreakpointLocation::ReadFastTraceRecords(std::vector<FastTraceRecord> &records) {
+  if (llvm::Error error = CheckFastTraceSite(m_bp_site_sp))
+    return error;
+  ProcessSP process_sp = m_owner.GetTarget().GetProcessSP();
+  if (!process_sp)
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "no process");
+  return FastTracepoint::ReadRecords(
+      *process_sp, m_bp_site_sp->GetFastTraceMemory().buffer_addr,
+      m_fast_trace_next_record, records);
+}
+
 bool BreakpointLocation::ResolveBreakpointSite() {
   if (m_bp_site_sp)
     return true;
@@ -479,6 +512,7 @@ bool BreakpointLocation::ClearBreakpointSite() {
       m_bp_site_sp->RemoveOwner(GetBreakpoint().GetID(), GetID());
 
     m_bp_site_sp.reset();
+    m_fast_trace_next_record = 0;
     return true;
   }
   return false;
@@ -602,6 +636,15 @@ void BreakpointLocation::GetDescription(Stream *s,
     s->Indent();
     s->Printf("hit count = %-4u\n", GetHitCount());
 
+    if (m_bp_site_sp && m_bp_site_sp->GetType() == BreakpointSite::eFastTrace) {
+      s->Indent();
+      if (llvm::Expected<uint64_t> count = GetFastTraceHitCount())
+        s->Printf("fast trace hit count = %" PRIu64 "\n", *count);
+      else
+        s->Printf("fast trace hit count = <%s>\n",
+                  llvm::toString(count.takeError()).c_str());
+    }
+
     if (m_options_up) {
       s->Indent();
       m_options_up->GetDescription(s, level);
@@ -611,6 +654,12 @@ void BreakpointLocation::GetDescription(Stream *s,
   } else if (level != eDescriptionLevelInitial) {
     s->Printf(", %sresolved, hit count = %u ", (IsResolved() ? "" : "un"),
               GetHitCount());
+    if (m_bp_site_sp && m_bp_site_sp->GetType() == BreakpointSite::eFastTrace) {
+      if (llvm::Expected<uint64_t> count = GetFastTraceHitCount())
+        s->Printf("fast trace hit count = %" PRIu64 " ", *count);
+      else
+        llvm::consumeError(count.takeError());
+    }
     if (m_options_up) {
       m_options_up->GetDescription(s, level);
     }
@@ -145,6 +145,10 @@ BreakpointLocationSP BreakpointSite::GetOwnerAtIndex(size_t index) {
 }
 
 bool BreakpointSite::ValidForThisThread(Thread *thread) {
+  // A thread stopped at a fast tracepoint for another reason didn't hit it,
+  // the trampoline records the hits.
+  if (m_type == eFastTrace)
+    return false;
   std::lock_guard<std::recursive_mutex> guard(m_owners_mutex);
   return m_owners.ValidForThisThread(thread);
 }
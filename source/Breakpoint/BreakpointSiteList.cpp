@@ -177,20 +177,26 @@ bool BreakpointSiteList::FindInRange(lldb::addr_t lower_bound,
   std::lock_guard<std::recursive_mutex> guard(m_mutex);
   collection::const_iterator lower, upper, pos;
   lower = m_bp_site_list.lower_bound(lower_bound);
-  if (lower == m_bp_site_list.end() || (*lower).first >= upper_bound)
-    return false;
 
   // This is one tricky bit.  The breakpoint might overlap the bottom end of
   // the range.  So we grab the breakpoint prior to the lower bound, and check
-  // that that + its byte size isn't in our range.
+  // that that + its byte size isn't in our range. Do this before checking
+  // whether any site starts in the range, the jump of a fast tracepoint can
+  // cover the whole range.
+  bool found = false;
   if (lower != m_bp_site_list.begin()) {
     collection::const_iterator prev_pos = lower;
     prev_pos--;
     const BreakpointSiteSP &prev_bp = (*prev_pos).second;
-    if (prev_bp->GetLoadAddress() + prev_bp->GetByteSize() > lower_bound)
+    if (prev_bp->GetLoadAddress() + prev_bp->GetByteSize() > lower_bound) {
       bp_site_list.Add(prev_bp);
+      found = true;
+    }
   }
 
+  if (lower == m_bp_site_list.end() || (*lower).first >= upper_bound)
+    return found;
+
   upper = m_bp_site_list.upper_bound(upper_bound);
 
   for (pos = lower; pos != upper; pos++) {
@@ -0,0 +1,320 @@
+//===-- FastTracepoint.cpp --------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Breakpoint/FastTracepoint.h"
+
+#include "lldb/Core/Address.h"
+#include "lldb/Core/Disassembler.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Utility/ArchSpec.h"
+#include "lldb/Utility/DataExtractor.h"
+
+#include "llvm/ADT/STLExtras.h"
+
+#include <cstring>
+
+using namespace lldb;
+using namespace lldb_private;
+
+// The trampolines are written for x86_64 only. The layout of the buffer
+// doesn't depend on the architecture.
+static const char *const g_register_names[] = {
+    "rax", "rbx", "rcx", "rdx", "rsi", "rdi", "rbp", "rsp", "r8",
+    "r9",  "r10", "r11", "r12", "r13", "r14", "r15", "rflags"};
+
+// x86_64 register numbers as used in ModRM bytes.
+enum {
+  eRegRAX = 0,
+  eRegRCX = 1,
+  eRegRDX = 2,
+  eRegRBX = 3,
+  eRegRSP = 4,
+  eRegRBP = 5,
+  eRegRSI = 6,
+  eRegRDI = 7,
+};
+
+static const size_t k_header_size = 32;
+static const uint64_t k_num_records = 1024; // Must be a power of two.
+static const size_t k_jump_size = 5;        // jmp rel32
+static const size_t k_max_displaced_size = 16;
+// The trampoline skips the red zone before pushing anything.
+static const int32_t k_red_zone_size = 128;
+
+static size_t GetNumRegisters() {
+  return llvm::array_lengthof(g_register_names);
+}
+
+static size_t GetRecordSize() { return 8 * (1 + GetNumRegisters()); }
+
+static void Append(std::vector<uint8_t> &code,
+                   std::initializer_list<uint8_t> bytes) {
+  code.insert(code.end(), bytes);
+}
+
+static void AppendU32(std::vector<uint8_t> &code, uint32_t value) {
+  for (unsigned i = 0; i < 4; ++i)
+    code.push_back(uint8_t(value >> (i * 8)));
+}
+
+static void AppendU64(std::vector<uint8_t> &code, uint64_t value) {
+  for (unsigned i = 0; i < 8; ++i)
+    code.push_back(uint8_t(value >> (i * 8)));
+}
+
+// mov [rdx + offset], reg
+static void AppendStoreToRecord(std::vector<uint8_t> &code, unsigned reg,
+                                uint32_t offset) {
+  Append(code, {uint8_t(0x48 | (reg >= 8 ? 0x04 : 0x00)), 0x89,
+                uint8_t(0x80 | ((reg & 7) << 3) | eRegRDX)});
+  AppendU32(code, offset);
+}
+
+// mov rax, [rsp + offset]
+static void AppendLoadFromStack(std::vector<uint8_t> &code, uint8_t offset) {
+  if (offset == 0)
+    Append(code, {0x48, 0x8b, 0x04, 0x24});
+  else
+    Append(code, {0x48, 0x8b, 0x44, 0x24, offset});
+}
+
+static void AppendJump(std::vector<uint8_t> &code, addr_t from, addr_t to) {
+  code.push_back(0xe9);
+  AppendU32(code, uint32_t(to - (from + k_jump_size)));
+}
+
+bool FastTracepoint::IsSupported(const ArchSpec &arch) {
+  return arch.GetMachine() == llvm::Triple::x86_64;
+}
+
+llvm::ArrayRef<const char *> FastTracepoint::GetRegisterNames() {
+  return g_register_names;
+}
+
+size_t FastTracepoint::GetMaxDisplacedSize() { return k_max_displaced_size; }
+
+addr_t FastTracepoint::GetMaxDistance() {
+  // Leave room for the size of the allocation in the reach of rel32.
+  return INT32_MAX - 0x100000;
+}
+
+llvm::Expected<size_t>
+FastTracepoint::GetDisplacedSize(const ArchSpec &arch, addr_t addr,
+                                 llvm::ArrayRef<uint8_t> bytes) {
+  if (!IsSupported(arch))
+    return llvm::createStringError(
+        llvm::inconvertibleErrorCode(),
+        "fast tracepoints are not supported for %s",
+        arch.GetTriple().getTriple().c_str());
+
+  DisassemblerSP disasm_sp = Disassembler::DisassembleBytes(
+      arch, nullptr, nullptr, Address(addr), bytes.data(), bytes.size(),
+      UINT32_MAX, false);
+  if (!disasm_sp)
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "unable to disassemble 0x%" PRIx64, addr);
+
+  // The displaced instructions run in the trampoline, so they must not
+  // depend on their address.
+  const InstructionList &insts = disasm_sp->GetInstructionList();
+  size_t size = 0;
+  for (size_t i = 0, e = insts.GetSize(); i < e && size < k_jump_size; ++i) {
+    InstructionSP inst_sp = insts.GetInstructionAtIndex(i);
+    const size_t inst_size = inst_sp->GetOpcode().GetByteSize();
+    if (inst_size == 0)
+      break;
+    const char *operands = inst_sp->GetOperands(nullptr);
+    if (inst_sp->DoesBranch() || (operands && strstr(operands, "rip")))
+      return llvm::createStringError(
+          llvm::inconvertibleErrorCode(),
+          "the instruction at 0x%" PRIx64 " depends on its address",
+          addr + size);
+    size += inst_size;
+  }
+
+  if (size < k_jump_size || size > bytes.size())
+    return llvm::createStringError(
+        llvm::inconvertibleErrorCode(),
+        "not enough instructions at 0x%" PRIx64 " to insert a jump", addr);
+  if (size > k_max_displaced_size)
+    return llvm::createStringError(
+        llvm::inconvertibleErrorCode(),
+        "the instructions at 0x%" PRIx64 " are too long to be displaced",
+        addr);
+  return size;
+}
+
+std::vector<uint8_t> FastTracepoint::BuildJump(addr_t addr,
+                                               size_t displaced_size,
+                                               addr_t trampoline_addr) {
+  std::vector<uint8_t> code;
+  AppendJump(code, addr, trampoline_addr);
+  // Process::EnableFastTracepoint() checks that nothing jumps to the rest of
+  // the displaced bytes, fill them with traps.
+  code.resize(displaced_size, 0xcc);
+  return code;
+}
+
+std::vector<uint8_t>
+FastTracepoint::BuildTrampoline(addr_t addr, addr_t trampoline_addr,
+                                addr_t buffer_addr,
+                                llvm::ArrayRef<uint8_t> displaced) {
+  std::vector<uint8_t> code;
+
+  // lea rsp, [rsp - 128]; pushfq; push rax; push rcx; push rdx
+  Append(code, {0x48, 0x8d, 0x64, 0x24, uint8_t(-k_red_zone_size)});
+  Append(code, {0x9c, 0x50, 0x51, 0x52});
+  const uint8_t rdx_offset = 0, rcx_offset = 8, rax_offset = 16,
+                rflags_offset = 24;
+  const uint32_t rsp_offset = 32 + k_red_zone_size;
+
+  // movabs rax, buffer_addr
+  Append(code, {0x48, 0xb8});
+  AppendU64(code, buffer_addr);
+  // lock inc qword ptr [rax]
+  Append(code, {0xf0, 0x48, 0xff, 0x00});
+  // mov rcx, 1; lock xadd qword ptr [rax + 8], rcx
+  Append(code, {0x48, 0xc7, 0xc1, 0x01, 0x00, 0x00, 0x00});
+  Append(code, {0xf0, 0x48, 0x0f, 0xc1, 0x48, 0x08});
+  // rdx = buffer_addr + header + (rcx % k_num_records) * record_size
+  Append(code, {0x48, 0x89, 0xca});
+  Append(code, {0x48, 0x81, 0xe2});
+  AppendU32(code, k_num_records - 1);
+  Append(code, {0x48, 0x69, 0xd2});
+  AppendU32(code, GetRecordSize());
+  Append(code, {0x48, 0x8d, 0x54, 0x10, uint8_t(k_header_size)});
+
+  // Store the registers in the order of g_register_names. The ones the
+  // trampoline changed come from the stack, through rax.
+  uint32_t offset = 8;
+  auto store = [&](unsigned reg) {
+    AppendStoreToRecord(code, reg, offset);
+    offset += 8;
+  };
+  auto store_from_stack = [&](uint8_t stack_offset) {
+    AppendLoadFromStack(code, stack_offset);
+    store(eRegRAX);
+  };
+  store_from_stack(rax_offset);
+  store(eRegRBX);
+  store_from_stack(rcx_offset);
+  store_from_stack(rdx_offset);
+  store(eRegRSI);
+  store(eRegRDI);
+  store(eRegRBP);
+  // lea rax, [rsp + rsp_offset]
+  Append(code, {0x48, 0x8d, 0x84, 0x24});
+  AppendU32(code, rsp_offset);
+  store(eRegRAX);
+  for (unsigned reg = 8; reg < 16; ++reg)
+    store(reg);
+  store_from_stack(rflags_offset);
+  assert(offset == GetRecordSize());
+
+  // Publish the record with the number of hits up to this one, so that a
+  // zeroed slot doesn't look like a record: inc rcx; mov qword ptr [rdx], rcx
+  Append(code, {0x48, 0xff, 0xc1});
+  Append(code, {0x48, 0x89, 0x0a});
+
+  // pop rdx; pop rcx; pop rax; popfq; lea rsp, [rsp + 128]
+  Append(code, {0x5a, 0x59, 0x58, 0x9d});
+  Append(code, {0x48, 0x8d, 0xa4, 0x24});
+  AppendU32(code, k_red_zone_size);
+
+  code.insert(code.end(), displaced.begin(), displaced.end());
+  AppendJump(code, trampoline_addr + code.size(), addr + displaced.size());
+  return code;
+}
+
+std::vector<uint8_t> FastTracepoint::BuildBufferHeader() {
+  std::vector<uint8_t> header;
+  AppendU64(header, 0);
+  AppendU64(header, 0);
+  AppendU64(header, k_num_records);
+  AppendU64(header, GetRecordSize());
+  return header;
+}
+
+size_t FastTracepoint::GetBufferSize() {
+  return k_header_size + k_num_records * GetRecordSize();
+}
+
+llvm::Expected<uint64_t> FastTracepoint::ReadHitCount(Process &process,
+                                                      addr_t buffer_addr) {
+  Status error;
+  const uint64_t hit_count =
+      process.ReadUnsignedIntegerFromMemory(buffer_addr, 8, 0, error);
+  if (error.Fail())
+    return error.ToError();
+  return hit_count;
+}
+
+llvm::Error FastTracepoint::ReadRecords(Process &process, addr_t buffer_addr,
+                                        uint64_t &next_index,
+                                        std::vector<FastTraceRecord> &records) {
+  Status error;
+  const uint64_t num_records =
+      process.ReadUnsignedIntegerFromMemory(buffer_addr + 8, 8, 0, error);
+  if (error.Fail())
+    return error.ToError();
+  if (num_records <= next_index)
+    return llvm::Error::success();
+
+  // Records older than the last k_num_records ones were overwritten.
+  uint64_t first = next_index;
+  if (num_records - first > k_num_records)
+    first = num_records - k_num_records;
+  const uint64_t count = num_records - first;
+
+  // The records wrap around the end of the buffer at most once, read them
+  // with a single request.
+  const size_t record_size = GetRecordSize();
+  const addr_t records_addr = buffer_addr + k_header_size;
+  const uint64_t first_slot = first % k_num_records;
+  const uint64_t count_to_end = std::min(count, k_num_records - first_slot);
+  std::vector<Process::LoadRange> ranges;
+  ranges.emplace_back(records_addr + first_slot * record_size,
+                      count_to_end * record_size);
+  if (count_to_end < count)
+    ranges.emplace_back(records_addr, (count - count_to_end) * record_size);
+
+  std::vector<uint8_t> data(count * record_size);
+  std::vector<size_t> bytes_read;
+  process.ReadMemoryRanges(ranges, data.data(), bytes_read);
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (bytes_read[i] != ranges[i].GetByteSize())
+      return llvm::createStringError(
+          llvm::inconvertibleErrorCode(),
+          "unable to read the fast tracepoint records at 0x%" PRIx64,
+          ranges[i].GetRangeBase());
+  }
+
+  DataExtractor extractor(data.data(), data.size(), process.GetByteOrder(),
+                          8);
+  lldb::offset_t offset = 0;
+  for (uint64_t index = first; index < num_records; ++index) {
+    const uint64_t num_hits = extractor.GetU64(&offset);
+    FastTraceRecord record;
+    record.index = index;
+    record.registers.resize(GetNumRegisters());
+    for (uint64_t &value : record.registers)
+      value = extractor.GetU64(&offset);
+    // The hit is still being recorded, read it next time.
+    if (num_hits < index + 1) {
+      next_index = index;
+      return llvm::Error::success();
+    }
+    // The slot was reused by a later hit.
+    if (num_hits > index + 1)
+      continue;
+    records.push_back(std::move(record));
+  }
+
+  next_index = num_records;
+  return llvm::Error::success();
+}
@@ -262,7 +262,7 @@ public:
           m_func_names(), m_func_name_type_mask(eFunctionNameTypeNone),
           m_func_regexp(), m_source_text_regexp(), m_modules(), m_load_addr(),
           m_catch_bp(false), m_throw_bp(true), m_hardware(false),
-          m_exception_language(eLanguageTypeUnknown),
+          m_fast_trace(false), m_exception_language(eLanguageTypeUnknown),
           m_language(lldb::eLanguageTypeUnknown),
           m_skip_prologue(eLazyBoolCalculate),
           m_all_files(false), m_move_to_nearest_code(eLazyBoolCalculate) {}
@@ -355,6 +355,10 @@ public:
         m_hardware = true;
         break;
 
+      case 'J':
+        m_fast_trace = true;
+        break;
+
       case 'k': {
           if (m_current_key.empty())
             m_current_key.assign(option_arg);
@@ -505,6 +509,7 @@ public:
       m_catch_bp = false;
       m_throw_bp = true;
       m_hardware = false;
+      m_fast_trace = false;
       m_language = eLanguageTypeUnknown;
       m_exception_language = eLanguageTypeUnknown;
       m_language = lldb::eLanguageTypeUnknown;
@@ -540,6 +545,7 @@ public:
     bool m_catch_bp;
     bool m_throw_bp;
     bool m_hardware; // Request to use hardware breakpoints
+    bool m_fast_trace; // Record hits without stopping
     lldb::LanguageType m_exception_language;
     lldb::LanguageType m_language;
     LazyBool m_skip_prologue;
@@ -584,6 +590,12 @@ protected:
     else if (m_options.m_exception_language != eLanguageTypeUnknown)
       break_type = eSetTypeException;
 
+    if (m_options.m_fast_trace && m_options.m_hardware) {
+      result.AppendError("--fast-trace can't be used with --hardware");
+      result.SetStatus(eReturnStatusFailed);
+      return false;
+    }
+
     BreakpointSP bp_sp = nullptr;
     FileSpec module_spec;
     const bool internal = false;
@@ -745,6 +757,9 @@ protected:
     if (bp_sp) {
       bp_sp->GetOptions()->CopyOverSetOptions(m_bp_opts.GetBreakpointOptions());
 
+      if (m_options.m_fast_trace)
+        bp_sp->SetFastTrace(true);
+
       if (!m_options.m_breakpoint_names.empty()) {
         Status name_error;
         for (auto name : m_options.m_breakpoint_names) {
@@ -10,7 +10,11 @@
 #include "lldb/Host/Host.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
+#include "lldb/Utility/ConstString.h"
+
+#include <inttypes.h>
 
 using namespace lldb;
 using namespace lldb_private;
@@ -86,6 +90,67 @@ protected:
           stat);
       i += 1;
     }
+
+    // The string pool is shared by all targets, so these are always
+    // collected.
+    ConstString::PoolStatistics pool_stats = ConstString::GetPoolStatistics();
+    result.AppendMessageWithFormat("string pool strings : %" PRIu64 "\n",
+                                   pool_stats.num_strings);
+    result.AppendMessageWithFormat("string pool bytes : %" PRIu64 "\n",
+                                   pool_stats.memory_size);
+    result.AppendMessageWithFormat("string pool lookups : %" PRIu64 "\n",
+                                   pool_stats.lookups);
+    result.AppendMessageWithFormat("string pool insertions : %" PRIu64 "\n",
+                                   pool_stats.insertions);
+    result.AppendMessageWithFormat(
+        "string pool lock acquisitions : %" PRIu64 "\n",
+        pool_stats.lock_acquisitions);
+#ifdef LLDB_CONFIGURATION_DEBUG
+    result.AppendMessageWithFormat(
+        "string pool lock contentions : %" PRIu64 "\n",
+        pool_stats.lock_contentions);
+#endif
+
+    if (Process *process = m_exe_ctx.GetProcessPtr()) {
+      MemoryCache::Statistics cache_stats =
+          process->GetMemoryCacheStatistics();
+      result.AppendMessageWithFormat("memory cache hits : %" PRIu64 "\n",
+                                     cache_stats.hits);
+      result.AppendMessageWithFormat("memory cache misses : %" PRIu64 "\n",
+                                     cache_stats.misses);
+      result.AppendMessageWithFormat(
+          "memory cache prefetched lines : %" PRIu64 "\n",
+          cache_stats.prefetched_lines);
+      result.AppendMessageWithFormat(
+          "memory cache evictions : %" PRIu64 "\n", cache_stats.evictions);
+      result.AppendMessageWithFormat(
+          "memory cache lines kept across stops : %" PRIu64 "\n",
+          cache_stats.retained_lines);
+      result.AppendMessageWithFormat(
+          "memory cache process reads : %" PRIu64 "\n",
+          cache_stats.process_reads);
+      result.AppendMessageWithFormat(
+          "memory cache process bytes read : %" PRIu64 "\n",
+          cache_stats.process_bytes_read);
+      result.AppendMessageWithFormat("remote round trips : %" PRIu64 "\n",
+                                     process->GetRemoteRoundTripCount());
+
+      Process::UnwindStatistics unwind_stats = process->GetUnwindStatistics();
+      result.AppendMessageWithFormat("unwind frames unwound : %" PRIu64 "\n",
+                                     unwind_stats.frames_unwound);
+      result.AppendMessageWithFormat(
+          "unwind frames matching the previous stop : %" PRIu64 "\n",
+          unwind_stats.frames_matched);
+      result.AppendMessageWithFormat(
+          "unwind frames reused from the previous stop : %" PRIu64 "\n",
+          unwind_stats.frames_reused);
+      result.AppendMessageWithFormat(
+          "unwind frames rejected from the previous stop : %" PRIu64 "\n",
+          unwind_stats.frames_rejected);
+      result.AppendMessageWithFormat(
+          "stack frame symbol contexts reused : %" PRIu64 "\n",
+          unwind_stats.symbol_contexts_reused);
+    }
     result.SetStatus(eReturnStatusSuccessFinishResult);
     return true;
   }
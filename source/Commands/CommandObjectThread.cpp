@@ -142,11 +142,14 @@ public:
     if (m_unique_stacks) {
       // Iterate over threads, finding unique stack buckets.
       std::set<UniqueStack> unique_stacks;
-      for (const lldb::tid_t &tid : tids) {
-        if (!BucketThread(tid, unique_stacks, result)) {
-          return false;
-        }
-      }
+      bool success = true;
+      const uint32_t num_frames = GetNumFramesToUnwind() ? UINT32_MAX : 0;
+      ForEachThread(tids, num_frames, [&](lldb::tid_t tid) {
+        success = BucketThread(tid, unique_stacks, result);
+        return success;
+      });
+      if (!success)
+        return false;
 
       // Write the thread id's and unique call stacks to the output stream
       Stream &strm = result.GetOutputStream();
@@ -171,15 +174,17 @@ public:
       }
     } else {
       uint32_t idx = 0;
-      for (const lldb::tid_t &tid : tids) {
+      bool success = true;
+      ForEachThread(tids, GetNumFramesToUnwind(), [&](lldb::tid_t tid) {
         if (idx != 0 && m_add_return)
           result.AppendMessage("");
 
-        if (!HandleOneThread(tid, result))
-          return false;
-
+        success = HandleOneThread(tid, result);
         ++idx;
-      }
+        return success;
+      });
+      if (!success)
+        return false;
     }
     return result.Succeeded();
   }
@@ -196,6 +201,31 @@ protected:
 
   virtual bool HandleOneThread(lldb::tid_t, CommandReturnObject &result) = 0;
 
+  // Override this to return the number of frames HandleOneThread needs, if
+  // the threads can be unwound concurrently before they are handled. Zero
+  // handles the threads one after the other without unwinding them first.
+  virtual uint32_t GetNumFramesToUnwind() { return 0; }
+
+  // Call \a callback with every thread in \a tids, in order, until it returns
+  // false. The first \a num_frames frames of the threads are unwound
+  // concurrently, and each thread is handed out as soon as it is unwound.
+  void ForEachThread(const std::vector<lldb::tid_t> &tids, uint32_t num_frames,
+                     llvm::function_ref<bool(lldb::tid_t)> callback) {
+    if (num_frames == 0) {
+      for (const lldb::tid_t &tid : tids)
+        if (!callback(tid))
+          return;
+      return;
+    }
+
+    Process *process = m_exe_ctx.GetProcessPtr();
+    std::vector<ThreadSP> threads;
+    for (const lldb::tid_t &tid : tids)
+      threads.push_back(process->GetThreadList().FindThreadByID(tid));
+    process->UnwindThreads(threads, num_frames,
+                           [&](size_t idx) { return callback(tids[idx]); });
+  }
+
   bool BucketThread(lldb::tid_t tid, std::set<UniqueStack> &unique_stacks,
                     CommandReturnObject &result) {
     // Grab the corresponding thread for the given thread id.
@@ -324,6 +354,16 @@ public:
   Options *GetOptions() override { return &m_options; }
 
 protected:
+  uint32_t GetNumFramesToUnwind() override {
+    // Extended backtraces are computed by running expressions, which must not
+    // resume the process while other threads are unwound.
+    if (m_options.m_extended_backtrace)
+      return 0;
+    if (m_options.m_count > UINT32_MAX - m_options.m_start)
+      return UINT32_MAX;
+    return m_options.m_start + m_options.m_count;
+  }
+
   void DoExtendedBacktrace(Thread *thread, CommandReturnObject &result) {
     SystemRuntime *runtime = thread->GetProcess()->GetSystemRuntime();
     if (runtime) {
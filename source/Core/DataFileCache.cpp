@@ -0,0 +1,158 @@
+//===-- DataFileCache.cpp ---------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/DataFileCache.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Utility/DataBufferLLVM.h"
+#include "lldb/Utility/Log.h"
+#include "lldb/Utility/Logging.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+DataFileCache::DataFileCache(const FileSpec &cache_dir,
+                             llvm::StringRef extension, uint64_t max_byte_size)
+    : m_cache_dir(cache_dir), m_extension(extension),
+      m_max_byte_size(max_byte_size) {}
+
+FileSpec DataFileCache::GetCacheFile(llvm::StringRef key) const {
+  if (!m_cache_dir || key.empty())
+    return FileSpec();
+  FileSpec cache_file = m_cache_dir;
+  cache_file.AppendPathComponent((key + m_extension).str());
+  return cache_file;
+}
+
+DataBufferSP DataFileCache::GetCachedData(llvm::StringRef key) const {
+  FileSpec cache_file = GetCacheFile(key);
+  if (!cache_file || !FileSystem::Instance().Exists(cache_file))
+    return nullptr;
+  // The buffer maps the file into memory instead of reading it.
+  return FileSystem::Instance().CreateDataBuffer(cache_file);
+}
+
+bool DataFileCache::SetCachedData(llvm::StringRef key, llvm::StringRef data) {
+  FileSpec cache_file = GetCacheFile(key);
+  if (!cache_file)
+    return false;
+
+  Log *log = GetLogIfAllCategoriesSet(LIBLLDB_LOG_MODULES);
+  if (std::error_code ec =
+          llvm::sys::fs::create_directories(m_cache_dir.GetPath())) {
+    LLDB_LOG(log, "unable to create cache directory {0}: {1}", m_cache_dir,
+             ec.message());
+    return false;
+  }
+
+  int fd;
+  llvm::SmallString<128> temp_path;
+  if (std::error_code ec = llvm::sys::fs::createUniqueFile(
+          cache_file.GetPath() + "-%%%%%%%%.tmp", fd, temp_path)) {
+    LLDB_LOG(log, "unable to create cache file {0}: {1}", cache_file,
+             ec.message());
+    return false;
+  }
+
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << data;
+    os.close();
+    if (os.has_error()) {
+      os.clear_error();
+      llvm::sys::fs::remove(temp_path);
+      return false;
+    }
+  }
+
+  if (std::error_code ec =
+          llvm::sys::fs::rename(temp_path, cache_file.GetPath())) {
+    LLDB_LOG(log, "unable to write cache file {0}: {1}", cache_file,
+             ec.message());
+    llvm::sys::fs::remove(temp_path);
+    return false;
+  }
+
+  if (m_max_byte_size)
+    Prune();
+  return true;
+}
+
+void DataFileCache::Prune() {
+  struct CacheEntry {
+    std::string path;
+    llvm::sys::TimePoint<> mod_time;
+    uint64_t size;
+  };
+  std::vector<CacheEntry> entries;
+  uint64_t total_size = 0;
+
+  std::error_code ec;
+  for (llvm::sys::fs::directory_iterator it(m_cache_dir.GetPath(), ec), end;
+       it != end && !ec; it.increment(ec)) {
+    if (!llvm::StringRef(it->path()).endswith(m_extension))
+      continue;
+    llvm::ErrorOr<llvm::sys::fs::basic_file_status> status = it->status();
+    if (!status)
+      continue;
+    entries.push_back(
+        {it->path(), status->getLastModificationTime(), status->getSize()});
+    total_size += status->getSize();
+  }
+  if (total_size <= m_max_byte_size)
+    return;
+
+  llvm::sort(entries, [](const CacheEntry &lhs, const CacheEntry &rhs) {
+    return lhs.mod_time < rhs.mod_time;
+  });
+  for (const CacheEntry &entry : entries) {
+    if (total_size <= m_max_byte_size)
+      break;
+    if (!llvm::sys::fs::remove(entry.path))
+      total_size -= entry.size;
+  }
+}
+
+uint32_t ConstStringTable::Add(ConstString s) {
+  auto insertion = m_offsets.try_emplace(s.GetCString(), m_data.size());
+  if (insertion.second) {
+    m_data.append(s.GetCString(), s.GetLength());
+    m_data.push_back('\0');
+  }
+  return insertion.first->second;
+}
+
+ConstStringTableReader::ConstStringTableReader(llvm::StringRef data) {
+  std::vector<llvm::StringRef> strings;
+  std::vector<uint32_t> offsets;
+  size_t offset = 0;
+  while (offset < data.size()) {
+    size_t end = data.find('\0', offset);
+    if (end == llvm::StringRef::npos)
+      break;
+    strings.push_back(data.slice(offset, end));
+    offsets.push_back(offset);
+    offset = end + 1;
+  }
+
+  std::vector<ConstString> interned = ConstString::FromStrings(strings);
+  m_strings.reserve(interned.size());
+  for (size_t i = 0; i < interned.size(); ++i)
+    m_strings.try_emplace(offsets[i], interned[i]);
+}
+
+bool ConstStringTableReader::GetString(uint32_t offset, ConstString &s) const {
+  auto it = m_strings.find(offset);
+  if (it == m_strings.end())
+    return false;
+  s = it->second;
+  return true;
+}
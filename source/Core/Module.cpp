@@ -13,11 +13,13 @@
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/FileSpecList.h"
 #include "lldb/Core/Mangled.h"
+#include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/SearchFilter.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Host/FileSystem.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/ScriptInterpreter.h"
 #include "lldb/Symbol/CompileUnit.h"
@@ -33,6 +35,7 @@
 #include "lldb/Symbol/TypeList.h"
 #include "lldb/Symbol/TypeMap.h"
 #include "lldb/Symbol/TypeSystem.h"
+#include "lldb/Symbol/UnwindTable.h"
 #include "lldb/Target/Language.h"
 #include "lldb/Target/Platform.h"
 #include "lldb/Target/Process.h"
@@ -350,6 +353,7 @@ void Module::SetUUID(const lldb_private::UUID &uuid) {
   if (!m_did_set_uuid) {
     m_uuid = uuid;
     m_did_set_uuid = true;
+    NotifyIndexLists();
   } else {
     lldbassert(0 && "Attempting to overwrite the existing module UUID");
   }
@@ -1095,6 +1099,28 @@ void Module::SetFileSpecAndObjectName(const FileSpec &file,
   m_file = file;
   m_mod_time = FileSystem::Instance().GetModificationTime(file);
   m_object_name = object_name;
+  NotifyIndexLists();
+}
+
+void Module::SetPlatformFileSpec(const FileSpec &file) {
+  m_platform_file = file;
+  NotifyIndexLists();
+}
+
+void Module::AddIndexList(ModuleList *list) {
+  std::lock_guard<std::mutex> guard(m_index_lists_mutex);
+  m_index_lists.push_back(list);
+}
+
+void Module::RemoveIndexList(ModuleList *list) {
+  std::lock_guard<std::mutex> guard(m_index_lists_mutex);
+  llvm::erase_if(m_index_lists, [list](ModuleList *l) { return l == list; });
+}
+
+void Module::NotifyIndexLists() {
+  std::lock_guard<std::mutex> guard(m_index_lists_mutex);
+  for (ModuleList *list : m_index_lists)
+    list->ModuleIdentityChanged(this);
 }
 
 const ArchSpec &Module::GetArchitecture() const { return m_arch; }
@@ -1412,17 +1438,28 @@ size_t Module::FindSymbolsMatchingRegExAndType(const RegularExpression &regex,
 }
 
 void Module::PreloadSymbols() {
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
-  SymbolFile *sym_file = GetSymbolFile();
-  if (!sym_file)
-    return;
+  // Index the unwind information while the symbols are loaded. The unwind
+  // sections are looked up here, so the task only parses their contents and
+  // doesn't need the module lock.
+  UnwindTable &unwind_table = GetUnwindTable();
+  unwind_table.GetEHFrameInfo();
+  std::future<void> unwind_future =
+      TaskPool::AddTask([&unwind_table]() { unwind_table.Preload(); });
 
-  // Prime the symbol file first, since it adds symbols to the symbol table.
-  sym_file->PreloadSymbols();
+  {
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    if (SymbolFile *sym_file = GetSymbolFile()) {
+      // Prime the symbol file first, since it adds symbols to the symbol
+      // table.
+      sym_file->PreloadSymbols();
+
+      // Now we can prime the symbol table.
+      if (Symtab *symtab = sym_file->GetSymtab())
+        symtab->PreloadSymbols();
+    }
+  }
 
-  // Now we can prime the symbol table.
-  if (Symtab *symtab = sym_file->GetSymtab())
-    symtab->PreloadSymbols();
+  TaskPool::Wait(unwind_future);
 }
 
 void Module::SetSymbolFileFileSpec(const FileSpec &file) {
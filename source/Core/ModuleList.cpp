@@ -11,6 +11,7 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Host/FileSystem.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Interpreter/OptionValueFileSpec.h"
 #include "lldb/Interpreter/OptionValueProperties.h"
 #include "lldb/Interpreter/Property.h"
@@ -96,6 +97,9 @@ ModuleListProperties::ModuleListProperties() {
   m_collection_sp =
       std::make_shared<OptionValueProperties>(ConstString("symbols"));
   m_collection_sp->Initialize(g_modulelist_properties);
+  m_collection_sp->SetValueChangedCallback(
+      ePropertyTaskPoolThreadCount,
+      ModuleListProperties::TaskPoolThreadCountChangedCallback, this);
 
   llvm::SmallString<128> path;
   clang::driver::Driver::getDefaultModuleCachePath(path);
@@ -121,6 +125,35 @@ FileSpec ModuleListProperties::GetClangModulesCachePath() const {
       ->GetCurrentValue();
 }
 
+FileSpec ModuleListProperties::GetSymtabCachePath() const {
+  return m_collection_sp
+      ->GetPropertyAtIndexAsOptionValueFileSpec(nullptr, false,
+                                                ePropertySymtabCachePath)
+      ->GetCurrentValue();
+}
+
+uint64_t ModuleListProperties::GetSymtabCacheMaxByteSize() const {
+  const uint32_t idx = ePropertySymtabCacheMaxByteSize;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_modulelist_properties[idx].default_uint_value);
+}
+
+uint64_t ModuleListProperties::GetTaskPoolThreadCount() const {
+  const uint32_t idx = ePropertyTaskPoolThreadCount;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_modulelist_properties[idx].default_uint_value);
+}
+
+void ModuleListProperties::TaskPoolThreadCountChangedCallback(
+    void *baton, OptionValue *option_value) {
+  ModuleListProperties *properties =
+      reinterpret_cast<ModuleListProperties *>(baton);
+  const uint64_t count = properties->GetTaskPoolThreadCount();
+  TaskPool::SetMaxThreadCount(
+      count ? std::min<uint64_t>(count, UINT32_MAX)
+            : GetHardwareConcurrencyHint());
+}
+
 bool ModuleListProperties::GetUseDWARFImporter() const {
   const uint32_t idx = ePropertyUseDWARFImporter;
   return m_collection_sp->GetPropertyAtIndexAsBoolean(
@@ -152,6 +185,7 @@ ModuleList::ModuleList(const ModuleList &rhs)
   std::lock_guard<std::recursive_mutex> lhs_guard(m_modules_mutex);
   std::lock_guard<std::recursive_mutex> rhs_guard(rhs.m_modules_mutex);
   m_modules = rhs.m_modules;
+  BuildIndexes();
 }
 
 ModuleList::ModuleList(ModuleList::Notifier *notifier)
@@ -165,16 +199,22 @@ const ModuleList &ModuleList::operator=(const ModuleList &rhs) {
     std::lock_guard<std::recursive_mutex> rhs_guard(rhs.m_modules_mutex,
                                                     std::adopt_lock);
     m_modules = rhs.m_modules;
+    BuildIndexes();
   }
   return *this;
 }
 
-ModuleList::~ModuleList() = default;
+ModuleList::~ModuleList() {
+  std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
+  for (const auto &entry : m_index_keys)
+    entry.first->RemoveIndexList(this);
+}
 
 void ModuleList::AppendImpl(const ModuleSP &module_sp, bool use_notifier) {
   if (module_sp) {
     std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
     m_modules.push_back(module_sp);
+    AddToIndexes(module_sp.get());
     if (use_notifier && m_notifier)
       m_notifier->NotifyModuleAdded(*this, module_sp);
   }
@@ -211,11 +251,8 @@ void ModuleList::ReplaceEquivalent(const ModuleSP &module_sp) {
 bool ModuleList::AppendIfNeeded(const ModuleSP &module_sp, bool notify) {
   if (module_sp) {
     std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
-    collection::iterator pos, end = m_modules.end();
-    for (pos = m_modules.begin(); pos != end; ++pos) {
-      if (pos->get() == module_sp.get())
-        return false; // Already in the list
-    }
+    if (m_index_keys.count(module_sp.get()))
+      return false; // Already in the list
     // Only push module_sp on the list if it wasn't already in there.
     Append(module_sp, notify);
     return true;
@@ -240,10 +277,13 @@ bool ModuleList::AppendIfNeeded(const ModuleList &module_list) {
 bool ModuleList::RemoveImpl(const ModuleSP &module_sp, bool use_notifier) {
   if (module_sp) {
     std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
+    if (!m_index_keys.count(module_sp.get()))
+      return false;
     collection::iterator pos, end = m_modules.end();
     for (pos = m_modules.begin(); pos != end; ++pos) {
       if (pos->get() == module_sp.get()) {
         m_modules.erase(pos);
+        RemoveFromIndexes(module_sp.get());
         if (use_notifier && m_notifier)
           m_notifier->NotifyModuleRemoved(*this, module_sp);
         return true;
@@ -258,6 +298,7 @@ ModuleList::RemoveImpl(ModuleList::collection::iterator pos,
                        bool use_notifier) {
   ModuleSP module_sp(*pos);
   collection::iterator retval = m_modules.erase(pos);
+  RemoveFromIndexes(module_sp.get());
   if (use_notifier && m_notifier)
     m_notifier->NotifyModuleRemoved(*this, module_sp);
   return retval;
@@ -280,6 +321,8 @@ bool ModuleList::ReplaceModule(const lldb::ModuleSP &old_module_sp,
 bool ModuleList::RemoveIfOrphaned(const Module *module_ptr) {
   if (module_ptr) {
     std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
+    if (!m_index_keys.count(const_cast<Module *>(module_ptr)))
+      return false;
     collection::iterator pos, end = m_modules.end();
     for (pos = m_modules.begin(); pos != end; ++pos) {
       if (pos->get() == module_ptr) {
@@ -339,6 +382,7 @@ void ModuleList::ClearImpl(bool use_notifier) {
   if (use_notifier && m_notifier)
     m_notifier->NotifyWillClearList(*this);
   m_modules.clear();
+  BuildIndexes();
 }
 
 Module *ModuleList::GetModulePointerAtIndex(size_t idx) const {
@@ -586,6 +630,15 @@ size_t ModuleList::FindModules(const ModuleSpec &module_spec,
                                ModuleList &matching_module_list) const {
   size_t existing_matches = matching_module_list.GetSize();
 
+  collection candidates;
+  if (GetIndexedCandidates(module_spec, candidates)) {
+    for (const ModuleSP &module_sp : candidates) {
+      if (module_sp->MatchesModuleSpec(module_spec))
+        matching_module_list.Append(module_sp);
+    }
+    return matching_module_list.GetSize() - existing_matches;
+  }
+
   std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
   collection::const_iterator pos, end = m_modules.end();
   for (pos = m_modules.begin(); pos != end; ++pos) {
@@ -602,14 +655,9 @@ ModuleSP ModuleList::FindModule(const Module *module_ptr) const {
   // Scope for "locker"
   {
     std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
-    collection::const_iterator pos, end = m_modules.end();
-
-    for (pos = m_modules.begin(); pos != end; ++pos) {
-      if ((*pos).get() == module_ptr) {
-        module_sp = (*pos);
-        break;
-      }
-    }
+    Module *module = const_cast<Module *>(module_ptr);
+    if (m_index_keys.count(module))
+      module_sp = module->shared_from_this();
   }
   return module_sp;
 }
@@ -618,12 +666,13 @@ ModuleSP ModuleList::FindModule(const UUID &uuid) const {
   ModuleSP module_sp;
 
   if (uuid.IsValid()) {
-    std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
-    collection::const_iterator pos, end = m_modules.end();
-
-    for (pos = m_modules.begin(); pos != end; ++pos) {
-      if ((*pos)->GetUUID() == uuid) {
-        module_sp = (*pos);
+    ModuleSpec module_spec;
+    module_spec.GetUUID() = uuid;
+    collection candidates;
+    GetIndexedCandidates(module_spec, candidates);
+    for (const ModuleSP &candidate_sp : candidates) {
+      if (candidate_sp->GetUUID() == uuid) {
+        module_sp = candidate_sp;
         break;
       }
     }
@@ -631,6 +680,226 @@ ModuleSP ModuleList::FindModule(const UUID &uuid) const {
   return module_sp;
 }
 
+static llvm::StringRef GetUUIDKey(const UUID &uuid) {
+  llvm::ArrayRef<uint8_t> bytes = uuid.GetBytes();
+  return llvm::StringRef(reinterpret_cast<const char *>(bytes.data()),
+                         bytes.size());
+}
+
+static std::pair<const char *, const char *> GetPathKey(const FileSpec &file) {
+  return {file.GetDirectory().GetCString(), file.GetFilename().GetCString()};
+}
+
+template <typename ModuleVector>
+static void AddToModuleVector(ModuleVector &modules, Module *module) {
+  if (!llvm::is_contained(modules, module))
+    modules.push_back(module);
+}
+
+template <typename MapType, typename KeyType>
+static void RemoveFromModuleVector(MapType &map, const KeyType &key,
+                                   Module *module) {
+  auto pos = map.find(key);
+  if (pos == map.end())
+    return;
+  llvm::erase_if(pos->second, [module](Module *m) { return m == module; });
+  if (pos->second.empty())
+    map.erase(pos);
+}
+
+void ModuleList::AddToIndexes(Module *module) {
+  auto inserted = m_index_keys.try_emplace(module);
+  IndexedKeys &keys = inserted.first->second;
+  ++keys.copies;
+  // Another copy of an indexed module keeps the keys and the position of the
+  // first copy.
+  if (!inserted.second)
+    return;
+  module->AddIndexList(this);
+  keys.order = m_next_order++;
+  keys.file = module->GetFileSpec();
+  keys.platform_file = module->GetPlatformFileSpec();
+  AddFileKeys(module, keys.file);
+  AddFileKeys(module, keys.platform_file);
+  m_pending_uuids.insert(module);
+}
+
+void ModuleList::RemoveFromIndexes(Module *module) {
+  auto pos = m_index_keys.find(module);
+  if (pos == m_index_keys.end())
+    return;
+  if (--pos->second.copies) {
+    // The erased copy may have been the first one.
+    UpdateOrder();
+    return;
+  }
+  const IndexedKeys &keys = pos->second;
+  RemoveFileKeys(module, keys.file);
+  RemoveFileKeys(module, keys.platform_file);
+  if (keys.uuid.IsValid())
+    RemoveFromModuleVector(m_uuid_index, GetUUIDKey(keys.uuid), module);
+  m_pending_uuids.erase(module);
+  m_index_keys.erase(pos);
+  module->RemoveIndexList(this);
+  std::lock_guard<std::mutex> guard(m_changed_mutex);
+  m_changed_modules.erase(module);
+}
+
+void ModuleList::UpdateOrder() {
+  llvm::DenseSet<Module *> seen;
+  for (const ModuleSP &module_sp : m_modules) {
+    if (seen.insert(module_sp.get()).second)
+      m_index_keys[module_sp.get()].order = m_next_order++;
+  }
+}
+
+void ModuleList::BuildIndexes() {
+  for (const auto &entry : m_index_keys)
+    entry.first->RemoveIndexList(this);
+  m_index_keys.clear();
+  m_basename_index.clear();
+  m_path_index.clear();
+  m_uuid_index.clear();
+  m_pending_uuids.clear();
+  {
+    std::lock_guard<std::mutex> guard(m_changed_mutex);
+    m_changed_modules.clear();
+  }
+  for (const ModuleSP &module_sp : m_modules)
+    AddToIndexes(module_sp.get());
+}
+
+void ModuleList::AddFileKeys(Module *module, const FileSpec &file) const {
+  if (!file)
+    return;
+  AddToModuleVector(m_basename_index[file.GetFilename().GetCString()],
+                    module);
+  AddToModuleVector(m_path_index[GetPathKey(file)], module);
+}
+
+void ModuleList::RemoveFileKeys(Module *module, const FileSpec &file) const {
+  if (!file)
+    return;
+  RemoveFromModuleVector(m_basename_index, file.GetFilename().GetCString(),
+                         module);
+  RemoveFromModuleVector(m_path_index, GetPathKey(file), module);
+}
+
+void ModuleList::ModuleIdentityChanged(Module *module) {
+  std::lock_guard<std::mutex> guard(m_changed_mutex);
+  m_changed_modules.insert(module);
+}
+
+void ModuleList::UpdateIndexes() const {
+  llvm::DenseSet<Module *> changed_modules;
+  {
+    std::lock_guard<std::mutex> guard(m_changed_mutex);
+    if (m_changed_modules.empty())
+      return;
+    changed_modules.swap(m_changed_modules);
+  }
+
+  for (Module *module : changed_modules) {
+    auto pos = m_index_keys.find(module);
+    if (pos == m_index_keys.end())
+      continue;
+    IndexedKeys &keys = pos->second;
+    const FileSpec &file = module->GetFileSpec();
+    const FileSpec &platform_file = module->GetPlatformFileSpec();
+    if (GetPathKey(file) != GetPathKey(keys.file) ||
+        GetPathKey(platform_file) != GetPathKey(keys.platform_file)) {
+      RemoveFileKeys(module, keys.file);
+      RemoveFileKeys(module, keys.platform_file);
+      keys.file = file;
+      keys.platform_file = platform_file;
+      AddFileKeys(module, keys.file);
+      AddFileKeys(module, keys.platform_file);
+    }
+    // A module without a UUID may have gotten one, look it up again.
+    if (keys.uuid_indexed && !keys.uuid.IsValid()) {
+      keys.uuid_indexed = false;
+      m_pending_uuids.insert(module);
+    }
+  }
+}
+
+void ModuleList::IndexPendingUUIDs() const {
+  collection pending;
+  {
+    std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
+    UpdateIndexes();
+    for (Module *module : m_pending_uuids)
+      pending.push_back(module->shared_from_this());
+  }
+  if (pending.empty())
+    return;
+
+  // Don't hold the lock while the object files are parsed.
+  std::vector<UUID> uuids;
+  uuids.reserve(pending.size());
+  for (const ModuleSP &module_sp : pending)
+    uuids.push_back(module_sp->GetUUID());
+
+  std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
+  for (size_t i = 0; i < pending.size(); ++i) {
+    Module *module = pending[i].get();
+    // Skip modules that were removed in the meantime.
+    if (!m_pending_uuids.erase(module))
+      continue;
+    IndexedKeys &keys = m_index_keys[module];
+    keys.uuid_indexed = true;
+    keys.uuid = uuids[i];
+    if (keys.uuid.IsValid())
+      AddToModuleVector(m_uuid_index[GetUUIDKey(keys.uuid)], module);
+  }
+}
+
+bool ModuleList::GetIndexedCandidates(const ModuleSpec &module_spec,
+                                      collection &candidates) const {
+  const UUID &uuid = module_spec.GetUUID();
+  const FileSpec &file = module_spec.GetFileSpec()
+                             ? module_spec.GetFileSpec()
+                             : module_spec.GetPlatformFileSpec();
+  // The file name keys are compared case sensitively.
+  if (!uuid.IsValid() && (!file || !file.IsCaseSensitive()))
+    return false;
+
+  if (uuid.IsValid())
+    IndexPendingUUIDs();
+
+  std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
+  UpdateIndexes();
+
+  const ModuleVector *modules = nullptr;
+  if (uuid.IsValid()) {
+    auto pos = m_uuid_index.find(GetUUIDKey(uuid));
+    if (pos != m_uuid_index.end())
+      modules = &pos->second;
+  } else if (file.GetDirectory()) {
+    auto pos = m_path_index.find(GetPathKey(file));
+    if (pos != m_path_index.end())
+      modules = &pos->second;
+  } else {
+    auto pos = m_basename_index.find(file.GetFilename().GetCString());
+    if (pos != m_basename_index.end())
+      modules = &pos->second;
+  }
+  if (!modules)
+    return true;
+
+  std::vector<std::pair<uint64_t, Module *>> ordered;
+  ordered.reserve(modules->size());
+  for (Module *module : *modules)
+    ordered.emplace_back(m_index_keys[module].order, module);
+  llvm::sort(ordered);
+  for (const auto &entry : ordered) {
+    ModuleSP module_sp = entry.second->shared_from_this();
+    candidates.insert(candidates.end(), m_index_keys[entry.second].copies,
+                      module_sp);
+  }
+  return true;
+}
+
 size_t
 ModuleList::FindTypes(Module *search_first, ConstString name,
                       bool name_is_fully_qualified, size_t max_matches,
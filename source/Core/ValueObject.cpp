@@ -152,6 +152,45 @@ ValueObject::ValueObject(ExecutionContextScope *exe_scope,
 // Destructor
 ValueObject::~ValueObject() {}
 
+namespace {
+// Every ValueObject is preceded by a header that records where its memory came
+// from, so that operator delete knows whether it has anything to free.
+struct alignas(alignof(std::max_align_t)) AllocationHeader {
+  bool in_arena;
+};
+} // namespace
+
+static void *InitAllocationHeader(void *memory, bool in_arena) {
+  AllocationHeader *header = static_cast<AllocationHeader *>(memory);
+  header->in_arena = in_arena;
+  return header + 1;
+}
+
+void *ValueObject::operator new(size_t size) {
+  return InitAllocationHeader(
+      ::operator new(sizeof(AllocationHeader) + size), false);
+}
+
+void *ValueObject::operator new(size_t size, ValueObject &parent) {
+  return InitAllocationHeader(
+      parent.GetManager()->Allocate(sizeof(AllocationHeader) + size,
+                                    alignof(AllocationHeader)),
+      true);
+}
+
+void ValueObject::operator delete(void *ptr) {
+  if (!ptr)
+    return;
+  AllocationHeader *header = static_cast<AllocationHeader *>(ptr) - 1;
+  // The arena of the cluster releases its memory all at once.
+  if (!header->in_arena)
+    ::operator delete(header);
+}
+
+void ValueObject::operator delete(void *ptr, ValueObject &parent) {
+  // Only called if a constructor throws, the memory stays in the arena.
+}
+
 bool ValueObject::UpdateValueIfNeeded(bool update_format) {
 
   bool did_change_formats = false;
@@ -521,6 +560,20 @@ ValueObjectSP ValueObject::GetChildAtIndex(size_t idx, bool can_create) {
   return child_sp;
 }
 
+std::vector<ValueObjectSP>
+ValueObject::GetChildrenAtIndexRange(size_t start, size_t count,
+                                     bool can_create) {
+  std::vector<ValueObjectSP> children;
+  const size_t num_children = GetNumChildren();
+  if (start >= num_children)
+    return children;
+  const size_t end = start + std::min(count, num_children - start);
+  children.reserve(end - start);
+  for (size_t idx = start; idx < end; ++idx)
+    children.push_back(GetChildAtIndex(idx, can_create));
+  return children;
+}
+
 lldb::ValueObjectSP
 ValueObject::GetChildAtIndexPath(llvm::ArrayRef<size_t> idxs,
                                  size_t *index_of_error) {
@@ -702,7 +755,7 @@ ValueObject *ValueObject::CreateChildAtIndex(size_t idx,
     if (!child_name_str.empty())
       child_name.SetCString(child_name_str.c_str());
 
-    valobj = new ValueObjectChild(
+    valobj = new (*this) ValueObjectChild(
         *this, child_compiler_type, child_name, child_byte_size,
         child_byte_offset, child_bitfield_bit_size, child_bitfield_bit_offset,
         child_is_base_class, child_is_deref_of_parent, eAddressTypeInvalid,
@@ -1720,13 +1773,12 @@ SwiftASTContextReader ValueObject::GetScratchSwiftASTContext() {
 
 void ValueObject::AddSyntheticChild(ConstString key,
                                     ValueObject *valobj) {
-  m_synthetic_children[key] = valobj;
+  m_synthetic_children[key.GetCString()] = valobj;
 }
 
 ValueObjectSP ValueObject::GetSyntheticChild(ConstString key) const {
   ValueObjectSP synthetic_child_sp;
-  std::map<ConstString, ValueObject *>::const_iterator pos =
-      m_synthetic_children.find(key);
+  auto pos = m_synthetic_children.find(key.GetCString());
   if (pos != m_synthetic_children.end())
     synthetic_child_sp = pos->second->GetSP();
   return synthetic_child_sp;
@@ -1848,7 +1900,7 @@ ValueObjectSP ValueObject::GetSyntheticBitFieldChild(uint32_t from, uint32_t to,
             GetByteSize() * 8 - bit_field_size - bit_field_offset;
       // We haven't made a synthetic array member for INDEX yet, so lets make
       // one and cache it for any future reference.
-      ValueObjectChild *synthetic_child = new ValueObjectChild(
+      ValueObjectChild *synthetic_child = new (*this) ValueObjectChild(
           *this, GetCompilerType(), index_const_str, GetByteSize(), 0,
           bit_field_size, bit_field_offset, false, false, eAddressTypeInvalid,
           0);
@@ -1893,8 +1945,8 @@ ValueObjectSP ValueObject::GetSyntheticChildAtOffset(
   if (!size)
     return {};
   ValueObjectChild *synthetic_child =
-      new ValueObjectChild(*this, type, name_const_str, *size, offset, 0, 0,
-                           false, false, eAddressTypeInvalid, 0);
+      new (*this) ValueObjectChild(*this, type, name_const_str, *size, offset,
+                                   0, 0, false, false, eAddressTypeInvalid, 0);
   if (synthetic_child) {
     AddSyntheticChild(name_const_str, synthetic_child);
     synthetic_child_sp = synthetic_child->GetSP();
@@ -1935,8 +1987,9 @@ ValueObjectSP ValueObject::GetSyntheticBase(uint32_t offset,
   if (!size)
     return {};
   ValueObjectChild *synthetic_child =
-      new ValueObjectChild(*this, type, name_const_str, *size, offset, 0, 0,
-                           is_base_class, false, eAddressTypeInvalid, 0);
+      new (*this) ValueObjectChild(*this, type, name_const_str, *size, offset,
+                                   0, 0, is_base_class, false,
+                                   eAddressTypeInvalid, 0);
   if (synthetic_child) {
     AddSyntheticChild(name_const_str, synthetic_child);
     synthetic_child_sp = synthetic_child->GetSP();
@@ -2009,7 +2062,8 @@ void ValueObject::CalculateSyntheticValue(bool use_synthetic) {
   if (current_synth_sp == m_synthetic_children_sp && m_synthetic_value)
     return;
 
-  m_synthetic_value = new ValueObjectSynthetic(*this, m_synthetic_children_sp);
+  m_synthetic_value =
+      new (*this) ValueObjectSynthetic(*this, m_synthetic_children_sp);
 }
 
 void ValueObject::CalculateDynamicValue(DynamicValueType use_dynamic) {
@@ -2021,7 +2075,8 @@ void ValueObject::CalculateDynamicValue(DynamicValueType use_dynamic) {
     Process *process = exe_ctx.GetProcessPtr();
     if (process && process->IsPossibleDynamicValue(*this)) {
       ClearDynamicTypeInformation();
-      m_dynamic_value = new ValueObjectDynamicValue(*this, use_dynamic);
+      m_dynamic_value =
+          new (*this) ValueObjectDynamicValue(*this, use_dynamic);
     }
   }
 }
@@ -2903,7 +2958,7 @@ ValueObjectSP ValueObject::Dereference(Status &error) {
       if (!child_name_str.empty())
         child_name.SetCString(child_name_str.c_str());
 
-      m_deref_valobj = new ValueObjectChild(
+      m_deref_valobj = new (*this) ValueObjectChild(
           *this, child_compiler_type, child_name, child_byte_size,
           child_byte_offset, child_bitfield_bit_size, child_bitfield_bit_offset,
           child_is_base_class, child_is_deref_of_parent, eAddressTypeInvalid,
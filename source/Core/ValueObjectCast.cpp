@@ -25,7 +25,7 @@ lldb::ValueObjectSP ValueObjectCast::Create(ValueObject &parent,
                                             ConstString name,
                                             const CompilerType &cast_type) {
   ValueObjectCast *cast_valobj_ptr =
-      new ValueObjectCast(parent, name, cast_type);
+      new (parent) ValueObjectCast(parent, name, cast_type);
   return cast_valobj_ptr->GetSP();
 }
 
@@ -279,7 +279,8 @@ ValueObjectConstResult::GetDynamicValue(lldb::DynamicValueType use_dynamic) {
       ExecutionContext exe_ctx(GetExecutionContextRef());
       Process *process = exe_ctx.GetProcessPtr();
       if (process && process->IsPossibleDynamicValue(*this))
-        m_dynamic_value = new ValueObjectDynamicValue(*this, use_dynamic);
+        m_dynamic_value =
+            new (*this) ValueObjectDynamicValue(*this, use_dynamic);
     }
     if (m_dynamic_value)
       return m_dynamic_value->GetSP();
@@ -90,7 +90,7 @@ ValueObject *ValueObjectConstResultImpl::CreateChildAtIndex(
     if (!child_name_str.empty())
       child_name.SetCString(child_name_str.c_str());
 
-    valobj = new ValueObjectConstResultChild(
+    valobj = new (*m_impl_backend) ValueObjectConstResultChild(
         *m_impl_backend, child_compiler_type, child_name, child_byte_size,
         child_byte_offset, child_bitfield_bit_size, child_bitfield_bit_offset,
         child_is_base_class, child_is_deref_of_parent,
@@ -147,8 +147,9 @@ ValueObjectConstResultImpl::Cast(const CompilerType &compiler_type) {
     return lldb::ValueObjectSP();
 
   ValueObjectConstResultCast *result_cast =
-      new ValueObjectConstResultCast(*m_impl_backend, m_impl_backend->GetName(),
-                                     compiler_type, m_live_address);
+      new (*m_impl_backend) ValueObjectConstResultCast(
+          *m_impl_backend, m_impl_backend->GetName(), compiler_type,
+          m_live_address);
   return result_cast->GetSP();
 }
 
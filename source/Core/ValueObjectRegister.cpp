@@ -180,8 +180,8 @@ ValueObject *ValueObjectRegisterSet::CreateChildAtIndex(
   if (m_reg_ctx_sp && m_reg_set) {
     const size_t num_children = GetNumChildren();
     if (idx < num_children)
-      valobj = new ValueObjectRegister(*this, m_reg_ctx_sp,
-                                       m_reg_set->registers[idx]);
+      valobj = new (*this) ValueObjectRegister(*this, m_reg_ctx_sp,
+                                               m_reg_set->registers[idx]);
   }
   return valobj;
 }
@@ -194,8 +194,8 @@ ValueObjectRegisterSet::GetChildMemberWithName(ConstString name,
     const RegisterInfo *reg_info =
         m_reg_ctx_sp->GetRegisterInfoByName(name.AsCString());
     if (reg_info != nullptr)
-      valobj = new ValueObjectRegister(*this, m_reg_ctx_sp,
-                                       reg_info->kinds[eRegisterKindLLDB]);
+      valobj = new (*this) ValueObjectRegister(
+          *this, m_reg_ctx_sp, reg_info->kinds[eRegisterKindLLDB]);
   }
   if (valobj)
     return valobj->GetSP();
@@ -254,11 +254,7 @@ lldb::ValueObjectSP ValueObjectSynthetic::GetChildAtIndex(size_t idx,
       if (!synth_guy)
         return synth_guy;
 
-      if (synth_guy->IsSyntheticChildrenGenerated())
-        m_synthetic_children_cache.AppendObject(synth_guy);
-      m_children_byindex.SetValueForKey(idx, synth_guy.get());
-      synth_guy->SetPreferredDisplayLanguageIfNeeded(
-          GetPreferredDisplayLanguage());
+      CacheChild(idx, synth_guy);
       return synth_guy;
     } else {
       LLDB_LOGF(log,
@@ -280,6 +276,57 @@ lldb::ValueObjectSP ValueObjectSynthetic::GetChildAtIndex(size_t idx,
   }
 }
 
+std::vector<lldb::ValueObjectSP>
+ValueObjectSynthetic::GetChildrenAtIndexRange(size_t start, size_t count,
+                                              bool can_create) {
+  Log *log = GetLogIfAllCategoriesSet(LIBLLDB_LOG_DATAFORMATTERS);
+
+  UpdateValueIfNeeded();
+
+  std::vector<lldb::ValueObjectSP> children;
+  const size_t num_children = GetNumChildren();
+  if (start >= num_children)
+    return children;
+  const size_t end = start + std::min(count, num_children - start);
+  children.reserve(end - start);
+
+  size_t idx = start;
+  while (idx < end) {
+    ValueObject *valobj;
+    if (m_children_byindex.GetValueForKey(idx, valobj)) {
+      children.push_back(valobj->GetSP());
+      ++idx;
+      continue;
+    }
+    if (!can_create || m_synth_filter_up == nullptr) {
+      children.push_back(lldb::ValueObjectSP());
+      ++idx;
+      continue;
+    }
+
+    // Ask the front end for the whole run of children that aren't cached.
+    size_t run_end = idx + 1;
+    while (run_end < end && !m_children_byindex.GetValueForKey(run_end, valobj))
+      ++run_end;
+
+    LLDB_LOGF(log,
+              "[ValueObjectSynthetic::GetChildrenAtIndexRange] name=%s, "
+              "creating children at indexes [%zu, %zu)",
+              GetName().AsCString(), idx, run_end);
+
+    std::vector<lldb::ValueObjectSP> fetched =
+        m_synth_filter_up->GetChildrenAtIndexRange(idx, run_end - idx);
+    fetched.resize(run_end - idx);
+    for (lldb::ValueObjectSP &child_sp : fetched) {
+      if (child_sp)
+        CacheChild(idx, child_sp);
+      children.push_back(child_sp);
+      ++idx;
+    }
+  }
+  return children;
+}
+
 lldb::ValueObjectSP
 ValueObjectSynthetic::GetChildMemberWithName(ConstString name,
                                              bool can_create) {
@@ -323,6 +370,14 @@ void ValueObjectSynthetic::CopyValueData(ValueObject *source) {
   m_error = m_value.GetValueAsData(&exe_ctx, m_data, GetModule().get());
 }
 
+void ValueObjectSynthetic::CacheChild(size_t idx,
+                                      lldb::ValueObjectSP &child_sp) {
+  if (child_sp->IsSyntheticChildrenGenerated())
+    m_synthetic_children_cache.AppendObject(child_sp);
+  m_children_byindex.SetValueForKey(idx, child_sp.get());
+  child_sp->SetPreferredDisplayLanguageIfNeeded(GetPreferredDisplayLanguage());
+}
+
 bool ValueObjectSynthetic::CanProvideValue() {
   if (!UpdateValueIfNeeded())
     return false;
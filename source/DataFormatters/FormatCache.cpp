@@ -12,208 +12,172 @@
 
 #include "lldb/DataFormatters/FormatCache.h"
 
+#include "lldb/DataFormatters/FormatClasses.h"
+
 using namespace lldb;
 using namespace lldb_private;
 
-FormatCache::Entry::Entry()
-    : m_format_cached(false), m_summary_cached(false),
-      m_synthetic_cached(false), m_validator_cached(false), m_format_sp(),
-      m_summary_sp(), m_synthetic_sp(), m_validator_sp() {}
-
-FormatCache::Entry::Entry(lldb::TypeFormatImplSP format_sp)
-    : m_summary_cached(false), m_synthetic_cached(false),
-      m_validator_cached(false), m_summary_sp(), m_synthetic_sp(),
-      m_validator_sp() {
-  SetFormat(format_sp);
-}
-
-FormatCache::Entry::Entry(lldb::TypeSummaryImplSP summary_sp)
-    : m_format_cached(false), m_synthetic_cached(false),
-      m_validator_cached(false), m_format_sp(), m_synthetic_sp(),
-      m_validator_sp() {
-  SetSummary(summary_sp);
-}
-
-FormatCache::Entry::Entry(lldb::SyntheticChildrenSP synthetic_sp)
-    : m_format_cached(false), m_summary_cached(false),
-      m_validator_cached(false), m_format_sp(), m_summary_sp(),
-      m_validator_sp() {
-  SetSynthetic(synthetic_sp);
-}
-
-FormatCache::Entry::Entry(lldb::TypeValidatorImplSP validator_sp)
-    : m_format_cached(false), m_summary_cached(false),
-      m_synthetic_cached(false), m_format_sp(), m_summary_sp(),
-      m_synthetic_sp() {
-  SetValidator(validator_sp);
-}
-
-FormatCache::Entry::Entry(lldb::TypeFormatImplSP format_sp,
-                          lldb::TypeSummaryImplSP summary_sp,
-                          lldb::SyntheticChildrenSP synthetic_sp,
-                          lldb::TypeValidatorImplSP validator_sp) {
-  SetFormat(format_sp);
-  SetSummary(summary_sp);
-  SetSynthetic(synthetic_sp);
-  SetValidator(validator_sp);
-}
-
-bool FormatCache::Entry::IsFormatCached() { return m_format_cached; }
-
-bool FormatCache::Entry::IsSummaryCached() { return m_summary_cached; }
-
-bool FormatCache::Entry::IsSyntheticCached() { return m_synthetic_cached; }
-
-bool FormatCache::Entry::IsValidatorCached() { return m_validator_cached; }
-
-lldb::TypeFormatImplSP FormatCache::Entry::GetFormat() { return m_format_sp; }
-
-lldb::TypeSummaryImplSP FormatCache::Entry::GetSummary() {
-  return m_summary_sp;
-}
-
-lldb::SyntheticChildrenSP FormatCache::Entry::GetSynthetic() {
-  return m_synthetic_sp;
-}
-
-lldb::TypeValidatorImplSP FormatCache::Entry::GetValidator() {
-  return m_validator_sp;
-}
-
-void FormatCache::Entry::SetFormat(lldb::TypeFormatImplSP format_sp) {
-  m_format_cached = true;
-  m_format_sp = format_sp;
-}
-
-void FormatCache::Entry::SetSummary(lldb::TypeSummaryImplSP summary_sp) {
-  m_summary_cached = true;
-  m_summary_sp = summary_sp;
-}
-
-void FormatCache::Entry::SetSynthetic(lldb::SyntheticChildrenSP synthetic_sp) {
-  m_synthetic_cached = true;
-  m_synthetic_sp = synthetic_sp;
-}
-
-void FormatCache::Entry::SetValidator(lldb::TypeValidatorImplSP validator_sp) {
-  m_validator_cached = true;
-  m_validator_sp = validator_sp;
-}
-
 FormatCache::FormatCache()
-    : m_map(), m_mutex()
-#ifdef LLDB_CONFIGURATION_DEBUG
-      ,
-      m_cache_hits(0), m_cache_misses(0)
-#endif
-{
-}
-
-FormatCache::Entry &FormatCache::GetEntry(ConstString type) {
-  auto i = m_map.find(type), e = m_map.end();
-  if (i != e)
-    return i->second;
-  m_map[type] = FormatCache::Entry();
-  return m_map[type];
-}
+    : m_entries(), m_type_map(), m_name_map(), m_mutex(), m_cache_hits(0),
+      m_cache_misses(0) {}
 
-bool FormatCache::GetFormat(ConstString type,
-                            lldb::TypeFormatImplSP &format_sp) {
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
-  auto entry = GetEntry(type);
-  if (entry.IsFormatCached()) {
+template <typename ImplSP>
+bool FormatCache::Found(const CachedFormatter<ImplSP> &cached,
+                        ImplSP &formatter_sp) {
+  if (cached.m_cached) {
 #ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_hits++;
+    m_cache_hits.fetch_add(1, std::memory_order_relaxed);
 #endif
-    format_sp = entry.GetFormat();
+    formatter_sp = cached.m_formatter_sp;
     return true;
   }
 #ifdef LLDB_CONFIGURATION_DEBUG
-  m_cache_misses++;
+  m_cache_misses.fetch_add(1, std::memory_order_relaxed);
 #endif
-  format_sp.reset();
+  formatter_sp.reset();
   return false;
 }
 
-bool FormatCache::GetSummary(ConstString type,
-                             lldb::TypeSummaryImplSP &summary_sp) {
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
-  auto entry = GetEntry(type);
-  if (entry.IsSummaryCached()) {
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_hits++;
-#endif
-    summary_sp = entry.GetSummary();
-    return true;
+template <typename ImplSP>
+bool FormatCache::Get(FormattersMatchData &match_data,
+                      CachedFormatter<ImplSP> Entry::*formatter,
+                      ImplSP &formatter_sp) {
+  FormatCacheTypeKey key;
+  const bool has_key = match_data.GetTypeKeyForCache(key);
+  if (has_key) {
+    llvm::sys::SmartScopedReader<false> guard(m_mutex);
+    auto pos = m_type_map.find(key);
+    if (pos != m_type_map.end())
+      return Found(pos->second->*formatter, formatter_sp);
   }
-#ifdef LLDB_CONFIGURATION_DEBUG
-  m_cache_misses++;
-#endif
-  summary_sp.reset();
-  return false;
-}
 
-bool FormatCache::GetSynthetic(ConstString type,
-                               lldb::SyntheticChildrenSP &synthetic_sp) {
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
-  auto entry = GetEntry(type);
-  if (entry.IsSyntheticCached()) {
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_hits++;
-#endif
-    synthetic_sp = entry.GetSynthetic();
-    return true;
+  // The first lookup of a type goes by name, and remembers the entry under
+  // the key of the type for the next ones.
+  ConstString type_name = match_data.GetTypeForCache();
+  if (type_name) {
+    llvm::sys::SmartScopedWriter<false> guard(m_mutex);
+    auto pos = m_name_map.find(type_name.GetCString());
+    if (pos != m_name_map.end()) {
+      if (has_key && m_type_map.size() < k_max_type_keys)
+        m_type_map[key] = pos->second;
+      return Found(pos->second->*formatter, formatter_sp);
+    }
   }
 #ifdef LLDB_CONFIGURATION_DEBUG
-  m_cache_misses++;
+  m_cache_misses.fetch_add(1, std::memory_order_relaxed);
 #endif
-  synthetic_sp.reset();
+  formatter_sp.reset();
   return false;
 }
 
-bool FormatCache::GetValidator(ConstString type,
-                               lldb::TypeValidatorImplSP &validator_sp) {
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
-  auto entry = GetEntry(type);
-  if (entry.IsValidatorCached()) {
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_hits++;
-#endif
-    validator_sp = entry.GetValidator();
-    return true;
+template <typename ImplSP>
+void FormatCache::Set(FormattersMatchData &match_data,
+                      CachedFormatter<ImplSP> Entry::*formatter,
+                      const ImplSP &formatter_sp, uint32_t category_index) {
+  FormatCacheTypeKey key;
+  const bool has_key = match_data.GetTypeKeyForCache(key);
+  Entry *entry = nullptr;
+  llvm::sys::SmartScopedWriter<false> guard(m_mutex);
+  if (m_type_map.size() >= k_max_type_keys) {
+    m_entries.clear();
+    m_type_map.clear();
+    m_name_map.clear();
+  }
+  if (has_key) {
+    auto pos = m_type_map.find(key);
+    if (pos != m_type_map.end())
+      entry = pos->second;
+  }
+  if (!entry) {
+    ConstString type_name = match_data.GetTypeForCache();
+    if (type_name) {
+      Entry *&named_entry = m_name_map[type_name.GetCString()];
+      if (!named_entry) {
+        m_entries.emplace_back();
+        named_entry = &m_entries.back();
+      }
+      entry = named_entry;
+    } else if (has_key) {
+      m_entries.emplace_back();
+      entry = &m_entries.back();
+    } else {
+      return;
+    }
+    if (has_key)
+      m_type_map[key] = entry;
+  }
+  CachedFormatter<ImplSP> &cached = entry->*formatter;
+  cached.m_cached = true;
+  cached.m_formatter_sp = formatter_sp;
+  cached.m_category_index = category_index;
+}
+
+template <typename CachedFormatter>
+static void InvalidateFormatter(CachedFormatter &cached,
+                                uint32_t category_index) {
+  if (cached.m_cached && cached.m_category_index >= category_index) {
+    cached.m_cached = false;
+    cached.m_formatter_sp.reset();
   }
-#ifdef LLDB_CONFIGURATION_DEBUG
-  m_cache_misses++;
-#endif
-  validator_sp.reset();
-  return false;
 }
 
-void FormatCache::SetFormat(ConstString type,
+bool FormatCache::GetFormat(FormattersMatchData &match_data,
                             lldb::TypeFormatImplSP &format_sp) {
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
-  GetEntry(type).SetFormat(format_sp);
+  return Get(match_data, &Entry::m_format, format_sp);
 }
 
-void FormatCache::SetSummary(ConstString type,
+bool FormatCache::GetSummary(FormattersMatchData &match_data,
                              lldb::TypeSummaryImplSP &summary_sp) {
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
-  GetEntry(type).SetSummary(summary_sp);
+  return Get(match_data, &Entry::m_summary, summary_sp);
 }
 
-void FormatCache::SetSynthetic(ConstString type,
+bool FormatCache::GetSynthetic(FormattersMatchData &match_data,
                                lldb::SyntheticChildrenSP &synthetic_sp) {
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
-  GetEntry(type).SetSynthetic(synthetic_sp);
+  return Get(match_data, &Entry::m_synthetic, synthetic_sp);
 }
 
-void FormatCache::SetValidator(ConstString type,
+bool FormatCache::GetValidator(FormattersMatchData &match_data,
                                lldb::TypeValidatorImplSP &validator_sp) {
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
-  GetEntry(type).SetValidator(validator_sp);
+  return Get(match_data, &Entry::m_validator, validator_sp);
+}
+
+void FormatCache::SetFormat(FormattersMatchData &match_data,
+                            const lldb::TypeFormatImplSP &format_sp,
+                            uint32_t category_index) {
+  Set(match_data, &Entry::m_format, format_sp, category_index);
+}
+
+void FormatCache::SetSummary(FormattersMatchData &match_data,
+                             const lldb::TypeSummaryImplSP &summary_sp,
+                             uint32_t category_index) {
+  Set(match_data, &Entry::m_summary, summary_sp, category_index);
+}
+
+void FormatCache::SetSynthetic(FormattersMatchData &match_data,
+                               const lldb::SyntheticChildrenSP &synthetic_sp,
+                               uint32_t category_index) {
+  Set(match_data, &Entry::m_synthetic, synthetic_sp, category_index);
+}
+
+void FormatCache::SetValidator(FormattersMatchData &match_data,
+                               const lldb::TypeValidatorImplSP &validator_sp,
+                               uint32_t category_index) {
+  Set(match_data, &Entry::m_validator, validator_sp, category_index);
+}
+
+void FormatCache::Invalidate(uint32_t category_index) {
+  llvm::sys::SmartScopedWriter<false> guard(m_mutex);
+  for (Entry &entry : m_entries) {
+    InvalidateFormatter(entry.m_format, category_index);
+    InvalidateFormatter(entry.m_summary, category_index);
+    InvalidateFormatter(entry.m_synthetic, category_index);
+    InvalidateFormatter(entry.m_validator, category_index);
+  }
 }
 
 void FormatCache::Clear() {
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
-  m_map.clear();
+  llvm::sys::SmartScopedWriter<false> guard(m_mutex);
+  m_entries.clear();
+  m_type_map.clear();
+  m_name_map.clear();
 }
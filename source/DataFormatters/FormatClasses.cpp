@@ -11,6 +11,10 @@
 
 #include "lldb/DataFormatters/FormatManager.h"
 
+#include "llvm/Support/Compiler.h"
+
+#include <cctype>
+
 
 
 
@@ -21,9 +25,8 @@ using namespace lldb_private;
 FormattersMatchData::FormattersMatchData(ValueObject &valobj,
                                          lldb::DynamicValueType use_dynamic)
     : m_valobj(valobj), m_dynamic_value_type(use_dynamic),
-      m_formatters_match_vector({}, false), m_type_for_cache(),
-      m_candidate_languages() {
-  m_type_for_cache = FormatManager::GetTypeForCache(valobj, use_dynamic);
+      m_formatters_match_vector({}, false), m_type_for_cache({}, false),
+      m_type_key_for_cache({}, false), m_candidate_languages() {
   m_candidate_languages = FormatManager::GetCandidateLanguages(valobj);
 }
 
@@ -36,7 +39,26 @@ FormattersMatchVector FormattersMatchData::GetMatchesVector() {
   return m_formatters_match_vector.first;
 }
 
-ConstString FormattersMatchData::GetTypeForCache() { return m_type_for_cache; }
+ConstString FormattersMatchData::GetTypeForCache() {
+  if (!m_type_for_cache.second) {
+    m_type_for_cache.second = true;
+    m_type_for_cache.first =
+        FormatManager::GetTypeForCache(m_valobj, m_dynamic_value_type);
+  }
+  return m_type_for_cache.first;
+}
+
+bool FormattersMatchData::GetTypeKeyForCache(FormatCacheTypeKey &key) {
+  if (!m_type_key_for_cache.second) {
+    m_type_key_for_cache.second = true;
+    m_type_key_for_cache.first =
+        FormatManager::GetTypeKeyForCache(m_valobj, m_dynamic_value_type);
+  }
+  if (!m_type_key_for_cache.first)
+    return false;
+  key = *m_type_key_for_cache.first;
+  return true;
+}
 
 CandidateLanguagesVector FormattersMatchData::GetCandidateLanguages() {
   return m_candidate_languages;
@@ -47,3 +69,157 @@ ValueObject &FormattersMatchData::GetValueObject() { return m_valobj; }
 lldb::DynamicValueType FormattersMatchData::GetDynamicValueType() {
   return m_dynamic_value_type;
 }
+
+/// Returns the index after the bracket expression that starts at \a pos, or
+/// StringRef::npos if it isn't closed.
+static size_t SkipBracketExpression(llvm::StringRef regex, size_t pos) {
+  ++pos;
+  if (pos < regex.size() && regex[pos] == '^')
+    ++pos;
+  // A ']' right at the start is part of the expression.
+  if (pos < regex.size() && regex[pos] == ']')
+    ++pos;
+  while (pos < regex.size() && regex[pos] != ']') {
+    // Skip character classes like [:alnum:] as a whole.
+    if (regex[pos] == '[' && pos + 1 < regex.size() &&
+        (regex[pos + 1] == ':' || regex[pos + 1] == '.' ||
+         regex[pos + 1] == '=')) {
+      const char terminator[] = {regex[pos + 1], ']', '\0'};
+      pos = regex.find(terminator, pos + 2);
+      if (pos == llvm::StringRef::npos)
+        return pos;
+      pos += 2;
+      continue;
+    }
+    ++pos;
+  }
+  return pos < regex.size() ? pos + 1 : llvm::StringRef::npos;
+}
+
+/// Returns the index after the group that starts at \a pos, or
+/// StringRef::npos if it isn't closed.
+static size_t SkipGroup(llvm::StringRef regex, size_t pos) {
+  unsigned depth = 0;
+  while (pos < regex.size()) {
+    switch (regex[pos]) {
+    case '(':
+      ++depth;
+      ++pos;
+      break;
+    case ')':
+      ++pos;
+      if (--depth == 0)
+        return pos;
+      break;
+    case '[':
+      pos = SkipBracketExpression(regex, pos);
+      if (pos == llvm::StringRef::npos)
+        return pos;
+      break;
+    case '\\':
+      pos += 2;
+      break;
+    default:
+      ++pos;
+      break;
+    }
+  }
+  return llvm::StringRef::npos;
+}
+
+RegexLiteralFilter::RegexLiteralFilter(llvm::StringRef regex) {
+  // Only the characters outside of groups and bracket expressions are
+  // collected, anything else ends a literal. This is conservative: when in
+  // doubt, a literal is dropped rather than required.
+  std::string literal;
+  bool literal_is_anchored = false;
+  auto end_literal = [&]() {
+    if (literal.empty())
+      return;
+    if (m_literals.empty())
+      m_anchored = literal_is_anchored;
+    m_literals.push_back(std::move(literal));
+    literal.clear();
+  };
+  auto give_up = [&]() {
+    m_literals.clear();
+    m_anchored = false;
+  };
+
+  size_t pos = 0;
+  while (pos < regex.size()) {
+    const char c = regex[pos];
+    switch (c) {
+    case '|':
+      // Top level alternatives don't have to contain anything in common.
+      give_up();
+      return;
+    case '(':
+      end_literal();
+      pos = SkipGroup(regex, pos);
+      break;
+    case ')':
+      give_up();
+      return;
+    case '[':
+      end_literal();
+      pos = SkipBracketExpression(regex, pos);
+      break;
+    case '{':
+      // Only a bound if digits follow, leave anything else alone.
+      if (pos + 1 >= regex.size() || !isdigit(regex[pos + 1])) {
+        give_up();
+        return;
+      }
+      pos = regex.find('}', pos);
+      LLVM_FALLTHROUGH;
+    case '*':
+    case '+':
+    case '?':
+      // The last character of the literal is repeated or optional.
+      if (!literal.empty())
+        literal.pop_back();
+      end_literal();
+      if (pos != llvm::StringRef::npos)
+        ++pos;
+      break;
+    case '\\':
+      end_literal();
+      pos += 2;
+      break;
+    case '.':
+    case '^':
+    case '$':
+      end_literal();
+      ++pos;
+      break;
+    default:
+      if (literal.empty())
+        literal_is_anchored = pos == 1 && regex[0] == '^';
+      literal.push_back(c);
+      ++pos;
+      break;
+    }
+    if (pos == llvm::StringRef::npos) {
+      give_up();
+      return;
+    }
+  }
+  end_literal();
+}
+
+bool RegexLiteralFilter::MayMatch(llvm::StringRef name) const {
+  llvm::StringRef rest = name;
+  for (size_t i = 0; i < m_literals.size(); ++i) {
+    llvm::StringRef literal = m_literals[i];
+    size_t pos;
+    if (i == 0 && m_anchored)
+      pos = rest.startswith(literal) ? 0 : llvm::StringRef::npos;
+    else
+      pos = rest.find(literal);
+    if (pos == llvm::StringRef::npos)
+      return false;
+    rest = rest.drop_front(pos + literal.size());
+  }
+  return true;
+}
@@ -14,6 +14,7 @@
 #include "lldb/Core/Debugger.h"
 #include "lldb/DataFormatters/FormattersHelpers.h"
 #include "lldb/DataFormatters/LanguageCategory.h"
+#include "lldb/Symbol/TypeSystem.h"
 #include "lldb/Target/ExecutionContext.h"
 #include "lldb/Target/Language.h"
 #include "lldb/Utility/Log.h"
@@ -123,6 +124,19 @@ void FormatManager::Changed() {
   }
 }
 
+void FormatManager::CategoryChanged(TypeCategoryImpl &category,
+                                    uint32_t category_index) {
+  ++m_last_revision;
+  // Categories are searched in order, so only what was found in this
+  // category, a later one or none of them can change.
+  m_format_cache.Invalidate(category_index);
+  std::lock_guard<std::recursive_mutex> guard(m_language_categories_mutex);
+  for (auto &iter : m_language_categories_map) {
+    if (iter.second && iter.second->GetCategory().get() == &category)
+      iter.second->GetFormatCache().Clear();
+  }
+}
+
 bool FormatManager::GetFormatFromCString(const char *format_cstr,
                                          bool partial_match_ok,
                                          lldb::Format &format) {
@@ -582,6 +596,24 @@ ConstString FormatManager::GetTypeForCache(ValueObject &valobj,
   return ConstString();
 }
 
+llvm::Optional<FormatCacheTypeKey>
+FormatManager::GetTypeKeyForCache(ValueObject &valobj,
+                                  lldb::DynamicValueType use_dynamic) {
+  ValueObjectSP valobj_sp = valobj.GetQualifiedRepresentationIfAvailable(
+      use_dynamic, valobj.IsSynthetic());
+  // The type name of a dynamic value may come from the runtime rather than
+  // its CompilerType, those are only cached by name.
+  if (!valobj_sp || valobj_sp->IsDynamic())
+    return llvm::None;
+  CompilerType compiler_type = valobj_sp->GetCompilerType();
+  if (!compiler_type.IsValid() ||
+      compiler_type.IsMeaninglessWithoutDynamicResolution())
+    return llvm::None;
+  return FormatCacheTypeKey{compiler_type.GetTypeSystem()->GetUniqueID(),
+                            compiler_type.GetOpaqueQualType(),
+                            valobj_sp->GetBitfieldBitSize()};
+}
+
 std::vector<lldb::LanguageType>
 FormatManager::GetCandidateLanguages(ValueObject &valobj) {
   lldb::LanguageType lang_type = valobj.GetObjectRuntimeLanguage();
@@ -643,26 +675,25 @@ FormatManager::GetFormat(ValueObject &valobj,
 
   TypeFormatImplSP retval;
   Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_DATAFORMATTERS));
-  if (match_data.GetTypeForCache()) {
-    LLDB_LOGF(log,
-              "\n\n[FormatManager::GetFormat] Looking into cache for type %s",
-              match_data.GetTypeForCache().AsCString("<invalid>"));
-    if (m_format_cache.GetFormat(match_data.GetTypeForCache(), retval)) {
-      if (log) {
-        LLDB_LOGF(
-            log, "[FormatManager::GetFormat] Cache search success. Returning.");
-        LLDB_LOGV(log, "Cache hits: {0} - Cache Misses: {1}",
-                  m_format_cache.GetCacheHits(),
-                  m_format_cache.GetCacheMisses());
-      }
-      return retval;
+  LLDB_LOGF(log,
+            "\n\n[FormatManager::GetFormat] Looking into cache for type %s",
+            match_data.GetTypeForCache().AsCString("<invalid>"));
+  if (m_format_cache.GetFormat(match_data, retval)) {
+    if (log) {
+      LLDB_LOGF(
+          log, "[FormatManager::GetFormat] Cache search success. Returning.");
+      LLDB_LOGV(log, "Cache hits: {0} - Cache Misses: {1}",
+                m_format_cache.GetCacheHits(),
+                m_format_cache.GetCacheMisses());
     }
-    LLDB_LOGF(
-        log,
-        "[FormatManager::GetFormat] Cache search failed. Going normal route");
+    return retval;
   }
+  LLDB_LOGF(
+      log,
+      "[FormatManager::GetFormat] Cache search failed. Going normal route");
 
-  retval = m_categories_map.GetFormat(match_data);
+  uint32_t category_index;
+  retval = m_categories_map.GetFormat(match_data, category_index);
   if (!retval) {
     LLDB_LOGF(log,
               "[FormatManager::GetFormat] Search failed. Giving language a "
@@ -686,11 +717,11 @@ FormatManager::GetFormat(ValueObject &valobj,
     retval = GetHardcodedFormat(match_data);
   }
 
-  if (match_data.GetTypeForCache() && (!retval || !retval->NonCacheable())) {
+  if (!retval || !retval->NonCacheable()) {
     LLDB_LOGF(log, "[FormatManager::GetFormat] Caching %p for type %s",
               static_cast<void *>(retval.get()),
               match_data.GetTypeForCache().AsCString("<invalid>"));
-    m_format_cache.SetFormat(match_data.GetTypeForCache(), retval);
+    m_format_cache.SetFormat(match_data, retval, category_index);
   }
   LLDB_LOGV(log, "Cache hits: {0} - Cache Misses: {1}",
             m_format_cache.GetCacheHits(), m_format_cache.GetCacheMisses());
@@ -718,27 +749,26 @@ FormatManager::GetSummaryFormat(ValueObject &valobj,
 
   TypeSummaryImplSP retval;
   Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_DATAFORMATTERS));
-  if (match_data.GetTypeForCache()) {
-    LLDB_LOGF(log,
-              "\n\n[FormatManager::GetSummaryFormat] Looking into cache "
-              "for type %s",
-              match_data.GetTypeForCache().AsCString("<invalid>"));
-    if (m_format_cache.GetSummary(match_data.GetTypeForCache(), retval)) {
-      if (log) {
-        LLDB_LOGF(log,
-                  "[FormatManager::GetSummaryFormat] Cache search success. "
-                  "Returning.");
-        LLDB_LOGV(log, "Cache hits: {0} - Cache Misses: {1}",
-                  m_format_cache.GetCacheHits(),
-                  m_format_cache.GetCacheMisses());
-      }
-      return retval;
+  LLDB_LOGF(log,
+            "\n\n[FormatManager::GetSummaryFormat] Looking into cache "
+            "for type %s",
+            match_data.GetTypeForCache().AsCString("<invalid>"));
+  if (m_format_cache.GetSummary(match_data, retval)) {
+    if (log) {
+      LLDB_LOGF(log,
+                "[FormatManager::GetSummaryFormat] Cache search success. "
+                "Returning.");
+      LLDB_LOGV(log, "Cache hits: {0} - Cache Misses: {1}",
+                m_format_cache.GetCacheHits(),
+                m_format_cache.GetCacheMisses());
     }
-    LLDB_LOGF(log, "[FormatManager::GetSummaryFormat] Cache search failed. "
-                   "Going normal route");
+    return retval;
   }
+  LLDB_LOGF(log, "[FormatManager::GetSummaryFormat] Cache search failed. "
+                 "Going normal route");
 
-  retval = m_categories_map.GetSummaryFormat(match_data);
+  uint32_t category_index;
+  retval = m_categories_map.GetSummaryFormat(match_data, category_index);
   if (!retval) {
     LLDB_LOGF(log, "[FormatManager::GetSummaryFormat] Search failed. Giving "
                    "language a chance.");
@@ -760,11 +790,11 @@ FormatManager::GetSummaryFormat(ValueObject &valobj,
     retval = GetHardcodedSummaryFormat(match_data);
   }
 
-  if (match_data.GetTypeForCache() && (!retval || !retval->NonCacheable())) {
+  if (!retval || !retval->NonCacheable()) {
     LLDB_LOGF(log, "[FormatManager::GetSummaryFormat] Caching %p for type %s",
               static_cast<void *>(retval.get()),
               match_data.GetTypeForCache().AsCString("<invalid>"));
-    m_format_cache.SetSummary(match_data.GetTypeForCache(), retval);
+    m_format_cache.SetSummary(match_data, retval, category_index);
   }
   LLDB_LOGV(log, "Cache hits: {0} - Cache Misses: {1}",
             m_format_cache.GetCacheHits(), m_format_cache.GetCacheMisses());
@@ -792,26 +822,25 @@ FormatManager::GetSyntheticChildren(ValueObject &valobj,
 
   SyntheticChildrenSP retval;
   Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_DATAFORMATTERS));
-  if (match_data.GetTypeForCache()) {
-    LLDB_LOGF(log,
-              "\n\n[FormatManager::GetSyntheticChildren] Looking into "
-              "cache for type %s",
-              match_data.GetTypeForCache().AsCString("<invalid>"));
-    if (m_format_cache.GetSynthetic(match_data.GetTypeForCache(), retval)) {
-      if (log) {
-        LLDB_LOGF(log, "[FormatManager::GetSyntheticChildren] Cache search "
-                       "success. Returning.");
-        LLDB_LOGV(log, "Cache hits: {0} - Cache Misses: {1}",
-                  m_format_cache.GetCacheHits(),
-                  m_format_cache.GetCacheMisses());
-      }
-      return retval;
+  LLDB_LOGF(log,
+            "\n\n[FormatManager::GetSyntheticChildren] Looking into "
+            "cache for type %s",
+            match_data.GetTypeForCache().AsCString("<invalid>"));
+  if (m_format_cache.GetSynthetic(match_data, retval)) {
+    if (log) {
+      LLDB_LOGF(log, "[FormatManager::GetSyntheticChildren] Cache search "
+                     "success. Returning.");
+      LLDB_LOGV(log, "Cache hits: {0} - Cache Misses: {1}",
+                m_format_cache.GetCacheHits(),
+                m_format_cache.GetCacheMisses());
     }
-    LLDB_LOGF(log, "[FormatManager::GetSyntheticChildren] Cache search failed. "
-                   "Going normal route");
+    return retval;
   }
+  LLDB_LOGF(log, "[FormatManager::GetSyntheticChildren] Cache search failed. "
+                 "Going normal route");
 
-  retval = m_categories_map.GetSyntheticChildren(match_data);
+  uint32_t category_index;
+  retval = m_categories_map.GetSyntheticChildren(match_data, category_index);
   if (!retval) {
     LLDB_LOGF(log,
               "[FormatManager::GetSyntheticChildren] Search failed. Giving "
@@ -835,12 +864,12 @@ FormatManager::GetSyntheticChildren(ValueObject &valobj,
     retval = GetHardcodedSyntheticChildren(match_data);
   }
 
-  if (match_data.GetTypeForCache() && (!retval || !retval->NonCacheable())) {
+  if (!retval || !retval->NonCacheable()) {
     LLDB_LOGF(log,
               "[FormatManager::GetSyntheticChildren] Caching %p for type %s",
               static_cast<void *>(retval.get()),
               match_data.GetTypeForCache().AsCString("<invalid>"));
-    m_format_cache.SetSynthetic(match_data.GetTypeForCache(), retval);
+    m_format_cache.SetSynthetic(match_data, retval, category_index);
   }
   LLDB_LOGV(log, "Cache hits: {0} - Cache Misses: {1}",
             m_format_cache.GetCacheHits(), m_format_cache.GetCacheMisses());
@@ -854,26 +883,25 @@ FormatManager::GetValidator(ValueObject &valobj,
 
   TypeValidatorImplSP retval;
   Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_DATAFORMATTERS));
-  if (match_data.GetTypeForCache()) {
-    LLDB_LOGF(
-        log, "\n\n[FormatManager::GetValidator] Looking into cache for type %s",
-        match_data.GetTypeForCache().AsCString("<invalid>"));
-    if (m_format_cache.GetValidator(match_data.GetTypeForCache(), retval)) {
-      if (log) {
-        LLDB_LOGF(
-            log,
-            "[FormatManager::GetValidator] Cache search success. Returning.");
-        LLDB_LOGV(log, "Cache hits: {0} - Cache Misses: {1}",
-                  m_format_cache.GetCacheHits(),
-                  m_format_cache.GetCacheMisses());
-      }
-      return retval;
+  LLDB_LOGF(
+      log, "\n\n[FormatManager::GetValidator] Looking into cache for type %s",
+      match_data.GetTypeForCache().AsCString("<invalid>"));
+  if (m_format_cache.GetValidator(match_data, retval)) {
+    if (log) {
+      LLDB_LOGF(
+          log,
+          "[FormatManager::GetValidator] Cache search success. Returning.");
+      LLDB_LOGV(log, "Cache hits: {0} - Cache Misses: {1}",
+                m_format_cache.GetCacheHits(),
+                m_format_cache.GetCacheMisses());
     }
-    LLDB_LOGF(log, "[FormatManager::GetValidator] Cache search failed. Going "
-                   "normal route");
+    return retval;
   }
+  LLDB_LOGF(log, "[FormatManager::GetValidator] Cache search failed. Going "
+                 "normal route");
 
-  retval = m_categories_map.GetValidator(match_data);
+  uint32_t category_index;
+  retval = m_categories_map.GetValidator(match_data, category_index);
   if (!retval) {
     LLDB_LOGF(log, "[FormatManager::GetValidator] Search failed. Giving "
                    "language a chance.");
@@ -895,11 +923,11 @@ FormatManager::GetValidator(ValueObject &valobj,
     retval = GetHardcodedValidator(match_data);
   }
 
-  if (match_data.GetTypeForCache() && (!retval || !retval->NonCacheable())) {
+  if (!retval || !retval->NonCacheable()) {
     LLDB_LOGF(log, "[FormatManager::GetValidator] Caching %p for type %s",
               static_cast<void *>(retval.get()),
               match_data.GetTypeForCache().AsCString("<invalid>"));
-    m_format_cache.SetValidator(match_data.GetTypeForCache(), retval);
+    m_format_cache.SetValidator(match_data, retval, category_index);
   }
   LLDB_LOGV(log, "Cache hits: {0} - Cache Misses: {1}",
             m_format_cache.GetCacheHits(), m_format_cache.GetCacheMisses());
@@ -12,12 +12,17 @@
 
 #include "lldb/DataFormatters/FormattersHelpers.h"
 
+#include "lldb/Target/Process.h"
 #include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Utility/ConstString.h"
 #include "lldb/Utility/RegularExpression.h"
 
+#include <algorithm>
+#include <numeric>
+#include <string.h>
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::formatters;
@@ -143,3 +148,51 @@ lldb_private::formatters::GetArrayAddressOrPointerValue(ValueObject &valobj) {
 
   return data_addr;
 }
+
+bool lldb_private::formatters::ReadMemoryBlocks(
+    Process &process, llvm::ArrayRef<lldb::addr_t> addrs, size_t size,
+    std::vector<uint8_t> &data, Status &error) {
+  // Blocks are read together if at most this many unused bytes lie between
+  // them, reading those is cheaper than another request to a remote stub.
+  const lldb::addr_t k_max_gap = 256;
+  const lldb::addr_t k_max_read_size = 64 * 1024;
+
+  data.resize(addrs.size() * size);
+  std::vector<size_t> order(addrs.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&addrs](size_t lhs, size_t rhs) {
+    return addrs[lhs] < addrs[rhs];
+  });
+
+  auto read_block = [&](lldb::addr_t addr, uint8_t *dst, size_t length) {
+    return process.ReadMemory(addr, dst, length, error) == length;
+  };
+
+  std::vector<uint8_t> buffer;
+  size_t first = 0;
+  while (first < order.size()) {
+    const lldb::addr_t read_start = addrs[order[first]];
+    lldb::addr_t read_end = read_start + size;
+    size_t last = first + 1;
+    while (last < order.size() && addrs[order[last]] <= read_end + k_max_gap &&
+           addrs[order[last]] + size - read_start <= k_max_read_size) {
+      read_end = std::max<lldb::addr_t>(read_end, addrs[order[last]] + size);
+      ++last;
+    }
+
+    buffer.resize(read_end - read_start);
+    if (read_block(read_start, buffer.data(), buffer.size())) {
+      for (size_t i = first; i < last; ++i)
+        memcpy(data.data() + order[i] * size,
+               buffer.data() + (addrs[order[i]] - read_start), size);
+    } else {
+      // The gaps may not be readable, fall back to reading block by block.
+      for (size_t i = first; i < last; ++i)
+        if (!read_block(addrs[order[i]], data.data() + order[i] * size, size))
+          return false;
+      error.Clear();
+    }
+    first = last;
+  }
+  return true;
+}
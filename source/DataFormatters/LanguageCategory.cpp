@@ -42,17 +42,14 @@ bool LanguageCategory::Get(FormattersMatchData &match_data,
   if (!IsEnabled())
     return false;
 
-  if (match_data.GetTypeForCache()) {
-    if (m_format_cache.GetFormat(match_data.GetTypeForCache(), format_sp))
-      return format_sp.get() != nullptr;
-  }
+  if (m_format_cache.GetFormat(match_data, format_sp))
+    return format_sp.get() != nullptr;
 
   ValueObject &valobj(match_data.GetValueObject());
   bool result =
       m_category_sp->Get(valobj, match_data.GetMatchesVector(), format_sp);
-  if (match_data.GetTypeForCache() &&
-      (!format_sp || !format_sp->NonCacheable())) {
-    m_format_cache.SetFormat(match_data.GetTypeForCache(), format_sp);
+  if (!format_sp || !format_sp->NonCacheable()) {
+    m_format_cache.SetFormat(match_data, format_sp);
   }
   return result;
 }
@@ -65,17 +62,14 @@ bool LanguageCategory::Get(FormattersMatchData &match_data,
   if (!IsEnabled())
     return false;
 
-  if (match_data.GetTypeForCache()) {
-    if (m_format_cache.GetSummary(match_data.GetTypeForCache(), format_sp))
-      return format_sp.get() != nullptr;
-  }
+  if (m_format_cache.GetSummary(match_data, format_sp))
+    return format_sp.get() != nullptr;
 
   ValueObject &valobj(match_data.GetValueObject());
   bool result =
       m_category_sp->Get(valobj, match_data.GetMatchesVector(), format_sp);
-  if (match_data.GetTypeForCache() &&
-      (!format_sp || !format_sp->NonCacheable())) {
-    m_format_cache.SetSummary(match_data.GetTypeForCache(), format_sp);
+  if (!format_sp || !format_sp->NonCacheable()) {
+    m_format_cache.SetSummary(match_data, format_sp);
   }
   return result;
 }
@@ -88,17 +82,14 @@ bool LanguageCategory::Get(FormattersMatchData &match_data,
   if (!IsEnabled())
     return false;
 
-  if (match_data.GetTypeForCache()) {
-    if (m_format_cache.GetSynthetic(match_data.GetTypeForCache(), format_sp))
-      return format_sp.get() != nullptr;
-  }
+  if (m_format_cache.GetSynthetic(match_data, format_sp))
+    return format_sp.get() != nullptr;
 
   ValueObject &valobj(match_data.GetValueObject());
   bool result =
       m_category_sp->Get(valobj, match_data.GetMatchesVector(), format_sp);
-  if (match_data.GetTypeForCache() &&
-      (!format_sp || !format_sp->NonCacheable())) {
-    m_format_cache.SetSynthetic(match_data.GetTypeForCache(), format_sp);
+  if (!format_sp || !format_sp->NonCacheable()) {
+    m_format_cache.SetSynthetic(match_data, format_sp);
   }
   return result;
 }
@@ -111,17 +102,14 @@ bool LanguageCategory::Get(FormattersMatchData &match_data,
   if (!IsEnabled())
     return false;
 
-  if (match_data.GetTypeForCache()) {
-    if (m_format_cache.GetValidator(match_data.GetTypeForCache(), format_sp))
-      return format_sp.get() != nullptr;
-  }
+  if (m_format_cache.GetValidator(match_data, format_sp))
+    return format_sp.get() != nullptr;
 
   ValueObject &valobj(match_data.GetValueObject());
   bool result =
       m_category_sp->Get(valobj, match_data.GetMatchesVector(), format_sp);
-  if (match_data.GetTypeForCache() &&
-      (!format_sp || !format_sp->NonCacheable())) {
-    m_format_cache.SetValidator(match_data.GetTypeForCache(), format_sp);
+  if (!format_sp || !format_sp->NonCacheable()) {
+    m_format_cache.SetValidator(match_data, format_sp);
   }
   return result;
 }
@@ -139,9 +127,8 @@ bool LanguageCategory::GetHardcoded(FormatManager &fmt_mgr,
     if ((format_sp = candidate(valobj, use_dynamic, fmt_mgr)))
       break;
   }
-  if (match_data.GetTypeForCache() &&
-      (!format_sp || !format_sp->NonCacheable())) {
-    m_format_cache.SetFormat(match_data.GetTypeForCache(), format_sp);
+  if (!format_sp || !format_sp->NonCacheable()) {
+    m_format_cache.SetFormat(match_data, format_sp);
   }
   return format_sp.get() != nullptr;
 }
@@ -159,9 +146,8 @@ bool LanguageCategory::GetHardcoded(FormatManager &fmt_mgr,
     if ((format_sp = candidate(valobj, use_dynamic, fmt_mgr)))
       break;
   }
-  if (match_data.GetTypeForCache() &&
-      (!format_sp || !format_sp->NonCacheable())) {
-    m_format_cache.SetSummary(match_data.GetTypeForCache(), format_sp);
+  if (!format_sp || !format_sp->NonCacheable()) {
+    m_format_cache.SetSummary(match_data, format_sp);
   }
   return format_sp.get() != nullptr;
 }
@@ -179,9 +165,8 @@ bool LanguageCategory::GetHardcoded(FormatManager &fmt_mgr,
     if ((format_sp = candidate(valobj, use_dynamic, fmt_mgr)))
       break;
   }
-  if (match_data.GetTypeForCache() &&
-      (!format_sp || !format_sp->NonCacheable())) {
-    m_format_cache.SetSynthetic(match_data.GetTypeForCache(), format_sp);
+  if (!format_sp || !format_sp->NonCacheable()) {
+    m_format_cache.SetSynthetic(match_data, format_sp);
   }
   return format_sp.get() != nullptr;
 }
@@ -199,9 +184,8 @@ bool LanguageCategory::GetHardcoded(FormatManager &fmt_mgr,
     if ((format_sp = candidate(valobj, use_dynamic, fmt_mgr)))
       break;
   }
-  if (match_data.GetTypeForCache() &&
-      (!format_sp || !format_sp->NonCacheable())) {
-    m_format_cache.SetValidator(match_data.GetTypeForCache(), format_sp);
+  if (!format_sp || !format_sp->NonCacheable()) {
+    m_format_cache.SetValidator(match_data, format_sp);
   }
   return format_sp.get() != nullptr;
 }
@@ -16,12 +16,13 @@ using namespace lldb_private;
 TypeCategoryImpl::TypeCategoryImpl(
     IFormatChangeListener *clist, ConstString name,
     std::initializer_list<lldb::LanguageType> langs)
-    : m_format_cont("format", "regex-format", clist),
-      m_summary_cont("summary", "regex-summary", clist),
-      m_filter_cont("filter", "regex-filter", clist),
-      m_synth_cont("synth", "regex-synth", clist),
-      m_validator_cont("validator", "regex-validator", clist), m_enabled(false),
-      m_change_listener(clist), m_mutex(), m_name(name), m_languages() {
+    : m_format_cont("format", "regex-format", this),
+      m_summary_cont("summary", "regex-summary", this),
+      m_filter_cont("filter", "regex-filter", this),
+      m_synth_cont("synth", "regex-synth", this),
+      m_validator_cont("validator", "regex-validator", this), m_enabled(false),
+      m_change_listener(clist), m_mutex(), m_name(name), m_languages(),
+      m_active_index(UINT32_MAX) {
   for (const lldb::LanguageType lang : langs)
     AddLanguage(lang);
 }
@@ -577,8 +578,16 @@ void TypeCategoryImpl::Enable(bool value, uint32_t position) {
   std::lock_guard<std::recursive_mutex> guard(m_mutex);
   if ((m_enabled = value))
     m_enabled_position = position;
+  Changed();
+}
+
+void TypeCategoryImpl::Changed() {
   if (m_change_listener)
-    m_change_listener->Changed();
+    m_change_listener->CategoryChanged(*this, m_active_index);
+}
+
+uint32_t TypeCategoryImpl::GetCurrentRevision() {
+  return m_change_listener ? m_change_listener->GetCurrentRevision() : 0;
 }
 
 std::string TypeCategoryImpl::GetDescription() {
@@ -76,6 +76,7 @@ bool TypeCategoryMap::Enable(ValueSP category, Position pos) {
       m_active_categories.insert(iter, category);
     } else
       return false;
+    UpdateActiveIndexes();
     category->Enable(true, pos);
     return true;
   }
@@ -86,12 +87,25 @@ bool TypeCategoryMap::Disable(ValueSP category) {
   std::lock_guard<std::recursive_mutex> guard(m_map_mutex);
   if (category.get()) {
     m_active_categories.remove_if(delete_matching_categories(category));
+    UpdateActiveIndexes();
+    // The change is reported at the position the category had.
     category->Disable();
+    category->m_active_index = UINT32_MAX;
     return true;
   }
   return false;
 }
 
+void TypeCategoryMap::UpdateActiveIndexes() {
+  // Go backwards so that a category enabled twice gets its first position,
+  // which is where lookups find it.
+  uint32_t index = m_active_categories.size();
+  for (auto pos = m_active_categories.rbegin(),
+            end = m_active_categories.rend();
+       pos != end; ++pos)
+    (*pos)->m_active_index = --index;
+}
+
 void TypeCategoryMap::EnableAllCategories() {
   std::lock_guard<std::recursive_mutex> guard(m_map_mutex);
   std::vector<ValueSP> sorted_categories(m_map.size(), ValueSP());
@@ -125,6 +139,8 @@ void TypeCategoryMap::DisableAllCategories() {
 
 void TypeCategoryMap::Clear() {
   std::lock_guard<std::recursive_mutex> guard(m_map_mutex);
+  for (const lldb::TypeCategoryImplSP &category : m_active_categories)
+    category->m_active_index = UINT32_MAX;
   m_map.clear();
   m_active_categories.clear();
   if (listener)
@@ -170,7 +186,8 @@ bool TypeCategoryMap::AnyMatches(
 }
 
 lldb::TypeFormatImplSP
-TypeCategoryMap::GetFormat(FormattersMatchData &match_data) {
+TypeCategoryMap::GetFormat(FormattersMatchData &match_data,
+                           uint32_t &category_index) {
   std::lock_guard<std::recursive_mutex> guard(m_map_mutex);
 
   uint32_t reason_why;
@@ -192,7 +209,9 @@ TypeCategoryMap::GetFormat(FormattersMatchData &match_data) {
     }
   }
 
-  for (begin = m_active_categories.begin(); begin != end; begin++) {
+  category_index = 0;
+  for (begin = m_active_categories.begin(); begin != end;
+       begin++, category_index++) {
     lldb::TypeCategoryImplSP category_sp = *begin;
     lldb::TypeFormatImplSP current_format;
     LLDB_LOGF(log, "[TypeCategoryMap::GetFormat] Trying to use category %s",
@@ -203,13 +222,15 @@ TypeCategoryMap::GetFormat(FormattersMatchData &match_data) {
       continue;
     return current_format;
   }
+  category_index = UINT32_MAX;
   LLDB_LOGF(log,
             "[TypeCategoryMap::GetFormat] nothing found - returning empty SP");
   return lldb::TypeFormatImplSP();
 }
 
 lldb::TypeSummaryImplSP
-TypeCategoryMap::GetSummaryFormat(FormattersMatchData &match_data) {
+TypeCategoryMap::GetSummaryFormat(FormattersMatchData &match_data,
+                                  uint32_t &category_index) {
   std::lock_guard<std::recursive_mutex> guard(m_map_mutex);
 
   uint32_t reason_why;
@@ -231,7 +252,9 @@ TypeCategoryMap::GetSummaryFormat(FormattersMatchData &match_data) {
     }
   }
 
-  for (begin = m_active_categories.begin(); begin != end; begin++) {
+  category_index = 0;
+  for (begin = m_active_categories.begin(); begin != end;
+       begin++, category_index++) {
     lldb::TypeCategoryImplSP category_sp = *begin;
     lldb::TypeSummaryImplSP current_format;
     LLDB_LOGF(log, "[CategoryMap::GetSummaryFormat] Trying to use category %s",
@@ -242,6 +265,7 @@ TypeCategoryMap::GetSummaryFormat(FormattersMatchData &match_data) {
       continue;
     return current_format;
   }
+  category_index = UINT32_MAX;
   LLDB_LOGF(
       log,
       "[CategoryMap::GetSummaryFormat] nothing found - returning empty SP");
@@ -249,7 +273,8 @@ TypeCategoryMap::GetSummaryFormat(FormattersMatchData &match_data) {
 }
 
 lldb::SyntheticChildrenSP
-TypeCategoryMap::GetSyntheticChildren(FormattersMatchData &match_data) {
+TypeCategoryMap::GetSyntheticChildren(FormattersMatchData &match_data,
+                                      uint32_t &category_index) {
   std::lock_guard<std::recursive_mutex> guard(m_map_mutex);
 
   uint32_t reason_why;
@@ -272,7 +297,9 @@ TypeCategoryMap::GetSyntheticChildren(FormattersMatchData &match_data) {
     }
   }
 
-  for (begin = m_active_categories.begin(); begin != end; begin++) {
+  category_index = 0;
+  for (begin = m_active_categories.begin(); begin != end;
+       begin++, category_index++) {
     lldb::TypeCategoryImplSP category_sp = *begin;
     lldb::SyntheticChildrenSP current_format;
     LLDB_LOGF(log,
@@ -284,6 +311,7 @@ TypeCategoryMap::GetSyntheticChildren(FormattersMatchData &match_data) {
       continue;
     return current_format;
   }
+  category_index = UINT32_MAX;
   LLDB_LOGF(log,
             "[CategoryMap::GetSyntheticChildren] nothing found - returning "
             "empty SP");
@@ -291,7 +319,8 @@ TypeCategoryMap::GetSyntheticChildren(FormattersMatchData &match_data) {
 }
 
 lldb::TypeValidatorImplSP
-TypeCategoryMap::GetValidator(FormattersMatchData &match_data) {
+TypeCategoryMap::GetValidator(FormattersMatchData &match_data,
+                              uint32_t &category_index) {
   std::lock_guard<std::recursive_mutex> guard(m_map_mutex);
 
   uint32_t reason_why;
@@ -313,7 +342,9 @@ TypeCategoryMap::GetValidator(FormattersMatchData &match_data) {
     }
   }
 
-  for (begin = m_active_categories.begin(); begin != end; begin++) {
+  category_index = 0;
+  for (begin = m_active_categories.begin(); begin != end;
+       begin++, category_index++) {
     lldb::TypeCategoryImplSP category_sp = *begin;
     lldb::TypeValidatorImplSP current_format;
     LLDB_LOGF(log, "[CategoryMap::GetValidator] Trying to use category %s",
@@ -324,6 +355,7 @@ TypeCategoryMap::GetValidator(FormattersMatchData &match_data) {
       continue;
     return current_format;
   }
+  category_index = UINT32_MAX;
   LLDB_LOGF(log,
             "[CategoryMap::GetValidator] nothing found - returning empty SP");
   return lldb::TypeValidatorImplSP();
@@ -95,6 +95,16 @@ std::string CXXSyntheticChildren::GetDescription() {
   return sstr.GetString();
 }
 
+std::vector<lldb::ValueObjectSP>
+SyntheticChildrenFrontEnd::GetChildrenAtIndexRange(size_t start,
+                                                   size_t count) {
+  std::vector<lldb::ValueObjectSP> children;
+  children.reserve(count);
+  for (size_t idx = start; idx < start + count; ++idx)
+    children.push_back(GetChildAtIndex(idx));
+  return children;
+}
+
 lldb::ValueObjectSP SyntheticChildrenFrontEnd::CreateValueObjectFromExpression(
     llvm::StringRef name, llvm::StringRef expression,
     const ExecutionContext &exe_ctx) {
@@ -691,8 +691,25 @@ void ValueObjectPrinter::PrintChildren(
   if (num_children) {
     bool any_children_printed = false;
 
+    // Synthetic front ends of big containers make a window of children much
+    // faster than one child at a time.
+    const size_t k_children_window = 256;
+    std::vector<ValueObjectSP> window;
+    size_t window_start = 0;
     for (size_t idx = 0; idx < num_children; ++idx) {
-      if (ValueObjectSP child_sp = GenerateChild(synth_m_valobj, idx)) {
+      ValueObjectSP child_sp;
+      if (m_options.m_pointer_as_array) {
+        child_sp = GenerateChild(synth_m_valobj, idx);
+      } else {
+        if (idx >= window_start + window.size()) {
+          window_start = idx;
+          window = synth_m_valobj->GetChildrenAtIndexRange(
+              idx, std::min(k_children_window, num_children - idx), true);
+        }
+        if (idx < window_start + window.size())
+          child_sp = window[idx - window_start];
+      }
+      if (child_sp) {
         if (!any_children_printed) {
           PrintChildrenPreamble();
           any_children_printed = true;
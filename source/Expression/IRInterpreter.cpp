@@ -21,13 +21,19 @@
 #include "lldb/Utility/Status.h"
 #include "lldb/Utility/StreamString.h"
 
+#include "lldb/Symbol/TypeSystem.h"
+
 #include "lldb/Target/ABI.h"
 #include "lldb/Target/ExecutionContext.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/ThreadPlan.h"
+#include "lldb/Target/ThreadPlanCallFunction.h"
 #include "lldb/Target/ThreadPlanCallFunctionUsingABI.h"
 
+#include "llvm/ADT/APSInt.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringSwitch.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Function.h"
@@ -38,6 +44,8 @@
 #include "llvm/IR/Operator.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <cmath>
+#include <limits>
 #include <map>
 
 using namespace llvm;
@@ -81,6 +89,8 @@ static bool CanIgnoreCall(const CallInst *call) {
       break;
     case llvm::Intrinsic::dbg_declare:
     case llvm::Intrinsic::dbg_value:
+    case llvm::Intrinsic::lifetime_start:
+    case llvm::Intrinsic::lifetime_end:
       return true;
     }
   }
@@ -175,40 +185,87 @@ public:
                                value->getType());
     } else {
       lldb::addr_t process_address = ResolveValue(value, module);
-      size_t value_size = m_target_data.getTypeStoreSize(value->getType());
 
-      lldb_private::DataExtractor value_extractor;
-      lldb_private::Status extract_error;
+      return ReadScalar(scalar, process_address, value->getType());
+    }
+  }
 
-      m_execution_unit.GetMemoryData(value_extractor, process_address,
-                                     value_size, extract_error);
+  /// Evaluate element \a index of the vector \a value.
+  bool EvaluateElement(lldb_private::Scalar &scalar, const Value *value,
+                       uint64_t index, Module &module) {
+    lldb::addr_t process_address = ResolveValue(value, module);
 
-      if (!extract_error.Success())
-        return false;
+    if (process_address == LLDB_INVALID_ADDRESS)
+      return false;
 
-      lldb::offset_t offset = 0;
-      if (value_size <= 8) {
-        uint64_t u64value = value_extractor.GetMaxU64(&offset, value_size);
-        return AssignToMatchType(scalar, u64value, value->getType());
-      }
-    }
+    Type *element_type = value->getType()->getVectorElementType();
 
-    return false;
+    if (index >= value->getType()->getVectorNumElements())
+      return false;
+
+    return ReadScalar(
+        scalar,
+        process_address + index * m_target_data.getTypeStoreSize(element_type),
+        element_type);
+  }
+
+  bool ReadScalar(lldb_private::Scalar &scalar, lldb::addr_t process_address,
+                  Type *type) {
+    size_t value_size = m_target_data.getTypeStoreSize(type);
+
+    if (process_address == LLDB_INVALID_ADDRESS || value_size > 8)
+      return false;
+
+    lldb_private::DataExtractor value_extractor;
+    lldb_private::Status extract_error;
+
+    m_execution_unit.GetMemoryData(value_extractor, process_address,
+                                   value_size, extract_error);
+
+    if (!extract_error.Success())
+      return false;
+
+    lldb::offset_t offset = 0;
+    uint64_t u64value = value_extractor.GetMaxU64(&offset, value_size);
+    return AssignToMatchType(scalar, u64value, type);
   }
 
   bool AssignValue(const Value *value, lldb_private::Scalar &scalar,
                    Module &module) {
     lldb::addr_t process_address = ResolveValue(value, module);
 
+    return WriteScalar(process_address, scalar, value->getType());
+  }
+
+  /// Assign element \a index of the vector \a value.
+  bool AssignElement(const Value *value, uint64_t index,
+                     lldb_private::Scalar &scalar, Module &module) {
+    lldb::addr_t process_address = ResolveValue(value, module);
+
+    if (process_address == LLDB_INVALID_ADDRESS)
+      return false;
+
+    Type *element_type = value->getType()->getVectorElementType();
+
+    if (index >= value->getType()->getVectorNumElements())
+      return false;
+
+    return WriteScalar(
+        process_address + index * m_target_data.getTypeStoreSize(element_type),
+        scalar, element_type);
+  }
+
+  bool WriteScalar(lldb::addr_t process_address, lldb_private::Scalar &scalar,
+                   Type *type) {
     if (process_address == LLDB_INVALID_ADDRESS)
       return false;
 
     lldb_private::Scalar cast_scalar;
 
-    if (!AssignToMatchType(cast_scalar, scalar.ULongLong(), value->getType()))
+    if (!AssignToMatchType(cast_scalar, scalar.ULongLong(), type))
       return false;
 
-    size_t value_byte_size = m_target_data.getTypeStoreSize(value->getType());
+    size_t value_byte_size = m_target_data.getTypeStoreSize(type);
 
     lldb_private::DataBufferHeap buf(value_byte_size, 0);
 
@@ -301,6 +358,10 @@ public:
         return true;
       }
       break;
+    case Value::UndefValueVal:
+      // Any value will do, pick zero so that results are reproducible.
+      value = APInt(m_target_data.getTypeSizeInBits(constant->getType()), 0);
+      return true;
     }
     return false;
   }
@@ -338,6 +399,23 @@ public:
   }
 
   bool ResolveConstant(lldb::addr_t process_address, const Constant *constant) {
+    Type *type = constant->getType();
+
+    if (type->isVectorTy()) {
+      Type *element_type = type->getVectorElementType();
+      size_t element_size = m_target_data.getTypeStoreSize(element_type);
+
+      for (unsigned i = 0, e = type->getVectorNumElements(); i != e; ++i) {
+        const Constant *element = constant->getAggregateElement(i);
+
+        if (!element || !ResolveConstant(process_address + i * element_size,
+                                         element))
+          return false;
+      }
+
+      return true;
+    }
+
     APInt resolved_value;
 
     if (!ResolveConstantValue(resolved_value, constant))
@@ -362,6 +440,48 @@ public:
     return write_error.Success();
   }
 
+  bool ReadValueData(std::vector<uint8_t> &data, const Value *value,
+                     Module &module) {
+    lldb::addr_t process_address = ResolveValue(value, module);
+
+    if (process_address == LLDB_INVALID_ADDRESS)
+      return false;
+
+    data.resize(m_target_data.getTypeStoreSize(value->getType()));
+
+    lldb_private::Status read_error;
+
+    m_execution_unit.ReadMemory(data.data(), process_address, data.size(),
+                                read_error);
+
+    return read_error.Success();
+  }
+
+  bool WriteValueData(const Value *value, const std::vector<uint8_t> &data,
+                      Module &module) {
+    lldb::addr_t process_address = ResolveValue(value, module);
+
+    if (process_address == LLDB_INVALID_ADDRESS ||
+        data.size() != m_target_data.getTypeStoreSize(value->getType()))
+      return false;
+
+    lldb_private::Status write_error;
+
+    m_execution_unit.WriteMemory(process_address, data.data(), data.size(),
+                                 write_error);
+
+    return write_error.Success();
+  }
+
+  /// Copy the bytes of \a source into \a dest, which works for values of
+  /// any type as long as both have the same store size.
+  bool CopyValue(const Value *dest, const Value *source, Module &module) {
+    std::vector<uint8_t> data;
+
+    return ReadValueData(data, source, module) &&
+           WriteValueData(dest, data, module);
+  }
+
   lldb::addr_t Malloc(size_t size, uint8_t byte_alignment) {
     lldb::addr_t ret = m_stack_pointer;
 
@@ -449,6 +569,315 @@ static const char *infinite_loop_error = "Interpreter ran for too many cycles";
 static const char *too_many_functions_error =
     "Interpreter doesn't handle modules with multiple function bodies.";
 
+static const uint64_t max_emulated_memory_size = 1024 * 1024;
+
+/// Calls the interpreter carries out on the host instead of in the process.
+enum EmulatedCall {
+  eEmulatedCallNone,
+  eEmulatedCallMemcpy,
+  eEmulatedCallMemset,
+  eEmulatedCallExpect,
+  eEmulatedCallBswap,
+  eEmulatedCallCtpop,
+  eEmulatedCallCtlz,
+  eEmulatedCallCttz,
+  eEmulatedCallFabs,
+  eEmulatedCallFloor,
+  eEmulatedCallCeil,
+  eEmulatedCallTrunc,
+  eEmulatedCallSqrt,
+  eEmulatedCallStrlen,
+  eEmulatedCallStrcmp,
+  eEmulatedCallStrncmp,
+  eEmulatedCallMemcmp,
+  eEmulatedCallAbs,
+};
+
+/// Check the types of a call against \a prototype, which holds the kind of
+/// the return value followed by the kind of each argument: 'p' for a pointer,
+/// 'i' for an integer and 'f' for a floating point value.
+static bool HasPrototype(const CallInst *call, llvm::StringRef prototype) {
+  if (call->getNumArgOperands() + 1 != prototype.size())
+    return false;
+
+  for (size_t i = 0; i < prototype.size(); ++i) {
+    Type *type = i ? call->getArgOperand(i - 1)->getType() : call->getType();
+    bool matches = false;
+    switch (prototype[i]) {
+    case 'p':
+      matches = type->isPointerTy();
+      break;
+    case 'i':
+      matches = type->isIntegerTy();
+      break;
+    case 'f':
+      matches = type->isFloatTy() || type->isDoubleTy();
+      break;
+    }
+    if (!matches)
+      return false;
+  }
+
+  return true;
+}
+
+static EmulatedCall GetEmulatedCall(const CallInst *call) {
+  const llvm::Function *called_function = dyn_cast<llvm::Function>(
+      call->getCalledValue()->stripPointerCasts());
+
+  if (!called_function)
+    return eEmulatedCallNone;
+
+  // The overloaded intrinsics are only emulated for scalars.
+  if (call->getType()->isVectorTy())
+    return eEmulatedCallNone;
+
+  if (called_function->isIntrinsic()) {
+    switch (called_function->getIntrinsicID()) {
+    default:
+      return eEmulatedCallNone;
+    case llvm::Intrinsic::memcpy:
+    case llvm::Intrinsic::memmove:
+      return eEmulatedCallMemcpy;
+    case llvm::Intrinsic::memset:
+      return eEmulatedCallMemset;
+    case llvm::Intrinsic::expect:
+      return eEmulatedCallExpect;
+    case llvm::Intrinsic::bswap:
+      return eEmulatedCallBswap;
+    case llvm::Intrinsic::ctpop:
+      return eEmulatedCallCtpop;
+    case llvm::Intrinsic::ctlz:
+      return eEmulatedCallCtlz;
+    case llvm::Intrinsic::cttz:
+      return eEmulatedCallCttz;
+    case llvm::Intrinsic::fabs:
+      return HasPrototype(call, "ff") ? eEmulatedCallFabs : eEmulatedCallNone;
+    case llvm::Intrinsic::floor:
+      return HasPrototype(call, "ff") ? eEmulatedCallFloor : eEmulatedCallNone;
+    case llvm::Intrinsic::ceil:
+      return HasPrototype(call, "ff") ? eEmulatedCallCeil : eEmulatedCallNone;
+    case llvm::Intrinsic::trunc:
+      return HasPrototype(call, "ff") ? eEmulatedCallTrunc : eEmulatedCallNone;
+    case llvm::Intrinsic::sqrt:
+      return HasPrototype(call, "ff") ? eEmulatedCallSqrt : eEmulatedCallNone;
+    }
+  }
+
+  // Functions of the C library that have no side effects besides writing the
+  // memory they are handed. The prototype is checked so that a function of
+  // the program which merely shares the name isn't mistaken for them.
+  struct HostFunction {
+    EmulatedCall kind;
+    const char *prototype;
+  };
+  HostFunction host_function =
+      llvm::StringSwitch<HostFunction>(called_function->getName())
+          .Cases("memcpy", "memmove", {eEmulatedCallMemcpy, "pppi"})
+          .Case("memset", {eEmulatedCallMemset, "ppii"})
+          .Case("strlen", {eEmulatedCallStrlen, "ip"})
+          .Case("strcmp", {eEmulatedCallStrcmp, "ipp"})
+          .Case("strncmp", {eEmulatedCallStrncmp, "ippi"})
+          .Case("memcmp", {eEmulatedCallMemcmp, "ippi"})
+          .Cases("abs", "labs", "llabs", {eEmulatedCallAbs, "ii"})
+          .Cases("fabs", "fabsf", {eEmulatedCallFabs, "ff"})
+          .Cases("floor", "floorf", {eEmulatedCallFloor, "ff"})
+          .Cases("ceil", "ceilf", {eEmulatedCallCeil, "ff"})
+          .Cases("trunc", "truncf", {eEmulatedCallTrunc, "ff"})
+          .Cases("sqrt", "sqrtf", {eEmulatedCallSqrt, "ff"})
+          .Default({eEmulatedCallNone, ""});
+
+  if (host_function.kind == eEmulatedCallNone ||
+      !HasPrototype(call, host_function.prototype))
+    return eEmulatedCallNone;
+
+  return host_function.kind;
+}
+
+static APFloat ScalarToAPFloat(const lldb_private::Scalar &scalar,
+                               Type *type) {
+  return APFloat(type->getFltSemantics(),
+                 APInt(type->getPrimitiveSizeInBits(), scalar.ULongLong()));
+}
+
+static lldb_private::Scalar APIntToScalar(const APInt &value) {
+  return lldb_private::Scalar(value.zextOrTrunc(64));
+}
+
+static bool CompareFloats(CmpInst::Predicate predicate, const APFloat &lhs,
+                          const APFloat &rhs) {
+  // The bits of a floating point predicate are set for each of the
+  // equal, greater, less and unordered outcomes that satisfy it.
+  unsigned outcome = 0;
+  switch (lhs.compare(rhs)) {
+  case APFloat::cmpEqual:
+    outcome = 1;
+    break;
+  case APFloat::cmpGreaterThan:
+    outcome = 2;
+    break;
+  case APFloat::cmpLessThan:
+    outcome = 4;
+    break;
+  case APFloat::cmpUnordered:
+    outcome = 8;
+    break;
+  }
+  return (predicate & outcome) != 0;
+}
+
+/// Compute a binary operator on scalars, which for vector operators are
+/// single elements of type \a type.
+static bool ComputeBinaryOperator(unsigned opcode, Type *type,
+                                  lldb_private::Scalar L,
+                                  lldb_private::Scalar R,
+                                  lldb_private::Scalar &result) {
+  if (type->isFloatingPointTy()) {
+    APFloat lhs = ScalarToAPFloat(L, type);
+    APFloat rhs = ScalarToAPFloat(R, type);
+
+    switch (opcode) {
+    default:
+      return false;
+    case Instruction::FAdd:
+      lhs.add(rhs, APFloat::rmNearestTiesToEven);
+      break;
+    case Instruction::FSub:
+      lhs.subtract(rhs, APFloat::rmNearestTiesToEven);
+      break;
+    case Instruction::FMul:
+      lhs.multiply(rhs, APFloat::rmNearestTiesToEven);
+      break;
+    case Instruction::FDiv:
+      lhs.divide(rhs, APFloat::rmNearestTiesToEven);
+      break;
+    case Instruction::FRem:
+      lhs.mod(rhs);
+      break;
+    }
+
+    result = APIntToScalar(lhs.bitcastToAPInt());
+    return true;
+  }
+
+  switch (opcode) {
+  default:
+    return false;
+  case Instruction::Add:
+    result = L + R;
+    break;
+  case Instruction::Mul:
+    result = L * R;
+    break;
+  case Instruction::Sub:
+    result = L - R;
+    break;
+  case Instruction::SDiv:
+    L.MakeSigned();
+    R.MakeSigned();
+    result = L / R;
+    break;
+  case Instruction::UDiv:
+    L.MakeUnsigned();
+    R.MakeUnsigned();
+    result = L / R;
+    break;
+  case Instruction::SRem:
+    L.MakeSigned();
+    R.MakeSigned();
+    result = L % R;
+    break;
+  case Instruction::URem:
+    L.MakeUnsigned();
+    R.MakeUnsigned();
+    result = L % R;
+    break;
+  case Instruction::Shl:
+    result = L << R;
+    break;
+  case Instruction::AShr:
+    result = L >> R;
+    break;
+  case Instruction::LShr:
+    result = L;
+    result.ShiftRightLogical(R);
+    break;
+  case Instruction::And:
+    result = L & R;
+    break;
+  case Instruction::Or:
+    result = L | R;
+    break;
+  case Instruction::Xor:
+    result = L ^ R;
+    break;
+  }
+
+  return true;
+}
+
+/// Check that the interpreter can handle an instruction that has vector
+/// operands or a vector result. Vectors are kept in memory, so only their
+/// elements need to be addressable bytes.
+static bool CanInterpretVectorInstruction(const Instruction &inst) {
+  SmallVector<Type *, 4> types;
+  types.push_back(inst.getType());
+  for (const Value *operand : inst.operand_values())
+    types.push_back(operand->getType());
+
+  bool has_vector = false;
+  for (Type *type : types) {
+    if (!type->isVectorTy())
+      continue;
+    has_vector = true;
+    Type *element_type = type->getVectorElementType();
+    if (!element_type->isIntegerTy() && !element_type->isPointerTy() &&
+        !element_type->isFloatTy() && !element_type->isDoubleTy())
+      return false;
+    unsigned element_bits = element_type->getScalarSizeInBits();
+    if (element_type->isIntegerTy() &&
+        (element_bits % 8 != 0 || element_bits > 64))
+      return false;
+  }
+
+  if (!has_vector)
+    return true;
+
+  if (inst.isBinaryOp())
+    return true;
+
+  switch (inst.getOpcode()) {
+  default:
+    return false;
+  case Instruction::BitCast:
+  case Instruction::ExtractElement:
+  case Instruction::InsertElement:
+  case Instruction::ShuffleVector:
+  case Instruction::Load:
+  case Instruction::Store:
+  case Instruction::PHI:
+    return true;
+  case Instruction::Select:
+    return !cast<SelectInst>(inst).getCondition()->getType()->isVectorTy();
+  }
+}
+
+/// Floating point values are computed with APFloat, only allow the types
+/// that fit the 64 bit scalars the interpreter passes them around in.
+static bool HasSupportedFloatTypes(const Instruction &inst) {
+  SmallVector<Type *, 4> types;
+  types.push_back(inst.getType()->getScalarType());
+  for (const Value *operand : inst.operand_values())
+    types.push_back(operand->getType()->getScalarType());
+
+  for (Type *type : types) {
+    if (type->isFloatingPointTy() && !type->isFloatTy() && !type->isDoubleTy())
+      return false;
+  }
+
+  return true;
+}
+
 static bool CanResolveConstant(llvm::Constant *constant) {
   switch (constant->getValueID()) {
   default:
@@ -456,6 +885,19 @@ static bool CanResolveConstant(llvm::Constant *constant) {
   case Value::ConstantIntVal:
   case Value::ConstantFPVal:
   case Value::FunctionVal:
+  case Value::UndefValueVal:
+    return true;
+  case Value::ConstantAggregateZeroVal:
+  case Value::ConstantDataVectorVal:
+  case Value::ConstantVectorVal:
+    if (!constant->getType()->isVectorTy())
+      return false;
+    for (unsigned i = 0, e = constant->getType()->getVectorNumElements();
+         i != e; ++i) {
+      Constant *element = constant->getAggregateElement(i);
+      if (!element || !CanResolveConstant(element))
+        return false;
+    }
     return true;
   case Value::ConstantExprVal:
     if (const ConstantExpr *constant_expr = dyn_cast<ConstantExpr>(constant)) {
@@ -530,7 +972,9 @@ bool IRInterpreter::CanInterpret(llvm::Module &module, llvm::Function &function,
           return false;
         }
 
-        if (!CanIgnoreCall(call_inst) && !support_function_calls) {
+        if (!CanIgnoreCall(call_inst) &&
+            GetEmulatedCall(call_inst) == eEmulatedCallNone &&
+            !support_function_calls) {
           LLDB_LOGF(log, "Unsupported instruction: %s",
                     PrintValue(&*ii).c_str());
           error.SetErrorToGenericError();
@@ -571,6 +1015,27 @@ bool IRInterpreter::CanInterpret(llvm::Module &module, llvm::Function &function,
           break;
         }
       } break;
+      case Instruction::FAdd:
+      case Instruction::FSub:
+      case Instruction::FMul:
+      case Instruction::FDiv:
+      case Instruction::FRem:
+      case Instruction::FNeg:
+      case Instruction::FCmp:
+      case Instruction::FPExt:
+      case Instruction::FPTrunc:
+      case Instruction::FPToSI:
+      case Instruction::FPToUI:
+      case Instruction::SIToFP:
+      case Instruction::UIToFP:
+        if (!HasSupportedFloatTypes(*ii)) {
+          LLDB_LOGF(log, "Unsupported floating point type: %s",
+                    PrintValue(&*ii).c_str());
+          error.SetErrorToGenericError();
+          error.SetErrorString(unsupported_operand_error);
+          return false;
+        }
+        break;
       case Instruction::And:
       case Instruction::AShr:
       case Instruction::IntToPtr:
@@ -581,39 +1046,43 @@ bool IRInterpreter::CanInterpret(llvm::Module &module, llvm::Function &function,
       case Instruction::Or:
       case Instruction::Ret:
       case Instruction::SDiv:
+      case Instruction::Select:
       case Instruction::SExt:
       case Instruction::Shl:
       case Instruction::SRem:
       case Instruction::Store:
       case Instruction::Sub:
+      case Instruction::Switch:
       case Instruction::Trunc:
       case Instruction::UDiv:
       case Instruction::URem:
       case Instruction::Xor:
       case Instruction::ZExt:
         break;
+      case Instruction::ExtractElement:
+      case Instruction::InsertElement:
+      case Instruction::ShuffleVector:
+        break;
+      }
+
+      if (!CanInterpretVectorInstruction(*ii)) {
+        LLDB_LOGF(log, "Unsupported vector instruction: %s",
+                  PrintValue(&*ii).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(unsupported_operand_error);
+        return false;
       }
 
       for (int oi = 0, oe = ii->getNumOperands(); oi != oe; ++oi) {
         Value *operand = ii->getOperand(oi);
         Type *operand_type = operand->getType();
 
-        switch (operand_type->getTypeID()) {
-        default:
-          break;
-        case Type::VectorTyID: {
-          LLDB_LOGF(log, "Unsupported operand type: %s",
-                    PrintType(operand_type).c_str());
-          error.SetErrorString(unsupported_operand_error);
-          return false;
-        }
-        }
-
         // The IR interpreter currently doesn't know about
         // 128-bit integers. As they're not that frequent,
         // we can just fall back to the JIT rather than
-        // choking.
-        if (operand_type->getPrimitiveSizeInBits() > 64) {
+        // choking. Vectors are checked element by element
+        // above.
+        if (operand_type->getScalarType()->getPrimitiveSizeInBits() > 64) {
           LLDB_LOGF(log, "Unsupported operand type: %s",
                     PrintType(operand_type).c_str());
           error.SetErrorString(unsupported_operand_error);
@@ -635,6 +1104,379 @@ bool IRInterpreter::CanInterpret(llvm::Module &module, llvm::Function &function,
   return true;
 }
 
+/// Read a NUL terminated string of at most \a max_length bytes. The string is
+/// read in pieces that don't extend past the end of an allocation of the
+/// interpreter or cross a page of the process.
+static bool ReadCString(lldb_private::IRExecutionUnit &execution_unit,
+                        lldb::addr_t address, size_t max_length,
+                        std::string &str) {
+  const size_t chunk_size = 256;
+
+  str.clear();
+  while (str.size() < max_length) {
+    size_t size = chunk_size - address % chunk_size;
+    size_t alloc_size = 0;
+    if (execution_unit.GetAllocSize(address, alloc_size)) {
+      if (alloc_size == 0)
+        return false;
+      size = std::min(size, alloc_size);
+    }
+    size = std::min(size, max_length - str.size());
+
+    char buf[chunk_size];
+    lldb_private::Status read_error;
+    execution_unit.ReadMemory(reinterpret_cast<uint8_t *>(buf), address, size,
+                              read_error);
+    if (!read_error.Success())
+      return false;
+
+    size_t length = strnlen(buf, size);
+    str.append(buf, length);
+    if (length < size)
+      return true;
+    address += size;
+  }
+
+  return true;
+}
+
+static int CompareBytes(llvm::StringRef lhs, llvm::StringRef rhs) {
+  int result = lhs.compare(rhs);
+  return result < 0 ? -1 : result > 0 ? 1 : 0;
+}
+
+/// Carry out a call the interpreter emulates on the host, see
+/// GetEmulatedCall(). \a declined is set if the call failed only because it
+/// handles more memory than the host emulates, the function of the process
+/// can still be called then.
+static bool InterpretEmulatedCall(EmulatedCall kind, const CallInst *call_inst,
+                                  InterpreterStackFrame &frame,
+                                  lldb_private::IRExecutionUnit &execution_unit,
+                                  Module &module, bool &declined,
+                                  lldb_private::Status &error) {
+  lldb_private::Log *log(
+      lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_EXPRESSIONS));
+
+  declined = false;
+  SmallVector<lldb_private::Scalar, 4> args(call_inst->getNumArgOperands());
+
+  for (unsigned i = 0, e = args.size(); i != e; ++i) {
+    if (!frame.EvaluateValue(args[i], call_inst->getArgOperand(i), module)) {
+      LLDB_LOGF(log, "Couldn't evaluate %s",
+                PrintValue(call_inst->getArgOperand(i)).c_str());
+      error.SetErrorToGenericError();
+      error.SetErrorString(bad_value_error);
+      return false;
+    }
+  }
+
+  Type *type = call_inst->getType();
+  lldb_private::Scalar result;
+
+  switch (kind) {
+  case eEmulatedCallNone:
+    error.SetErrorToGenericError();
+    error.SetErrorString(interpreter_internal_error);
+    return false;
+  case eEmulatedCallMemcpy:
+  case eEmulatedCallMemset: {
+    lldb::addr_t dest = args[0].ULongLong();
+    uint64_t size = args[2].ULongLong();
+
+    if (size > max_emulated_memory_size) {
+      LLDB_LOGF(log, "%s of 0x%" PRIx64 " bytes is too large to emulate",
+                kind == eEmulatedCallMemcpy ? "memcpy" : "memset", size);
+      declined = true;
+      error.SetErrorToGenericError();
+      error.SetErrorString(memory_write_error);
+      return false;
+    }
+
+    if (size != 0) {
+      lldb_private::DataBufferHeap buffer(size, 0);
+      lldb_private::Status memory_error;
+
+      // Reading all of the source first makes this correct for memmove too.
+      if (kind == eEmulatedCallMemcpy)
+        execution_unit.ReadMemory(buffer.GetBytes(), args[1].ULongLong(),
+                                  size, memory_error);
+      else
+        memset(buffer.GetBytes(), args[1].UInt(), size);
+
+      if (!memory_error.Success()) {
+        error.SetErrorToGenericError();
+        error.SetErrorString(memory_read_error);
+        return false;
+      }
+
+      execution_unit.WriteMemory(dest, buffer.GetBytes(), size, memory_error);
+
+      if (!memory_error.Success()) {
+        error.SetErrorToGenericError();
+        error.SetErrorString(memory_write_error);
+        return false;
+      }
+    }
+
+    // The library functions return the destination, the intrinsics nothing.
+    result = args[0];
+  } break;
+  case eEmulatedCallExpect:
+    result = args[0];
+    break;
+  case eEmulatedCallBswap:
+  case eEmulatedCallCtpop:
+  case eEmulatedCallCtlz:
+  case eEmulatedCallCttz: {
+    unsigned bit_width = type->getIntegerBitWidth();
+    APInt value(bit_width, args[0].ULongLong());
+
+    if (kind == eEmulatedCallBswap) {
+      if (bit_width % 16 != 0) {
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+      result = APIntToScalar(value.byteSwap());
+    } else if (kind == eEmulatedCallCtpop) {
+      result = APIntToScalar(APInt(bit_width, value.countPopulation()));
+    } else if (kind == eEmulatedCallCtlz) {
+      result = APIntToScalar(APInt(bit_width, value.countLeadingZeros()));
+    } else {
+      result = APIntToScalar(APInt(bit_width, value.countTrailingZeros()));
+    }
+  } break;
+  case eEmulatedCallFabs:
+  case eEmulatedCallFloor:
+  case eEmulatedCallCeil:
+  case eEmulatedCallTrunc:
+  case eEmulatedCallSqrt: {
+    APFloat value = ScalarToAPFloat(args[0], type);
+
+    switch (kind) {
+    default:
+      break;
+    case eEmulatedCallFabs:
+      value.clearSign();
+      break;
+    case eEmulatedCallFloor:
+      value.roundToIntegral(APFloat::rmTowardNegative);
+      break;
+    case eEmulatedCallCeil:
+      value.roundToIntegral(APFloat::rmTowardPositive);
+      break;
+    case eEmulatedCallTrunc:
+      value.roundToIntegral(APFloat::rmTowardZero);
+      break;
+    case eEmulatedCallSqrt:
+      // APFloat has no square root, the host computes it the same way the
+      // process would for IEEE types.
+      if (type->isFloatTy())
+        value = APFloat(std::sqrt(value.convertToFloat()));
+      else
+        value = APFloat(std::sqrt(value.convertToDouble()));
+      break;
+    }
+
+    result = APIntToScalar(value.bitcastToAPInt());
+  } break;
+  case eEmulatedCallStrlen: {
+    std::string str;
+
+    if (!ReadCString(execution_unit, args[0].ULongLong(),
+                     max_emulated_memory_size, str) ||
+        str.size() == max_emulated_memory_size) {
+      declined = str.size() == max_emulated_memory_size;
+      error.SetErrorToGenericError();
+      error.SetErrorString(memory_read_error);
+      return false;
+    }
+
+    result = APIntToScalar(APInt(64, str.size()));
+  } break;
+  case eEmulatedCallStrcmp:
+  case eEmulatedCallStrncmp: {
+    uint64_t length_limit = kind == eEmulatedCallStrncmp
+                                ? args[2].ULongLong()
+                                : std::numeric_limits<uint64_t>::max();
+    uint64_t max_length =
+        std::min<uint64_t>(length_limit, max_emulated_memory_size);
+
+    std::string lhs;
+    std::string rhs;
+
+    // A string that is cut off before the comparison would have stopped
+    // can't be compared.
+    if (!ReadCString(execution_unit, args[0].ULongLong(), max_length, lhs) ||
+        !ReadCString(execution_unit, args[1].ULongLong(), max_length, rhs)) {
+      error.SetErrorToGenericError();
+      error.SetErrorString(memory_read_error);
+      return false;
+    }
+    if (length_limit > max_length &&
+        (lhs.size() == max_length || rhs.size() == max_length)) {
+      declined = true;
+      error.SetErrorToGenericError();
+      error.SetErrorString(memory_read_error);
+      return false;
+    }
+
+    result = CompareBytes(lhs, rhs);
+  } break;
+  case eEmulatedCallMemcmp: {
+    uint64_t size = args[2].ULongLong();
+
+    if (size > max_emulated_memory_size) {
+      declined = true;
+      error.SetErrorToGenericError();
+      error.SetErrorString(memory_read_error);
+      return false;
+    }
+
+    std::vector<uint8_t> lhs(size);
+    std::vector<uint8_t> rhs(size);
+    lldb_private::Status read_error;
+
+    if (size != 0) {
+      execution_unit.ReadMemory(lhs.data(), args[0].ULongLong(), size,
+                                read_error);
+      if (read_error.Success())
+        execution_unit.ReadMemory(rhs.data(), args[1].ULongLong(), size,
+                                  read_error);
+    }
+
+    if (!read_error.Success()) {
+      error.SetErrorToGenericError();
+      error.SetErrorString(memory_read_error);
+      return false;
+    }
+
+    result = CompareBytes(llvm::toStringRef(lhs), llvm::toStringRef(rhs));
+  } break;
+  case eEmulatedCallAbs: {
+    args[0].MakeSigned();
+    int64_t value = args[0].SLongLong();
+    result = APIntToScalar(
+        APInt(64, value < 0 ? 0 - static_cast<uint64_t>(value) : value));
+  } break;
+  }
+
+  if (!type->isVoidTy() && !frame.AssignValue(call_inst, result, module)) {
+    error.SetErrorToGenericError();
+    error.SetErrorString(bad_value_error);
+    return false;
+  }
+
+  LLDB_LOGF(log, "Emulated %s on the host", PrintValue(call_inst).c_str());
+
+  return true;
+}
+
+/// Call the function of the process that a library call the host declined to
+/// emulate refers to. The arguments are integers and pointers into the
+/// process, so they can be passed as they are.
+static bool CallLibraryFunction(const CallInst *call_inst,
+                                InterpreterStackFrame &frame,
+                                lldb_private::IRExecutionUnit &execution_unit,
+                                Module &module,
+                                lldb_private::ExecutionContext &exe_ctx,
+                                lldb_private::Status &error) {
+  lldb_private::Log *log(
+      lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_EXPRESSIONS));
+
+  lldb_private::Thread *thread = exe_ctx.GetThreadPtr();
+  if (!thread || !exe_ctx.GetProcessPtr()) {
+    error.SetErrorToGenericError();
+    error.SetErrorString("unable to call the function without a thread");
+    return false;
+  }
+
+  lldb_private::Scalar function_address;
+  if (!frame.EvaluateValue(function_address, call_inst->getCalledValue(),
+                           module)) {
+    error.SetErrorToGenericError();
+    error.SetErrorString("unable to get address of function");
+    return false;
+  }
+
+  std::vector<lldb::addr_t> args;
+  for (unsigned i = 0, e = call_inst->getNumArgOperands(); i != e; ++i) {
+    const llvm::Value *arg = call_inst->getArgOperand(i);
+    lldb_private::Scalar value;
+    if (!frame.EvaluateValue(value, arg, module)) {
+      error.SetErrorToGenericError();
+      error.SetErrorStringWithFormat("unable to evaluate argument %u", i);
+      return false;
+    }
+
+    // The memory of the interpreter only exists on the host.
+    size_t alloc_size = 0;
+    if (arg->getType()->isPointerTy() &&
+        execution_unit.GetAllocSize(value.ULongLong(), alloc_size)) {
+      error.SetErrorToGenericError();
+      error.SetErrorStringWithFormat(
+          "argument %u points to memory the process can't access", i);
+      return false;
+    }
+    args.push_back(value.ULongLong());
+  }
+
+  auto type_system_or_err =
+      exe_ctx.GetTargetRef().GetScratchTypeSystemForLanguage(
+          lldb::eLanguageTypeC);
+  if (!type_system_or_err) {
+    error.SetErrorToGenericError();
+    error.SetErrorString(llvm::toString(type_system_or_err.takeError()));
+    return false;
+  }
+  Type *type = call_inst->getType();
+  lldb_private::CompilerType return_type =
+      type->isPointerTy()
+          ? type_system_or_err->GetBasicTypeFromAST(lldb::eBasicTypeVoid)
+                .GetPointerType()
+          : type_system_or_err->GetBuiltinTypeForEncodingAndBitSize(
+                lldb::eEncodingSint, type->getIntegerBitWidth());
+
+  lldb_private::EvaluateExpressionOptions options;
+  options.SetUnwindOnError(true);
+  options.SetIgnoreBreakpoints(true);
+  lldb::ThreadPlanSP call_plan_sp(new lldb_private::ThreadPlanCallFunction(
+      *thread, lldb_private::Address(function_address.ULongLong()),
+      return_type, args, options));
+
+  lldb_private::StreamString ss;
+  if (!call_plan_sp->ValidatePlan(&ss)) {
+    error.SetErrorToGenericError();
+    error.SetErrorStringWithFormat("unable to call the function: %s",
+                                   ss.GetData());
+    return false;
+  }
+
+  lldb_private::DiagnosticManager diagnostics;
+  exe_ctx.GetProcessPtr()->SetRunningUserExpression(true);
+  lldb::ExpressionResults res = exe_ctx.GetProcessRef().RunThreadPlan(
+      exe_ctx, call_plan_sp, options, diagnostics);
+  exe_ctx.GetProcessPtr()->SetRunningUserExpression(false);
+
+  lldb::ValueObjectSP return_valobj_sp = call_plan_sp->GetReturnValueObject();
+  if (res != lldb::eExpressionCompleted || !return_valobj_sp) {
+    error.SetErrorToGenericError();
+    error.SetErrorString("calling the function in the process failed");
+    return false;
+  }
+
+  if (!frame.AssignValue(call_inst, return_valobj_sp->GetValue().GetScalar(),
+                         module)) {
+    error.SetErrorToGenericError();
+    error.SetErrorString(bad_value_error);
+    return false;
+  }
+
+  LLDB_LOGF(log, "Called %s in the process", PrintValue(call_inst).c_str());
+
+  return true;
+}
+
 bool IRInterpreter::Interpret(llvm::Module &module, llvm::Function &function,
                               llvm::ArrayRef<lldb::addr_t> args,
                               lldb_private::IRExecutionUnit &execution_unit,
@@ -706,7 +1548,12 @@ bool IRInterpreter::Interpret(llvm::Module &module, llvm::Function &function,
     case Instruction::AShr:
     case Instruction::And:
     case Instruction::Or:
-    case Instruction::Xor: {
+    case Instruction::Xor:
+    case Instruction::FAdd:
+    case Instruction::FSub:
+    case Instruction::FMul:
+    case Instruction::FDiv:
+    case Instruction::FRem: {
       const BinaryOperator *bin_op = dyn_cast<BinaryOperator>(inst);
 
       if (!bin_op) {
@@ -725,6 +1572,31 @@ bool IRInterpreter::Interpret(llvm::Module &module, llvm::Function &function,
       lldb_private::Scalar L;
       lldb_private::Scalar R;
 
+      if (inst->getType()->isVectorTy()) {
+        // Vectors are computed one element at a time.
+        Type *element_type = inst->getType()->getVectorElementType();
+
+        for (unsigned i = 0, e = inst->getType()->getVectorNumElements();
+             i != e; ++i) {
+          lldb_private::Scalar result;
+
+          if (!frame.EvaluateElement(L, lhs, i, module) ||
+              !frame.EvaluateElement(R, rhs, i, module) ||
+              !ComputeBinaryOperator(inst->getOpcode(), element_type, L, R,
+                                     result) ||
+              !frame.AssignElement(inst, i, result, module)) {
+            LLDB_LOGF(log, "Couldn't compute element %u of %s", i,
+                      PrintValue(inst).c_str());
+            error.SetErrorToGenericError();
+            error.SetErrorString(bad_value_error);
+            return false;
+          }
+        }
+
+        LLDB_LOGF(log, "Interpreted a vector %s", inst->getOpcodeName());
+        break;
+      }
+
       if (!frame.EvaluateValue(L, lhs, module)) {
         LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(lhs).c_str());
         error.SetErrorToGenericError();
@@ -741,58 +1613,7 @@ bool IRInterpreter::Interpret(llvm::Module &module, llvm::Function &function,
 
       lldb_private::Scalar result;
 
-      switch (inst->getOpcode()) {
-      default:
-        break;
-      case Instruction::Add:
-        result = L + R;
-        break;
-      case Instruction::Mul:
-        result = L * R;
-        break;
-      case Instruction::Sub:
-        result = L - R;
-        break;
-      case Instruction::SDiv:
-        L.MakeSigned();
-        R.MakeSigned();
-        result = L / R;
-        break;
-      case Instruction::UDiv:
-        L.MakeUnsigned();
-        R.MakeUnsigned();
-        result = L / R;
-        break;
-      case Instruction::SRem:
-        L.MakeSigned();
-        R.MakeSigned();
-        result = L % R;
-        break;
-      case Instruction::URem:
-        L.MakeUnsigned();
-        R.MakeUnsigned();
-        result = L % R;
-        break;
-      case Instruction::Shl:
-        result = L << R;
-        break;
-      case Instruction::AShr:
-        result = L >> R;
-        break;
-      case Instruction::LShr:
-        result = L;
-        result.ShiftRightLogical(R);
-        break;
-      case Instruction::And:
-        result = L & R;
-        break;
-      case Instruction::Or:
-        result = L | R;
-        break;
-      case Instruction::Xor:
-        result = L ^ R;
-        break;
-      }
+      ComputeBinaryOperator(inst->getOpcode(), inst->getType(), L, R, result);
 
       frame.AssignValue(inst, result, module);
 
@@ -873,7 +1694,18 @@ bool IRInterpreter::Interpret(llvm::Module &module, llvm::Function &function,
         LLDB_LOGF(log, "  P : 0x%" PRIx64, P);
       }
     } break;
-    case Instruction::BitCast:
+    case Instruction::BitCast: {
+      // A bitcast keeps the bits of its operand, which also covers vectors
+      // and floating point values.
+      Value *source = inst->getOperand(0);
+
+      if (!frame.CopyValue(inst, source, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(source).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+    } break;
     case Instruction::ZExt: {
       const CastInst *cast_inst = dyn_cast<CastInst>(inst);
 
@@ -928,6 +1760,83 @@ bool IRInterpreter::Interpret(llvm::Module &module, llvm::Function &function,
 
       frame.AssignValue(inst, S_signextend, module);
     } break;
+    case Instruction::FPExt:
+    case Instruction::FPTrunc:
+    case Instruction::FPToSI:
+    case Instruction::FPToUI:
+    case Instruction::SIToFP:
+    case Instruction::UIToFP: {
+      Value *source = inst->getOperand(0);
+      Type *source_ty = source->getType();
+      Type *dest_ty = inst->getType();
+
+      lldb_private::Scalar S;
+
+      if (!frame.EvaluateValue(S, source, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(source).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      lldb_private::Scalar result;
+      bool loses_info = false;
+
+      switch (inst->getOpcode()) {
+      default:
+        break;
+      case Instruction::FPExt:
+      case Instruction::FPTrunc: {
+        APFloat value = ScalarToAPFloat(S, source_ty);
+        value.convert(dest_ty->getFltSemantics(), APFloat::rmNearestTiesToEven,
+                      &loses_info);
+        result = APIntToScalar(value.bitcastToAPInt());
+      } break;
+      case Instruction::FPToSI:
+      case Instruction::FPToUI: {
+        APSInt value(dest_ty->getIntegerBitWidth(),
+                     inst->getOpcode() == Instruction::FPToUI);
+        ScalarToAPFloat(S, source_ty)
+            .convertToInteger(value, APFloat::rmTowardZero, &loses_info);
+        result = APIntToScalar(value);
+      } break;
+      case Instruction::SIToFP:
+      case Instruction::UIToFP: {
+        APFloat value(dest_ty->getFltSemantics());
+        value.convertFromAPInt(
+            APInt(source_ty->getIntegerBitWidth(), S.ULongLong()),
+            inst->getOpcode() == Instruction::SIToFP,
+            APFloat::rmNearestTiesToEven);
+        result = APIntToScalar(value.bitcastToAPInt());
+      } break;
+      }
+
+      frame.AssignValue(inst, result, module);
+
+      if (log) {
+        LLDB_LOGF(log, "Interpreted a %s", inst->getOpcodeName());
+        LLDB_LOGF(log, "  Src : %s", frame.SummarizeValue(source).c_str());
+        LLDB_LOGF(log, "  =   : %s", frame.SummarizeValue(inst).c_str());
+      }
+    } break;
+    case Instruction::FNeg: {
+      Value *source = inst->getOperand(0);
+
+      lldb_private::Scalar S;
+
+      if (!frame.EvaluateValue(S, source, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(source).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      APFloat value = ScalarToAPFloat(S, inst->getType());
+      value.changeSign();
+      lldb_private::Scalar result = APIntToScalar(value.bitcastToAPInt());
+
+      frame.AssignValue(inst, result, module);
+    } break;
     case Instruction::Br: {
       const BranchInst *br_inst = dyn_cast<BranchInst>(inst);
 
@@ -989,22 +1898,110 @@ bool IRInterpreter::Interpret(llvm::Module &module, llvm::Function &function,
         return false;
       }
 
-      Value *value = phi_inst->getIncomingValueForBlock(frame.m_prev_bb);
-      lldb_private::Scalar result;
-      if (!frame.EvaluateValue(result, value, module)) {
+      // The PHI nodes at the start of a block all take their incoming value
+      // at once, so read every incoming value before assigning any of them.
+      // Otherwise a PHI that uses another PHI of the same block, as loops
+      // that rotate values do, would see the value of this iteration.
+      std::vector<std::pair<const PHINode *, std::vector<uint8_t>>> incoming;
+
+      for (; frame.m_ii != frame.m_ie && isa<PHINode>(*frame.m_ii);
+           ++frame.m_ii) {
+        phi_inst = cast<PHINode>(&*frame.m_ii);
+        Value *value = phi_inst->getIncomingValueForBlock(frame.m_prev_bb);
+        std::vector<uint8_t> data;
+
+        if (!value || !frame.ReadValueData(data, value, module)) {
+          LLDB_LOGF(log, "Couldn't evaluate the incoming value of %s",
+                    PrintValue(phi_inst).c_str());
+          error.SetErrorToGenericError();
+          error.SetErrorString(bad_value_error);
+          return false;
+        }
+
+        if (log) {
+          LLDB_LOGF(log, "Interpreted a %s", phi_inst->getOpcodeName());
+          LLDB_LOGF(log, "  Incoming value : %s",
+                    frame.SummarizeValue(value).c_str());
+        }
+
+        incoming.emplace_back(phi_inst, std::move(data));
+      }
+
+      for (auto &phi_and_data : incoming) {
+        if (!frame.WriteValueData(phi_and_data.first, phi_and_data.second,
+                                  module)) {
+          LLDB_LOGF(log, "Couldn't assign %s",
+                    PrintValue(phi_and_data.first).c_str());
+          error.SetErrorToGenericError();
+          error.SetErrorString(bad_value_error);
+          return false;
+        }
+      }
+    }
+      continue;
+    case Instruction::Select: {
+      const SelectInst *select_inst = cast<SelectInst>(inst);
+
+      const Value *condition = select_inst->getCondition();
+
+      lldb_private::Scalar C;
+
+      if (!frame.EvaluateValue(C, condition, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(condition).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      const Value *value = C.IsZero() ? select_inst->getFalseValue()
+                                      : select_inst->getTrueValue();
+
+      if (!frame.CopyValue(inst, value, module)) {
         LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(value).c_str());
         error.SetErrorToGenericError();
         error.SetErrorString(bad_value_error);
         return false;
       }
-      frame.AssignValue(inst, result, module);
 
       if (log) {
-        LLDB_LOGF(log, "Interpreted a %s", inst->getOpcodeName());
-        LLDB_LOGF(log, "  Incoming value : %s",
-                  frame.SummarizeValue(value).c_str());
+        LLDB_LOGF(log, "Interpreted a SelectInst");
+        LLDB_LOGF(log, "  cond : %s", frame.SummarizeValue(condition).c_str());
+        LLDB_LOGF(log, "  =    : %s", frame.SummarizeValue(inst).c_str());
       }
     } break;
+    case Instruction::Switch: {
+      const SwitchInst *switch_inst = cast<SwitchInst>(inst);
+
+      Value *condition = switch_inst->getCondition();
+
+      lldb_private::Scalar C;
+
+      if (!frame.EvaluateValue(C, condition, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(condition).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      APInt condition_value(condition->getType()->getIntegerBitWidth(),
+                            C.ULongLong());
+      const BasicBlock *destination = switch_inst->getDefaultDest();
+
+      for (auto switch_case : switch_inst->cases()) {
+        if (switch_case.getCaseValue()->getValue() == condition_value) {
+          destination = switch_case.getCaseSuccessor();
+          break;
+        }
+      }
+
+      frame.Jump(destination);
+
+      if (log) {
+        LLDB_LOGF(log, "Interpreted a SwitchInst");
+        LLDB_LOGF(log, "  cond : %s", frame.SummarizeValue(condition).c_str());
+      }
+    }
+      continue;
     case Instruction::GetElementPtr: {
       const GetElementPtrInst *gep_inst = dyn_cast<GetElementPtrInst>(inst);
 
@@ -1171,6 +2168,108 @@ bool IRInterpreter::Interpret(llvm::Module &module, llvm::Function &function,
         LLDB_LOGF(log, "  = : %s", frame.SummarizeValue(inst).c_str());
       }
     } break;
+    case Instruction::FCmp: {
+      const FCmpInst *fcmp_inst = cast<FCmpInst>(inst);
+
+      Value *lhs = inst->getOperand(0);
+      Value *rhs = inst->getOperand(1);
+
+      lldb_private::Scalar L;
+      lldb_private::Scalar R;
+
+      if (!frame.EvaluateValue(L, lhs, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(lhs).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      if (!frame.EvaluateValue(R, rhs, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(rhs).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      lldb_private::Scalar result =
+          CompareFloats(fcmp_inst->getPredicate(),
+                        ScalarToAPFloat(L, lhs->getType()),
+                        ScalarToAPFloat(R, rhs->getType()));
+
+      frame.AssignValue(inst, result, module);
+
+      if (log) {
+        LLDB_LOGF(log, "Interpreted an FCmpInst");
+        LLDB_LOGF(log, "  L : %s", frame.SummarizeValue(lhs).c_str());
+        LLDB_LOGF(log, "  R : %s", frame.SummarizeValue(rhs).c_str());
+        LLDB_LOGF(log, "  = : %s", frame.SummarizeValue(inst).c_str());
+      }
+    } break;
+    case Instruction::ExtractElement: {
+      const ExtractElementInst *extract_inst = cast<ExtractElementInst>(inst);
+
+      const Value *vector = extract_inst->getVectorOperand();
+      const Value *index = extract_inst->getIndexOperand();
+
+      lldb_private::Scalar I;
+      lldb_private::Scalar E;
+
+      if (!frame.EvaluateValue(I, index, module) ||
+          !frame.EvaluateElement(E, vector, I.ULongLong(), module) ||
+          !frame.AssignValue(inst, E, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(inst).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+    } break;
+    case Instruction::InsertElement: {
+      Value *vector = inst->getOperand(0);
+      Value *element = inst->getOperand(1);
+      Value *index = inst->getOperand(2);
+
+      lldb_private::Scalar E;
+      lldb_private::Scalar I;
+
+      if (!frame.CopyValue(inst, vector, module) ||
+          !frame.EvaluateValue(E, element, module) ||
+          !frame.EvaluateValue(I, index, module) ||
+          !frame.AssignElement(inst, I.ULongLong(), E, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(inst).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+    } break;
+    case Instruction::ShuffleVector: {
+      const ShuffleVectorInst *shuffle_inst = cast<ShuffleVectorInst>(inst);
+
+      Value *lhs = shuffle_inst->getOperand(0);
+      Value *rhs = shuffle_inst->getOperand(1);
+      unsigned lhs_size = lhs->getType()->getVectorNumElements();
+
+      SmallVector<int, 16> mask;
+      shuffle_inst->getShuffleMask(mask);
+
+      for (unsigned i = 0, e = mask.size(); i != e; ++i) {
+        lldb_private::Scalar E;
+
+        // Undefined elements of the mask pick the first element.
+        unsigned source = mask[i] < 0 ? 0 : mask[i];
+        bool evaluated =
+            source < lhs_size
+                ? frame.EvaluateElement(E, lhs, source, module)
+                : frame.EvaluateElement(E, rhs, source - lhs_size, module);
+
+        if (!evaluated || !frame.AssignElement(inst, i, E, module)) {
+          LLDB_LOGF(log, "Couldn't compute element %u of %s", i,
+                    PrintValue(inst).c_str());
+          error.SetErrorToGenericError();
+          error.SetErrorString(bad_value_error);
+          return false;
+        }
+      }
+    } break;
     case Instruction::IntToPtr: {
       const IntToPtrInst *int_to_ptr_inst = dyn_cast<IntToPtrInst>(inst);
 
@@ -1454,6 +2553,28 @@ bool IRInterpreter::Interpret(llvm::Module &module, llvm::Function &function,
       if (CanIgnoreCall(call_inst))
         break;
 
+      EmulatedCall emulated_call = GetEmulatedCall(call_inst);
+      if (emulated_call != eEmulatedCallNone) {
+        bool declined = false;
+        if (InterpretEmulatedCall(emulated_call, call_inst, frame,
+                                  execution_unit, module, declined, error))
+          break;
+
+        // Intrinsics have no function in the process to fall back to.
+        const llvm::Function *called_function =
+            call_inst->getCalledFunction();
+        if (!declined || !called_function || called_function->isIntrinsic())
+          return false;
+
+        LLDB_LOGF(log, "Too much memory to emulate %s, calling it instead",
+                  PrintValue(call_inst).c_str());
+        error.Clear();
+        if (!CallLibraryFunction(call_inst, frame, execution_unit, module,
+                                 exe_ctx, error))
+          return false;
+        break;
+      }
+
       // Get the return type
       llvm::Type *returnType = call_inst->getType();
       if (returnType == nullptr) {
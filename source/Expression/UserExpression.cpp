@@ -35,6 +35,7 @@
 #include "lldb/Symbol/TypeSystem.h"
 #include "lldb/Symbol/VariableList.h"
 #include "lldb/Target/ExecutionContext.h"
+#include "lldb/Target/Language.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Target.h"
@@ -44,6 +45,8 @@
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/StreamString.h"
 
+#include "llvm/Support/raw_ostream.h"
+
 using namespace lldb_private;
 
 UserExpression::UserExpression(ExecutionContextScope &exe_scope,
@@ -62,8 +65,10 @@ void UserExpression::InstallContext(ExecutionContext &exe_ctx) {
 
   lldb::StackFrameSP frame_sp = exe_ctx.GetFrameSP();
 
-  if (frame_sp)
+  if (frame_sp) {
     m_address = frame_sp->GetFrameCodeAddress();
+    m_block = frame_sp->GetSymbolContext(lldb::eSymbolContextBlock).block;
+  }
 }
 
 bool UserExpression::LockAndCheckContext(ExecutionContext &exe_ctx,
@@ -83,15 +88,63 @@ bool UserExpression::LockAndCheckContext(ExecutionContext &exe_ctx,
   if (m_address.IsValid()) {
     if (!frame_sp)
       return false;
-    else
-      return (0 == Address::CompareLoadAddress(m_address,
-                                               frame_sp->GetFrameCodeAddress(),
-                                               target_sp.get()));
+    const Address &frame_address = frame_sp->GetFrameCodeAddress();
+    if (0 == Address::CompareLoadAddress(m_address, frame_address,
+                                         target_sp.get()))
+      return true;
+    // The block pointer is only compared, make sure it still belongs to a
+    // loaded module.
+    return m_block && m_address.GetModule() &&
+           m_address.GetModule() == frame_address.GetModule() &&
+           frame_sp->GetSymbolContext(lldb::eSymbolContextBlock).block ==
+               m_block;
   }
 
   return true;
 }
 
+// Get the key under which the prepared expression is cached in the target,
+// or an empty string if the expression can't be reused.
+static std::string GetExpressionCacheKey(
+    ExecutionContext &exe_ctx, const EvaluateExpressionOptions &options,
+    llvm::StringRef expr, llvm::StringRef prefix, lldb::LanguageType language,
+    UserExpression::ResultType desired_type, ExecutionPolicy execution_policy,
+    ValueObject *ctx_obj) {
+  Target *target = exe_ctx.GetTargetPtr();
+  if (!target || target->GetExpressionCacheSize() == 0)
+    return std::string();
+
+  // Only Clang expressions support being executed again. Top level code and
+  // persistent declarations only make sense once, and an expression that can
+  // be left on the stack must not be run again while it is still active.
+  if (!Language::LanguageIsCFamily(language) || ctx_obj ||
+      execution_policy == eExecutionPolicyTopLevel ||
+      options.GetREPLEnabled() || options.GetPlaygroundTransformEnabled() ||
+      !options.DoesIgnoreBreakpoints() || !options.DoesUnwindOnError() ||
+      expr.contains('$'))
+    return std::string();
+
+  std::string key;
+  llvm::raw_string_ostream stream(key);
+  stream << language << ' ' << desired_type << ' ' << execution_policy << ' '
+         << options.GetGenerateDebugInfo() << options.GetAutoApplyFixIts()
+         << options.DoesKeepInMemory() << ' ';
+  // Expressions are reused within the innermost block they were parsed in,
+  // which determines the variables that are visible and their types.
+  if (StackFrame *frame = exe_ctx.GetFramePtr()) {
+    const SymbolContext &sc =
+        frame->GetSymbolContext(lldb::eSymbolContextBlock);
+    if (sc.block)
+      stream << "block " << sc.block;
+    else
+      stream << "pc " << frame->GetFrameCodeAddress().GetLoadAddress(target);
+  } else {
+    stream << "no frame";
+  }
+  stream << ' ' << prefix.size() << ' ' << prefix << expr;
+  return stream.str();
+}
+
 bool UserExpression::MatchesContext(ExecutionContext &exe_ctx) {
   lldb::TargetSP target_sp;
   lldb::ProcessSP process_sp;
@@ -229,20 +282,38 @@ lldb::ExpressionResults UserExpression::Evaluate(
       language = frame->GetLanguage();
   }
 
-  lldb::UserExpressionSP user_expression_sp(
-      target->GetUserExpressionForLanguage(exe_ctx, expr, full_prefix, language,
-                                           desired_type, options, ctx_obj,
-                                           error));
-  if (error.Fail()) {
-    if (log)
-      LLDB_LOGF(log, "== [UserExpression::Evaluate] Getting expression: %s ==",
-                error.AsCString());
-    return lldb::eExpressionSetupError;
+  // An expression that was prepared for the same text and scope before only
+  // needs its arguments materialized again.
+  const std::string cache_key =
+      GetExpressionCacheKey(exe_ctx, options, expr, full_prefix, language,
+                            desired_type, execution_policy, ctx_obj);
+  lldb::UserExpressionSP user_expression_sp;
+  if (!cache_key.empty()) {
+    user_expression_sp = target->GetCachedUserExpression(cache_key);
+    if (user_expression_sp && !user_expression_sp->MatchesContext(exe_ctx))
+      user_expression_sp.reset();
+    target->IncrementStats(user_expression_sp
+                               ? StatisticKind::ExpressionCacheHit
+                               : StatisticKind::ExpressionCacheMiss);
+  }
+  const bool from_cache = user_expression_sp != nullptr;
+
+  if (!from_cache) {
+    user_expression_sp.reset(target->GetUserExpressionForLanguage(
+        exe_ctx, expr, full_prefix, language, desired_type, options, ctx_obj,
+        error));
+    if (error.Fail()) {
+      if (log)
+        LLDB_LOGF(log,
+                  "== [UserExpression::Evaluate] Getting expression: %s ==",
+                  error.AsCString());
+      return lldb::eExpressionSetupError;
+    }
   }
 
   if (log)
-    LLDB_LOGF(log, "== [UserExpression::Evaluate] Parsing expression %s ==",
-              expr.str().c_str());
+    LLDB_LOGF(log, "== [UserExpression::Evaluate] %s expression %s ==",
+              from_cache ? "Reusing" : "Parsing", expr.str().c_str());
 
   const bool keep_expression_in_memory = true;
   const bool generate_debug_info = options.GetGenerateDebugInfo();
@@ -257,9 +328,15 @@ lldb::ExpressionResults UserExpression::Evaluate(
   DiagnosticManager diagnostic_manager;
 
   bool parse_success =
+      from_cache ||
       user_expression_sp->Parse(diagnostic_manager, exe_ctx, execution_policy,
                                 keep_expression_in_memory, generate_debug_info);
 
+  // Expressions that needed fix-its are not cached, the user should keep
+  // seeing the fixed expression.
+  if (parse_success && !from_cache && !cache_key.empty())
+    target->CacheUserExpression(cache_key, user_expression_sp);
+
   // Calculate the fixed expression always, since we need it for errors.
   std::string tmp_fixed_expression;
   if (fixed_expression == nullptr)
@@ -11,8 +11,10 @@
 #include "lldb/Host/common/NativeBreakpointList.h"
 #include "lldb/Host/common/NativeRegisterContext.h"
 #include "lldb/Host/common/NativeThreadProtocol.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/LLDBAssert.h"
 #include "lldb/Utility/Log.h"
+#include "lldb/Utility/RegisterValue.h"
 #include "lldb/Utility/State.h"
 #include "lldb/lldb-enumerations.h"
 
@@ -41,6 +43,13 @@ lldb_private::Status NativeProcessProtocol::Interrupt() {
 #endif
 }
 
+Status NativeProcessProtocol::SetNonStopMode(bool enabled) {
+  // Default: only all-stop mode is supported.
+  if (enabled)
+    return Status("non-stop mode not supported");
+  return Status();
+}
+
 Status NativeProcessProtocol::IgnoreSignals(llvm::ArrayRef<int> signals) {
   m_signals_to_ignore.clear();
   m_signals_to_ignore.insert(signals.begin(), signals.end());
@@ -356,6 +365,15 @@ void NativeProcessProtocol::NotifyDidExec() {
   }
 }
 
+void NativeProcessProtocol::NotifyThreadStopped(NativeThreadProtocol &thread) {
+  Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_THREAD));
+  LLDB_LOG(log, "pid {0} tid {1} stopped", GetID(), thread.GetID());
+
+  std::lock_guard<std::recursive_mutex> guard(m_delegates_mutex);
+  for (auto native_delegate : m_delegates)
+    native_delegate->ThreadStopped(this, thread);
+}
+
 Status NativeProcessProtocol::SetSoftwareBreakpoint(lldb::addr_t addr,
                                                     uint32_t size_hint) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
@@ -634,6 +652,81 @@ Status NativeProcessProtocol::RemoveBreakpoint(lldb::addr_t addr,
     return RemoveSoftwareBreakpoint(addr);
 }
 
+Status NativeProcessProtocol::SetBreakpointConditions(
+    lldb::addr_t addr, std::vector<AgentExpression> conditions) {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+  LLDB_LOG(log, "addr = {0:x}, {1} conditions", addr, conditions.size());
+
+  auto it = m_software_breakpoints.find(addr);
+  if (it == m_software_breakpoints.end())
+    return Status("Breakpoint not found.");
+  it->second.conditions = std::move(conditions);
+  return Status();
+}
+
+bool NativeProcessProtocol::ShouldReportBreakpointHit(
+    NativeThreadProtocol &thread, lldb::addr_t addr) {
+  auto it = m_software_breakpoints.find(addr);
+  if (it == m_software_breakpoints.end() || it->second.conditions.empty())
+    return true;
+
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+  NativeRegisterContext &reg_ctx = thread.GetRegisterContext();
+
+  auto read_register = [&](uint32_t reg_num) -> llvm::Expected<uint64_t> {
+    const RegisterInfo *reg_info = reg_ctx.GetRegisterInfoAtIndex(reg_num);
+    if (!reg_info)
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "invalid register %u", reg_num);
+    RegisterValue value;
+    Status error = reg_ctx.ReadRegister(reg_info, value);
+    if (error.Fail())
+      return error.ToError();
+    bool success = false;
+    uint64_t result = value.GetAsUInt64(0, &success);
+    if (!success)
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "register %s is not an integer",
+                                     reg_info->name);
+    return result;
+  };
+
+  auto read_memory = [&](lldb::addr_t addr,
+                         uint32_t size) -> llvm::Expected<uint64_t> {
+    uint8_t buf[8];
+    size_t bytes_read = 0;
+    Status error = ReadMemoryWithoutTrap(addr, buf, size, bytes_read);
+    if (error.Fail())
+      return error.ToError();
+    if (bytes_read != size)
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "could not read %u bytes at 0x%" PRIx64,
+                                     size, addr);
+    const ArchSpec &arch = GetArchitecture();
+    DataExtractor data(buf, size, arch.GetByteOrder(),
+                       arch.GetAddressByteSize());
+    lldb::offset_t offset = 0;
+    return data.GetMaxU64(&offset, size);
+  };
+
+  for (const AgentExpression &condition : it->second.conditions) {
+    llvm::Expected<uint64_t> result =
+        condition.Evaluate(read_register, read_memory);
+    if (!result) {
+      LLDB_LOG(log, "pid {0} tid {1}: condition at {2:x} failed: {3}",
+               GetID(), thread.GetID(), addr,
+               llvm::toString(result.takeError()));
+      return true;
+    }
+    if (*result != 0)
+      return true;
+  }
+
+  LLDB_LOG(log, "pid {0} tid {1}: all conditions at {2:x} are false", GetID(),
+           thread.GetID(), addr);
+  return false;
+}
+
 Status NativeProcessProtocol::ReadMemoryWithoutTrap(lldb::addr_t addr,
                                                     void *buf, size_t size,
                                                     size_t &bytes_read) {
@@ -641,8 +734,41 @@ Status NativeProcessProtocol::ReadMemoryWithoutTrap(lldb::addr_t addr,
   if (error.Fail())
     return error;
 
-  auto data =
-      llvm::makeMutableArrayRef(static_cast<uint8_t *>(buf), bytes_read);
+  RemoveSoftwareBreakpointOpcodes(
+      addr, llvm::makeMutableArrayRef(static_cast<uint8_t *>(buf), bytes_read));
+  return Status();
+}
+
+void NativeProcessProtocol::ReadMemoryRanges(
+    llvm::ArrayRef<MemoryRange> ranges, void *buf,
+    llvm::MutableArrayRef<size_t> bytes_read) {
+  uint8_t *dst = static_cast<uint8_t *>(buf);
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    Status error = ReadMemory(ranges[i].GetRangeBase(), dst,
+                              ranges[i].GetByteSize(), bytes_read[i]);
+    if (error.Fail())
+      bytes_read[i] = 0;
+    dst += ranges[i].GetByteSize();
+  }
+}
+
+void NativeProcessProtocol::ReadMemoryRangesWithoutTrap(
+    llvm::ArrayRef<MemoryRange> ranges, void *buf,
+    llvm::MutableArrayRef<size_t> bytes_read) {
+  ReadMemoryRanges(ranges, buf, bytes_read);
+
+  uint8_t *dst = static_cast<uint8_t *>(buf);
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    RemoveSoftwareBreakpointOpcodes(
+        ranges[i].GetRangeBase(),
+        llvm::makeMutableArrayRef(dst, bytes_read[i]));
+    dst += ranges[i].GetByteSize();
+  }
+}
+
+void NativeProcessProtocol::RemoveSoftwareBreakpointOpcodes(
+    lldb::addr_t addr, llvm::MutableArrayRef<uint8_t> data) {
+  const size_t bytes_read = data.size();
   for (const auto &pair : m_software_breakpoints) {
     lldb::addr_t bp_addr = pair.first;
     auto saved_opcodes = makeArrayRef(pair.second.saved_opcodes);
@@ -659,7 +785,6 @@ Status NativeProcessProtocol::ReadMemoryWithoutTrap(lldb::addr_t addr,
                 std::min(saved_opcodes.size(), bp_data.size()),
                 bp_data.begin());
   }
-  return Status();
 }
 
 llvm::Expected<llvm::StringRef>
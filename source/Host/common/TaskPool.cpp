@@ -9,102 +9,301 @@
 #include "lldb/Host/TaskPool.h"
 #include "lldb/Host/ThreadLauncher.h"
 #include "lldb/Utility/Log.h"
+#include "llvm/Support/RWMutex.h"
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
-#include <queue>
+#include <deque>
 #include <thread>
 
 namespace lldb_private {
 
 namespace {
+// A task and the batch it belongs to. The tasks one thread adds from the same
+// task, or from outside of any task, form a batch.
+struct PendingTask {
+  std::function<void()> task_fn;
+  uint64_t batch;
+};
+
+// The tasks owned by one worker thread. The owner adds and removes tasks at
+// the back, other threads steal them from the front.
+struct WorkQueue {
+  std::mutex mutex;
+  std::deque<PendingTask> tasks;
+};
+
 class TaskPoolImpl {
 public:
   static TaskPoolImpl &GetInstance();
 
   void AddTask(std::function<void()> &&task_fn);
 
+  bool RunPendingTask();
+
+  bool RunOwnPendingTask();
+
+  void SetMaxThreadCount(unsigned count) { m_max_thread_count = count; }
+
+  unsigned GetMaxThreadCount() const { return m_max_thread_count; }
+
 private:
   TaskPoolImpl();
 
-  static lldb::thread_result_t WorkerPtr(void *pool);
+  static lldb::thread_result_t WorkerPtr(void *queue);
+
+  void Worker(WorkQueue &queue);
+
+  bool PopTask(std::function<void()> &task_fn);
+
+  bool PopOwnTask(std::function<void()> &task_fn);
+
+  static void RunTask(std::function<void()> &task_fn);
+
+  void SpawnWorkerIfNeeded();
+
+  // Tasks added by threads that are not workers of the pool.
+  std::deque<PendingTask> m_injected_tasks;
+  std::mutex m_injected_tasks_mutex;
+
+  // One queue per worker thread. Queues are only ever added, never removed.
+  std::vector<std::unique_ptr<WorkQueue>> m_queues;
+  llvm::sys::RWMutex m_queues_mutex;
 
-  static void Worker(TaskPoolImpl *pool);
+  // Number of tasks in all queues, used to put idle workers to sleep.
+  std::atomic<size_t> m_pending_tasks{0};
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_sleep_cv;
 
-  std::queue<std::function<void()>> m_tasks;
-  std::mutex m_tasks_mutex;
-  uint32_t m_thread_count;
+  std::atomic<unsigned> m_thread_count{0};
+  std::atomic<unsigned> m_max_thread_count;
 };
 
+// The queue of the worker running on the current thread, if any.
+static thread_local WorkQueue *g_current_queue = nullptr;
+
+static std::atomic<uint64_t> g_next_batch{1};
+
+// The batch of the tasks the current thread adds. Every thread and every task
+// run gets a batch of its own.
+static thread_local uint64_t g_current_batch = 0;
+
+static uint64_t GetCurrentBatch() {
+  if (g_current_batch == 0)
+    g_current_batch = g_next_batch++;
+  return g_current_batch;
+}
+
 } // end of anonymous namespace
 
 TaskPoolImpl &TaskPoolImpl::GetInstance() {
-  static TaskPoolImpl g_task_pool_impl;
-  return g_task_pool_impl;
+  // Worker threads are detached and may still reference the pool while the
+  // process exits, so the pool is intentionally leaked.
+  static TaskPoolImpl *g_task_pool_impl = new TaskPoolImpl();
+  return *g_task_pool_impl;
 }
 
 void TaskPool::AddTaskImpl(std::function<void()> &&task_fn) {
   TaskPoolImpl::GetInstance().AddTask(std::move(task_fn));
 }
 
-TaskPoolImpl::TaskPoolImpl() : m_thread_count(0) {}
+bool TaskPool::RunOwnPendingTask() {
+  return TaskPoolImpl::GetInstance().RunOwnPendingTask();
+}
+
+void TaskPool::SetMaxThreadCount(unsigned count) {
+  TaskPoolImpl::GetInstance().SetMaxThreadCount(std::max(1u, count));
+}
+
+unsigned TaskPool::GetMaxThreadCount() {
+  return TaskPoolImpl::GetInstance().GetMaxThreadCount();
+}
+
+TaskPoolImpl::TaskPoolImpl()
+    : m_max_thread_count(GetHardwareConcurrencyHint()) {}
 
 unsigned GetHardwareConcurrencyHint() {
   // std::thread::hardware_concurrency may return 0 if the value is not well
   // defined or not computable.
-  static const unsigned g_hardware_concurrency = 
+  static const unsigned g_hardware_concurrency =
     std::max(1u, std::thread::hardware_concurrency());
   return g_hardware_concurrency;
 }
 
 void TaskPoolImpl::AddTask(std::function<void()> &&task_fn) {
+  PendingTask task{std::move(task_fn), GetCurrentBatch()};
+  if (WorkQueue *queue = g_current_queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    queue->tasks.push_back(std::move(task));
+  } else {
+    std::lock_guard<std::mutex> lock(m_injected_tasks_mutex);
+    m_injected_tasks.push_back(std::move(task));
+  }
+
+  {
+    // Taking the sleep mutex makes sure a worker that just found no work
+    // cannot miss this notification.
+    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    m_pending_tasks++;
+  }
+  m_sleep_cv.notify_one();
+
+  SpawnWorkerIfNeeded();
+}
+
+void TaskPoolImpl::SpawnWorkerIfNeeded() {
   const size_t min_stack_size = 8 * 1024 * 1024;
 
-  std::unique_lock<std::mutex> lock(m_tasks_mutex);
-  m_tasks.emplace(std::move(task_fn));
-  if (m_thread_count < GetHardwareConcurrencyHint()) {
-    m_thread_count++;
-    // Note that this detach call needs to happen with the m_tasks_mutex held.
-    // This prevents the thread from exiting prematurely and triggering a linux
-    // libc bug (https://sourceware.org/bugzilla/show_bug.cgi?id=19951).
-    llvm::Expected<HostThread> host_thread =
-        lldb_private::ThreadLauncher::LaunchThread(
-            "task-pool.worker", WorkerPtr, this, min_stack_size);
-    if (host_thread) {
-      host_thread->Release();
-    } else {
-      LLDB_LOG(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_HOST),
-               "failed to launch host thread: {}",
-               llvm::toString(host_thread.takeError()));
+  if (m_thread_count >= m_max_thread_count)
+    return;
+
+  llvm::sys::ScopedWriter lock(m_queues_mutex);
+  if (m_thread_count >= m_max_thread_count)
+    return;
+  m_thread_count++;
+  m_queues.push_back(std::make_unique<WorkQueue>());
+  // Note that this detach call needs to happen with the m_queues_mutex held.
+  // This prevents the thread from exiting prematurely and triggering a linux
+  // libc bug (https://sourceware.org/bugzilla/show_bug.cgi?id=19951).
+  llvm::Expected<HostThread> host_thread =
+      lldb_private::ThreadLauncher::LaunchThread(
+          "task-pool.worker", WorkerPtr, m_queues.back().get(),
+          min_stack_size);
+  if (host_thread) {
+    host_thread->Release();
+  } else {
+    m_thread_count--;
+    m_queues.pop_back();
+    LLDB_LOG(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_HOST),
+             "failed to launch host thread: {}",
+             llvm::toString(host_thread.takeError()));
+  }
+}
+
+bool TaskPoolImpl::PopTask(std::function<void()> &task_fn) {
+  if (m_pending_tasks == 0)
+    return false;
+
+  // Newest task of our own queue first, it is the most likely to still be in
+  // the cache.
+  if (WorkQueue *queue = g_current_queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (!queue->tasks.empty()) {
+      task_fn = std::move(queue->tasks.back().task_fn);
+      queue->tasks.pop_back();
+      m_pending_tasks--;
+      return true;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_injected_tasks_mutex);
+    if (!m_injected_tasks.empty()) {
+      task_fn = std::move(m_injected_tasks.front().task_fn);
+      m_injected_tasks.pop_front();
+      m_pending_tasks--;
+      return true;
+    }
+  }
+
+  // Steal the oldest task of another worker. Start at a different queue on
+  // every thread to spread the thieves out.
+  static std::atomic<size_t> g_next_victim{0};
+  llvm::sys::ScopedReader lock(m_queues_mutex);
+  const size_t num_queues = m_queues.size();
+  const size_t start = g_next_victim++;
+  for (size_t i = 0; i < num_queues; ++i) {
+    WorkQueue &victim = *m_queues[(start + i) % num_queues];
+    if (&victim == g_current_queue)
+      continue;
+    std::lock_guard<std::mutex> victim_lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task_fn = std::move(victim.tasks.front().task_fn);
+      victim.tasks.pop_front();
+      m_pending_tasks--;
+      return true;
+    }
+  }
+  return false;
+}
+
+// The tasks of a batch were all added by this thread, so they can only be in
+// our own queue, or in the injected queue if we aren't a worker. They are
+// usually the newest tasks there.
+bool TaskPoolImpl::PopOwnTask(std::function<void()> &task_fn) {
+  if (m_pending_tasks == 0)
+    return false;
+
+  const uint64_t batch = GetCurrentBatch();
+  auto pop_from = [&](std::deque<PendingTask> &tasks) {
+    for (auto pos = tasks.rbegin(), end = tasks.rend(); pos != end; ++pos) {
+      if (pos->batch == batch) {
+        task_fn = std::move(pos->task_fn);
+        tasks.erase(std::next(pos).base());
+        m_pending_tasks--;
+        return true;
+      }
     }
+    return false;
+  };
+
+  if (WorkQueue *queue = g_current_queue) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return pop_from(queue->tasks);
   }
+  std::lock_guard<std::mutex> lock(m_injected_tasks_mutex);
+  return pop_from(m_injected_tasks);
+}
+
+void TaskPoolImpl::RunTask(std::function<void()> &task_fn) {
+  // The tasks added by this one are a new batch.
+  const uint64_t outer_batch = g_current_batch;
+  g_current_batch = g_next_batch++;
+  task_fn();
+  g_current_batch = outer_batch;
 }
 
-lldb::thread_result_t TaskPoolImpl::WorkerPtr(void *pool) {
-  Worker((TaskPoolImpl *)pool);
+bool TaskPoolImpl::RunPendingTask() {
+  std::function<void()> task_fn;
+  if (!PopTask(task_fn))
+    return false;
+  RunTask(task_fn);
+  return true;
+}
+
+bool TaskPoolImpl::RunOwnPendingTask() {
+  std::function<void()> task_fn;
+  if (!PopOwnTask(task_fn))
+    return false;
+  RunTask(task_fn);
+  return true;
+}
+
+lldb::thread_result_t TaskPoolImpl::WorkerPtr(void *queue) {
+  GetInstance().Worker(*static_cast<WorkQueue *>(queue));
   return {};
 }
 
-void TaskPoolImpl::Worker(TaskPoolImpl *pool) {
+void TaskPoolImpl::Worker(WorkQueue &queue) {
+  g_current_queue = &queue;
   while (true) {
-    std::unique_lock<std::mutex> lock(pool->m_tasks_mutex);
-    if (pool->m_tasks.empty()) {
-      pool->m_thread_count--;
-      break;
-    }
+    if (RunPendingTask())
+      continue;
 
-    std::function<void()> f = std::move(pool->m_tasks.front());
-    pool->m_tasks.pop();
-    lock.unlock();
-
-    f();
+    std::unique_lock<std::mutex> lock(m_sleep_mutex);
+    m_sleep_cv.wait(lock, [this] { return m_pending_tasks > 0; });
   }
 }
 
 void TaskMapOverInt(size_t begin, size_t end,
                     const llvm::function_ref<void(size_t)> &func) {
-  const size_t num_workers = std::min<size_t>(end, GetHardwareConcurrencyHint());
+  if (begin >= end)
+    return;
+  const size_t num_workers =
+      std::min<size_t>(end - begin, TaskPool::GetMaxThreadCount());
   std::atomic<size_t> idx{begin};
-  
+
   auto wrapper = [&idx, end, &func]() {
     while (true) {
       size_t i = idx.fetch_add(1);
@@ -114,13 +313,15 @@ void TaskMapOverInt(size_t begin, size_t end,
     }
   };
 
+  // The calling thread is one of the workers. Waiting runs the helper tasks
+  // no worker picked up, they return right away.
   std::vector<std::future<void>> futures;
-  futures.reserve(num_workers);
-  for (size_t i = 0; i < num_workers; i++)
+  futures.reserve(num_workers - 1);
+  for (size_t i = 1; i < num_workers; i++)
     futures.push_back(TaskPool::AddTask(wrapper));
-  for (size_t i = 0; i < num_workers; i++)
-    futures[i].wait();
+  wrapper();
+  for (std::future<void> &future : futures)
+    TaskPool::Wait(future);
 }
 
 } // namespace lldb_private
-
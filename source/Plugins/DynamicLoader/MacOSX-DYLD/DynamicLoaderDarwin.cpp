@@ -91,13 +91,9 @@ void DynamicLoaderDarwin::Clear(bool clear_process) {
   m_dyld.Clear(false);
 }
 
-ModuleSP DynamicLoaderDarwin::FindTargetModuleForImageInfo(
-    ImageInfo &image_info, bool can_create, bool *did_create_ptr) {
-  if (did_create_ptr)
-    *did_create_ptr = false;
-
+ModuleSpec
+DynamicLoaderDarwin::GetModuleSpecForImageInfo(ImageInfo &image_info) {
   Target &target = m_process->GetTarget();
-  const ModuleList &target_images = target.GetImages();
   ModuleSpec module_spec(image_info.file_spec);
   module_spec.GetUUID() = image_info.uuid;
 
@@ -111,6 +107,17 @@ ModuleSP DynamicLoaderDarwin::FindTargetModuleForImageInfo(
       module_spec.GetArchitecture() = ArchSpec(target_triple);
     }
   }
+  return module_spec;
+}
+
+ModuleSP DynamicLoaderDarwin::FindTargetModuleForImageInfo(
+    ImageInfo &image_info, bool can_create, bool *did_create_ptr) {
+  if (did_create_ptr)
+    *did_create_ptr = false;
+
+  Target &target = m_process->GetTarget();
+  const ModuleList &target_images = target.GetImages();
+  ModuleSpec module_spec = GetModuleSpecForImageInfo(image_info);
 
   ModuleSP module_sp(target_images.FindFirstModule(module_spec));
 
@@ -608,6 +615,19 @@ bool DynamicLoaderDarwin::AddModulesUsingImageInfos(
   Target &target = m_process->GetTarget();
   ModuleList &target_images = target.GetImages();
 
+  // Create the modules of all new images with a UUID in one batch, so that
+  // their symbols are preloaded in parallel. FindTargetModuleForImageInfo
+  // then finds them in the target.
+  std::vector<ModuleSpec> module_specs;
+  for (ImageInfo &image_info : image_infos) {
+    ModuleSpec module_spec = GetModuleSpecForImageInfo(image_info);
+    if (module_spec.GetUUID().IsValid() &&
+        !target_images.FindFirstModule(module_spec))
+      module_specs.push_back(module_spec);
+  }
+  if (module_specs.size() > 1)
+    target.GetOrCreateModules(module_specs, false /* notify */);
+
   for (uint32_t idx = 0; idx < image_infos.size(); ++idx) {
     if (log) {
       LLDB_LOGF(log, "Adding new image at address=0x%16.16" PRIx64 ".",
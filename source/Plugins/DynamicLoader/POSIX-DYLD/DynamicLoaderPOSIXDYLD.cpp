@@ -419,6 +419,7 @@ void DynamicLoaderPOSIXDYLD::RefreshModules() {
   if (m_rendezvous.ModulesDidLoad()) {
     ModuleList new_modules;
 
+    CreateModules(m_rendezvous.loaded_begin(), m_rendezvous.loaded_end());
     E = m_rendezvous.loaded_end();
     for (I = m_rendezvous.loaded_begin(); I != E; ++I) {
       ModuleSP module_sp =
@@ -574,6 +575,8 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
   m_process->PrefetchModuleSpecs(
       module_names, m_process->GetTarget().GetArchitecture().GetTriple());
 
+  CreateModules(m_rendezvous.begin(), m_rendezvous.end());
+
   for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I) {
     ModuleSP module_sp =
         LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
@@ -593,6 +596,20 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
   m_process->GetTarget().ModulesDidLoad(module_list);
 }
 
+void DynamicLoaderPOSIXDYLD::CreateModules(DYLDRendezvous::iterator begin,
+                                           DYLDRendezvous::iterator end) {
+  Target &target = m_process->GetTarget();
+  const ModuleList &modules = target.GetImages();
+  std::vector<ModuleSpec> module_specs;
+  for (DYLDRendezvous::iterator I = begin; I != end; ++I) {
+    ModuleSpec module_spec(I->file_spec, target.GetArchitecture());
+    if (!modules.FindFirstModule(module_spec))
+      module_specs.push_back(module_spec);
+  }
+  if (module_specs.size() > 1)
+    target.GetOrCreateModules(module_specs, true /* notify */);
+}
+
 addr_t DynamicLoaderPOSIXDYLD::ComputeLoadOffset() {
   addr_t virt_entry;
 
@@ -134,6 +134,12 @@ protected:
   /// of all dependent modules.
   virtual void LoadAllCurrentModules();
 
+  /// Find or create the modules for the entries in [begin, end) that are not
+  /// in the target yet in one batch, so that their symbols get preloaded in
+  /// parallel. LoadModuleAtAddress then finds them in the target.
+  void CreateModules(DYLDRendezvous::iterator begin,
+                     DYLDRendezvous::iterator end);
+
   void LoadVDSO();
 
   // Loading an interpreter module (if present) assumming m_interpreter_base
@@ -12,103 +12,22 @@
 #include "lldb/Core/ValueObjectConstResult.h"
 #include "lldb/DataFormatters/FormattersHelpers.h"
 #include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Utility/DataBufferHeap.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Endian.h"
 #include "lldb/Utility/Status.h"
 #include "lldb/Utility/Stream.h"
 
+#include "llvm/Support/MathExtras.h"
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::formatters;
 
 namespace {
 
-class ListEntry {
-public:
-  ListEntry() = default;
-  ListEntry(ValueObjectSP entry_sp) : m_entry_sp(entry_sp) {}
-  ListEntry(const ListEntry &rhs) = default;
-  ListEntry(ValueObject *entry)
-      : m_entry_sp(entry ? entry->GetSP() : ValueObjectSP()) {}
-
-  ListEntry next() {
-    static ConstString g_next("__next_");
-
-    if (!m_entry_sp)
-      return ListEntry();
-    return ListEntry(m_entry_sp->GetChildMemberWithName(g_next, true));
-  }
-
-  ListEntry prev() {
-    static ConstString g_prev("__prev_");
-
-    if (!m_entry_sp)
-      return ListEntry();
-    return ListEntry(m_entry_sp->GetChildMemberWithName(g_prev, true));
-  }
-
-  uint64_t value() const {
-    if (!m_entry_sp)
-      return 0;
-    return m_entry_sp->GetValueAsUnsigned(0);
-  }
-
-  bool null() { return (value() == 0); }
-
-  explicit operator bool() { return GetEntry() && !null(); }
-
-  ValueObjectSP GetEntry() { return m_entry_sp; }
-
-  void SetEntry(ValueObjectSP entry) { m_entry_sp = entry; }
-
-  bool operator==(const ListEntry &rhs) const { return value() == rhs.value(); }
-
-  bool operator!=(const ListEntry &rhs) const { return !(*this == rhs); }
-
-private:
-  ValueObjectSP m_entry_sp;
-};
-
-class ListIterator {
-public:
-  ListIterator() = default;
-  ListIterator(ListEntry entry) : m_entry(entry) {}
-  ListIterator(ValueObjectSP entry) : m_entry(entry) {}
-  ListIterator(const ListIterator &rhs) = default;
-  ListIterator(ValueObject *entry) : m_entry(entry) {}
-
-  ValueObjectSP value() { return m_entry.GetEntry(); }
-
-  ValueObjectSP advance(size_t count) {
-    if (count == 0)
-      return m_entry.GetEntry();
-    if (count == 1) {
-      next();
-      return m_entry.GetEntry();
-    }
-    while (count > 0) {
-      next();
-      count--;
-      if (m_entry.null())
-        return lldb::ValueObjectSP();
-    }
-    return m_entry.GetEntry();
-  }
-
-  bool operator==(const ListIterator &rhs) const {
-    return (rhs.m_entry == m_entry);
-  }
-
-protected:
-  void next() { m_entry = m_entry.next(); }
-
-  void prev() { m_entry = m_entry.prev(); }
-
-private:
-  ListEntry m_entry;
-};
-
 class AbstractListFrontEnd : public SyntheticChildrenFrontEnd {
 public:
   size_t GetIndexOfChildWithName(ConstString name) override {
@@ -116,6 +35,9 @@ public:
   }
   bool MightHaveChildren() override { return true; }
   bool Update() override;
+  lldb::ValueObjectSP GetChildAtIndex(size_t idx) override;
+  std::vector<lldb::ValueObjectSP>
+  GetChildrenAtIndexRange(size_t start, size_t count) override;
 
 protected:
   AbstractListFrontEnd(ValueObject &valobj)
@@ -124,18 +46,21 @@ protected:
   size_t m_count;
   ValueObject *m_head;
 
-  static constexpr bool g_use_loop_detect = true;
-  size_t m_loop_detected; // The number of elements that have had loop detection
-                          // run over them.
-  ListEntry m_slow_runner; // Used for loop detection
-  ListEntry m_fast_runner; // Used for loop detection
-
   size_t m_list_capping_size;
   CompilerType m_element_type;
-  std::map<size_t, ListIterator> m_iterators;
 
-  bool HasLoop(size_t count);
-  ValueObjectSP GetItem(size_t idx);
+  // The nodes are walked by reading their next pointers, the derived front
+  // ends say where those are and what the last one points to.
+  uint32_t m_next_offset;
+  lldb::addr_t m_end_address;
+  uint64_t m_value_offset;
+  // The addresses of the nodes in order, as far as the list was walked.
+  std::vector<lldb::addr_t> m_nodes;
+  lldb::addr_t m_loop_anchor; // Used for loop detection
+  bool m_has_loop;
+
+  bool FindNodes(Process &process, size_t count);
+  bool GetNodeLayout(Process &process);
 };
 
 class ForwardListFrontEnd : public AbstractListFrontEnd {
@@ -143,7 +68,6 @@ public:
   ForwardListFrontEnd(ValueObject &valobj);
 
   size_t CalculateNumChildren() override;
-  ValueObjectSP GetChildAtIndex(size_t idx) override;
   bool Update() override;
 };
 
@@ -155,8 +79,6 @@ public:
 
   size_t CalculateNumChildren() override;
 
-  lldb::ValueObjectSP GetChildAtIndex(size_t idx) override;
-
   bool Update() override;
 
 private:
@@ -167,13 +89,15 @@ private:
 } // end anonymous namespace
 
 bool AbstractListFrontEnd::Update() {
-  m_loop_detected = 0;
   m_count = UINT32_MAX;
   m_head = nullptr;
   m_list_capping_size = 0;
-  m_slow_runner.SetEntry(nullptr);
-  m_fast_runner.SetEntry(nullptr);
-  m_iterators.clear();
+  m_next_offset = 0;
+  m_end_address = 0;
+  m_value_offset = UINT64_MAX;
+  m_nodes.clear();
+  m_loop_anchor = LLDB_INVALID_ADDRESS;
+  m_has_loop = false;
 
   if (m_backend.GetTargetSP())
     m_list_capping_size =
@@ -192,53 +116,118 @@ bool AbstractListFrontEnd::Update() {
   return false;
 }
 
-bool AbstractListFrontEnd::HasLoop(size_t count) {
-  if (!g_use_loop_detect)
-    return false;
-  // don't bother checking for a loop if we won't actually need to jump nodes
-  if (m_count < 2)
+bool AbstractListFrontEnd::FindNodes(Process &process, size_t count) {
+  if (!m_head)
     return false;
+  if (m_nodes.empty()) {
+    lldb::addr_t head = m_head->GetValueAsUnsigned(0);
+    if (!head || head == m_end_address)
+      return false;
+    m_nodes.push_back(head);
+    m_loop_anchor = head;
+  }
 
-  if (m_loop_detected == 0) {
-    // This is the first time we are being run (after the last update). Set up
-    // the loop invariant for the first element.
-    m_slow_runner = ListEntry(m_head).next();
-    m_fast_runner = m_slow_runner.next();
-    m_loop_detected = 1;
+  Status error;
+  while (m_nodes.size() < count) {
+    if (m_has_loop)
+      return false;
+    lldb::addr_t next =
+        process.ReadPointerFromMemory(m_nodes.back() + m_next_offset, error);
+    if (error.Fail() || !next || next == m_end_address)
+      return false;
+    // Compare every node with the one at the last index that is a power of
+    // two minus one. A list with a loop comes back to it once the power of
+    // two is larger than the loop.
+    const size_t idx = m_nodes.size();
+    if (next == m_loop_anchor) {
+      // The loop is as long as the distance to the anchor. Keep the nodes up
+      // to the first one that comes back after that many steps.
+      const size_t loop_length = idx - (llvm::PowerOf2Floor(idx) - 1);
+      for (size_t i = 0; i + loop_length < idx; ++i)
+        if (m_nodes[i] == m_nodes[i + loop_length]) {
+          m_nodes.resize(i + loop_length);
+          break;
+        }
+      m_has_loop = true;
+      return false;
+    }
+    if ((idx & (idx + 1)) == 0)
+      m_loop_anchor = next;
+    m_nodes.push_back(next);
   }
+  return true;
+}
 
-  // Loop invariant:
-  // Loop detection has been run over the first m_loop_detected elements. If
-  // m_slow_runner == m_fast_runner then the loop has been detected after
-  // m_loop_detected elements.
-  const size_t steps_to_run = std::min(count, m_count);
-  while (m_loop_detected < steps_to_run && m_slow_runner && m_fast_runner &&
-         m_slow_runner != m_fast_runner) {
-
-    m_slow_runner = m_slow_runner.next();
-    m_fast_runner = m_fast_runner.next().next();
-    m_loop_detected++;
+bool AbstractListFrontEnd::GetNodeLayout(Process &process) {
+  static ConstString g_next("__next_");
+
+  if (m_value_offset != UINT64_MAX)
+    return true;
+  if (!m_head)
+    return false;
+  // get the __value_ child of the first node
+  ValueObjectSP value_sp = m_head->GetChildAtIndex(1, true);
+  if (!value_sp)
+    return false;
+  if (value_sp->GetName() == g_next) {
+    // if we grabbed the __next_ pointer, then the value is one pointer deep-er
+    m_value_offset = 2 * process.GetAddressByteSize();
+    return true;
   }
-  if (count <= m_loop_detected)
-    return false; // No loop in the first m_loop_detected elements.
-  if (!m_slow_runner || !m_fast_runner)
-    return false; // Reached the end of the list. Definitely no loops.
-  return m_slow_runner == m_fast_runner;
+  const lldb::addr_t node = m_head->GetValueAsUnsigned(0);
+  const lldb::addr_t value = value_sp->GetAddressOf();
+  if (value == LLDB_INVALID_ADDRESS || value < node)
+    return false;
+  m_value_offset = value - node;
+  return true;
 }
 
-ValueObjectSP AbstractListFrontEnd::GetItem(size_t idx) {
-  size_t advance = idx;
-  ListIterator current(m_head);
-  if (idx > 0) {
-    auto cached_iterator = m_iterators.find(idx - 1);
-    if (cached_iterator != m_iterators.end()) {
-      current = cached_iterator->second;
-      advance = 1;
-    }
+ValueObjectSP AbstractListFrontEnd::GetChildAtIndex(size_t idx) {
+  if (idx >= CalculateNumChildren())
+    return nullptr;
+  return GetChildrenAtIndexRange(idx, 1).front();
+}
+
+std::vector<ValueObjectSP>
+AbstractListFrontEnd::GetChildrenAtIndexRange(size_t start, size_t count) {
+  std::vector<ValueObjectSP> children(count);
+  const size_t num_children = CalculateNumChildren();
+  if (start >= num_children || !m_head)
+    return children;
+  const size_t end = start + std::min(count, num_children - start);
+
+  ProcessSP process_sp = m_backend.GetProcessSP();
+  if (!process_sp || !GetNodeLayout(*process_sp))
+    return children;
+  llvm::Optional<uint64_t> size = m_element_type.GetByteSize(process_sp.get());
+  if (!size)
+    return children;
+
+  FindNodes(*process_sp, end);
+  const size_t found = std::min(m_nodes.size(), end);
+  if (found <= start)
+    return children;
+
+  std::vector<lldb::addr_t> addrs;
+  addrs.reserve(found - start);
+  for (size_t idx = start; idx < found; ++idx)
+    addrs.push_back(m_nodes[idx] + m_value_offset);
+  std::vector<uint8_t> bytes;
+  Status error;
+  if (!ReadMemoryBlocks(*process_sp, addrs, *size, bytes, error))
+    return children;
+
+  // we need to copy the values into new objects otherwise we will end up with
+  // all items named __value_
+  for (size_t i = 0; i < addrs.size(); ++i) {
+    DataExtractor data(bytes.data() + i * *size, *size,
+                       process_sp->GetByteOrder(),
+                       process_sp->GetAddressByteSize());
+    children[i] = CreateValueObjectFromData(
+        llvm::formatv("[{0}]", start + i).str(), data,
+        m_backend.GetExecutionContextRef(), m_element_type);
   }
-  ValueObjectSP value_sp = current.advance(advance);
-  m_iterators[idx] = current;
-  return value_sp;
+  return children;
 }
 
 ForwardListFrontEnd::ForwardListFrontEnd(ValueObject &valobj)
@@ -250,46 +239,15 @@ size_t ForwardListFrontEnd::CalculateNumChildren() {
   if (m_count != UINT32_MAX)
     return m_count;
 
-  ListEntry current(m_head);
   m_count = 0;
-  while (current && m_count < m_list_capping_size) {
-    ++m_count;
-    current = current.next();
-  }
+  ProcessSP process_sp = m_backend.GetProcessSP();
+  if (!process_sp)
+    return m_count;
+  FindNodes(*process_sp, m_list_capping_size);
+  m_count = m_nodes.size();
   return m_count;
 }
 
-ValueObjectSP ForwardListFrontEnd::GetChildAtIndex(size_t idx) {
-  if (idx >= CalculateNumChildren())
-    return nullptr;
-
-  if (!m_head)
-    return nullptr;
-
-  if (HasLoop(idx + 1))
-    return nullptr;
-
-  ValueObjectSP current_sp = GetItem(idx);
-  if (!current_sp)
-    return nullptr;
-
-  current_sp = current_sp->GetChildAtIndex(1, true); // get the __value_ child
-  if (!current_sp)
-    return nullptr;
-
-  // we need to copy current_sp into a new object otherwise we will end up with
-  // all items named __value_
-  DataExtractor data;
-  Status error;
-  current_sp->GetData(data, error);
-  if (error.Fail())
-    return nullptr;
-
-  return CreateValueObjectFromData(llvm::formatv("[{0}]", idx).str(), data,
-                                   m_backend.GetExecutionContextRef(),
-                                   m_element_type);
-}
-
 static ValueObjectSP GetValueOfCompressedPair(ValueObject &pair) {
   ValueObjectSP value = pair.GetChildMemberWithName(ConstString("__value_"), true);
   if (! value) {
@@ -315,6 +273,9 @@ bool ForwardListFrontEnd::Update() {
   if (!impl_sp)
     return false;
   m_head = impl_sp->GetChildMemberWithName(ConstString("__next_"), true).get();
+  // __next_ is the first member of a node, the last node's is null.
+  m_next_offset = 0;
+  m_end_address = 0;
   return false;
 }
 
@@ -346,69 +307,12 @@ size_t ListFrontEnd::CalculateNumChildren() {
       return 0;
     if (next_val == m_node_address)
       return 0;
-    if (next_val == prev_val)
-      return 1;
-    uint64_t size = 2;
-    ListEntry current(m_head);
-    while (current.next() && current.next().value() != m_node_address) {
-      size++;
-      current = current.next();
-      if (size > m_list_capping_size)
-        break;
-    }
-    return m_count = (size - 1);
-  }
-}
-
-lldb::ValueObjectSP ListFrontEnd::GetChildAtIndex(size_t idx) {
-  static ConstString g_value("__value_");
-  static ConstString g_next("__next_");
-
-  if (idx >= CalculateNumChildren())
-    return lldb::ValueObjectSP();
-
-  if (!m_head || !m_tail || m_node_address == 0)
-    return lldb::ValueObjectSP();
-
-  if (HasLoop(idx + 1))
-    return lldb::ValueObjectSP();
-
-  ValueObjectSP current_sp = GetItem(idx);
-  if (!current_sp)
-    return lldb::ValueObjectSP();
-
-  current_sp = current_sp->GetChildAtIndex(1, true); // get the __value_ child
-  if (!current_sp)
-    return lldb::ValueObjectSP();
-
-  if (current_sp->GetName() == g_next) {
-    ProcessSP process_sp(current_sp->GetProcessSP());
+    ProcessSP process_sp = m_backend.GetProcessSP();
     if (!process_sp)
-      return lldb::ValueObjectSP();
-
-    // if we grabbed the __next_ pointer, then the child is one pointer deep-er
-    lldb::addr_t addr = current_sp->GetParent()->GetPointerValue();
-    addr = addr + 2 * process_sp->GetAddressByteSize();
-    ExecutionContext exe_ctx(process_sp);
-    current_sp =
-        CreateValueObjectFromAddress("__value_", addr, exe_ctx, m_element_type);
-    if (!current_sp)
-      return lldb::ValueObjectSP();
+      return 0;
+    FindNodes(*process_sp, m_list_capping_size);
+    return m_count = m_nodes.size();
   }
-
-  // we need to copy current_sp into a new object otherwise we will end up with
-  // all items named __value_
-  DataExtractor data;
-  Status error;
-  current_sp->GetData(data, error);
-  if (error.Fail())
-    return lldb::ValueObjectSP();
-
-  StreamString name;
-  name.Printf("[%" PRIu64 "]", (uint64_t)idx);
-  return CreateValueObjectFromData(name.GetString(), data,
-                                   m_backend.GetExecutionContextRef(),
-                                   m_element_type);
 }
 
 bool ListFrontEnd::Update() {
@@ -429,6 +333,11 @@ bool ListFrontEnd::Update() {
     return false;
   m_head = impl_sp->GetChildMemberWithName(ConstString("__next_"), true).get();
   m_tail = impl_sp->GetChildMemberWithName(ConstString("__prev_"), true).get();
+  // __next_ follows __prev_ in a node, the last node's is the end node in the
+  // list object.
+  if (ProcessSP process_sp = m_backend.GetProcessSP())
+    m_next_offset = process_sp->GetAddressByteSize();
+  m_end_address = m_node_address;
   return false;
 }
 
@@ -12,8 +12,10 @@
 #include "lldb/Core/ValueObjectConstResult.h"
 #include "lldb/DataFormatters/FormattersHelpers.h"
 #include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Utility/DataBufferHeap.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Endian.h"
 #include "lldb/Utility/Status.h"
 #include "lldb/Utility/Stream.h"
@@ -22,152 +24,6 @@ using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::formatters;
 
-class MapEntry {
-public:
-  MapEntry() = default;
-  explicit MapEntry(ValueObjectSP entry_sp) : m_entry_sp(entry_sp) {}
-  MapEntry(const MapEntry &rhs) = default;
-  explicit MapEntry(ValueObject *entry)
-      : m_entry_sp(entry ? entry->GetSP() : ValueObjectSP()) {}
-
-  ValueObjectSP left() const {
-    static ConstString g_left("__left_");
-    if (!m_entry_sp)
-      return m_entry_sp;
-    return m_entry_sp->GetSyntheticChildAtOffset(
-        0, m_entry_sp->GetCompilerType(), true);
-  }
-
-  ValueObjectSP right() const {
-    static ConstString g_right("__right_");
-    if (!m_entry_sp)
-      return m_entry_sp;
-    return m_entry_sp->GetSyntheticChildAtOffset(
-        m_entry_sp->GetProcessSP()->GetAddressByteSize(),
-        m_entry_sp->GetCompilerType(), true);
-  }
-
-  ValueObjectSP parent() const {
-    static ConstString g_parent("__parent_");
-    if (!m_entry_sp)
-      return m_entry_sp;
-    return m_entry_sp->GetSyntheticChildAtOffset(
-        2 * m_entry_sp->GetProcessSP()->GetAddressByteSize(),
-        m_entry_sp->GetCompilerType(), true);
-  }
-
-  uint64_t value() const {
-    if (!m_entry_sp)
-      return 0;
-    return m_entry_sp->GetValueAsUnsigned(0);
-  }
-
-  bool error() const {
-    if (!m_entry_sp)
-      return true;
-    return m_entry_sp->GetError().Fail();
-  }
-
-  bool null() const { return (value() == 0); }
-
-  ValueObjectSP GetEntry() const { return m_entry_sp; }
-
-  void SetEntry(ValueObjectSP entry) { m_entry_sp = entry; }
-
-  bool operator==(const MapEntry &rhs) const {
-    return (rhs.m_entry_sp.get() == m_entry_sp.get());
-  }
-
-private:
-  ValueObjectSP m_entry_sp;
-};
-
-class MapIterator {
-public:
-  MapIterator() = default;
-  MapIterator(MapEntry entry, size_t depth = 0)
-      : m_entry(entry), m_max_depth(depth), m_error(false) {}
-  MapIterator(ValueObjectSP entry, size_t depth = 0)
-      : m_entry(entry), m_max_depth(depth), m_error(false) {}
-  MapIterator(const MapIterator &rhs)
-      : m_entry(rhs.m_entry), m_max_depth(rhs.m_max_depth), m_error(false) {}
-  MapIterator(ValueObject *entry, size_t depth = 0)
-      : m_entry(entry), m_max_depth(depth), m_error(false) {}
-
-  ValueObjectSP value() { return m_entry.GetEntry(); }
-
-  ValueObjectSP advance(size_t count) {
-    ValueObjectSP fail;
-    if (m_error)
-      return fail;
-    size_t steps = 0;
-    while (count > 0) {
-      next();
-      count--, steps++;
-      if (m_error || m_entry.null() || (steps > m_max_depth))
-        return fail;
-    }
-    return m_entry.GetEntry();
-  }
-
-protected:
-  void next() {
-    if (m_entry.null())
-      return;
-    MapEntry right(m_entry.right());
-    if (!right.null()) {
-      m_entry = tree_min(std::move(right));
-      return;
-    }
-    size_t steps = 0;
-    while (!is_left_child(m_entry)) {
-      if (m_entry.error()) {
-        m_error = true;
-        return;
-      }
-      m_entry.SetEntry(m_entry.parent());
-      steps++;
-      if (steps > m_max_depth) {
-        m_entry = MapEntry();
-        return;
-      }
-    }
-    m_entry = MapEntry(m_entry.parent());
-  }
-
-private:
-  MapEntry tree_min(MapEntry &&x) {
-    if (x.null())
-      return MapEntry();
-    MapEntry left(x.left());
-    size_t steps = 0;
-    while (!left.null()) {
-      if (left.error()) {
-        m_error = true;
-        return MapEntry();
-      }
-      x = left;
-      left.SetEntry(x.left());
-      steps++;
-      if (steps > m_max_depth)
-        return MapEntry();
-    }
-    return x;
-  }
-
-  bool is_left_child(const MapEntry &x) {
-    if (x.null())
-      return false;
-    MapEntry rhs(x.parent());
-    rhs.SetEntry(rhs.left());
-    return x.value() == rhs.value();
-  }
-
-  MapEntry m_entry;
-  size_t m_max_depth;
-  bool m_error;
-};
-
 namespace lldb_private {
 namespace formatters {
 class LibcxxStdMapSyntheticFrontEnd : public SyntheticChildrenFrontEnd {
@@ -180,6 +36,9 @@ public:
 
   lldb::ValueObjectSP GetChildAtIndex(size_t idx) override;
 
+  std::vector<lldb::ValueObjectSP>
+  GetChildrenAtIndexRange(size_t start, size_t count) override;
+
   bool Update() override;
 
   bool MightHaveChildren() override;
@@ -191,12 +50,21 @@ private:
 
   void GetValueOffset(const lldb::ValueObjectSP &node);
 
+  bool GetNodeLayout();
+
+  lldb::addr_t GetNextNode(Process &process, lldb::addr_t node);
+
+  bool FindNodes(Process &process, size_t count);
+
+  lldb::ValueObjectSP CreateChild(size_t idx, const DataExtractor &data);
+
   ValueObject *m_tree;
   ValueObject *m_root_node;
   CompilerType m_element_type;
   uint32_t m_skip_size;
   size_t m_count;
-  std::map<size_t, MapIterator> m_iterators;
+  // The addresses of the tree nodes in order, as far as the tree was walked.
+  std::vector<lldb::addr_t> m_nodes;
 };
 } // namespace formatters
 } // namespace lldb_private
@@ -205,7 +73,7 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::
     LibcxxStdMapSyntheticFrontEnd(lldb::ValueObjectSP valobj_sp)
     : SyntheticChildrenFrontEnd(*valobj_sp), m_tree(nullptr),
       m_root_node(nullptr), m_element_type(), m_skip_size(UINT32_MAX),
-      m_count(UINT32_MAX), m_iterators() {
+      m_count(UINT32_MAX), m_nodes() {
   if (valobj_sp)
     Update();
 }
@@ -326,86 +194,89 @@ void lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetValueOffset(
   }
 }
 
-lldb::ValueObjectSP
-lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetChildAtIndex(
-    size_t idx) {
-  static ConstString g___cc("__cc");
-  static ConstString g___nc("__nc");
-  static ConstString g___value_("__value_");
-
-  if (idx >= CalculateNumChildren())
-    return lldb::ValueObjectSP();
-  if (m_tree == nullptr || m_root_node == nullptr)
-    return lldb::ValueObjectSP();
-
-  MapIterator iterator(m_root_node, CalculateNumChildren());
+bool lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::
+    GetNodeLayout() {
+  if (m_skip_size != UINT32_MAX)
+    return true;
+  if (!GetDataType())
+    return false;
+  // because of the way our debug info is made, we need to look at the first
+  // node to find where the value is in all of them
+  Status error;
+  ValueObjectSP node_sp = m_root_node->Dereference(error);
+  if (!node_sp || error.Fail())
+    return false;
+  GetValueOffset(node_sp);
+  return m_skip_size != UINT32_MAX;
+}
 
-  const bool need_to_skip = (idx > 0);
-  size_t actual_advancde = idx;
-  if (need_to_skip) {
-    auto cached_iterator = m_iterators.find(idx - 1);
-    if (cached_iterator != m_iterators.end()) {
-      iterator = cached_iterator->second;
-      actual_advancde = 1;
+// Every node starts with the __left_, __right_ and __parent_ pointers. Only
+// __left_ exists in the end node, whose left child is the root of the tree.
+lldb::addr_t
+lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetNextNode(
+    Process &process, lldb::addr_t node) {
+  const uint32_t ptr_size = process.GetAddressByteSize();
+  Status error;
+  lldb::addr_t right = process.ReadPointerFromMemory(node + ptr_size, error);
+  if (error.Fail())
+    return LLDB_INVALID_ADDRESS;
+
+  // A tree that isn't garbage is never deeper than it has nodes.
+  if (right) {
+    // The next node is the leftmost one of the right subtree.
+    node = right;
+    for (size_t steps = 0; steps <= m_count; ++steps) {
+      lldb::addr_t left = process.ReadPointerFromMemory(node, error);
+      if (error.Fail())
+        return LLDB_INVALID_ADDRESS;
+      if (!left)
+        return node;
+      node = left;
     }
+    return LLDB_INVALID_ADDRESS;
   }
 
-  ValueObjectSP iterated_sp(iterator.advance(actual_advancde));
-  if (!iterated_sp) {
-    // this tree is garbage - stop
-    m_tree =
-        nullptr; // this will stop all future searches until an Update() happens
-    return iterated_sp;
+  // Otherwise it is the first ancestor that has the node in its left subtree.
+  for (size_t steps = 0; steps <= m_count; ++steps) {
+    lldb::addr_t parent =
+        process.ReadPointerFromMemory(node + 2 * ptr_size, error);
+    if (error.Fail() || !parent)
+      return LLDB_INVALID_ADDRESS;
+    lldb::addr_t parent_left = process.ReadPointerFromMemory(parent, error);
+    if (error.Fail())
+      return LLDB_INVALID_ADDRESS;
+    if (parent_left == node)
+      return parent;
+    node = parent;
   }
-  if (GetDataType()) {
-    if (!need_to_skip) {
-      Status error;
-      iterated_sp = iterated_sp->Dereference(error);
-      if (!iterated_sp || error.Fail()) {
-        m_tree = nullptr;
-        return lldb::ValueObjectSP();
-      }
-      GetValueOffset(iterated_sp);
-      auto child_sp = iterated_sp->GetChildMemberWithName(g___value_, true);
-      if (child_sp)
-        iterated_sp = child_sp;
-      else
-        iterated_sp = iterated_sp->GetSyntheticChildAtOffset(
-            m_skip_size, m_element_type, true);
-      if (!iterated_sp) {
-        m_tree = nullptr;
-        return lldb::ValueObjectSP();
-      }
-    } else {
-      // because of the way our debug info is made, we need to read item 0
-      // first so that we can cache information used to generate other elements
-      if (m_skip_size == UINT32_MAX)
-        GetChildAtIndex(0);
-      if (m_skip_size == UINT32_MAX) {
-        m_tree = nullptr;
-        return lldb::ValueObjectSP();
-      }
-      iterated_sp = iterated_sp->GetSyntheticChildAtOffset(
-          m_skip_size, m_element_type, true);
-      if (!iterated_sp) {
-        m_tree = nullptr;
-        return lldb::ValueObjectSP();
-      }
-    }
-  } else {
-    m_tree = nullptr;
-    return lldb::ValueObjectSP();
+  return LLDB_INVALID_ADDRESS;
+}
+
+bool lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::FindNodes(
+    Process &process, size_t count) {
+  if (m_nodes.empty()) {
+    lldb::addr_t begin = m_root_node->GetValueAsUnsigned(0);
+    if (!begin)
+      return false;
+    m_nodes.push_back(begin);
   }
-  // at this point we have a valid
-  // we need to copy current_sp into a new object otherwise we will end up with
-  // all items named __value_
-  DataExtractor data;
-  Status error;
-  iterated_sp->GetData(data, error);
-  if (error.Fail()) {
-    m_tree = nullptr;
-    return lldb::ValueObjectSP();
+  while (m_nodes.size() < count) {
+    lldb::addr_t next = GetNextNode(process, m_nodes.back());
+    if (next == LLDB_INVALID_ADDRESS || !next)
+      return false;
+    m_nodes.push_back(next);
   }
+  return true;
+}
+
+lldb::ValueObjectSP
+lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::CreateChild(
+    size_t idx, const DataExtractor &data) {
+  static ConstString g___cc("__cc");
+  static ConstString g___nc("__nc");
+
+  // we need to copy the value into a new object otherwise we will end up
+  // with all items named __value_
   StreamString name;
   name.Printf("[%" PRIu64 "]", (uint64_t)idx);
   auto potential_child_sp = CreateValueObjectFromData(
@@ -429,16 +300,73 @@ lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetChildAtIndex(
     }
     }
   }
-  m_iterators[idx] = iterator;
   return potential_child_sp;
 }
 
+lldb::ValueObjectSP
+lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::GetChildAtIndex(
+    size_t idx) {
+  if (idx >= CalculateNumChildren())
+    return lldb::ValueObjectSP();
+  return GetChildrenAtIndexRange(idx, 1).front();
+}
+
+std::vector<lldb::ValueObjectSP> lldb_private::formatters::
+    LibcxxStdMapSyntheticFrontEnd::GetChildrenAtIndexRange(size_t start,
+                                                           size_t count) {
+  std::vector<lldb::ValueObjectSP> children(count);
+  const size_t num_children = CalculateNumChildren();
+  if (start >= num_children)
+    return children;
+  const size_t end = start + std::min(count, num_children - start);
+  if (m_tree == nullptr || m_root_node == nullptr)
+    return children;
+  ProcessSP process_sp = m_backend.GetProcessSP();
+  if (!process_sp || !GetNodeLayout()) {
+    m_tree = nullptr;
+    return children;
+  }
+  llvm::Optional<uint64_t> size = m_element_type.GetByteSize(process_sp.get());
+  if (!size) {
+    m_tree = nullptr;
+    return children;
+  }
+
+  // Walk the tree only as far as the window, and remember the nodes so that
+  // the next window starts where this one ended.
+  const bool found_all = FindNodes(*process_sp, end);
+  const size_t found = std::min(m_nodes.size(), end);
+  if (found > start) {
+    std::vector<lldb::addr_t> addrs;
+    addrs.reserve(found - start);
+    for (size_t idx = start; idx < found; ++idx)
+      addrs.push_back(m_nodes[idx] + m_skip_size);
+
+    std::vector<uint8_t> bytes;
+    Status error;
+    if (!ReadMemoryBlocks(*process_sp, addrs, *size, bytes, error)) {
+      m_tree = nullptr;
+      return children;
+    }
+    for (size_t i = 0; i < addrs.size(); ++i) {
+      DataExtractor data(bytes.data() + i * *size, *size,
+                         process_sp->GetByteOrder(),
+                         process_sp->GetAddressByteSize());
+      children[i] = CreateChild(start + i, data);
+    }
+  }
+  // this tree is garbage - stop all future searches until an Update()
+  if (!found_all)
+    m_tree = nullptr;
+  return children;
+}
+
 bool lldb_private::formatters::LibcxxStdMapSyntheticFrontEnd::Update() {
   static ConstString g___tree_("__tree_");
   static ConstString g___begin_node_("__begin_node_");
   m_count = UINT32_MAX;
   m_tree = m_root_node = nullptr;
-  m_iterators.clear();
+  m_nodes.clear();
   m_tree = m_backend.GetChildMemberWithName(g___tree_, true).get();
   if (!m_tree)
     return false;
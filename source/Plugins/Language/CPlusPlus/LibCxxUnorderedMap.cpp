@@ -12,8 +12,10 @@
 #include "lldb/Core/ValueObjectConstResult.h"
 #include "lldb/DataFormatters/FormattersHelpers.h"
 #include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Utility/DataBufferHeap.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Endian.h"
 #include "lldb/Utility/Status.h"
 #include "lldb/Utility/Stream.h"
@@ -35,6 +37,9 @@ public:
 
   lldb::ValueObjectSP GetChildAtIndex(size_t idx) override;
 
+  std::vector<lldb::ValueObjectSP>
+  GetChildrenAtIndexRange(size_t start, size_t count) override;
+
   bool Update() override;
 
   bool MightHaveChildren() override;
@@ -42,12 +47,21 @@ public:
   size_t GetIndexOfChildWithName(ConstString name) override;
 
 private:
+  bool GetNodeLayout();
+
+  bool FindNodes(Process &process, size_t count);
+
   CompilerType m_element_type;
   CompilerType m_node_type;
   ValueObject *m_tree;
   size_t m_num_elements;
   ValueObject *m_next_element;
-  std::vector<std::pair<ValueObject *, uint64_t>> m_elements_cache;
+  // Where the value is in a node, and its type, found from the first node.
+  CompilerType m_value_type;
+  uint64_t m_value_offset;
+  // The addresses of the nodes in order, as far as the list of nodes was
+  // walked.
+  std::vector<lldb::addr_t> m_nodes;
 };
 } // namespace formatters
 } // namespace lldb_private
@@ -55,7 +69,8 @@ private:
 lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::
     LibcxxStdUnorderedMapSyntheticFrontEnd(lldb::ValueObjectSP valobj_sp)
     : SyntheticChildrenFrontEnd(*valobj_sp), m_element_type(), m_tree(nullptr),
-      m_num_elements(0), m_next_element(nullptr), m_elements_cache() {
+      m_num_elements(0), m_next_element(nullptr), m_value_type(),
+      m_value_offset(UINT64_MAX), m_nodes() {
   if (valobj_sp)
     Update();
 }
@@ -67,102 +82,157 @@ size_t lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::
   return 0;
 }
 
-lldb::ValueObjectSP lldb_private::formatters::
-    LibcxxStdUnorderedMapSyntheticFrontEnd::GetChildAtIndex(size_t idx) {
-  if (idx >= CalculateNumChildren())
-    return lldb::ValueObjectSP();
-  if (m_tree == nullptr)
-    return lldb::ValueObjectSP();
+bool lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::
+    GetNodeLayout() {
+  if (m_value_offset != UINT64_MAX)
+    return true;
+  if (m_next_element == nullptr)
+    return false;
 
-  while (idx >= m_elements_cache.size()) {
-    if (m_next_element == nullptr)
-      return lldb::ValueObjectSP();
-
-    Status error;
-    ValueObjectSP node_sp = m_next_element->Dereference(error);
-    if (!node_sp || error.Fail())
-      return lldb::ValueObjectSP();
-
-    ValueObjectSP value_sp =
-        node_sp->GetChildMemberWithName(ConstString("__value_"), true);
-    ValueObjectSP hash_sp =
-        node_sp->GetChildMemberWithName(ConstString("__hash_"), true);
-    if (!hash_sp || !value_sp) {
-      if (!m_element_type) {
-        auto p1_sp = m_backend.GetChildAtNamePath({ConstString("__table_"),
-                                                   ConstString("__p1_")});
-        if (!p1_sp)
-          return nullptr;
-
-        ValueObjectSP first_sp = nullptr;
-        switch (p1_sp->GetCompilerType().GetNumDirectBaseClasses()) {
-        case 1:
-          // Assume a pre llvm r300140 __compressed_pair implementation:
-          first_sp = p1_sp->GetChildMemberWithName(ConstString("__first_"),
-                                                   true);
-          break;
-        case 2: {
-          // Assume a post llvm r300140 __compressed_pair implementation:
-          ValueObjectSP first_elem_parent_sp =
-            p1_sp->GetChildAtIndex(0, true);
-          first_sp = p1_sp->GetChildMemberWithName(ConstString("__value_"),
-                                                   true);
-          break;
-        }
-        default:
-          return nullptr;
-        }
-
-        if (!first_sp)
-          return nullptr;
-        m_element_type = first_sp->GetCompilerType();
-        m_element_type = m_element_type.GetTypeTemplateArgument(0);
-        m_element_type = m_element_type.GetPointeeType();
-        m_node_type = m_element_type;
-        m_element_type = m_element_type.GetTypeTemplateArgument(0);
-        std::string name;
-        m_element_type =
-            m_element_type.GetFieldAtIndex(0, name, nullptr, nullptr, nullptr);
-        m_element_type = m_element_type.GetTypedefedType();
+  Status error;
+  ValueObjectSP node_sp = m_next_element->Dereference(error);
+  if (!node_sp || error.Fail())
+    return false;
+
+  ValueObjectSP value_sp =
+      node_sp->GetChildMemberWithName(ConstString("__value_"), true);
+  ValueObjectSP hash_sp =
+      node_sp->GetChildMemberWithName(ConstString("__hash_"), true);
+  if (!hash_sp || !value_sp) {
+    if (!m_element_type) {
+      auto p1_sp = m_backend.GetChildAtNamePath({ConstString("__table_"),
+                                                 ConstString("__p1_")});
+      if (!p1_sp)
+        return false;
+
+      ValueObjectSP first_sp = nullptr;
+      switch (p1_sp->GetCompilerType().GetNumDirectBaseClasses()) {
+      case 1:
+        // Assume a pre llvm r300140 __compressed_pair implementation:
+        first_sp = p1_sp->GetChildMemberWithName(ConstString("__first_"),
+                                                 true);
+        break;
+      case 2: {
+        // Assume a post llvm r300140 __compressed_pair implementation:
+        ValueObjectSP first_elem_parent_sp =
+          p1_sp->GetChildAtIndex(0, true);
+        first_sp = p1_sp->GetChildMemberWithName(ConstString("__value_"),
+                                                 true);
+        break;
+      }
+      default:
+        return false;
       }
-      if (!m_node_type)
-        return nullptr;
-      node_sp = node_sp->Cast(m_node_type);
-      value_sp = node_sp->GetChildMemberWithName(ConstString("__value_"), true);
-      hash_sp = node_sp->GetChildMemberWithName(ConstString("__hash_"), true);
-      if (!value_sp || !hash_sp)
-        return nullptr;
+
+      if (!first_sp)
+        return false;
+      m_element_type = first_sp->GetCompilerType();
+      m_element_type = m_element_type.GetTypeTemplateArgument(0);
+      m_element_type = m_element_type.GetPointeeType();
+      m_node_type = m_element_type;
+      m_element_type = m_element_type.GetTypeTemplateArgument(0);
+      std::string name;
+      m_element_type =
+          m_element_type.GetFieldAtIndex(0, name, nullptr, nullptr, nullptr);
+      m_element_type = m_element_type.GetTypedefedType();
     }
-    m_elements_cache.push_back(
-        {value_sp.get(), hash_sp->GetValueAsUnsigned(0)});
-    m_next_element =
-        node_sp->GetChildMemberWithName(ConstString("__next_"), true).get();
-    if (!m_next_element || m_next_element->GetValueAsUnsigned(0) == 0)
-      m_next_element = nullptr;
+    if (!m_node_type)
+      return false;
+    node_sp = node_sp->Cast(m_node_type);
+    value_sp = node_sp->GetChildMemberWithName(ConstString("__value_"), true);
+    hash_sp = node_sp->GetChildMemberWithName(ConstString("__hash_"), true);
+    if (!value_sp || !hash_sp)
+      return false;
   }
 
-  std::pair<ValueObject *, uint64_t> val_hash = m_elements_cache[idx];
-  if (!val_hash.first)
-    return lldb::ValueObjectSP();
-  StreamString stream;
-  stream.Printf("[%" PRIu64 "]", (uint64_t)idx);
-  DataExtractor data;
+  // All nodes have the layout of the first one.
+  const lldb::addr_t node = m_next_element->GetValueAsUnsigned(0);
+  const lldb::addr_t value = value_sp->GetAddressOf();
+  if (value == LLDB_INVALID_ADDRESS || value < node)
+    return false;
+  m_value_type = value_sp->GetCompilerType();
+  m_value_offset = value - node;
+  return true;
+}
+
+// The nodes form a singly linked list, __next_ is the first member of each.
+bool lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::
+    FindNodes(Process &process, size_t count) {
+  if (m_nodes.empty()) {
+    lldb::addr_t first = m_next_element->GetValueAsUnsigned(0);
+    if (!first)
+      return false;
+    m_nodes.push_back(first);
+  }
   Status error;
-  val_hash.first->GetData(data, error);
-  if (error.Fail())
+  while (m_nodes.size() < count) {
+    lldb::addr_t next = process.ReadPointerFromMemory(m_nodes.back(), error);
+    if (error.Fail() || !next)
+      return false;
+    m_nodes.push_back(next);
+  }
+  return true;
+}
+
+lldb::ValueObjectSP lldb_private::formatters::
+    LibcxxStdUnorderedMapSyntheticFrontEnd::GetChildAtIndex(size_t idx) {
+  if (idx >= CalculateNumChildren())
     return lldb::ValueObjectSP();
+  return GetChildrenAtIndexRange(idx, 1).front();
+}
+
+std::vector<lldb::ValueObjectSP> lldb_private::formatters::
+    LibcxxStdUnorderedMapSyntheticFrontEnd::GetChildrenAtIndexRange(
+        size_t start, size_t count) {
+  std::vector<lldb::ValueObjectSP> children(count);
+  const size_t num_children = CalculateNumChildren();
+  if (start >= num_children)
+    return children;
+  const size_t end = start + std::min(count, num_children - start);
+  if (m_tree == nullptr || !GetNodeLayout())
+    return children;
+  ProcessSP process_sp = m_backend.GetProcessSP();
+  if (!process_sp)
+    return children;
+  llvm::Optional<uint64_t> size = m_value_type.GetByteSize(process_sp.get());
+  if (!size)
+    return children;
+
+  FindNodes(*process_sp, end);
+  const size_t found = std::min(m_nodes.size(), end);
+  if (found <= start)
+    return children;
+
+  std::vector<lldb::addr_t> addrs;
+  addrs.reserve(found - start);
+  for (size_t idx = start; idx < found; ++idx)
+    addrs.push_back(m_nodes[idx] + m_value_offset);
+  std::vector<uint8_t> bytes;
+  Status error;
+  if (!ReadMemoryBlocks(*process_sp, addrs, *size, bytes, error))
+    return children;
+
   const bool thread_and_frame_only_if_stopped = true;
-  ExecutionContext exe_ctx = val_hash.first->GetExecutionContextRef().Lock(
+  ExecutionContext exe_ctx = m_backend.GetExecutionContextRef().Lock(
       thread_and_frame_only_if_stopped);
-  return CreateValueObjectFromData(stream.GetString(), data, exe_ctx,
-                                   val_hash.first->GetCompilerType());
+  for (size_t i = 0; i < addrs.size(); ++i) {
+    StreamString stream;
+    stream.Printf("[%" PRIu64 "]", (uint64_t)(start + i));
+    DataExtractor data(bytes.data() + i * *size, *size,
+                       process_sp->GetByteOrder(),
+                       process_sp->GetAddressByteSize());
+    children[i] = CreateValueObjectFromData(stream.GetString(), data, exe_ctx,
+                                            m_value_type);
+  }
+  return children;
 }
 
 bool lldb_private::formatters::LibcxxStdUnorderedMapSyntheticFrontEnd::
     Update() {
   m_num_elements = UINT32_MAX;
   m_next_element = nullptr;
-  m_elements_cache.clear();
+  m_value_offset = UINT64_MAX;
+  m_nodes.clear();
   ValueObjectSP table_sp =
       m_backend.GetChildMemberWithName(ConstString("__table_"), true);
   if (!table_sp)
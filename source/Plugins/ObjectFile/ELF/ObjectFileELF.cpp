@@ -36,10 +36,12 @@
 #include "llvm/BinaryFormat/ELF.h"
 #include "llvm/Object/Decompressor.h"
 #include "llvm/Support/ARMBuildAttributes.h"
+#include "llvm/Support/EndianStream.h"
 #include "llvm/Support/JamCRC.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/MipsABIFlags.h"
+#include "llvm/Support/raw_ostream.h"
 
 #define CASE_AND_STREAM(s, def, width)                                         \
   case def:                                                                    \
@@ -2668,6 +2670,27 @@ Symtab *ObjectFileELF::GetSymtab() {
           section_list->FindSectionByType(eSectionTypeELFDynamicSymbols, true)
               .get();
     }
+
+    // A cached symbol table comes with its name and address indexes, so
+    // neither parsing nor demangling is needed. It belongs to the same object
+    // file as the table parsed below.
+    ObjectFile *symtab_objfile = this;
+    if (symtab) {
+      symtab_objfile = symtab->GetObjectFile();
+    } else if (const ELFDynamic *jmprel = FindDynamicSymbol(DT_JMPREL)) {
+      if (Section *reloc_section =
+              section_list->FindSectionContainingFileAddress(jmprel->d_ptr)
+                  .get())
+        symtab_objfile = reloc_section->GetObjectFile();
+    }
+    auto cached_symtab_up = std::make_unique<Symtab>(symtab_objfile);
+    std::string cached_data;
+    if (cached_symtab_up->LoadFromCache(*this, &cached_data) &&
+        DecodeSymtabCacheData(cached_data)) {
+      m_symtab_up = std::move(cached_symtab_up);
+      return m_symtab_up.get();
+    }
+
     if (symtab) {
       m_symtab_up.reset(new Symtab(symtab->GetObjectFile()));
       symbol_id += ParseSymbolTable(m_symtab_up.get(), symbol_id, symtab);
@@ -2715,11 +2738,47 @@ Symtab *ObjectFileELF::GetSymtab() {
       m_symtab_up.reset(new Symtab(this));
 
     m_symtab_up->CalculateSymbolSizes();
+    m_symtab_up->SaveToCache(*this, EncodeSymtabCacheData());
   }
 
   return m_symtab_up.get();
 }
 
+std::string ObjectFileELF::EncodeSymtabCacheData() const {
+  namespace endian = llvm::support::endian;
+  using llvm::support::little;
+  std::string data;
+  llvm::raw_string_ostream os(data);
+  endian::write<uint32_t>(os, m_address_class_map.size(), little);
+  for (const auto &entry : m_address_class_map) {
+    endian::write<uint64_t>(os, entry.first, little);
+    endian::write<uint8_t>(os, static_cast<uint8_t>(entry.second), little);
+  }
+  os.flush();
+  return data;
+}
+
+bool ObjectFileELF::DecodeSymtabCacheData(llvm::StringRef data) {
+  DataExtractor extractor(data.data(), data.size(), eByteOrderLittle, 4);
+  lldb::offset_t offset = 0;
+  if (!extractor.ValidOffsetForDataOfSize(offset, 4))
+    return false;
+  const uint32_t num_entries = extractor.GetU32(&offset);
+  if (!extractor.ValidOffsetForDataOfSize(offset, num_entries * 9ull))
+    return false;
+  FileAddressToAddressClassMap address_class_map;
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    const addr_t file_addr = extractor.GetU64(&offset);
+    const uint8_t address_class = extractor.GetU8(&offset);
+    if (address_class > static_cast<uint8_t>(AddressClass::eRuntime))
+      return false;
+    address_class_map.emplace_hint(address_class_map.end(), file_addr,
+                                   static_cast<AddressClass>(address_class));
+  }
+  m_address_class_map = std::move(address_class_map);
+  return true;
+}
+
 void ObjectFileELF::RelocateSection(lldb_private::Section *section)
 {
   static const char *debug_prefix = ".debug";
@@ -280,6 +280,12 @@ private:
                             lldb::user_id_t start_id,
                             lldb_private::Section *symtab);
 
+  /// The address classes ParseSymbolTable() derives from the mapping
+  /// symbols, which are stored alongside the symbol table in the symbol table
+  /// cache.
+  std::string EncodeSymtabCacheData() const;
+  bool DecodeSymtabCacheData(llvm::StringRef data);
+
   /// Helper routine for ParseSymbolTable().
   unsigned ParseSymbols(lldb_private::Symtab *symbol_table,
                         lldb::user_id_t start_id,
@@ -44,7 +44,9 @@
 
 #include "lldb/Host/SafeMachO.h"
 
+#include "llvm/Support/EndianStream.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
 
 #include "ObjectFileMachO.h"
 
@@ -1250,16 +1252,56 @@ Symtab *ObjectFileMachO::GetSymtab() {
   if (module_sp) {
     std::lock_guard<std::recursive_mutex> guard(module_sp->GetMutex());
     if (m_symtab_up == nullptr) {
+      // A cached symbol table comes with its name and address indexes, so
+      // neither parsing nor demangling is needed.
+      auto cached_symtab_up = std::make_unique<Symtab>(this);
+      std::string cached_data;
+      if (cached_symtab_up->LoadFromCache(*this, &cached_data) &&
+          DecodeSymtabCacheData(cached_data)) {
+        m_symtab_up = std::move(cached_symtab_up);
+        return m_symtab_up.get();
+      }
+
       m_symtab_up.reset(new Symtab(this));
       std::lock_guard<std::recursive_mutex> symtab_guard(
           m_symtab_up->GetMutex());
       ParseSymtab();
       m_symtab_up->Finalize();
+      m_symtab_up->SaveToCache(*this, EncodeSymtabCacheData());
     }
   }
   return m_symtab_up.get();
 }
 
+std::string ObjectFileMachO::EncodeSymtabCacheData() const {
+  namespace endian = llvm::support::endian;
+  using llvm::support::little;
+  std::string data;
+  llvm::raw_string_ostream os(data);
+  endian::write<uint8_t>(os, m_allow_assembly_emulation_unwind_plans, little);
+  endian::write<uint32_t>(os, m_reexported_dylibs.GetSize(), little);
+  for (size_t i = 0; i < m_reexported_dylibs.GetSize(); ++i)
+    os << m_reexported_dylibs.GetFileSpecAtIndex(i).GetPath() << '\0';
+  os.flush();
+  return data;
+}
+
+bool ObjectFileMachO::DecodeSymtabCacheData(llvm::StringRef data) {
+  DataExtractor extractor(data.data(), data.size(), eByteOrderLittle, 4);
+  lldb::offset_t offset = 0;
+  if (!extractor.ValidOffsetForDataOfSize(offset, 5))
+    return false;
+  m_allow_assembly_emulation_unwind_plans = extractor.GetU8(&offset) != 0;
+  const uint32_t num_reexported_dylibs = extractor.GetU32(&offset);
+  for (uint32_t i = 0; i < num_reexported_dylibs; ++i) {
+    const char *path = extractor.GetCStr(&offset);
+    if (!path)
+      return false;
+    m_reexported_dylibs.AppendIfUnique(FileSpec(path));
+  }
+  return true;
+}
+
 bool ObjectFileMachO::IsStripped() {
   if (m_dysymtab.cmd == 0) {
     ModuleSP module_sp(GetModule());
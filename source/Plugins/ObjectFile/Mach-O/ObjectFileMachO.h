@@ -193,6 +193,11 @@ protected:
 
   size_t ParseSymtab();
 
+  // The state ParseSymtab() sets up besides the symbol table, which is stored
+  // alongside the symbol table in the symbol table cache.
+  std::string EncodeSymtabCacheData() const;
+  bool DecodeSymtabCacheData(llvm::StringRef data);
+
   typedef lldb_private::RangeArray<uint32_t, uint32_t, 8> EncryptedFileRanges;
   EncryptedFileRanges GetEncryptedFileRanges();
 
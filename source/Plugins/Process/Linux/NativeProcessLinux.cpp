@@ -9,6 +9,7 @@
 #include "NativeProcessLinux.h"
 
 #include <errno.h>
+#include <limits.h>
 #include <stdint.h>
 #include <string.h>
 #include <unistd.h>
@@ -257,7 +258,7 @@ NativeProcessLinux::Factory::Launch(ProcessLaunchInfo &launch_info,
 
   return std::unique_ptr<NativeProcessLinux>(new NativeProcessLinux(
       pid, launch_info.GetPTY().ReleaseMasterFileDescriptor(), native_delegate,
-      Info.GetArchitecture(), mainloop, {pid}));
+      Info.GetArchitecture(), mainloop, {pid}, /*seized=*/false));
 }
 
 llvm::Expected<std::unique_ptr<NativeProcessProtocol>>
@@ -274,12 +275,14 @@ NativeProcessLinux::Factory::Attach(
                                          llvm::inconvertibleErrorCode());
   }
 
-  auto tids_or = NativeProcessLinux::Attach(pid);
+  bool seized = false;
+  auto tids_or = NativeProcessLinux::Attach(pid, seized);
   if (!tids_or)
     return tids_or.takeError();
 
-  return std::unique_ptr<NativeProcessLinux>(new NativeProcessLinux(
-      pid, -1, native_delegate, Info.GetArchitecture(), mainloop, *tids_or));
+  return std::unique_ptr<NativeProcessLinux>(
+      new NativeProcessLinux(pid, -1, native_delegate, Info.GetArchitecture(),
+                             mainloop, *tids_or, seized));
 }
 
 // Public Instance Methods
@@ -287,8 +290,10 @@ NativeProcessLinux::Factory::Attach(
 NativeProcessLinux::NativeProcessLinux(::pid_t pid, int terminal_fd,
                                        NativeDelegate &delegate,
                                        const ArchSpec &arch, MainLoop &mainloop,
-                                       llvm::ArrayRef<::pid_t> tids)
-    : NativeProcessELF(pid, terminal_fd, delegate), m_arch(arch) {
+                                       llvm::ArrayRef<::pid_t> tids,
+                                       bool seized)
+    : NativeProcessELF(pid, terminal_fd, delegate), m_arch(arch),
+      m_seized(seized) {
   if (m_terminal_fd != -1) {
     Status status = EnsureFDFlags(m_terminal_fd, O_NONBLOCK);
     assert(status.Success());
@@ -313,9 +318,16 @@ NativeProcessLinux::NativeProcessLinux(::pid_t pid, int terminal_fd,
   SigchldHandler();
 }
 
-llvm::Expected<std::vector<::pid_t>> NativeProcessLinux::Attach(::pid_t pid) {
+llvm::Expected<std::vector<::pid_t>> NativeProcessLinux::Attach(::pid_t pid,
+                                                               bool &seized) {
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
 
+  // Prefer PTRACE_SEIZE over PTRACE_ATTACH. It lets us stop the threads with
+  // PTRACE_INTERRUPT instead of sending each of them a SIGSTOP. Threads
+  // created later inherit the mode of the thread that created them.
+  seized = true;
+  bool attached_any = false;
+
   Status status;
   // Use a map to keep track of the threads which we have attached/need to
   // attach.
@@ -326,9 +338,23 @@ llvm::Expected<std::vector<::pid_t>> NativeProcessLinux::Attach(::pid_t pid) {
       if (it->second == false) {
         lldb::tid_t tid = it->first;
 
+        if (seized) {
+          status = PtraceWrapper(PTRACE_SEIZE, tid, nullptr,
+                                 reinterpret_cast<void *>(GetDefaultPtraceOpts()));
+          if (status.GetError() == EIO && !attached_any) {
+            LLDB_LOG(log, "PTRACE_SEIZE not supported, using PTRACE_ATTACH");
+            seized = false;
+          } else if (status.Success()) {
+            // Stop the seized thread, it will report a PTRACE_EVENT_STOP.
+            status = PtraceWrapper(PTRACE_INTERRUPT, tid);
+          }
+        }
+
         // Attach to the requested process.
         // An attach will cause the thread to stop with a SIGSTOP.
-        if ((status = PtraceWrapper(PTRACE_ATTACH, tid)).Fail()) {
+        if (!seized)
+          status = PtraceWrapper(PTRACE_ATTACH, tid);
+        if (status.Fail()) {
           // No such thread. The thread may have exited. More error handling
           // may be needed.
           if (status.GetError() == ESRCH) {
@@ -353,11 +379,12 @@ llvm::Expected<std::vector<::pid_t>> NativeProcessLinux::Attach(::pid_t pid) {
               std::error_code(errno, std::generic_category()));
         }
 
-        if ((status = SetDefaultPtraceOpts(tid)).Fail())
+        if (!seized && (status = SetDefaultPtraceOpts(tid)).Fail())
           return status.ToError();
 
         LLDB_LOG(log, "adding tid = {0}", tid);
         it->second = true;
+        attached_any = true;
       }
 
       // move the loop forward
@@ -377,7 +404,7 @@ llvm::Expected<std::vector<::pid_t>> NativeProcessLinux::Attach(::pid_t pid) {
   return std::move(tids);
 }
 
-Status NativeProcessLinux::SetDefaultPtraceOpts(lldb::pid_t pid) {
+long NativeProcessLinux::GetDefaultPtraceOpts() {
   long ptrace_opts = 0;
 
   // Have the child raise an event on exit.  This is used to keep the child in
@@ -393,7 +420,12 @@ Status NativeProcessLinux::SetDefaultPtraceOpts(lldb::pid_t pid) {
   // SIGTRAP generation)
   ptrace_opts |= PTRACE_O_TRACEEXEC;
 
-  return PtraceWrapper(PTRACE_SETOPTIONS, pid, nullptr, (void *)ptrace_opts);
+  return ptrace_opts;
+}
+
+Status NativeProcessLinux::SetDefaultPtraceOpts(lldb::pid_t pid) {
+  return PtraceWrapper(PTRACE_SETOPTIONS, pid, nullptr,
+                       (void *)GetDefaultPtraceOpts());
 }
 
 // Handles all waitpid events from the inferior process.
@@ -454,15 +486,22 @@ void NativeProcessLinux::MonitorCallback(lldb::pid_t pid, bool exited,
     return;
   }
 
+  // Seized threads report group stops as a PTRACE_EVENT_STOP with the
+  // stopping signal, for other threads PTRACE_GETSIGINFO fails with EINVAL.
+  const bool is_group_stop =
+      info_err.Success()
+          ? (info.si_code >> 8) == PTRACE_EVENT_STOP && info.si_signo != SIGTRAP
+          : info_err.GetError() == EINVAL;
+
   // Get details on the signal raised.
-  if (info_err.Success()) {
+  if (info_err.Success() && !is_group_stop) {
     // We have retrieved the signal info.  Dispatch appropriately.
     if (info.si_signo == SIGTRAP)
       MonitorSIGTRAP(info, *thread_sp);
     else
       MonitorSignal(info, *thread_sp, exited);
   } else {
-    if (info_err.GetError() == EINVAL) {
+    if (is_group_stop) {
       // This is a group stop reception for this tid. We can reach here if we
       // reinject SIGSTOP, SIGSTP, SIGTTIN or SIGTTOU into the tracee,
       // triggering the group-stop mechanism. Normally receiving these would
@@ -529,7 +568,12 @@ void NativeProcessLinux::WaitForNewThread(::pid_t tid) {
            "received thread creation event for tid {0}. tid not tracked "
            "yet, waiting for thread to appear...",
            tid);
-  ::pid_t wait_pid = llvm::sys::RetryAfterSignal(-1, ::waitpid, tid, &status, __WALL);
+  // The creation event may have been reaped along with the event we are
+  // handling now.
+  ::pid_t wait_pid = tid;
+  if (!TakePendingWaitStatus(tid, status))
+    wait_pid =
+        llvm::sys::RetryAfterSignal(-1, ::waitpid, tid, &status, __WALL);
   // Since we are waiting on a specific tid, this must be the creation event.
   // But let's do some checks just in case.
   if (wait_pid != tid) {
@@ -599,9 +643,8 @@ void NativeProcessLinux::MonitorSIGTRAP(const siginfo_t &info,
     // which only copies the main thread.
     LLDB_LOG(log, "exec received, stop tracking all but main thread");
 
-    llvm::erase_if(m_threads, [&](std::unique_ptr<NativeThreadProtocol> &t) {
-      return t->GetID() != GetID();
-    });
+    RemoveThreads(
+        [&](NativeThreadLinux &thread) { return thread.GetID() != GetID(); });
     assert(m_threads.size() == 1);
     auto *main_thread = static_cast<NativeThreadLinux *>(m_threads[0].get());
 
@@ -620,6 +663,11 @@ void NativeProcessLinux::MonitorSIGTRAP(const siginfo_t &info,
     break;
   }
 
+  case (SIGTRAP | (PTRACE_EVENT_STOP << 8)):
+    // A seized thread stopped because of PTRACE_INTERRUPT.
+    MonitorStopRequest(info, thread);
+    break;
+
   case (SIGTRAP | (PTRACE_EVENT_EXIT << 8)): {
     // The inferior process or one of its threads is about to exit. We don't
     // want to do anything with the thread so we just resume it. In case we
@@ -738,21 +786,62 @@ void NativeProcessLinux::MonitorTrace(NativeThreadLinux &thread) {
   // This thread is currently stopped.
   thread.SetStoppedByTrace();
 
+  if (MonitorStepOver(thread))
+    return;
+
   StopRunningThreads(thread.GetID());
 }
 
+bool NativeProcessLinux::MonitorStepOver(NativeThreadLinux &thread) {
+  if (thread.GetID() != m_step_over_tid || !m_step_over_started)
+    return false;
+
+  if (m_pending_notification_tid == LLDB_INVALID_THREAD_ID) {
+    FinishStepOver();
+    return true;
+  }
+  // The step was cancelled by another stop. It is not a stop reason of its
+  // own.
+  thread.SetStoppedWithNoReason();
+  m_step_over_tid = LLDB_INVALID_THREAD_ID;
+  SignalIfAllThreadsStopped();
+  return true;
+}
+
 void NativeProcessLinux::MonitorBreakpoint(NativeThreadLinux &thread) {
   Log *log(
       GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
   LLDB_LOG(log, "received breakpoint event, pid = {0}", thread.GetID());
 
+  const bool was_stepping = thread.GetState() == eStateStepping;
+
   // Mark the thread as stopped at breakpoint.
   thread.SetStoppedByBreakpoint();
   FixupBreakpointPCAsNeeded(thread);
 
   if (m_threads_stepping_with_breakpoint.find(thread.GetID()) !=
-      m_threads_stepping_with_breakpoint.end())
+      m_threads_stepping_with_breakpoint.end()) {
     thread.SetStoppedByTrace();
+    if (MonitorStepOver(thread))
+      return;
+  } else if (!was_stepping && !m_non_stop_mode &&
+             SupportHardwareSingleStepping() &&
+             m_pending_notification_tid == LLDB_INVALID_THREAD_ID) {
+    // Hits of a breakpoint whose conditions are all false are not reported.
+    // Hits while stepping are, as the client is waiting for the step.
+    const lldb::addr_t pc = thread.GetRegisterContext().GetPC();
+    if (!ShouldReportBreakpointHit(thread, pc)) {
+      if (m_step_over_tid == LLDB_INVALID_THREAD_ID) {
+        StepOverBreakpoint(thread, pc);
+      } else {
+        // The thread hit the breakpoint while being stopped for another
+        // thread's step. It hits it again once it is resumed.
+        thread.SetStoppedWithNoReason();
+        HoldForStepOver(thread);
+      }
+      return;
+    }
+  }
 
   StopRunningThreads(thread.GetID());
 }
@@ -773,6 +862,61 @@ void NativeProcessLinux::MonitorWatchpoint(NativeThreadLinux &thread,
   StopRunningThreads(thread.GetID());
 }
 
+void NativeProcessLinux::MonitorStopRequest(const siginfo_t &info,
+                                            NativeThreadLinux &thread) {
+  Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
+  LLDB_LOG(log, "pid {0} tid {1}, thread stopped", GetID(), thread.GetID());
+
+  // Check that we're not already marked with a stop reason. Note this thread
+  // really shouldn't already be marked as stopped - if we were, that would
+  // imply that the kernel signaled us with the thread stopping which we
+  // handled and marked as stopped, and that, without an intervening resume,
+  // we received another stop.  It is more likely that we are missing the
+  // marking of a run state somewhere if we find that the thread was marked
+  // as stopped.
+  const StateType thread_state = thread.GetState();
+  if (!StateIsStoppedState(thread_state, false)) {
+    // An inferior thread has stopped because of a stop request we have sent
+    // it. Generally, these are not important stops and we don't want to
+    // report them as they are just used to stop other threads when one thread
+    // (the one with the *real* stop reason) hits a breakpoint (watchpoint,
+    // etc...). However, in the case of an asynchronous Interrupt(), this *is*
+    // the real stop reason, so we leave the signal intact if this is the
+    // thread that was chosen as the triggering thread.
+    if (m_non_stop_mode && m_stop_requested_tids.count(thread.GetID())) {
+      // In non-stop mode the thread was stopped on its own and the stop is
+      // reported right away.
+      thread.SetStoppedWithNoReason();
+      ReportThreadStop(thread);
+    } else if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID) {
+      if (m_pending_notification_tid == thread.GetID())
+        thread.SetStoppedBySignal(SIGSTOP, &info);
+      else
+        thread.SetStoppedWithNoReason();
+
+      SetCurrentThreadID(thread.GetID());
+      SignalIfAllThreadsStopped();
+    } else if (m_step_over_tid != LLDB_INVALID_THREAD_ID) {
+      // Stopped so that another thread can step over a breakpoint.
+      thread.SetStoppedWithNoReason();
+      HoldForStepOver(thread);
+    } else {
+      // We can end up here if stop was initiated by LLGS but by this time a
+      // thread stop has occurred - maybe initiated by another event.
+      Status error = ResumeThread(thread, thread.GetState(), 0);
+      if (error.Fail())
+        LLDB_LOG(log, "failed to resume thread {0}: {1}", thread.GetID(),
+                 error);
+    }
+  } else {
+    LLDB_LOG(log,
+             "pid {0} tid {1}, thread was already marked as a stopped "
+             "state (state={2}), leaving stop signal as is",
+             GetID(), thread.GetID(), thread_state);
+    SignalIfAllThreadsStopped();
+  }
+}
+
 void NativeProcessLinux::MonitorSignal(const siginfo_t &info,
                                        NativeThreadLinux &thread, bool exited) {
   const int signo = info.si_signo;
@@ -799,49 +943,7 @@ void NativeProcessLinux::MonitorSignal(const siginfo_t &info,
   // Check for thread stop notification.
   if (is_from_llgs && (info.si_code == SI_TKILL) && (signo == SIGSTOP)) {
     // This is a tgkill()-based stop.
-    LLDB_LOG(log, "pid {0} tid {1}, thread stopped", GetID(), thread.GetID());
-
-    // Check that we're not already marked with a stop reason. Note this thread
-    // really shouldn't already be marked as stopped - if we were, that would
-    // imply that the kernel signaled us with the thread stopping which we
-    // handled and marked as stopped, and that, without an intervening resume,
-    // we received another stop.  It is more likely that we are missing the
-    // marking of a run state somewhere if we find that the thread was marked
-    // as stopped.
-    const StateType thread_state = thread.GetState();
-    if (!StateIsStoppedState(thread_state, false)) {
-      // An inferior thread has stopped because of a SIGSTOP we have sent it.
-      // Generally, these are not important stops and we don't want to report
-      // them as they are just used to stop other threads when one thread (the
-      // one with the *real* stop reason) hits a breakpoint (watchpoint,
-      // etc...). However, in the case of an asynchronous Interrupt(), this
-      // *is* the real stop reason, so we leave the signal intact if this is
-      // the thread that was chosen as the triggering thread.
-      if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID) {
-        if (m_pending_notification_tid == thread.GetID())
-          thread.SetStoppedBySignal(SIGSTOP, &info);
-        else
-          thread.SetStoppedWithNoReason();
-
-        SetCurrentThreadID(thread.GetID());
-        SignalIfAllThreadsStopped();
-      } else {
-        // We can end up here if stop was initiated by LLGS but by this time a
-        // thread stop has occurred - maybe initiated by another event.
-        Status error = ResumeThread(thread, thread.GetState(), 0);
-        if (error.Fail())
-          LLDB_LOG(log, "failed to resume thread {0}: {1}", thread.GetID(),
-                   error);
-      }
-    } else {
-      LLDB_LOG(log,
-               "pid {0} tid {1}, thread was already marked as a stopped "
-               "state (state={2}), leaving stop signal as is",
-               GetID(), thread.GetID(), thread_state);
-      SignalIfAllThreadsStopped();
-    }
-
-    // Done handling.
+    MonitorStopRequest(info, thread);
     return;
   }
 
@@ -1029,6 +1131,201 @@ bool NativeProcessLinux::SupportHardwareSingleStepping() const {
   return true;
 }
 
+void NativeProcessLinux::StepOverBreakpoint(NativeThreadLinux &thread,
+                                            lldb::addr_t addr,
+                                            lldb::StateType state, int signo) {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+  LLDB_LOG(log, "pid {0} tid {1}: stepping over breakpoint at {2:x}", GetID(),
+           thread.GetID(), addr);
+
+  assert(m_step_over_tid == LLDB_INVALID_THREAD_ID);
+  m_step_over_tid = thread.GetID();
+  m_step_over_addr = addr;
+  m_step_over_state = state;
+  m_step_over_signo = signo;
+  m_step_over_started = false;
+
+  // The trap opcode is removed during the step, so no other thread may run
+  // meanwhile. Threads that are stopped already were not resumed by the
+  // client, and stay stopped.
+  for (const auto &thread_sp : m_threads) {
+    if (!StateIsRunningState(thread_sp->GetState()))
+      continue;
+    m_step_over_held_tids.push_back(thread_sp->GetID());
+    static_cast<NativeThreadLinux *>(thread_sp.get())->RequestStop();
+  }
+
+  MaybeStartStepOver();
+}
+
+bool NativeProcessLinux::StepOverBreakpointForResume(NativeThreadLinux &thread,
+                                                     lldb::StateType state,
+                                                     int signo) {
+  // While another thread steps over a breakpoint, a trap opcode is missing
+  // and the thread has to wait for its turn.
+  if (m_step_over_tid != LLDB_INVALID_THREAD_ID) {
+    m_pending_step_overs.push_back({thread.GetID(), state, signo});
+    return true;
+  }
+
+  const lldb::addr_t pc = thread.GetRegisterContext().GetPC();
+  if (m_software_breakpoints.count(pc) == 0)
+    return false;
+  StepOverBreakpoint(thread, pc, state, signo);
+  return true;
+}
+
+void NativeProcessLinux::HoldForStepOver(NativeThreadLinux &thread) {
+  if (!llvm::is_contained(m_step_over_held_tids, thread.GetID()))
+    m_step_over_held_tids.push_back(thread.GetID());
+  MaybeStartStepOver();
+}
+
+bool NativeProcessLinux::IsInStepOver(lldb::tid_t tid) const {
+  if (tid == m_step_over_tid || llvm::is_contained(m_step_over_held_tids, tid))
+    return true;
+  return llvm::any_of(m_pending_step_overs, [tid](const PendingStepOver &p) {
+    return p.tid == tid;
+  });
+}
+
+void NativeProcessLinux::MaybeStartStepOver() {
+  if (m_step_over_tid == LLDB_INVALID_THREAD_ID ||
+      m_step_over_started || m_num_running_threads > 0)
+    return;
+
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+  NativeThreadLinux *thread = GetThreadByID(m_step_over_tid);
+  auto bp_it = m_software_breakpoints.find(m_step_over_addr);
+  Status error;
+  if (thread && bp_it != m_software_breakpoints.end()) {
+    const auto &saved = bp_it->second.saved_opcodes;
+    size_t bytes_written = 0;
+    error = WriteMemory(m_step_over_addr, saved.data(), saved.size(),
+                        bytes_written);
+    if (error.Success() && !SupportHardwareSingleStepping() &&
+        m_threads_stepping_with_breakpoint.count(thread->GetID()) == 0)
+      error = SetupSoftwareSingleStepping(*thread);
+    if (error.Success()) {
+      m_step_over_started = true;
+      error = ResumeThread(*thread, eStateStepping, m_step_over_signo);
+      if (error.Success())
+        return;
+      RestoreStepOverTrap();
+      m_step_over_started = false;
+    }
+  }
+
+  if (!thread) {
+    // The thread exited meanwhile, there is nothing left to step.
+    FinishStepOver();
+    return;
+  }
+
+  LLDB_LOG(log, "pid {0}: cannot step over breakpoint at {1:x}: {2}", GetID(),
+           m_step_over_addr, error);
+  if (m_non_stop_mode) {
+    // The thread stays where it is and its stop is reported.
+    thread->SetStoppedWithNoReason();
+    m_step_over_state = eStateStopped;
+    FinishStepOver();
+    return;
+  }
+  // The hit is reported as if the conditions were true.
+  StopRunningThreads(m_step_over_tid);
+}
+
+void NativeProcessLinux::FinishStepOver() {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+  LLDB_LOG(log, "pid {0} tid {1}: stepped over breakpoint at {2:x}", GetID(),
+           m_step_over_tid, m_step_over_addr);
+
+  RestoreStepOverTrap();
+  RemoveSteppingBreakpoint(m_step_over_tid);
+
+  const lldb::tid_t step_tid = m_step_over_tid;
+  const lldb::StateType step_state = m_step_over_state;
+  std::vector<lldb::tid_t> held_tids;
+  held_tids.swap(m_step_over_held_tids);
+  m_step_over_tid = LLDB_INVALID_THREAD_ID;
+  m_step_over_state = eStateRunning;
+  m_step_over_signo = LLDB_INVALID_SIGNAL_NUMBER;
+  m_step_over_started = false;
+
+  if (NativeThreadLinux *step_thread = GetThreadByID(step_tid)) {
+    if (step_state == eStateRunning) {
+      held_tids.push_back(step_tid);
+    } else {
+      if (step_state == eStateStopped)
+        step_thread->SetStoppedWithNoReason();
+      ReportThreadStop(*step_thread);
+    }
+  }
+
+  // The next thread waiting to be stepped over a breakpoint is stepped while
+  // the others are still held.
+  while (!m_pending_step_overs.empty()) {
+    const PendingStepOver next = m_pending_step_overs.front();
+    m_pending_step_overs.erase(m_pending_step_overs.begin());
+    NativeThreadLinux *next_thread = GetThreadByID(next.tid);
+    if (!next_thread)
+      continue;
+    const lldb::addr_t pc = next_thread->GetRegisterContext().GetPC();
+    if (m_software_breakpoints.count(pc) == 0) {
+      Status error = ResumeThread(*next_thread, next.state, next.signo);
+      if (error.Fail())
+        LLDB_LOG(log, "failed to resume thread {0}: {1}", next.tid, error);
+      continue;
+    }
+    m_step_over_held_tids = std::move(held_tids);
+    StepOverBreakpoint(*next_thread, pc, next.state, next.signo);
+    return;
+  }
+
+  for (lldb::tid_t tid : held_tids) {
+    NativeThreadLinux *held_thread = GetThreadByID(tid);
+    if (!held_thread || StateIsRunningState(held_thread->GetState()))
+      continue;
+    Status error =
+        ResumeThread(*held_thread, eStateRunning, LLDB_INVALID_SIGNAL_NUMBER);
+    if (error.Fail())
+      LLDB_LOG(log, "failed to resume thread {0}: {1}", tid, error);
+  }
+}
+
+void NativeProcessLinux::CancelStepOver() {
+  if (m_step_over_tid == LLDB_INVALID_THREAD_ID)
+    return;
+
+  RestoreStepOverTrap();
+  m_step_over_held_tids.clear();
+  // A thread that is still stepping keeps its id, so that the end of the step
+  // is not reported as a stop reason.
+  if (!m_step_over_started)
+    m_step_over_tid = LLDB_INVALID_THREAD_ID;
+}
+
+void NativeProcessLinux::RestoreStepOverTrap() {
+  if (m_step_over_addr == LLDB_INVALID_ADDRESS)
+    return;
+  const lldb::addr_t addr = m_step_over_addr;
+  m_step_over_addr = LLDB_INVALID_ADDRESS;
+  if (!m_step_over_started)
+    return;
+
+  auto bp_it = m_software_breakpoints.find(addr);
+  if (bp_it == m_software_breakpoints.end())
+    return;
+  const auto &trap = bp_it->second.breakpoint_opcodes;
+  size_t bytes_written = 0;
+  Status error = WriteMemory(addr, trap.data(), trap.size(), bytes_written);
+  if (error.Fail()) {
+    Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+    LLDB_LOG(log, "pid {0}: failed to restore breakpoint at {1:x}: {2}",
+             GetID(), addr, error);
+  }
+}
+
 Status NativeProcessLinux::Resume(const ResumeActionList &resume_actions) {
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
   LLDB_LOG(log, "pid {0}", GetID());
@@ -1043,6 +1340,9 @@ Status NativeProcessLinux::Resume(const ResumeActionList &resume_actions) {
           resume_actions.GetActionForThread(thread->GetID(), true);
       if (action == nullptr)
         continue;
+      if (m_non_stop_mode && (StateIsRunningState(thread->GetState()) ||
+                              IsInStepOver(thread->GetID())))
+        continue;
 
       if (action->state == eStateStepping) {
         Status error = SetupSoftwareSingleStepping(
@@ -1071,15 +1371,44 @@ Status NativeProcessLinux::Resume(const ResumeActionList &resume_actions) {
     switch (action->state) {
     case eStateRunning:
     case eStateStepping: {
+      // In non-stop mode, actions that apply to all threads leave the threads
+      // that are still running alone.
+      if (m_non_stop_mode && (StateIsRunningState(thread->GetState()) ||
+                              IsInStepOver(thread->GetID())))
+        break;
+
       // Run the thread, possibly feeding it the signal.
       const int signo = action->signal;
+
+      // In non-stop mode the other threads keep running. If the client
+      // removed the breakpoint to step over it, they could run past it
+      // without hitting it meanwhile. The breakpoint is stepped over here
+      // instead, with all other threads held.
+      if (m_non_stop_mode &&
+          StepOverBreakpointForResume(
+              static_cast<NativeThreadLinux &>(*thread), action->state, signo))
+        break;
       ResumeThread(static_cast<NativeThreadLinux &>(*thread), action->state,
                    signo);
       break;
     }
 
+    case eStateStopped: {
+      // Stopped threads stay stopped. Only non-stop mode lets a running
+      // thread be stopped on its own.
+      if (!StateIsRunningState(thread->GetState()))
+        break;
+      if (!m_non_stop_mode)
+        return Status("NativeProcessLinux::%s (): stopping running tid "
+                      "%" PRIu64 " requires non-stop mode",
+                      __FUNCTION__, thread->GetID());
+      Status error = StopThread(static_cast<NativeThreadLinux &>(*thread));
+      if (error.Fail())
+        return error;
+      break;
+    }
+
     case eStateSuspended:
-    case eStateStopped:
       llvm_unreachable("Unexpected state");
 
     default:
@@ -1143,6 +1472,16 @@ Status NativeProcessLinux::Interrupt() {
   // chosen thread that will be the stop-reason thread.
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
 
+  // In non-stop mode every running thread reports its own stop.
+  if (m_non_stop_mode) {
+    for (const auto &thread : m_threads) {
+      Status error = StopThread(static_cast<NativeThreadLinux &>(*thread));
+      if (error.Fail())
+        return error;
+    }
+    return Status();
+  }
+
   NativeThreadProtocol *running_thread = nullptr;
   NativeThreadProtocol *stopped_thread = nullptr;
 
@@ -1181,6 +1520,14 @@ Status NativeProcessLinux::Interrupt() {
   return Status();
 }
 
+Status NativeProcessLinux::SetNonStopMode(bool enabled) {
+  if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+    return Status("cannot change the stop mode while a stop is pending");
+  m_non_stop_mode = enabled;
+  m_stop_requested_tids.clear();
+  return Status();
+}
+
 Status NativeProcessLinux::Kill() {
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
   LLDB_LOG(log, "pid {0}", GetID());
@@ -1469,7 +1816,8 @@ Status NativeProcessLinux::ReadMemory(lldb::addr_t addr, void *buf, size_t size,
 
   for (bytes_read = 0; bytes_read < size; bytes_read += remainder) {
     Status error = NativeProcessLinux::PtraceWrapper(
-        PTRACE_PEEKDATA, GetID(), (void *)addr, nullptr, 0, &data);
+        PTRACE_PEEKDATA, GetMemoryAccessTID(), (void *)addr, nullptr, 0,
+        &data);
     if (error.Fail())
       return error;
 
@@ -1486,6 +1834,67 @@ Status NativeProcessLinux::ReadMemory(lldb::addr_t addr, void *buf, size_t size,
   return Status();
 }
 
+void NativeProcessLinux::ReadMemoryRanges(
+    llvm::ArrayRef<MemoryRange> ranges, void *buf,
+    llvm::MutableArrayRef<size_t> bytes_read) {
+  if (!ProcessVmReadvSupported()) {
+    NativeProcessProtocol::ReadMemoryRanges(ranges, buf, bytes_read);
+    return;
+  }
+
+  Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
+  const ::pid_t pid = GetID();
+  uint8_t *dst = static_cast<uint8_t *>(buf);
+  std::vector<struct iovec> local_iovs;
+  std::vector<struct iovec> remote_iovs;
+
+  size_t first = 0;
+  while (first < ranges.size()) {
+    const size_t count = std::min<size_t>(ranges.size() - first, IOV_MAX);
+    local_iovs.resize(count);
+    remote_iovs.resize(count);
+    uint8_t *range_dst = dst;
+    for (size_t i = 0; i < count; ++i) {
+      const MemoryRange &range = ranges[first + i];
+      local_iovs[i].iov_base = range_dst;
+      local_iovs[i].iov_len = range.GetByteSize();
+      remote_iovs[i].iov_base = reinterpret_cast<void *>(range.GetRangeBase());
+      remote_iovs[i].iov_len = range.GetByteSize();
+      range_dst += range.GetByteSize();
+    }
+
+    ssize_t result = process_vm_readv(pid, local_iovs.data(), count,
+                                      remote_iovs.data(), count, 0);
+    LLDB_LOG(log,
+             "using process_vm_readv to read {0} ranges from inferior: {1}",
+             count, result < 0 ? llvm::sys::StrError(errno) : "Success");
+
+    // The ranges are read in order until the first one that can't be read
+    // completely.
+    size_t remaining = result < 0 ? 0 : result;
+    size_t i = 0;
+    for (; i < count && remaining >= ranges[first + i].GetByteSize(); ++i) {
+      bytes_read[first + i] = ranges[first + i].GetByteSize();
+      remaining -= ranges[first + i].GetByteSize();
+      dst += ranges[first + i].GetByteSize();
+    }
+    first += i;
+    if (i == count)
+      continue;
+
+    // Read the failed range on its own, which falls back to ptrace, and
+    // continue after it.
+    const MemoryRange &range = ranges[first];
+    Status error =
+        ReadMemory(range.GetRangeBase(), dst, range.GetByteSize(),
+                   bytes_read[first]);
+    if (error.Fail())
+      bytes_read[first] = 0;
+    dst += range.GetByteSize();
+    ++first;
+  }
+}
+
 Status NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf,
                                        size_t size, size_t &bytes_written) {
   const unsigned char *src = static_cast<const unsigned char *>(buf);
@@ -1504,8 +1913,8 @@ Status NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf,
       memcpy(&data, src, k_ptrace_word_size);
 
       LLDB_LOG(log, "[{0:x}]:{1:x}", addr, data);
-      error = NativeProcessLinux::PtraceWrapper(PTRACE_POKEDATA, GetID(),
-                                                (void *)addr, (void *)data);
+      error = NativeProcessLinux::PtraceWrapper(
+          PTRACE_POKEDATA, GetMemoryAccessTID(), (void *)addr, (void *)data);
       if (error.Fail())
         return error;
     } else {
@@ -1532,6 +1941,22 @@ Status NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf,
   return error;
 }
 
+::pid_t NativeProcessLinux::GetMemoryAccessTID() {
+  if (m_num_running_threads == 0)
+    return GetID();
+
+  NativeThreadLinux *main_thread = GetThreadByID(GetID());
+  if (main_thread && !StateIsRunningState(main_thread->GetState()))
+    return GetID();
+  for (const auto &thread : m_threads) {
+    if (!StateIsRunningState(thread->GetState()))
+      return thread->GetID();
+  }
+  // Nothing is stopped, the access will fail with the error of the main
+  // thread.
+  return GetID();
+}
+
 Status NativeProcessLinux::GetSignalInfo(lldb::tid_t tid, void *siginfo) {
   return PtraceWrapper(PTRACE_GETSIGINFO, tid, nullptr, siginfo);
 }
@@ -1549,37 +1974,42 @@ Status NativeProcessLinux::Detach(lldb::tid_t tid) {
 }
 
 bool NativeProcessLinux::HasThreadNoLock(lldb::tid_t thread_id) {
-  for (const auto &thread : m_threads) {
-    assert(thread && "thread list should not contain NULL threads");
-    if (thread->GetID() == thread_id) {
-      // We have this thread.
-      return true;
-    }
-  }
-
-  // We don't have this thread.
-  return false;
+  return m_threads_by_tid.count(thread_id) != 0;
 }
 
 bool NativeProcessLinux::StopTrackingThread(lldb::tid_t thread_id) {
   Log *const log = ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_THREAD);
   LLDB_LOG(log, "tid: {0})", thread_id);
 
-  bool found = false;
-  for (auto it = m_threads.begin(); it != m_threads.end(); ++it) {
-    if (*it && ((*it)->GetID() == thread_id)) {
-      m_threads.erase(it);
-      found = true;
-      break;
-    }
-  }
-
-  if (found)
+  bool found = HasThreadNoLock(thread_id);
+  if (found) {
+    RemoveThreads([thread_id](NativeThreadLinux &thread) {
+      return thread.GetID() == thread_id;
+    });
     StopTracingForThread(thread_id);
+    m_stop_requested_tids.erase(thread_id);
+  }
+  if (thread_id == m_step_over_tid && m_step_over_started &&
+      m_pending_notification_tid == LLDB_INVALID_THREAD_ID)
+    FinishStepOver();
+  else
+    MaybeStartStepOver();
   SignalIfAllThreadsStopped();
   return found;
 }
 
+void NativeProcessLinux::RemoveThreads(
+    llvm::function_ref<bool(NativeThreadLinux &)> pred) {
+  llvm::erase_if(m_threads, [&](std::unique_ptr<NativeThreadProtocol> &t) {
+    auto &thread = static_cast<NativeThreadLinux &>(*t);
+    if (!pred(thread))
+      return false;
+    ThreadStateChanged(thread.GetState(), eStateInvalid);
+    m_threads_by_tid.erase(thread.GetID());
+    return true;
+  });
+}
+
 NativeThreadLinux &NativeProcessLinux::AddThread(lldb::tid_t thread_id) {
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_THREAD));
   LLDB_LOG(log, "pid {0} adding thread with tid {1}", GetID(), thread_id);
@@ -1592,6 +2022,8 @@ NativeThreadLinux &NativeProcessLinux::AddThread(lldb::tid_t thread_id) {
     SetCurrentThreadID(thread_id);
 
   m_threads.push_back(std::make_unique<NativeThreadLinux>(*this, thread_id));
+  auto &thread = static_cast<NativeThreadLinux &>(*m_threads.back());
+  m_threads_by_tid[thread_id] = &thread;
 
   if (m_pt_proces_trace_id != LLDB_INVALID_UID) {
     auto traceMonitor = ProcessorTraceMonitor::Create(
@@ -1607,7 +2039,7 @@ NativeThreadLinux &NativeProcessLinux::AddThread(lldb::tid_t thread_id) {
     }
   }
 
-  return static_cast<NativeThreadLinux &>(*m_threads.back());
+  return thread;
 }
 
 Status NativeProcessLinux::GetLoadedModuleFileSpec(const char *module_path,
@@ -1648,8 +2080,19 @@ Status NativeProcessLinux::GetFileLoadAddress(const llvm::StringRef &file_name,
 }
 
 NativeThreadLinux *NativeProcessLinux::GetThreadByID(lldb::tid_t tid) {
-  return static_cast<NativeThreadLinux *>(
-      NativeProcessProtocol::GetThreadByID(tid));
+  return m_threads_by_tid.lookup(tid);
+}
+
+void NativeProcessLinux::ThreadStateChanged(lldb::StateType old_state,
+                                            lldb::StateType new_state) {
+  const bool was_running = StateIsRunningState(old_state);
+  const bool is_running = StateIsRunningState(new_state);
+  if (is_running && !was_running) {
+    ++m_num_running_threads;
+  } else if (was_running && !is_running) {
+    assert(m_num_running_threads > 0);
+    --m_num_running_threads;
+  }
 }
 
 Status NativeProcessLinux::ResumeThread(NativeThreadLinux &thread,
@@ -1698,6 +2141,16 @@ void NativeProcessLinux::StopRunningThreads(const lldb::tid_t triggering_tid) {
   LLDB_LOG(log, "about to process event: (triggering_tid: {0})",
            triggering_tid);
 
+  if (m_non_stop_mode) {
+    // Only the triggering thread stops, the others keep running.
+    if (NativeThreadLinux *thread = GetThreadByID(triggering_tid))
+      ReportThreadStop(*thread);
+    return;
+  }
+
+  // A stop that is reported ends any step over a conditional breakpoint.
+  CancelStepOver();
+
   m_pending_notification_tid = triggering_tid;
 
   // Request a stop for all the thread stops that need to be stopped and are
@@ -1715,10 +2168,8 @@ void NativeProcessLinux::SignalIfAllThreadsStopped() {
   if (m_pending_notification_tid == LLDB_INVALID_THREAD_ID)
     return; // No pending notification. Nothing to do.
 
-  for (const auto &thread_sp : m_threads) {
-    if (StateIsRunningState(thread_sp->GetState()))
-      return; // Some threads are still running. Don't signal yet.
-  }
+  if (m_num_running_threads > 0)
+    return; // Some threads are still running. Don't signal yet.
 
   // We have a pending notification and all threads have stopped.
   Log *log(
@@ -1734,55 +2185,156 @@ void NativeProcessLinux::SignalIfAllThreadsStopped() {
   }
   m_threads_stepping_with_breakpoint.clear();
 
+  // The thread that stepped over a breakpoint stopped without finishing the
+  // step.
+  m_step_over_tid = LLDB_INVALID_THREAD_ID;
+  m_step_over_started = false;
+  m_step_over_held_tids.clear();
+
   // Notify the delegate about the stop
   SetCurrentThreadID(m_pending_notification_tid);
   SetState(StateType::eStateStopped, true);
   m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
 }
 
+void NativeProcessLinux::ReportThreadStop(NativeThreadLinux &thread) {
+  m_stop_requested_tids.erase(thread.GetID());
+  // A thread held for a step over a breakpoint that stops for a reason of its
+  // own is not resumed at the end of the step.
+  llvm::erase_if(m_step_over_held_tids,
+                 [&thread](lldb::tid_t tid) { return tid == thread.GetID(); });
+
+  RemoveSteppingBreakpoint(thread.GetID());
+
+  SetCurrentThreadID(thread.GetID());
+  // The process only counts as stopped once all of its threads are. The
+  // delegate gets the process state change before the thread stop.
+  if (m_num_running_threads == 0)
+    SetState(StateType::eStateStopped, true);
+  NotifyThreadStopped(thread);
+
+  // The thread may have been the last one a step over a breakpoint waited
+  // for.
+  MaybeStartStepOver();
+}
+
+void NativeProcessLinux::RemoveSteppingBreakpoint(lldb::tid_t tid) {
+  auto stepping_it = m_threads_stepping_with_breakpoint.find(tid);
+  if (stepping_it == m_threads_stepping_with_breakpoint.end())
+    return;
+
+  Log *log(
+      GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+  Status error = RemoveBreakpoint(stepping_it->second);
+  if (error.Fail())
+    LLDB_LOG(log, "pid = {0} remove stepping breakpoint: {1}",
+             stepping_it->first, error);
+  m_threads_stepping_with_breakpoint.erase(stepping_it);
+}
+
+Status NativeProcessLinux::StopThread(NativeThreadLinux &thread) {
+  // Threads involved in a step over a breakpoint are running as far as the
+  // client knows.
+  if (thread.GetID() == m_step_over_tid) {
+    // Reported once the step is done.
+    if (m_step_over_state == eStateRunning)
+      m_step_over_state = eStateStopped;
+    return Status();
+  }
+  auto pending_it = llvm::find_if(
+      m_pending_step_overs,
+      [&thread](const PendingStepOver &p) { return p.tid == thread.GetID(); });
+  if (pending_it != m_pending_step_overs.end() ||
+      llvm::is_contained(m_step_over_held_tids, thread.GetID())) {
+    if (pending_it != m_pending_step_overs.end())
+      m_pending_step_overs.erase(pending_it);
+    thread.SetStoppedWithNoReason();
+    ReportThreadStop(thread);
+    return Status();
+  }
+
+  if (!StateIsRunningState(thread.GetState()) ||
+      m_stop_requested_tids.count(thread.GetID()))
+    return Status();
+
+  Status error = thread.RequestStop();
+  if (error.Success())
+    m_stop_requested_tids.insert(thread.GetID());
+  return error;
+}
+
 void NativeProcessLinux::ThreadWasCreated(NativeThreadLinux &thread) {
   Log *const log = ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_THREAD);
   LLDB_LOG(log, "tid: {0}", thread.GetID());
 
-  if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID &&
+  if ((m_pending_notification_tid != LLDB_INVALID_THREAD_ID ||
+       m_step_over_tid != LLDB_INVALID_THREAD_ID) &&
       StateIsRunningState(thread.GetState())) {
     // We will need to wait for this new thread to stop as well before firing
-    // the notification.
+    // the notification or stepping over a conditional breakpoint.
     thread.RequestStop();
   }
 }
 
 void NativeProcessLinux::SigchldHandler() {
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
-  // Process all pending waitpid notifications.
+  // Process all pending waitpid notifications. When all threads are stopped,
+  // one notification arrives per thread, so reap everything that is pending
+  // before handling any of it.
   while (true) {
-    int status = -1;
-    ::pid_t wait_pid = llvm::sys::RetryAfterSignal(-1, ::waitpid, -1, &status,
-                                          __WALL | __WNOTHREAD | WNOHANG);
+    while (true) {
+      int status = -1;
+      ::pid_t wait_pid = llvm::sys::RetryAfterSignal(
+          -1, ::waitpid, -1, &status, __WALL | __WNOTHREAD | WNOHANG);
 
-    if (wait_pid == 0)
-      break; // We are done.
+      if (wait_pid == 0)
+        break; // Nothing else pending.
 
-    if (wait_pid == -1) {
-      Status error(errno, eErrorTypePOSIX);
-      LLDB_LOG(log, "waitpid (-1, &status, _) failed: {0}", error);
-      break;
+      if (wait_pid == -1) {
+        Status error(errno, eErrorTypePOSIX);
+        LLDB_LOG(log, "waitpid (-1, &status, _) failed: {0}", error);
+        break;
+      }
+      m_pending_wait_statuses.emplace_back(wait_pid, status);
     }
 
-    WaitStatus wait_status = WaitStatus::Decode(status);
-    bool exited = wait_status.type == WaitStatus::Exit ||
-                  (wait_status.type == WaitStatus::Signal &&
-                   wait_pid == static_cast<::pid_t>(GetID()));
+    if (m_pending_wait_statuses.empty())
+      break; // We are done.
 
-    LLDB_LOG(
-        log,
-        "waitpid (-1, &status, _) => pid = {0}, status = {1}, exited = {2}",
-        wait_pid, wait_status, exited);
+    LLDB_LOG(log, "handling {0} wait statuses",
+             m_pending_wait_statuses.size());
+    while (!m_pending_wait_statuses.empty()) {
+      ::pid_t wait_pid = m_pending_wait_statuses.front().first;
+      int status = m_pending_wait_statuses.front().second;
+      m_pending_wait_statuses.pop_front();
+
+      WaitStatus wait_status = WaitStatus::Decode(status);
+      bool exited = wait_status.type == WaitStatus::Exit ||
+                    (wait_status.type == WaitStatus::Signal &&
+                     wait_pid == static_cast<::pid_t>(GetID()));
 
-    MonitorCallback(wait_pid, exited, wait_status);
+      LLDB_LOG(
+          log,
+          "waitpid (-1, &status, _) => pid = {0}, status = {1}, exited = {2}",
+          wait_pid, wait_status, exited);
+
+      MonitorCallback(wait_pid, exited, wait_status);
+    }
   }
 }
 
+bool NativeProcessLinux::TakePendingWaitStatus(::pid_t tid, int &status) {
+  auto pos = llvm::find_if(m_pending_wait_statuses,
+                           [tid](const std::pair<::pid_t, int> &entry) {
+                             return entry.first == tid;
+                           });
+  if (pos == m_pending_wait_statuses.end())
+    return false;
+  status = pos->second;
+  m_pending_wait_statuses.erase(pos);
+  return true;
+}
+
 // Wrapper for ptrace to catch errors and log calls. Note that ptrace sets
 // errno on error because -1 can be a valid result (i.e. for PTRACE_PEEK*)
 Status NativeProcessLinux::PtraceWrapper(int req, lldb::pid_t pid, void *addr,
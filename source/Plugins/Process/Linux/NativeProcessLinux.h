@@ -10,6 +10,7 @@
 #define liblldb_NativeProcessLinux_H_
 
 #include <csignal>
+#include <deque>
 #include <unordered_set>
 
 #include "lldb/Host/Debug.h"
@@ -62,12 +63,17 @@ public:
 
   Status Kill() override;
 
+  Status SetNonStopMode(bool enabled) override;
+
   Status GetMemoryRegionInfo(lldb::addr_t load_addr,
                              MemoryRegionInfo &range_info) override;
 
   Status ReadMemory(lldb::addr_t addr, void *buf, size_t size,
                     size_t &bytes_read) override;
 
+  void ReadMemoryRanges(llvm::ArrayRef<MemoryRange> ranges, void *buf,
+                        llvm::MutableArrayRef<size_t> bytes_read) override;
+
   Status WriteMemory(lldb::addr_t addr, const void *buf, size_t size,
                      size_t &bytes_written) override;
 
@@ -123,6 +129,16 @@ public:
 
   bool SupportHardwareSingleStepping() const;
 
+  // Interface used by NativeThreadLinux.
+
+  /// Return true if the threads were attached with PTRACE_SEIZE and can be
+  /// stopped with PTRACE_INTERRUPT.
+  bool IsSeized() const { return m_seized; }
+
+  /// Keeps track of the number of running threads.
+  void ThreadStateChanged(lldb::StateType old_state,
+                          lldb::StateType new_state);
+
 protected:
   llvm::Expected<llvm::ArrayRef<uint8_t>>
   GetSoftwareBreakpointTrapOpcode(size_t size_hint) override;
@@ -136,17 +152,60 @@ private:
 
   lldb::tid_t m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
 
+  bool m_seized;
+
+  // The threads in m_threads indexed by their tid, and how many of them are
+  // in a running state. Deciding whether a stop can be reported is done for
+  // every thread that stops, so this must not require walking all threads.
+  llvm::DenseMap<lldb::tid_t, NativeThreadLinux *> m_threads_by_tid;
+  size_t m_num_running_threads = 0;
+
+  // Wait statuses reaped by SigchldHandler that are not handled yet.
+  std::deque<std::pair<::pid_t, int>> m_pending_wait_statuses;
+
   // List of thread ids stepping with a breakpoint with the address of
   // the relevan breakpoint
   std::map<lldb::tid_t, lldb::addr_t> m_threads_stepping_with_breakpoint;
 
+  // Threads that were asked to stop by an eStateStopped resume action in
+  // non-stop mode and haven't stopped yet.
+  llvm::DenseSet<lldb::tid_t> m_stop_requested_tids;
+
+  // The thread stepping over a software breakpoint, and the threads that are
+  // held stopped meanwhile so that they can't run past the breakpoint while
+  // its trap opcode is removed. The step skips a breakpoint whose conditions
+  // were all false, or, in non-stop mode, moves a thread that the client
+  // resumed at a breakpoint past it. m_step_over_state says what happens to
+  // the thread after the step: eStateRunning resumes it, eStateStepping
+  // reports the end of the step and eStateStopped reports a stop with no
+  // reason.
+  lldb::tid_t m_step_over_tid = LLDB_INVALID_THREAD_ID;
+  lldb::addr_t m_step_over_addr = LLDB_INVALID_ADDRESS;
+  lldb::StateType m_step_over_state = lldb::eStateRunning;
+  int m_step_over_signo = LLDB_INVALID_SIGNAL_NUMBER;
+  bool m_step_over_started = false;
+  std::vector<lldb::tid_t> m_step_over_held_tids;
+
+  // Threads the client resumed at a breakpoint in non-stop mode while another
+  // thread was stepping over one. They are stepped over in turn.
+  struct PendingStepOver {
+    lldb::tid_t tid;
+    lldb::StateType state;
+    int signo;
+  };
+  std::vector<PendingStepOver> m_pending_step_overs;
+
   // Private Instance Methods
   NativeProcessLinux(::pid_t pid, int terminal_fd, NativeDelegate &delegate,
                      const ArchSpec &arch, MainLoop &mainloop,
-                     llvm::ArrayRef<::pid_t> tids);
+                     llvm::ArrayRef<::pid_t> tids, bool seized);
+
+  // Returns a list of process threads that we have attached to. \p seized is
+  // set if they were attached with PTRACE_SEIZE.
+  static llvm::Expected<std::vector<::pid_t>> Attach(::pid_t pid,
+                                                     bool &seized);
 
-  // Returns a list of process threads that we have attached to.
-  static llvm::Expected<std::vector<::pid_t>> Attach(::pid_t pid);
+  static long GetDefaultPtraceOpts();
 
   static Status SetDefaultPtraceOpts(const lldb::pid_t);
 
@@ -165,12 +224,52 @@ private:
   void MonitorSignal(const siginfo_t &info, NativeThreadLinux &thread,
                      bool exited);
 
+  // Handles a thread stopping because of RequestStop().
+  void MonitorStopRequest(const siginfo_t &info, NativeThreadLinux &thread);
+
   Status SetupSoftwareSingleStepping(NativeThreadLinux &thread);
 
+  // Move the thread stopped at the breakpoint at addr past it. All other
+  // threads are stopped first. See m_step_over_state for state.
+  void StepOverBreakpoint(NativeThreadLinux &thread, lldb::addr_t addr,
+                          lldb::StateType state = lldb::eStateRunning,
+                          int signo = LLDB_INVALID_SIGNAL_NUMBER);
+
+  // In non-stop mode, step the thread over the software breakpoint at its pc
+  // before resuming it with state. Returns false if the thread can be resumed
+  // right away.
+  bool StepOverBreakpointForResume(NativeThreadLinux &thread,
+                                   lldb::StateType state, int signo);
+
+  // Keep the thread stopped until the breakpoint step is done.
+  void HoldForStepOver(NativeThreadLinux &thread);
+
+  // Whether the thread is held or waiting for a step over a breakpoint. The
+  // client still considers such threads running.
+  bool IsInStepOver(lldb::tid_t tid) const;
+
+  // Single step the thread over the breakpoint once all threads are stopped.
+  void MaybeStartStepOver();
+
+  // Handles the end of the single step over the breakpoint. Returns false if
+  // the thread isn't stepping over a breakpoint.
+  bool MonitorStepOver(NativeThreadLinux &thread);
+
+  // Re-insert the breakpoint and resume all threads after the step.
+  void FinishStepOver();
+
+  // Abandon the breakpoint step because of a stop that is reported. The
+  // breakpoint is re-inserted if it was removed.
+  void CancelStepOver();
+
+  void RestoreStepOverTrap();
+
   bool HasThreadNoLock(lldb::tid_t thread_id);
 
   bool StopTrackingThread(lldb::tid_t thread_id);
 
+  void RemoveThreads(llvm::function_ref<bool(NativeThreadLinux &)> pred);
+
   NativeThreadLinux &AddThread(lldb::tid_t thread_id);
 
   /// Writes a siginfo_t structure corresponding to the given thread ID to the
@@ -196,6 +295,21 @@ private:
   // Notify the delegate if all threads have stopped.
   void SignalIfAllThreadsStopped();
 
+  // Report the stop of a single thread in non-stop mode.
+  void ReportThreadStop(NativeThreadLinux &thread);
+
+  // Remove the temporary breakpoint used to single step the thread, if any.
+  void RemoveSteppingBreakpoint(lldb::tid_t tid);
+
+  // Request a stop of the given thread in non-stop mode. A stop is reported
+  // for it unless it was already stopped.
+  Status StopThread(NativeThreadLinux &thread);
+
+  // Returns a stopped thread to access the memory through ptrace with. Only
+  // stopped threads can be used, which in non-stop mode or while evaluating a
+  // breakpoint condition need not include the main thread.
+  ::pid_t GetMemoryAccessTID();
+
   // Resume the given thread, optionally passing it the given signal. The type
   // of resume
   // operation (continue, single-step) depends on the state parameter.
@@ -206,6 +320,10 @@ private:
 
   void SigchldHandler();
 
+  // Remove the wait status of the given thread from the statuses reaped but
+  // not handled yet. Returns true if there was one.
+  bool TakePendingWaitStatus(::pid_t tid, int &status);
+
   Status PopulateMemoryRegionCache();
 
   lldb::user_id_t StartTraceGroup(const TraceOptions &config,
@@ -95,39 +95,33 @@ NativeRegisterContextLinux::WriteRegisterRaw(uint32_t reg_index,
 }
 
 Status NativeRegisterContextLinux::ReadGPR() {
-  return NativeProcessLinux::PtraceWrapper(
-      PTRACE_GETREGS, m_thread.GetID(), nullptr, GetGPRBuffer(), GetGPRSize());
+  return PtraceWrapper(PTRACE_GETREGS, nullptr, GetGPRBuffer(), GetGPRSize());
 }
 
 Status NativeRegisterContextLinux::WriteGPR() {
-  return NativeProcessLinux::PtraceWrapper(
-      PTRACE_SETREGS, m_thread.GetID(), nullptr, GetGPRBuffer(), GetGPRSize());
+  return PtraceWrapper(PTRACE_SETREGS, nullptr, GetGPRBuffer(), GetGPRSize());
 }
 
 Status NativeRegisterContextLinux::ReadFPR() {
-  return NativeProcessLinux::PtraceWrapper(PTRACE_GETFPREGS, m_thread.GetID(),
-                                           nullptr, GetFPRBuffer(),
-                                           GetFPRSize());
+  return PtraceWrapper(PTRACE_GETFPREGS, nullptr, GetFPRBuffer(),
+                       GetFPRSize());
 }
 
 Status NativeRegisterContextLinux::WriteFPR() {
-  return NativeProcessLinux::PtraceWrapper(PTRACE_SETFPREGS, m_thread.GetID(),
-                                           nullptr, GetFPRBuffer(),
-                                           GetFPRSize());
+  return PtraceWrapper(PTRACE_SETFPREGS, nullptr, GetFPRBuffer(),
+                       GetFPRSize());
 }
 
 Status NativeRegisterContextLinux::ReadRegisterSet(void *buf, size_t buf_size,
                                                    unsigned int regset) {
-  return NativeProcessLinux::PtraceWrapper(PTRACE_GETREGSET, m_thread.GetID(),
-                                           static_cast<void *>(&regset), buf,
-                                           buf_size);
+  return PtraceWrapper(PTRACE_GETREGSET, static_cast<void *>(&regset), buf,
+                       buf_size);
 }
 
 Status NativeRegisterContextLinux::WriteRegisterSet(void *buf, size_t buf_size,
                                                     unsigned int regset) {
-  return NativeProcessLinux::PtraceWrapper(PTRACE_SETREGSET, m_thread.GetID(),
-                                           static_cast<void *>(&regset), buf,
-                                           buf_size);
+  return PtraceWrapper(PTRACE_SETREGSET, static_cast<void *>(&regset), buf,
+                       buf_size);
 }
 
 Status NativeRegisterContextLinux::DoReadRegisterValue(uint32_t offset,
@@ -137,9 +131,9 @@ Status NativeRegisterContextLinux::DoReadRegisterValue(uint32_t offset,
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_REGISTERS));
 
   long data;
-  Status error = NativeProcessLinux::PtraceWrapper(
-      PTRACE_PEEKUSER, m_thread.GetID(), reinterpret_cast<void *>(offset),
-      nullptr, 0, &data);
+  Status error = PtraceWrapper(PTRACE_PEEKUSER,
+                               reinterpret_cast<void *>(offset), nullptr, 0,
+                               &data);
 
   if (error.Success())
     // First cast to an unsigned of the same size to avoid sign extension.
@@ -156,6 +150,13 @@ Status NativeRegisterContextLinux::DoWriteRegisterValue(
   void *buf = reinterpret_cast<void *>(value.GetAsUInt64());
   LLDB_LOG(log, "{0}: {1}", reg_name, buf);
 
-  return NativeProcessLinux::PtraceWrapper(
-      PTRACE_POKEUSER, m_thread.GetID(), reinterpret_cast<void *>(offset), buf);
+  return PtraceWrapper(PTRACE_POKEUSER, reinterpret_cast<void *>(offset), buf);
+}
+
+Status NativeRegisterContextLinux::PtraceWrapper(int req, void *addr,
+                                                 void *data, size_t data_size,
+                                                 long *result) {
+  ++m_ptrace_call_count;
+  return NativeProcessLinux::PtraceWrapper(req, m_thread.GetID(), addr, data,
+                                           data_size, result);
 }
@@ -28,6 +28,16 @@ public:
   CreateHostNativeRegisterContextLinux(const ArchSpec &target_arch,
                                        NativeThreadProtocol &native_thread);
 
+  /// Forget any register state cached since the thread stopped. This is
+  /// called before the thread is resumed.
+  virtual void InvalidateAllRegisters() {}
+
+  /// Return the number of ptrace calls made by this register context since
+  /// the last call to ResetPtraceCallCount().
+  uint32_t GetPtraceCallCount() const { return m_ptrace_call_count; }
+
+  void ResetPtraceCallCount() { m_ptrace_call_count = 0; }
+
 protected:
   lldb::ByteOrder GetByteOrder() const;
 
@@ -68,6 +78,12 @@ protected:
 
   virtual Status DoWriteRegisterValue(uint32_t offset, const char *reg_name,
                                       const RegisterValue &value);
+
+  // Issue a ptrace request for this thread and count it.
+  Status PtraceWrapper(int req, void *addr, void *data, size_t data_size = 0,
+                       long *result = nullptr);
+
+  uint32_t m_ptrace_call_count = 0;
 };
 
 } // namespace process_linux
@@ -296,7 +296,8 @@ NativeRegisterContextLinux_x86_64::NativeRegisterContextLinux_x86_64(
     : NativeRegisterContextLinux(native_thread,
                                  CreateRegisterInfoInterface(target_arch)),
       m_xstate_type(XStateType::Invalid), m_ymm_set(), m_mpx_set(),
-      m_reg_info(), m_gpr_x86_64() {
+      m_reg_info(), m_gpr_x86_64(), m_gpr_valid(false),
+      m_xstate_valid(false) {
   // Set up data about ranges of valid registers.
   switch (target_arch.GetMachine()) {
   case llvm::Triple::x86:
@@ -426,9 +427,21 @@ NativeRegisterContextLinux_x86_64::ReadRegister(const RegisterInfo *reg_info,
   }
 
   if (IsFPR(reg) || IsAVX(reg) || IsMPX(reg)) {
-    error = ReadFPR();
+    error = ReadFPRIfNeeded();
     if (error.Fail())
       return error;
+  } else if (IsInGPRBuffer(reg_info)) {
+    error = ReadGPRIfNeeded();
+    if (error.Fail())
+      return error;
+
+    // The buffer has the user_regs_struct layout the byte offsets refer to,
+    // so this works for the unaligned subregisters (ah, bh, ...) too.
+    reg_value.SetFromMemoryData(
+        reg_info, reinterpret_cast<uint8_t *>(m_gpr_x86_64) +
+                      reg_info->byte_offset,
+        reg_info->byte_size, GetByteOrder(), error);
+    return error;
   } else {
     uint32_t full_reg = reg;
     bool is_subreg = reg_info->invalidate_regs &&
@@ -576,12 +589,21 @@ Status NativeRegisterContextLinux_x86_64::WriteRegister(
                                                ? reg_info->name
                                                : "<unknown register>");
 
-  UpdateXSTATEforWrite(reg_index);
-
-  if (IsGPR(reg_index))
+  if (IsGPR(reg_index)) {
+    // The kernel may adjust the value written (e.g. the reserved bits of
+    // eflags), so read the registers again on the next access.
+    m_gpr_valid = false;
     return WriteRegisterRaw(reg_index, reg_value);
+  }
 
   if (IsFPR(reg_index) || IsAVX(reg_index) || IsMPX(reg_index)) {
+    // Only part of the extended state is changed, the rest must be current.
+    Status error = ReadFPRIfNeeded();
+    if (error.Fail())
+      return error;
+
+    UpdateXSTATEforWrite(reg_index);
+
     if (reg_info->encoding == lldb::eEncodingVector) {
       if (reg_index >= m_reg_info.first_st && reg_index <= m_reg_info.last_st)
         ::memcpy(m_xstate->fxsave.stmm[reg_index - m_reg_info.first_st].bytes,
@@ -656,9 +678,11 @@ Status NativeRegisterContextLinux_x86_64::WriteRegister(
       }
     }
 
-    Status error = WriteFPR();
-    if (error.Fail())
+    error = WriteFPR();
+    if (error.Fail()) {
+      m_xstate_valid = false;
       return error;
+    }
 
     if (IsAVX(reg_index)) {
       if (!CopyYMMtoXSTATE(reg_index, GetByteOrder()))
@@ -680,11 +704,11 @@ Status NativeRegisterContextLinux_x86_64::ReadAllRegisterValues(
   Status error;
 
   data_sp.reset(new DataBufferHeap(REG_CONTEXT_SIZE, 0));
-  error = ReadGPR();
+  error = ReadGPRIfNeeded();
   if (error.Fail())
     return error;
 
-  error = ReadFPR();
+  error = ReadFPRIfNeeded();
   if (error.Fail())
     return error;
 
@@ -743,8 +767,10 @@ Status NativeRegisterContextLinux_x86_64::ReadAllRegisterValues(
   if (reg_info == nullptr)
     reg_info = GetRegisterInfoInterface().GetDynamicRegisterInfo("orig_rax");
 
-  if (reg_info != nullptr)
+  if (reg_info != nullptr) {
+    m_gpr_valid = false;
     return DoWriteRegisterValue(reg_info->byte_offset, reg_info->name, value);
+  }
 
   return error;
 }
@@ -777,6 +803,7 @@ Status NativeRegisterContextLinux_x86_64::WriteAllRegisterValues(
   }
   ::memcpy(&m_gpr_x86_64, src, GetRegisterInfoInterface().GetGPRSize());
 
+  m_gpr_valid = false;
   error = WriteGPR();
   if (error.Fail())
     return error;
@@ -788,6 +815,7 @@ Status NativeRegisterContextLinux_x86_64::WriteAllRegisterValues(
     ::memcpy(&m_xstate->xsave, src, sizeof(m_xstate->xsave));
 
   error = WriteFPR();
+  m_xstate_valid = error.Success();
   if (error.Fail())
     return error;
 
@@ -830,7 +858,9 @@ Status NativeRegisterContextLinux_x86_64::WriteAllRegisterValues(
 bool NativeRegisterContextLinux_x86_64::IsCPUFeatureAvailable(
     RegSet feature_code) const {
   if (m_xstate_type == XStateType::Invalid) {
-    if (const_cast<NativeRegisterContextLinux_x86_64 *>(this)->ReadFPR().Fail())
+    if (const_cast<NativeRegisterContextLinux_x86_64 *>(this)
+            ->ReadFPRIfNeeded()
+            .Fail())
       return false;
   }
   switch (feature_code) {
@@ -972,6 +1002,36 @@ Status NativeRegisterContextLinux_x86_64::ReadFPR() {
   return Status("Unrecognized FPR type.");
 }
 
+Status NativeRegisterContextLinux_x86_64::ReadFPRIfNeeded() {
+  if (m_xstate_valid)
+    return Status();
+
+  Status error = ReadFPR();
+  m_xstate_valid = error.Success();
+  return error;
+}
+
+Status NativeRegisterContextLinux_x86_64::ReadGPRIfNeeded() {
+  if (m_gpr_valid)
+    return Status();
+
+  Status error = ReadGPR();
+  m_gpr_valid = error.Success();
+  return error;
+}
+
+bool NativeRegisterContextLinux_x86_64::IsInGPRBuffer(
+    const RegisterInfo *reg_info) {
+  const uint32_t reg = reg_info->kinds[lldb::eRegisterKindLLDB];
+  return IsGPR(reg) &&
+         reg_info->byte_offset + reg_info->byte_size <= GetGPRSize();
+}
+
+void NativeRegisterContextLinux_x86_64::InvalidateAllRegisters() {
+  m_gpr_valid = false;
+  m_xstate_valid = false;
+}
+
 bool NativeRegisterContextLinux_x86_64::IsMPX(uint32_t reg_index) const {
   if (!IsCPUFeatureAvailable(RegSet::mpx))
     return false;
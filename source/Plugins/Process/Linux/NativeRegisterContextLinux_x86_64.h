@@ -64,6 +64,8 @@ public:
 
   uint32_t NumSupportedHardwareWatchpoints() override;
 
+  void InvalidateAllRegisters() override;
+
 protected:
   void *GetGPRBuffer() override { return &m_gpr_x86_64; }
 
@@ -116,6 +118,9 @@ private:
   RegInfo m_reg_info;
   uint64_t m_gpr_x86_64[k_num_gpr_registers_x86_64];
   uint32_t m_fctrl_offset_in_userarea;
+  // Whether m_gpr_x86_64 and m_xstate hold the state of the stopped thread.
+  bool m_gpr_valid;
+  bool m_xstate_valid;
 
   // Private member methods.
   bool IsCPUFeatureAvailable(RegSet feature_code) const;
@@ -139,6 +144,12 @@ private:
   bool IsMPX(uint32_t reg_index) const;
 
   void UpdateXSTATEforWrite(uint32_t reg_index);
+
+  bool IsInGPRBuffer(const RegisterInfo *reg_info);
+
+  Status ReadGPRIfNeeded();
+
+  Status ReadFPRIfNeeded();
 };
 
 } // namespace process_linux
@@ -8,6 +8,7 @@
 
 #include "NativeThreadLinux.h"
 
+#include <algorithm>
 #include <signal.h>
 #include <sstream>
 
@@ -205,8 +206,7 @@ Status NativeThreadLinux::RemoveHardwareBreakpoint(lldb::addr_t addr) {
 
 Status NativeThreadLinux::Resume(uint32_t signo) {
   const StateType new_state = StateType::eStateRunning;
-  MaybeLogStateChange(new_state);
-  m_state = new_state;
+  SetState(new_state);
 
   m_stop_info.reason = StopReason::eStopReasonNone;
   m_stop_description.clear();
@@ -241,14 +241,14 @@ Status NativeThreadLinux::Resume(uint32_t signo) {
   if (signo != LLDB_INVALID_SIGNAL_NUMBER)
     data = signo;
 
+  PrepareToResume();
   return NativeProcessLinux::PtraceWrapper(PTRACE_CONT, GetID(), nullptr,
                                            reinterpret_cast<void *>(data));
 }
 
 Status NativeThreadLinux::SingleStep(uint32_t signo) {
   const StateType new_state = StateType::eStateStepping;
-  MaybeLogStateChange(new_state);
-  m_state = new_state;
+  SetState(new_state);
   m_stop_info.reason = StopReason::eStopReasonNone;
 
   if(!m_step_workaround) {
@@ -262,6 +262,8 @@ Status NativeThreadLinux::SingleStep(uint32_t signo) {
   if (signo != LLDB_INVALID_SIGNAL_NUMBER)
     data = signo;
 
+  PrepareToResume();
+
   // If hardware single-stepping is not supported, we just do a continue. The
   // breakpoint on the next instruction has been setup in
   // NativeProcessLinux::Resume.
@@ -320,11 +322,26 @@ void NativeThreadLinux::SetStopped() {
     m_step_workaround.reset();
 
   const StateType new_state = StateType::eStateStopped;
-  MaybeLogStateChange(new_state);
-  m_state = new_state;
+  SetState(new_state);
   m_stop_description.clear();
 }
 
+void NativeThreadLinux::PrepareToResume() {
+  m_reg_context_up->InvalidateAllRegisters();
+
+  // Count the request resuming the thread too.
+  const uint32_t num_calls = m_reg_context_up->GetPtraceCallCount() + 1;
+  m_reg_context_up->ResetPtraceCallCount();
+  ++m_ptrace_stats.num_stops;
+  m_ptrace_stats.num_calls += num_calls;
+  m_ptrace_stats.max_calls_per_stop =
+      std::max(m_ptrace_stats.max_calls_per_stop, num_calls);
+
+  Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_THREAD));
+  LLDB_LOG(log, "tid {0} made {1} ptrace calls while stopped", m_tid,
+           num_calls);
+}
+
 void NativeThreadLinux::SetStoppedByExec() {
   Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_THREAD));
   LLDB_LOGF(log, "NativeThreadLinux::%s()", __FUNCTION__);
@@ -397,8 +414,7 @@ void NativeThreadLinux::SetStoppedWithNoReason() {
 
 void NativeThreadLinux::SetExited() {
   const StateType new_state = StateType::eStateExited;
-  MaybeLogStateChange(new_state);
-  m_state = new_state;
+  SetState(new_state);
 
   m_stop_info.reason = StopReason::eStopReasonThreadExiting;
 }
@@ -416,6 +432,10 @@ Status NativeThreadLinux::RequestStop() {
             ", tid: %" PRIu64 ")",
             __FUNCTION__, pid, tid);
 
+  // Seized threads can be stopped without sending them a signal.
+  if (process.IsSeized())
+    return NativeProcessLinux::PtraceWrapper(PTRACE_INTERRUPT, tid);
+
   Status err;
   errno = 0;
   if (::tgkill(pid, tid, SIGSTOP) != 0) {
@@ -444,6 +464,12 @@ void NativeThreadLinux::MaybeLogStateChange(lldb::StateType new_state) {
            m_process.GetID(), GetID(), old_state, new_state);
 }
 
+void NativeThreadLinux::SetState(lldb::StateType new_state) {
+  MaybeLogStateChange(new_state);
+  GetProcess().ThreadStateChanged(m_state, new_state);
+  m_state = new_state;
+}
+
 NativeProcessLinux &NativeThreadLinux::GetProcess() {
   return static_cast<NativeProcessLinux &>(m_process);
 }
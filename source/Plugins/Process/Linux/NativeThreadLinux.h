@@ -28,6 +28,12 @@ class NativeThreadLinux : public NativeThreadProtocol {
   friend class NativeProcessLinux;
 
 public:
+  struct PtraceCallStats {
+    uint64_t num_stops = 0;
+    uint64_t num_calls = 0;
+    uint32_t max_calls_per_stop = 0;
+  };
+
   NativeThreadLinux(NativeProcessLinux &process, lldb::tid_t tid);
 
   // NativeThreadProtocol Interface
@@ -51,6 +57,16 @@ public:
 
   Status RemoveHardwareBreakpoint(lldb::addr_t addr) override;
 
+  /// Return the number of ptrace calls made for this thread since it last
+  /// stopped.
+  uint32_t GetPtraceCallCount() const {
+    return m_reg_context_up->GetPtraceCallCount();
+  }
+
+  /// Return the ptrace calls made for this thread during the stops it was
+  /// resumed from.
+  const PtraceCallStats &GetPtraceCallStats() const { return m_ptrace_stats; }
+
 private:
   // Interface for friend classes
 
@@ -90,10 +106,16 @@ private:
   // Private interface
   void MaybeLogStateChange(lldb::StateType new_state);
 
+  void SetState(lldb::StateType new_state);
+
   NativeProcessLinux &GetProcess();
 
   void SetStopped();
 
+  /// Drops the cached register state and accounts the ptrace calls of the
+  /// current stop. Must be called right before the thread is resumed.
+  void PrepareToResume();
+
   // Member Variables
   lldb::StateType m_state;
   ThreadStopInfo m_stop_info;
@@ -103,6 +125,7 @@ private:
   WatchpointIndexMap m_watchpoint_index_map;
   WatchpointIndexMap m_hw_break_index_map;
   std::unique_ptr<SingleStepWorkaround> m_step_workaround;
+  PtraceCallStats m_ptrace_stats;
 };
 } // namespace process_linux
 } // namespace lldb_private
@@ -949,6 +949,15 @@ void RegisterContextLLDB::InvalidateAllRegisters() {
   m_frame_type = eNotAValidFrame;
 }
 
+void RegisterContextLLDB::SetFrameNumber(uint32_t frame_number) {
+  m_frame_number = frame_number;
+  m_concrete_frame_idx = frame_number;
+  // The register locations found in the frames below may be different now.
+  m_registers.clear();
+  if (ProcessSP process_sp = m_thread.GetProcess())
+    SetStopID(process_sp->GetStopID());
+}
+
 size_t RegisterContextLLDB::GetRegisterCount() {
   return m_thread.GetRegisterContext()->GetRegisterCount();
 }
@@ -1017,6 +1026,9 @@ bool RegisterContextLLDB::ReadRegisterValueFromRegisterLocation(
         reg_info, regloc.location.target_memory_location, reg_info->byte_size,
         value));
     success = error.Success();
+    if (success)
+      m_parent_unwind.RecordSavedValue(regloc.location.target_memory_location,
+                                       value);
   } break;
   default:
     llvm_unreachable("Unknown RegisterLocation type.");
@@ -1489,6 +1501,9 @@ RegisterContextLLDB::SavedLocationForRegister(
     cfa_val.SetValueType(Value::eValueTypeLoadAddress);
     Value result;
     Status error;
+    // The expression may read any register or memory, which can't be
+    // checked at a later stop.
+    m_parent_unwind.RecordUnverifiableValue();
     if (dwarfexpr.Evaluate(&exe_ctx, this, 0, &cfa_val, nullptr, result,
                            &error)) {
       addr_t val;
@@ -1671,6 +1686,7 @@ bool RegisterContextLLDB::TryFallbackUnwindPlan() {
     PropagateTrapHandlerFlagFromUnwindPlan(m_full_unwind_plan_sp);
   }
 
+  m_parent_unwind.MarkFrameUnverifiable(m_frame_number);
   return true;
 }
 
@@ -1716,6 +1732,7 @@ bool RegisterContextLLDB::ForceSwitchToFallbackUnwindPlan() {
 
     UnwindLogMsg("switched unconditionally to the fallback unwindplan %s",
                  m_full_unwind_plan_sp->GetSourceName().GetCString());
+    m_parent_unwind.MarkFrameUnverifiable(m_frame_number);
     return true;
   }
   return false;
@@ -1788,6 +1805,7 @@ bool RegisterContextLLDB::ReadFrameAddress(
         Status error = ReadRegisterValueFromMemory(
             reg_info, cfa_reg_contents, reg_info->byte_size, reg_value);
         if (error.Success()) {
+          m_parent_unwind.RecordSavedValue(cfa_reg_contents, reg_value);
           address = reg_value.GetAsUInt64();
           UnwindLogMsg(
               "CFA value via dereferencing reg %s (%d): reg has val 0x%" PRIx64
@@ -1840,6 +1858,7 @@ bool RegisterContextLLDB::ReadFrameAddress(
     dwarfexpr.SetRegisterKind(row_register_kind);
     Value result;
     Status error;
+    m_parent_unwind.RecordUnverifiableValue();
     if (dwarfexpr.Evaluate(&exe_ctx, this, 0, nullptr, nullptr, result,
                            &error)) {
       address = result.GetScalar().ULongLong();
@@ -67,6 +67,10 @@ public:
 
   bool ReadPC(lldb::addr_t &start_pc);
 
+  // Move a frame kept from the previous stop to its place in the stack of
+  // this stop.
+  void SetFrameNumber(uint32_t frame_number);
+
 private:
   enum FrameType {
     eNormalFrame,
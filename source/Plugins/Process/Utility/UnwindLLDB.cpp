@@ -15,7 +15,13 @@
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Log.h"
+#include "lldb/Utility/RegisterValue.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/ScopeExit.h"
+
+#include <algorithm>
 
 #include "RegisterContextLLDB.h"
 #include "UnwindLLDB.h"
@@ -25,7 +31,9 @@ using namespace lldb_private;
 
 UnwindLLDB::UnwindLLDB(Thread &thread)
     : Unwind(thread), m_frames(), m_unwind_complete(false),
-      m_user_supplied_trap_handler_functions() {
+      m_user_supplied_trap_handler_functions(), m_prev_frames(),
+      m_prev_unwind_complete(false), m_prev_frame_index(),
+      m_prev_next_idx(0), m_recording_cursor(nullptr), m_allow_reuse(true) {
   ProcessSP process_sp(thread.GetProcess());
   if (process_sp) {
     Args args;
@@ -64,10 +72,21 @@ uint32_t UnwindLLDB::DoGetFrameCount() {
       }
 #endif
     }
+    PublishUnwindStatistics();
   }
   return m_frames.size();
 }
 
+void UnwindLLDB::PublishUnwindStatistics() {
+  const Process::UnwindStatistics &stats = m_unwind_stats;
+  if (stats.frames_unwound == 0 && stats.frames_matched == 0 &&
+      stats.frames_reused == 0 && stats.frames_rejected == 0)
+    return;
+  if (ProcessSP process_sp = m_thread.GetProcess())
+    process_sp->AddUnwindStatistics(stats);
+  m_unwind_stats = Process::UnwindStatistics();
+}
+
 bool UnwindLLDB::AddFirstFrame() {
   if (m_frames.size() > 0)
     return true;
@@ -126,6 +145,16 @@ UnwindLLDB::CursorSP UnwindLLDB::GetOneMoreFrame(ABI *abi) {
   uint32_t cur_idx = m_frames.size();
 
   CursorSP cursor_sp(new Cursor());
+
+  // Every value read from memory from here on goes into this frame's
+  // unwinding, so that a later stop can check whether it changed.
+  Cursor *old_recording_cursor = m_recording_cursor;
+  m_recording_cursor = cursor_sp.get();
+  auto restore_recording_cursor = llvm::make_scope_exit(
+      [this, old_recording_cursor]() {
+        m_recording_cursor = old_recording_cursor;
+      });
+
   RegisterContextLLDBSP reg_ctx_sp(new RegisterContextLLDB(
       m_thread, prev_frame->reg_ctx_lldb_sp, cursor_sp->sctx, cur_idx, *this));
 
@@ -290,6 +319,7 @@ UnwindLLDB::CursorSP UnwindLLDB::GetOneMoreFrame(ABI *abi) {
   }
 
   cursor_sp->reg_ctx_lldb_sp = reg_ctx_sp;
+  ++m_unwind_stats.frames_unwound;
   return cursor_sp;
 }
 
@@ -300,6 +330,10 @@ void UnwindLLDB::UpdateUnwindPlanForFirstFrameIfInvalid(ABI *abi) {
   bool old_m_unwind_complete = m_unwind_complete;
   CursorSP old_m_candidate_frame = m_candidate_frame;
 
+  // The frames added here are thrown away, don't splice in any from the
+  // previous stop.
+  m_allow_reuse = false;
+
   // Try to unwind 2 more frames using the Unwinder. It uses Full UnwindPlan
   // and if Full UnwindPlan fails, then uses FallBack UnwindPlan. Also update
   // the cfa of Frame 0 (if required).
@@ -313,6 +347,7 @@ void UnwindLLDB::UpdateUnwindPlanForFirstFrameIfInvalid(ABI *abi) {
   // Restore status after calling AddOneMoreFrame
   m_unwind_complete = old_m_unwind_complete;
   m_candidate_frame = old_m_candidate_frame;
+  m_allow_reuse = true;
   return;
 }
 
@@ -341,6 +376,12 @@ bool UnwindLLDB::AddOneMoreFrame(ABI *abi) {
 
   m_frames.push_back(new_frame);
 
+  // If this frame was already unwound at the previous stop, the frames that
+  // called it probably are still the same, and can be checked much faster
+  // than they can be unwound.
+  if (ReusePreviousFrames())
+    return true;
+
   // If we can get one more frame further then accept that we get back a
   // correct frame.
   m_candidate_frame = GetOneMoreFrame(abi);
@@ -390,6 +431,195 @@ bool UnwindLLDB::AddOneMoreFrame(ABI *abi) {
   return true;
 }
 
+llvm::Optional<uint32_t> UnwindLLDB::FindPreviousFrame(addr_t cfa, addr_t pc) {
+  if (m_prev_frame_index.empty()) {
+    for (uint32_t i = 0; i < m_prev_frames.size(); ++i)
+      m_prev_frame_index.insert(
+          {{m_prev_frames[i]->cfa, m_prev_frames[i]->start_pc}, i});
+  }
+  auto pos = m_prev_frame_index.find({cfa, pc});
+  if (pos == m_prev_frame_index.end())
+    return llvm::None;
+  return pos->second;
+}
+
+void UnwindLLDB::SavePreviousFrames() {
+  std::vector<CursorSP> frames;
+  frames.swap(m_frames);
+  bool unwind_complete = m_unwind_complete;
+
+  if (!m_prev_frames.empty()) {
+    // The callers of frame zero of the previous stop were unwound from the
+    // live registers of that stop, which can't be checked.
+    llvm::Optional<uint32_t> junction_idx =
+        FindPreviousFrame(frames.back()->cfa, frames.back()->start_pc);
+    if (junction_idx && *junction_idx > 0 &&
+        *junction_idx + 1 >= m_prev_next_idx) {
+      // Append the frames above the junction, renumbered. Stop at the first
+      // one that was unwound from values of a frame below the junction,
+      // which the frames of this stop don't describe.
+      const uint32_t junction_frame_num = frames.size() - 1;
+      uint32_t i = *junction_idx + 1;
+      for (; i < m_prev_frames.size(); ++i) {
+        CursorSP cursor_sp = m_prev_frames[i];
+        if (cursor_sp->min_location_frame < *junction_idx)
+          break;
+        if (cursor_sp->min_location_frame != UINT32_MAX)
+          cursor_sp->min_location_frame = cursor_sp->min_location_frame -
+                                          *junction_idx + junction_frame_num;
+        frames.push_back(cursor_sp);
+      }
+      if (i == m_prev_frames.size())
+        unwind_complete = m_prev_unwind_complete;
+    } else if (m_prev_next_idx == 0 && frames.size() < m_prev_frames.size()) {
+      // This stop didn't get as far as a frame of the previous stop. The
+      // longer list is more likely to help the next stop.
+      m_prev_next_idx = 0;
+      return;
+    }
+  }
+
+  m_prev_frames.swap(frames);
+  m_prev_unwind_complete = unwind_complete;
+  m_prev_frame_index.clear();
+  m_prev_next_idx = 0;
+}
+
+bool UnwindLLDB::ReusePreviousFrames() {
+  if (!m_allow_reuse || m_prev_next_idx >= m_prev_frames.size())
+    return false;
+
+  ProcessSP process_sp(m_thread.GetProcess());
+  if (!process_sp)
+    return false;
+
+  // The callers of frame zero of the previous stop were unwound from the live
+  // registers of that stop, which can't be checked. The frames before
+  // m_prev_next_idx are already in m_frames.
+  const CursorSP &frame = m_frames.back();
+  llvm::Optional<uint32_t> prev_idx =
+      FindPreviousFrame(frame->cfa, frame->start_pc);
+  if (!prev_idx || *prev_idx == 0 || *prev_idx < m_prev_next_idx)
+    return false;
+  const uint32_t match_idx = *prev_idx;
+  const CursorSP &prev_match = m_prev_frames[match_idx];
+  if (!prev_match->reg_ctx_lldb_sp ||
+      prev_match->reg_ctx_lldb_sp->IsTrapHandlerFrame() !=
+          frame->reg_ctx_lldb_sp->IsTrapHandlerFrame())
+    return false;
+
+  Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_UNWIND));
+  ++m_unwind_stats.frames_matched;
+
+  // The frames that called the matching frame can be reused if they were
+  // unwound only from values that this and the reused frames provide, and
+  // those values are still the same. Don't check more frames than were
+  // unwound so far, so the work stays proportional to the frames that are
+  // asked for.
+  const uint64_t max_stack_depth = m_thread.GetMaxBacktraceDepth();
+  const uint32_t max_reuse = std::max<size_t>(16, m_frames.size());
+  uint32_t end_idx = match_idx + 1;
+  while (end_idx < m_prev_frames.size() && end_idx - match_idx <= max_reuse &&
+         m_frames.size() + (end_idx - match_idx - 1) < max_stack_depth) {
+    const Cursor &cursor = *m_prev_frames[end_idx];
+    if (cursor.unverifiable || cursor.min_location_frame < match_idx ||
+        !cursor.reg_ctx_lldb_sp || !cursor.reg_ctx_lldb_sp->IsValid())
+      break;
+    ++end_idx;
+  }
+
+  // Read all the saved values at once, merging the ones next to each other.
+  std::vector<Process::LoadRange> ranges;
+  for (uint32_t i = match_idx + 1; i < end_idx; ++i) {
+    for (const SavedValue &saved : m_prev_frames[i]->saved_values)
+      ranges.push_back(Process::LoadRange(saved.addr, saved.size));
+  }
+  llvm::sort(ranges.begin(), ranges.end(),
+             [](const Process::LoadRange &lhs, const Process::LoadRange &rhs) {
+               return lhs.GetRangeBase() < rhs.GetRangeBase();
+             });
+  std::vector<Process::LoadRange> merged;
+  std::vector<size_t> merged_offsets;
+  size_t buffer_size = 0;
+  for (const Process::LoadRange &range : ranges) {
+    if (!merged.empty() &&
+        range.GetRangeBase() <= merged.back().GetRangeEnd()) {
+      if (range.GetRangeEnd() > merged.back().GetRangeEnd()) {
+        buffer_size += range.GetRangeEnd() - merged.back().GetRangeEnd();
+        merged.back().SetRangeEnd(range.GetRangeEnd());
+      }
+    } else {
+      merged.push_back(range);
+      merged_offsets.push_back(buffer_size);
+      buffer_size += range.GetByteSize();
+    }
+  }
+
+  std::vector<uint8_t> buffer(buffer_size);
+  std::vector<size_t> bytes_read;
+  process_sp->ReadMemoryRanges(merged, buffer.data(), bytes_read);
+
+  // Check the frames in order, the first one that changed ends the reuse.
+  DataExtractor data(buffer.data(), buffer.size(), process_sp->GetByteOrder(),
+                     process_sp->GetAddressByteSize());
+  uint32_t valid_end_idx = match_idx + 1;
+  for (; valid_end_idx < end_idx; ++valid_end_idx) {
+    bool unchanged = true;
+    for (const SavedValue &saved : m_prev_frames[valid_end_idx]->saved_values) {
+      auto range_pos = std::upper_bound(
+          merged.begin(), merged.end(), saved.addr,
+          [](addr_t addr, const Process::LoadRange &range) {
+            return addr < range.GetRangeBase();
+          });
+      assert(range_pos != merged.begin() && "saved value wasn't read");
+      const size_t range_idx = range_pos - merged.begin() - 1;
+      const addr_t offset_in_range =
+          saved.addr - merged[range_idx].GetRangeBase();
+      if (offset_in_range + saved.size > bytes_read[range_idx]) {
+        unchanged = false;
+        break;
+      }
+      lldb::offset_t offset = merged_offsets[range_idx] + offset_in_range;
+      if (data.GetMaxU64(&offset, saved.size) != saved.value) {
+        unchanged = false;
+        break;
+      }
+    }
+    if (!unchanged) {
+      ++m_unwind_stats.frames_rejected;
+      break;
+    }
+  }
+
+  // Append the frames that are still valid, renumbered for this stop.
+  const uint32_t match_frame_num = m_frames.size() - 1;
+  for (uint32_t i = match_idx + 1; i < valid_end_idx; ++i) {
+    CursorSP cursor_sp = m_prev_frames[i];
+    if (cursor_sp->min_location_frame != UINT32_MAX)
+      cursor_sp->min_location_frame =
+          cursor_sp->min_location_frame - match_idx + match_frame_num;
+    cursor_sp->reg_ctx_lldb_sp->SetFrameNumber(m_frames.size());
+    m_frames.push_back(cursor_sp);
+  }
+  const uint32_t frames_reused = valid_end_idx - match_idx - 1;
+  m_unwind_stats.frames_reused += frames_reused;
+  m_prev_next_idx = valid_end_idx;
+
+  LLDB_LOGF(log,
+            "th%d frame %u matches frame %u of the previous stop, reused %u "
+            "of its callers",
+            m_thread.GetIndexID(), match_frame_num, match_idx,
+            frames_reused);
+
+  if (frames_reused == 0)
+    return false;
+
+  m_candidate_frame.reset();
+  if (valid_end_idx == m_prev_frames.size() && m_prev_unwind_complete)
+    m_unwind_complete = true;
+  return true;
+}
+
 bool UnwindLLDB::DoGetFrameInfoAtIndex(uint32_t idx, addr_t &cfa, addr_t &pc,
                                        bool &behaves_like_zeroth_frame) {
   if (m_frames.size() == 0) {
@@ -402,6 +632,7 @@ bool UnwindLLDB::DoGetFrameInfoAtIndex(uint32_t idx, addr_t &cfa, addr_t &pc,
 
   while (idx >= m_frames.size() && AddOneMoreFrame(abi))
     ;
+  PublishUnwindStatistics();
 
   if (idx < m_frames.size()) {
     cfa = m_frames[idx]->cfa;
@@ -450,6 +681,7 @@ UnwindLLDB::DoCreateRegisterContextForFrame(StackFrame *frame) {
     if (!AddOneMoreFrame(abi))
       break;
   }
+  PublishUnwindStatistics();
 
   const uint32_t num_frames = m_frames.size();
   if (idx < num_frames) {
@@ -481,7 +713,10 @@ bool UnwindLLDB::SearchForSavedLocationForRegister(
     UnwindLLDB::RegisterSearchResult result;
     result = m_frames[frame_num]->reg_ctx_lldb_sp->SavedLocationForRegister(
         lldb_regnum, regloc);
-    return result == UnwindLLDB::RegisterSearchResult::eRegisterFound;
+    if (result != UnwindLLDB::RegisterSearchResult::eRegisterFound)
+      return false;
+    RecordLocationFrame(frame_num);
+    return true;
   }
   while (frame_num >= 0) {
     UnwindLLDB::RegisterSearchResult result;
@@ -493,6 +728,7 @@ bool UnwindLLDB::SearchForSavedLocationForRegister(
     if (result == UnwindLLDB::RegisterSearchResult::eRegisterFound &&
         regloc.type ==
             UnwindLLDB::RegisterLocation::eRegisterInLiveRegisterContext) {
+      RecordLocationFrame(frame_num);
       return true;
     }
 
@@ -509,11 +745,48 @@ bool UnwindLLDB::SearchForSavedLocationForRegister(
       lldb_regnum = regloc.location.register_number;
     }
 
-    if (result == UnwindLLDB::RegisterSearchResult::eRegisterFound)
+    if (result == UnwindLLDB::RegisterSearchResult::eRegisterFound) {
+      RecordLocationFrame(frame_num);
       return true;
+    }
     if (result == UnwindLLDB::RegisterSearchResult::eRegisterIsVolatile)
       return false;
     frame_num--;
   }
   return false;
 }
+
+void UnwindLLDB::RecordLocationFrame(uint32_t frame_num) {
+  if (m_recording_cursor)
+    m_recording_cursor->min_location_frame =
+        std::min(m_recording_cursor->min_location_frame, frame_num);
+}
+
+void UnwindLLDB::RecordSavedValue(addr_t addr, const RegisterValue &value) {
+  if (!m_recording_cursor)
+    return;
+  const uint32_t size = value.GetByteSize();
+  if (size == 0 || size > sizeof(uint64_t)) {
+    m_recording_cursor->unverifiable = true;
+    return;
+  }
+  bool success = false;
+  const uint64_t saved = value.GetAsUInt64(0, &success);
+  if (!success) {
+    m_recording_cursor->unverifiable = true;
+    return;
+  }
+  m_recording_cursor->saved_values.push_back({addr, size, saved});
+}
+
+void UnwindLLDB::RecordUnverifiableValue() {
+  if (m_recording_cursor)
+    m_recording_cursor->unverifiable = true;
+}
+
+void UnwindLLDB::MarkFrameUnverifiable(uint32_t frame_num) {
+  if (frame_num < m_frames.size())
+    m_frames[frame_num]->unverifiable = true;
+  else
+    RecordUnverifiableValue();
+}
@@ -14,10 +14,13 @@
 #include "lldb/Symbol/FuncUnwinders.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Target/Unwind.h"
 #include "lldb/Utility/ConstString.h"
 #include "lldb/lldb-public.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
 
 namespace lldb_private {
 
@@ -65,6 +68,10 @@ protected:
   };
 
   void DoClear() override {
+    // Keep the frames around, the next unwind can reuse the ones that didn't
+    // change. The thread may clear its frames several times in a row.
+    if (!m_frames.empty())
+      SavePreviousFrames();
     m_frames.clear();
     m_candidate_frame.reset();
     m_unwind_complete = false;
@@ -94,6 +101,22 @@ protected:
       uint32_t lldb_regnum, lldb_private::UnwindLLDB::RegisterLocation &regloc,
       uint32_t starting_frame_num, bool pc_register);
 
+  // Record that frame_num supplied a register location to the frame that is
+  // being created.
+  void RecordLocationFrame(uint32_t frame_num);
+
+  // Record a value read from the inferior's memory while unwinding the frame
+  // that is being created.
+  void RecordSavedValue(lldb::addr_t addr, const RegisterValue &value);
+
+  // Record that the frame that is being created depends on values that can't
+  // be checked again later, e.g. the result of a DWARF expression.
+  void RecordUnverifiableValue();
+
+  // The unwind plan of frame_num changed, so the values it was unwound from
+  // no longer describe it.
+  void MarkFrameUnverifiable(uint32_t frame_num);
+
   /// Provide the list of user-specified trap handler functions
   ///
   /// The Platform is one source of trap handler function names; that
@@ -109,6 +132,12 @@ protected:
   }
 
 private:
+  struct SavedValue {
+    lldb::addr_t addr;
+    uint32_t size;
+    uint64_t value;
+  };
+
   struct Cursor {
     lldb::addr_t start_pc; // The start address of the function/symbol for this
                            // frame - current pc if unknown
@@ -118,9 +147,20 @@ private:
     RegisterContextLLDBSP
         reg_ctx_lldb_sp; // These are all RegisterContextLLDB's
 
+    // The values read from memory to unwind this frame from the frame below
+    // it. If they are the same at a later stop, and the frames that supplied
+    // their locations are too, this frame is still valid.
+    std::vector<SavedValue> saved_values;
+    uint32_t min_location_frame; // The lowest frame number that supplied a
+                                 // register location while unwinding this
+                                 // frame, UINT32_MAX if none did
+    bool unverifiable; // The frame was unwound from values that can't be
+                       // checked again
+
     Cursor()
         : start_pc(LLDB_INVALID_ADDRESS), cfa(LLDB_INVALID_ADDRESS), sctx(),
-          reg_ctx_lldb_sp() {}
+          reg_ctx_lldb_sp(), saved_values(), min_location_frame(UINT32_MAX),
+          unverifiable(false) {}
 
   private:
     DISALLOW_COPY_AND_ASSIGN(Cursor);
@@ -137,6 +177,29 @@ private:
 
   std::vector<ConstString> m_user_supplied_trap_handler_functions;
 
+  // The frames of the previous stop, and an index of them by CFA and pc that
+  // is built when it is first needed.
+  std::vector<CursorSP> m_prev_frames;
+  bool m_prev_unwind_complete;
+  llvm::DenseMap<std::pair<lldb::addr_t, lldb::addr_t>, uint32_t>
+      m_prev_frame_index;
+  uint32_t m_prev_next_idx; // The first frame of m_prev_frames that wasn't
+                            // reused yet
+
+  // The frame GetOneMoreFrame() is creating, which records the values it is
+  // unwound from.
+  Cursor *m_recording_cursor;
+
+  // Whether AddOneMoreFrame() may splice in frames of the previous stop.
+  bool m_allow_reuse;
+
+  // The counters of the frames added since they were last given to the
+  // process.
+  Process::UnwindStatistics m_unwind_stats;
+
+  // Add m_unwind_stats to the counters of the process and clear them.
+  void PublishUnwindStatistics();
+
   // Check if Full UnwindPlan of First frame is valid or not.
   // If not then try Fallback UnwindPlan of the frame. If Fallback
   // UnwindPlan succeeds then update the Full UnwindPlan with the
@@ -147,6 +210,20 @@ private:
 
   bool AddOneMoreFrame(ABI *abi);
 
+  // If the last frame in m_frames is a frame of the previous stop, append the
+  // frames that called it at the previous stop, as long as the values they
+  // were unwound from didn't change. Returns true if any frame was appended.
+  bool ReusePreviousFrames();
+
+  // Find the frame of the previous stop with the given CFA and pc.
+  llvm::Optional<uint32_t> FindPreviousFrame(lldb::addr_t cfa,
+                                             lldb::addr_t pc);
+
+  // Move m_frames to m_prev_frames. If the unwind stopped at a frame of the
+  // previous stop, the frames that called it at the previous stop are kept
+  // too, so stops that only need the first few frames don't lose the rest.
+  void SavePreviousFrames();
+
   bool AddFirstFrame();
 
   // For UnwindLLDB only
@@ -0,0 +1,206 @@
+//===-- BinaryStructuredData.cpp --------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "BinaryStructuredData.h"
+
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+void BinaryStructuredDataWriter::PutUnsigned(uint64_t value) {
+  m_data.push_back(eTagUnsigned);
+  llvm::raw_string_ostream stream(m_data);
+  llvm::encodeULEB128(value, stream);
+}
+
+void BinaryStructuredDataWriter::PutSigned(int64_t value) {
+  m_data.push_back(eTagSigned);
+  llvm::raw_string_ostream stream(m_data);
+  llvm::encodeSLEB128(value, stream);
+}
+
+void BinaryStructuredDataWriter::PutDouble(double value) {
+  m_data.push_back(eTagDouble);
+  char bytes[sizeof(uint64_t)];
+  llvm::support::endian::write64le(bytes, llvm::DoubleToBits(value));
+  m_data.append(bytes, sizeof(bytes));
+}
+
+void BinaryStructuredDataWriter::PutString(llvm::StringRef value) {
+  m_data.push_back(eTagString);
+  PutLength(value);
+}
+
+void BinaryStructuredDataWriter::PutBytes(llvm::ArrayRef<uint8_t> value) {
+  m_data.push_back(eTagBytes);
+  PutLength(llvm::toStringRef(value));
+}
+
+void BinaryStructuredDataWriter::PutKey(llvm::StringRef key) {
+  PutString(key);
+}
+
+void BinaryStructuredDataWriter::PutLength(llvm::StringRef value) {
+  {
+    llvm::raw_string_ostream stream(m_data);
+    llvm::encodeULEB128(value.size(), stream);
+  }
+  m_data.append(value.data(), value.size());
+}
+
+namespace {
+class Parser {
+public:
+  Parser(llvm::StringRef data) : m_data(data) {}
+
+  llvm::Expected<StructuredData::ObjectSP> ParseValue(unsigned depth);
+
+  bool AtEnd() const { return m_data.empty(); }
+
+private:
+  // Replies are only a few levels deep, this guards the stack against
+  // garbage.
+  static const unsigned k_max_depth = 64;
+
+  static llvm::Error MakeError(const char *reason) {
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "malformed binary data: %s", reason);
+  }
+
+  llvm::Expected<uint64_t> ParseULEB();
+  llvm::Expected<llvm::StringRef> ParseLength();
+
+  llvm::StringRef m_data;
+};
+} // namespace
+
+llvm::Expected<uint64_t> Parser::ParseULEB() {
+  unsigned size;
+  const char *error = nullptr;
+  uint64_t value = llvm::decodeULEB128(m_data.bytes_begin(), &size,
+                                       m_data.bytes_end(), &error);
+  if (error)
+    return MakeError(error);
+  m_data = m_data.drop_front(size);
+  return value;
+}
+
+llvm::Expected<llvm::StringRef> Parser::ParseLength() {
+  llvm::Expected<uint64_t> length = ParseULEB();
+  if (!length)
+    return length.takeError();
+  if (*length > m_data.size())
+    return MakeError("truncated string");
+  llvm::StringRef value = m_data.take_front(*length);
+  m_data = m_data.drop_front(*length);
+  return value;
+}
+
+llvm::Expected<StructuredData::ObjectSP> Parser::ParseValue(unsigned depth) {
+  if (m_data.empty())
+    return MakeError("unexpected end of data");
+  if (depth > k_max_depth)
+    return MakeError("nested too deeply");
+
+  const uint8_t tag = m_data.front();
+  m_data = m_data.drop_front();
+  switch (tag) {
+  case BinaryStructuredDataWriter::eTagNull:
+    return std::make_shared<StructuredData::Null>();
+  case BinaryStructuredDataWriter::eTagFalse:
+  case BinaryStructuredDataWriter::eTagTrue:
+    return std::make_shared<StructuredData::Boolean>(
+        tag == BinaryStructuredDataWriter::eTagTrue);
+  case BinaryStructuredDataWriter::eTagUnsigned: {
+    llvm::Expected<uint64_t> value = ParseULEB();
+    if (!value)
+      return value.takeError();
+    return std::make_shared<StructuredData::Integer>(*value);
+  }
+  case BinaryStructuredDataWriter::eTagSigned: {
+    unsigned size;
+    const char *error = nullptr;
+    int64_t value = llvm::decodeSLEB128(m_data.bytes_begin(), &size,
+                                        m_data.bytes_end(), &error);
+    if (error)
+      return MakeError(error);
+    m_data = m_data.drop_front(size);
+    return std::make_shared<StructuredData::Integer>(value);
+  }
+  case BinaryStructuredDataWriter::eTagDouble: {
+    if (m_data.size() < sizeof(uint64_t))
+      return MakeError("truncated double");
+    uint64_t bits = llvm::support::endian::read64le(m_data.data());
+    m_data = m_data.drop_front(sizeof(uint64_t));
+    return std::make_shared<StructuredData::Float>(llvm::BitsToDouble(bits));
+  }
+  case BinaryStructuredDataWriter::eTagString: {
+    llvm::Expected<llvm::StringRef> value = ParseLength();
+    if (!value)
+      return value.takeError();
+    return std::make_shared<StructuredData::String>(*value);
+  }
+  case BinaryStructuredDataWriter::eTagBytes: {
+    llvm::Expected<llvm::StringRef> value = ParseLength();
+    if (!value)
+      return value.takeError();
+    return std::make_shared<StructuredData::String>(
+        llvm::toHex(*value, /*LowerCase=*/true));
+  }
+  case BinaryStructuredDataWriter::eTagArray: {
+    auto array_sp = std::make_shared<StructuredData::Array>();
+    while (!m_data.empty() &&
+           m_data.front() != BinaryStructuredDataWriter::eTagEnd) {
+      llvm::Expected<StructuredData::ObjectSP> item = ParseValue(depth + 1);
+      if (!item)
+        return item.takeError();
+      array_sp->Push(*item);
+    }
+    if (m_data.empty())
+      return MakeError("unterminated array");
+    m_data = m_data.drop_front();
+    return array_sp;
+  }
+  case BinaryStructuredDataWriter::eTagDictionary: {
+    auto dict_sp = std::make_shared<StructuredData::Dictionary>();
+    while (!m_data.empty() &&
+           m_data.front() != BinaryStructuredDataWriter::eTagEnd) {
+      if (m_data.front() != BinaryStructuredDataWriter::eTagString)
+        return MakeError("expected a dictionary key");
+      m_data = m_data.drop_front();
+      llvm::Expected<llvm::StringRef> key = ParseLength();
+      if (!key)
+        return key.takeError();
+      llvm::Expected<StructuredData::ObjectSP> value = ParseValue(depth + 1);
+      if (!value)
+        return value.takeError();
+      dict_sp->AddItem(*key, *value);
+    }
+    if (m_data.empty())
+      return MakeError("unterminated dictionary");
+    m_data = m_data.drop_front();
+    return dict_sp;
+  }
+  default:
+    return MakeError("unknown tag");
+  }
+}
+
+llvm::Expected<StructuredData::ObjectSP>
+process_gdb_remote::ParseBinaryStructuredData(llvm::StringRef data) {
+  Parser parser(data);
+  llvm::Expected<StructuredData::ObjectSP> object = parser.ParseValue(0);
+  if (object && !parser.AtEnd())
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "malformed binary data: trailing bytes");
+  return object;
+}
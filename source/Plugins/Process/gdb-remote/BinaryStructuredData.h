@@ -0,0 +1,82 @@
+//===-- BinaryStructuredData.h ----------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_BinaryStructuredData_h_
+#define liblldb_BinaryStructuredData_h_
+
+#include "lldb/Utility/StructuredData.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+
+#include <string>
+
+namespace lldb_private {
+namespace process_gdb_remote {
+
+/// A binary encoding of the JSON-like replies of the gdb-remote protocol.
+///
+/// Every value starts with a one byte tag. Integers follow as LEB128,
+/// doubles as eight little-endian bytes, and strings and byte blocks as a
+/// ULEB128 length and their bytes. Arrays hold values and dictionaries hold
+/// key strings followed by a value, both up to an end tag.
+/// Byte blocks let binary data such as register values be sent without the
+/// hex encoding JSON needs, they read back as hex strings so that the result
+/// matches what the JSON form of the reply would have parsed into.
+///
+/// The encoding is sent with the gdb-remote binary escaping applied.
+class BinaryStructuredDataWriter {
+public:
+  enum Tag : uint8_t {
+    eTagNull = 0,
+    eTagFalse,
+    eTagTrue,
+    eTagUnsigned,
+    eTagSigned,
+    eTagDouble,
+    eTagString,
+    eTagBytes,
+    eTagArray,
+    eTagDictionary,
+    eTagEnd,
+  };
+
+  void PutNull() { m_data.push_back(eTagNull); }
+  void PutBoolean(bool value) {
+    m_data.push_back(value ? eTagTrue : eTagFalse);
+  }
+  void PutUnsigned(uint64_t value);
+  void PutSigned(int64_t value);
+  void PutDouble(double value);
+  void PutString(llvm::StringRef value);
+  void PutBytes(llvm::ArrayRef<uint8_t> value);
+
+  /// Start an array or dictionary, which is closed by End().
+  void BeginArray() { m_data.push_back(eTagArray); }
+  void BeginDictionary() { m_data.push_back(eTagDictionary); }
+  void End() { m_data.push_back(eTagEnd); }
+
+  /// Start a dictionary entry, the value must be written next.
+  void PutKey(llvm::StringRef key);
+
+  llvm::StringRef GetData() const { return m_data; }
+
+private:
+  void PutLength(llvm::StringRef value);
+
+  std::string m_data;
+};
+
+/// Decode one value written by BinaryStructuredDataWriter.
+llvm::Expected<StructuredData::ObjectSP>
+ParseBinaryStructuredData(llvm::StringRef data);
+
+} // namespace process_gdb_remote
+} // namespace lldb_private
+
+#endif // liblldb_BinaryStructuredData_h_
@@ -0,0 +1,721 @@
+//===-- BreakpointConditionCompiler.cpp -------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "BreakpointConditionCompiler.h"
+
+#include "lldb/Core/Module.h"
+#include "lldb/Core/dwarf.h"
+#include "lldb/Expression/DWARFExpression.h"
+#include "lldb/Symbol/Block.h"
+#include "lldb/Symbol/CompileUnit.h"
+#include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/Type.h"
+#include "lldb/Symbol/Variable.h"
+#include "lldb/Symbol/VariableList.h"
+#include "lldb/Target/Language.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Utility/DataExtractor.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+static llvm::Error MakeError(const llvm::Twine &message) {
+  return llvm::make_error<llvm::StringError>(message,
+                                             llvm::inconvertibleErrorCode());
+}
+
+BreakpointConditionCompiler::TargetScope::TargetScope(
+    Target &target, const Address &addr, RegisterMapper map_register)
+    : m_target(target), m_addr(addr), m_map_register(std::move(map_register)) {
+  addr.CalculateSymbolContext(&m_sc, eSymbolContextModule |
+                                         eSymbolContextCompUnit |
+                                         eSymbolContextFunction |
+                                         eSymbolContextBlock);
+}
+
+bool BreakpointConditionCompiler::TargetScope::IsCFamily() {
+  return m_sc.comp_unit &&
+         Language::LanguageIsCFamily(m_sc.comp_unit->GetLanguage());
+}
+
+uint32_t BreakpointConditionCompiler::TargetScope::GetAddressByteSize() {
+  return m_target.GetArchitecture().GetAddressByteSize();
+}
+
+llvm::Expected<BreakpointConditionCompiler::VariableInfo>
+BreakpointConditionCompiler::TargetScope::FindVariable(llvm::StringRef name) {
+  // Locals and arguments come first, then globals of the compile unit and of
+  // the module.
+  ConstString const_name(name);
+  VariableSP var_sp;
+  if (m_sc.block) {
+    VariableList variables;
+    m_sc.block->AppendVariables(
+        true, true, true,
+        [&](Variable *variable) { return variable->GetName() == const_name; },
+        &variables);
+    var_sp = variables.GetVariableAtIndex(0);
+  }
+  if (!var_sp && m_sc.comp_unit) {
+    if (VariableListSP globals = m_sc.comp_unit->GetVariableList(true))
+      var_sp = globals->FindVariable(const_name);
+  }
+  if (!var_sp && m_sc.module_sp) {
+    VariableList variables;
+    if (m_sc.module_sp->FindGlobalVariables(const_name, nullptr, 2,
+                                            variables) == 1)
+      var_sp = variables.GetVariableAtIndex(0);
+  }
+  if (!var_sp)
+    return MakeError("no variable named '" + name + "'");
+
+  Type *var_type = var_sp->GetType();
+  if (!var_type)
+    return MakeError("variable '" + name + "' has no type");
+  CompilerType compiler_type = var_type->GetFullCompilerType();
+  llvm::Optional<uint64_t> byte_size = compiler_type.GetByteSize(nullptr);
+  if (!byte_size)
+    return MakeError("variable '" + name + "' has no size");
+
+  VariableInfo info;
+  info.variable_sp = var_sp;
+  info.byte_size = *byte_size;
+  if (compiler_type.IsPointerType())
+    info.kind = VariableInfo::ePointer;
+  else if (compiler_type.IsIntegerType(info.is_signed))
+    info.kind = VariableInfo::eInteger;
+
+  DWARFExpression &location = var_sp->LocationExpression();
+  if (!location.IsLocationList() &&
+      location.GetRegisterKind() == eRegisterKindDWARF)
+    location.GetExpressionData(info.location);
+  return info;
+}
+
+llvm::Expected<lldb::addr_t>
+BreakpointConditionCompiler::TargetScope::GetLoadAddress(
+    const VariableInfo &variable, lldb::addr_t file_addr) {
+  llvm::StringRef name = variable.variable_sp->GetName().GetStringRef();
+  SymbolContextScope *scope = variable.variable_sp->GetSymbolContextScope();
+  ModuleSP module_sp =
+      scope ? scope->CalculateSymbolContextModule() : ModuleSP();
+  Address so_addr;
+  if (!module_sp || !module_sp->ResolveFileAddress(file_addr, so_addr))
+    return MakeError("cannot resolve the address of '" + name + "'");
+  const lldb::addr_t load_addr = so_addr.GetLoadAddress(&m_target);
+  if (load_addr == LLDB_INVALID_ADDRESS)
+    return MakeError("'" + name + "' is not loaded");
+  return load_addr;
+}
+
+llvm::Expected<DataExtractor>
+BreakpointConditionCompiler::TargetScope::GetFrameBase() {
+  if (!m_sc.function)
+    return MakeError("no function at the breakpoint");
+  DWARFExpression &frame_base = m_sc.function->GetFrameBaseExpression();
+  DataExtractor data;
+  if (!frame_base.IsLocationList() &&
+      frame_base.GetRegisterKind() == eRegisterKindDWARF)
+    frame_base.GetExpressionData(data);
+  return data;
+}
+
+llvm::Error BreakpointConditionCompiler::TargetScope::CheckPastPrologue() {
+  if (!m_sc.function)
+    return MakeError("no function at the breakpoint");
+  const lldb::addr_t func_addr =
+      m_sc.function->GetAddressRange().GetBaseAddress().GetFileAddress();
+  const lldb::addr_t bp_addr = m_addr.GetFileAddress();
+  if (bp_addr < func_addr ||
+      bp_addr - func_addr < m_sc.function->GetPrologueByteSize())
+    return MakeError("the breakpoint is in the prologue");
+  return llvm::Error::success();
+}
+
+llvm::Optional<uint32_t>
+BreakpointConditionCompiler::TargetScope::MapRegister(uint32_t dwarf_reg_num) {
+  return m_map_register(dwarf_reg_num);
+}
+
+BreakpointConditionCompiler::BreakpointConditionCompiler(Scope &scope)
+    : m_scope(scope), m_address_byte_size(scope.GetAddressByteSize()) {}
+
+llvm::Expected<AgentExpression>
+BreakpointConditionCompiler::Compile(llvm::StringRef condition) {
+  if (!m_scope.IsCFamily())
+    return MakeError("only conditions in C family code are supported");
+
+  m_input = condition;
+  m_expr = AgentExpression();
+  if (llvm::Error error = Lex())
+    return std::move(error);
+
+  llvm::Expected<ValueType> type = ParseLogicalOr();
+  if (!type)
+    return type.takeError();
+  if (m_token.kind != eTokenEnd)
+    return MakeError("unexpected '" + m_token.text + "'");
+
+  m_expr.AppendOpcode(AgentExpression::eOpEnd);
+  return std::move(m_expr);
+}
+
+llvm::Error BreakpointConditionCompiler::Lex() {
+  m_input = m_input.ltrim();
+  if (m_input.empty()) {
+    m_token = Token();
+    return llvm::Error::success();
+  }
+
+  size_t length;
+  const char c = m_input.front();
+  if (llvm::isDigit(c)) {
+    // Take all characters that can continue a number and let EmitNumber()
+    // validate them.
+    length = m_input.find_if_not(
+        [](char c) { return llvm::isAlnum(c) || c == '_' || c == '.'; });
+    m_token.kind = eTokenNumber;
+  } else if (llvm::isAlpha(c) || c == '_') {
+    length = m_input.find_if_not(
+        [](char c) { return llvm::isAlnum(c) || c == '_'; });
+    m_token.kind = eTokenIdentifier;
+  } else {
+    static const char *const g_punctuators[] = {
+        "||", "&&", "==", "!=", "<=", ">=", "<<", ">>", "+", "-", "*",
+        "/",  "%",  "&",  "|",  "^",  "~",  "!",  "<",  ">", "(", ")"};
+    length = 0;
+    for (const char *punctuator : g_punctuators) {
+      if (m_input.startswith(punctuator)) {
+        length = strlen(punctuator);
+        break;
+      }
+    }
+    if (length == 0)
+      return MakeError(llvm::Twine("unsupported character '") +
+                       llvm::Twine(c) + "'");
+    m_token.kind = eTokenPunctuator;
+  }
+
+  if (length == llvm::StringRef::npos)
+    length = m_input.size();
+  m_token.text = m_input.take_front(length);
+  m_input = m_input.drop_front(length);
+  return llvm::Error::success();
+}
+
+bool BreakpointConditionCompiler::IsPunctuator(
+    llvm::StringRef punctuator) const {
+  return m_token.kind == eTokenPunctuator && m_token.text == punctuator;
+}
+
+llvm::Expected<BreakpointConditionCompiler::ValueType>
+BreakpointConditionCompiler::ParseLogicalOr() {
+  llvm::Expected<ValueType> lhs = ParseLogicalAnd();
+  if (!lhs || !IsPunctuator("||"))
+    return lhs;
+
+  // Both operands are evaluated. This doesn't change the result as the
+  // operands have no side effects, and an evaluation error makes the stub
+  // report the hit.
+  m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+  m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+  while (IsPunctuator("||")) {
+    if (llvm::Error error = Lex())
+      return std::move(error);
+    llvm::Expected<ValueType> rhs = ParseLogicalAnd();
+    if (!rhs)
+      return rhs;
+    m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+    m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+    m_expr.AppendOpcode(AgentExpression::eOpBitOr);
+  }
+  return ValueType();
+}
+
+llvm::Expected<BreakpointConditionCompiler::ValueType>
+BreakpointConditionCompiler::ParseLogicalAnd() {
+  llvm::Expected<ValueType> lhs = ParseBitwise(0);
+  if (!lhs || !IsPunctuator("&&"))
+    return lhs;
+
+  m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+  m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+  while (IsPunctuator("&&")) {
+    if (llvm::Error error = Lex())
+      return std::move(error);
+    llvm::Expected<ValueType> rhs = ParseBitwise(0);
+    if (!rhs)
+      return rhs;
+    m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+    m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+    m_expr.AppendOpcode(AgentExpression::eOpBitAnd);
+  }
+  return ValueType();
+}
+
+llvm::Expected<BreakpointConditionCompiler::ValueType>
+BreakpointConditionCompiler::ParseBitwise(unsigned level) {
+  // Inclusive or binds weakest, and has the lowest level.
+  static const struct {
+    const char *punctuator;
+    AgentExpression::Opcode opcode;
+  } g_operators[] = {{"|", AgentExpression::eOpBitOr},
+                     {"^", AgentExpression::eOpBitXor},
+                     {"&", AgentExpression::eOpBitAnd}};
+  const size_t num_levels = llvm::array_lengthof(g_operators);
+
+  auto parse_operand = [&]() {
+    return level + 1 < num_levels ? ParseBitwise(level + 1) : ParseEquality();
+  };
+
+  llvm::Expected<ValueType> lhs = parse_operand();
+  while (lhs && IsPunctuator(g_operators[level].punctuator)) {
+    if (llvm::Error error = Lex())
+      return std::move(error);
+    llvm::Expected<ValueType> rhs = parse_operand();
+    if (!rhs)
+      return rhs;
+    lhs = EmitArithmeticConversion(*lhs, *rhs);
+    if (lhs)
+      m_expr.AppendOpcode(g_operators[level].opcode);
+  }
+  return lhs;
+}
+
+llvm::Expected<BreakpointConditionCompiler::ValueType>
+BreakpointConditionCompiler::ParseEquality() {
+  llvm::Expected<ValueType> lhs = ParseRelational();
+  while (lhs && (IsPunctuator("==") || IsPunctuator("!="))) {
+    const bool is_equal = IsPunctuator("==");
+    if (llvm::Error error = Lex())
+      return std::move(error);
+    llvm::Expected<ValueType> rhs = ParseRelational();
+    if (!rhs)
+      return rhs;
+
+    if (lhs->is_pointer || rhs->is_pointer) {
+      // Pointers can only be compared to null here, the stub doesn't know
+      // about pointee types.
+      if (!(lhs->is_pointer || lhs->is_null_constant) ||
+          !(rhs->is_pointer || rhs->is_null_constant) ||
+          (lhs->is_pointer && rhs->is_pointer))
+        return MakeError("only comparisons of pointers to 0 are supported");
+    } else {
+      llvm::Expected<ValueType> type = EmitArithmeticConversion(*lhs, *rhs);
+      if (!type)
+        return type;
+    }
+    m_expr.AppendOpcode(AgentExpression::eOpEqual);
+    if (!is_equal)
+      m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+    lhs = ValueType();
+  }
+  return lhs;
+}
+
+llvm::Expected<BreakpointConditionCompiler::ValueType>
+BreakpointConditionCompiler::ParseRelational() {
+  llvm::Expected<ValueType> lhs = ParseShift();
+  while (lhs && (IsPunctuator("<") || IsPunctuator(">") ||
+                 IsPunctuator("<=") || IsPunctuator(">="))) {
+    const llvm::StringRef op = m_token.text;
+    if (llvm::Error error = Lex())
+      return std::move(error);
+    llvm::Expected<ValueType> rhs = ParseShift();
+    if (!rhs)
+      return rhs;
+    llvm::Expected<ValueType> type = EmitArithmeticConversion(*lhs, *rhs);
+    if (!type)
+      return type;
+
+    // a > b is b < a, a <= b is !(b < a) and a >= b is !(a < b).
+    if (op == ">" || op == "<=")
+      m_expr.AppendOpcode(AgentExpression::eOpSwap);
+    m_expr.AppendOpcode(type->is_signed ? AgentExpression::eOpLessSigned
+                                        : AgentExpression::eOpLessUnsigned);
+    if (op == "<=" || op == ">=")
+      m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+    lhs = ValueType();
+  }
+  return lhs;
+}
+
+llvm::Expected<BreakpointConditionCompiler::ValueType>
+BreakpointConditionCompiler::ParseShift() {
+  llvm::Expected<ValueType> lhs = ParseAdditive();
+  while (lhs && (IsPunctuator("<<") || IsPunctuator(">>"))) {
+    const bool is_left = IsPunctuator("<<");
+    if (llvm::Error error = Lex())
+      return std::move(error);
+    llvm::Expected<ValueType> rhs = ParseAdditive();
+    if (!rhs)
+      return rhs;
+    if (lhs->is_pointer || rhs->is_pointer)
+      return MakeError("pointer arithmetic is not supported");
+
+    // The result has the type of the left operand.
+    ValueType type = *lhs;
+    type.is_null_constant = false;
+    if (is_left)
+      m_expr.AppendOpcode(AgentExpression::eOpLsh);
+    else
+      m_expr.AppendOpcode(type.is_signed ? AgentExpression::eOpRshSigned
+                                         : AgentExpression::eOpRshUnsigned);
+    EmitTruncation(type);
+    lhs = type;
+  }
+  return lhs;
+}
+
+llvm::Expected<BreakpointConditionCompiler::ValueType>
+BreakpointConditionCompiler::ParseAdditive() {
+  llvm::Expected<ValueType> lhs = ParseMultiplicative();
+  while (lhs && (IsPunctuator("+") || IsPunctuator("-"))) {
+    const bool is_add = IsPunctuator("+");
+    if (llvm::Error error = Lex())
+      return std::move(error);
+    llvm::Expected<ValueType> rhs = ParseMultiplicative();
+    if (!rhs)
+      return rhs;
+    lhs = EmitArithmeticConversion(*lhs, *rhs);
+    if (lhs) {
+      m_expr.AppendOpcode(is_add ? AgentExpression::eOpAdd
+                                 : AgentExpression::eOpSub);
+      EmitTruncation(*lhs);
+    }
+  }
+  return lhs;
+}
+
+llvm::Expected<BreakpointConditionCompiler::ValueType>
+BreakpointConditionCompiler::ParseMultiplicative() {
+  llvm::Expected<ValueType> lhs = ParseUnary();
+  while (lhs && (IsPunctuator("*") || IsPunctuator("/") || IsPunctuator("%"))) {
+    const llvm::StringRef op = m_token.text;
+    if (llvm::Error error = Lex())
+      return std::move(error);
+    llvm::Expected<ValueType> rhs = ParseUnary();
+    if (!rhs)
+      return rhs;
+    lhs = EmitArithmeticConversion(*lhs, *rhs);
+    if (!lhs)
+      return lhs;
+    if (op == "*")
+      m_expr.AppendOpcode(AgentExpression::eOpMul);
+    else if (op == "/")
+      m_expr.AppendOpcode(lhs->is_signed ? AgentExpression::eOpDivSigned
+                                         : AgentExpression::eOpDivUnsigned);
+    else
+      m_expr.AppendOpcode(lhs->is_signed ? AgentExpression::eOpRemSigned
+                                         : AgentExpression::eOpRemUnsigned);
+    EmitTruncation(*lhs);
+  }
+  return lhs;
+}
+
+llvm::Expected<BreakpointConditionCompiler::ValueType>
+BreakpointConditionCompiler::ParseUnary() {
+  if (!IsPunctuator("!") && !IsPunctuator("-") && !IsPunctuator("~") &&
+      !IsPunctuator("+"))
+    return ParsePrimary();
+
+  const llvm::StringRef op = m_token.text;
+  if (llvm::Error error = Lex())
+    return std::move(error);
+  llvm::Expected<ValueType> operand = ParseUnary();
+  if (!operand)
+    return operand;
+
+  if (op == "!") {
+    m_expr.AppendOpcode(AgentExpression::eOpLogNot);
+    return ValueType();
+  }
+  if (operand->is_pointer)
+    return MakeError("pointer arithmetic is not supported");
+
+  ValueType type = *operand;
+  type.is_null_constant = false;
+  if (op == "-") {
+    m_expr.AppendConstant(0);
+    m_expr.AppendOpcode(AgentExpression::eOpSwap);
+    m_expr.AppendOpcode(AgentExpression::eOpSub);
+  } else if (op == "~") {
+    m_expr.AppendOpcode(AgentExpression::eOpBitNot);
+  }
+  EmitTruncation(type);
+  return type;
+}
+
+llvm::Expected<BreakpointConditionCompiler::ValueType>
+BreakpointConditionCompiler::ParsePrimary() {
+  const Token token = m_token;
+  switch (token.kind) {
+  case eTokenEnd:
+    return MakeError("unexpected end of condition");
+
+  case eTokenNumber: {
+    if (llvm::Error error = Lex())
+      return std::move(error);
+    return EmitNumber(token.text);
+  }
+
+  case eTokenIdentifier: {
+    if (llvm::Error error = Lex())
+      return std::move(error);
+    if (token.text == "true" || token.text == "false") {
+      m_expr.AppendConstant(token.text == "true");
+      return ValueType();
+    }
+    return EmitVariable(token.text);
+  }
+
+  case eTokenPunctuator:
+    if (!IsPunctuator("("))
+      break;
+    if (llvm::Error error = Lex())
+      return std::move(error);
+    llvm::Expected<ValueType> type = ParseLogicalOr();
+    if (!type)
+      return type;
+    if (!IsPunctuator(")"))
+      return MakeError("expected ')'");
+    if (llvm::Error error = Lex())
+      return std::move(error);
+    return type;
+  }
+  return MakeError("unexpected '" + token.text + "'");
+}
+
+llvm::Expected<BreakpointConditionCompiler::ValueType>
+BreakpointConditionCompiler::EmitNumber(llvm::StringRef text) {
+  // Split off the suffix.
+  llvm::StringRef digits = text.rtrim("uUlL");
+  llvm::StringRef suffix = text.drop_front(digits.size());
+  const size_t num_u = suffix.count('u') + suffix.count('U');
+  const size_t num_l = suffix.size() - num_u;
+  if (num_u > 1 || num_l > 2 || (num_l == 2 && suffix.lower().find("ll") ==
+                                                   std::string::npos))
+    return MakeError("invalid integer suffix in '" + text + "'");
+
+  uint64_t value;
+  if (digits.getAsInteger(0, value))
+    return MakeError("invalid integer '" + text + "'");
+
+  // The type of a literal is the first of these that can hold its value and
+  // is allowed by its suffix. Decimal literals can only have unsigned types
+  // if they have an u suffix.
+  const unsigned long_bits = m_address_byte_size * 8;
+  const unsigned min_bits = num_l == 0 ? 32 : num_l == 1 ? long_bits : 64;
+  const bool is_decimal = digits.size() == 1 || digits.front() != '0';
+  const ValueType candidates[] = {
+      {32, true}, {32, false}, {64, true}, {64, false}};
+  for (ValueType type : candidates) {
+    if (type.bits < min_bits || (type.is_signed && num_u > 0) ||
+        (!type.is_signed && is_decimal && num_u == 0))
+      continue;
+    const unsigned value_bits = type.is_signed ? type.bits - 1 : type.bits;
+    if (value_bits < 64 && value >> value_bits)
+      continue;
+    type.is_null_constant = value == 0;
+    m_expr.AppendConstant(value);
+    return type;
+  }
+  return MakeError("integer '" + text + "' is too large");
+}
+
+llvm::Expected<BreakpointConditionCompiler::ValueType>
+BreakpointConditionCompiler::EmitVariable(llvm::StringRef name) {
+  llvm::Expected<VariableInfo> variable = m_scope.FindVariable(name);
+  if (!variable)
+    return variable.takeError();
+
+  ValueType type;
+  if (variable->kind == VariableInfo::ePointer) {
+    if (variable->byte_size != m_address_byte_size)
+      return MakeError("variable '" + name + "' has an unsupported size");
+    type.bits = variable->byte_size * 8;
+    type.is_signed = false;
+    type.is_pointer = true;
+  } else if (variable->kind == VariableInfo::eInteger) {
+    if (variable->byte_size == 0 || variable->byte_size > 8)
+      return MakeError("variable '" + name + "' has an unsupported size");
+    // Integers narrower than int are promoted to int.
+    if (variable->byte_size >= 4) {
+      type.bits = variable->byte_size * 8;
+      type.is_signed = variable->is_signed;
+    }
+  } else {
+    return MakeError("variable '" + name +
+                     "' is neither an integer nor a pointer");
+  }
+
+  if (llvm::Error error = EmitVariableValue(name, *variable))
+    return std::move(error);
+  return type;
+}
+
+llvm::Error
+BreakpointConditionCompiler::EmitVariableValue(llvm::StringRef name,
+                                               const VariableInfo &variable) {
+  const DataExtractor &data = variable.location;
+  if (data.GetByteSize() == 0)
+    return MakeError("unsupported location for '" + name + "'");
+
+  lldb::offset_t offset = 0;
+  const uint8_t op = data.GetU8(&offset);
+  bool in_register = false;
+  if (op == DW_OP_addr) {
+    llvm::Expected<lldb::addr_t> load_addr =
+        m_scope.GetLoadAddress(variable, data.GetAddress(&offset));
+    if (!load_addr)
+      return load_addr.takeError();
+    m_expr.AppendConstant(*load_addr);
+  } else if (op >= DW_OP_reg0 && op <= DW_OP_reg31) {
+    in_register = true;
+    llvm::Expected<uint32_t> reg_num = MapRegister(op - DW_OP_reg0);
+    if (!reg_num)
+      return reg_num.takeError();
+    m_expr.AppendRegister(*reg_num);
+  } else if (op == DW_OP_regx) {
+    in_register = true;
+    llvm::Expected<uint32_t> reg_num = MapRegister(data.GetULEB128(&offset));
+    if (!reg_num)
+      return reg_num.takeError();
+    m_expr.AppendRegister(*reg_num);
+  } else if (op >= DW_OP_breg0 && op <= DW_OP_breg31) {
+    if (llvm::Error error = EmitRegisterRelative(op - DW_OP_breg0,
+                                                 data.GetSLEB128(&offset)))
+      return error;
+  } else if (op == DW_OP_bregx) {
+    const uint32_t reg_num = data.GetULEB128(&offset);
+    if (llvm::Error error =
+            EmitRegisterRelative(reg_num, data.GetSLEB128(&offset)))
+      return error;
+  } else if (op == DW_OP_fbreg) {
+    if (llvm::Error error = EmitFrameBase())
+      return error;
+    const int64_t fb_offset = data.GetSLEB128(&offset);
+    if (fb_offset != 0) {
+      m_expr.AppendConstant(fb_offset);
+      m_expr.AppendOpcode(AgentExpression::eOpAdd);
+    }
+  } else {
+    return MakeError("unsupported location for '" + name + "'");
+  }
+  if (offset != data.GetByteSize())
+    return MakeError("unsupported location for '" + name + "'");
+
+  // Registers only hold the values of locals once the prologue is done.
+  if (op != DW_OP_addr) {
+    if (llvm::Error error = m_scope.CheckPastPrologue())
+      return error;
+  }
+
+  if (in_register) {
+    if (variable.byte_size < 8)
+      m_expr.AppendExtend(variable.byte_size * 8, variable.is_signed);
+    return llvm::Error::success();
+  }
+  if (!m_expr.AppendMemoryRead(variable.byte_size, variable.is_signed))
+    return MakeError("'" + name + "' has an unsupported size");
+  return llvm::Error::success();
+}
+
+llvm::Error
+BreakpointConditionCompiler::EmitRegisterRelative(uint32_t dwarf_reg_num,
+                                                  int64_t offset) {
+  llvm::Expected<uint32_t> reg_num = MapRegister(dwarf_reg_num);
+  if (!reg_num)
+    return reg_num.takeError();
+  m_expr.AppendRegister(*reg_num);
+  if (offset != 0) {
+    m_expr.AppendConstant(offset);
+    m_expr.AppendOpcode(AgentExpression::eOpAdd);
+  }
+  return llvm::Error::success();
+}
+
+llvm::Error BreakpointConditionCompiler::EmitFrameBase() {
+  // Frame bases that need unwinding, like DW_OP_call_frame_cfa, are not
+  // supported.
+  llvm::Expected<DataExtractor> frame_base = m_scope.GetFrameBase();
+  if (!frame_base)
+    return frame_base.takeError();
+  const DataExtractor &data = *frame_base;
+  if (data.GetByteSize() == 0)
+    return MakeError("unsupported frame base");
+
+  lldb::offset_t offset = 0;
+  const uint8_t op = data.GetU8(&offset);
+  uint32_t reg_num;
+  int64_t reg_offset = 0;
+  if (op >= DW_OP_reg0 && op <= DW_OP_reg31) {
+    reg_num = op - DW_OP_reg0;
+  } else if (op == DW_OP_regx) {
+    reg_num = data.GetULEB128(&offset);
+  } else if (op >= DW_OP_breg0 && op <= DW_OP_breg31) {
+    reg_num = op - DW_OP_breg0;
+    reg_offset = data.GetSLEB128(&offset);
+  } else if (op == DW_OP_bregx) {
+    reg_num = data.GetULEB128(&offset);
+    reg_offset = data.GetSLEB128(&offset);
+  } else {
+    return MakeError("unsupported frame base");
+  }
+  if (offset != data.GetByteSize())
+    return MakeError("unsupported frame base");
+  return EmitRegisterRelative(reg_num, reg_offset);
+}
+
+llvm::Expected<uint32_t>
+BreakpointConditionCompiler::MapRegister(uint32_t dwarf_reg_num) {
+  llvm::Optional<uint32_t> reg_num = m_scope.MapRegister(dwarf_reg_num);
+  if (!reg_num || *reg_num > UINT16_MAX)
+    return MakeError("the stub has no register with DWARF number " +
+                     llvm::Twine(dwarf_reg_num));
+  return *reg_num;
+}
+
+llvm::Expected<BreakpointConditionCompiler::ValueType>
+BreakpointConditionCompiler::EmitArithmeticConversion(ValueType lhs,
+                                                      ValueType rhs) {
+  if (lhs.is_pointer || rhs.is_pointer)
+    return MakeError("pointer arithmetic is not supported");
+
+  // Both operands have been promoted to at least int. The wider type wins,
+  // at equal width the unsigned one does.
+  ValueType common;
+  if (lhs.bits != rhs.bits)
+    common = lhs.bits > rhs.bits ? lhs : rhs;
+  else
+    common = {lhs.bits, lhs.is_signed && rhs.is_signed};
+  common.is_null_constant = false;
+
+  // The representation of a value only changes if it is converted from a
+  // signed type to an unsigned type of the same width, which needs the sign
+  // extension removed.
+  if (common.bits < 64 && !common.is_signed) {
+    if (rhs.is_signed)
+      m_expr.AppendExtend(common.bits, false);
+    if (lhs.is_signed) {
+      m_expr.AppendOpcode(AgentExpression::eOpSwap);
+      m_expr.AppendExtend(common.bits, false);
+      m_expr.AppendOpcode(AgentExpression::eOpSwap);
+    }
+  }
+  return common;
+}
+
+void BreakpointConditionCompiler::EmitTruncation(ValueType type) {
+  if (type.bits < 64)
+    m_expr.AppendExtend(type.bits, type.is_signed);
+}
@@ -0,0 +1,188 @@
+//===-- BreakpointConditionCompiler.h ---------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_BreakpointConditionCompiler_h_
+#define liblldb_BreakpointConditionCompiler_h_
+
+#include "lldb/Core/Address.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Utility/AgentExpression.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/lldb-private.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+
+#include <functional>
+
+namespace lldb_private {
+namespace process_gdb_remote {
+
+/// Translates breakpoint conditions into agent expressions a remote stub can
+/// evaluate when the breakpoint is hit.
+///
+/// Only conditions whose value the stub can compute exactly like the
+/// expression parser would are translated. These are C expressions made of
+/// integer literals and of local, static and global variables of integer or
+/// pointer type, combined with the arithmetic, bitwise, relational and
+/// logical operators. The variables must live in a register, at a register
+/// relative address or at a fixed address. Anything else is rejected and
+/// left to the debugger.
+class BreakpointConditionCompiler {
+public:
+  /// A variable a condition refers to.
+  struct VariableInfo {
+    enum Kind { eInteger, ePointer, eOther };
+
+    Kind kind = eOther;
+    uint32_t byte_size = 0;
+    bool is_signed = false;
+    /// The DWARF location expression of the variable, empty if the variable
+    /// has no single location expression.
+    DataExtractor location;
+    lldb::VariableSP variable_sp;
+  };
+
+  /// Gives the compiler access to what is in scope at the breakpoint.
+  class Scope {
+  public:
+    virtual ~Scope() = default;
+
+    virtual bool IsCFamily() = 0;
+
+    virtual uint32_t GetAddressByteSize() = 0;
+
+    /// Find the innermost variable named \a name.
+    virtual llvm::Expected<VariableInfo> FindVariable(llvm::StringRef name) = 0;
+
+    /// Convert a DW_OP_addr operand in the location of \a variable into a
+    /// load address.
+    virtual llvm::Expected<lldb::addr_t>
+    GetLoadAddress(const VariableInfo &variable, lldb::addr_t file_addr) = 0;
+
+    /// Return the DWARF frame base expression of the function, empty if it
+    /// has no single expression.
+    virtual llvm::Expected<DataExtractor> GetFrameBase() = 0;
+
+    /// Fail if the breakpoint is in the prologue, where registers and the
+    /// frame base don't hold the values of the locals yet.
+    virtual llvm::Error CheckPastPrologue() = 0;
+
+    /// Map a DWARF register number to the stub's number for the register.
+    virtual llvm::Optional<uint32_t> MapRegister(uint32_t dwarf_reg_num) = 0;
+  };
+
+  /// Maps a DWARF register number to the stub's number for the register.
+  typedef std::function<llvm::Optional<uint32_t>(uint32_t dwarf_reg_num)>
+      RegisterMapper;
+
+  /// The scope at a breakpoint address in a target, as described by the
+  /// debug info.
+  class TargetScope : public Scope {
+  public:
+    /// \param[in] target
+    ///     The target the breakpoint is set in.
+    ///
+    /// \param[in] addr
+    ///     The address of the breakpoint, which determines the variables in
+    ///     scope.
+    ///
+    /// \param[in] map_register
+    ///     Maps the registers in variable locations to the stub's registers.
+    TargetScope(Target &target, const Address &addr,
+                RegisterMapper map_register);
+
+    bool IsCFamily() override;
+    uint32_t GetAddressByteSize() override;
+    llvm::Expected<VariableInfo> FindVariable(llvm::StringRef name) override;
+    llvm::Expected<lldb::addr_t>
+    GetLoadAddress(const VariableInfo &variable,
+                   lldb::addr_t file_addr) override;
+    llvm::Expected<DataExtractor> GetFrameBase() override;
+    llvm::Error CheckPastPrologue() override;
+    llvm::Optional<uint32_t> MapRegister(uint32_t dwarf_reg_num) override;
+
+  private:
+    Target &m_target;
+    Address m_addr;
+    RegisterMapper m_map_register;
+    SymbolContext m_sc;
+  };
+
+  explicit BreakpointConditionCompiler(Scope &scope);
+
+  /// Compile \a condition into an agent expression that leaves a non-zero
+  /// value on the stack if the condition is true.
+  llvm::Expected<AgentExpression> Compile(llvm::StringRef condition);
+
+private:
+  /// The C type of a value on the stack, int by default. Values are kept in
+  /// 64 bits, sign extended for signed types and zero extended for unsigned
+  /// ones.
+  struct ValueType {
+    unsigned bits = 32;
+    bool is_signed = true;
+    bool is_pointer = false;
+    /// Whether this is the literal 0, which compares to pointers.
+    bool is_null_constant = false;
+  };
+
+  enum TokenKind {
+    eTokenEnd,
+    eTokenNumber,
+    eTokenIdentifier,
+    eTokenPunctuator,
+  };
+
+  struct Token {
+    TokenKind kind = eTokenEnd;
+    llvm::StringRef text;
+  };
+
+  llvm::Error Lex();
+  bool IsPunctuator(llvm::StringRef punctuator) const;
+
+  llvm::Expected<ValueType> ParseLogicalOr();
+  llvm::Expected<ValueType> ParseLogicalAnd();
+  llvm::Expected<ValueType> ParseBitwise(unsigned level);
+  llvm::Expected<ValueType> ParseEquality();
+  llvm::Expected<ValueType> ParseRelational();
+  llvm::Expected<ValueType> ParseShift();
+  llvm::Expected<ValueType> ParseAdditive();
+  llvm::Expected<ValueType> ParseMultiplicative();
+  llvm::Expected<ValueType> ParseUnary();
+  llvm::Expected<ValueType> ParsePrimary();
+
+  llvm::Expected<ValueType> EmitNumber(llvm::StringRef text);
+  llvm::Expected<ValueType> EmitVariable(llvm::StringRef name);
+  llvm::Error EmitVariableValue(llvm::StringRef name,
+                                const VariableInfo &variable);
+  llvm::Error EmitRegisterRelative(uint32_t dwarf_reg_num, int64_t offset);
+  llvm::Error EmitFrameBase();
+  llvm::Expected<uint32_t> MapRegister(uint32_t dwarf_reg_num);
+
+  /// Convert the operands on top of the stack to their common type for an
+  /// arithmetic or relational operator.
+  llvm::Expected<ValueType> EmitArithmeticConversion(ValueType lhs,
+                                                     ValueType rhs);
+
+  /// Wrap the result of an operator around to the width of \a type.
+  void EmitTruncation(ValueType type);
+
+  Scope &m_scope;
+  uint32_t m_address_byte_size;
+
+  llvm::StringRef m_input;
+  Token m_token;
+  AgentExpression m_expr;
+};
+
+} // namespace process_gdb_remote
+} // namespace lldb_private
+
+#endif // liblldb_BreakpointConditionCompiler_h_
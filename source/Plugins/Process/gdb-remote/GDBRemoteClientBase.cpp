@@ -169,6 +169,97 @@ GDBRemoteClientBase::SendPacketAndWaitForResponse(
   return SendPacketAndWaitForResponseNoLock(payload, response);
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteClientBase::SendPacketsAndWaitForResponses(
+    llvm::ArrayRef<std::string> payloads,
+    std::vector<StringExtractorGDBRemote> &responses, bool send_async) {
+  responses.clear();
+  Lock lock(*this, send_async);
+  if (!lock) {
+    if (Log *log =
+            ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PROCESS))
+      LLDB_LOGF(log,
+                "GDBRemoteClientBase::%s failed to get mutex, not sending "
+                "%zu packets (send_async=%d)",
+                __FUNCTION__, payloads.size(), send_async);
+    return PacketResult::ErrorSendFailed;
+  }
+
+  // With acks enabled every packet waits for its ack before the next one can
+  // be sent, so there is nothing to gain from pipelining.
+  if (GetSendAcks()) {
+    for (const std::string &payload : payloads) {
+      StringExtractorGDBRemote response;
+      PacketResult packet_result =
+          SendPacketAndWaitForResponseNoLock(payload, response);
+      if (packet_result != PacketResult::Success)
+        return packet_result;
+      responses.push_back(std::move(response));
+    }
+    return PacketResult::Success;
+  }
+
+  PacketResult send_result = PacketResult::Success;
+  size_t num_sent = 0;
+  size_t num_to_send = payloads.size();
+  while (responses.size() < num_to_send) {
+    while (num_sent < num_to_send &&
+           num_sent - responses.size() < k_max_packets_in_flight) {
+      send_result = SendPacketNoLock(payloads[num_sent]);
+      if (send_result != PacketResult::Success) {
+        // Still collect the responses of the packets that are in flight, so
+        // that they don't get mistaken for the responses of later packets.
+        num_to_send = num_sent;
+        break;
+      }
+      // Only a packet sent while nothing else is in flight has to wait for
+      // the full latency of the connection.
+      if (num_sent == responses.size())
+        ++m_round_trips;
+      ++num_sent;
+    }
+    if (responses.size() == num_to_send)
+      break;
+
+    // Unlike ReadResponseNoLock, don't skip a response that looks invalid for
+    // its packet, and don't resync with qEcho on a timeout. With more packets
+    // in flight, the packets read next are the responses of the next packets.
+    StringExtractorGDBRemote response;
+    PacketResult packet_result =
+        ReadPacket(response, GetPacketTimeout(), false);
+    if (packet_result != PacketResult::Success) {
+      DiscardPipelinedResponses(num_sent - responses.size());
+      return packet_result;
+    }
+    responses.push_back(std::move(response));
+  }
+  return send_result;
+}
+
+void GDBRemoteClientBase::DiscardPipelinedResponses(size_t num_outstanding) {
+  // The response that could not be read and those of the packets sent after
+  // it can still arrive, and would be taken for the responses of the next
+  // packets. Read them if they arrive in time, otherwise drop the connection
+  // rather than getting out of sync with the stub.
+  Log *log = ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PACKETS);
+  for (size_t i = 0; i < num_outstanding; ++i) {
+    if (!IsConnected())
+      return;
+    StringExtractorGDBRemote response;
+    if (ReadPacket(response, GetPacketTimeout(), false) !=
+        PacketResult::Success) {
+      LLDB_LOGF(log,
+                "GDBRemoteClientBase::%s lost %zu pipelined responses, "
+                "disconnecting",
+                __FUNCTION__, num_outstanding - i);
+      Disconnect();
+      return;
+    }
+    LLDB_LOGF(log, "GDBRemoteClientBase::%s discarded response \"%s\"",
+              __FUNCTION__, response.GetStringRef().data());
+  }
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteClientBase::SendPacketAndReceiveResponseWithOutputSupport(
     llvm::StringRef payload, StringExtractorGDBRemote &response,
@@ -188,6 +279,7 @@ GDBRemoteClientBase::SendPacketAndReceiveResponseWithOutputSupport(
   PacketResult packet_result = SendPacketNoLock(payload);
   if (packet_result != PacketResult::Success)
     return packet_result;
+  ++m_round_trips;
 
   return ReadPacketWithOutputSupport(response, GetPacketTimeout(), true,
                                      output_callback);
@@ -199,7 +291,15 @@ GDBRemoteClientBase::SendPacketAndWaitForResponseNoLock(
   PacketResult packet_result = SendPacketNoLock(payload);
   if (packet_result != PacketResult::Success)
     return packet_result;
+  ++m_round_trips;
 
+  return ReadResponseNoLock(payload, response);
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteClientBase::ReadResponseNoLock(llvm::StringRef payload,
+                                        StringExtractorGDBRemote &response) {
+  PacketResult packet_result = PacketResult::Success;
   const size_t max_response_retries = 3;
   for (size_t i = 0; i < max_response_retries; ++i) {
     packet_result = ReadPacket(response, GetPacketTimeout(), true);
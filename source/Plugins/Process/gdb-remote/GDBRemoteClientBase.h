@@ -11,6 +11,7 @@
 
 #include "GDBRemoteCommunication.h"
 
+#include <atomic>
 #include <condition_variable>
 
 namespace lldb_private {
@@ -45,6 +46,24 @@ public:
                                             StringExtractorGDBRemote &response,
                                             bool send_async);
 
+  /// Send independent packets and wait for all of their responses.
+  ///
+  /// When acks are disabled, up to k_max_packets_in_flight packets are sent
+  /// before their responses are read, so the batch pays the latency of the
+  /// connection about once instead of once per packet. The stub answers
+  /// packets in the order it receives them, which matches each response to
+  /// its packet.
+  ///
+  /// \param[out] responses
+  ///   The responses of the packets, in order, up to the first packet that
+  ///   could not be sent or got no response.
+  ///
+  /// \return
+  ///   Success if every packet got a response, the first failure otherwise.
+  PacketResult SendPacketsAndWaitForResponses(
+      llvm::ArrayRef<std::string> payloads,
+      std::vector<StringExtractorGDBRemote> &responses, bool send_async);
+
   PacketResult SendPacketAndReceiveResponseWithOutputSupport(
       llvm::StringRef payload, StringExtractorGDBRemote &response,
       bool send_async,
@@ -53,6 +72,10 @@ public:
   bool SendvContPacket(llvm::StringRef payload,
                        StringExtractorGDBRemote &response);
 
+  /// Get the number of packets that were sent to wait for their response,
+  /// i.e. how often the latency of the connection had to be paid.
+  uint64_t GetRoundTripCount() const { return m_round_trips; }
+
   class Lock {
   public:
     Lock(GDBRemoteClientBase &comm, bool interrupt);
@@ -81,6 +104,17 @@ protected:
   virtual void OnRunPacketSent(bool first);
 
 private:
+  /// Keep the pipeline short enough that neither side can fill its socket
+  /// buffers while the other one is not reading.
+  static const size_t k_max_packets_in_flight = 32;
+
+  PacketResult ReadResponseNoLock(llvm::StringRef payload,
+                                  StringExtractorGDBRemote &response);
+
+  /// Read and drop the responses of \a num_outstanding pipelined packets
+  /// after reading one of them failed. Disconnects if they don't arrive.
+  void DiscardPipelinedResponses(size_t num_outstanding);
+
   /// Variables handling synchronization between the Continue thread and any
   /// other threads wishing to send packets over the connection. Either the
   /// continue thread has control over the connection (m_is_running == true) or
@@ -125,6 +159,8 @@ private:
   /// now they just use a simple mutex.
   std::recursive_mutex m_async_mutex;
 
+  std::atomic<uint64_t> m_round_trips{0};
+
   bool ShouldStop(const UnixSignals &signals,
                   StringExtractorGDBRemote &response);
 
@@ -29,6 +29,7 @@
 #include "lldb/Target/Platform.h"
 #include "lldb/Utility/Event.h"
 #include "lldb/Utility/FileSpec.h"
+#include "lldb/Utility/LZ4.h"
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/StreamString.h"
@@ -68,7 +69,7 @@ GDBRemoteCommunication::GDBRemoteCommunication(const char *comm_name,
 #endif
       m_echo_number(0), m_supports_qEcho(eLazyBoolCalculate), m_history(512),
       m_send_acks(true), m_compression_type(CompressionType::None),
-      m_listen_url() {
+      m_send_compression_type(CompressionType::None), m_listen_url() {
 }
 
 // Destructor
@@ -119,8 +120,70 @@ size_t GDBRemoteCommunication::SendNack() {
   return bytes_written;
 }
 
+// Payloads smaller than this are sent uncompressed, the compressed stream
+// header and the escaping eat most of what could be gained.
+static const size_t k_min_compressed_payload_size = 384;
+
+std::string GDBRemoteCommunication::CompressPayload(llvm::StringRef payload) {
+  llvm::ArrayRef<uint8_t> input(payload.bytes_begin(), payload.size());
+  std::vector<uint8_t> compressed;
+  if (payload.size() >= k_min_compressed_payload_size) {
+    switch (m_send_compression_type) {
+    case CompressionType::LZ4:
+      lz4::Compress(input, compressed);
+      break;
+    case CompressionType::ZlibDeflate:
+#if defined(HAVE_LIBZ)
+    {
+      // Raw deflate without the zlib header, which is what DecompressPacket
+      // and libcompression's COMPRESSION_ZLIB expect.
+      z_stream stream;
+      memset(&stream, 0, sizeof(z_stream));
+      if (deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, -15, 8,
+                       Z_DEFAULT_STRATEGY) == Z_OK) {
+        compressed.resize(deflateBound(&stream, input.size()));
+        stream.next_in = const_cast<Bytef *>(input.data());
+        stream.avail_in = input.size();
+        stream.next_out = compressed.data();
+        stream.avail_out = compressed.size();
+        if (deflate(&stream, Z_FINISH) == Z_STREAM_END)
+          compressed.resize(stream.total_out);
+        else
+          compressed.clear();
+        deflateEnd(&stream);
+      }
+    }
+#endif
+      break;
+    default:
+      break;
+    }
+  }
+
+  if (!compressed.empty()) {
+    std::string framed = "C" + std::to_string(payload.size()) + ":";
+    framed.reserve(framed.size() + compressed.size() * 9 / 8);
+    for (uint8_t byte : compressed) {
+      if (byte == '#' || byte == '$' || byte == '}' || byte == '*') {
+        framed.push_back('}');
+        framed.push_back(byte ^ 0x20);
+      } else
+        framed.push_back(byte);
+    }
+    if (framed.size() <= payload.size())
+      return framed;
+  }
+  return "N" + payload.str();
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunication::SendPacketNoLock(llvm::StringRef payload) {
+  std::string framed;
+  if (m_send_compression_type != CompressionType::None) {
+    framed = CompressPayload(payload);
+    payload = framed;
+  }
+
   StreamString packet(0, 4, eByteOrderBig);
   packet.PutChar('$');
   packet.Write(payload.data(), payload.size());
@@ -131,6 +194,25 @@ GDBRemoteCommunication::SendPacketNoLock(llvm::StringRef payload) {
   return SendRawPacketNoLock(packet_str);
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunication::SendNotificationPacketNoLock(
+    llvm::StringRef notify_type, llvm::StringRef payload) {
+  std::string content = notify_type.str();
+  content += ':';
+  content += payload;
+  if (m_send_compression_type != CompressionType::None)
+    content = CompressPayload(content);
+
+  StreamString packet(0, 4, eByteOrderBig);
+  packet.PutChar('%');
+  packet.Write(content.data(), content.size());
+  packet.PutChar('#');
+  packet.PutHex8(CalculcateChecksum(content));
+  std::string packet_str = packet.GetString();
+
+  return SendRawPacketNoLock(packet_str, /*skip_ack=*/true);
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunication::SendRawPacketNoLock(llvm::StringRef packet,
                                             bool skip_ack) {
@@ -495,13 +577,13 @@ bool GDBRemoteCommunication::DecompressPacket() {
                 (int)(pkt_size), m_bytes.c_str(), (uint8_t)packet_checksum,
                 (uint8_t)actual_checksum);
     }
-    // Send the ack or nack if needed
+    // Send the nack if needed, the ack is sent by CheckForPacket once it has
+    // the decompressed packet. Notifications aren't acknowledged.
     if (!success) {
-      SendNack();
+      if (m_bytes[0] != '%')
+        SendNack();
       m_bytes.erase(0, size_of_first_packet);
       return false;
-    } else {
-      SendAck();
     }
   }
 
@@ -509,6 +591,14 @@ bool GDBRemoteCommunication::DecompressPacket() {
     // This packet was not compressed -- delete the 'N' character at the start
     // and the packet may be processed as-is.
     m_bytes.erase(1, 1);
+    // The checksum covered the 'N', fix it up for CheckForPacket.
+    if (GetSendAcks()) {
+      char checksum_str[3];
+      snprintf(checksum_str, sizeof(checksum_str), "%02x",
+               (uint8_t)CalculcateChecksum(
+                   llvm::StringRef(m_bytes).substr(1, hash_mark_idx - 2)));
+      m_bytes.replace(hash_mark_idx, 2, checksum_str, 2);
+    }
     return true;
   }
 
@@ -584,6 +674,20 @@ bool GDBRemoteCommunication::DecompressPacket() {
   }
 #endif
 
+  if (decompressed_bytes == 0 && decompressed_bufsize != ULONG_MAX &&
+      decompressed_buffer != nullptr &&
+      m_compression_type == CompressionType::LZ4) {
+    llvm::Expected<size_t> size = lz4::Decompress(
+        unescaped_content,
+        llvm::MutableArrayRef<uint8_t>(decompressed_buffer,
+                                       decompressed_bufsize));
+    if (size)
+      decompressed_bytes = *size;
+    else
+      LLDB_LOG_ERROR(log, size.takeError(),
+                     "failed to decompress packet: {0}");
+  }
+
 #if defined(HAVE_LIBZ)
   if (decompressed_bytes == 0 && decompressed_bufsize != ULONG_MAX &&
       decompressed_buffer != nullptr &&
@@ -857,11 +961,14 @@ GDBRemoteCommunication::CheckForPacket(const uint8_t *src, size_t src_len,
                         (int)(total_length), m_bytes.c_str(),
                         (uint8_t)packet_checksum, (uint8_t)actual_checksum);
             }
-            // Send the ack or nack if needed
-            if (!success)
-              SendNack();
-            else
-              SendAck();
+            // Send the ack or nack if needed, notifications aren't
+            // acknowledged.
+            if (!isNotifyPacket) {
+              if (!success)
+                SendNack();
+              else
+                SendAck();
+            }
           }
         } else {
           success = false;
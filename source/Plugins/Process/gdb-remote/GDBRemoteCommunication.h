@@ -44,7 +44,7 @@ enum class CompressionType {
                // libcompression
   LZFSE,       // an Apple compression scheme, requires Apple's libcompression
   LZ4, // lz compression - called "lz4 raw" in libcompression terms, compat with
-       // https://code.google.com/p/lz4/
+       // https://code.google.com/p/lz4/, always available
   LZMA, // Lempel–Ziv–Markov chain algorithm
 };
 
@@ -149,8 +149,15 @@ protected:
                       // a single process
 
   CompressionType m_compression_type;
+  // The compression of the packets we send. This is separate from
+  // m_compression_type since only the server compresses its packets.
+  CompressionType m_send_compression_type;
 
   PacketResult SendPacketNoLock(llvm::StringRef payload);
+  // Sends an asynchronous "%<notify_type>:<payload>" notification, which is
+  // not acknowledged by the other side.
+  PacketResult SendNotificationPacketNoLock(llvm::StringRef notify_type,
+                                            llvm::StringRef payload);
   PacketResult SendRawPacketNoLock(llvm::StringRef payload,
                                    bool skip_ack = false);
 
@@ -174,6 +181,18 @@ protected:
     return m_compression_type != CompressionType::None;
   }
 
+  // Compress all packets sent from now on with the given type. Payloads
+  // that are too small to gain anything are still sent, but in the
+  // "N<payload>" uncompressed form, since the other side expects every
+  // packet to be framed.
+  void EnableSendCompression(CompressionType type) {
+    m_send_compression_type = type;
+  }
+
+  // Returns the payload framed for the send compression: "C<size>:" followed
+  // by the escaped compressed payload, or "N" followed by the payload.
+  std::string CompressPayload(llvm::StringRef payload);
+
   // If compression is enabled, decompress the packet in m_bytes and update
   // m_bytes with the uncompressed version.
   // Returns 'true' packet was decompressed and m_bytes is the now-decompressed
@@ -29,6 +29,7 @@
 #include "lldb/Utility/State.h"
 #include "lldb/Utility/StreamString.h"
 
+#include "BinaryStructuredData.h"
 #include "ProcessGDBRemote.h"
 #include "ProcessGDBRemoteLog.h"
 #include "lldb/Host/Config.h"
@@ -81,6 +82,10 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_supports_jLoadedDynamicLibrariesInfos(eLazyBoolCalculate),
       m_supports_jGetSharedCacheInfo(eLazyBoolCalculate),
       m_supports_QPassSignals(eLazyBoolCalculate),
+      m_supports_multi_mem_read(eLazyBoolCalculate),
+      m_supports_conditional_breakpoints(eLazyBoolCalculate),
+      m_supports_non_stop_step_over(eLazyBoolCalculate),
+      m_supports_qThreadsInfoBinary(eLazyBoolCalculate),
       m_supports_error_string_reply(eLazyBoolCalculate),
       m_supports_qProcessInfoPID(true), m_supports_qfProcessInfo(true),
       m_supports_qUserName(true), m_supports_qGroupName(true),
@@ -95,7 +100,8 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_num_supported_hardware_watchpoints(0), m_host_arch(), m_process_arch(),
       m_os_build(), m_os_kernel(), m_hostname(), m_gdb_server_name(),
       m_gdb_server_version(UINT32_MAX), m_default_packet_timeout(0),
-      m_max_packet_size(0), m_qSupported_response(),
+      m_max_packet_size(0), m_qSupported_response(), m_packet_compression(),
+      m_use_binary_threads_info(true),
       m_supported_async_json_packets_is_valid(false),
       m_supported_async_json_packets_sp(), m_qXfer_memory_map(),
       m_qXfer_memory_map_loaded(false) {}
@@ -150,6 +156,34 @@ bool GDBRemoteCommunicationClient::GetQPassSignalsSupported() {
   return m_supports_QPassSignals == eLazyBoolYes;
 }
 
+bool GDBRemoteCommunicationClient::GetMultiMemReadSupported() {
+  if (m_supports_multi_mem_read == eLazyBoolCalculate) {
+    GetRemoteQSupported();
+  }
+  return m_supports_multi_mem_read == eLazyBoolYes;
+}
+
+bool GDBRemoteCommunicationClient::GetConditionalBreakpointsSupported() {
+  if (m_supports_conditional_breakpoints == eLazyBoolCalculate) {
+    GetRemoteQSupported();
+  }
+  return m_supports_conditional_breakpoints == eLazyBoolYes;
+}
+
+bool GDBRemoteCommunicationClient::GetNonStopStepOverSupported() {
+  if (m_supports_non_stop_step_over == eLazyBoolCalculate) {
+    GetRemoteQSupported();
+  }
+  return m_supports_non_stop_step_over == eLazyBoolYes;
+}
+
+bool GDBRemoteCommunicationClient::GetThreadsInfoBinarySupported() {
+  if (m_supports_qThreadsInfoBinary == eLazyBoolCalculate) {
+    GetRemoteQSupported();
+  }
+  return m_supports_qThreadsInfoBinary == eLazyBoolYes;
+}
+
 bool GDBRemoteCommunicationClient::GetAugmentedLibrariesSVR4ReadSupported() {
   if (m_supports_augmented_libraries_svr4_read == eLazyBoolCalculate) {
     GetRemoteQSupported();
@@ -291,6 +325,10 @@ void GDBRemoteCommunicationClient::ResetDiscoverableSettings(bool did_exec) {
     m_supports_qXfer_features_read = eLazyBoolCalculate;
     m_supports_qXfer_memory_map_read = eLazyBoolCalculate;
     m_supports_augmented_libraries_svr4_read = eLazyBoolCalculate;
+    m_supports_multi_mem_read = eLazyBoolCalculate;
+    m_supports_conditional_breakpoints = eLazyBoolCalculate;
+    m_supports_non_stop_step_over = eLazyBoolCalculate;
+    m_supports_qThreadsInfoBinary = eLazyBoolCalculate;
     m_supports_qProcessInfoPID = true;
     m_supports_qfProcessInfo = true;
     m_supports_qUserName = true;
@@ -375,10 +413,10 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
     // Look for a list of compressions in the features list e.g.
     // qXfer:features:read+;PacketSize=20000;qEcho+;SupportedCompressions=zlib-
     // deflate,lzma
-    const char *features_list = ::strstr(response_cstr, "qXfer:features:");
-    if (features_list) {
+    // lldb-server doesn't send qXfer:features, so search the whole reply.
+    {
       const char *compressions =
-          ::strstr(features_list, "SupportedCompressions=");
+          ::strstr(response_cstr, "SupportedCompressions=");
       if (compressions) {
         std::vector<std::string> supported_compressions;
         compressions += sizeof("SupportedCompressions=") - 1;
@@ -426,6 +464,26 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
     else
       m_supports_QPassSignals = eLazyBoolNo;
 
+    if (::strstr(response_cstr, "MultiMemRead+"))
+      m_supports_multi_mem_read = eLazyBoolYes;
+    else
+      m_supports_multi_mem_read = eLazyBoolNo;
+
+    if (::strstr(response_cstr, "ConditionalBreakpoints+"))
+      m_supports_conditional_breakpoints = eLazyBoolYes;
+    else
+      m_supports_conditional_breakpoints = eLazyBoolNo;
+
+    if (::strstr(response_cstr, "NonStopStepOver+"))
+      m_supports_non_stop_step_over = eLazyBoolYes;
+    else
+      m_supports_non_stop_step_over = eLazyBoolNo;
+
+    if (::strstr(response_cstr, "qThreadsInfoBinary+"))
+      m_supports_qThreadsInfoBinary = eLazyBoolYes;
+    else
+      m_supports_qThreadsInfoBinary = eLazyBoolNo;
+
     const char *packet_size_str = ::strstr(response_cstr, "PacketSize=");
     if (packet_size_str) {
       StringExtractorGDBRemote packet_response(packet_size_str +
@@ -562,6 +620,28 @@ StructuredData::ObjectSP GDBRemoteCommunicationClient::GetThreadsInfo() {
   // Get information on all threads at one using the "jThreadsInfo" packet
   StructuredData::ObjectSP object_sp;
 
+  // The binary form of the reply sends the registers as raw bytes and needs
+  // no JSON parsing, which matters with thousands of threads.
+  if (m_use_binary_threads_info && GetThreadsInfoBinarySupported()) {
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse("qThreadsInfoBinary", response, false) ==
+            PacketResult::Success &&
+        !response.IsErrorResponse()) {
+      if (response.IsUnsupportedResponse()) {
+        m_supports_qThreadsInfoBinary = eLazyBoolNo;
+      } else {
+        llvm::Expected<StructuredData::ObjectSP> binary_object =
+            ParseBinaryStructuredData(response.GetStringRef());
+        if (binary_object)
+          return *binary_object;
+        LLDB_LOG_ERROR(
+            ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PACKETS),
+            binary_object.takeError(),
+            "failed to decode the qThreadsInfoBinary reply: {0}");
+      }
+    }
+  }
+
   if (m_supports_jThreadsInfo) {
     StringExtractorGDBRemote response;
     response.SetResponseValidatorToJSON();
@@ -1018,6 +1098,13 @@ void GDBRemoteCommunicationClient::MaybeEnableCompression(
   CompressionType avail_type = CompressionType::None;
   std::string avail_name;
 
+  // Only consider the compression the user asked for, "none" matches none.
+  if (!m_packet_compression.empty()) {
+    if (!llvm::is_contained(supported_compressions, m_packet_compression))
+      return;
+    supported_compressions = {m_packet_compression};
+  }
+
 #if defined(HAVE_LIBCOMPRESSION)
   if (avail_type == CompressionType::None) {
     for (auto compression : supported_compressions) {
@@ -1054,7 +1141,7 @@ void GDBRemoteCommunicationClient::MaybeEnableCompression(
   }
 #endif
 
-#if defined(HAVE_LIBCOMPRESSION)
+  // lz4 is implemented in-tree and always available.
   if (avail_type == CompressionType::None) {
     for (auto compression : supported_compressions) {
       if (compression == "lz4") {
@@ -1064,7 +1151,6 @@ void GDBRemoteCommunicationClient::MaybeEnableCompression(
       }
     }
   }
-#endif
 
 #if defined(HAVE_LIBCOMPRESSION)
   if (avail_type == CompressionType::None) {
@@ -1446,6 +1532,70 @@ Status GDBRemoteCommunicationClient::Detach(bool keep_stopped) {
   return error;
 }
 
+bool GDBRemoteCommunicationClient::ReadMemoryRanges(
+    llvm::ArrayRef<Range<lldb::addr_t, lldb::addr_t>> ranges, uint8_t *buf,
+    llvm::MutableArrayRef<size_t> bytes_read) {
+  assert(ranges.size() == bytes_read.size());
+  Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_MEMORY));
+
+  StreamString packet;
+  packet.PutCString("MultiMemRead:ranges:");
+  for (size_t i = 0; i < ranges.size(); ++i)
+    packet.Printf("%s%" PRIx64 ",%" PRIx64, i == 0 ? "" : ",",
+                  ranges[i].GetRangeBase(), ranges[i].GetByteSize());
+  packet.PutChar(';');
+
+  StringExtractorGDBRemote response;
+  if (SendPacketAndWaitForResponse(packet.GetString(), response, true) !=
+      PacketResult::Success)
+    return false;
+  if (response.IsUnsupportedResponse()) {
+    m_supports_multi_mem_read = eLazyBoolNo;
+    return false;
+  }
+  if (!response.IsNormalResponse())
+    return false;
+
+  // The reply is the number of bytes read from each range, followed by the
+  // bytes of all ranges:
+  // <bytes read>[,<bytes read>]*;<binary data>
+  llvm::StringRef sizes, data;
+  std::tie(sizes, data) = response.GetStringRef().split(';');
+  llvm::SmallVector<llvm::StringRef, 16> size_strs;
+  sizes.split(size_strs, ',');
+  if (size_strs.size() != ranges.size()) {
+    LLDB_LOGF(log, "MultiMemRead reply has %zu sizes for %zu ranges",
+              size_strs.size(), ranges.size());
+    return false;
+  }
+  std::vector<size_t> sizes_read(ranges.size());
+  size_t total_read = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    uint64_t size;
+    if (size_strs[i].getAsInteger(16, size) ||
+        size > ranges[i].GetByteSize()) {
+      LLDB_LOGF(log, "MultiMemRead reply has an invalid size for range %zu",
+                i);
+      return false;
+    }
+    sizes_read[i] = size;
+    total_read += size;
+  }
+  if (total_read != data.size()) {
+    LLDB_LOGF(log, "MultiMemRead reply has %zu bytes instead of %zu",
+              data.size(), total_read);
+    return false;
+  }
+
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    memcpy(buf, data.data(), sizes_read[i]);
+    data = data.drop_front(sizes_read[i]);
+    buf += ranges[i].GetByteSize();
+    bytes_read[i] = sizes_read[i];
+  }
+  return true;
+}
+
 Status GDBRemoteCommunicationClient::GetMemoryRegionInfo(
     lldb::addr_t addr, lldb_private::MemoryRegionInfo &region_info) {
   Status error;
@@ -2658,28 +2808,34 @@ bool GDBRemoteCommunicationClient::GetThreadStopInfo(
 }
 
 uint8_t GDBRemoteCommunicationClient::SendGDBStoppointTypePacket(
-    GDBStoppointType type, bool insert, addr_t addr, uint32_t length) {
+    GDBStoppointType type, bool insert, addr_t addr, uint32_t length,
+    llvm::ArrayRef<AgentExpression> conditions) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
-  LLDB_LOGF(log, "GDBRemoteCommunicationClient::%s() %s at addr = 0x%" PRIx64,
-            __FUNCTION__, insert ? "add" : "remove", addr);
+  LLDB_LOGF(log,
+            "GDBRemoteCommunicationClient::%s() %s at addr = 0x%" PRIx64
+            " with %zu conditions",
+            __FUNCTION__, insert ? "add" : "remove", addr, conditions.size());
 
   // Check if the stub is known not to support this breakpoint type
   if (!SupportsGDBStoppointPacket(type))
     return UINT8_MAX;
   // Construct the breakpoint packet
-  char packet[64];
-  const int packet_len =
-      ::snprintf(packet, sizeof(packet), "%c%i,%" PRIx64 ",%x",
-                 insert ? 'Z' : 'z', type, addr, length);
-  // Check we haven't overwritten the end of the packet buffer
-  assert(packet_len + 1 < (int)sizeof(packet));
-  UNUSED_IF_ASSERT_DISABLED(packet_len);
+  StreamString packet;
+  packet.Printf("%c%i,%" PRIx64 ",%x", insert ? 'Z' : 'z', type, addr,
+                length);
+  if (insert) {
+    for (const AgentExpression &condition : conditions) {
+      llvm::ArrayRef<uint8_t> bytecode = condition.GetBytecode();
+      packet.Printf(";X%zx,", bytecode.size());
+      packet.PutBytesAsRawHex8(bytecode.data(), bytecode.size());
+    }
+  }
   StringExtractorGDBRemote response;
   // Make sure the response is either "OK", "EXX" where XX are two hex digits,
   // or "" (unsupported)
   response.SetResponseValidatorToOKErrorNotSupported();
   // Try to send the breakpoint packet, and check that it was correctly sent
-  if (SendPacketAndWaitForResponse(packet, response, true) ==
+  if (SendPacketAndWaitForResponse(packet.GetString(), response, true) ==
       PacketResult::Success) {
     // Receive and OK packet when the breakpoint successfully placed
     if (response.IsOKResponse())
@@ -3506,36 +3662,20 @@ Status GDBRemoteCommunicationClient::SendGetTraceDataPacket(
   return error;
 }
 
-bool GDBRemoteCommunicationClient::GetModuleInfo(
-    const FileSpec &module_file_spec, const lldb_private::ArchSpec &arch_spec,
-    ModuleSpec &module_spec) {
-  if (!m_supports_qModuleInfo)
-    return false;
-
-  std::string module_path = module_file_spec.GetPath(false);
-  if (module_path.empty())
-    return false;
-
+static std::string MakeModuleInfoPacket(llvm::StringRef module_path,
+                                        const llvm::Triple &triple) {
   StreamString packet;
   packet.PutCString("qModuleInfo:");
   packet.PutStringAsRawHex8(module_path);
   packet.PutCString(";");
-  const auto &triple = arch_spec.GetTriple().getTriple();
-  packet.PutStringAsRawHex8(triple);
-
-  StringExtractorGDBRemote response;
-  if (SendPacketAndWaitForResponse(packet.GetString(), response, false) !=
-      PacketResult::Success)
-    return false;
-
-  if (response.IsErrorResponse())
-    return false;
-
-  if (response.IsUnsupportedResponse()) {
-    m_supports_qModuleInfo = false;
-    return false;
-  }
+  packet.PutStringAsRawHex8(triple.getTriple());
+  return packet.GetString();
+}
 
+static void ParseModuleInfoResponse(StringExtractorGDBRemote &response,
+                                    const FileSpec &module_file_spec,
+                                    const ArchSpec &arch_spec,
+                                    ModuleSpec &module_spec) {
   llvm::StringRef name;
   llvm::StringRef value;
 
@@ -3568,10 +3708,74 @@ bool GDBRemoteCommunicationClient::GetModuleInfo(
       module_spec.GetFileSpec() = FileSpec(path, arch_spec.GetTriple());
     }
   }
+}
 
+bool GDBRemoteCommunicationClient::GetModuleInfo(
+    const FileSpec &module_file_spec, const lldb_private::ArchSpec &arch_spec,
+    ModuleSpec &module_spec) {
+  if (!m_supports_qModuleInfo)
+    return false;
+
+  std::string module_path = module_file_spec.GetPath(false);
+  if (module_path.empty())
+    return false;
+
+  StringExtractorGDBRemote response;
+  if (SendPacketAndWaitForResponse(
+          MakeModuleInfoPacket(module_path, arch_spec.GetTriple()), response,
+          false) != PacketResult::Success)
+    return false;
+
+  if (response.IsErrorResponse())
+    return false;
+
+  if (response.IsUnsupportedResponse()) {
+    m_supports_qModuleInfo = false;
+    return false;
+  }
+
+  ParseModuleInfoResponse(response, module_file_spec, arch_spec, module_spec);
   return true;
 }
 
+llvm::Optional<std::vector<ModuleSpec>>
+GDBRemoteCommunicationClient::GetModulesInfoWithPackets(
+    llvm::ArrayRef<FileSpec> module_file_specs, const llvm::Triple &triple) {
+  if (!m_supports_qModuleInfo)
+    return llvm::None;
+
+  std::vector<const FileSpec *> requested_specs;
+  std::vector<std::string> packets;
+  for (const FileSpec &module_file_spec : module_file_specs) {
+    std::string module_path = module_file_spec.GetPath(false);
+    if (module_path.empty())
+      continue;
+    requested_specs.push_back(&module_file_spec);
+    packets.push_back(MakeModuleInfoPacket(module_path, triple));
+  }
+
+  std::vector<StringExtractorGDBRemote> responses;
+  if (SendPacketsAndWaitForResponses(packets, responses, false) !=
+      PacketResult::Success)
+    return llvm::None;
+
+  const ArchSpec arch_spec(triple);
+  std::vector<ModuleSpec> result;
+  for (size_t i = 0; i < responses.size(); ++i) {
+    if (responses[i].IsUnsupportedResponse()) {
+      m_supports_qModuleInfo = false;
+      return llvm::None;
+    }
+    if (responses[i].IsErrorResponse())
+      continue;
+    ModuleSpec module_spec;
+    ParseModuleInfoResponse(responses[i], *requested_specs[i], arch_spec,
+                            module_spec);
+    result.push_back(module_spec);
+  }
+  return result;
+}
+
 static llvm::Optional<ModuleSpec>
 ParseModuleSpec(StructuredData::Dictionary *dict) {
   ModuleSpec result;
@@ -3610,7 +3814,7 @@ llvm::Optional<std::vector<ModuleSpec>>
 GDBRemoteCommunicationClient::GetModulesInfo(
     llvm::ArrayRef<FileSpec> module_file_specs, const llvm::Triple &triple) {
   if (!m_supports_jModulesInfo)
-    return llvm::None;
+    return GetModulesInfoWithPackets(module_file_specs, triple);
 
   JSONArray::SP module_array_sp = std::make_shared<JSONArray>();
   for (const FileSpec &module_file_spec : module_file_specs) {
@@ -3639,7 +3843,7 @@ GDBRemoteCommunicationClient::GetModulesInfo(
 
   if (response.IsUnsupportedResponse()) {
     m_supports_jModulesInfo = false;
-    return llvm::None;
+    return GetModulesInfoWithPackets(module_file_specs, triple);
   }
 
   StructuredData::ObjectSP response_object_sp =
@@ -17,7 +17,9 @@
 #include <string>
 #include <vector>
 
+#include "lldb/Utility/AgentExpression.h"
 #include "lldb/Utility/ArchSpec.h"
+#include "lldb/Utility/RangeMap.h"
 #include "lldb/Utility/StreamGDBRemote.h"
 #include "lldb/Utility/StructuredData.h"
 #if defined(_WIN32)
@@ -214,6 +216,26 @@ public:
 
   Status GetMemoryRegionInfo(lldb::addr_t addr, MemoryRegionInfo &range_info);
 
+  /// Read several ranges of memory with a single MultiMemRead packet.
+  ///
+  /// \param[in] ranges
+  ///     The address and size of every range to read.
+  ///
+  /// \param[out] buf
+  ///     A buffer large enough for all ranges. The bytes of every range are
+  ///     stored right after the ones of the previous range.
+  ///
+  /// \param[out] bytes_read
+  ///     Receives the number of bytes read from each range, which is less
+  ///     than its size if the range could only be read partially.
+  ///
+  /// \return
+  ///     True if the server replied to the packet, false if the ranges need
+  ///     to be read one by one.
+  bool
+  ReadMemoryRanges(llvm::ArrayRef<Range<lldb::addr_t, lldb::addr_t>> ranges,
+                   uint8_t *buf, llvm::MutableArrayRef<size_t> bytes_read);
+
   Status GetWatchpointSupportInfo(uint32_t &num);
 
   Status GetWatchpointSupportInfo(uint32_t &num, bool &after,
@@ -296,11 +318,14 @@ public:
     }
   }
 
+  // The conditions are agent expressions the stub evaluates before reporting
+  // a hit of the breakpoint, see GetConditionalBreakpointsSupported().
   uint8_t SendGDBStoppointTypePacket(
       GDBStoppointType type, // Type of breakpoint or watchpoint
       bool insert,           // Insert or remove?
       lldb::addr_t addr,     // Address of breakpoint or watchpoint
-      uint32_t length);      // Byte Size of breakpoint or watchpoint
+      uint32_t length,       // Byte Size of breakpoint or watchpoint
+      llvm::ArrayRef<AgentExpression> conditions = {});
 
   bool SetNonStopMode(const bool enable);
 
@@ -333,6 +358,30 @@ public:
 
   bool GetQPassSignalsSupported();
 
+  bool GetMultiMemReadSupported();
+
+  bool GetConditionalBreakpointsSupported();
+
+  // Whether the stub steps threads that are resumed at one of its software
+  // breakpoints in non-stop mode over the breakpoint itself.
+  bool GetNonStopStepOverSupported();
+
+  bool GetThreadsInfoBinarySupported();
+
+  // Select the compression to ask the stub for when it lists the ones it
+  // supports in its qSupported reply: empty for the best one lldb can
+  // decompress, "none" to never compress. Must be called before the first
+  // qSupported packet is sent.
+  void SetPacketCompression(llvm::StringRef name) {
+    m_packet_compression = name;
+  }
+
+  // Whether GetThreadsInfo() may use the binary qThreadsInfoBinary packet
+  // instead of jThreadsInfo.
+  void SetUseBinaryThreadsInfo(bool enable) {
+    m_use_binary_threads_info = enable;
+  }
+
   bool GetAugmentedLibrariesSVR4ReadSupported();
 
   bool GetQXferFeaturesReadSupported();
@@ -528,6 +577,10 @@ protected:
   LazyBool m_supports_jLoadedDynamicLibrariesInfos;
   LazyBool m_supports_jGetSharedCacheInfo;
   LazyBool m_supports_QPassSignals;
+  LazyBool m_supports_multi_mem_read;
+  LazyBool m_supports_conditional_breakpoints;
+  LazyBool m_supports_non_stop_step_over;
+  LazyBool m_supports_qThreadsInfoBinary;
   LazyBool m_supports_error_string_reply;
 
   bool m_supports_qProcessInfoPID : 1, m_supports_qfProcessInfo : 1,
@@ -561,6 +614,8 @@ protected:
   std::chrono::seconds m_default_packet_timeout;
   uint64_t m_max_packet_size;        // as returned by qSupported
   std::string m_qSupported_response; // the complete response to qSupported
+  std::string m_packet_compression;
+  bool m_use_binary_threads_info;
 
   bool m_supported_async_json_packets_is_valid;
   lldb_private::StructuredData::ObjectSP m_supported_async_json_packets_sp;
@@ -595,6 +650,12 @@ protected:
   Status GetQXferMemoryMapRegionInfo(lldb::addr_t addr,
                                      MemoryRegionInfo &region);
 
+  // Get the module info with pipelined qModuleInfo packets, for stubs that
+  // don't support jModulesInfo.
+  llvm::Optional<std::vector<ModuleSpec>>
+  GetModulesInfoWithPackets(llvm::ArrayRef<FileSpec> module_file_specs,
+                            const llvm::Triple &triple);
+
 private:
   DISALLOW_COPY_AND_ASSIGN(GDBRemoteCommunicationClient);
 };
@@ -136,6 +136,9 @@ GDBRemoteCommunicationServerCommon::GDBRemoteCommunicationServerCommon(
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_QThreadSuffixSupported,
       &GDBRemoteCommunicationServerCommon::Handle_QThreadSuffixSupported);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_QEnableCompression,
+      &GDBRemoteCommunicationServerCommon::Handle_QEnableCompression);
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_qUserName,
       &GDBRemoteCommunicationServerCommon::Handle_qUserName);
@@ -829,10 +832,22 @@ GDBRemoteCommunicationServerCommon::Handle_qSupported(
   response.PutCString(";QThreadSuffixSupported+");
   response.PutCString(";QListThreadsInStopReply+");
   response.PutCString(";qEcho+");
+  response.PutCString(";MultiMemRead+");
+#if defined(HAVE_LIBZ)
+  response.PutCString(";SupportedCompressions=zlib-deflate,lz4");
+#else
+  response.PutCString(";SupportedCompressions=lz4");
+#endif
 #if defined(__linux__) || defined(__NetBSD__)
   response.PutCString(";QPassSignals+");
   response.PutCString(";qXfer:auxv:read+");
   response.PutCString(";qXfer:libraries-svr4:read+");
+  response.PutCString(";qThreadsInfoBinary+");
+#endif
+#if defined(__linux__)
+  response.PutCString(";QNonStop+");
+  response.PutCString(";ConditionalBreakpoints+");
+  response.PutCString(";NonStopStepOver+");
 #endif
 
   return SendPacketNoLock(response.GetString());
@@ -845,6 +860,37 @@ GDBRemoteCommunicationServerCommon::Handle_QThreadSuffixSupported(
   return SendOKResponse();
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerCommon::Handle_QEnableCompression(
+    StringExtractorGDBRemote &packet) {
+  // The packet is "QEnableCompression:type:<name>;".
+  llvm::StringRef fields =
+      packet.GetStringRef().drop_front(strlen("QEnableCompression:"));
+  llvm::StringRef name;
+  while (!fields.empty()) {
+    llvm::StringRef field, key, value;
+    std::tie(field, fields) = fields.split(';');
+    std::tie(key, value) = field.split(':');
+    if (key == "type")
+      name = value;
+  }
+
+  CompressionType type = llvm::StringSwitch<CompressionType>(name)
+#if defined(HAVE_LIBZ)
+                             .Case("zlib-deflate", CompressionType::ZlibDeflate)
+#endif
+                             .Case("lz4", CompressionType::LZ4)
+                             .Default(CompressionType::None);
+  if (type == CompressionType::None)
+    return SendIllFormedResponse(packet, "unsupported compression type");
+
+  // The reply is the last packet sent uncompressed, the client only starts
+  // decompressing once it has seen it.
+  PacketResult result = SendOKResponse();
+  EnableSendCompression(type);
+  return result;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerCommon::Handle_QListThreadsInStopReply(
     StringExtractorGDBRemote &packet) {
@@ -93,6 +93,8 @@ protected:
 
   PacketResult Handle_QThreadSuffixSupported(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_QEnableCompression(StringExtractorGDBRemote &packet);
+
   PacketResult Handle_QListThreadsInStopReply(StringExtractorGDBRemote &packet);
 
   PacketResult Handle_QSetDetachOnError(StringExtractorGDBRemote &packet);
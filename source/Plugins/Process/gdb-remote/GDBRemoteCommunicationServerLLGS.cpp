@@ -42,6 +42,7 @@
 #include "llvm/ADT/Triple.h"
 #include "llvm/Support/ScopedPrinter.h"
 
+#include "BinaryStructuredData.h"
 #include "ProcessGDBRemote.h"
 #include "ProcessGDBRemoteLog.h"
 #include "lldb/Utility/StringExtractorGDBRemote.h"
@@ -92,6 +93,9 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
       &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_M,
                                 &GDBRemoteCommunicationServerLLGS::Handle_M);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_MultiMemRead,
+      &GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_p,
                                 &GDBRemoteCommunicationServerLLGS::Handle_p);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_P,
@@ -119,6 +123,9 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_qRegisterInfo,
       &GDBRemoteCommunicationServerLLGS::Handle_qRegisterInfo);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_QNonStop,
+      &GDBRemoteCommunicationServerLLGS::Handle_QNonStop);
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_QRestoreRegisterState,
       &GDBRemoteCommunicationServerLLGS::Handle_QRestoreRegisterState);
@@ -140,6 +147,9 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_jThreadsInfo,
       &GDBRemoteCommunicationServerLLGS::Handle_jThreadsInfo);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_qThreadsInfoBinary,
+      &GDBRemoteCommunicationServerLLGS::Handle_qThreadsInfoBinary);
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_qWatchpointSupportInfo,
       &GDBRemoteCommunicationServerLLGS::Handle_qWatchpointSupportInfo);
@@ -160,6 +170,9 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_vCont_actions,
       &GDBRemoteCommunicationServerLLGS::Handle_vCont_actions);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_vStopped,
+      &GDBRemoteCommunicationServerLLGS::Handle_vStopped);
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_x,
       &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
@@ -235,6 +248,11 @@ Status GDBRemoteCommunicationServerLLGS::LaunchProcess() {
     if (!process_or)
       return Status(process_or.takeError());
     m_debugged_process_up = std::move(*process_or);
+    if (m_non_stop) {
+      Status error = m_debugged_process_up->SetNonStopMode(true);
+      if (error.Fail())
+        return error;
+    }
   }
 
   // Handle mirroring of inferior stdout/stderr over the gdb-remote protocol as
@@ -304,6 +322,11 @@ Status GDBRemoteCommunicationServerLLGS::AttachToProcess(lldb::pid_t pid) {
     return status;
   }
   m_debugged_process_up = std::move(*process_or);
+  if (m_non_stop) {
+    Status error = m_debugged_process_up->SetNonStopMode(true);
+    if (error.Fail())
+      return error;
+  }
 
   // Setup stdout/stderr mapping from inferior.
   auto terminal_fd = m_debugged_process_up->GetTerminalFileDescriptor();
@@ -341,7 +364,7 @@ void GDBRemoteCommunicationServerLLGS::InitializeDelegate(
 
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::SendWResponse(
-    NativeProcessProtocol *process) {
+    NativeProcessProtocol *process, bool as_notification) {
   assert(process && "process cannot be NULL");
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
 
@@ -362,6 +385,8 @@ GDBRemoteCommunicationServerLLGS::SendWResponse(
 
   StreamGDBRemote response;
   response.Format("{0:g}", *wait_status);
+  if (as_notification)
+    return SendNotificationPacketNoLock("Stop", response.GetString());
   return SendPacketNoLock(response.GetString());
 }
 
@@ -402,19 +427,34 @@ static void WriteRegisterValueInHexFixedWidth(
   }
 }
 
-static JSONObject::SP GetRegistersAsJSON(NativeThreadProtocol &thread) {
+namespace {
+// The stop information of a thread as it is sent in the thread info replies.
+struct ThreadStopSummary {
+  lldb::tid_t tid;
+  int signum;
+  std::string name;
+  const char *reason;
+  std::string description;
+  uint64_t exception_type;
+  std::vector<uint64_t> exception_data;
+  bool has_registers;
+  // The expedited registers, with their value in target byte order.
+  std::vector<std::pair<uint32_t, std::vector<uint8_t>>> registers;
+};
+} // namespace
+
+static bool GetExpeditedRegisters(NativeThreadProtocol &thread,
+                                  ThreadStopSummary &summary) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_THREAD));
 
   NativeRegisterContext& reg_ctx = thread.GetRegisterContext();
 
-  JSONObject::SP register_object_sp = std::make_shared<JSONObject>();
-
 #ifdef LLDB_JTHREADSINFO_FULL_REGISTER_SET
   // Expedite all registers in the first register set (i.e. should be GPRs)
   // that are not contained in other registers.
   const RegisterSet *reg_set_p = reg_ctx_sp->GetRegisterSet(0);
   if (!reg_set_p)
-    return nullptr;
+    return false;
   for (const uint32_t *reg_num_p = reg_set_p->registers;
        *reg_num_p != LLDB_INVALID_REGNUM; ++reg_num_p) {
     uint32_t reg_num = *reg_num_p;
@@ -456,16 +496,13 @@ static JSONObject::SP GetRegistersAsJSON(NativeThreadProtocol &thread) {
       continue;
     }
 
-    StreamString stream;
-    WriteRegisterValueInHexFixedWidth(stream, reg_ctx, *reg_info_p,
-                                      &reg_value, lldb::eByteOrderBig);
-
-    register_object_sp->SetObject(
-        llvm::to_string(reg_num),
-        std::make_shared<JSONString>(stream.GetString()));
+    const uint8_t *bytes = static_cast<const uint8_t *>(reg_value.GetBytes());
+    summary.registers.emplace_back(
+        reg_num,
+        std::vector<uint8_t>(bytes, bytes + reg_value.GetByteSize()));
   }
 
-  return register_object_sp;
+  return true;
 }
 
 static const char *GetStopReasonString(StopReason stop_reason) {
@@ -492,12 +529,11 @@ static const char *GetStopReasonString(StopReason stop_reason) {
   return nullptr;
 }
 
-static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
-                                        bool abridged) {
+static bool GetThreadStopSummaries(NativeProcessProtocol &process,
+                                   bool abridged,
+                                   std::vector<ThreadStopSummary> &summaries) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
 
-  JSONArray::SP threads_array_sp = std::make_shared<JSONArray>();
-
   // Ensure we can get info on the given thread.
   uint32_t thread_idx = 0;
   for (NativeThreadProtocol *thread;
@@ -506,11 +542,16 @@ static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
 
     lldb::tid_t tid = thread->GetID();
 
+    // In non-stop mode some threads may still be running; they have no stop
+    // info to report.
+    if (StateIsRunningState(thread->GetState()))
+      continue;
+
     // Grab the reason this thread stopped.
     struct ThreadStopInfo tid_stop_info;
     std::string description;
     if (!thread->GetStopReason(tid_stop_info, description))
-      return nullptr;
+      return false;
 
     const int signum = tid_stop_info.details.signal.signo;
     if (log) {
@@ -522,55 +563,148 @@ static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
                 tid_stop_info.reason, tid_stop_info.details.exception.type);
     }
 
+    summaries.emplace_back();
+    ThreadStopSummary &summary = summaries.back();
+    summary.tid = tid;
+    summary.signum = signum;
+    summary.name = thread->GetName();
+    summary.reason = GetStopReasonString(tid_stop_info.reason);
+    summary.description = std::move(description);
+    summary.exception_type = 0;
+    if (tid_stop_info.reason == eStopReasonException) {
+      summary.exception_type = tid_stop_info.details.exception.type;
+      summary.exception_data.assign(
+          tid_stop_info.details.exception.data,
+          tid_stop_info.details.exception.data +
+              tid_stop_info.details.exception.data_count);
+    }
+    summary.has_registers =
+        !abridged && GetExpeditedRegisters(*thread, summary);
+
+    // TODO: Expedite interesting regions of inferior memory
+  }
+
+  return true;
+}
+
+static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
+                                        bool abridged) {
+  std::vector<ThreadStopSummary> summaries;
+  if (!GetThreadStopSummaries(process, abridged, summaries))
+    return nullptr;
+
+  JSONArray::SP threads_array_sp = std::make_shared<JSONArray>();
+  for (const ThreadStopSummary &summary : summaries) {
     JSONObject::SP thread_obj_sp = std::make_shared<JSONObject>();
     threads_array_sp->AppendObject(thread_obj_sp);
 
-    if (!abridged) {
-      if (JSONObject::SP registers_sp = GetRegistersAsJSON(*thread))
-        thread_obj_sp->SetObject("registers", registers_sp);
+    if (summary.has_registers) {
+      JSONObject::SP registers_sp = std::make_shared<JSONObject>();
+      for (const auto &reg : summary.registers) {
+        StreamString stream;
+        for (uint8_t byte : reg.second)
+          stream.PutHex8(byte);
+        registers_sp->SetObject(
+            llvm::to_string(reg.first),
+            std::make_shared<JSONString>(stream.GetString()));
+      }
+      thread_obj_sp->SetObject("registers", registers_sp);
     }
 
-    thread_obj_sp->SetObject("tid", std::make_shared<JSONNumber>(tid));
-    if (signum != 0)
-      thread_obj_sp->SetObject("signal", std::make_shared<JSONNumber>(signum));
+    thread_obj_sp->SetObject("tid", std::make_shared<JSONNumber>(summary.tid));
+    if (summary.signum != 0)
+      thread_obj_sp->SetObject("signal",
+                               std::make_shared<JSONNumber>(summary.signum));
 
-    const std::string thread_name = thread->GetName();
-    if (!thread_name.empty())
+    if (!summary.name.empty())
       thread_obj_sp->SetObject("name",
-                               std::make_shared<JSONString>(thread_name));
+                               std::make_shared<JSONString>(summary.name));
 
-    if (const char *stop_reason_str = GetStopReasonString(tid_stop_info.reason))
+    if (summary.reason)
       thread_obj_sp->SetObject("reason",
-                               std::make_shared<JSONString>(stop_reason_str));
+                               std::make_shared<JSONString>(summary.reason));
 
-    if (!description.empty())
-      thread_obj_sp->SetObject("description",
-                               std::make_shared<JSONString>(description));
+    if (!summary.description.empty())
+      thread_obj_sp->SetObject(
+          "description", std::make_shared<JSONString>(summary.description));
 
-    if ((tid_stop_info.reason == eStopReasonException) &&
-        tid_stop_info.details.exception.type) {
+    if (summary.exception_type) {
       thread_obj_sp->SetObject(
-          "metype",
-          std::make_shared<JSONNumber>(tid_stop_info.details.exception.type));
+          "metype", std::make_shared<JSONNumber>(summary.exception_type));
 
       JSONArray::SP medata_array_sp = std::make_shared<JSONArray>();
-      for (uint32_t i = 0; i < tid_stop_info.details.exception.data_count;
-           ++i) {
-        medata_array_sp->AppendObject(std::make_shared<JSONNumber>(
-            tid_stop_info.details.exception.data[i]));
-      }
+      for (uint64_t data : summary.exception_data)
+        medata_array_sp->AppendObject(std::make_shared<JSONNumber>(data));
       thread_obj_sp->SetObject("medata", medata_array_sp);
     }
-
-    // TODO: Expedite interesting regions of inferior memory
   }
 
   return threads_array_sp;
 }
 
+// The same information as GetJSONThreadsInfo, but in the binary encoding
+// with raw register values.
+static bool GetBinaryThreadsInfo(NativeProcessProtocol &process,
+                                 BinaryStructuredDataWriter &writer) {
+  std::vector<ThreadStopSummary> summaries;
+  if (!GetThreadStopSummaries(process, /*abridged=*/false, summaries))
+    return false;
+
+  writer.BeginArray();
+  for (const ThreadStopSummary &summary : summaries) {
+    writer.BeginDictionary();
+
+    if (summary.has_registers) {
+      writer.PutKey("registers");
+      writer.BeginDictionary();
+      for (const auto &reg : summary.registers) {
+        writer.PutKey(llvm::to_string(reg.first));
+        writer.PutBytes(reg.second);
+      }
+      writer.End();
+    }
+
+    writer.PutKey("tid");
+    writer.PutUnsigned(summary.tid);
+    if (summary.signum != 0) {
+      writer.PutKey("signal");
+      writer.PutSigned(summary.signum);
+    }
+
+    if (!summary.name.empty()) {
+      writer.PutKey("name");
+      writer.PutString(summary.name);
+    }
+
+    if (summary.reason) {
+      writer.PutKey("reason");
+      writer.PutString(summary.reason);
+    }
+
+    if (!summary.description.empty()) {
+      writer.PutKey("description");
+      writer.PutString(summary.description);
+    }
+
+    if (summary.exception_type) {
+      writer.PutKey("metype");
+      writer.PutUnsigned(summary.exception_type);
+      writer.PutKey("medata");
+      writer.BeginArray();
+      for (uint64_t data : summary.exception_data)
+        writer.PutUnsigned(data);
+      writer.End();
+    }
+
+    writer.End();
+  }
+  writer.End();
+  return true;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread(
-    lldb::tid_t tid) {
+    lldb::tid_t tid, bool as_notification) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
 
   // Ensure we have a debugged process.
@@ -779,6 +913,8 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread(
     }
   }
 
+  if (as_notification)
+    return SendNotificationPacketNoLock("Stop", response.GetString());
   return SendPacketNoLock(response.GetString());
 }
 
@@ -789,7 +925,11 @@ void GDBRemoteCommunicationServerLLGS::HandleInferiorState_Exited(
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
   LLDB_LOGF(log, "GDBRemoteCommunicationServerLLGS::%s called", __FUNCTION__);
 
-  PacketResult result = SendStopReasonForState(StateType::eStateExited);
+  // In non-stop mode the client is not waiting for a reply; the exit is
+  // reported asynchronously like any other stop.
+  PacketResult result =
+      m_non_stop ? SendWResponse(process, /*as_notification=*/true)
+                 : SendStopReasonForState(StateType::eStateExited);
   if (result != PacketResult::Success) {
     LLDB_LOGF(log,
               "GDBRemoteCommunicationServerLLGS::%s failed to send stop "
@@ -813,6 +953,11 @@ void GDBRemoteCommunicationServerLLGS::HandleInferiorState_Stopped(
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
   LLDB_LOGF(log, "GDBRemoteCommunicationServerLLGS::%s called", __FUNCTION__);
 
+  // In non-stop mode every thread reports its own stop via ThreadStopped,
+  // which follows this.
+  if (m_non_stop)
+    return;
+
   // Send the stop reason unless this is the stop after the launch or attach.
   switch (m_inferior_prev_state) {
   case eStateLaunching:
@@ -883,6 +1028,60 @@ void GDBRemoteCommunicationServerLLGS::DidExec(NativeProcessProtocol *process) {
   ClearProcessSpecificData();
 }
 
+void GDBRemoteCommunicationServerLLGS::ThreadStopped(
+    NativeProcessProtocol *process, NativeThreadProtocol &thread) {
+  if (!m_non_stop)
+    return;
+
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_THREAD));
+  LLDB_LOG(log, "pid {0} tid {1} stopped", process->GetID(), thread.GetID());
+
+  // Flush the inferior output before the stop so the client sees them in
+  // order.
+  SendProcessOutput();
+
+  if (llvm::find(m_stop_notification_queue, thread.GetID()) ==
+      m_stop_notification_queue.end())
+    m_stop_notification_queue.push_back(thread.GetID());
+  MaybeSendStopNotification();
+}
+
+void GDBRemoteCommunicationServerLLGS::MaybeSendStopNotification() {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_THREAD));
+
+  if (m_stop_notification_sent || !m_debugged_process_up)
+    return;
+
+  // Drop threads that exited or were resumed before we got to report them.
+  while (!m_stop_notification_queue.empty()) {
+    NativeThreadProtocol *thread =
+        m_debugged_process_up->GetThreadByID(m_stop_notification_queue.front());
+    if (thread && !StateIsRunningState(thread->GetState()))
+      break;
+    m_stop_notification_queue.pop_front();
+  }
+  if (m_stop_notification_queue.empty())
+    return;
+
+  const lldb::tid_t tid = m_stop_notification_queue.front();
+  if (SendStopReplyPacketForThread(tid, /*as_notification=*/true) !=
+      PacketResult::Success) {
+    LLDB_LOG(log, "failed to send stop notification for tid {0}", tid);
+    return;
+  }
+  m_stop_notification_sent = true;
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::SendResumeResponse() {
+  // In all-stop mode the reply is the stop reply packet sent once the
+  // process stops again.  In non-stop mode the resume is acknowledged right
+  // away and stops are reported with %Stop notifications.
+  if (m_non_stop)
+    return SendOKResponse();
+  return PacketResult::Success;
+}
+
 void GDBRemoteCommunicationServerLLGS::DataAvailableCallback() {
   Log *log(GetLogIfAnyCategoriesSet(GDBR_LOG_COMM));
 
@@ -1424,8 +1623,9 @@ GDBRemoteCommunicationServerLLGS::Handle_C(StringExtractorGDBRemote &packet) {
     return SendErrorResponse(0x38);
   }
 
-  // Don't send an "OK" packet; response is the stopped/exited message.
-  return PacketResult::Success;
+  // In all-stop mode, don't send an "OK" packet; response is the
+  // stopped/exited message.
+  return SendResumeResponse();
 }
 
 GDBRemoteCommunication::PacketResult
@@ -1464,7 +1664,7 @@ GDBRemoteCommunicationServerLLGS::Handle_c(StringExtractorGDBRemote &packet) {
 
   LLDB_LOG(log, "continued process {0}", m_debugged_process_up->GetID());
   // No response required from continue.
-  return PacketResult::Success;
+  return SendResumeResponse();
 }
 
 GDBRemoteCommunication::PacketResult
@@ -1472,6 +1672,8 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont_actions(
     StringExtractorGDBRemote &packet) {
   StreamString response;
   response.Printf("vCont;c;C;s;S");
+  if (m_non_stop)
+    response.PutCString(";t");
 
   return SendPacketNoLock(response.GetString());
 }
@@ -1548,6 +1750,14 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont(
       thread_action.state = eStateStepping;
       break;
 
+    case 't':
+      // Stop; only meaningful while other threads keep running.
+      if (!m_non_stop)
+        return SendIllFormedResponse(
+            packet, "vCont t action requires non-stop mode");
+      thread_action.state = eStateStopped;
+      break;
+
     default:
       return SendIllFormedResponse(packet, "Unsupported vCont action");
       break;
@@ -1576,7 +1786,7 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont(
 
   LLDB_LOG(log, "continued process {0}", m_debugged_process_up->GetID());
   // No response required from vCont.
-  return PacketResult::Success;
+  return SendResumeResponse();
 }
 
 void GDBRemoteCommunicationServerLLGS::SetCurrentThreadID(lldb::tid_t tid) {
@@ -1604,6 +1814,25 @@ GDBRemoteCommunicationServerLLGS::Handle_stop_reason(
   if (!m_debugged_process_up)
     return SendErrorResponse(02);
 
+  if (m_non_stop) {
+    // Report every stopped thread again: the first one here, the rest via
+    // vStopped.
+    m_stop_notification_queue.clear();
+    m_stop_notification_sent = false;
+    uint32_t thread_idx = 0;
+    for (NativeThreadProtocol *thread;
+         (thread = m_debugged_process_up->GetThreadAtIndex(thread_idx)) !=
+         nullptr;
+         ++thread_idx) {
+      if (!StateIsRunningState(thread->GetState()))
+        m_stop_notification_queue.push_back(thread->GetID());
+    }
+    if (m_stop_notification_queue.empty())
+      return SendOKResponse();
+    m_stop_notification_sent = true;
+    return SendStopReplyPacketForThread(m_stop_notification_queue.front());
+  }
+
   return SendStopReasonForState(m_debugged_process_up->GetState());
 }
 
@@ -2244,7 +2473,10 @@ GDBRemoteCommunicationServerLLGS::Handle_interrupt(
 
   LLDB_LOG(log, "stopped process {0}", m_debugged_process_up->GetID());
 
-  // No response required from stop all.
+  // No response required from stop all; in non-stop mode the stopped
+  // threads are reported with %Stop notifications.
+  if (m_non_stop)
+    return SendOKResponse();
   return PacketResult::Success;
 }
 
@@ -2410,6 +2642,76 @@ GDBRemoteCommunicationServerLLGS::Handle_M(StringExtractorGDBRemote &packet) {
   return SendOKResponse();
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead(
+    StringExtractorGDBRemote &packet) {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+  if (!m_debugged_process_up ||
+      (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID)) {
+    LLDB_LOG(log, "failed, no process available");
+    return SendErrorResponse(0x15);
+  }
+
+  // Parse out the ranges from "MultiMemRead:ranges:<addr>,<size>,...;".
+  llvm::StringRef ranges_str;
+  llvm::StringRef args =
+      packet.GetStringRef().substr(strlen("MultiMemRead:"));
+  while (!args.empty()) {
+    llvm::StringRef arg, name, value;
+    std::tie(arg, args) = args.split(';');
+    std::tie(name, value) = arg.split(':');
+    if (name == "ranges")
+      ranges_str = value;
+  }
+  if (ranges_str.empty())
+    return SendIllFormedResponse(packet, "No ranges in MultiMemRead packet");
+
+  llvm::SmallVector<llvm::StringRef, 32> numbers;
+  ranges_str.split(numbers, ',');
+  if (numbers.size() % 2 != 0)
+    return SendIllFormedResponse(packet,
+                                 "Size missing in MultiMemRead packet");
+
+  std::vector<NativeProcessProtocol::MemoryRange> ranges;
+  ranges.reserve(numbers.size() / 2);
+  size_t total_size = 0;
+  for (size_t i = 0; i < numbers.size(); i += 2) {
+    lldb::addr_t addr;
+    size_t size;
+    if (numbers[i].getAsInteger(16, addr) ||
+        numbers[i + 1].getAsInteger(16, size))
+      return SendIllFormedResponse(packet,
+                                   "Invalid range in MultiMemRead packet");
+    if (total_size + size < total_size)
+      return SendErrorResponse(0x78);
+    total_size += size;
+    ranges.emplace_back(addr, size);
+  }
+
+  std::string buf(total_size, '\0');
+  std::vector<size_t> bytes_read(ranges.size(), 0);
+  m_debugged_process_up->ReadMemoryRangesWithoutTrap(ranges, &buf[0],
+                                                     bytes_read);
+
+  // Reply with the number of bytes read from each range, followed by the
+  // bytes of all ranges.
+  StreamGDBRemote response;
+  for (size_t i = 0; i < ranges.size(); ++i)
+    response.Printf("%s%" PRIx64, i == 0 ? "" : ",", uint64_t(bytes_read[i]));
+  response.PutChar(';');
+  size_t offset = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (bytes_read[i] > 0)
+      response.PutEscapedBytes(buf.data() + offset, bytes_read[i]);
+    offset += ranges[i].GetByteSize();
+  }
+  LLDB_LOG(log, "pid {0}: read {1} ranges with {2} bytes",
+           m_debugged_process_up->GetID(), ranges.size(), total_size);
+
+  return SendPacketNoLock(response.GetString());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfoSupported(
     StringExtractorGDBRemote &packet) {
@@ -2584,10 +2886,34 @@ GDBRemoteCommunicationServerLLGS::Handle_Z(StringExtractorGDBRemote &packet) {
     return SendIllFormedResponse(
         packet, "Malformed Z packet, failed to parse size argument");
 
+  // Parse out the breakpoint conditions, which are agent expressions. Command
+  // lists are not supported and ignored.
+  std::vector<AgentExpression> conditions;
+  while (packet.GetBytesLeft() > 0 && packet.PeekChar() == ';') {
+    packet.GetChar();
+    if (packet.PeekChar() != 'X')
+      break;
+    packet.GetChar();
+    const uint32_t length = packet.GetHexMaxU32(false, 0);
+    if (length == 0 || packet.GetChar() != ',')
+      return SendIllFormedResponse(
+          packet, "Malformed Z packet, invalid condition length");
+    std::vector<uint8_t> bytecode(length);
+    if (packet.GetHexBytes(bytecode, 0) != length)
+      return SendIllFormedResponse(
+          packet, "Malformed Z packet, condition is too short");
+    conditions.emplace_back(std::move(bytecode));
+  }
+
   if (want_breakpoint) {
     // Try to set the breakpoint.
-    const Status error =
+    Status error =
         m_debugged_process_up->SetBreakpoint(addr, size, want_hardware);
+    // Hardware breakpoints report every hit, their conditions are evaluated
+    // by the client.
+    if (error.Success() && !want_hardware)
+      error = m_debugged_process_up->SetBreakpointConditions(
+          addr, std::move(conditions));
     if (error.Success())
       return SendOKResponse();
     Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
@@ -2742,7 +3068,7 @@ GDBRemoteCommunicationServerLLGS::Handle_s(StringExtractorGDBRemote &packet) {
   }
 
   // No response here - the stop or exit will come from the resulting action.
-  return PacketResult::Success;
+  return SendResumeResponse();
 }
 
 llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>>
@@ -3093,6 +3419,30 @@ GDBRemoteCommunicationServerLLGS::Handle_jThreadsInfo(
   return SendPacketNoLock(escaped_response.GetString());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qThreadsInfoBinary(
+    StringExtractorGDBRemote &) {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+
+  // Ensure we have a debugged process.
+  if (!m_debugged_process_up ||
+      (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID))
+    return SendErrorResponse(50);
+  LLDB_LOG(log, "preparing packet for pid {0}", m_debugged_process_up->GetID());
+
+  BinaryStructuredDataWriter writer;
+  if (!GetBinaryThreadsInfo(*m_debugged_process_up, writer)) {
+    LLDB_LOG(log, "failed to prepare a packet for pid {0}",
+             m_debugged_process_up->GetID());
+    return SendErrorResponse(52);
+  }
+
+  StreamGDBRemote escaped_response;
+  escaped_response.PutEscapedBytes(writer.GetData().data(),
+                                   writer.GetData().size());
+  return SendPacketNoLock(escaped_response.GetString());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_qWatchpointSupportInfo(
     StringExtractorGDBRemote &packet) {
@@ -3181,6 +3531,62 @@ GDBRemoteCommunicationServerLLGS::Handle_QPassSignals(
   return SendOKResponse();
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QNonStop(
+    StringExtractorGDBRemote &packet) {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+  packet.SetFilePos(strlen("QNonStop:"));
+  const uint32_t value = packet.GetU32(UINT32_MAX);
+  if (value > 1 || packet.GetBytesLeft() > 0)
+    return SendIllFormedResponse(packet, "QNonStop expects 0 or 1");
+  const bool enabled = value == 1;
+
+  if (m_debugged_process_up) {
+    Status error = m_debugged_process_up->SetNonStopMode(enabled);
+    if (error.Fail()) {
+      LLDB_LOG(log, "failed to set non-stop mode for pid {0}: {1}",
+               m_debugged_process_up->GetID(), error);
+      return SendErrorResponse(0x70);
+    }
+  }
+
+  m_non_stop = enabled;
+  m_stop_notification_queue.clear();
+  m_stop_notification_sent = false;
+  return SendOKResponse();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_vStopped(
+    StringExtractorGDBRemote &packet) {
+  if (!m_non_stop)
+    return SendUnimplementedResponse(packet.GetStringRef().data());
+
+  // The client acknowledges the stop we reported last.
+  if (m_stop_notification_sent && !m_stop_notification_queue.empty())
+    m_stop_notification_queue.pop_front();
+
+  while (!m_stop_notification_queue.empty()) {
+    NativeThreadProtocol *thread =
+        m_debugged_process_up
+            ? m_debugged_process_up->GetThreadByID(
+                  m_stop_notification_queue.front())
+            : nullptr;
+    if (thread && !StateIsRunningState(thread->GetState()))
+      break;
+    m_stop_notification_queue.pop_front();
+  }
+
+  if (m_stop_notification_queue.empty()) {
+    m_stop_notification_sent = false;
+    return SendOKResponse();
+  }
+
+  m_stop_notification_sent = true;
+  return SendStopReplyPacketForThread(m_stop_notification_queue.front());
+}
+
 void GDBRemoteCommunicationServerLLGS::MaybeCloseInferiorTerminalConnection() {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
 
@@ -9,6 +9,7 @@
 #ifndef liblldb_GDBRemoteCommunicationServerLLGS_h_
 #define liblldb_GDBRemoteCommunicationServerLLGS_h_
 
+#include <deque>
 #include <mutex>
 #include <unordered_map>
 
@@ -67,6 +68,9 @@ public:
 
   void DidExec(NativeProcessProtocol *process) override;
 
+  void ThreadStopped(NativeProcessProtocol *process,
+                     NativeThreadProtocol &thread) override;
+
   Status InitializeConnection(std::unique_ptr<Connection> &&connection);
 
 protected:
@@ -88,11 +92,21 @@ protected:
   uint32_t m_next_saved_registers_id = 1;
   bool m_handshake_completed = false;
 
+  // Non-stop mode state (see QNonStop).  Threads that stopped but whose stop
+  // has not been acknowledged by the client yet, in the order they stopped.
+  // The head of the queue has been reported with a %Stop notification when
+  // m_stop_notification_sent is set; the rest are drained with vStopped.
+  bool m_non_stop = false;
+  std::deque<lldb::tid_t> m_stop_notification_queue;
+  bool m_stop_notification_sent = false;
+
   PacketResult SendONotification(const char *buffer, uint32_t len);
 
-  PacketResult SendWResponse(NativeProcessProtocol *process);
+  PacketResult SendWResponse(NativeProcessProtocol *process,
+                             bool as_notification = false);
 
-  PacketResult SendStopReplyPacketForThread(lldb::tid_t tid);
+  PacketResult SendStopReplyPacketForThread(lldb::tid_t tid,
+                                            bool as_notification = false);
 
   PacketResult SendStopReasonForState(lldb::StateType process_state);
 
@@ -139,6 +153,8 @@ protected:
 
   PacketResult Handle_M(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_MultiMemRead(StringExtractorGDBRemote &packet);
+
   PacketResult
   Handle_qMemoryRegionInfoSupported(StringExtractorGDBRemote &packet);
 
@@ -172,6 +188,8 @@ protected:
 
   PacketResult Handle_jThreadsInfo(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_qThreadsInfoBinary(StringExtractorGDBRemote &packet);
+
   PacketResult Handle_qWatchpointSupportInfo(StringExtractorGDBRemote &packet);
 
   PacketResult Handle_qFileLoadAddress(StringExtractorGDBRemote &packet);
@@ -180,6 +198,10 @@ protected:
 
   PacketResult Handle_g(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_QNonStop(StringExtractorGDBRemote &packet);
+
+  PacketResult Handle_vStopped(StringExtractorGDBRemote &packet);
+
   void SetCurrentThreadID(lldb::tid_t tid);
 
   lldb::tid_t GetCurrentThreadID() const;
@@ -203,6 +225,13 @@ private:
 
   void HandleInferiorState_Stopped(NativeProcessProtocol *process);
 
+  /// In non-stop mode, send a %Stop notification for the first queued
+  /// thread stop unless one is already awaiting acknowledgement.
+  void MaybeSendStopNotification();
+
+  /// In non-stop mode, reply to a resume packet that succeeded.
+  PacketResult SendResumeResponse();
+
   NativeThreadProtocol *GetThreadFromSuffix(StringExtractorGDBRemote &packet);
 
   uint32_t GetNextSavedRegistersID();
@@ -27,6 +27,7 @@
 #include <mutex>
 #include <sstream>
 
+#include "lldb/Breakpoint/BreakpointLocation.h"
 #include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
@@ -70,6 +71,7 @@
 #include "lldb/Utility/StreamString.h"
 #include "lldb/Utility/Timer.h"
 
+#include "BreakpointConditionCompiler.h"
 #include "GDBRemoteRegisterContext.h"
 #include "Plugins/Platform/MacOSX/PlatformRemoteiOS.h"
 #include "Plugins/Process/Utility/GDBRemoteSignals.h"
@@ -82,6 +84,7 @@
 #include "lldb/Utility/StringExtractorGDBRemote.h"
 
 #include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -110,6 +113,22 @@ void DumpProcessGDBRemotePacketHistory(void *p, const char *path) {
 
 namespace {
 
+enum PacketCompression {
+  ePacketCompressionAuto,
+  ePacketCompressionNone,
+  ePacketCompressionZlibDeflate,
+  ePacketCompressionLZ4,
+};
+
+static constexpr OptionEnumValueElement g_packet_compression_enums[] = {
+    {ePacketCompressionAuto, "auto",
+     "Use the best compression both lldb and the remote stub support."},
+    {ePacketCompressionNone, "none", "Don't compress packets."},
+    {ePacketCompressionZlibDeflate, "zlib-deflate",
+     "Use zlib's deflate compression if the remote stub supports it."},
+    {ePacketCompressionLZ4, "lz4",
+     "Use LZ4 compression if the remote stub supports it."}};
+
 #define LLDB_PROPERTIES_processgdbremote
 #include "ProcessGDBRemoteProperties.inc"
 
@@ -153,6 +172,35 @@ public:
         nullptr, idx,
         g_processgdbremote_properties[idx].default_uint_value != 0);
   }
+
+  bool GetUseStubBreakpointConditions() const {
+    const uint32_t idx = ePropertyUseStubBreakpointConditions;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(
+        nullptr, idx,
+        g_processgdbremote_properties[idx].default_uint_value != 0);
+  }
+
+  llvm::StringRef GetPacketCompression() const {
+    const uint32_t idx = ePropertyPacketCompression;
+    switch (m_collection_sp->GetPropertyAtIndexAsEnumeration(
+        nullptr, idx, g_processgdbremote_properties[idx].default_uint_value)) {
+    case ePacketCompressionNone:
+      return "none";
+    case ePacketCompressionZlibDeflate:
+      return "zlib-deflate";
+    case ePacketCompressionLZ4:
+      return "lz4";
+    default:
+      return "";
+    }
+  }
+
+  bool GetUseBinaryThreadsInfo() const {
+    const uint32_t idx = ePropertyUseBinaryThreadsInfo;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(
+        nullptr, idx,
+        g_processgdbremote_properties[idx].default_uint_value != 0);
+  }
 };
 
 typedef std::shared_ptr<PluginProperties> ProcessKDPPropertiesSP;
@@ -347,6 +395,11 @@ ProcessGDBRemote::ProcessGDBRemote(lldb::TargetSP target_sp,
       GetGlobalPluginProperties()->GetPacketTimeout();
   if (timeout_seconds > 0)
     m_gdb_comm.SetPacketTimeout(std::chrono::seconds(timeout_seconds));
+
+  m_gdb_comm.SetPacketCompression(
+      GetGlobalPluginProperties()->GetPacketCompression());
+  m_gdb_comm.SetUseBinaryThreadsInfo(
+      GetGlobalPluginProperties()->GetUseBinaryThreadsInfo());
 }
 
 // Destructor
@@ -1328,6 +1381,8 @@ Status ProcessGDBRemote::DoResume() {
   Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PROCESS));
   LLDB_LOGF(log, "ProcessGDBRemote::Resume()");
 
+  UpdateBreakpointSiteConditions();
+
   ListenerSP listener_sp(
       Listener::MakeListener("gdb-remote.resume-packet-sent"));
   if (listener_sp->StartListeningForEvents(
@@ -1518,6 +1573,20 @@ Status ProcessGDBRemote::DoResume() {
         return error;
       }
 
+      if (GetTarget().GetNonStopModeEnabled()) {
+        // Remember which threads are about to run; they stay running until
+        // they report a stop of their own.
+        std::lock_guard<std::mutex> guard(m_non_stop_running_tids_mutex);
+        m_non_stop_running_tids.insert(m_continue_c_tids.begin(),
+                                       m_continue_c_tids.end());
+        m_non_stop_running_tids.insert(m_continue_s_tids.begin(),
+                                       m_continue_s_tids.end());
+        for (const auto &tid_sig : m_continue_C_tids)
+          m_non_stop_running_tids.insert(tid_sig.first);
+        for (const auto &tid_sig : m_continue_S_tids)
+          m_non_stop_running_tids.insert(tid_sig.first);
+      }
+
       m_async_broadcaster.BroadcastEvent(
           eBroadcastBitAsyncContinue,
           new EventDataBytes(continue_packet.GetString().data(),
@@ -1764,7 +1833,17 @@ bool ProcessGDBRemote::GetThreadStopInfoFromJSON(
   return false;
 }
 
+bool ProcessGDBRemote::IsThreadRunningInNonStopMode(lldb::tid_t tid) {
+  std::lock_guard<std::mutex> guard(m_non_stop_running_tids_mutex);
+  return m_non_stop_running_tids.count(tid) != 0;
+}
+
 bool ProcessGDBRemote::CalculateThreadStopInfo(ThreadGDBRemote *thread) {
+  // A thread that is still running in non-stop mode has no stop info, don't
+  // ask the remote for one.
+  if (IsThreadRunningInNonStopMode(thread->GetProtocolID()))
+    return false;
+
   // See if we got thread stop infos for all threads via the "jThreadsInfo"
   // packet
   if (GetThreadStopInfoFromJSON(thread, m_jthreadsinfo_sp))
@@ -1801,6 +1880,11 @@ ThreadSP ProcessGDBRemote::SetThreadStopInfo(
     std::string &queue_name, QueueKind queue_kind, uint64_t queue_serial) {
   ThreadSP thread_sp;
   if (tid != LLDB_INVALID_THREAD_ID) {
+    {
+      std::lock_guard<std::mutex> guard(m_non_stop_running_tids_mutex);
+      m_non_stop_running_tids.erase(tid);
+    }
+
     // Scope for "locker" below
     {
       // m_thread_list_real does have its own mutex, but we need to hold onto
@@ -2460,6 +2544,15 @@ Status ProcessGDBRemote::DoHalt(bool &caused_stop) {
     // We are being asked to halt during an attach. We need to just close our
     // file handle and debugserver will go away, and we can be done...
     m_gdb_comm.Disconnect();
+  } else if (GetTarget().GetNonStopModeEnabled()) {
+    // There is no continue packet to interrupt in non-stop mode. Ask the
+    // remote to stop every running thread; the stops are reported as
+    // notifications.
+    StringExtractorGDBRemote response;
+    caused_stop = m_gdb_comm.SendPacketAndWaitForResponse("vCont;t", response,
+                                                          false) ==
+                      GDBRemoteCommunication::PacketResult::Success &&
+                  response.IsOKResponse();
   } else
     caused_stop = m_gdb_comm.Interrupt();
   return error;
@@ -2756,6 +2849,28 @@ void ProcessGDBRemote::WillPublicStop() {
 }
 
 // Process Memory
+// Copy the memory in a successful reply to an x or m packet to BUF.
+static size_t CopyMemoryReadResponse(StringExtractorGDBRemote &response,
+                                     bool binary_memory_read, void *buf,
+                                     size_t size) {
+  if (binary_memory_read) {
+    // The lower level GDBRemoteCommunication packet receive layer has
+    // already de-quoted any 0x7d character escaping that was present in
+    // the packet
+
+    size_t data_received_size = response.GetBytesLeft();
+    if (data_received_size > size) {
+      // Don't write past the end of BUF if the remote debug server gave us
+      // too much data for some reason.
+      data_received_size = size;
+    }
+    memcpy(buf, response.GetStringRef().data(), data_received_size);
+    return data_received_size;
+  }
+  return response.GetHexBytes(
+      llvm::MutableArrayRef<uint8_t>((uint8_t *)buf, size), '\xdd');
+}
+
 size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
                                       Status &error) {
   GetMaxMemorySize();
@@ -2764,10 +2879,17 @@ size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
   size_t max_memory_size =
       binary_memory_read ? m_max_memory_size : m_max_memory_size / 2;
   if (size > max_memory_size) {
-    // Keep memory read sizes down to a sane limit. This function will be
-    // called multiple times in order to complete the task by
-    // lldb_private::Process so it is ok to do this.
-    size = max_memory_size;
+    // Send the packets for all parts of the read at once instead of having
+    // lldb_private::Process call us again for every part.
+    size_t bytes_read = 0;
+    ReadMemoryRangesWithPackets(LoadRange(addr, size), (uint8_t *)buf,
+                                bytes_read);
+    if (bytes_read == 0)
+      error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64,
+                                     addr);
+    else
+      error.Clear();
+    return bytes_read;
   }
 
   char packet[64];
@@ -2782,23 +2904,7 @@ size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
       GDBRemoteCommunication::PacketResult::Success) {
     if (response.IsNormalResponse()) {
       error.Clear();
-      if (binary_memory_read) {
-        // The lower level GDBRemoteCommunication packet receive layer has
-        // already de-quoted any 0x7d character escaping that was present in
-        // the packet
-
-        size_t data_received_size = response.GetBytesLeft();
-        if (data_received_size > size) {
-          // Don't write past the end of BUF if the remote debug server gave us
-          // too much data for some reason.
-          data_received_size = size;
-        }
-        memcpy(buf, response.GetStringRef().data(), data_received_size);
-        return data_received_size;
-      } else {
-        return response.GetHexBytes(
-            llvm::MutableArrayRef<uint8_t>((uint8_t *)buf, size), '\xdd');
-      }
+      return CopyMemoryReadResponse(response, binary_memory_read, buf, size);
     } else if (response.IsErrorResponse())
       error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64, addr);
     else if (response.IsUnsupportedResponse())
@@ -2814,6 +2920,96 @@ size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
   return 0;
 }
 
+void ProcessGDBRemote::DoReadMemoryRanges(
+    llvm::ArrayRef<LoadRange> ranges, uint8_t *buf,
+    llvm::MutableArrayRef<size_t> bytes_read) {
+  if (!m_gdb_comm.GetMultiMemReadSupported()) {
+    ReadMemoryRangesWithPackets(ranges, buf, bytes_read);
+    return;
+  }
+
+  GetMaxMemorySize();
+  // Every range costs up to "<addr>,<size>," in the packet and "<size>," in
+  // the reply besides its bytes.
+  const size_t packet_overhead = 2 * 16 + 2;
+  const size_t reply_overhead = 16 + 1;
+
+  size_t first = 0;
+  while (first < ranges.size()) {
+    size_t end = first;
+    size_t packet_size = 0;
+    size_t reply_size = 0;
+    size_t batch_byte_size = 0;
+    for (; end < ranges.size(); ++end) {
+      const size_t size = ranges[end].GetByteSize();
+      if (end > first &&
+          (packet_size + packet_overhead > m_max_memory_size ||
+           reply_size + size + reply_overhead > m_max_memory_size))
+        break;
+      packet_size += packet_overhead;
+      reply_size += size + reply_overhead;
+      batch_byte_size += size;
+    }
+
+    llvm::ArrayRef<LoadRange> batch = ranges.slice(first, end - first);
+    llvm::MutableArrayRef<size_t> batch_bytes_read =
+        bytes_read.slice(first, end - first);
+    // A single range, e.g. one that is too large for a packet, is read with
+    // the regular memory read packets.
+    if (batch.size() == 1 ||
+        !m_gdb_comm.ReadMemoryRanges(batch, buf, batch_bytes_read))
+      ReadMemoryRangesWithPackets(batch, buf, batch_bytes_read);
+
+    buf += batch_byte_size;
+    first = end;
+  }
+}
+
+void ProcessGDBRemote::ReadMemoryRangesWithPackets(
+    llvm::ArrayRef<LoadRange> ranges, uint8_t *buf,
+    llvm::MutableArrayRef<size_t> bytes_read) {
+  GetMaxMemorySize();
+  const bool binary_memory_read = m_gdb_comm.GetxPacketSupported();
+  // M and m packets take 2 bytes for 1 byte of memory
+  const size_t max_memory_size =
+      binary_memory_read ? m_max_memory_size : m_max_memory_size / 2;
+
+  struct Part {
+    size_t range_idx;
+    size_t offset;
+    size_t size;
+    uint8_t *buf;
+  };
+  std::vector<Part> parts;
+  std::vector<std::string> packets;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    const size_t range_size = ranges[i].GetByteSize();
+    bytes_read[i] = 0;
+    for (size_t offset = 0; offset < range_size; offset += max_memory_size) {
+      const size_t size = std::min(range_size - offset, max_memory_size);
+      packets.push_back(llvm::formatv("{0}{1:x-},{2:x-}",
+                                      binary_memory_read ? 'x' : 'm',
+                                      ranges[i].GetRangeBase() + offset, size)
+                            .str());
+      parts.push_back({i, offset, size, buf + offset});
+    }
+    buf += range_size;
+  }
+
+  std::vector<StringExtractorGDBRemote> responses;
+  m_gdb_comm.SendPacketsAndWaitForResponses(packets, responses, true);
+  for (size_t i = 0; i < responses.size(); ++i) {
+    const Part &part = parts[i];
+    // The bytes of a range are only valid up to the first part that could
+    // not be read completely.
+    if (bytes_read[part.range_idx] != part.offset ||
+        !responses[i].IsNormalResponse())
+      continue;
+    bytes_read[part.range_idx] += CopyMemoryReadResponse(
+        responses[i], binary_memory_read, part.buf, part.size);
+  }
+}
+
 Status ProcessGDBRemote::WriteObjectFile(
     std::vector<ObjectFile::LoadableData> entries) {
   Status error;
@@ -3016,6 +3212,17 @@ size_t ProcessGDBRemote::DoWriteMemory(addr_t addr, const void *buf,
   return 0;
 }
 
+static unsigned GetMmapProtection(uint32_t permissions) {
+  unsigned prot = 0;
+  if (permissions & lldb::ePermissionsReadable)
+    prot |= eMmapProtRead;
+  if (permissions & lldb::ePermissionsWritable)
+    prot |= eMmapProtWrite;
+  if (permissions & lldb::ePermissionsExecutable)
+    prot |= eMmapProtExec;
+  return prot;
+}
+
 lldb::addr_t ProcessGDBRemote::DoAllocateMemory(size_t size,
                                                 uint32_t permissions,
                                                 Status &error) {
@@ -3032,13 +3239,7 @@ lldb::addr_t ProcessGDBRemote::DoAllocateMemory(size_t size,
 
   if (m_gdb_comm.SupportsAllocDeallocMemory() == eLazyBoolNo) {
     // Call mmap() to create memory in the inferior..
-    unsigned prot = 0;
-    if (permissions & lldb::ePermissionsReadable)
-      prot |= eMmapProtRead;
-    if (permissions & lldb::ePermissionsWritable)
-      prot |= eMmapProtWrite;
-    if (permissions & lldb::ePermissionsExecutable)
-      prot |= eMmapProtExec;
+    unsigned prot = GetMmapProtection(permissions);
 
     if (InferiorCallMmap(this, allocated_addr, 0, size, prot,
                          eMmapFlagsAnon | eMmapFlagsPrivate, -1, 0))
@@ -3062,6 +3263,25 @@ lldb::addr_t ProcessGDBRemote::DoAllocateMemory(size_t size,
   return allocated_addr;
 }
 
+lldb::addr_t ProcessGDBRemote::DoAllocateMemoryAt(size_t size,
+                                                  uint32_t permissions,
+                                                  lldb::addr_t hint,
+                                                  Status &error) {
+  // The allocation packet has no address, call mmap() with the hint.
+  addr_t allocated_addr = LLDB_INVALID_ADDRESS;
+  if (InferiorCallMmap(this, allocated_addr, hint, size,
+                       GetMmapProtection(permissions),
+                       eMmapFlagsAnon | eMmapFlagsPrivate, -1, 0)) {
+    m_addr_to_mmap_size[allocated_addr] = size;
+    error.Clear();
+    return allocated_addr;
+  }
+  error.SetErrorStringWithFormat("unable to allocate %" PRIu64
+                                 " bytes of memory at 0x%" PRIx64,
+                                 (uint64_t)size, hint);
+  return LLDB_INVALID_ADDRESS;
+}
+
 Status ProcessGDBRemote::GetMemoryRegionInfo(addr_t load_addr,
                                              MemoryRegionInfo &region_info) {
 
@@ -3083,6 +3303,18 @@ Status ProcessGDBRemote::GetWatchpointSupportInfo(uint32_t &num, bool &after) {
 
 Status ProcessGDBRemote::DoDeallocateMemory(lldb::addr_t addr) {
   Status error;
+
+  // Memory from DoAllocateMemoryAt() is always mapped with mmap().
+  MMapMap::iterator mmap_pos = m_addr_to_mmap_size.find(addr);
+  if (mmap_pos != m_addr_to_mmap_size.end()) {
+    if (InferiorCallMunmap(this, addr, mmap_pos->second))
+      m_addr_to_mmap_size.erase(mmap_pos);
+    else
+      error.SetErrorStringWithFormat(
+          "unable to deallocate memory at 0x%" PRIx64, addr);
+    return error;
+  }
+
   LazyBool supported = m_gdb_comm.SupportsAllocDeallocMemory();
 
   switch (supported) {
@@ -3252,6 +3484,91 @@ Status ProcessGDBRemote::EnableBreakpointSite(BreakpointSite *bp_site) {
   return EnableSoftwareBreakpoint(bp_site);
 }
 
+void ProcessGDBRemote::UpdateBreakpointSiteConditions() {
+  // Conditions are only evaluated by the stub in all-stop mode, where it can
+  // step a thread over the breakpoint while the others are stopped.
+  if (GetTarget().GetNonStopModeEnabled() ||
+      !GetGlobalPluginProperties()->GetUseStubBreakpointConditions() ||
+      !m_gdb_comm.GetConditionalBreakpointsSupported())
+    return;
+
+  Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+  GetBreakpointSiteList().ForEach([this, log](BreakpointSite *bp_site) {
+    if (!bp_site->IsEnabled() ||
+        bp_site->GetType() != BreakpointSite::eExternal ||
+        bp_site->IsHardware())
+      return;
+
+    // The stub may only skip a hit if no owner of the site would stop, so
+    // every owner needs a condition. Ignore counts are consumed before the
+    // condition is checked, so those owners have to see every hit.
+    std::vector<std::string> texts;
+    const size_t num_owners = bp_site->GetNumberOfOwners();
+    for (size_t i = 0; i < num_owners; ++i) {
+      BreakpointLocationSP loc_sp = bp_site->GetOwnerAtIndex(i);
+      const char *text = loc_sp ? loc_sp->GetConditionText() : nullptr;
+      if (!text || !text[0] || loc_sp->GetIgnoreCount() != 0 ||
+          loc_sp->GetBreakpoint().GetIgnoreCount() != 0) {
+        texts.clear();
+        break;
+      }
+      texts.push_back(text);
+    }
+
+    SiteConditions &sent = m_site_conditions[bp_site->GetID()];
+    if (texts == sent.texts)
+      return;
+
+    std::vector<AgentExpression> exprs;
+    for (size_t i = 0; i < texts.size(); ++i) {
+      BreakpointLocationSP loc_sp = bp_site->GetOwnerAtIndex(i);
+      BreakpointConditionCompiler::TargetScope scope(
+          GetTarget(), loc_sp->GetAddress(),
+          [this](uint32_t dwarf_reg_num) -> llvm::Optional<uint32_t> {
+            const uint32_t reg_num =
+                m_register_info.ConvertRegisterKindToRegisterNumber(
+                    eRegisterKindDWARF, dwarf_reg_num);
+            const RegisterInfo *reg_info =
+                m_register_info.GetRegisterInfoAtIndex(reg_num);
+            if (!reg_info)
+              return llvm::None;
+            return reg_info->kinds[eRegisterKindProcessPlugin];
+          });
+      BreakpointConditionCompiler compiler(scope);
+      llvm::Expected<AgentExpression> expr = compiler.Compile(texts[i]);
+      if (!expr) {
+        LLDB_LOG_ERROR(log, expr.takeError(),
+                       "Condition \"{1}\" left to the debugger: {0}",
+                       texts[i]);
+        exprs.clear();
+        break;
+      }
+      exprs.push_back(std::move(*expr));
+    }
+
+    sent.texts = std::move(texts);
+    if (exprs.empty() && sent.exprs.empty())
+      return;
+
+    // Reinserting the breakpoint replaces the conditions the stub has for it.
+    const addr_t addr = bp_site->GetLoadAddress();
+    const size_t bp_op_size = GetSoftwareBreakpointTrapOpcode(bp_site);
+    m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, false, addr,
+                                          bp_op_size);
+    if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr,
+                                              bp_op_size, exprs) != 0) {
+      LLDB_LOGF(log,
+                "ProcessGDBRemote::%s failed to send the conditions for "
+                "address 0x%" PRIx64,
+                __FUNCTION__, addr);
+      exprs.clear();
+      m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr,
+                                            bp_op_size);
+    }
+    sent.exprs = std::move(exprs);
+  });
+}
+
 Status ProcessGDBRemote::DisableBreakpointSite(BreakpointSite *bp_site) {
   Status error;
   assert(bp_site != nullptr);
@@ -3279,6 +3596,7 @@ Status ProcessGDBRemote::DisableBreakpointSite(BreakpointSite *bp_site) {
       break;
 
     case BreakpointSite::eExternal: {
+      m_site_conditions.erase(site_id);
       GDBStoppointType stoppoint_type;
       if (bp_site->IsHardware())
         stoppoint_type = eBreakpointHardware;
@@ -3305,6 +3623,14 @@ Status ProcessGDBRemote::DisableBreakpointSite(BreakpointSite *bp_site) {
   return error;
 }
 
+bool ProcessGDBRemote::StepsOverBreakpointSite(BreakpointSite &bp_site) {
+  // In non-stop mode the other threads keep running while a thread steps over
+  // a breakpoint, so the stub has to do it with the breakpoint in place.
+  return GetTarget().GetNonStopModeEnabled() &&
+         bp_site.GetType() == BreakpointSite::eExternal &&
+         !bp_site.IsHardware() && m_gdb_comm.GetNonStopStepOverSupported();
+}
+
 // Pre-requisite: wp != NULL.
 static GDBStoppointType GetGDBStoppointType(Watchpoint *wp) {
   assert(wp);
@@ -3707,6 +4033,18 @@ bool ProcessGDBRemote::HandleNotifyPacket(StringExtractorGDBRemote &packet) {
   // skip %stop:
   StringExtractorGDBRemote stop_info(pkt.c_str() + 5);
 
+  // The process exited or was killed, there are no threads left to stop.
+  const char stop_type = stop_info.PeekChar();
+  if (stop_type == 'W' || stop_type == 'X') {
+    {
+      std::lock_guard<std::mutex> guard(m_non_stop_running_tids_mutex);
+      m_non_stop_running_tids.clear();
+    }
+    stop_info.SetFilePos(1);
+    SetExitStatus(stop_info.GetHexU8(), nullptr);
+    return true;
+  }
+
   // pass as a thread stop info packet
   SetLastStopPacket(stop_info);
 
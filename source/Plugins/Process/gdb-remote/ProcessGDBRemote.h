@@ -12,6 +12,7 @@
 #include <atomic>
 #include <map>
 #include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -133,6 +134,20 @@ public:
   size_t DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
                       Status &error) override;
 
+  void DoReadMemoryRanges(llvm::ArrayRef<LoadRange> ranges, uint8_t *buf,
+                          llvm::MutableArrayRef<size_t> bytes_read) override;
+
+  /// Read the ranges with one memory read packet per range, or per part of a
+  /// range that doesn't fit into a packet. The packets are pipelined when the
+  /// connection allows it.
+  void ReadMemoryRangesWithPackets(llvm::ArrayRef<LoadRange> ranges,
+                                   uint8_t *buf,
+                                   llvm::MutableArrayRef<size_t> bytes_read);
+
+  uint64_t GetRemoteRoundTripCount() override {
+    return m_gdb_comm.GetRoundTripCount();
+  }
+
   Status
   WriteObjectFile(std::vector<ObjectFile::LoadableData> entries) override;
 
@@ -142,6 +157,9 @@ public:
   lldb::addr_t DoAllocateMemory(size_t size, uint32_t permissions,
                                 Status &error) override;
 
+  lldb::addr_t DoAllocateMemoryAt(size_t size, uint32_t permissions,
+                                  lldb::addr_t hint, Status &error) override;
+
   Status GetMemoryRegionInfo(lldb::addr_t load_addr,
                              MemoryRegionInfo &region_info) override;
 
@@ -155,6 +173,8 @@ public:
 
   Status DisableBreakpointSite(BreakpointSite *bp_site) override;
 
+  bool StepsOverBreakpointSite(BreakpointSite &bp_site) override;
+
   // Process Watchpoints
   Status EnableWatchpoint(Watchpoint *wp, bool notify = true) override;
 
@@ -273,6 +293,10 @@ protected:
   tid_sig_collection m_continue_C_tids;       // 'C' for continue with signal
   tid_collection m_continue_s_tids;           // 's' for step
   tid_sig_collection m_continue_S_tids;       // 'S' for step with signal
+  // In non-stop mode, the threads that were resumed and have not reported a
+  // stop since. They are left out of resume packets and stop info queries.
+  std::set<lldb::tid_t> m_non_stop_running_tids;
+  std::mutex m_non_stop_running_tids_mutex;
   uint64_t m_max_memory_size; // The maximum number of bytes to read/write when
                               // reading and writing memory
   uint64_t m_remote_stub_max_memory_size; // The maximum memory size the remote
@@ -333,6 +357,8 @@ protected:
 
   bool CalculateThreadStopInfo(ThreadGDBRemote *thread);
 
+  bool IsThreadRunningInNonStopMode(lldb::tid_t tid);
+
   size_t UpdateThreadPCsFromStopReplyThreadsValue(std::string &value);
 
   size_t UpdateThreadIDsFromStopReplyThreadsValue(std::string &value);
@@ -411,6 +437,18 @@ private:
   std::map<uint64_t, uint32_t> m_thread_id_to_used_usec_map;
   uint64_t m_last_signals_version = 0;
 
+  // The breakpoint conditions the stub evaluates for a breakpoint site, and
+  // the condition texts they were compiled from.
+  struct SiteConditions {
+    std::vector<std::string> texts;
+    std::vector<AgentExpression> exprs;
+  };
+  std::map<lldb::break_id_t, SiteConditions> m_site_conditions;
+
+  // Send the stub the conditions of the breakpoint sites it implements, if
+  // it can evaluate them.
+  void UpdateBreakpointSiteConditions();
+
   static bool NewThreadNotifyBreakpointHit(void *baton,
                                            StoppointCallbackContext *context,
                                            lldb::user_id_t break_id,
@@ -236,6 +236,9 @@ void ThreadGDBRemote::WillResume(StateType resume_state) {
   if (process_sp) {
     ProcessGDBRemote *gdb_process =
         static_cast<ProcessGDBRemote *>(process_sp.get());
+    // In non-stop mode a thread that never stopped is already running.
+    if (gdb_process->IsThreadRunningInNonStopMode(tid))
+      return;
     switch (resume_state) {
     case eStateSuspended:
     case eStateStopped:
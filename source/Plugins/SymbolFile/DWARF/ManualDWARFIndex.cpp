@@ -15,12 +15,30 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/Log.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/Timer.h"
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace lldb_private;
 using namespace lldb;
 
+// Bump the version whenever the layout of the cache file or the contents of
+// the index change.
+static const uint32_t g_index_cache_magic = 0x58444944; // "DIDX"
+static const uint32_t g_index_cache_version = 1;
+static const char g_index_cache_extension[] = ".dwarfindex";
+
+void ManualDWARFIndex::EnableCache(const FileSpec &cache_dir,
+                                   uint64_t max_byte_size,
+                                   CacheSignature signature) {
+  m_cache = std::make_unique<DataFileCache>(cache_dir, g_index_cache_extension,
+                                            max_byte_size);
+  m_cache_signature = std::move(signature);
+}
+
 void ManualDWARFIndex::Index() {
   if (!m_debug_info)
     return;
@@ -31,6 +49,9 @@ void ManualDWARFIndex::Index() {
   static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
   Timer scoped_timer(func_cat, "%p", static_cast<void *>(&debug_info));
 
+  if (LoadFromCache())
+    return;
+
   std::vector<DWARFUnit *> units_to_index;
   units_to_index.reserve(debug_info.GetNumUnits());
   for (size_t U = 0; U < debug_info.GetNumUnits(); ++U) {
@@ -55,6 +76,29 @@ void ManualDWARFIndex::Index() {
     clear_cu_dies[cu_idx] = units_to_index[cu_idx]->ExtractDIEsScoped();
   };
 
+  // Parse the unit DIE of every unit on this thread first. This is where
+  // .dwo and .dwp files get located and their object files created, which
+  // requires the module lock that our caller may already be holding. Once
+  // every unit DIE is parsed, extracting the remaining DIEs only touches the
+  // unit's own data and can safely run on the task pool.
+  {
+    static Timer::Category unit_die_cat(
+        "ManualDWARFIndex::Index - extract unit DIEs");
+    Timer scoped_timer(unit_die_cat, "%zu units", units_to_index.size());
+    for (DWARFUnit *unit : units_to_index) {
+      unit->ExtractUnitDIEIfNeeded();
+      SymbolFileDWARFDwo *dwo_symbol_file = unit->GetDwoSymbolFile();
+      if (!dwo_symbol_file)
+        continue;
+      // A .dwo with an empty .debug_info has no units to extract.
+      DWARFDebugInfo *dwo_info = dwo_symbol_file->DebugInfo();
+      if (!dwo_info)
+        continue;
+      for (size_t i = 0; i < dwo_info->GetNumUnits(); ++i)
+        dwo_info->GetUnitAtIndex(i)->ExtractUnitDIEIfNeeded();
+    }
+  }
+
   // Create a task runner that extracts dies for each DWARF unit in a
   // separate thread
   // First figure out which units didn't have their DIEs already
@@ -64,16 +108,20 @@ void ManualDWARFIndex::Index() {
   // to wait until all compile units have been indexed in case a DIE in one
   // compile unit refers to another and the indexes accesses those DIEs.
   //----------------------------------------------------------------------
-  for (int i=0; i<units_to_index.size(); ++i) {
-     extract_fn(i);
+  {
+    static Timer::Category extract_cat(
+        "ManualDWARFIndex::Index - extract DIEs");
+    Timer scoped_timer(extract_cat, "%zu units", units_to_index.size());
+    TaskMapOverInt(0, units_to_index.size(), extract_fn);
   }
-  // This call can deadlock because we are sometimes holding the module lock.
-  //TaskMapOverInt(0, units_to_index.size(), extract_fn);
 
   // Now create a task runner that can index each DWARF unit in a
   // separate thread so we can index quickly.
-
-  TaskMapOverInt(0, units_to_index.size(), parser_fn);
+  {
+    static Timer::Category parse_cat("ManualDWARFIndex::Index - index units");
+    Timer scoped_timer(parse_cat, "%zu units", units_to_index.size());
+    TaskMapOverInt(0, units_to_index.size(), parser_fn);
+  }
 
   auto finalize_fn = [this, &sets](NameToDIE(IndexSet::*index)) {
     NameToDIE &result = m_set.*index;
@@ -82,6 +130,8 @@ void ManualDWARFIndex::Index() {
     result.Finalize();
   };
 
+  static Timer::Category finalize_cat("ManualDWARFIndex::Index - finalize");
+  Timer finalize_timer(finalize_cat, "%zu sets", sets.size());
   TaskPool::RunTasks([&]() { finalize_fn(&IndexSet::function_basenames); },
                      [&]() { finalize_fn(&IndexSet::function_fullnames); },
                      [&]() { finalize_fn(&IndexSet::function_methods); },
@@ -90,6 +140,8 @@ void ManualDWARFIndex::Index() {
                      [&]() { finalize_fn(&IndexSet::globals); },
                      [&]() { finalize_fn(&IndexSet::types); },
                      [&]() { finalize_fn(&IndexSet::namespaces); });
+
+  SaveToCache();
 }
 
 void ManualDWARFIndex::IndexUnit(DWARFUnit &unit, IndexSet &set) {
@@ -110,15 +162,26 @@ void ManualDWARFIndex::IndexUnit(DWARFUnit &unit, IndexSet &set) {
   IndexUnitImpl(unit, cu_language, set);
 
   if (SymbolFileDWARFDwo *dwo_symbol_file = unit.GetDwoSymbolFile()) {
-    DWARFDebugInfo &dwo_info = *dwo_symbol_file->DebugInfo();
-    for (size_t i = 0; i < dwo_info.GetNumUnits(); ++i)
-      IndexUnitImpl(*dwo_info.GetUnitAtIndex(i), cu_language, set);
+    if (DWARFDebugInfo *dwo_info = dwo_symbol_file->DebugInfo()) {
+      for (size_t i = 0; i < dwo_info->GetNumUnits(); ++i)
+        IndexUnitImpl(*dwo_info->GetUnitAtIndex(i), cu_language, set);
+    }
   }
 }
 
 void ManualDWARFIndex::IndexUnitImpl(DWARFUnit &unit,
                                      const LanguageType cu_language,
                                      IndexSet &set) {
+  // Names are interned in one batch at the end of the unit, so that the
+  // indexing threads don't fight over the string pool locks for every name.
+  // The strings point into the DWARF sections which outlive this function.
+  ConstStringBatch names;
+  std::vector<std::pair<NameToDIE *, DIERef>> staged_entries;
+  auto stage = [&](NameToDIE &map, const char *name, DIERef ref) {
+    names.Add(name);
+    staged_entries.emplace_back(&map, ref);
+  };
+
   for (const DWARFDebugInfoEntry &die : unit.dies()) {
     const dw_tag_t tag = die.Tag();
 
@@ -266,7 +329,7 @@ void ManualDWARFIndex::IndexUnitImpl(DWARFUnit &unit,
               ConstString objc_fullname_no_category_name(
                   objc_method.GetFullNameWithoutCategory(true));
               ConstString class_name_no_category(objc_method.GetClassName());
-              set.function_fullnames.Insert(ConstString(name), ref);
+              stage(set.function_fullnames, name, ref);
               if (class_name_with_category)
                 set.objc_class_selectors.Insert(class_name_with_category, ref);
               if (class_name_no_category &&
@@ -284,12 +347,12 @@ void ManualDWARFIndex::IndexUnitImpl(DWARFUnit &unit,
           bool is_method = DWARFDIE(&unit, &die).IsMethod();
 
           if (is_method)
-            set.function_methods.Insert(ConstString(name), ref);
+            stage(set.function_methods, name, ref);
           else
-            set.function_basenames.Insert(ConstString(name), ref);
+            stage(set.function_basenames, name, ref);
 
           if (!is_method && !mangled_cstr && !is_objc_method)
-            set.function_fullnames.Insert(ConstString(name), ref);
+            stage(set.function_fullnames, name, ref);
         }
         if (mangled_cstr) {
           // Make sure our mangled name isn't the same string table entry as
@@ -299,7 +362,7 @@ void ManualDWARFIndex::IndexUnitImpl(DWARFUnit &unit,
           if (name && name != mangled_cstr &&
               ((mangled_cstr[0] == '_') ||
                (::strcmp(name, mangled_cstr) != 0))) {
-            set.function_fullnames.Insert(ConstString(mangled_cstr), ref);
+            stage(set.function_fullnames, mangled_cstr, ref);
           }
         }
       }
@@ -317,19 +380,19 @@ void ManualDWARFIndex::IndexUnitImpl(DWARFUnit &unit,
     case DW_TAG_union_type:
     case DW_TAG_unspecified_type:
       if (name && !is_declaration)
-        set.types.Insert(ConstString(name), ref);
+        stage(set.types, name, ref);
       if (mangled_cstr && !is_declaration)
-        set.types.Insert(ConstString(mangled_cstr), ref);
+        stage(set.types, mangled_cstr, ref);
       break;
 
     case DW_TAG_namespace:
       if (name)
-        set.namespaces.Insert(ConstString(name), ref);
+        stage(set.namespaces, name, ref);
       break;
 
     case DW_TAG_variable:
       if (name && has_location_or_const_value && is_global_or_static_variable) {
-        set.globals.Insert(ConstString(name), ref);
+        stage(set.globals, name, ref);
         // Be sure to include variables by their mangled and demangled names if
         // they have any since a variable can have a basename "i", a mangled
         // named "_ZN12_GLOBAL__N_11iE" and a demangled mangled name
@@ -341,7 +404,7 @@ void ManualDWARFIndex::IndexUnitImpl(DWARFUnit &unit,
         // entries
         if (mangled_cstr && name != mangled_cstr &&
             ((mangled_cstr[0] == '_') || (::strcmp(name, mangled_cstr) != 0))) {
-          set.globals.Insert(ConstString(mangled_cstr), ref);
+          stage(set.globals, mangled_cstr, ref);
         }
       }
       break;
@@ -350,6 +413,10 @@ void ManualDWARFIndex::IndexUnitImpl(DWARFUnit &unit,
       continue;
     }
   }
+
+  std::vector<ConstString> interned = names.Flush();
+  for (size_t i = 0; i < staged_entries.size(); ++i)
+    staged_entries[i].first->Insert(interned[i], staged_entries[i].second);
 }
 
 void ManualDWARFIndex::GetGlobalVariables(ConstString basename, DIEArray &offsets) {
@@ -479,3 +546,112 @@ void ManualDWARFIndex::Dump(Stream &s) {
   s.Printf("\nNamespaces:\n");
   m_set.namespaces.Dump(&s);
 }
+
+void ManualDWARFIndex::IndexSet::Encode(llvm::raw_ostream &os,
+                                        ConstStringTable &strtab) const {
+  function_basenames.Encode(os, strtab);
+  function_fullnames.Encode(os, strtab);
+  function_methods.Encode(os, strtab);
+  function_selectors.Encode(os, strtab);
+  objc_class_selectors.Encode(os, strtab);
+  globals.Encode(os, strtab);
+  types.Encode(os, strtab);
+  namespaces.Encode(os, strtab);
+}
+
+bool ManualDWARFIndex::IndexSet::Decode(const DataExtractor &data,
+                                        lldb::offset_t *offset_ptr,
+                                        const DataExtractor &strtab) {
+  return function_basenames.Decode(data, offset_ptr, strtab) &&
+         function_fullnames.Decode(data, offset_ptr, strtab) &&
+         function_methods.Decode(data, offset_ptr, strtab) &&
+         function_selectors.Decode(data, offset_ptr, strtab) &&
+         objc_class_selectors.Decode(data, offset_ptr, strtab) &&
+         globals.Decode(data, offset_ptr, strtab) &&
+         types.Decode(data, offset_ptr, strtab) &&
+         namespaces.Decode(data, offset_ptr, strtab);
+}
+
+// The cache file is laid out as follows, all integers little endian:
+//   uint32_t magic, version
+//   uint8_t  uuid length, followed by the uuid bytes
+//   uint64_t modification time, DWARF size
+//   uint32_t string table size, followed by the NUL-terminated strings
+//   the encoded NameToDIE maps of the IndexSet
+bool ManualDWARFIndex::LoadFromCache() {
+  if (!m_cache)
+    return false;
+  const std::string cache_key = m_cache_signature.uuid.GetAsString("");
+  DataBufferSP buffer_sp = m_cache->GetCachedData(cache_key);
+  if (!buffer_sp)
+    return false;
+
+  static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+  Timer scoped_timer(func_cat, "%s", LLVM_PRETTY_FUNCTION);
+  DataExtractor data(buffer_sp, eByteOrderLittle, 4);
+
+  lldb::offset_t offset = 0;
+  if (data.GetU32(&offset) != g_index_cache_magic ||
+      data.GetU32(&offset) != g_index_cache_version)
+    return false;
+
+  llvm::ArrayRef<uint8_t> uuid_bytes = m_cache_signature.uuid.GetBytes();
+  const uint8_t uuid_size = data.GetU8(&offset);
+  const void *uuid_data = data.GetData(&offset, uuid_size);
+  if (uuid_size != uuid_bytes.size() || !uuid_data ||
+      memcmp(uuid_data, uuid_bytes.data(), uuid_size) != 0)
+    return false;
+  if (data.GetU64(&offset) != m_cache_signature.mod_time ||
+      data.GetU64(&offset) != m_cache_signature.dwarf_size)
+    return false;
+
+  const uint32_t strtab_size = data.GetU32(&offset);
+  if (!data.ValidOffsetForDataOfSize(offset, strtab_size))
+    return false;
+  DataExtractor strtab(data, offset, strtab_size);
+  offset += strtab_size;
+
+  IndexSet set;
+  if (!set.Decode(data, &offset, strtab)) {
+    LLDB_LOG(LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO),
+             "ignoring corrupt DWARF index cache file {0}",
+             m_cache->GetCacheFile(cache_key));
+    return false;
+  }
+  m_set = std::move(set);
+  return true;
+}
+
+void ManualDWARFIndex::SaveToCache() {
+  if (!m_cache || !m_cache_signature.uuid.IsValid())
+    return;
+
+  static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+  Timer scoped_timer(func_cat, "%s", LLVM_PRETTY_FUNCTION);
+
+  // The string table has to be written before the maps referring to it, so
+  // encode the maps into memory first.
+  ConstStringTable strtab;
+  std::string tables;
+  llvm::raw_string_ostream tables_os(tables);
+  m_set.Encode(tables_os, strtab);
+  tables_os.flush();
+
+  std::string data;
+  llvm::raw_string_ostream os(data);
+  namespace endian = llvm::support::endian;
+  using llvm::support::little;
+  llvm::ArrayRef<uint8_t> uuid_bytes = m_cache_signature.uuid.GetBytes();
+  endian::write<uint32_t>(os, g_index_cache_magic, little);
+  endian::write<uint32_t>(os, g_index_cache_version, little);
+  endian::write<uint8_t>(os, uuid_bytes.size(), little);
+  os.write(reinterpret_cast<const char *>(uuid_bytes.data()),
+           uuid_bytes.size());
+  endian::write<uint64_t>(os, m_cache_signature.mod_time, little);
+  endian::write<uint64_t>(os, m_cache_signature.dwarf_size, little);
+  endian::write<uint32_t>(os, strtab.GetData().size(), little);
+  os << strtab.GetData() << tables;
+  os.flush();
+
+  m_cache->SetCachedData(m_cache_signature.uuid.GetAsString(""), data);
+}
@@ -11,6 +11,8 @@
 
 #include "Plugins/SymbolFile/DWARF/DWARFIndex.h"
 #include "Plugins/SymbolFile/DWARF/NameToDIE.h"
+#include "lldb/Utility/FileSpec.h"
+#include "lldb/Utility/UUID.h"
 #include "llvm/ADT/DenseSet.h"
 
 class DWARFDebugInfo;
@@ -23,6 +25,21 @@ public:
       : DWARFIndex(module), m_debug_info(debug_info),
         m_units_to_avoid(std::move(units_to_avoid)) {}
 
+  /// Identifies the DWARF an index was built from. A cached index is only
+  /// used when every field matches the DWARF being indexed.
+  struct CacheSignature {
+    UUID uuid;
+    uint64_t mod_time = 0;
+    uint64_t dwarf_size = 0;
+  };
+
+  /// Load the index from \a cache_dir instead of indexing the DWARF, and
+  /// save it there after indexing. Whenever an index is saved, the least
+  /// recently written entries are removed until the directory holds at most
+  /// \a max_byte_size bytes of cached indexes (zero means no limit).
+  void EnableCache(const FileSpec &cache_dir, uint64_t max_byte_size,
+                   CacheSignature signature);
+
   void Preload() override { Index(); }
 
   void GetGlobalVariables(ConstString basename, DIEArray &offsets) override;
@@ -54,8 +71,14 @@ private:
     NameToDIE globals;
     NameToDIE types;
     NameToDIE namespaces;
+
+    void Encode(llvm::raw_ostream &os, ConstStringTable &strtab) const;
+    bool Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
+                const DataExtractor &strtab);
   };
   void Index();
+  bool LoadFromCache();
+  void SaveToCache();
   void IndexUnit(DWARFUnit &unit, IndexSet &set);
 
   static void IndexUnitImpl(DWARFUnit &unit,
@@ -68,6 +91,10 @@ private:
   llvm::DenseSet<dw_offset_t> m_units_to_avoid;
 
   IndexSet m_set;
+
+  /// Null if the index is not cached.
+  std::unique_ptr<DataFileCache> m_cache;
+  CacheSignature m_cache_signature;
 };
 } // namespace lldb_private
 
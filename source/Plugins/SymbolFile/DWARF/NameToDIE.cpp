@@ -10,9 +10,11 @@
 #include "DWARFUnit.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/StreamString.h"
+#include "llvm/Support/EndianStream.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -76,3 +78,49 @@ void NameToDIE::Append(const NameToDIE &other) {
                  other.m_map.GetValueAtIndexUnchecked(i));
   }
 }
+
+void NameToDIE::Encode(llvm::raw_ostream &os, ConstStringTable &strtab) const {
+  namespace endian = llvm::support::endian;
+  using llvm::support::little;
+  const uint32_t size = m_map.GetSize();
+  endian::write<uint32_t>(os, size, little);
+  for (uint32_t i = 0; i < size; ++i) {
+    const DIERef &die_ref = m_map.GetValueRefAtIndexUnchecked(i);
+    endian::write<uint32_t>(os, strtab.Add(m_map.GetCStringAtIndexUnchecked(i)),
+                            little);
+    // A zero dwo number means the DIE lives in the main file.
+    endian::write<uint32_t>(os, die_ref.dwo_num() ? *die_ref.dwo_num() + 1 : 0,
+                            little);
+    endian::write<uint8_t>(os, die_ref.section(), little);
+    endian::write<uint32_t>(os, die_ref.die_offset(), little);
+  }
+}
+
+bool NameToDIE::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
+                       const DataExtractor &strtab) {
+  m_map.Clear();
+  const uint32_t size = data.GetU32(offset_ptr);
+  // Each entry is 13 bytes; reject truncated data before reserving memory.
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, size * 13ull))
+    return false;
+  m_map.Reserve(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    lldb::offset_t str_offset = data.GetU32(offset_ptr);
+    const uint32_t dwo = data.GetU32(offset_ptr);
+    const uint8_t section = data.GetU8(offset_ptr);
+    const dw_offset_t die_offset = data.GetU32(offset_ptr);
+    const char *name = strtab.GetCStr(&str_offset);
+    if (!name || section > DIERef::DebugTypes)
+      return false;
+    llvm::Optional<uint32_t> dwo_num;
+    if (dwo)
+      dwo_num = dwo - 1;
+    m_map.Append(ConstString(name),
+                 DIERef(dwo_num, static_cast<DIERef::Section>(section),
+                        die_offset));
+  }
+  // Names are sorted by their uniqued pointer values, which differ between
+  // processes, so the map has to be sorted again.
+  Finalize();
+  return true;
+}
@@ -12,12 +12,21 @@
 #include <functional>
 
 #include "DIERef.h"
+#include "lldb/Core/DataFileCache.h"
 #include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/Core/dwarf.h"
 #include "lldb/lldb-defines.h"
 
 class DWARFUnit;
 
+namespace lldb_private {
+class DataExtractor;
+}
+
+namespace llvm {
+class raw_ostream;
+}
+
 class NameToDIE {
 public:
   NameToDIE() : m_map() {}
@@ -46,6 +55,18 @@ public:
                              const DIERef &die_ref)> const
               &callback) const;
 
+  /// Write this map to \a os, adding its names to \a strtab. The map must be
+  /// finalized.
+  void Encode(llvm::raw_ostream &os,
+              lldb_private::ConstStringTable &strtab) const;
+
+  /// Replace the contents of this map with one written by Encode(). Names are
+  /// looked up in \a strtab, the data of the string table written alongside.
+  /// The map is finalized on success.
+  bool Decode(const lldb_private::DataExtractor &data,
+              lldb::offset_t *offset_ptr,
+              const lldb_private::DataExtractor &strtab);
+
 protected:
   lldb_private::UniqueCStringMap<DIERef> m_map;
 };
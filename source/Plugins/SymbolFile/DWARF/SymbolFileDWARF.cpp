@@ -30,6 +30,7 @@
 #include "lldb/Host/FileSystem.h"
 #include "lldb/Host/Host.h"
 
+#include "lldb/Interpreter/OptionValueFileSpec.h"
 #include "lldb/Interpreter/OptionValueFileSpecList.h"
 #include "lldb/Interpreter/OptionValueProperties.h"
 
@@ -144,6 +145,19 @@ public:
     return m_collection_sp->GetPropertyAtIndexAsBoolean(
         nullptr, ePropertyIgnoreIndexes, false);
   }
+
+  FileSpec GetIndexCachePath() const {
+    return m_collection_sp
+        ->GetPropertyAtIndexAsOptionValueFileSpec(nullptr, false,
+                                                  ePropertyIndexCachePath)
+        ->GetCurrentValue();
+  }
+
+  uint64_t GetIndexCacheMaxByteSize() const {
+    const uint32_t idx = ePropertyIndexCacheMaxByteSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64(
+        nullptr, idx, g_symbolfiledwarf_properties[idx].default_uint_value);
+  }
 };
 
 typedef std::shared_ptr<PluginProperties> SymbolFileDWARFPropertiesSP;
@@ -474,8 +488,20 @@ void SymbolFileDWARF::InitializeObject() {
     }
   }
 
-  m_index = std::make_unique<ManualDWARFIndex>(*GetObjectFile()->GetModule(),
-                                                DebugInfo());
+  auto manual_index = std::make_unique<ManualDWARFIndex>(
+      *GetObjectFile()->GetModule(), DebugInfo());
+  if (FileSpec cache_dir = GetGlobalPluginProperties()->GetIndexCachePath()) {
+    ManualDWARFIndex::CacheSignature signature;
+    signature.uuid = m_objfile_sp->GetUUID();
+    const FileSpec &file = m_objfile_sp->GetFileSpec();
+    signature.mod_time =
+        llvm::sys::toTimeT(FileSystem::Instance().GetModificationTime(file));
+    signature.dwarf_size = m_context.getOrLoadDebugInfoData().GetByteSize();
+    manual_index->EnableCache(
+        cache_dir, GetGlobalPluginProperties()->GetIndexCacheMaxByteSize(),
+        std::move(signature));
+  }
+  m_index = std::move(manual_index);
 }
 
 bool SymbolFileDWARF::SupportedVersion(uint16_t version) {
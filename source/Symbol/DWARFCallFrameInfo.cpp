@@ -144,8 +144,11 @@ GetGNUEHPointer(const DataExtractor &DE, offset_t *offset_ptr,
 }
 
 DWARFCallFrameInfo::DWARFCallFrameInfo(ObjectFile &objfile,
-                                       SectionSP &section_sp, Type type)
-    : m_objfile(objfile), m_section_sp(section_sp), m_type(type) {}
+                                       SectionSP &section_sp, Type type,
+                                       const SectionSP &eh_frame_hdr_sp)
+    : m_objfile(objfile), m_section_sp(section_sp),
+      m_eh_frame_hdr_sp(type == EH ? eh_frame_hdr_sp : SectionSP()),
+      m_type(type) {}
 
 bool DWARFCallFrameInfo::GetUnwindPlan(const Address &addr,
                                        UnwindPlan &unwind_plan) {
@@ -180,6 +183,18 @@ bool DWARFCallFrameInfo::GetAddressRange(Address addr, AddressRange &range) {
 
   if (m_section_sp.get() == nullptr || m_section_sp->IsEncrypted())
     return false;
+
+  // Until the index is built, .eh_frame_hdr can answer without scanning the
+  // whole section.
+  if (!m_fde_index_initialized && GetEHFrameHdrTable()) {
+    llvm::Optional<FDEEntryMap::Entry> fde =
+        FindFDEInEHFrameHdr(addr.GetFileAddress());
+    if (!fde || !fde->Contains(addr.GetFileAddress()))
+      return false;
+    range = AddressRange(fde->base, fde->size, m_objfile.GetSectionList());
+    return true;
+  }
+
   GetFDEIndex();
   FDEEntryMap::Entry *fde_entry =
       m_fde_index.FindEntryThatContains(addr.GetFileAddress());
@@ -196,9 +211,18 @@ DWARFCallFrameInfo::GetFirstFDEEntryInRange(const AddressRange &range) {
   if (!m_section_sp || m_section_sp->IsEncrypted())
     return llvm::None;
 
+  addr_t start_file_addr = range.GetBaseAddress().GetFileAddress();
+  if (!m_fde_index_initialized && GetEHFrameHdrTable()) {
+    llvm::Optional<FDEEntryMap::Entry> fde =
+        FindFDEInEHFrameHdr(start_file_addr);
+    if (fde && fde->DoesIntersect(
+                   FDEEntryMap::Range(start_file_addr, range.GetByteSize())))
+      return fde;
+    return llvm::None;
+  }
+
   GetFDEIndex();
 
-  addr_t start_file_addr = range.GetBaseAddress().GetFileAddress();
   const FDEEntryMap::Entry *fde =
       m_fde_index.FindEntryThatContainsOrFollows(start_file_addr);
   if (fde && fde->DoesIntersect(
@@ -228,6 +252,7 @@ void DWARFCallFrameInfo::GetFunctionAddressAndSizeVector(
 
 const DWARFCallFrameInfo::CIE *
 DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset) {
+  std::lock_guard<std::mutex> guard(m_cie_map_mutex);
   cie_map_t::iterator pos = m_cie_map.find(cie_offset);
 
   if (pos != m_cie_map.end()) {
@@ -237,7 +262,16 @@ DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset) {
 
     return pos->second.get();
   }
-  return nullptr;
+
+  // The index scan finds all CIEs. FDEs found through .eh_frame_hdr refer to
+  // CIEs that weren't parsed yet.
+  if (m_fde_index_initialized || !m_eh_frame_hdr_initialized ||
+      !m_cfi_data.ValidOffsetForDataOfSize(cie_offset, 8))
+    return nullptr;
+  CIESP cie_sp = ParseCIE(cie_offset);
+  const CIE *cie = cie_sp.get();
+  m_cie_map[cie_offset] = std::move(cie_sp);
+  return cie;
 }
 
 DWARFCallFrameInfo::CIESP
@@ -389,6 +423,9 @@ DWARFCallFrameInfo::ParseCIE(const dw_offset_t cie_offset) {
                                    cie_sp->initial_row))
         break; // Stop if we hit an unrecognized opcode
     }
+  } else if (length > 0) {
+    // This isn't a CIE.
+    return nullptr;
   }
 
   return cie_sp;
@@ -474,7 +511,12 @@ void DWARFCallFrameInfo::GetFDEIndex() {
         return;
       }
 
-      m_cie_map[current_entry] = std::move(cie_sp);
+      // GetCIE may already have parsed this CIE on demand, and callers hold
+      // raw pointers to it, so keep an existing entry.
+      std::lock_guard<std::mutex> cie_guard(m_cie_map_mutex);
+      CIESP &entry = m_cie_map[current_entry];
+      if (!entry)
+        entry = std::move(cie_sp);
       offset = next_entry;
       continue;
     }
@@ -523,6 +565,165 @@ void DWARFCallFrameInfo::GetFDEIndex() {
   m_fde_index_initialized = true;
 }
 
+bool DWARFCallFrameInfo::GetEHFrameHdrTable() {
+  if (!m_eh_frame_hdr_sp)
+    return false;
+
+  if (m_eh_frame_hdr_initialized)
+    return m_eh_frame_hdr_fde_count > 0;
+
+  std::lock_guard<std::mutex> guard(m_fde_index_mutex);
+
+  if (m_eh_frame_hdr_initialized) // if two threads hit the locker
+    return m_eh_frame_hdr_fde_count > 0;
+
+  // The FDEs the table points to are read from the section data.
+  if (!m_cfi_data_initialized)
+    GetCFIData();
+
+  if (ArchSpec arch = m_objfile.GetArchitecture()) {
+    if (arch.GetTriple().getArch() == llvm::Triple::arm ||
+        arch.GetTriple().getArch() == llvm::Triple::thumb)
+      m_clear_address_zeroth_bit = true;
+  }
+
+  m_objfile.ReadSectionData(m_eh_frame_hdr_sp.get(), m_eh_frame_hdr_data);
+  const addr_t hdr_addr = m_eh_frame_hdr_sp->GetFileAddress();
+  lldb::offset_t offset = 0;
+  const uint8_t version = m_eh_frame_hdr_data.GetU8(&offset);
+  const uint8_t eh_frame_ptr_enc = m_eh_frame_hdr_data.GetU8(&offset);
+  const uint8_t fde_count_enc = m_eh_frame_hdr_data.GetU8(&offset);
+  const uint8_t table_enc = m_eh_frame_hdr_data.GetU8(&offset);
+
+  // The binary search only works if the entries have a fixed size, and only
+  // absolute and section relative values can be decoded.
+  uint8_t value_size = 0;
+  switch (table_enc & DW_EH_PE_MASK_ENCODING) {
+  case DW_EH_PE_udata2:
+  case DW_EH_PE_sdata2:
+    value_size = 2;
+    break;
+  case DW_EH_PE_udata4:
+  case DW_EH_PE_sdata4:
+    value_size = 4;
+    break;
+  case DW_EH_PE_udata8:
+  case DW_EH_PE_sdata8:
+    value_size = 8;
+    break;
+  default:
+    break;
+  }
+  const uint8_t table_base = table_enc & 0x70;
+  if (version == 1 && offset == 4 && eh_frame_ptr_enc != DW_EH_PE_omit &&
+      fde_count_enc != DW_EH_PE_omit && value_size != 0 &&
+      (table_base == DW_EH_PE_absptr || table_base == DW_EH_PE_datarel)) {
+    const addr_t eh_frame_addr =
+        GetGNUEHPointer(m_eh_frame_hdr_data, &offset, eh_frame_ptr_enc,
+                        hdr_addr, LLDB_INVALID_ADDRESS, hdr_addr);
+    const uint64_t fde_count =
+        GetGNUEHPointer(m_eh_frame_hdr_data, &offset, fde_count_enc, hdr_addr,
+                        LLDB_INVALID_ADDRESS, hdr_addr);
+    // The table must describe this eh_frame section and fit in the header.
+    if (eh_frame_addr == m_section_sp->GetFileAddress() && fde_count > 0 &&
+        fde_count < UINT32_MAX &&
+        m_eh_frame_hdr_data.ValidOffsetForDataOfSize(offset, fde_count * 2 *
+                                                                 value_size)) {
+      m_eh_frame_hdr_table_offset = offset;
+      m_eh_frame_hdr_table_encoding = table_enc;
+      m_eh_frame_hdr_entry_size = 2 * value_size;
+      m_eh_frame_hdr_fde_count = fde_count;
+    }
+  }
+
+  m_eh_frame_hdr_initialized = true;
+  return m_eh_frame_hdr_fde_count > 0;
+}
+
+addr_t DWARFCallFrameInfo::GetEHFrameHdrTableEntry(uint32_t index,
+                                                   dw_offset_t &fde_offset) {
+  const addr_t hdr_addr = m_eh_frame_hdr_sp->GetFileAddress();
+  lldb::offset_t offset =
+      m_eh_frame_hdr_table_offset + index * m_eh_frame_hdr_entry_size;
+  addr_t start_addr =
+      GetGNUEHPointer(m_eh_frame_hdr_data, &offset,
+                      m_eh_frame_hdr_table_encoding, hdr_addr,
+                      LLDB_INVALID_ADDRESS, hdr_addr);
+  if (m_clear_address_zeroth_bit)
+    start_addr &= ~1ull;
+  const addr_t fde_addr =
+      GetGNUEHPointer(m_eh_frame_hdr_data, &offset,
+                      m_eh_frame_hdr_table_encoding, hdr_addr,
+                      LLDB_INVALID_ADDRESS, hdr_addr);
+  fde_offset = fde_addr - m_section_sp->GetFileAddress();
+  return start_addr;
+}
+
+llvm::Optional<DWARFCallFrameInfo::FDEEntryMap::Entry>
+DWARFCallFrameInfo::FindFDEInEHFrameHdr(addr_t file_addr) {
+  // Find the first function that starts after file_addr. The one before it
+  // is the only one that can contain file_addr.
+  uint32_t low = 0;
+  uint32_t high = m_eh_frame_hdr_fde_count;
+  dw_offset_t fde_offset;
+  while (low < high) {
+    const uint32_t mid = low + (high - low) / 2;
+    if (GetEHFrameHdrTableEntry(mid, fde_offset) <= file_addr)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+
+  FDEEntryMap::Entry entry;
+  if (low > 0) {
+    GetEHFrameHdrTableEntry(low - 1, fde_offset);
+    if (ParseFDEAddressRange(fde_offset, entry) && entry.Contains(file_addr))
+      return entry;
+  }
+  if (low < m_eh_frame_hdr_fde_count) {
+    GetEHFrameHdrTableEntry(low, fde_offset);
+    if (ParseFDEAddressRange(fde_offset, entry))
+      return entry;
+  }
+  return llvm::None;
+}
+
+bool DWARFCallFrameInfo::ParseFDEAddressRange(dw_offset_t fde_offset,
+                                              FDEEntryMap::Entry &entry) {
+  lldb::offset_t offset = fde_offset;
+  if (!m_cfi_data.ValidOffsetForDataOfSize(offset, 8))
+    return false;
+
+  dw_offset_t cie_id, cie_offset;
+  uint32_t len = m_cfi_data.GetU32(&offset);
+  if (len == UINT32_MAX) {
+    len = m_cfi_data.GetU64(&offset);
+    cie_id = m_cfi_data.GetU64(&offset);
+    cie_offset = fde_offset + 12 - cie_id;
+  } else {
+    cie_id = m_cfi_data.GetU32(&offset);
+    cie_offset = fde_offset + 4 - cie_id;
+  }
+  if (len == 0 || cie_id == 0 || cie_id == UINT32_MAX)
+    return false;
+
+  const CIE *cie = GetCIE(cie_offset);
+  if (!cie)
+    return false;
+
+  const lldb::addr_t pc_rel_addr = m_section_sp->GetFileAddress();
+  lldb::addr_t addr =
+      GetGNUEHPointer(m_cfi_data, &offset, cie->ptr_encoding, pc_rel_addr,
+                      LLDB_INVALID_ADDRESS, LLDB_INVALID_ADDRESS);
+  if (m_clear_address_zeroth_bit)
+    addr &= ~1ull;
+  lldb::addr_t length = GetGNUEHPointer(
+      m_cfi_data, &offset, cie->ptr_encoding & DW_EH_PE_MASK_ENCODING,
+      pc_rel_addr, LLDB_INVALID_ADDRESS, LLDB_INVALID_ADDRESS);
+  entry = FDEEntryMap::Entry(addr, length, fde_offset);
+  return true;
+}
+
 bool DWARFCallFrameInfo::FDEToUnwindPlan(dw_offset_t dwarf_offset,
                                          Address startaddr,
                                          UnwindPlan &unwind_plan) {
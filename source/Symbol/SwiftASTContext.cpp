@@ -68,7 +68,6 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
-#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Target/TargetOptions.h"
@@ -99,6 +98,7 @@
 #include "lldb/Host/Host.h"
 #include "lldb/Host/HostInfo.h"
 #include "lldb/Host/StringConvert.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Symbol/ClangUtil.h"
 #include "lldb/Symbol/CompileUnit.h"
@@ -1894,17 +1894,16 @@ lldb::TypeSystemSP SwiftASTContext::CreateInstance(lldb::LanguageType language,
     // the Clang modules that were imported in this module. This can
     // be a lot of work (potentially ten seconds per module), but it
     // can be performed in parallel.
-    llvm::ThreadPool pool;
-    for (size_t mi = 0; mi != num_images; ++mi) {
+    // Use the global task pool, so that the DWARF indexing this may trigger
+    // in each module shares the worker threads instead of oversubscribing.
+    TaskMapOverInt(0, num_images, [&](size_t mi) {
       auto module_sp = target.GetImages().GetModuleAtIndex(mi);
-      pool.async([=] {
-        auto val_or_err = module_sp->GetTypeSystemForLanguage(lldb::eLanguageTypeSwift);
-        if (!val_or_err) {
-          llvm::consumeError(val_or_err.takeError());
-        }
-      });
-    }
-    pool.wait();
+      auto val_or_err =
+          module_sp->GetTypeSystemForLanguage(lldb::eLanguageTypeSwift);
+      if (!val_or_err) {
+        llvm::consumeError(val_or_err.takeError());
+      }
+    });
   }
 
   Status module_error;
@@ -8,6 +8,7 @@
 
 #include "lldb/Symbol/Symbol.h"
 
+#include "lldb/Core/DataFileCache.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/Section.h"
@@ -17,8 +18,11 @@
 #include "lldb/Symbol/Symtab.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Stream.h"
 
+#include "llvm/Support/EndianStream.h"
+
 using namespace lldb;
 using namespace lldb_private;
 
@@ -571,3 +575,116 @@ bool Symbol::GetDisassembly(const ExecutionContext &exe_ctx, const char *flavor,
 bool Symbol::ContainsFileAddress(lldb::addr_t file_addr) const {
   return m_addr_range.ContainsFileAddress(file_addr);
 }
+
+// A symbol is encoded as follows, all integers little endian:
+//   uint32_t uid
+//   uint16_t type data
+//   uint16_t flag bits, see below
+//   uint8_t  symbol type
+//   uint32_t flags of the original symbol table
+//   uint32_t mangled and demangled name string table offsets
+//   uint64_t section ID, zero if the value is not an address
+//   uint64_t section offset or value, byte size
+static const uint32_t g_null_string_offset = UINT32_MAX;
+static const size_t g_encoded_symbol_size = 45;
+
+enum EncodedSymbolBits : uint16_t {
+  eTypeDataResolved = 1u << 0,
+  eIsSynthetic = 1u << 1,
+  eIsDebug = 1u << 2,
+  eIsExternal = 1u << 3,
+  eSizeIsSibling = 1u << 4,
+  eSizeIsSynthesized = 1u << 5,
+  eSizeIsValid = 1u << 6,
+  eDemangledIsSynthesized = 1u << 7,
+  eContainsLinkerAnnotations = 1u << 8,
+  eIsWeak = 1u << 9,
+};
+
+void Symbol::Encode(llvm::raw_ostream &os, ConstStringTable &strtab) const {
+  namespace endian = llvm::support::endian;
+  using llvm::support::little;
+  uint16_t bits = 0;
+  bits |= m_type_data_resolved ? eTypeDataResolved : 0;
+  bits |= m_is_synthetic ? eIsSynthetic : 0;
+  bits |= m_is_debug ? eIsDebug : 0;
+  bits |= m_is_external ? eIsExternal : 0;
+  bits |= m_size_is_sibling ? eSizeIsSibling : 0;
+  bits |= m_size_is_synthesized ? eSizeIsSynthesized : 0;
+  bits |= m_size_is_valid ? eSizeIsValid : 0;
+  bits |= m_demangled_is_synthesized ? eDemangledIsSynthesized : 0;
+  bits |= m_contains_linker_annotations ? eContainsLinkerAnnotations : 0;
+  bits |= m_is_weak ? eIsWeak : 0;
+
+  // The demangled name is only stored if it was computed already, an empty
+  // one means demangling failed.
+  auto string_offset = [&strtab](ConstString s) {
+    return s.IsNull() ? g_null_string_offset : strtab.Add(s);
+  };
+
+  const Address &addr = m_addr_range.GetBaseAddress();
+  SectionSP section_sp = addr.GetSection();
+  endian::write<uint32_t>(os, m_uid, little);
+  endian::write<uint16_t>(os, m_type_data, little);
+  endian::write<uint16_t>(os, bits, little);
+  endian::write<uint8_t>(os, m_type, little);
+  endian::write<uint32_t>(os, m_flags, little);
+  endian::write<uint32_t>(os, string_offset(m_mangled.GetMangledName()),
+                          little);
+  endian::write<uint32_t>(
+      os, string_offset(m_mangled.GetCachedDemangledName()), little);
+  endian::write<uint64_t>(os, section_sp ? section_sp->GetID() : 0, little);
+  endian::write<uint64_t>(os, addr.GetOffset(), little);
+  endian::write<uint64_t>(os, m_addr_range.GetByteSize(), little);
+}
+
+bool Symbol::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
+                    const ConstStringTableReader &strtab,
+                    const SectionList *section_list) {
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, g_encoded_symbol_size))
+    return false;
+
+  m_uid = data.GetU32(offset_ptr);
+  m_type_data = data.GetU16(offset_ptr);
+  const uint16_t bits = data.GetU16(offset_ptr);
+  m_type_data_resolved = (bits & eTypeDataResolved) != 0;
+  m_is_synthetic = (bits & eIsSynthetic) != 0;
+  m_is_debug = (bits & eIsDebug) != 0;
+  m_is_external = (bits & eIsExternal) != 0;
+  m_size_is_sibling = (bits & eSizeIsSibling) != 0;
+  m_size_is_synthesized = (bits & eSizeIsSynthesized) != 0;
+  m_size_is_valid = (bits & eSizeIsValid) != 0;
+  m_demangled_is_synthesized = (bits & eDemangledIsSynthesized) != 0;
+  m_contains_linker_annotations = (bits & eContainsLinkerAnnotations) != 0;
+  m_is_weak = (bits & eIsWeak) != 0;
+  m_type = data.GetU8(offset_ptr);
+  m_flags = data.GetU32(offset_ptr);
+
+  auto get_string = [&](ConstString &s) {
+    const uint32_t offset = data.GetU32(offset_ptr);
+    if (offset == g_null_string_offset) {
+      s.Clear();
+      return true;
+    }
+    return strtab.GetString(offset, s);
+  };
+  ConstString mangled, demangled;
+  if (!get_string(mangled) || !get_string(demangled))
+    return false;
+  m_mangled.SetMangledName(mangled);
+  m_mangled.SetDemangledName(demangled);
+
+  const user_id_t section_id = data.GetU64(offset_ptr);
+  const addr_t offset = data.GetU64(offset_ptr);
+  const addr_t byte_size = data.GetU64(offset_ptr);
+  if (section_id) {
+    SectionSP section_sp =
+        section_list ? section_list->FindSectionByID(section_id) : nullptr;
+    if (!section_sp)
+      return false;
+    m_addr_range = AddressRange(section_sp, offset, byte_size);
+  } else {
+    m_addr_range = AddressRange(Address(offset), byte_size);
+  }
+  return true;
+}
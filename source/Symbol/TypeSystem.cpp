@@ -16,6 +16,7 @@
 
 #include "lldb/Symbol/TypeSystem.h"
 
+#include <atomic>
 #include <set>
 
 #include "lldb/Utility/Status.h"
@@ -44,7 +45,11 @@ size_t LanguageSet::Size() const { return bitvector.count(); }
 bool LanguageSet::Empty() const { return bitvector.none(); }
 bool LanguageSet::operator[](unsigned i) const { return bitvector[i]; }
 
-TypeSystem::TypeSystem(LLVMCastKind kind) : m_kind(kind), m_sym_file(nullptr) {}
+static std::atomic<uint64_t> g_next_type_system_id(1);
+
+TypeSystem::TypeSystem(LLVMCastKind kind)
+    : m_kind(kind), m_unique_id(g_next_type_system_id++),
+      m_sym_file(nullptr) {}
 
 TypeSystem::~TypeSystem() {}
 
@@ -8,6 +8,7 @@
 
 #include "lldb/Symbol/UnwindTable.h"
 
+#include <algorithm>
 #include <stdio.h>
 
 #include "lldb/Core/Module.h"
@@ -19,6 +20,7 @@
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/SymbolVendor.h"
+#include "llvm/Support/Allocator.h"
 
 // There is one UnwindTable object per ObjectFile. It contains a list of Unwind
 // objects -- one per function, populated lazily -- for the ObjectFile. Each
@@ -28,8 +30,11 @@ using namespace lldb;
 using namespace lldb_private;
 
 UnwindTable::UnwindTable(Module &module)
-    : m_module(module), m_unwinds(), m_initialized(false), m_mutex(),
-      m_eh_frame_up(), m_compact_unwind_up(), m_arm_unwind_up() {}
+    : m_module(module), m_unwinds(), m_new_unwinds(),
+      m_unwinds_allocator_sp(
+          std::make_shared<llvm::SpecificBumpPtrAllocator<FuncUnwinders>>()),
+      m_initialized(false), m_mutex(), m_eh_frame_up(), m_compact_unwind_up(),
+      m_arm_unwind_up() {}
 
 // We can't do some of this initialization when the ObjectFile is running its
 // ctor; delay doing it until needed for something.
@@ -53,8 +58,9 @@ void UnwindTable::Initialize() {
 
   SectionSP sect = sl->FindSectionByType(eSectionTypeEHFrame, true);
   if (sect.get()) {
-    m_eh_frame_up.reset(
-        new DWARFCallFrameInfo(*object_file, sect, DWARFCallFrameInfo::EH));
+    SectionSP hdr_sect = sl->FindSectionByName(ConstString(".eh_frame_hdr"));
+    m_eh_frame_up.reset(new DWARFCallFrameInfo(
+        *object_file, sect, DWARFCallFrameInfo::EH, hdr_sect));
   }
 
   sect = sl->FindSectionByType(eSectionTypeDWARFDebugFrame, true);
@@ -100,6 +106,38 @@ llvm::Optional<AddressRange> UnwindTable::GetAddressRange(const Address &addr,
   return llvm::None;
 }
 
+static bool StartsAfter(addr_t file_addr,
+                        const std::pair<addr_t, FuncUnwindersSP> &entry) {
+  return file_addr < entry.first;
+}
+
+static bool StartsBefore(const std::pair<addr_t, FuncUnwindersSP> &lhs,
+                         const std::pair<addr_t, FuncUnwindersSP> &rhs) {
+  return lhs.first < rhs.first;
+}
+
+FuncUnwindersSP UnwindTable::FindContainingAddress(const collection &unwinds,
+                                                   const Address &addr) {
+  // There is an UnwindTable per object file, so we can safely use file handles
+  const_iterator pos = std::upper_bound(
+      unwinds.begin(), unwinds.end(), addr.GetFileAddress(), StartsAfter);
+  if (pos != unwinds.begin() && std::prev(pos)->second->ContainsAddress(addr))
+    return std::prev(pos)->second;
+  return nullptr;
+}
+
+void UnwindTable::MergeNewUnwinds() {
+  if (m_new_unwinds.empty())
+    return;
+  const size_t old_size = m_unwinds.size();
+  m_unwinds.insert(m_unwinds.end(),
+                   std::make_move_iterator(m_new_unwinds.begin()),
+                   std::make_move_iterator(m_new_unwinds.end()));
+  std::inplace_merge(m_unwinds.begin(), m_unwinds.begin() + old_size,
+                     m_unwinds.end(), StartsBefore);
+  m_new_unwinds.clear();
+}
+
 FuncUnwindersSP
 UnwindTable::GetFuncUnwindersContainingAddress(const Address &addr,
                                                SymbolContext &sc) {
@@ -107,30 +145,31 @@ UnwindTable::GetFuncUnwindersContainingAddress(const Address &addr,
 
   std::lock_guard<std::mutex> guard(m_mutex);
 
-  // There is an UnwindTable per object file, so we can safely use file handles
-  addr_t file_addr = addr.GetFileAddress();
-  iterator end = m_unwinds.end();
-  iterator insert_pos = end;
-  if (!m_unwinds.empty()) {
-    insert_pos = m_unwinds.lower_bound(file_addr);
-    iterator pos = insert_pos;
-    if ((pos == m_unwinds.end()) ||
-        (pos != m_unwinds.begin() &&
-         pos->second->GetFunctionStartAddress() != addr))
-      --pos;
-
-    if (pos->second->ContainsAddress(addr))
-      return pos->second;
-  }
+  if (FuncUnwindersSP func_unwinder_sp = FindContainingAddress(m_unwinds, addr))
+    return func_unwinder_sp;
+  if (FuncUnwindersSP func_unwinder_sp =
+          FindContainingAddress(m_new_unwinds, addr))
+    return func_unwinder_sp;
 
   auto range_or = GetAddressRange(addr, sc);
   if (!range_or)
     return nullptr;
 
-  FuncUnwindersSP func_unwinder_sp(new FuncUnwinders(*this, *range_or));
-  m_unwinds.insert(insert_pos,
-                   std::make_pair(range_or->GetBaseAddress().GetFileAddress(),
-                                  func_unwinder_sp));
+  FuncUnwinders *func_unwinder =
+      new (m_unwinds_allocator_sp->Allocate()) FuncUnwinders(*this, *range_or);
+  FuncUnwindersSP func_unwinder_sp(m_unwinds_allocator_sp, func_unwinder);
+  const addr_t start_addr = range_or->GetBaseAddress().GetFileAddress();
+  m_new_unwinds.insert(std::upper_bound(m_new_unwinds.begin(),
+                                        m_new_unwinds.end(), start_addr,
+                                        StartsAfter),
+                       std::make_pair(start_addr, func_unwinder_sp));
+
+  // Merge once the new list is longer than the square root of the merged
+  // one. Both an insertion and the share of a merge it pays for then cost
+  // O(sqrt(N)), instead of the O(N) of inserting into m_unwinds directly.
+  const size_t num_new = m_new_unwinds.size();
+  if (num_new > 64 && num_new * num_new > m_unwinds.size())
+    MergeNewUnwinds();
   return func_unwinder_sp;
 }
 
@@ -152,6 +191,7 @@ UnwindTable::GetUncachedFuncUnwindersContainingAddress(const Address &addr,
 
 void UnwindTable::Dump(Stream &s) {
   std::lock_guard<std::mutex> guard(m_mutex);
+  MergeNewUnwinds();
   s.Format("UnwindTable for '{0}':\n", m_module.GetFileSpec());
   const_iterator begin = m_unwinds.begin();
   const_iterator end = m_unwinds.end();
@@ -177,6 +217,14 @@ CompactUnwindInfo *UnwindTable::GetCompactUnwindInfo() {
   return m_compact_unwind_up.get();
 }
 
+void UnwindTable::Preload() {
+  Initialize();
+  if (m_eh_frame_up)
+    m_eh_frame_up->PreloadFDEIndex();
+  if (m_debug_frame_up)
+    m_debug_frame_up->PreloadFDEIndex();
+}
+
 ArmUnwindInfo *UnwindTable::GetArmUnwindInfo() {
   Initialize();
   return m_arm_unwind_up.get();
@@ -7,12 +7,18 @@
 //===----------------------------------------------------------------------===//
 
 #include "lldb/Target/Memory.h"
+#include "lldb/Core/Section.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/SectionLoadList.h"
+#include "lldb/Target/Target.h"
 #include "lldb/Utility/DataBufferHeap.h"
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/RangeMap.h"
 #include "lldb/Utility/State.h"
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/MathExtras.h"
+
 #include <cinttypes>
 #include <memory>
 
@@ -23,18 +29,71 @@ using namespace lldb_private;
 MemoryCache::MemoryCache(Process &process)
     : m_mutex(), m_L1_cache(), m_L2_cache(), m_invalid_ranges(),
       m_process(process),
-      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()) {}
+      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()) {
+  ReadSettings();
+}
 
 // Destructor
 MemoryCache::~MemoryCache() {}
 
+void MemoryCache::ReadSettings() {
+  m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+  m_L2_cache_max_byte_size = m_process.GetMemoryCacheMaxByteSize();
+  // Never read more than half of the cache at once, the lines of a read must
+  // not evict each other.
+  uint64_t max_lines =
+      m_L2_cache_max_byte_size / 2 / std::max(m_L2_cache_line_byte_size, 1u);
+  m_prefetch_max_lines = std::max<uint64_t>(
+      1, std::min<uint64_t>(m_process.GetMemoryCachePrefetchMaxLines(),
+                            max_lines));
+  m_prefetch_lines = 1;
+  m_prefetch_next_addr = LLDB_INVALID_ADDRESS;
+}
+
 void MemoryCache::Clear(bool clear_invalid_ranges) {
   std::lock_guard<std::recursive_mutex> guard(m_mutex);
   m_L1_cache.clear();
   m_L2_cache.clear();
+  m_L2_lru.clear();
+  m_L2_cache_byte_size = 0;
   if (clear_invalid_ranges)
     m_invalid_ranges.Clear();
-  m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+  ReadSettings();
+}
+
+void MemoryCache::ClearWritableMemory() {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  if (m_L2_cache_line_byte_size != m_process.GetMemoryCacheLineSize()) {
+    Clear();
+    return;
+  }
+
+  // The data provided by the process plugin describes the current stop only.
+  m_L1_cache.clear();
+
+  // Check every section only once, there are usually many lines per section.
+  llvm::DenseMap<Section *, bool> section_is_unchanged;
+  SectionLoadList &load_list = m_process.GetTarget().GetSectionLoadList();
+  for (LineMap::iterator pos = m_L2_cache.begin(); pos != m_L2_cache.end();) {
+    SectionSP section_sp = pos->second.read_only_section.lock();
+    bool keep = false;
+    if (section_sp) {
+      auto insertion = section_is_unchanged.try_emplace(section_sp.get());
+      if (insertion.second)
+        insertion.first->second = load_list.GetSectionLoadAddress(section_sp) ==
+                                  pos->second.section_load_addr;
+      keep = insertion.first->second;
+    }
+    if (keep) {
+      ++m_stats.retained_lines;
+      ++pos;
+    } else {
+      LineMap::iterator next = std::next(pos);
+      RemoveLine(pos);
+      pos = next;
+    }
+  }
+  ReadSettings();
 }
 
 void MemoryCache::AddL1CacheData(lldb::addr_t addr, const void *src,
@@ -49,6 +108,65 @@ void MemoryCache::AddL1CacheData(lldb::addr_t addr,
   m_L1_cache[addr] = data_buffer_sp;
 }
 
+void MemoryCache::AddL2CacheData(lldb::addr_t addr, const void *src,
+                                 size_t src_len) {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  if (m_L2_cache_max_byte_size == 0)
+    return;
+
+  const uint8_t *bytes = static_cast<const uint8_t *>(src);
+  const addr_t line_size = m_L2_cache_line_byte_size;
+  for (addr_t offset = llvm::alignTo(addr, line_size) - addr;
+       offset + line_size <= src_len; offset += line_size) {
+    AddLine(addr + offset,
+            std::make_shared<DataBufferHeap>(bytes + offset, line_size));
+    ++m_stats.prefetched_lines;
+  }
+}
+
+void MemoryCache::AddLine(addr_t line_addr, DataBufferSP data_sp) {
+  CacheLine &line = m_L2_cache[line_addr];
+  if (line.data) {
+    m_L2_cache_byte_size -= line.data->GetByteSize();
+    m_L2_lru.erase(line.lru_pos);
+  }
+  m_L2_cache_byte_size += data_sp->GetByteSize();
+  m_L2_lru.push_front(line_addr);
+  line.lru_pos = m_L2_lru.begin();
+  line.data = std::move(data_sp);
+  line.read_only_section.reset();
+  line.section_load_addr = LLDB_INVALID_ADDRESS;
+
+  // Remember whether the line is part of a section that the process cannot
+  // modify, so it can survive the next stop.
+  Address so_addr;
+  Target &target = m_process.GetTarget();
+  if (target.GetSectionLoadList().ResolveLoadAddress(line_addr, so_addr)) {
+    SectionSP section_sp = so_addr.GetSection();
+    const uint32_t permissions = section_sp ? section_sp->GetPermissions() : 0;
+    if ((permissions & ePermissionsReadable) &&
+        !(permissions & ePermissionsWritable) &&
+        so_addr.GetOffset() + line.data->GetByteSize() <=
+            section_sp->GetByteSize()) {
+      line.read_only_section = section_sp;
+      line.section_load_addr =
+          target.GetSectionLoadList().GetSectionLoadAddress(section_sp);
+    }
+  }
+
+  while (m_L2_cache_byte_size > m_L2_cache_max_byte_size &&
+         m_L2_lru.size() > 1) {
+    RemoveLine(m_L2_cache.find(m_L2_lru.back()));
+    ++m_stats.evictions;
+  }
+}
+
+void MemoryCache::RemoveLine(LineMap::iterator pos) {
+  m_L2_cache_byte_size -= pos->second.data->GetByteSize();
+  m_L2_lru.erase(pos->second.lru_pos);
+  m_L2_cache.erase(pos);
+}
+
 void MemoryCache::Flush(addr_t addr, size_t size) {
   if (size == 0)
     return;
@@ -90,9 +208,9 @@ void MemoryCache::Flush(addr_t addr, size_t size) {
     uint32_t cache_idx = 0;
     for (addr_t curr_addr = first_cache_line_addr; cache_idx < num_cache_lines;
          curr_addr += cache_line_byte_size, ++cache_idx) {
-      BlockMap::iterator pos = m_L2_cache.find(curr_addr);
+      LineMap::iterator pos = m_L2_cache.find(curr_addr);
       if (pos != m_L2_cache.end())
-        m_L2_cache.erase(pos);
+        RemoveLine(pos);
     }
   }
 }
@@ -122,6 +240,85 @@ bool MemoryCache::RemoveInvalidRange(lldb::addr_t base_addr,
   return false;
 }
 
+MemoryCache::Statistics MemoryCache::GetStatistics() {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  return m_stats;
+}
+
+size_t MemoryCache::FillLines(addr_t line_addr, size_t byte_size,
+                              Status &error) {
+  const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+  const uint64_t needed_lines =
+      (byte_size + cache_line_byte_size - 1) / cache_line_byte_size;
+
+  // Grow the prefetch window while the misses continue close to where the
+  // previous read ended, shrink it back to a single line as soon as they
+  // don't. Allowing a gap of up to a window keeps it growing when the reads
+  // skip some memory, like when walking a list with nodes laid out in
+  // ascending order.
+  if (m_prefetch_next_addr != LLDB_INVALID_ADDRESS &&
+      line_addr >= m_prefetch_next_addr &&
+      (line_addr - m_prefetch_next_addr) / cache_line_byte_size <
+          m_prefetch_lines)
+    m_prefetch_lines = std::min(m_prefetch_lines * 2, m_prefetch_max_lines);
+  else
+    m_prefetch_lines = 1;
+
+  // Stop at lines that are cached already or that can't be read.
+  uint64_t num_lines = 1;
+  const uint64_t max_lines = std::max<uint64_t>(needed_lines, m_prefetch_lines);
+  for (; num_lines < max_lines; ++num_lines) {
+    const addr_t next_addr = line_addr + num_lines * cache_line_byte_size;
+    if (next_addr < line_addr || m_L2_cache.count(next_addr) ||
+        m_invalid_ranges.FindEntryThatContains(next_addr))
+      break;
+  }
+
+  size_t read_size = num_lines * cache_line_byte_size;
+  DataBufferHeap buffer(read_size, 0);
+  size_t bytes_read = m_process.ReadMemoryFromInferior(
+      line_addr, buffer.GetBytes(), read_size, error);
+  ++m_stats.process_reads;
+  // Some stubs fail the whole read if a part of it is not readable, don't let
+  // the lines read ahead break the read of the needed lines.
+  if (bytes_read == 0 && num_lines > needed_lines) {
+    read_size = needed_lines * cache_line_byte_size;
+    bytes_read = m_process.ReadMemoryFromInferior(line_addr, buffer.GetBytes(),
+                                                  read_size, error);
+    ++m_stats.process_reads;
+  }
+  m_stats.process_bytes_read += bytes_read;
+  if (bytes_read == 0) {
+    m_prefetch_next_addr = LLDB_INVALID_ADDRESS;
+    return 0;
+  }
+  // Reading the needed bytes succeeded even if reading ahead did not.
+  if (bytes_read >= byte_size)
+    error.Clear();
+
+  const uint64_t lines_read =
+      (bytes_read + cache_line_byte_size - 1) / cache_line_byte_size;
+  m_stats.misses += std::min(lines_read, needed_lines);
+  if (lines_read > needed_lines)
+    m_stats.prefetched_lines += lines_read - needed_lines;
+
+  // The lines are added in reverse order so that the first line, which the
+  // caller will read next, is the most recently used one.
+  for (uint64_t i = lines_read; i-- > 0;) {
+    const size_t offset = i * cache_line_byte_size;
+    const size_t line_size =
+        std::min<size_t>(cache_line_byte_size, bytes_read - offset);
+    AddLine(line_addr + offset,
+            std::make_shared<DataBufferHeap>(buffer.GetBytes() + offset,
+                                             line_size));
+  }
+
+  // There is nothing to prefetch after the end of the readable memory.
+  m_prefetch_next_addr =
+      bytes_read == read_size ? line_addr + bytes_read : LLDB_INVALID_ADDRESS;
+  return bytes_read;
+}
+
 size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
                          Status &error) {
   size_t bytes_left = dst_len;
@@ -148,20 +345,14 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
     }
   }
 
-  // If this memory read request is larger than the cache line size, then we
-  // (1) try to read as much of it at once as possible, and (2) don't add the
-  // data to the memory cache.  We don't want to split a big read up into more
-  // separate reads than necessary, and with a large memory read request, it is
-  // unlikely that the caller function will ask for the next
-  // 4 bytes after the large memory read - so there's little benefit to saving
-  // it in the cache.
-  if (dst && dst_len > m_L2_cache_line_byte_size) {
+  // If this memory read request is too large to be cached without evicting
+  // its own lines, read it at once and don't add it to the cache. It is
+  // unlikely that the caller will ask for the same memory again.
+  if (dst && dst_len > m_L2_cache_max_byte_size / 4) {
     size_t bytes_read =
         m_process.ReadMemoryFromInferior(addr, dst, dst_len, error);
-    // Add this non block sized range to the L1 cache if we actually read
-    // anything
-    if (bytes_read > 0)
-      AddL1CacheData(addr, dst, bytes_read);
+    ++m_stats.process_reads;
+    m_stats.process_bytes_read += bytes_read;
     return bytes_read;
   }
 
@@ -178,66 +369,41 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
         return dst_len - bytes_left;
       }
 
-      BlockMap::const_iterator pos = m_L2_cache.find(curr_addr);
-      BlockMap::const_iterator end = m_L2_cache.end();
-
-      if (pos != end) {
-        size_t curr_read_size = cache_line_byte_size - cache_offset;
-        if (curr_read_size > bytes_left)
-          curr_read_size = bytes_left;
-
-        memcpy(dst_buf + dst_len - bytes_left,
-               pos->second->GetBytes() + cache_offset, curr_read_size);
-
-        bytes_left -= curr_read_size;
-        curr_addr += curr_read_size + cache_offset;
-        cache_offset = 0;
-
-        if (bytes_left > 0) {
-          // Get sequential cache page hits
-          for (++pos; (pos != end) && (bytes_left > 0); ++pos) {
-            assert((curr_addr % cache_line_byte_size) == 0);
-
-            if (pos->first != curr_addr)
-              break;
-
-            curr_read_size = pos->second->GetByteSize();
-            if (curr_read_size > bytes_left)
-              curr_read_size = bytes_left;
+      LineMap::iterator pos = m_L2_cache.find(curr_addr);
+      if (pos == m_L2_cache.end()) {
+        // We need to read from the process, then get the data out of the
+        // cache.
+        if (FillLines(curr_addr, cache_offset + bytes_left, error) == 0)
+          return dst_len - bytes_left;
+        pos = m_L2_cache.find(curr_addr);
+        assert(pos != m_L2_cache.end());
+      } else {
+        ++m_stats.hits;
+      }
 
-            memcpy(dst_buf + dst_len - bytes_left, pos->second->GetBytes(),
-                   curr_read_size);
+      CacheLine &line = pos->second;
+      m_L2_lru.splice(m_L2_lru.begin(), m_L2_lru, line.lru_pos);
 
-            bytes_left -= curr_read_size;
-            curr_addr += curr_read_size;
+      const size_t line_size = line.data->GetByteSize();
+      if (cache_offset >= line_size)
+        return dst_len - bytes_left;
+      size_t curr_read_size = line_size - cache_offset;
+      if (curr_read_size > bytes_left)
+        curr_read_size = bytes_left;
 
-            // We have a cache page that succeeded to read some bytes but not
-            // an entire page. If this happens, we must cap off how much data
-            // we are able to read...
-            if (pos->second->GetByteSize() != cache_line_byte_size)
-              return dst_len - bytes_left;
-          }
-        }
-      }
+      memcpy(dst_buf + dst_len - bytes_left,
+             line.data->GetBytes() + cache_offset, curr_read_size);
 
-      // We need to read from the process
+      bytes_left -= curr_read_size;
 
-      if (bytes_left > 0) {
-        assert((curr_addr % cache_line_byte_size) == 0);
-        std::unique_ptr<DataBufferHeap> data_buffer_heap_up(
-            new DataBufferHeap(cache_line_byte_size, 0));
-        size_t process_bytes_read = m_process.ReadMemoryFromInferior(
-            curr_addr, data_buffer_heap_up->GetBytes(),
-            data_buffer_heap_up->GetByteSize(), error);
-        if (process_bytes_read == 0)
-          return dst_len - bytes_left;
+      // We have a cache line that succeeded to read some bytes but not an
+      // entire line. If this happens, we must cap off how much data we are
+      // able to read...
+      if (line_size != cache_line_byte_size)
+        return dst_len - bytes_left;
 
-        if (process_bytes_read != cache_line_byte_size)
-          data_buffer_heap_up->SetByteSize(process_bytes_read);
-        m_L2_cache[curr_addr] = DataBufferSP(data_buffer_heap_up.release());
-        // We have read data and put it into the cache, continue through the
-        // loop again to get the data out of the cache...
-      }
+      curr_addr += cache_line_byte_size;
+      cache_offset = 0;
     }
   }
 
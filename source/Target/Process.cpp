@@ -15,8 +15,10 @@
 
 #include "Plugins/Process/Utility/InferiorCallPOSIX.h"
 #include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Breakpoint/FastTracepoint.h"
 #include "lldb/Breakpoint/StoppointCallbackContext.h"
 #include "lldb/Core/Debugger.h"
+#include "lldb/Core/Disassembler.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/PluginManager.h"
@@ -31,6 +33,7 @@
 #include "lldb/Host/HostInfo.h"
 #include "lldb/Host/OptionParser.h"
 #include "lldb/Host/Pipe.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Host/Terminal.h"
 #include "lldb/Host/ThreadLauncher.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
@@ -51,6 +54,7 @@
 #include "lldb/Target/Platform.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/StackFrame.h"
 #include "lldb/Target/StopInfo.h"
 #include "lldb/Target/StructuredDataPlugin.h"
 #include "lldb/Target/SystemRuntime.h"
@@ -162,6 +166,18 @@ uint64_t ProcessProperties::GetMemoryCacheLineSize() const {
       nullptr, idx, g_process_properties[idx].default_uint_value);
 }
 
+uint64_t ProcessProperties::GetMemoryCacheMaxByteSize() const {
+  const uint32_t idx = ePropertyMemCacheMaxByteSize;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_process_properties[idx].default_uint_value);
+}
+
+uint64_t ProcessProperties::GetMemoryCachePrefetchMaxLines() const {
+  const uint32_t idx = ePropertyMemCachePrefetchMaxLines;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_process_properties[idx].default_uint_value);
+}
+
 Args ProcessProperties::GetExtraStartupCommands() const {
   Args args;
   const uint32_t idx = ePropertyExtraStartCommand;
@@ -247,6 +263,18 @@ std::chrono::seconds ProcessProperties::GetUtilityExpressionTimeout() const {
   return std::chrono::seconds(value);
 }
 
+bool ProcessProperties::GetParallelUnwind() const {
+  const uint32_t idx = ePropertyParallelUnwind;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_process_properties[idx].default_uint_value != 0);
+}
+
+uint64_t ProcessProperties::GetStackPrefetchSize() const {
+  const uint32_t idx = ePropertyStackPrefetchSize;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_process_properties[idx].default_uint_value);
+}
+
 Status ProcessLaunchCommandOptions::SetOptionValue(
     uint32_t option_idx, llvm::StringRef option_arg,
     ExecutionContext *execution_context) {
@@ -1551,7 +1579,7 @@ void Process::SetPrivateState(StateType new_state) {
       m_mod_id.BumpStopID();
       if (!m_mod_id.IsLastResumeForUserExpression())
         m_mod_id.SetStopEventForLastNaturalStopID(event_sp);
-      m_memory_cache.Clear();
+      m_memory_cache.ClearWritableMemory();
       LLDB_LOGF(log, "Process::SetPrivateState (%s) stop_id = %u",
                 StateAsCString(new_state), m_mod_id.GetStopID());
     }
@@ -1674,7 +1702,10 @@ const BreakpointSiteList &Process::GetBreakpointSiteList() const {
 void Process::DisableAllBreakpointSites() {
   m_breakpoint_site_list.ForEach([this](BreakpointSite *bp_site) -> void {
     //        bp_site->SetEnabled(true);
-    DisableBreakpointSite(bp_site);
+    if (bp_site->GetType() == BreakpointSite::eFastTrace)
+      DisableFastTracepoint(bp_site);
+    else
+      DisableBreakpointSite(bp_site);
   });
 }
 
@@ -1691,7 +1722,11 @@ Status Process::DisableBreakpointSiteByID(lldb::user_id_t break_id) {
   Status error;
   BreakpointSiteSP bp_site_sp = m_breakpoint_site_list.FindByID(break_id);
   if (bp_site_sp) {
-    if (bp_site_sp->IsEnabled())
+    if (!bp_site_sp->IsEnabled())
+      return error;
+    if (bp_site_sp->GetType() == BreakpointSite::eFastTrace)
+      error = DisableFastTracepoint(bp_site_sp.get());
+    else
       error = DisableBreakpointSite(bp_site_sp.get());
   } else {
     error.SetErrorStringWithFormat("invalid breakpoint site ID: %" PRIu64,
@@ -1705,7 +1740,11 @@ Status Process::EnableBreakpointSiteByID(lldb::user_id_t break_id) {
   Status error;
   BreakpointSiteSP bp_site_sp = m_breakpoint_site_list.FindByID(break_id);
   if (bp_site_sp) {
-    if (!bp_site_sp->IsEnabled())
+    if (bp_site_sp->IsEnabled())
+      return error;
+    if (bp_site_sp->GetType() == BreakpointSite::eFastTrace)
+      error = EnableFastTracepoint(bp_site_sp.get());
+    else
       error = EnableBreakpointSite(bp_site_sp.get());
   } else {
     error.SetErrorStringWithFormat("invalid breakpoint site ID: %" PRIu64,
@@ -1714,6 +1753,26 @@ Status Process::EnableBreakpointSiteByID(lldb::user_id_t break_id) {
   return error;
 }
 
+// Find a site other than bp_site that starts in [low, high) or whose bytes
+// reach into it.
+static BreakpointSiteSP FindOverlappingSite(const BreakpointSiteList &site_list,
+                                            const BreakpointSite *bp_site,
+                                            addr_t low, addr_t high) {
+  BreakpointSiteList sites_in_range;
+  BreakpointSiteSP overlapping_sp;
+  if (!site_list.FindInRange(low, high, sites_in_range))
+    return overlapping_sp;
+  sites_in_range.ForEach([&](BreakpointSite *site) {
+    if (overlapping_sp || site == bp_site)
+      return;
+    const addr_t start = site->GetLoadAddress();
+    const addr_t end = start + std::max<size_t>(site->GetByteSize(), 1);
+    if (start < high && end > low)
+      overlapping_sp = site->shared_from_this();
+  });
+  return overlapping_sp;
+}
+
 lldb::break_id_t
 Process::CreateBreakpointSite(const BreakpointLocationSP &owner,
                               bool use_hardware) {
@@ -1775,15 +1834,47 @@ Process::CreateBreakpointSite(const BreakpointLocationSP &owner,
 
     bp_site_sp = m_breakpoint_site_list.FindByAddress(load_addr);
 
+    const bool fast_trace = owner->GetBreakpoint().IsFastTrace();
     if (bp_site_sp) {
+      // A site either traps or records hits without stopping, it can't do
+      // both.
+      if (fast_trace !=
+          (bp_site_sp->GetType() == BreakpointSite::eFastTrace)) {
+        if (show_error)
+          GetTarget().GetDebugger().GetErrorFile()->Printf(
+              "warning: failed to set breakpoint site at 0x%" PRIx64
+              " for breakpoint %i.%i: the address already has a %s\n",
+              load_addr, owner->GetBreakpoint().GetID(), owner->GetID(),
+              fast_trace ? "breakpoint" : "fast tracepoint");
+        return LLDB_INVALID_BREAK_ID;
+      }
       bp_site_sp->AddOwner(owner);
       owner->SetBreakpointSite(bp_site_sp);
       return bp_site_sp->GetID();
     } else {
+      // Traps in the instructions a fast tracepoint replaces would never be
+      // hit. Fast tracepoints check the sites in their range when they are
+      // enabled.
+      BreakpointSiteSP tracepoint_sp;
+      if (!fast_trace)
+        tracepoint_sp = FindOverlappingSite(m_breakpoint_site_list, nullptr,
+                                            load_addr, load_addr + 1);
+      if (tracepoint_sp &&
+          tracepoint_sp->GetType() == BreakpointSite::eFastTrace) {
+        if (show_error)
+          GetTarget().GetDebugger().GetErrorFile()->Printf(
+              "warning: failed to set breakpoint site at 0x%" PRIx64
+              " for breakpoint %i.%i: the fast tracepoint at 0x%" PRIx64
+              " replaces the instructions at the address\n",
+              load_addr, owner->GetBreakpoint().GetID(), owner->GetID(),
+              tracepoint_sp->GetLoadAddress());
+        return LLDB_INVALID_BREAK_ID;
+      }
       bp_site_sp.reset(new BreakpointSite(&m_breakpoint_site_list, owner,
                                           load_addr, use_hardware));
       if (bp_site_sp) {
-        Status error = EnableBreakpointSite(bp_site_sp.get());
+        Status error = fast_trace ? EnableFastTracepoint(bp_site_sp.get())
+                                  : EnableBreakpointSite(bp_site_sp.get());
         if (error.Success()) {
           owner->SetBreakpointSite(bp_site_sp);
           return m_breakpoint_site_list.Add(bp_site_sp);
@@ -1810,8 +1901,12 @@ void Process::RemoveOwnerFromBreakpointSite(lldb::user_id_t owner_id,
   uint32_t num_owners = bp_site_sp->RemoveOwner(owner_id, owner_loc_id);
   if (num_owners == 0) {
     // Don't try to disable the site if we don't have a live process anymore.
-    if (IsAlive())
-      DisableBreakpointSite(bp_site_sp.get());
+    if (IsAlive()) {
+      if (bp_site_sp->GetType() == BreakpointSite::eFastTrace)
+        DisableFastTracepoint(bp_site_sp.get());
+      else
+        DisableBreakpointSite(bp_site_sp.get());
+    }
     m_breakpoint_site_list.RemoveByAddress(bp_site_sp->GetLoadAddress());
   }
 }
@@ -1825,7 +1920,8 @@ size_t Process::RemoveBreakpointOpcodesFromBuffer(addr_t bp_addr, size_t size,
                                          bp_sites_in_range)) {
     bp_sites_in_range.ForEach([bp_addr, size,
                                buf](BreakpointSite *bp_site) -> void {
-      if (bp_site->GetType() == BreakpointSite::eSoftware) {
+      if (bp_site->GetType() == BreakpointSite::eSoftware ||
+          bp_site->GetType() == BreakpointSite::eFastTrace) {
         addr_t intersect_addr;
         size_t intersect_size;
         size_t opcode_offset;
@@ -2019,6 +2115,301 @@ Status Process::DisableSoftwareBreakpoint(BreakpointSite *bp_site) {
   return error;
 }
 
+// Returns true if the pc of a thread in \a thread_list is in [low, high).
+static bool IsAnyThreadPCInRange(ThreadList &thread_list, addr_t low,
+                                 addr_t high) {
+  for (ThreadSP thread_sp : thread_list.Threads()) {
+    RegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext();
+    if (!reg_ctx_sp)
+      continue;
+    addr_t pc = reg_ctx_sp->GetPC();
+    if (pc >= low && pc < high)
+      return true;
+  }
+  return false;
+}
+
+// A site in the instructions a fast tracepoint displaces would never be hit,
+// the trampoline runs copies of them. Writing its trap would also corrupt the
+// jump, and enabling the jump would overwrite its trap.
+static Status CheckFastTracepointRange(const BreakpointSiteList &site_list,
+                                       const BreakpointSite *bp_site,
+                                       addr_t bp_addr, size_t size) {
+  Status error;
+  if (BreakpointSiteSP other_sp =
+          FindOverlappingSite(site_list, bp_site, bp_addr, bp_addr + size))
+    error.SetErrorStringWithFormat(
+        "the %s at 0x%" PRIx64
+        " overlaps the instructions the fast tracepoint replaces",
+        other_sp->GetType() == BreakpointSite::eFastTrace ? "fast tracepoint"
+                                                           : "breakpoint",
+        other_sp->GetLoadAddress());
+  return error;
+}
+
+// The jump only replaces the first of the displaced instructions, the others
+// are filled with traps. Reject sites where code may start or continue at one
+// of the others: a symbol, a line table entry or the target of a branch in
+// the function.
+static Status CheckFastTracepointTargets(Process &process, addr_t bp_addr,
+                                         size_t size,
+                                         const AddressRange &func_range) {
+  Status error;
+  Target &target = process.GetTarget();
+  for (addr_t addr = bp_addr + 1; addr < bp_addr + size; ++addr) {
+    Address so_addr;
+    if (!target.ResolveLoadAddress(addr, so_addr))
+      continue;
+    SymbolContext sc;
+    so_addr.CalculateSymbolContext(&sc, eSymbolContextSymbol |
+                                            eSymbolContextLineEntry);
+    if (sc.symbol && sc.symbol->GetLoadAddress(&target) == addr) {
+      error.SetErrorStringWithFormat(
+          "the symbol %s at 0x%" PRIx64
+          " starts inside the instructions the fast tracepoint replaces",
+          sc.symbol->GetName().AsCString("<unknown>"), addr);
+      return error;
+    }
+    if (sc.line_entry.IsValid() &&
+        sc.line_entry.range.GetBaseAddress().GetLoadAddress(&target) == addr) {
+      error.SetErrorStringWithFormat(
+          "the line table entry at 0x%" PRIx64
+          " starts inside the instructions the fast tracepoint replaces",
+          addr);
+      return error;
+    }
+  }
+
+  if (!func_range.GetBaseAddress().IsValid())
+    return error;
+  ExecutionContext exe_ctx(&process);
+  DisassemblerSP disasm_sp = Disassembler::DisassembleRange(
+      target.GetArchitecture(), nullptr, nullptr, exe_ctx, func_range, true);
+  if (!disasm_sp)
+    return error;
+  const InstructionList &insts = disasm_sp->GetInstructionList();
+  for (size_t i = 0, e = insts.GetSize(); i < e; ++i) {
+    InstructionSP inst_sp = insts.GetInstructionAtIndex(i);
+    if (!inst_sp->DoesBranch())
+      continue;
+    // Direct branches have their target address as the only operand.
+    addr_t branch_target;
+    const char *operands = inst_sp->GetOperands(&exe_ctx);
+    if (!operands ||
+        llvm::StringRef(operands).trim().getAsInteger(0, branch_target))
+      continue;
+    if (branch_target > bp_addr && branch_target < bp_addr + size) {
+      error.SetErrorStringWithFormat(
+          "the branch at 0x%" PRIx64 " jumps into the instructions the fast "
+          "tracepoint replaces",
+          inst_sp->GetAddress().GetLoadAddress(&target));
+      return error;
+    }
+  }
+  return error;
+}
+
+Status Process::EnableFastTracepoint(BreakpointSite *bp_site) {
+  Status error;
+  assert(bp_site != nullptr);
+  Log *log(lldb_private::GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+  const addr_t bp_addr = bp_site->GetLoadAddress();
+  LLDB_LOGF(log,
+            "Process::EnableFastTracepoint (site_id = %d) addr = 0x%" PRIx64,
+            bp_site->GetID(), (uint64_t)bp_addr);
+  if (bp_site->IsEnabled())
+    return error;
+
+  // The trampoline of a disabled tracepoint is kept, just put the jump back.
+  BreakpointSite::FastTraceMemory &memory = bp_site->GetFastTraceMemory();
+  if (memory.addr != LLDB_INVALID_ADDRESS) {
+    const size_t size = bp_site->GetByteSize();
+    error = CheckFastTracepointRange(m_breakpoint_site_list, bp_site, bp_addr,
+                                     size);
+    if (error.Fail())
+      return error;
+    if (DoWriteMemory(bp_addr, bp_site->GetTrapOpcodeBytes(), size, error) ==
+        size)
+      bp_site->SetEnabled(true);
+    else if (error.Success())
+      error.SetErrorString("unable to write the fast tracepoint jump");
+    return error;
+  }
+
+  const ArchSpec &arch = GetTarget().GetArchitecture();
+  if (!FastTracepoint::IsSupported(arch)) {
+    error.SetErrorStringWithFormat(
+        "fast tracepoints are not supported for %s",
+        arch.GetArchitectureName());
+    return error;
+  }
+  if (GetPrivateState() != eStateStopped) {
+    error.SetErrorString(
+        "fast tracepoints can only be set while the process is stopped");
+    return error;
+  }
+
+  // Read the code at the site, but don't displace instructions past the end
+  // of the function.
+  uint8_t code[sizeof(bp_site->m_saved_opcode)];
+  size_t code_size =
+      std::min(FastTracepoint::GetMaxDisplacedSize(), sizeof(code));
+  Address so_addr;
+  AddressRange func_range;
+  if (GetTarget().ResolveLoadAddress(bp_addr, so_addr)) {
+    SymbolContext sc;
+    const SymbolContextItem scope =
+        eSymbolContextFunction | eSymbolContextSymbol;
+    so_addr.CalculateSymbolContext(&sc, scope);
+    if (sc.GetAddressRange(scope, 0, false, func_range)) {
+      addr_t end =
+          func_range.GetBaseAddress().GetLoadAddress(&GetTarget()) +
+          func_range.GetByteSize();
+      if (end > bp_addr)
+        code_size = std::min<size_t>(code_size, end - bp_addr);
+    }
+  }
+  // Read through the cache, which hides the traps of other sites, so that
+  // they are reported as overlapping instead of failing the decoding.
+  code_size = ReadMemory(bp_addr, code, code_size, error);
+  if (error.Fail())
+    return error;
+
+  llvm::Expected<size_t> displaced_size = FastTracepoint::GetDisplacedSize(
+      arch, bp_addr, llvm::makeArrayRef(code, code_size));
+  if (!displaced_size) {
+    error.SetErrorString(llvm::toString(displaced_size.takeError()));
+    return error;
+  }
+
+  error = CheckFastTracepointRange(m_breakpoint_site_list, bp_site, bp_addr,
+                                   *displaced_size);
+  if (error.Fail())
+    return error;
+
+  error = CheckFastTracepointTargets(*this, bp_addr, *displaced_size,
+                                     func_range);
+  if (error.Fail())
+    return error;
+
+  // A thread stopped in the middle of the displaced instructions would
+  // resume in the middle of the jump.
+  if (IsAnyThreadPCInRange(GetThreadList(), bp_addr + 1,
+                           bp_addr + *displaced_size)) {
+    error.SetErrorString("a thread is stopped inside the instructions the "
+                         "fast tracepoint replaces");
+    return error;
+  }
+
+  // The trampoline and the buffer share one allocation, the buffer starts on
+  // its own cache line.
+  llvm::ArrayRef<uint8_t> displaced(code, *displaced_size);
+  const size_t trampoline_size =
+      FastTracepoint::BuildTrampoline(bp_addr, bp_addr, bp_addr, displaced)
+          .size();
+  const size_t buffer_offset = llvm::alignTo(trampoline_size, 64);
+  const size_t alloc_size = buffer_offset + FastTracepoint::GetBufferSize();
+  addr_t alloc_addr = AllocateMemoryNear(
+      alloc_size,
+      ePermissionsReadable | ePermissionsWritable | ePermissionsExecutable,
+      bp_addr, FastTracepoint::GetMaxDistance(), error);
+  if (alloc_addr == LLDB_INVALID_ADDRESS) {
+    if (error.Success())
+      error.SetErrorString("unable to allocate the fast tracepoint buffer");
+    return error;
+  }
+
+  const addr_t buffer_addr = alloc_addr + buffer_offset;
+  std::vector<uint8_t> trampoline = FastTracepoint::BuildTrampoline(
+      bp_addr, alloc_addr, buffer_addr, displaced);
+  std::vector<uint8_t> header = FastTracepoint::BuildBufferHeader();
+  std::vector<uint8_t> jump =
+      FastTracepoint::BuildJump(bp_addr, *displaced_size, alloc_addr);
+  assert(trampoline.size() == trampoline_size);
+  assert(jump.size() == *displaced_size);
+
+  if (DoWriteMemory(alloc_addr, trampoline.data(), trampoline.size(), error) !=
+          trampoline.size() ||
+      DoWriteMemory(buffer_addr, header.data(), header.size(), error) !=
+          header.size()) {
+    if (error.Success())
+      error.SetErrorString("unable to write the fast tracepoint trampoline");
+    DoDeallocateMemory(alloc_addr);
+    return error;
+  }
+
+  ::memcpy(bp_site->GetSavedOpcodeBytes(), code, *displaced_size);
+  bp_site->SetTrapOpcode(jump.data(), jump.size());
+  if (DoWriteMemory(bp_addr, jump.data(), jump.size(), error) != jump.size()) {
+    if (error.Success())
+      error.SetErrorString("unable to write the fast tracepoint jump");
+    // Part of the jump may have made it, put the code back.
+    Status restore_error;
+    DoWriteMemory(bp_addr, code, *displaced_size, restore_error);
+    DoDeallocateMemory(alloc_addr);
+    return error;
+  }
+
+  memory.addr = alloc_addr;
+  memory.size = alloc_size;
+  memory.trampoline_size = trampoline_size;
+  memory.buffer_addr = buffer_addr;
+  bp_site->SetType(BreakpointSite::eFastTrace);
+  bp_site->SetEnabled(true);
+  LLDB_LOGF(log,
+            "Process::EnableFastTracepoint (site_id = %d) addr = 0x%" PRIx64
+            " -- SUCCESS, trampoline = 0x%" PRIx64 ", buffer = 0x%" PRIx64,
+            bp_site->GetID(), (uint64_t)bp_addr, alloc_addr, buffer_addr);
+  return error;
+}
+
+Status Process::DisableFastTracepoint(BreakpointSite *bp_site) {
+  Status error;
+  assert(bp_site != nullptr);
+  Log *log(lldb_private::GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+  const addr_t bp_addr = bp_site->GetLoadAddress();
+  LLDB_LOGF(log,
+            "Process::DisableFastTracepoint (site_id = %d) addr = 0x%" PRIx64,
+            bp_site->GetID(), (uint64_t)bp_addr);
+  if (!bp_site->IsEnabled())
+    return error;
+
+  const size_t size = bp_site->GetByteSize();
+  if (DoWriteMemory(bp_addr, bp_site->GetSavedOpcodeBytes(), size, error) !=
+      size) {
+    if (error.Success())
+      error.SetErrorString(
+          "Memory write failed when restoring original instructions.");
+    return error;
+  }
+  bp_site->SetEnabled(false);
+
+  // The trampoline can only be freed if no thread will return to it. A
+  // running thread may be in it, so keep it in that case. The buffer stays
+  // with it, so the hits can still be read until the site is removed.
+  BreakpointSite::FastTraceMemory &memory = bp_site->GetFastTraceMemory();
+  if (memory.addr == LLDB_INVALID_ADDRESS)
+    return error;
+  if (GetPrivateState() == eStateStopped &&
+      !IsAnyThreadPCInRange(GetThreadList(), memory.addr,
+                            memory.addr + memory.trampoline_size) &&
+      !bp_site->GetNumberOfOwners()) {
+    Status dealloc_error = DoDeallocateMemory(memory.addr);
+    LLDB_LOGF(log,
+              "Process::DisableFastTracepoint (site_id = %d) freed "
+              "0x%" PRIx64 ": %s",
+              bp_site->GetID(), memory.addr,
+              dealloc_error.AsCString("success"));
+    memory = BreakpointSite::FastTraceMemory();
+  } else {
+    LLDB_LOGF(log,
+              "Process::DisableFastTracepoint (site_id = %d) keeping "
+              "0x%" PRIx64,
+              bp_site->GetID(), memory.addr);
+  }
+  return error;
+}
+
 // Uncomment to verify memory caching works after making changes to caching
 // code
 //#define VERIFY_MEMORY_READS
@@ -2207,6 +2598,145 @@ size_t Process::ReadMemoryFromInferior(addr_t addr, void *buf, size_t size,
   return bytes_read;
 }
 
+void Process::DoReadMemoryRanges(llvm::ArrayRef<LoadRange> ranges,
+                                 uint8_t *buf,
+                                 llvm::MutableArrayRef<size_t> bytes_read) {
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    const size_t size = ranges[i].GetByteSize();
+    size_t &range_bytes_read = bytes_read[i];
+    Status error;
+    while (range_bytes_read < size) {
+      const size_t curr_size = size - range_bytes_read;
+      const size_t curr_bytes_read =
+          DoReadMemory(ranges[i].GetRangeBase() + range_bytes_read,
+                       buf + range_bytes_read, curr_size, error);
+      range_bytes_read += curr_bytes_read;
+      if (curr_bytes_read == curr_size || curr_bytes_read == 0)
+        break;
+    }
+    buf += size;
+  }
+}
+
+Process::UnwindStatistics Process::GetUnwindStatistics() {
+  std::lock_guard<std::mutex> guard(m_unwind_stats_mutex);
+  return m_unwind_stats;
+}
+
+void Process::AddUnwindStatistics(const UnwindStatistics &stats) {
+  std::lock_guard<std::mutex> guard(m_unwind_stats_mutex);
+  m_unwind_stats.frames_unwound += stats.frames_unwound;
+  m_unwind_stats.frames_matched += stats.frames_matched;
+  m_unwind_stats.frames_reused += stats.frames_reused;
+  m_unwind_stats.frames_rejected += stats.frames_rejected;
+  m_unwind_stats.symbol_contexts_reused += stats.symbol_contexts_reused;
+}
+
+void Process::UnwindThreads(llvm::ArrayRef<ThreadSP> threads,
+                            uint32_t max_frames,
+                            llvm::function_ref<bool(size_t)> callback) {
+  // Operating system plug-ins create the register contexts of their threads
+  // in Python, don't call into them from several threads at once.
+  if (threads.size() < 2 || !GetParallelUnwind() || GetOperatingSystem()) {
+    for (size_t i = 0; i < threads.size(); ++i)
+      if (!callback(i))
+        return;
+    return;
+  }
+
+  // Read the top of every stack with a single request. The first frames of
+  // all threads are then unwound from the memory cache instead of each
+  // thread sending its own reads.
+  const uint64_t prefetch_size = GetStackPrefetchSize();
+  if (prefetch_size > 0 && !GetDisableMemoryCache()) {
+    const addr_t line_size = m_memory_cache.GetMemoryCacheLineSize();
+    std::vector<LoadRange> ranges;
+    for (const ThreadSP &thread_sp : threads) {
+      if (!thread_sp)
+        continue;
+      RegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext();
+      const addr_t sp = reg_ctx_sp ? reg_ctx_sp->GetSP(LLDB_INVALID_ADDRESS)
+                                   : LLDB_INVALID_ADDRESS;
+      if (sp == LLDB_INVALID_ADDRESS)
+        continue;
+      const addr_t base = llvm::alignDown(sp, line_size);
+      ranges.emplace_back(base, llvm::alignTo(sp + prefetch_size, line_size) -
+                                    base);
+    }
+
+    // Merge the ranges of threads whose stacks are next to each other.
+    std::sort(ranges.begin(), ranges.end());
+    std::vector<LoadRange> merged;
+    size_t total_size = 0;
+    for (const LoadRange &range : ranges) {
+      if (!merged.empty() &&
+          range.GetRangeBase() <= merged.back().GetRangeEnd()) {
+        const addr_t end =
+            std::max(range.GetRangeEnd(), merged.back().GetRangeEnd());
+        total_size += end - merged.back().GetRangeEnd();
+        merged.back().SetRangeEnd(end);
+      } else {
+        merged.push_back(range);
+        total_size += range.GetByteSize();
+      }
+    }
+
+    std::vector<uint8_t> buffer(total_size);
+    std::vector<size_t> bytes_read;
+    ReadMemoryRanges(merged, buffer.data(), bytes_read);
+    const uint8_t *bytes = buffer.data();
+    for (size_t i = 0; i < merged.size(); ++i) {
+      m_memory_cache.AddL2CacheData(merged[i].GetRangeBase(), bytes,
+                                    bytes_read[i]);
+      bytes += merged[i].GetByteSize();
+    }
+  }
+
+  std::vector<std::future<void>> futures;
+  futures.reserve(threads.size());
+  for (const ThreadSP &thread_sp : threads) {
+    futures.push_back(TaskPool::AddTask([thread_sp, max_frames]() {
+      for (uint32_t idx = 0; thread_sp && idx < max_frames; ++idx) {
+        StackFrameSP frame_sp = thread_sp->GetStackFrameAtIndex(idx);
+        if (!frame_sp)
+          break;
+        frame_sp->GetSymbolContext(eSymbolContextEverything);
+      }
+    }));
+  }
+
+  // Hand out the threads in order while the later ones are still being
+  // unwound. The tasks must finish even if the callback stops early.
+  bool keep_going = true;
+  for (size_t i = 0; i < futures.size(); ++i) {
+    TaskPool::Wait(futures[i]);
+    if (keep_going)
+      keep_going = callback(i);
+  }
+}
+
+size_t Process::ReadMemoryRanges(llvm::ArrayRef<LoadRange> ranges, void *buf,
+                                 std::vector<size_t> &bytes_read) {
+  bytes_read.assign(ranges.size(), 0);
+  if (buf == nullptr || ranges.empty())
+    return 0;
+
+  uint8_t *bytes = static_cast<uint8_t *>(buf);
+  DoReadMemoryRanges(ranges, bytes, bytes_read);
+
+  // Replace any software breakpoint opcodes that fall into the ranges back
+  // into "buf" before we return
+  size_t total_bytes_read = 0;
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    if (bytes_read[i] > 0)
+      RemoveBreakpointOpcodesFromBuffer(ranges[i].GetRangeBase(),
+                                        bytes_read[i], bytes);
+    total_bytes_read += bytes_read[i];
+    bytes += ranges[i].GetByteSize();
+  }
+  return total_bytes_read;
+}
+
 uint64_t Process::ReadUnsignedIntegerFromMemory(lldb::addr_t vm_addr,
                                                 size_t integer_byte_size,
                                                 uint64_t fail_value,
@@ -2434,6 +2964,101 @@ addr_t Process::CallocateMemory(size_t size, uint32_t permissions,
   return return_addr;
 }
 
+addr_t Process::AllocateMemoryNear(size_t size, uint32_t permissions,
+                                   addr_t near_addr, addr_t max_distance,
+                                   Status &error) {
+  if (GetPrivateState() != eStateStopped) {
+    error.SetErrorToGenericError();
+    return LLDB_INVALID_ADDRESS;
+  }
+
+  Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
+  const addr_t page_mask = 0xfff;
+  const addr_t min_addr = 0x10000;
+  const size_t max_regions = 64;
+  const size_t max_attempts = 8;
+  size = (size + page_mask) & ~page_mask;
+
+  auto in_reach = [&](addr_t addr) {
+    addr_t low = std::min(addr, near_addr);
+    addr_t high = std::max(addr + size, near_addr);
+    return addr >= min_addr && high - low <= max_distance;
+  };
+
+  // Collect the closest address in each unmapped region the allocation fits
+  // in, looking up and down from near_addr.
+  std::vector<addr_t> hints;
+  MemoryRegionInfo region_info;
+  addr_t addr = near_addr;
+  for (size_t i = 0; i < max_regions; ++i) {
+    if (GetMemoryRegionInfo(addr, region_info).Fail())
+      break;
+    const auto &range = region_info.GetRange();
+    if (range.GetRangeEnd() <= addr)
+      break;
+    addr_t hint = (range.GetRangeBase() + page_mask) & ~page_mask;
+    if (region_info.GetMapped() == MemoryRegionInfo::eNo &&
+        hint + size <= range.GetRangeEnd()) {
+      if (!in_reach(hint))
+        break;
+      hints.push_back(hint);
+    }
+    addr = range.GetRangeEnd();
+  }
+  addr = near_addr;
+  for (size_t i = 0; i < max_regions; ++i) {
+    if (GetMemoryRegionInfo(addr, region_info).Fail())
+      break;
+    const auto &range = region_info.GetRange();
+    if (region_info.GetMapped() == MemoryRegionInfo::eNo &&
+        range.GetRangeEnd() >= size) {
+      addr_t hint = (range.GetRangeEnd() - size) & ~page_mask;
+      if (hint >= range.GetRangeBase() && hint < near_addr) {
+        if (!in_reach(hint))
+          break;
+        hints.push_back(hint);
+      }
+    }
+    if (range.GetRangeBase() == 0 || range.GetRangeBase() > addr)
+      break;
+    addr = range.GetRangeBase() - 1;
+  }
+
+  std::sort(hints.begin(), hints.end(), [near_addr](addr_t lhs, addr_t rhs) {
+    addr_t lhs_distance = lhs > near_addr ? lhs - near_addr : near_addr - lhs;
+    addr_t rhs_distance = rhs > near_addr ? rhs - near_addr : near_addr - rhs;
+    return lhs_distance < rhs_distance;
+  });
+  if (hints.size() > max_attempts)
+    hints.resize(max_attempts);
+
+  // An allocation at one hint can fail while another succeeds, for example
+  // if the inferior mapped something into the gap since it was found.
+  Status alloc_error;
+  for (addr_t hint : hints) {
+    alloc_error.Clear();
+    addr_t allocated_addr =
+        DoAllocateMemoryAt(size, permissions, hint, alloc_error);
+    LLDB_LOGF(log,
+              "Process::AllocateMemoryNear(size=%" PRIu64 ", near=0x%" PRIx64
+              ") hint 0x%" PRIx64 " => 0x%" PRIx64 ": %s",
+              (uint64_t)size, near_addr, hint, allocated_addr,
+              alloc_error.AsCString("success"));
+    if (alloc_error.Fail() || allocated_addr == LLDB_INVALID_ADDRESS)
+      continue;
+    if (in_reach(allocated_addr))
+      return allocated_addr;
+    DoDeallocateMemory(allocated_addr);
+  }
+
+  error.SetErrorStringWithFormat(
+      "unable to allocate %" PRIu64 " bytes within 0x%" PRIx64
+      " bytes of 0x%" PRIx64 "%s%s",
+      (uint64_t)size, max_distance, near_addr,
+      alloc_error.Fail() ? ": " : "", alloc_error.AsCString(""));
+  return LLDB_INVALID_ADDRESS;
+}
+
 bool Process::CanJIT() {
   if (m_can_jit == eCanJITDontKnow) {
     Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
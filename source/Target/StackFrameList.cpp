@@ -35,7 +35,8 @@ using namespace lldb_private;
 StackFrameList::StackFrameList(Thread &thread,
                                const lldb::StackFrameListSP &prev_frames_sp,
                                bool show_inline_frames)
-    : m_thread(thread), m_prev_frames_sp(prev_frames_sp), m_mutex(), m_frames(),
+    : m_thread(thread), m_prev_frames_sp(prev_frames_sp),
+      m_prev_concrete_frames(), m_mutex(), m_frames(),
       m_selected_frame_idx(0), m_concrete_frames_fetched(0),
       m_current_inlined_depth(UINT32_MAX),
       m_current_inlined_pc(LLDB_INVALID_ADDRESS),
@@ -413,6 +414,41 @@ void StackFrameList::SynthesizeTailCallFrames(StackFrame &next_frame) {
     next_frame.SetFrameIndex(m_frames.size());
 }
 
+const SymbolContext *
+StackFrameList::GetPreviousSymbolContext(addr_t cfa, addr_t pc,
+                                         bool behaves_like_zeroth_frame) {
+  if (!m_prev_frames_sp)
+    return nullptr;
+
+  if (m_prev_concrete_frames.empty()) {
+    // The first regular frame of each concrete frame index is the concrete
+    // one, the frames inlined into it follow. Frame zero was looked up with a
+    // pc that wasn't backed up, it never matches a caller frame.
+    uint32_t last_concrete_idx = 0;
+    for (const StackFrameSP &frame_sp : m_prev_frames_sp->m_frames) {
+      if (!frame_sp || frame_sp->IsHistorical() || frame_sp->IsArtificial())
+        continue;
+      const uint32_t concrete_idx = frame_sp->GetConcreteFrameIndex();
+      if (concrete_idx == last_concrete_idx)
+        continue;
+      last_concrete_idx = concrete_idx;
+      m_prev_concrete_frames.insert(
+          {{frame_sp->m_id.GetCallFrameAddress(), frame_sp->m_id.GetPC()},
+           frame_sp.get()});
+    }
+  }
+
+  auto pos = m_prev_concrete_frames.find({cfa, pc});
+  if (pos == m_prev_concrete_frames.end())
+    return nullptr;
+  StackFrame *prev_frame = pos->second;
+  if (prev_frame->m_behaves_like_zeroth_frame != behaves_like_zeroth_frame ||
+      prev_frame->m_flags.IsClear(eSymbolContextFunction |
+                                  eSymbolContextSymbol))
+    return nullptr;
+  return &prev_frame->m_sc;
+}
+
 void StackFrameList::GetFramesUpTo(uint32_t end_idx) {
   // Do not fetch frames for an invalid thread.
   if (!m_thread.IsValid())
@@ -449,6 +485,7 @@ void StackFrameList::GetFramesUpTo(uint32_t end_idx) {
   }
 
   StackFrameSP unwind_frame_sp;
+  uint64_t symbol_contexts_reused = 0;
   do {
     uint32_t idx = m_concrete_frames_fetched++;
     lldb::addr_t pc = LLDB_INVALID_ADDRESS;
@@ -491,9 +528,13 @@ void StackFrameList::GetFramesUpTo(uint32_t end_idx) {
         break;
       }
       const bool cfa_is_valid = true;
+      const SymbolContext *prev_sc =
+          GetPreviousSymbolContext(cfa, pc, behaves_like_zeroth_frame);
+      if (prev_sc)
+        ++symbol_contexts_reused;
       unwind_frame_sp = std::make_shared<StackFrame>(
           m_thread.shared_from_this(), m_frames.size(), idx, cfa, cfa_is_valid,
-          pc, StackFrame::Kind::Regular, behaves_like_zeroth_frame, nullptr);
+          pc, StackFrame::Kind::Regular, behaves_like_zeroth_frame, prev_sc);
 
       // Create synthetic tail call frames between the previous frame and the
       // newly-found frame. The new frame's index may change after this call,
@@ -548,6 +589,15 @@ void StackFrameList::GetFramesUpTo(uint32_t end_idx) {
     }
   } while (m_frames.size() - 1 < end_idx);
 
+  // Threads unwind concurrently, add the counter to the process once.
+  if (symbol_contexts_reused > 0) {
+    if (ProcessSP process_sp = m_thread.GetProcess()) {
+      Process::UnwindStatistics stats;
+      stats.symbol_contexts_reused = symbol_contexts_reused;
+      process_sp->AddUnwindStatistics(stats);
+    }
+  }
+
   // Don't try to merge till you've calculated all the frames in this stack.
   if (GetAllFramesFetched() && m_prev_frames_sp) {
     StackFrameList *prev_frames = m_prev_frames_sp.get();
@@ -604,6 +654,7 @@ void StackFrameList::GetFramesUpTo(uint32_t end_idx) {
 #endif
     }
     // We are done with the old stack frame list, we can release it now.
+    m_prev_concrete_frames.clear();
     m_prev_frames_sp.reset();
   }
 
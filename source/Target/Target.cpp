@@ -32,6 +32,7 @@
 #include "lldb/Expression/UserExpression.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/PosixApi.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
 #include "lldb/Interpreter/OptionGroupWatchpoint.h"
@@ -61,6 +62,7 @@
 #include "lldb/Utility/Timer.h"
 
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/SmallPtrSet.h"
 
 #include <memory>
 #include <mutex>
@@ -182,6 +184,7 @@ void Target::CleanupProcess() {
 void Target::DeleteCurrentProcess() {
   if (m_process_sp) {
     m_section_load_history.Clear();
+    ClearUserExpressionCache();
     if (m_process_sp->IsAlive())
       m_process_sp->Destroy(false);
 
@@ -1630,6 +1633,8 @@ void Target::ModulesDidLoad(ModuleList &module_list) {
     if (m_process_sp) {
       m_process_sp->ModulesDidLoad(module_list);
     }
+    // New modules can change how the names in cached expressions resolve.
+    ClearUserExpressionCache();
 
     // Notify all the ASTContext(s).
     auto notify_callback = [&](TypeSystem *type_system) {
@@ -1673,6 +1678,7 @@ void Target::SymbolsDidLoad(ModuleList &module_list) {
 void Target::ModulesDidUnload(ModuleList &module_list, bool delete_locations) {
   if (m_valid && module_list.GetSize()) {
     UnloadModuleSections(module_list);
+    ClearUserExpressionCache();
     m_breakpoint_list.UpdateBreakpoints(module_list, false, delete_locations);
     m_internal_breakpoint_list.UpdateBreakpoints(module_list, false,
                                                  delete_locations);
@@ -1983,9 +1989,11 @@ bool Target::ReadPointerFromMemory(const Address &addr, bool prefer_file_cache,
   return false;
 }
 
-ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
-                                   Status *error_ptr) {
+ModuleSP Target::FindOrCreateModule(const ModuleSpec &module_spec,
+                                    ModuleSP &old_module_sp, bool &is_new,
+                                    Status *error_ptr) {
   ModuleSP module_sp;
+  is_new = false;
 
   Status error;
 
@@ -1997,8 +2005,7 @@ ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
     module_sp = m_images.FindFirstModule(module_spec);
 
   if (!module_sp) {
-    ModuleSP old_module_sp; // This will get filled in if we have a new version
-                            // of the library
+    // old_module_sp will get filled in if we have a new version of the library
     bool did_create_module = false;
     FileSpecList search_paths = GetExecutableSearchPaths();
     // If there are image search path entries, try to use them first to acquire
@@ -2105,20 +2112,7 @@ ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
           }
         }
 
-        // Preload symbols outside of any lock, so hopefully we can do this for
-        // each library in parallel.
-        if (GetPreloadSymbols())
-          module_sp->PreloadSymbols();
-
-        if (old_module_sp && m_images.GetIndexForModule(old_module_sp.get()) !=
-                                 LLDB_INVALID_INDEX32) {
-          m_images.ReplaceModule(old_module_sp, module_sp);
-          Module *old_module_ptr = old_module_sp.get();
-          old_module_sp.reset();
-          ModuleList::RemoveSharedModuleIfOrphaned(old_module_ptr);
-        } else {
-          m_images.Append(module_sp, notify);
-        }
+        is_new = true;
       } else
         module_sp.reset();
     }
@@ -2128,6 +2122,69 @@ ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
   return module_sp;
 }
 
+void Target::AddNewModule(const ModuleSP &module_sp, ModuleSP old_module_sp,
+                          bool notify) {
+  if (old_module_sp && m_images.GetIndexForModule(old_module_sp.get()) !=
+                           LLDB_INVALID_INDEX32) {
+    m_images.ReplaceModule(old_module_sp, module_sp);
+    Module *old_module_ptr = old_module_sp.get();
+    old_module_sp.reset();
+    ModuleList::RemoveSharedModuleIfOrphaned(old_module_ptr);
+  } else {
+    m_images.Append(module_sp, notify);
+  }
+}
+
+ModuleSP Target::GetOrCreateModule(const ModuleSpec &module_spec, bool notify,
+                                   Status *error_ptr) {
+  ModuleSP old_module_sp;
+  bool is_new;
+  ModuleSP module_sp =
+      FindOrCreateModule(module_spec, old_module_sp, is_new, error_ptr);
+  if (!is_new)
+    return module_sp;
+
+  // Preload symbols outside of any lock.
+  if (GetPreloadSymbols())
+    module_sp->PreloadSymbols();
+
+  AddNewModule(module_sp, std::move(old_module_sp), notify);
+  return module_sp;
+}
+
+std::vector<ModuleSP>
+Target::GetOrCreateModules(llvm::ArrayRef<ModuleSpec> module_specs,
+                           bool notify) {
+  static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+  Timer scoped_timer(func_cat, "Target::GetOrCreateModules (%zu modules)",
+                     module_specs.size());
+
+  const size_t num_specs = module_specs.size();
+  std::vector<ModuleSP> modules(num_specs);
+  std::vector<ModuleSP> old_modules(num_specs);
+  std::vector<size_t> new_module_indexes;
+  llvm::SmallPtrSet<Module *, 32> new_modules;
+  for (size_t i = 0; i < num_specs; ++i) {
+    bool is_new;
+    modules[i] = FindOrCreateModule(module_specs[i], old_modules[i], is_new,
+                                    nullptr);
+    // The same module may be listed more than once, only add it once.
+    if (is_new && new_modules.insert(modules[i].get()).second)
+      new_module_indexes.push_back(i);
+  }
+
+  // Preload the symbols of all new modules in parallel. No lock other than
+  // each module's own is held while doing so.
+  if (GetPreloadSymbols())
+    TaskMapOverInt(0, new_module_indexes.size(), [&](size_t i) {
+      modules[new_module_indexes[i]]->PreloadSymbols();
+    });
+
+  for (size_t idx : new_module_indexes)
+    AddNewModule(modules[idx], std::move(old_modules[idx]), notify);
+  return modules;
+}
+
 TargetSP Target::CalculateTarget() { return shared_from_this(); }
 
 ProcessSP Target::CalculateProcess() { return m_process_sp; }
@@ -2346,6 +2403,40 @@ UserExpression *Target::GetUserExpressionForLanguage(
   return user_expr;
 }
 
+lldb::UserExpressionSP Target::GetCachedUserExpression(llvm::StringRef key) {
+  std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+  auto pos = m_user_expression_cache.find(key);
+  if (pos == m_user_expression_cache.end())
+    return nullptr;
+  m_user_expression_lru.splice(m_user_expression_lru.begin(),
+                               m_user_expression_lru, pos->second.lru_pos);
+  return pos->second.expr_sp;
+}
+
+void Target::CacheUserExpression(llvm::StringRef key,
+                                 const lldb::UserExpressionSP &expr_sp) {
+  const uint64_t max_size = GetExpressionCacheSize();
+  std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+  auto insert_result = m_user_expression_cache.try_emplace(key);
+  CachedUserExpression &entry = insert_result.first->second;
+  if (!insert_result.second)
+    m_user_expression_lru.erase(entry.lru_pos);
+  entry.expr_sp = expr_sp;
+  m_user_expression_lru.push_front(insert_result.first->first());
+  entry.lru_pos = m_user_expression_lru.begin();
+
+  while (m_user_expression_lru.size() > max_size) {
+    m_user_expression_cache.erase(m_user_expression_lru.back());
+    m_user_expression_lru.pop_back();
+  }
+}
+
+void Target::ClearUserExpressionCache() {
+  std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+  m_user_expression_lru.clear();
+  m_user_expression_cache.clear();
+}
+
 FunctionCaller *Target::GetFunctionCallerForLanguage(
     lldb::LanguageType language, const CompilerType &return_type,
     const Address &function_address, const ValueList &arg_value_list,
@@ -4124,6 +4215,12 @@ bool TargetProperties::GetEnableAutoApplyFixIts() const {
       nullptr, idx, g_target_properties[idx].default_uint_value != 0);
 }
 
+uint64_t TargetProperties::GetExpressionCacheSize() const {
+  const uint32_t idx = ePropertyExpressionCacheSize;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_target_properties[idx].default_uint_value);
+}
+
 bool TargetProperties::GetEnableNotifyAboutFixIts() const {
   const uint32_t idx = ePropertyNotifyAboutFixIts;
   return m_collection_sp->GetPropertyAtIndexAsBoolean(
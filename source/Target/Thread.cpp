@@ -607,7 +607,9 @@ void Thread::SetupForResume() {
       const addr_t thread_pc = reg_ctx_sp->GetPC();
       BreakpointSiteSP bp_site_sp =
           GetProcess()->GetBreakpointSiteList().FindByAddress(thread_pc);
-      if (bp_site_sp) {
+      // Fast tracepoints don't trap, the thread runs through them.
+      if (bp_site_sp && bp_site_sp->GetType() != BreakpointSite::eFastTrace &&
+          !GetProcess()->StepsOverBreakpointSite(*bp_site_sp)) {
         // Note, don't assume there's a ThreadPlanStepOverBreakpoint, the
         // target may not require anything special to step over a breakpoint.
 
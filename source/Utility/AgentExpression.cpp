@@ -0,0 +1,345 @@
+//===-- AgentExpression.cpp -------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Utility/AgentExpression.h"
+
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
+
+using namespace lldb_private;
+
+// Limits that keep a malformed or malicious expression from exhausting the
+// stub. Conditions the debugger generates are far below both.
+static const size_t k_max_stack_depth = 1024;
+static const size_t k_max_executed_ops = 100000;
+
+void AgentExpression::AppendConstant(uint64_t value) {
+  unsigned num_bytes;
+  if (value <= UINT8_MAX) {
+    AppendOpcode(eOpConst8);
+    num_bytes = 1;
+  } else if (value <= UINT16_MAX) {
+    AppendOpcode(eOpConst16);
+    num_bytes = 2;
+  } else if (value <= UINT32_MAX) {
+    AppendOpcode(eOpConst32);
+    num_bytes = 4;
+  } else {
+    AppendOpcode(eOpConst64);
+    num_bytes = 8;
+  }
+  // Operands are big-endian.
+  for (unsigned i = num_bytes; i > 0; --i)
+    m_bytecode.push_back(uint8_t(value >> ((i - 1) * 8)));
+}
+
+void AgentExpression::AppendRegister(uint32_t reg_num) {
+  AppendOpcode(eOpReg);
+  m_bytecode.push_back(uint8_t(reg_num >> 8));
+  m_bytecode.push_back(uint8_t(reg_num));
+}
+
+bool AgentExpression::AppendMemoryRead(uint32_t byte_size, bool is_signed) {
+  switch (byte_size) {
+  case 1:
+    AppendOpcode(eOpRef8);
+    break;
+  case 2:
+    AppendOpcode(eOpRef16);
+    break;
+  case 4:
+    AppendOpcode(eOpRef32);
+    break;
+  case 8:
+    AppendOpcode(eOpRef64);
+    return true;
+  default:
+    return false;
+  }
+  // The ref opcodes zero extend.
+  if (is_signed)
+    AppendExtend(byte_size * 8, true);
+  return true;
+}
+
+void AgentExpression::AppendExtend(uint8_t bits, bool is_signed) {
+  AppendOpcode(is_signed ? eOpExt : eOpZeroExt);
+  m_bytecode.push_back(bits);
+}
+
+static llvm::Error MakeError(const char *message, size_t pc) {
+  return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                 "agent expression at offset %zu: %s", pc,
+                                 message);
+}
+
+llvm::Expected<uint64_t>
+AgentExpression::Evaluate(ReadRegisterCallback read_register,
+                          ReadMemoryCallback read_memory) const {
+  std::vector<uint64_t> stack;
+  const size_t size = m_bytecode.size();
+  size_t pc = 0;
+
+  for (size_t num_ops = 0; num_ops < k_max_executed_ops; ++num_ops) {
+    if (pc >= size)
+      return MakeError("missing end opcode", pc);
+
+    const size_t op_pc = pc;
+    const uint8_t op = m_bytecode[pc++];
+
+    // Reads a big-endian operand of the current opcode.
+    auto read_operand = [&](unsigned num_bytes, uint64_t &value) {
+      if (size - pc < num_bytes)
+        return false;
+      value = 0;
+      for (unsigned i = 0; i < num_bytes; ++i)
+        value = (value << 8) | m_bytecode[pc++];
+      return true;
+    };
+
+    // Number of stack entries each opcode consumes.
+    size_t num_operands = 0;
+    switch (op) {
+    case eOpAdd:
+    case eOpSub:
+    case eOpMul:
+    case eOpDivSigned:
+    case eOpDivUnsigned:
+    case eOpRemSigned:
+    case eOpRemUnsigned:
+    case eOpLsh:
+    case eOpRshSigned:
+    case eOpRshUnsigned:
+    case eOpBitAnd:
+    case eOpBitOr:
+    case eOpBitXor:
+    case eOpEqual:
+    case eOpLessSigned:
+    case eOpLessUnsigned:
+    case eOpSwap:
+      num_operands = 2;
+      break;
+    case eOpRot:
+      num_operands = 3;
+      break;
+    case eOpLogNot:
+    case eOpBitNot:
+    case eOpExt:
+    case eOpZeroExt:
+    case eOpRef8:
+    case eOpRef16:
+    case eOpRef32:
+    case eOpRef64:
+    case eOpIfGoto:
+    case eOpEnd:
+    case eOpDup:
+    case eOpPop:
+      num_operands = 1;
+      break;
+    default:
+      break;
+    }
+    if (stack.size() < num_operands)
+      return MakeError("stack underflow", op_pc);
+    if (stack.size() >= k_max_stack_depth)
+      return MakeError("stack overflow", op_pc);
+
+    switch (op) {
+    case eOpAdd:
+    case eOpSub:
+    case eOpMul:
+    case eOpDivSigned:
+    case eOpDivUnsigned:
+    case eOpRemSigned:
+    case eOpRemUnsigned:
+    case eOpLsh:
+    case eOpRshSigned:
+    case eOpRshUnsigned:
+    case eOpBitAnd:
+    case eOpBitOr:
+    case eOpBitXor:
+    case eOpEqual:
+    case eOpLessSigned:
+    case eOpLessUnsigned: {
+      const uint64_t b = stack.back();
+      stack.pop_back();
+      const uint64_t a = stack.back();
+      uint64_t &result = stack.back();
+      switch (op) {
+      case eOpAdd:
+        result = a + b;
+        break;
+      case eOpSub:
+        result = a - b;
+        break;
+      case eOpMul:
+        result = a * b;
+        break;
+      case eOpDivSigned:
+      case eOpRemSigned:
+        if (b == 0)
+          return MakeError("division by zero", op_pc);
+        // INT64_MIN / -1 overflows.
+        if (int64_t(b) == -1)
+          result = op == eOpDivSigned ? 0 - a : 0;
+        else if (op == eOpDivSigned)
+          result = uint64_t(int64_t(a) / int64_t(b));
+        else
+          result = uint64_t(int64_t(a) % int64_t(b));
+        break;
+      case eOpDivUnsigned:
+      case eOpRemUnsigned:
+        if (b == 0)
+          return MakeError("division by zero", op_pc);
+        result = op == eOpDivUnsigned ? a / b : a % b;
+        break;
+      case eOpLsh:
+        result = b < 64 ? a << b : 0;
+        break;
+      case eOpRshSigned:
+        result = uint64_t(int64_t(a) >> (b < 64 ? b : 63));
+        break;
+      case eOpRshUnsigned:
+        result = b < 64 ? a >> b : 0;
+        break;
+      case eOpBitAnd:
+        result = a & b;
+        break;
+      case eOpBitOr:
+        result = a | b;
+        break;
+      case eOpBitXor:
+        result = a ^ b;
+        break;
+      case eOpEqual:
+        result = a == b;
+        break;
+      case eOpLessSigned:
+        result = int64_t(a) < int64_t(b);
+        break;
+      case eOpLessUnsigned:
+        result = a < b;
+        break;
+      }
+      break;
+    }
+
+    case eOpLogNot:
+      stack.back() = stack.back() == 0;
+      break;
+
+    case eOpBitNot:
+      stack.back() = ~stack.back();
+      break;
+
+    case eOpExt:
+    case eOpZeroExt: {
+      uint64_t bits;
+      if (!read_operand(1, bits))
+        return MakeError("truncated operand", op_pc);
+      if (bits == 0 || bits > 64)
+        return MakeError("invalid extension width", op_pc);
+      if (bits < 64) {
+        if (op == eOpExt)
+          stack.back() = uint64_t(llvm::SignExtend64(stack.back(), bits));
+        else
+          stack.back() &= llvm::maskTrailingOnes<uint64_t>(bits);
+      }
+      break;
+    }
+
+    case eOpRef8:
+    case eOpRef16:
+    case eOpRef32:
+    case eOpRef64: {
+      const uint32_t byte_size = 1u << (op - eOpRef8);
+      llvm::Expected<uint64_t> value = read_memory(stack.back(), byte_size);
+      if (!value)
+        return value.takeError();
+      stack.back() = *value;
+      break;
+    }
+
+    case eOpIfGoto:
+    case eOpGoto: {
+      uint64_t target;
+      if (!read_operand(2, target))
+        return MakeError("truncated operand", op_pc);
+      bool jump = true;
+      if (op == eOpIfGoto) {
+        jump = stack.back() != 0;
+        stack.pop_back();
+      }
+      if (jump)
+        pc = target;
+      break;
+    }
+
+    case eOpConst8:
+    case eOpConst16:
+    case eOpConst32:
+    case eOpConst64: {
+      uint64_t value;
+      if (!read_operand(1u << (op - eOpConst8), value))
+        return MakeError("truncated operand", op_pc);
+      stack.push_back(value);
+      break;
+    }
+
+    case eOpReg: {
+      uint64_t reg_num;
+      if (!read_operand(2, reg_num))
+        return MakeError("truncated operand", op_pc);
+      llvm::Expected<uint64_t> value = read_register(reg_num);
+      if (!value)
+        return value.takeError();
+      stack.push_back(*value);
+      break;
+    }
+
+    case eOpEnd:
+      return stack.back();
+
+    case eOpDup:
+      stack.push_back(stack.back());
+      break;
+
+    case eOpPop:
+      stack.pop_back();
+      break;
+
+    case eOpSwap:
+      std::swap(stack[stack.size() - 1], stack[stack.size() - 2]);
+      break;
+
+    case eOpPick: {
+      uint64_t index;
+      if (!read_operand(1, index))
+        return MakeError("truncated operand", op_pc);
+      if (index >= stack.size())
+        return MakeError("stack underflow", op_pc);
+      stack.push_back(stack[stack.size() - 1 - index]);
+      break;
+    }
+
+    case eOpRot: {
+      // a b c => c a b
+      const size_t n = stack.size();
+      std::rotate(stack.begin() + (n - 3), stack.begin() + (n - 1),
+                  stack.end());
+      break;
+    }
+
+    default:
+      return MakeError("unsupported opcode", op_pc);
+    }
+  }
+
+  return MakeError("too many operations executed", pc);
+}
@@ -20,6 +20,8 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <mutex>
 #include <utility>
 
 #include <inttypes.h>
@@ -28,6 +30,66 @@
 
 using namespace lldb_private;
 
+namespace {
+// The usage counters of the string pool. Every thread counts into its own
+// copy so that interning strings doesn't write to memory shared with other
+// threads. Only the owning thread writes a copy, readers add them all up.
+struct PoolCounters {
+  std::atomic<uint64_t> lookups{0};
+  std::atomic<uint64_t> insertions{0};
+  std::atomic<uint64_t> lock_acquisitions{0};
+  std::atomic<uint64_t> lock_contentions{0};
+
+  // There is a single writer, so this doesn't need an atomic add.
+  static void Add(std::atomic<uint64_t> &counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+  }
+
+  void AddTo(ConstString::PoolStatistics &stats) const {
+    stats.lookups += lookups.load(std::memory_order_relaxed);
+    stats.insertions += insertions.load(std::memory_order_relaxed);
+    stats.lock_acquisitions +=
+        lock_acquisitions.load(std::memory_order_relaxed);
+    stats.lock_contentions += lock_contentions.load(std::memory_order_relaxed);
+  }
+};
+
+// The counters of all live threads, and the sum of the counters of the
+// threads that exited. Leaked for the same reason as the pool below.
+struct PoolCountersRegistry {
+  std::mutex m_mutex;
+  std::vector<const PoolCounters *> m_live;
+  ConstString::PoolStatistics m_exited;
+
+  static PoolCountersRegistry &Get() {
+    static PoolCountersRegistry *g_registry = new PoolCountersRegistry();
+    return *g_registry;
+  }
+};
+
+struct ThreadPoolCounters : PoolCounters {
+  ThreadPoolCounters() {
+    PoolCountersRegistry &registry = PoolCountersRegistry::Get();
+    std::lock_guard<std::mutex> guard(registry.m_mutex);
+    registry.m_live.push_back(this);
+  }
+
+  ~ThreadPoolCounters() {
+    PoolCountersRegistry &registry = PoolCountersRegistry::Get();
+    std::lock_guard<std::mutex> guard(registry.m_mutex);
+    AddTo(registry.m_exited);
+    registry.m_live.erase(
+        std::find(registry.m_live.begin(), registry.m_live.end(), this));
+  }
+};
+} // namespace
+
+static PoolCounters &GetThreadPoolCounters() {
+  static thread_local ThreadPoolCounters g_counters;
+  return g_counters;
+}
+
 class Pool {
 public:
   typedef const char *StringPoolValueType;
@@ -73,25 +135,79 @@ public:
 
   const char *GetConstCStringWithStringRef(const llvm::StringRef &string_ref) {
     if (string_ref.data()) {
-      const uint8_t h = hash(string_ref);
+      PoolEntry &pool = m_string_pools[hash(string_ref)];
+      PoolCounters &counters = GetThreadPoolCounters();
+      PoolCounters::Add(counters.lookups, 1);
 
       {
-        llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-        auto it = m_string_pools[h].m_string_map.find(string_ref);
-        if (it != m_string_pools[h].m_string_map.end())
+        ShardUse use(pool, counters);
+        llvm::sys::SmartScopedReader<false> rlock(pool.m_mutex);
+        auto it = pool.m_string_map.find(string_ref);
+        if (it != pool.m_string_map.end())
           return it->getKeyData();
       }
 
-      llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
-      StringPoolEntryType &entry =
-          *m_string_pools[h]
-               .m_string_map.insert(std::make_pair(string_ref, nullptr))
-               .first;
-      return entry.getKeyData();
+      ShardUse use(pool, counters);
+      llvm::sys::SmartScopedWriter<false> wlock(pool.m_mutex);
+      auto result = pool.m_string_map.try_emplace(string_ref, nullptr);
+      if (result.second)
+        PoolCounters::Add(counters.insertions, 1);
+      return result.first->getKeyData();
     }
     return nullptr;
   }
 
+  void GetConstCStrings(llvm::ArrayRef<llvm::StringRef> strings,
+                        const char **results) {
+    // Sort the indexes of the strings by shard (counting sort, the shard is
+    // the key) so every shard is visited once.
+    std::vector<uint8_t> shards(strings.size());
+    std::array<uint32_t, 257> shard_begin{};
+    for (size_t i = 0; i < strings.size(); ++i) {
+      results[i] = nullptr;
+      if (!strings[i].data())
+        continue;
+      shards[i] = hash(strings[i]);
+      ++shard_begin[shards[i] + 1];
+    }
+    for (size_t h = 0; h < 256; ++h)
+      shard_begin[h + 1] += shard_begin[h];
+
+    std::vector<uint32_t> order(shard_begin[256]);
+    std::array<uint32_t, 256> next;
+    std::copy(shard_begin.begin(), shard_begin.end() - 1, next.begin());
+    for (size_t i = 0; i < strings.size(); ++i) {
+      if (strings[i].data())
+        order[next[shards[i]]++] = i;
+    }
+
+    PoolCounters &counters = GetThreadPoolCounters();
+    for (size_t h = 0; h < 256; ++h) {
+      const uint32_t begin = shard_begin[h];
+      const uint32_t end = shard_begin[h + 1];
+      if (begin == end)
+        continue;
+
+      // Batches mostly contain new strings while indexing, so go straight for
+      // the writer lock instead of trying a lookup under the reader lock
+      // first.
+      PoolEntry &pool = m_string_pools[h];
+      uint64_t insertions = 0;
+      {
+        ShardUse use(pool, counters);
+        llvm::sys::SmartScopedWriter<false> wlock(pool.m_mutex);
+        for (uint32_t i = begin; i < end; ++i) {
+          auto result = pool.m_string_map.try_emplace(strings[order[i]]);
+          if (result.second)
+            ++insertions;
+          results[order[i]] = result.first->getKeyData();
+        }
+      }
+      PoolCounters::Add(counters.lookups, end - begin);
+      PoolCounters::Add(counters.insertions, insertions);
+    }
+  }
+
   const char *
   GetConstCStringAndSetMangledCounterPart(llvm::StringRef demangled,
                                           const char *mangled_ccstr) {
@@ -144,6 +260,25 @@ public:
     return mem_size;
   }
 
+  ConstString::PoolStatistics GetStatistics() const {
+    ConstString::PoolStatistics stats;
+    stats.memory_size = MemorySize();
+    for (const auto &pool : m_string_pools) {
+      llvm::sys::SmartScopedReader<false> rlock(pool.m_mutex);
+      stats.num_strings += pool.m_string_map.size();
+    }
+
+    PoolCountersRegistry &registry = PoolCountersRegistry::Get();
+    std::lock_guard<std::mutex> guard(registry.m_mutex);
+    stats.lookups += registry.m_exited.lookups;
+    stats.insertions += registry.m_exited.insertions;
+    stats.lock_acquisitions += registry.m_exited.lock_acquisitions;
+    stats.lock_contentions += registry.m_exited.lock_contentions;
+    for (const PoolCounters *counters : registry.m_live)
+      counters->AddTo(stats);
+    return stats;
+  }
+
 protected:
   uint8_t hash(const llvm::StringRef &s) const {
     uint32_t h = llvm::djbHash(s);
@@ -153,6 +288,35 @@ protected:
   struct PoolEntry {
     mutable llvm::sys::SmartRWMutex<false> m_mutex;
     StringPool m_string_map;
+#ifdef LLDB_CONFIGURATION_DEBUG
+    // Number of threads currently waiting for or holding m_mutex to intern
+    // strings.
+    std::atomic<uint32_t> m_users{0};
+#endif
+  };
+
+  // Counts an acquisition of the lock of a shard. It must be created before
+  // the lock is taken so that threads waiting for the lock count as users.
+  // Telling whether other threads use the shard takes a counter that all of
+  // them write to, so contentions are only counted in debug builds.
+  class ShardUse {
+  public:
+    ShardUse(PoolEntry &pool, PoolCounters &counters) : m_pool(pool) {
+      PoolCounters::Add(counters.lock_acquisitions, 1);
+#ifdef LLDB_CONFIGURATION_DEBUG
+      if (m_pool.m_users.fetch_add(1, std::memory_order_relaxed) != 0)
+        PoolCounters::Add(counters.lock_contentions, 1);
+#endif
+    }
+
+    ~ShardUse() {
+#ifdef LLDB_CONFIGURATION_DEBUG
+      m_pool.m_users.fetch_sub(1, std::memory_order_relaxed);
+#endif
+    }
+
+  private:
+    LLVM_ATTRIBUTE_UNUSED PoolEntry &m_pool;
   };
 
   std::array<PoolEntry, 256> m_string_pools;
@@ -185,6 +349,22 @@ ConstString::ConstString(const char *cstr, size_t cstr_len)
 ConstString::ConstString(const llvm::StringRef &s)
     : m_string(StringPool().GetConstCStringWithStringRef(s)) {}
 
+std::vector<ConstString>
+ConstString::FromStrings(llvm::ArrayRef<llvm::StringRef> strings) {
+  std::vector<ConstString> result(strings.size());
+  std::vector<const char *> cstrs(strings.size());
+  StringPool().GetConstCStrings(strings, cstrs.data());
+  for (size_t i = 0; i < strings.size(); ++i)
+    result[i].m_string = cstrs[i];
+  return result;
+}
+
+std::vector<ConstString> ConstStringBatch::Flush() {
+  std::vector<ConstString> result = ConstString::FromStrings(m_strings);
+  m_strings.clear();
+  return result;
+}
+
 bool ConstString::operator<(ConstString rhs) const {
   if (m_string == rhs.m_string)
     return false;
@@ -305,6 +485,10 @@ size_t ConstString::StaticMemorySize() {
   return StringPool().MemorySize();
 }
 
+ConstString::PoolStatistics ConstString::GetPoolStatistics() {
+  return StringPool().GetStatistics();
+}
+
 void llvm::format_provider<ConstString>::format(const ConstString &CS,
                                                 llvm::raw_ostream &OS,
                                                 llvm::StringRef Options) {
@@ -0,0 +1,153 @@
+//===-- LZ4.cpp -------------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Utility/LZ4.h"
+
+#include "llvm/Support/Endian.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace lldb_private;
+
+// A block is a sequence of sequences. Each sequence starts with a token whose
+// upper four bits are the number of literals and lower four bits are the
+// length of the match minus four. A value of 15 is continued in the bytes
+// after the token, each byte adding its value until one is less than 255. The
+// literals follow, then the offset of the match as a little-endian 16-bit
+// value, then the continuation of the match length. The last sequence has
+// literals only.
+static const size_t k_min_match = 4;
+// The last match must start at least this many bytes before the end of the
+// block, and the last five bytes are always literals.
+static const size_t k_match_start_limit = 12;
+static const size_t k_last_literals = 5;
+static const size_t k_max_offset = 65535;
+static const unsigned k_hash_bits = 12;
+
+static void AppendLength(std::vector<uint8_t> &output, size_t length) {
+  for (; length >= 255; length -= 255)
+    output.push_back(255);
+  output.push_back(length);
+}
+
+static void AppendSequence(std::vector<uint8_t> &output,
+                           llvm::ArrayRef<uint8_t> literals,
+                           size_t match_offset, size_t match_length) {
+  const size_t literal_length = literals.size();
+  const size_t match_code = match_length ? match_length - k_min_match : 0;
+  output.push_back((std::min<size_t>(literal_length, 15) << 4) |
+                   std::min<size_t>(match_code, 15));
+  if (literal_length >= 15)
+    AppendLength(output, literal_length - 15);
+  output.insert(output.end(), literals.begin(), literals.end());
+  if (match_length == 0)
+    return;
+  output.push_back(match_offset & 0xff);
+  output.push_back(match_offset >> 8);
+  if (match_code >= 15)
+    AppendLength(output, match_code - 15);
+}
+
+void lz4::Compress(llvm::ArrayRef<uint8_t> input,
+                   std::vector<uint8_t> &output) {
+  const uint8_t *data = input.data();
+  const size_t size = input.size();
+  size_t anchor = 0;
+
+  if (size > k_match_start_limit) {
+    std::vector<uint32_t> table(1u << k_hash_bits, UINT32_MAX);
+    const size_t match_start_limit = size - k_match_start_limit;
+    const size_t match_end_limit = size - k_last_literals;
+    size_t pos = 0;
+    while (pos < match_start_limit) {
+      const uint32_t sequence = llvm::support::endian::read32le(data + pos);
+      const uint32_t hash = (sequence * 2654435761u) >> (32 - k_hash_bits);
+      const size_t candidate = table[hash];
+      table[hash] = pos;
+      if (candidate == UINT32_MAX || pos - candidate > k_max_offset ||
+          llvm::support::endian::read32le(data + candidate) != sequence) {
+        ++pos;
+        continue;
+      }
+
+      size_t length = k_min_match;
+      while (pos + length < match_end_limit &&
+             data[candidate + length] == data[pos + length])
+        ++length;
+      AppendSequence(output, input.slice(anchor, pos - anchor),
+                     pos - candidate, length);
+      pos += length;
+      anchor = pos;
+    }
+  }
+
+  AppendSequence(output, input.drop_front(anchor), 0, 0);
+}
+
+static bool ReadLength(llvm::ArrayRef<uint8_t> input, size_t &pos,
+                       size_t &length) {
+  uint8_t byte;
+  do {
+    if (pos >= input.size())
+      return false;
+    byte = input[pos++];
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+llvm::Expected<size_t> lz4::Decompress(llvm::ArrayRef<uint8_t> input,
+                                       llvm::MutableArrayRef<uint8_t> output) {
+  auto malformed = [] {
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "malformed LZ4 block");
+  };
+
+  size_t in_pos = 0;
+  size_t out_pos = 0;
+  while (in_pos < input.size()) {
+    const uint8_t token = input[in_pos++];
+
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 && !ReadLength(input, in_pos, literal_length))
+      return malformed();
+    if (literal_length > input.size() - in_pos ||
+        literal_length > output.size() - out_pos)
+      return malformed();
+    memcpy(output.data() + out_pos, input.data() + in_pos, literal_length);
+    in_pos += literal_length;
+    out_pos += literal_length;
+
+    // The last sequence has no match.
+    if (in_pos == input.size())
+      break;
+
+    if (input.size() - in_pos < 2)
+      return malformed();
+    const size_t offset = input[in_pos] | (input[in_pos + 1] << 8);
+    in_pos += 2;
+    if (offset == 0 || offset > out_pos)
+      return malformed();
+
+    size_t match_length = token & 15;
+    if (match_length == 15 && !ReadLength(input, in_pos, match_length))
+      return malformed();
+    match_length += k_min_match;
+    if (match_length > output.size() - out_pos)
+      return malformed();
+
+    // The match may overlap the bytes it produces, copy it byte by byte.
+    uint8_t *dst = output.data() + out_pos;
+    const uint8_t *src = dst - offset;
+    for (size_t i = 0; i < match_length; ++i)
+      dst[i] = src[i];
+    out_pos += match_length;
+  }
+  return out_pos;
+}
@@ -97,6 +97,13 @@ StringExtractorGDBRemote::GetServerPacketType() const {
         return eServerPacketType_QEnvironmentHexEncoded;
       if (PACKET_STARTS_WITH("QEnableErrorStrings"))
         return eServerPacketType_QEnableErrorStrings;
+      if (PACKET_STARTS_WITH("QEnableCompression:"))
+        return eServerPacketType_QEnableCompression;
+      break;
+
+    case 'N':
+      if (PACKET_STARTS_WITH("QNonStop:"))
+        return eServerPacketType_QNonStop;
       break;
 
     case 'P':
@@ -265,6 +272,8 @@ StringExtractorGDBRemote::GetServerPacketType() const {
         return eServerPacketType_qThreadExtraInfo;
       if (PACKET_STARTS_WITH("qThreadStopInfo"))
         return eServerPacketType_qThreadStopInfo;
+      if (PACKET_MATCHES("qThreadsInfoBinary"))
+        return eServerPacketType_qThreadsInfoBinary;
       break;
 
     case 'U':
@@ -348,6 +357,8 @@ StringExtractorGDBRemote::GetServerPacketType() const {
         return eServerPacketType_vCont;
       if (PACKET_MATCHES("vCont?"))
         return eServerPacketType_vCont_actions;
+      if (PACKET_MATCHES("vStopped"))
+        return eServerPacketType_vStopped;
     }
     break;
   case '_':
@@ -397,6 +408,8 @@ StringExtractorGDBRemote::GetServerPacketType() const {
     return eServerPacketType_m;
 
   case 'M':
+    if (PACKET_STARTS_WITH("MultiMemRead:"))
+      return eServerPacketType_MultiMemRead;
     return eServerPacketType_M;
 
   case 'p':
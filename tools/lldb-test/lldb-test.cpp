@@ -21,10 +21,14 @@
 #include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Symbol/ClangASTImporter.h"
 #include "lldb/Symbol/CompileUnit.h"
+#include "lldb/Symbol/DWARFCallFrameInfo.h"
+#include "lldb/Symbol/FuncUnwinders.h"
 #include "lldb/Symbol/LineTable.h"
 #include "lldb/Symbol/SymbolFile.h"
 #include "lldb/Symbol/TypeList.h"
 #include "lldb/Symbol/TypeMap.h"
+#include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Symbol/UnwindTable.h"
 #include "lldb/Symbol/VariableList.h"
 #include "lldb/Target/Language.h"
 #include "lldb/Target/Process.h"
@@ -33,6 +37,7 @@
 #include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/State.h"
 #include "lldb/Utility/StreamString.h"
+#include "lldb/Utility/Timer.h"
 
 #include "llvm/ADT/IntervalMap.h"
 #include "llvm/ADT/StringRef.h"
@@ -43,7 +48,11 @@
 #include "llvm/Support/PrettyStackTrace.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/WithColor.h"
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <map>
+#include <random>
 #include <thread>
 
 using namespace lldb;
@@ -57,12 +66,15 @@ cl::SubCommand ObjectFileSubcommand("object-file",
                                     "Display LLDB object file information");
 cl::SubCommand SymbolsSubcommand("symbols", "Dump symbols for an object file");
 cl::SubCommand IRMemoryMapSubcommand("ir-memory-map", "Test IRMemoryMap");
+cl::SubCommand UnwindSubcommand("unwind",
+                                "Benchmark unwind information lookups");
 
 cl::opt<std::string> Log("log", cl::desc("Path to a log file"), cl::init(""),
                          cl::sub(BreakpointSubcommand),
                          cl::sub(ObjectFileSubcommand),
                          cl::sub(SymbolsSubcommand),
-                         cl::sub(IRMemoryMapSubcommand));
+                         cl::sub(IRMemoryMapSubcommand),
+                         cl::sub(UnwindSubcommand));
 
 /// Create a target using the file pointed to by \p Filename, or abort.
 TargetSP createTarget(Debugger &Dbg, const std::string &Filename);
@@ -173,6 +185,12 @@ static cl::opt<bool> DumpAST("dump-ast",
 static cl::opt<bool> Verify("verify", cl::desc("Verify symbol information."),
                             cl::sub(SymbolsSubcommand));
 
+static cl::opt<bool> BenchmarkIndex(
+    "benchmark-index",
+    cl::desc("Build the symbol index and report the time spent in each "
+             "indexing stage."),
+    cl::sub(SymbolsSubcommand));
+
 static cl::opt<std::string> File("file",
                                  cl::desc("File (compile unit) to search."),
                                  cl::sub(SymbolsSubcommand));
@@ -189,6 +207,7 @@ static Error findVariables(lldb_private::Module &Module);
 static Error dumpModule(lldb_private::Module &Module);
 static Error dumpAST(lldb_private::Module &Module);
 static Error verify(lldb_private::Module &Module);
+static Error benchmarkIndex(lldb_private::Module &Module);
 
 static Expected<Error (*)(lldb_private::Module &)> getAction();
 static int dumpSymbols(Debugger &Dbg);
@@ -228,6 +247,31 @@ bool evalFree(StringRef Line, IRMemoryMapTestState &State);
 int evaluateMemoryMapCommands(Debugger &Dbg);
 } // namespace irmemorymap
 
+namespace unwind {
+static cl::opt<std::string> InputFile(cl::Positional, cl::desc("<input file>"),
+                                      cl::Required, cl::sub(UnwindSubcommand));
+static cl::opt<unsigned> Count("count",
+                               cl::desc("Number of addresses to look up."),
+                               cl::init(1000000), cl::sub(UnwindSubcommand));
+static cl::opt<unsigned> Seed("seed",
+                              cl::desc("Seed for the random addresses."),
+                              cl::init(0), cl::sub(UnwindSubcommand));
+static cl::opt<bool> Preload(
+    "preload",
+    cl::desc("Preload the module, including its unwind information, before "
+             "looking up the addresses."),
+    cl::sub(UnwindSubcommand));
+static cl::opt<bool> DumpRanges(
+    "dump-ranges",
+    cl::desc("Print the address ranges of the functions that were found and "
+             "check that the unwind info of each address covers it."),
+    cl::sub(UnwindSubcommand));
+
+static void collectCodeSections(const SectionList &List,
+                                std::vector<SectionSP> &Sections);
+static int benchmarkUnwind(Debugger &Dbg);
+} // namespace unwind
+
 } // namespace opts
 
 std::vector<CompilerContext> parseCompilerContext() {
@@ -658,7 +702,32 @@ Error opts::symbols::verify(lldb_private::Module &Module) {
   return Error::success();
 }
 
+Error opts::symbols::benchmarkIndex(lldb_private::Module &Module) {
+  SymbolFile *symfile = Module.GetSymbolFile();
+  if (!symfile)
+    return make_string_error("Module has no symbol file.");
+
+  Timer::ResetCategoryTimes();
+  auto start = std::chrono::steady_clock::now();
+  Module.PreloadSymbols();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  outs() << formatv("Indexed symbols in {0:f6} sec.\n", elapsed.count());
+  StreamString Stream;
+  Timer::DumpCategoryTimes(&Stream);
+  outs() << Stream.GetData();
+  return Error::success();
+}
+
 Expected<Error (*)(lldb_private::Module &)> opts::symbols::getAction() {
+  if (BenchmarkIndex) {
+    if (Verify || DumpAST || Find != FindType::None)
+      return make_string_error("Cannot benchmark the index while verifying, "
+                               "dumping AST or searching.");
+    return benchmarkIndex;
+  }
+
   if (Verify && DumpAST)
     return make_string_error(
         "Cannot both verify symbol information and dump AST.");
@@ -1019,6 +1088,109 @@ int opts::irmemorymap::evaluateMemoryMapCommands(Debugger &Dbg) {
   return 0;
 }
 
+void opts::unwind::collectCodeSections(const SectionList &List,
+                                        std::vector<SectionSP> &Sections) {
+  for (size_t I = 0; I < List.GetSize(); ++I) {
+    SectionSP S = List.GetSectionAtIndex(I);
+    if (S->GetType() == eSectionTypeCode && S->GetByteSize() > 0)
+      Sections.push_back(S);
+    collectCodeSections(S->GetChildren(), Sections);
+  }
+}
+
+int opts::unwind::benchmarkUnwind(Debugger &Dbg) {
+  auto ModulePtr =
+      std::make_shared<lldb_private::Module>(ModuleSpec(FileSpec(InputFile)));
+  SectionList *List = ModulePtr->GetSectionList();
+  std::vector<SectionSP> Sections;
+  if (List)
+    collectCodeSections(*List, Sections);
+  if (Sections.empty()) {
+    WithColor::error() << "Module has no code sections.\n";
+    return 1;
+  }
+
+  if (Preload) {
+    auto start = std::chrono::steady_clock::now();
+    ModulePtr->PreloadSymbols();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    outs() << formatv("Preloaded module in {0:f6} sec.\n", elapsed.count());
+  }
+
+  // Pick the addresses up front so that only the lookups are timed. Each code
+  // byte of the module is equally likely to be picked.
+  std::vector<addr_t> SectionEnds;
+  addr_t Total = 0;
+  for (const SectionSP &S : Sections)
+    SectionEnds.push_back(Total += S->GetByteSize());
+  std::mt19937_64 Generator(Seed);
+  std::uniform_int_distribution<addr_t> Distribution(0, Total - 1);
+  std::vector<Address> Addresses;
+  Addresses.reserve(Count);
+  for (unsigned I = 0; I < Count; ++I) {
+    addr_t Offset = Distribution(Generator);
+    size_t Index = std::upper_bound(SectionEnds.begin(), SectionEnds.end(),
+                                    Offset) -
+                   SectionEnds.begin();
+    addr_t SectionStart = Index == 0 ? 0 : SectionEnds[Index - 1];
+    Addresses.emplace_back(Sections[Index], Offset - SectionStart);
+  }
+
+  UnwindTable &Table = ModulePtr->GetUnwindTable();
+  DWARFCallFrameInfo *EHFrame = Table.GetEHFrameInfo();
+  size_t NumUnwinders = 0;
+  size_t NumEHFramePlans = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (const Address &Addr : Addresses) {
+    SymbolContext SC;
+    if (Table.GetFuncUnwindersContainingAddress(Addr, SC))
+      ++NumUnwinders;
+    UnwindPlan Plan(eRegisterKindGeneric);
+    if (EHFrame && EHFrame->GetUnwindPlan(Addr, Plan))
+      ++NumEHFramePlans;
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  outs() << formatv("Looked up {0} addresses in {1:f6} sec.\n",
+                    Addresses.size(), elapsed.count());
+  outs() << formatv("{0} addresses are in a function with unwind info.\n",
+                    NumUnwinders);
+  outs() << formatv("{0} addresses have an eh_frame unwind plan.\n",
+                    NumEHFramePlans);
+
+  if (!DumpRanges)
+    return 0;
+
+  // The unwind info of an address must describe the function the eh_frame
+  // puts the address in.
+  std::map<addr_t, addr_t> Ranges;
+  size_t NumMismatches = 0;
+  for (const Address &Addr : Addresses) {
+    SymbolContext SC;
+    FuncUnwindersSP Unwinders =
+        Table.GetFuncUnwindersContainingAddress(Addr, SC);
+    AddressRange Range;
+    if (!EHFrame || !EHFrame->GetAddressRange(Addr, Range)) {
+      if (Unwinders)
+        ++NumMismatches;
+      continue;
+    }
+    addr_t Start = Range.GetBaseAddress().GetFileAddress();
+    Ranges[Start] = Start + Range.GetByteSize();
+    if (!Unwinders || !Unwinders->ContainsAddress(Addr) ||
+        Unwinders->GetFunctionStartAddress().GetFileAddress() != Start)
+      ++NumMismatches;
+  }
+  outs() << formatv("{0} addresses have unwind info of another function.\n",
+                    NumMismatches);
+  for (const auto &Range : Ranges)
+    outs() << formatv("[{0:x}, {1:x}) {2} bytes\n", Range.first,
+                      Range.second, Range.second - Range.first);
+  return 0;
+}
+
 int main(int argc, const char *argv[]) {
   StringRef ToolName = argv[0];
   sys::PrintStackTraceOnErrorSignal(ToolName);
@@ -1055,6 +1227,8 @@ int main(int argc, const char *argv[]) {
     return opts::symbols::dumpSymbols(*Dbg);
   if (opts::IRMemoryMapSubcommand)
     return opts::irmemorymap::evaluateMemoryMapCommands(*Dbg);
+  if (opts::UnwindSubcommand)
+    return opts::unwind::benchmarkUnwind(*Dbg);
 
   WithColor::error() << "No command specified.\n";
   return 1;
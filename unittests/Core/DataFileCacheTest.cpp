@@ -0,0 +1,104 @@
+//===-- DataFileCacheTest.cpp -----------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/DataFileCache.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Utility/DataBuffer.h"
+
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Testing/Support/Error.h"
+
+#include "gtest/gtest.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+class DataFileCacheTest : public testing::Test {
+public:
+  void SetUp() override {
+    FileSystem::Initialize();
+    ASSERT_FALSE(
+        llvm::sys::fs::createUniqueDirectory("DataFileCacheTest", m_dir));
+  }
+
+  void TearDown() override {
+    llvm::sys::fs::remove_directories(m_dir);
+    FileSystem::Terminate();
+  }
+
+protected:
+  llvm::SmallString<128> m_dir;
+};
+} // namespace
+
+static llvm::StringRef GetString(const DataBufferSP &buffer_sp) {
+  return llvm::StringRef(reinterpret_cast<const char *>(buffer_sp->GetBytes()),
+                         buffer_sp->GetByteSize());
+}
+
+TEST_F(DataFileCacheTest, SetAndGet) {
+  DataFileCache cache(FileSpec(m_dir), ".test", 0);
+  EXPECT_FALSE(cache.GetCachedData("key"));
+  EXPECT_FALSE(cache.GetCacheFile(""));
+  EXPECT_FALSE(cache.SetCachedData("", "data"));
+
+  EXPECT_TRUE(cache.SetCachedData("key", "data"));
+  DataBufferSP buffer_sp = cache.GetCachedData("key");
+  ASSERT_TRUE(buffer_sp);
+  EXPECT_EQ("data", GetString(buffer_sp));
+
+  EXPECT_TRUE(cache.SetCachedData("key", "new data"));
+  buffer_sp = cache.GetCachedData("key");
+  ASSERT_TRUE(buffer_sp);
+  EXPECT_EQ("new data", GetString(buffer_sp));
+}
+
+TEST_F(DataFileCacheTest, Prune) {
+  // Room for two files of four bytes each.
+  DataFileCache cache(FileSpec(m_dir), ".test", 8);
+  ASSERT_TRUE(cache.SetCachedData("first", "1111"));
+  ASSERT_TRUE(cache.SetCachedData("second", "2222"));
+  EXPECT_TRUE(cache.GetCachedData("first"));
+  EXPECT_TRUE(cache.GetCachedData("second"));
+
+  // Make the first file the oldest one, regardless of timestamp granularity.
+  int fd;
+  ASSERT_FALSE(llvm::sys::fs::openFileForWrite(
+      cache.GetCacheFile("first").GetPath(), fd,
+      llvm::sys::fs::CD_OpenExisting));
+  EXPECT_FALSE(llvm::sys::fs::setLastAccessAndModificationTime(
+      fd, llvm::sys::TimePoint<>()));
+  llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+
+  ASSERT_TRUE(cache.SetCachedData("third", "3333"));
+  EXPECT_FALSE(cache.GetCachedData("first"));
+  EXPECT_TRUE(cache.GetCachedData("second"));
+  EXPECT_TRUE(cache.GetCachedData("third"));
+}
+
+TEST(ConstStringTableTest, RoundTrip) {
+  ConstStringTable table;
+  const uint32_t foo = table.Add(ConstString("foo"));
+  const uint32_t empty = table.Add(ConstString(""));
+  const uint32_t bar = table.Add(ConstString("bar"));
+  EXPECT_EQ(foo, table.Add(ConstString("foo")));
+  EXPECT_NE(foo, bar);
+
+  ConstStringTableReader reader(table.GetData());
+  ConstString s;
+  ASSERT_TRUE(reader.GetString(foo, s));
+  EXPECT_EQ(ConstString("foo"), s);
+  ASSERT_TRUE(reader.GetString(empty, s));
+  EXPECT_EQ(ConstString(""), s);
+  ASSERT_TRUE(reader.GetString(bar, s));
+  EXPECT_EQ(ConstString("bar"), s);
+  EXPECT_FALSE(reader.GetString(foo + 1, s));
+  EXPECT_FALSE(reader.GetString(table.GetData().size(), s));
+}
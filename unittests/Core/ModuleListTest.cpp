@@ -0,0 +1,180 @@
+//===-- ModuleListTest.cpp --------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleSpec.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Host/TaskPool.h"
+#include "lldb/Utility/ArchSpec.h"
+
+#include "gtest/gtest.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+class ModuleListTest : public testing::Test {
+public:
+  void SetUp() override { FileSystem::Initialize(); }
+  void TearDown() override { FileSystem::Terminate(); }
+
+protected:
+  static ModuleSP CreateModule(llvm::StringRef path) {
+    return std::make_shared<Module>(FileSpec(path),
+                                    ArchSpec("x86_64-pc-linux"));
+  }
+
+  static size_t FindModules(const ModuleList &list, const FileSpec &file,
+                            ModuleList &matches) {
+    matches.Clear();
+    return list.FindModules(ModuleSpec(file), matches);
+  }
+};
+} // namespace
+
+TEST_F(ModuleListTest, FindModulesByPath) {
+  ModuleSP foo_sp = CreateModule("/usr/lib/libfoo.so");
+  ModuleSP other_foo_sp = CreateModule("/opt/lib/libfoo.so");
+  ModuleSP bar_sp = CreateModule("/usr/lib/libbar.so");
+
+  ModuleList list;
+  list.Append(foo_sp);
+  list.Append(other_foo_sp);
+  list.Append(bar_sp);
+
+  ModuleList matches;
+  ASSERT_EQ(2u, FindModules(list, FileSpec("libfoo.so"), matches));
+  EXPECT_EQ(foo_sp, matches.GetModuleAtIndex(0));
+  EXPECT_EQ(other_foo_sp, matches.GetModuleAtIndex(1));
+
+  ASSERT_EQ(1u, FindModules(list, FileSpec("/opt/lib/libfoo.so"), matches));
+  EXPECT_EQ(other_foo_sp, matches.GetModuleAtIndex(0));
+
+  EXPECT_EQ(0u, FindModules(list, FileSpec("/lib/libfoo.so"), matches));
+  EXPECT_EQ(0u, FindModules(list, FileSpec("libbaz.so"), matches));
+
+  EXPECT_EQ(bar_sp, list.FindModule(bar_sp.get()));
+  EXPECT_FALSE(list.AppendIfNeeded(bar_sp));
+  EXPECT_EQ(3u, list.GetSize());
+}
+
+TEST_F(ModuleListTest, IndexesFollowChanges) {
+  ModuleSP foo_sp = CreateModule("/usr/lib/libfoo.so");
+  ModuleSP bar_sp = CreateModule("/usr/lib/libbar.so");
+
+  ModuleList list;
+  list.Append(foo_sp);
+  list.Append(bar_sp);
+
+  ModuleList matches;
+  foo_sp->SetPlatformFileSpec(FileSpec("/remote/lib/libfoo.so.1"));
+  ASSERT_EQ(1u, FindModules(list, FileSpec("/remote/lib/libfoo.so.1"),
+                            matches));
+  EXPECT_EQ(foo_sp, matches.GetModuleAtIndex(0));
+
+  ModuleSP new_foo_sp = CreateModule("/usr/lib/libfoo.so");
+  EXPECT_TRUE(list.ReplaceModule(foo_sp, new_foo_sp));
+  ASSERT_EQ(1u, FindModules(list, FileSpec("/usr/lib/libfoo.so"), matches));
+  EXPECT_EQ(new_foo_sp, matches.GetModuleAtIndex(0));
+  EXPECT_EQ(0u, FindModules(list, FileSpec("libfoo.so.1"), matches));
+  EXPECT_EQ(nullptr, list.FindModule(foo_sp.get()));
+
+  ModuleList copy(list);
+  EXPECT_TRUE(list.Remove(bar_sp));
+  EXPECT_EQ(0u, FindModules(list, FileSpec("libbar.so"), matches));
+  EXPECT_EQ(1u, FindModules(copy, FileSpec("libbar.so"), matches));
+
+  list.Clear();
+  EXPECT_EQ(0u, FindModules(list, FileSpec("libfoo.so"), matches));
+}
+
+TEST_F(ModuleListTest, ChangesReachEveryListOfTheModule) {
+  ModuleSP foo_sp = CreateModule("/usr/lib/libfoo.so");
+  ModuleSP bar_sp = CreateModule("/usr/lib/libbar.so");
+
+  ModuleList first;
+  first.Append(foo_sp);
+  first.Append(bar_sp);
+  ModuleList second;
+  second.Append(foo_sp);
+
+  ModuleList matches;
+  foo_sp->SetFileSpecAndObjectName(FileSpec("/usr/lib/libfoo.so.2"),
+                                   ConstString());
+  EXPECT_EQ(1u, FindModules(first, FileSpec("libfoo.so.2"), matches));
+  EXPECT_EQ(1u, FindModules(second, FileSpec("libfoo.so.2"), matches));
+  EXPECT_EQ(0u, FindModules(second, FileSpec("libfoo.so"), matches));
+
+  // A list that dropped the module or was destroyed must not be told about
+  // later changes.
+  EXPECT_TRUE(second.Remove(foo_sp));
+  {
+    ModuleList temporary;
+    temporary.Append(bar_sp);
+  }
+  bar_sp->SetPlatformFileSpec(FileSpec("/remote/lib/libbar.so.1"));
+  foo_sp->SetPlatformFileSpec(FileSpec("/remote/lib/libfoo.so.1"));
+  EXPECT_EQ(0u, FindModules(second, FileSpec("libfoo.so.1"), matches));
+  EXPECT_EQ(1u, FindModules(first, FileSpec("libfoo.so.1"), matches));
+  EXPECT_EQ(1u, FindModules(first, FileSpec("libbar.so.1"), matches));
+}
+
+TEST_F(ModuleListTest, DuplicateModules) {
+  ModuleSP foo_sp = CreateModule("/usr/lib/libfoo.so");
+  ModuleSP bar_sp = CreateModule("/usr/lib/libbar.so");
+
+  ModuleList list;
+  list.Append(foo_sp);
+  list.Append(bar_sp);
+  list.Append(foo_sp);
+
+  ModuleList matches;
+  EXPECT_EQ(2u, FindModules(list, FileSpec("libfoo.so"), matches));
+
+  // Removing one copy must keep the other one indexed.
+  EXPECT_TRUE(list.Remove(foo_sp));
+  EXPECT_EQ(2u, list.GetSize());
+  ASSERT_EQ(1u, FindModules(list, FileSpec("libfoo.so"), matches));
+  EXPECT_EQ(foo_sp, matches.GetModuleAtIndex(0));
+  EXPECT_EQ(foo_sp, list.FindModule(foo_sp.get()));
+  EXPECT_FALSE(list.AppendIfNeeded(foo_sp));
+
+  // The remaining copy comes after bar now.
+  foo_sp->SetPlatformFileSpec(FileSpec("/remote/lib/libfoo.so.1"));
+  bar_sp->SetPlatformFileSpec(FileSpec("/remote/lib/libfoo.so.1"));
+  ASSERT_EQ(2u, FindModules(list, FileSpec("/remote/lib/libfoo.so.1"),
+                            matches));
+  EXPECT_EQ(bar_sp, matches.GetModuleAtIndex(0));
+  EXPECT_EQ(foo_sp, matches.GetModuleAtIndex(1));
+
+  EXPECT_TRUE(list.Remove(foo_sp));
+  ASSERT_EQ(1u, FindModules(list, FileSpec("/remote/lib/libfoo.so.1"),
+                            matches));
+  EXPECT_EQ(bar_sp, matches.GetModuleAtIndex(0));
+  EXPECT_EQ(nullptr, list.FindModule(foo_sp.get()));
+  EXPECT_FALSE(list.Remove(foo_sp));
+}
+
+TEST_F(ModuleListTest, TaskPoolThreadCountSetting) {
+  ModuleListProperties &properties =
+      ModuleList::GetGlobalModuleListProperties();
+  ASSERT_TRUE(properties
+                  .SetPropertyValue(nullptr, eVarSetOperationAssign,
+                                    "task-pool-thread-count", "3")
+                  .Success());
+  EXPECT_EQ(3u, properties.GetTaskPoolThreadCount());
+  EXPECT_EQ(3u, TaskPool::GetMaxThreadCount());
+
+  // Zero goes back to one thread per hardware thread.
+  ASSERT_TRUE(properties
+                  .SetPropertyValue(nullptr, eVarSetOperationAssign,
+                                    "task-pool-thread-count", "0")
+                  .Success());
+  EXPECT_EQ(GetHardwareConcurrencyHint(), TaskPool::GetMaxThreadCount());
+}
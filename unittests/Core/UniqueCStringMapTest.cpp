@@ -51,3 +51,31 @@ TEST(UniqueCStringMap, NoDefaultConstructor) {
   EXPECT_THAT(Map.GetValues(Bar, Values), 0);
   EXPECT_THAT(Values, testing::IsEmpty());
 }
+
+TEST(UniqueCStringMap, AppendSorted) {
+  using MapT = UniqueCStringMap<NoDefault>;
+
+  MapT Lhs, Rhs;
+  ConstString Foo("foo"), Bar("bar"), Baz("baz");
+
+  Lhs.Append(Foo, NoDefault(1));
+  Lhs.Append(Bar, NoDefault(2));
+  Lhs.Sort();
+  Rhs.Append(Baz, NoDefault(3));
+  Rhs.Append(Foo, NoDefault(4));
+  Rhs.Sort();
+
+  Lhs.AppendSorted(Rhs);
+  EXPECT_THAT(Lhs.GetSize(), 4u);
+  for (size_t i = 1; i < Lhs.GetSize(); ++i)
+    EXPECT_LE(uintptr_t(Lhs.GetCStringAtIndex(i - 1).GetCString()),
+              uintptr_t(Lhs.GetCStringAtIndex(i).GetCString()));
+
+  std::vector<NoDefault> Values;
+  EXPECT_THAT(Lhs.GetValues(Foo, Values), 2);
+  EXPECT_THAT(Values,
+              testing::UnorderedElementsAre(NoDefault(1), NoDefault(4)));
+  Values.clear();
+  EXPECT_THAT(Lhs.GetValues(Baz, Values), 1);
+  EXPECT_THAT(Values, testing::ElementsAre(NoDefault(3)));
+}
@@ -0,0 +1,202 @@
+//===-- RegexLiteralFilterTest.cpp ------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/DataFormatters/FormatClasses.h"
+#include "lldb/Utility/RegularExpression.h"
+
+#include "gtest/gtest.h"
+
+using namespace lldb_private;
+
+namespace {
+// A selection of the type names the formatters of the C++ standard libraries
+// are tried on.
+const char *const g_type_names[] = {
+    "int",
+    "std::vector<int>",
+    "std::vector<int, std::allocator<int> >",
+    "std::vector<int, std::allocator<int> > &",
+    "std::vector<int, std::allocator<int> >&",
+    "std::__1::vector<int, std::__1::allocator<int> >",
+    "std::__1::vector<int, std::__1::allocator<int> > &",
+    "std::__ndk1::vector<bool, std::__ndk1::allocator<bool> >",
+    "std::__1::map<int, int, std::__1::less<int>, "
+    "std::__1::allocator<std::__1::pair<const int, int> > >",
+    "std::map<int, int, std::less<int>, "
+    "std::allocator<std::pair<const int, int> > >",
+    "std::__1::unordered_map<int, int, std::__1::hash<int> >",
+    "std::__1::unordered_multiset<int, std::__1::hash<int> >",
+    "std::__1::tuple<>",
+    "std::__1::tuple<int, char>",
+    "std::__1::shared_ptr<int>",
+    "std::__1::weak_ptr<int> &",
+    "std::__1::__wrap_iter<int *>",
+    "std::list<int>",
+    "std::__cxx11::list<int, std::allocator<int> >",
+    "std::__cxx11::list<int, std::allocator<int> > &",
+    "std::unique_ptr<int, std::default_delete<int> >",
+    "std::initializer_list<int>",
+    "__gnu_cxx::__normal_iterator<int *, std::vector<int> >",
+    "std::_Rb_tree_iterator<std::pair<const int, int> >",
+    "my::std::__1::vector<int>",
+    "vector<int>",
+    "std::__1::vector",
+};
+
+/// Check that the filter never rules out a name the regex matches, and
+/// return how many names it ruled out.
+size_t CountRejected(llvm::StringRef regex) {
+  RegularExpression compiled(regex);
+  EXPECT_TRUE(compiled.IsValid()) << regex.str();
+  RegexLiteralFilter filter(regex);
+  size_t rejected = 0;
+  for (const char *name : g_type_names) {
+    if (compiled.Execute(name))
+      EXPECT_TRUE(filter.MayMatch(name)) << regex.str() << " on " << name;
+    else if (!filter.MayMatch(name))
+      ++rejected;
+  }
+  return rejected;
+}
+} // namespace
+
+TEST(RegexLiteralFilterTest, LibcxxRegexes) {
+  const char *const regexes[] = {
+      "^std::__[[:alnum:]]+::string$",
+      "^std::__[[:alnum:]]+::bitset<.+>(( )?&)?$",
+      "^std::__[[:alnum:]]+::vector<.+>(( )?&)?$",
+      "^std::__[[:alnum:]]+::map<.+> >(( )?&)?$",
+      "^(std::__[[:alnum:]]+::)unordered_(multi)?(map|set)<.+> >$",
+      "^std::__[[:alnum:]]+::tuple<.*>(( )?&)?$",
+      "^(std::__[[:alnum:]]+::)shared_ptr<.+>(( )?&)?$",
+      "^std::__[[:alnum:]]+::weak_ptr<.+>(( )?&)?$",
+      "^std::__[[:alnum:]]+::__wrap_iter<.+>$",
+      "^std::initializer_list<.+>(( )?&)?$",
+  };
+  for (const char *regex : regexes)
+    EXPECT_GT(CountRejected(regex), 0u) << regex;
+
+  RegexLiteralFilter vector("^std::__[[:alnum:]]+::vector<.+>(( )?&)?$");
+  EXPECT_TRUE(vector.MayMatch("std::__1::vector<int>"));
+  EXPECT_FALSE(vector.MayMatch("std::vector<int>"));
+  EXPECT_FALSE(vector.MayMatch("my::std::__1::vector<int>"));
+  EXPECT_FALSE(vector.MayMatch("std::__1::map<int, int>"));
+}
+
+TEST(RegexLiteralFilterTest, LibstdcxxRegexes) {
+  const char *const regexes[] = {
+      "^std::vector<.+>(( )?&)?$",
+      "^std::map<.+> >(( )?&)?$",
+      "^std::(__cxx11::)?list<.+>(( )?&)?$",
+      "^__gnu_cxx::__normal_iterator<.+>$",
+      "^std::_Rb_tree_iterator<.+>$",
+      "^std::unique_ptr<.+>(( )?&)?$",
+      "^std::tuple<.+>(( )?&)?$",
+  };
+  for (const char *regex : regexes)
+    EXPECT_GT(CountRejected(regex), 0u) << regex;
+
+  // The optional group leaves a literal on each side of it.
+  RegexLiteralFilter list("^std::(__cxx11::)?list<.+>(( )?&)?$");
+  EXPECT_TRUE(list.MayMatch("std::list<int>"));
+  EXPECT_TRUE(list.MayMatch("std::__cxx11::list<int>"));
+  EXPECT_FALSE(list.MayMatch("std::vector<int>"));
+  EXPECT_FALSE(list.MayMatch("list<int>"));
+}
+
+TEST(RegexLiteralFilterTest, Anchors) {
+  RegexLiteralFilter anchored("^std::");
+  EXPECT_TRUE(anchored.MayMatch("std::string"));
+  EXPECT_FALSE(anchored.MayMatch("my::std::string"));
+
+  // Only the start is checked, a name that goes on past '$' may still match
+  // as far as the filter is concerned.
+  RegexLiteralFilter at_end("string$");
+  EXPECT_TRUE(at_end.MayMatch("std::string"));
+  EXPECT_TRUE(at_end.MayMatch("std::string_view"));
+  EXPECT_FALSE(at_end.MayMatch("std::vector"));
+
+  // A literal after the first one isn't anchored.
+  RegexLiteralFilter later("^a.b");
+  EXPECT_TRUE(later.MayMatch("axxb"));
+  EXPECT_FALSE(later.MayMatch("xab"));
+
+  // Nothing is required by an anchor on its own.
+  EXPECT_TRUE(RegexLiteralFilter("^").MayMatch(""));
+  EXPECT_TRUE(RegexLiteralFilter("^$").MayMatch("anything"));
+}
+
+TEST(RegexLiteralFilterTest, Quantifiers) {
+  // The quantified character isn't required, the rest of the literal is.
+  for (const char *regex : {"ab*c", "ab+c", "ab?c", "ab{2,3}c"}) {
+    RegexLiteralFilter filter(regex);
+    EXPECT_TRUE(filter.MayMatch("ac")) << regex;
+    EXPECT_TRUE(filter.MayMatch("abbc")) << regex;
+    EXPECT_FALSE(filter.MayMatch("bc")) << regex;
+    EXPECT_FALSE(filter.MayMatch("ab")) << regex;
+    // The literals have to appear in order.
+    EXPECT_FALSE(filter.MayMatch("ca")) << regex;
+  }
+
+  // A quantifier at the start of a literal leaves nothing to remove.
+  RegexLiteralFilter after_dot("a.*b");
+  EXPECT_TRUE(after_dot.MayMatch("ab"));
+  EXPECT_FALSE(after_dot.MayMatch("ba"));
+
+  // A brace that doesn't start a bound isn't understood.
+  EXPECT_TRUE(RegexLiteralFilter("a{b").MayMatch("c"));
+  EXPECT_TRUE(RegexLiteralFilter("a{2").MayMatch("c"));
+}
+
+TEST(RegexLiteralFilterTest, BracketExpressions) {
+  RegexLiteralFilter simple("a[bc]d");
+  EXPECT_TRUE(simple.MayMatch("abd"));
+  EXPECT_TRUE(simple.MayMatch("axd"));
+  EXPECT_FALSE(simple.MayMatch("bcd"));
+
+  // Brackets and character classes inside the expression don't end it.
+  for (const char *regex : {"a[]]b", "a[^]x]b", "a[[:digit:]]b",
+                            "a[[:alpha:][:digit:]]b", "a[x[]b"}) {
+    RegexLiteralFilter filter(regex);
+    EXPECT_TRUE(filter.MayMatch("a]b")) << regex;
+    EXPECT_TRUE(filter.MayMatch("a1b")) << regex;
+    EXPECT_FALSE(filter.MayMatch("ba")) << regex;
+  }
+
+  // An unclosed bracket expression makes the filter give up.
+  EXPECT_TRUE(RegexLiteralFilter("a[b").MayMatch("c"));
+  EXPECT_TRUE(RegexLiteralFilter("a[[:digit:b").MayMatch("c"));
+}
+
+TEST(RegexLiteralFilterTest, Groups) {
+  // Nothing inside a group is required, alternatives or not.
+  RegexLiteralFilter alternatives("x(ab|cd)y");
+  EXPECT_TRUE(alternatives.MayMatch("xaby"));
+  EXPECT_TRUE(alternatives.MayMatch("xcdy"));
+  EXPECT_FALSE(alternatives.MayMatch("ab"));
+  EXPECT_FALSE(alternatives.MayMatch("yx"));
+
+  RegexLiteralFilter nested("x((a)|[)]b)y");
+  EXPECT_TRUE(nested.MayMatch("xay"));
+  EXPECT_TRUE(nested.MayMatch("x)by"));
+  EXPECT_FALSE(nested.MayMatch("y"));
+
+  // Top level alternatives and unbalanced groups make the filter give up.
+  EXPECT_TRUE(RegexLiteralFilter("ab|cd").MayMatch("cd"));
+  EXPECT_TRUE(RegexLiteralFilter("ab|cd").MayMatch("x"));
+  EXPECT_TRUE(RegexLiteralFilter("a)b").MayMatch("x"));
+  EXPECT_TRUE(RegexLiteralFilter("a(b").MayMatch("x"));
+}
+
+TEST(RegexLiteralFilterTest, Escapes) {
+  RegexLiteralFilter escaped("a\\.b");
+  EXPECT_TRUE(escaped.MayMatch("a.b"));
+  EXPECT_FALSE(escaped.MayMatch("b.a"));
+
+  EXPECT_TRUE(RegexLiteralFilter().MayMatch("anything"));
+}
@@ -1,6 +1,13 @@
 #include "gtest/gtest.h"
 
 #include "lldb/Host/TaskPool.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <queue>
+#include <thread>
 
 using namespace lldb_private;
 
@@ -43,3 +50,173 @@ TEST(TaskPoolTest, TaskMap) {
   ASSERT_EQ(data[2], 4);
   ASSERT_EQ(data[3], 9);
 }
+
+TEST(TaskPoolTest, NestedTaskMap) {
+  // Every level waits for the level below it from a task on the pool, which
+  // must not deadlock however few worker threads there are.
+  std::atomic<size_t> count{0};
+  TaskMapOverInt(0, 16, [&count](size_t) {
+    TaskMapOverInt(0, 16, [&count](size_t) {
+      TaskMapOverInt(0, 4, [&count](size_t) { count++; });
+    });
+  });
+  ASSERT_EQ(16u * 16u * 4u, count.load());
+}
+
+TEST(TaskPoolTest, WaitInTask) {
+  auto outer = TaskPool::AddTask([]() {
+    auto inner = TaskPool::AddTask([]() { return 42; });
+    TaskPool::Wait(inner);
+    return inner.get() + 1;
+  });
+  TaskPool::Wait(outer);
+  ASSERT_EQ(43, outer.get());
+}
+
+TEST(TaskPoolTest, WaitOnlyRunsOwnTasks) {
+  // The tasks of another thread must never run while this one waits, they
+  // might need a lock it holds.
+  const std::thread::id waiter = std::this_thread::get_id();
+  std::atomic<unsigned> foreign_tasks_run_by_waiter{0};
+  std::thread other([&]() {
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 1000; ++i)
+      futures.push_back(TaskPool::AddTask([&]() {
+        if (std::this_thread::get_id() == waiter)
+          foreign_tasks_run_by_waiter++;
+      }));
+    for (std::future<void> &future : futures)
+      TaskPool::Wait(future);
+  });
+
+  std::atomic<unsigned> count{0};
+  for (int i = 0; i < 1000; ++i) {
+    auto future = TaskPool::AddTask([&count]() { count++; });
+    TaskPool::Wait(future);
+  }
+  other.join();
+  ASSERT_EQ(1000u, count.load());
+  ASSERT_EQ(0u, foreign_tasks_run_by_waiter.load());
+}
+
+namespace {
+// The previous implementation of the task pool, a single FIFO queue guarded by
+// one mutex, kept here to compare the work-stealing pool against.
+class FIFOTaskPool {
+public:
+  explicit FIFOTaskPool(unsigned num_threads) {
+    for (unsigned i = 0; i < num_threads; ++i)
+      m_threads.emplace_back([this]() { Worker(); });
+  }
+
+  ~FIFOTaskPool() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_done = true;
+    }
+    m_cv.notify_all();
+    for (std::thread &thread : m_threads)
+      thread.join();
+  }
+
+  std::future<void> AddTask(std::function<void()> fn) {
+    auto task = std::make_shared<std::packaged_task<void()>>(std::move(fn));
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_tasks.push([task]() { (*task)(); });
+    }
+    m_cv.notify_one();
+    return task->get_future();
+  }
+
+private:
+  void Worker() {
+    while (true) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [this]() { return m_done || !m_tasks.empty(); });
+      if (m_tasks.empty())
+        return;
+      std::function<void()> fn = std::move(m_tasks.front());
+      m_tasks.pop();
+      lock.unlock();
+      fn();
+    }
+  }
+
+  std::vector<std::thread> m_threads;
+  std::queue<std::function<void()>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_done = false;
+};
+
+// TaskMapOverInt as it was implemented on top of the previous task pool.
+void FIFOTaskMapOverInt(FIFOTaskPool &pool, size_t begin, size_t end,
+                        const llvm::function_ref<void(size_t)> &func) {
+  const size_t num_workers =
+      std::min<size_t>(end, GetHardwareConcurrencyHint());
+  std::atomic<size_t> idx{begin};
+
+  auto wrapper = [&idx, end, &func]() {
+    while (true) {
+      size_t i = idx.fetch_add(1);
+      if (i >= end)
+        break;
+      func(i);
+    }
+  };
+
+  std::vector<std::future<void>> futures;
+  futures.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++)
+    futures.push_back(pool.AddTask(wrapper));
+  for (size_t i = 0; i < num_workers; i++)
+    futures[i].wait();
+}
+
+template <typename F> double MeasureSeconds(F &&f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+} // namespace
+
+// Micro-benchmark comparing the task pool with a single-queue pool. Both run
+// the same TaskMapOverInt workload of many small items, a few rounds each.
+// Run with --gtest_also_run_disabled_tests.
+TEST(TaskPoolTest, DISABLED_BenchmarkTaskMap) {
+  const size_t num_items = 200000;
+  const unsigned num_rounds = 20;
+  std::atomic<size_t> count{0};
+  auto small_item = [&count](size_t) {
+    volatile unsigned x = 0;
+    for (unsigned i = 0; i < 64; ++i)
+      x = x + i;
+    count++;
+  };
+
+  double fifo_seconds;
+  {
+    FIFOTaskPool pool(GetHardwareConcurrencyHint());
+    fifo_seconds = MeasureSeconds([&]() {
+      for (unsigned round = 0; round < num_rounds; ++round)
+        FIFOTaskMapOverInt(pool, 0, num_items, small_item);
+    });
+  }
+  ASSERT_EQ(num_items * num_rounds, count.load());
+
+  count = 0;
+  double stealing_seconds = MeasureSeconds([&]() {
+    for (unsigned round = 0; round < num_rounds; ++round)
+      TaskMapOverInt(0, num_items, small_item);
+  });
+  ASSERT_EQ(num_items * num_rounds, count.load());
+
+  llvm::outs() << llvm::formatv(
+      "{0} rounds of {1} items on {2} threads: FIFO pool {3:f3}s, "
+      "work-stealing pool {4:f3}s\n",
+      num_rounds, num_items, GetHardwareConcurrencyHint(), fifo_seconds,
+      stealing_seconds);
+}
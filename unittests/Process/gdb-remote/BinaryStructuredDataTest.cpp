@@ -0,0 +1,97 @@
+//===-- BinaryStructuredDataTest.cpp ----------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "Plugins/Process/gdb-remote/BinaryStructuredData.h"
+#include "lldb/Utility/StreamString.h"
+#include "llvm/Testing/Support/Error.h"
+
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+static std::string ToJSON(const StructuredData::ObjectSP &object_sp) {
+  StreamString stream;
+  object_sp->Dump(stream, /*pretty_print=*/false);
+  return stream.GetString().str();
+}
+
+TEST(BinaryStructuredDataTest, ThreadsInfo) {
+  BinaryStructuredDataWriter writer;
+  writer.BeginArray();
+  writer.BeginDictionary();
+  writer.PutKey("registers");
+  writer.BeginDictionary();
+  writer.PutKey("16");
+  writer.PutBytes({0x00, 0x10, 0xfe, 0xff});
+  writer.End();
+  writer.PutKey("tid");
+  writer.PutUnsigned(4242);
+  writer.PutKey("signal");
+  writer.PutSigned(-5);
+  writer.PutKey("reason");
+  writer.PutString("breakpoint");
+  writer.PutKey("ratio");
+  writer.PutDouble(0.5);
+  writer.PutKey("flags");
+  writer.BeginArray();
+  writer.PutBoolean(true);
+  writer.PutBoolean(false);
+  writer.PutNull();
+  writer.End();
+  writer.End();
+  writer.End();
+
+  llvm::Expected<StructuredData::ObjectSP> object =
+      ParseBinaryStructuredData(writer.GetData());
+  ASSERT_THAT_EXPECTED(object, llvm::Succeeded());
+
+  StructuredData::Array *array = (*object)->GetAsArray();
+  ASSERT_NE(nullptr, array);
+  ASSERT_EQ(1u, array->GetSize());
+  StructuredData::Dictionary *thread = nullptr;
+  ASSERT_TRUE(array->GetItemAtIndexAsDictionary(0, thread));
+
+  uint64_t tid = 0;
+  EXPECT_TRUE(thread->GetValueForKeyAsInteger("tid", tid));
+  EXPECT_EQ(4242u, tid);
+  int64_t signal = 0;
+  EXPECT_TRUE(thread->GetValueForKeyAsInteger("signal", signal));
+  EXPECT_EQ(-5, signal);
+  llvm::StringRef reason;
+  EXPECT_TRUE(thread->GetValueForKeyAsString("reason", reason));
+  EXPECT_EQ("breakpoint", reason);
+
+  // Byte blocks read back like the hex strings of the JSON reply.
+  StructuredData::Dictionary *registers = nullptr;
+  ASSERT_TRUE(thread->GetValueForKeyAsDictionary("registers", registers));
+  llvm::StringRef pc;
+  EXPECT_TRUE(registers->GetValueForKeyAsString("16", pc));
+  EXPECT_EQ("0010feff", pc);
+
+  EXPECT_EQ("[true,false,null]", ToJSON(thread->GetValueForKey("flags")));
+}
+
+TEST(BinaryStructuredDataTest, Malformed) {
+  // Unterminated array.
+  EXPECT_THAT_EXPECTED(
+      ParseBinaryStructuredData(llvm::StringRef("\x08\x00", 2)),
+      llvm::Failed());
+  // String longer than the data.
+  EXPECT_THAT_EXPECTED(ParseBinaryStructuredData("\x06\x05" "ab"),
+                       llvm::Failed());
+  // Dictionary key without a string tag.
+  EXPECT_THAT_EXPECTED(ParseBinaryStructuredData("\x09\x03\x0a"),
+                       llvm::Failed());
+  // Trailing bytes.
+  EXPECT_THAT_EXPECTED(
+      ParseBinaryStructuredData(llvm::StringRef("\x00\x00", 2)),
+      llvm::Failed());
+  // Unknown tag.
+  EXPECT_THAT_EXPECTED(ParseBinaryStructuredData("\x7f"), llvm::Failed());
+}
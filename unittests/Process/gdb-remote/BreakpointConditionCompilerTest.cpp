@@ -0,0 +1,468 @@
+//===-- BreakpointConditionCompilerTest.cpp ---------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "Plugins/Process/gdb-remote/BreakpointConditionCompiler.h"
+#include "lldb/Utility/DataBufferHeap.h"
+#include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Testing/Support/Error.h"
+
+#include <map>
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+using namespace llvm::dwarf;
+
+typedef BreakpointConditionCompiler::VariableInfo VariableInfo;
+
+namespace {
+/// Builds DWARF expressions.
+struct Location {
+  std::vector<uint8_t> bytes;
+
+  Location &Op(uint8_t op) {
+    bytes.push_back(op);
+    return *this;
+  }
+  Location &ULEB(uint64_t value) {
+    uint8_t buffer[16];
+    bytes.insert(bytes.end(), buffer,
+                 buffer + llvm::encodeULEB128(value, buffer));
+    return *this;
+  }
+  Location &SLEB(int64_t value) {
+    uint8_t buffer[16];
+    bytes.insert(bytes.end(), buffer,
+                 buffer + llvm::encodeSLEB128(value, buffer));
+    return *this;
+  }
+  Location &Addr(uint64_t addr) {
+    for (int i = 0; i < 8; ++i)
+      bytes.push_back(addr >> (i * 8));
+    return *this;
+  }
+
+  DataExtractor GetData() const {
+    if (bytes.empty())
+      return DataExtractor();
+    return DataExtractor(
+        DataBufferSP(new DataBufferHeap(bytes.data(), bytes.size())),
+        eByteOrderLittle, 8);
+  }
+};
+
+/// The stub's number for a DWARF register, registers without a number are
+/// unknown to the stub.
+const uint32_t g_stub_reg_offset = 100;
+const uint32_t g_unmapped_dwarf_reg = 50;
+
+/// The distance between file and load addresses.
+const addr_t g_load_bias = 0x10000;
+
+class FakeScope : public BreakpointConditionCompiler::Scope {
+public:
+  bool c_family = true;
+  bool past_prologue = true;
+  Location frame_base;
+  std::map<std::string, VariableInfo> variables;
+
+  bool IsCFamily() override { return c_family; }
+
+  uint32_t GetAddressByteSize() override { return 8; }
+
+  llvm::Expected<VariableInfo> FindVariable(llvm::StringRef name) override {
+    auto pos = variables.find(name.str());
+    if (pos == variables.end())
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "no variable named '%s'",
+                                     name.str().c_str());
+    return pos->second;
+  }
+
+  llvm::Expected<addr_t> GetLoadAddress(const VariableInfo &variable,
+                                        addr_t file_addr) override {
+    return file_addr + g_load_bias;
+  }
+
+  llvm::Expected<DataExtractor> GetFrameBase() override {
+    return frame_base.GetData();
+  }
+
+  llvm::Error CheckPastPrologue() override {
+    if (past_prologue)
+      return llvm::Error::success();
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "the breakpoint is in the prologue");
+  }
+
+  llvm::Optional<uint32_t> MapRegister(uint32_t dwarf_reg_num) override {
+    if (dwarf_reg_num == g_unmapped_dwarf_reg)
+      return llvm::None;
+    return dwarf_reg_num + g_stub_reg_offset;
+  }
+};
+
+struct FakeTarget {
+  std::map<uint32_t, uint64_t> registers;
+  std::map<addr_t, uint8_t> memory;
+
+  void WriteMemory(addr_t addr, uint64_t value, uint32_t size) {
+    for (uint32_t i = 0; i < size; ++i)
+      memory[addr + i] = value >> (i * 8);
+  }
+
+  llvm::Expected<uint64_t> Evaluate(const AgentExpression &expr) {
+    return expr.Evaluate(
+        [this](uint32_t reg_num) -> llvm::Expected<uint64_t> {
+          auto pos = registers.find(reg_num);
+          if (pos == registers.end())
+            return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                           "bad register");
+          return pos->second;
+        },
+        [this](addr_t addr, uint32_t size) -> llvm::Expected<uint64_t> {
+          uint64_t value = 0;
+          for (uint32_t i = 0; i < size; ++i) {
+            auto pos = memory.find(addr + i);
+            if (pos == memory.end())
+              return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                             "bad address");
+            value |= uint64_t(pos->second) << (i * 8);
+          }
+          return value;
+        });
+  }
+};
+
+// The C values of the variables the conditions refer to. The fake target
+// holds them at the locations set up in the fixture.
+int i = -7;
+unsigned u = 3;
+long long ll = -5000000000ll;
+unsigned long long ull = 0xfedcba9876543210ull;
+short s = -300;
+unsigned char uc = 200;
+signed char sc = -100;
+void *p = reinterpret_cast<void *>(0x1234);
+void *np = nullptr;
+
+class BreakpointConditionCompilerTest : public testing::Test {
+protected:
+  void SetUp() override {
+    // i lives in a register whose upper bits are garbage.
+    AddVariable("i", VariableInfo::eInteger, 4, true,
+                Location().Op(DW_OP_reg3));
+    m_target.registers[3 + g_stub_reg_offset] =
+        0xdeadbeef00000000ull | uint32_t(i);
+
+    AddVariable("u", VariableInfo::eInteger, 4, false,
+                Location().Op(DW_OP_regx).ULEB(40));
+    m_target.registers[40 + g_stub_reg_offset] =
+        0xdeadbeef00000000ull | u;
+
+    AddVariable("ll", VariableInfo::eInteger, 8, true,
+                Location().Op(DW_OP_breg7).SLEB(-16));
+    m_target.registers[7 + g_stub_reg_offset] = 0x7000;
+    m_target.WriteMemory(0x7000 - 16, ll, 8);
+
+    AddVariable("ull", VariableInfo::eInteger, 8, false,
+                Location().Op(DW_OP_bregx).ULEB(33).SLEB(8));
+    m_target.registers[33 + g_stub_reg_offset] = 0x8000;
+    m_target.WriteMemory(0x8000 + 8, ull, 8);
+
+    // The frame base is at 0x6010.
+    m_scope.frame_base = Location().Op(DW_OP_breg6).SLEB(16);
+    m_target.registers[6 + g_stub_reg_offset] = 0x6000;
+    AddVariable("s", VariableInfo::eInteger, 2, true,
+                Location().Op(DW_OP_fbreg).SLEB(-20));
+    m_target.WriteMemory(0x6010 - 20, s, 2);
+    AddVariable("sc", VariableInfo::eInteger, 1, true,
+                Location().Op(DW_OP_fbreg).SLEB(0));
+    m_target.WriteMemory(0x6010, sc, 1);
+
+    AddVariable("uc", VariableInfo::eInteger, 1, false,
+                Location().Op(DW_OP_addr).Addr(0x2000));
+    m_target.WriteMemory(0x2000 + g_load_bias, uc, 1);
+
+    AddVariable("p", VariableInfo::ePointer, 8, false,
+                Location().Op(DW_OP_addr).Addr(0x3000));
+    m_target.WriteMemory(0x3000 + g_load_bias,
+                         reinterpret_cast<uintptr_t>(p), 8);
+    AddVariable("np", VariableInfo::ePointer, 8, false,
+                Location().Op(DW_OP_addr).Addr(0x3008));
+    m_target.WriteMemory(0x3008 + g_load_bias, 0, 8);
+  }
+
+  void AddVariable(llvm::StringRef name, VariableInfo::Kind kind,
+                   uint32_t byte_size, bool is_signed,
+                   const Location &location) {
+    VariableInfo &variable = m_scope.variables[name.str()];
+    variable.kind = kind;
+    variable.byte_size = byte_size;
+    variable.is_signed = is_signed;
+    variable.location = location.GetData();
+  }
+
+  llvm::Expected<AgentExpression> Compile(llvm::StringRef condition) {
+    BreakpointConditionCompiler compiler(m_scope);
+    return compiler.Compile(condition);
+  }
+
+  llvm::Expected<uint64_t> Evaluate(llvm::StringRef condition) {
+    llvm::Expected<AgentExpression> expr = Compile(condition);
+    if (!expr)
+      return expr.takeError();
+    return m_target.Evaluate(*expr);
+  }
+
+  FakeScope m_scope;
+  FakeTarget m_target;
+};
+} // namespace
+
+// Values are kept in 64 bits, sign extended for signed types and zero
+// extended for unsigned ones.
+#define EXPECT_AS_IN_C(expr)                                                   \
+  EXPECT_THAT_EXPECTED(Evaluate(#expr),                                        \
+                       llvm::HasValue(uint64_t(int64_t(expr))))
+
+#define EXPECT_REJECTED(condition)                                             \
+  EXPECT_THAT_EXPECTED(Compile(condition), llvm::Failed())
+
+TEST_F(BreakpointConditionCompilerTest, OperandLocations) {
+  EXPECT_AS_IN_C(i);   // DW_OP_reg3
+  EXPECT_AS_IN_C(u);   // DW_OP_regx
+  EXPECT_AS_IN_C(ll);  // DW_OP_breg7
+  EXPECT_AS_IN_C(ull); // DW_OP_bregx
+  EXPECT_AS_IN_C(s);   // DW_OP_fbreg
+  EXPECT_AS_IN_C(sc);  // DW_OP_fbreg with no offset
+  EXPECT_AS_IN_C(uc);  // DW_OP_addr
+}
+
+TEST_F(BreakpointConditionCompilerTest, FrameBases) {
+  // DW_OP_reg6 and DW_OP_regx 6 make the register the frame base.
+  m_target.registers[6 + g_stub_reg_offset] = 0x6010;
+  m_scope.frame_base = Location().Op(DW_OP_reg6);
+  EXPECT_AS_IN_C(s);
+  m_scope.frame_base = Location().Op(DW_OP_regx).ULEB(6);
+  EXPECT_AS_IN_C(s);
+
+  m_target.registers[6 + g_stub_reg_offset] = 0x6000;
+  m_scope.frame_base = Location().Op(DW_OP_bregx).ULEB(6).SLEB(16);
+  EXPECT_AS_IN_C(s);
+
+  // Frame bases that need unwinding.
+  m_scope.frame_base = Location().Op(DW_OP_call_frame_cfa);
+  EXPECT_REJECTED("s");
+  m_scope.frame_base = Location();
+  EXPECT_REJECTED("s");
+  m_scope.frame_base = Location().Op(DW_OP_breg6).SLEB(16).Op(DW_OP_deref);
+  EXPECT_REJECTED("s");
+}
+
+TEST_F(BreakpointConditionCompilerTest, ArithmeticOperators) {
+  EXPECT_AS_IN_C(i + 10);
+  EXPECT_AS_IN_C(i - u);
+  EXPECT_AS_IN_C(i * 3);
+  EXPECT_AS_IN_C(i / 2);
+  EXPECT_AS_IN_C(i % 4);
+  EXPECT_AS_IN_C(i / u);
+  EXPECT_AS_IN_C(i % u);
+  EXPECT_AS_IN_C(ll * 3);
+  EXPECT_AS_IN_C(ll / i);
+  EXPECT_AS_IN_C(ull / 3);
+  EXPECT_AS_IN_C(ull % 1000);
+  EXPECT_AS_IN_C(s * s);
+  EXPECT_AS_IN_C(uc + sc);
+  EXPECT_AS_IN_C(u - 4);
+  EXPECT_AS_IN_C(-i);
+  EXPECT_AS_IN_C(-u);
+  EXPECT_AS_IN_C(+s);
+  EXPECT_AS_IN_C(-uc);
+  EXPECT_AS_IN_C((i + 1) * (u + 2));
+  EXPECT_AS_IN_C(1 + 2 * 3 - 4 / 2);
+}
+
+TEST_F(BreakpointConditionCompilerTest, BitwiseOperators) {
+  EXPECT_AS_IN_C(i & 0xff);
+  EXPECT_AS_IN_C(i | 0x100);
+  EXPECT_AS_IN_C(i ^ u);
+  EXPECT_AS_IN_C(~i);
+  EXPECT_AS_IN_C(~u);
+  EXPECT_AS_IN_C(~uc);
+  EXPECT_AS_IN_C(ull & 0xffff0000ffff0000ull);
+  EXPECT_AS_IN_C(u << 30);
+  EXPECT_AS_IN_C(uc << 4);
+  EXPECT_AS_IN_C(i >> 1);
+  EXPECT_AS_IN_C(u >> 1);
+  EXPECT_AS_IN_C(ll >> 40);
+  EXPECT_AS_IN_C(ull >> 40);
+  EXPECT_AS_IN_C(1 | 2 ^ 3 & 4);
+}
+
+TEST_F(BreakpointConditionCompilerTest, RelationalOperators) {
+  EXPECT_AS_IN_C(i < 0);
+  EXPECT_AS_IN_C(i > 0);
+  EXPECT_AS_IN_C(i <= -7);
+  EXPECT_AS_IN_C(i >= -6);
+  EXPECT_AS_IN_C(i == -7);
+  EXPECT_AS_IN_C(i != -7);
+  // The usual arithmetic conversions turn i into a large unsigned value.
+  EXPECT_AS_IN_C(i < u);
+  EXPECT_AS_IN_C(i > u);
+  EXPECT_AS_IN_C(i == 4294967289u);
+  EXPECT_AS_IN_C(ll < u);
+  EXPECT_AS_IN_C(ull > ll);
+  EXPECT_AS_IN_C(s < uc);
+  EXPECT_AS_IN_C(sc < 0);
+  EXPECT_AS_IN_C(1 < 2 == 1);
+}
+
+TEST_F(BreakpointConditionCompilerTest, LogicalOperators) {
+  EXPECT_AS_IN_C(!i);
+  EXPECT_AS_IN_C(!!i);
+  EXPECT_AS_IN_C(i && u);
+  EXPECT_AS_IN_C(i && 0);
+  EXPECT_AS_IN_C(0 || u);
+  EXPECT_AS_IN_C(0 || 0);
+  EXPECT_AS_IN_C(i < 0 && u == 3 || ll > 0);
+  EXPECT_AS_IN_C(i > 0 || u == 3 && ll > 0);
+  EXPECT_AS_IN_C(true && !false);
+}
+
+TEST_F(BreakpointConditionCompilerTest, Literals) {
+  // Decimal literals are signed unless they have an u suffix, hexadecimal and
+  // octal ones take the first type that can hold them.
+  EXPECT_AS_IN_C(4294967295 > -1);
+  EXPECT_AS_IN_C(0xffffffff > -1);
+  EXPECT_AS_IN_C(037777777777 > -1);
+  EXPECT_AS_IN_C(2147483648 > -1);
+  EXPECT_AS_IN_C(0x80000000 > -1);
+  EXPECT_AS_IN_C(1u > -1);
+  EXPECT_AS_IN_C(1l > -1);
+  EXPECT_AS_IN_C(1ul > -1);
+  EXPECT_AS_IN_C(1LL > -1);
+  EXPECT_AS_IN_C(1ULL > -1);
+  EXPECT_AS_IN_C(0xffffffffffffffff > 0);
+  EXPECT_AS_IN_C(0x7fffffff + 0);
+
+  EXPECT_REJECTED("1uu");
+  EXPECT_REJECTED("1lll");
+  EXPECT_REJECTED("1lul");
+  EXPECT_REJECTED("1x");
+  EXPECT_REJECTED("18446744073709551616");
+  EXPECT_REJECTED("0x10000000000000000");
+  EXPECT_REJECTED("1.5");
+  EXPECT_REJECTED("1e3");
+  EXPECT_REJECTED("'a'");
+  EXPECT_REJECTED("\"a\"");
+}
+
+TEST_F(BreakpointConditionCompilerTest, Pointers) {
+  EXPECT_THAT_EXPECTED(Evaluate("p == 0"), llvm::HasValue(0u));
+  EXPECT_THAT_EXPECTED(Evaluate("p != 0"), llvm::HasValue(1u));
+  EXPECT_THAT_EXPECTED(Evaluate("0 == np"), llvm::HasValue(1u));
+  EXPECT_THAT_EXPECTED(Evaluate("!p"), llvm::HasValue(0u));
+  EXPECT_THAT_EXPECTED(Evaluate("!np"), llvm::HasValue(1u));
+  EXPECT_THAT_EXPECTED(Evaluate("p && !np"), llvm::HasValue(1u));
+  EXPECT_THAT_EXPECTED(Evaluate("p == (0)"), llvm::HasValue(0u));
+
+  // The stub doesn't know the pointee types.
+  EXPECT_REJECTED("p + 1");
+  EXPECT_REJECTED("p - np");
+  EXPECT_REJECTED("-p");
+  EXPECT_REJECTED("~p");
+  EXPECT_REJECTED("p << 1");
+  EXPECT_REJECTED("p & 1");
+  EXPECT_REJECTED("p < np");
+  EXPECT_REJECTED("p > 0");
+  EXPECT_REJECTED("p == 1");
+  EXPECT_REJECTED("p == np");
+  EXPECT_REJECTED("p == i");
+  EXPECT_REJECTED("p == 0 + 0");
+  EXPECT_REJECTED("p == -0");
+}
+
+TEST_F(BreakpointConditionCompilerTest, UnsupportedSyntax) {
+  EXPECT_REJECTED("");
+  EXPECT_REJECTED("i = 1");
+  EXPECT_REJECTED("i += 1");
+  EXPECT_REJECTED("i++");
+  EXPECT_REJECTED("i ? u : 0");
+  EXPECT_REJECTED("i, u");
+  EXPECT_REJECTED("i(1)");
+  EXPECT_REJECTED("f(1)");
+  EXPECT_REJECTED("s.x");
+  EXPECT_REJECTED("p->x");
+  EXPECT_REJECTED("*p");
+  EXPECT_REJECTED("&i");
+  EXPECT_REJECTED("p[0]");
+  EXPECT_REJECTED("(char)i");
+  EXPECT_REJECTED("sizeof(i)");
+  EXPECT_REJECTED("(i");
+  EXPECT_REJECTED("i)");
+  EXPECT_REJECTED("i u");
+  EXPECT_REJECTED("unknown == 1");
+}
+
+TEST_F(BreakpointConditionCompilerTest, UnsupportedVariables) {
+  AddVariable("f", VariableInfo::eOther, 4, false,
+              Location().Op(DW_OP_reg3));
+  EXPECT_REJECTED("f");
+  AddVariable("i128", VariableInfo::eInteger, 16, true,
+              Location().Op(DW_OP_breg7).SLEB(0));
+  EXPECT_REJECTED("i128");
+  AddVariable("p32", VariableInfo::ePointer, 4, false,
+              Location().Op(DW_OP_breg7).SLEB(0));
+  EXPECT_REJECTED("p32 == 0");
+
+  // Location lists and locations that are more than a register or an address.
+  AddVariable("list", VariableInfo::eInteger, 4, true, Location());
+  EXPECT_REJECTED("list");
+  AddVariable("deref", VariableInfo::eInteger, 4, true,
+              Location().Op(DW_OP_breg7).SLEB(0).Op(DW_OP_deref));
+  EXPECT_REJECTED("deref");
+  AddVariable("piece", VariableInfo::eInteger, 8, true,
+              Location().Op(DW_OP_reg3).Op(DW_OP_piece).ULEB(4).Op(
+                  DW_OP_reg4).Op(DW_OP_piece).ULEB(4));
+  EXPECT_REJECTED("piece");
+  AddVariable("value", VariableInfo::eInteger, 4, true,
+              Location().Op(DW_OP_lit1).Op(DW_OP_stack_value));
+  EXPECT_REJECTED("value");
+  AddVariable("tls", VariableInfo::eInteger, 4, true,
+              Location().Op(DW_OP_const8u).Addr(0x10).Op(
+                  DW_OP_GNU_push_tls_address));
+  EXPECT_REJECTED("tls");
+
+  // Registers the stub doesn't have.
+  AddVariable("unmapped", VariableInfo::eInteger, 4, true,
+              Location().Op(DW_OP_regx).ULEB(g_unmapped_dwarf_reg));
+  EXPECT_REJECTED("unmapped");
+  AddVariable("unmapped_base", VariableInfo::eInteger, 4, true,
+              Location().Op(DW_OP_bregx).ULEB(g_unmapped_dwarf_reg).SLEB(0));
+  EXPECT_REJECTED("unmapped_base");
+}
+
+TEST_F(BreakpointConditionCompilerTest, Prologue) {
+  // Only variables at fixed addresses hold their values in the prologue.
+  m_scope.past_prologue = false;
+  EXPECT_REJECTED("i");
+  EXPECT_REJECTED("u");
+  EXPECT_REJECTED("ll");
+  EXPECT_REJECTED("ull");
+  EXPECT_REJECTED("s");
+  EXPECT_AS_IN_C(uc);
+}
+
+TEST_F(BreakpointConditionCompilerTest, Language) {
+  m_scope.c_family = false;
+  EXPECT_REJECTED("1");
+}
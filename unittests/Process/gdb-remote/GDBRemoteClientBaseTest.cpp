@@ -359,3 +359,50 @@ TEST_F(GDBRemoteClientBaseTest, SendPacketAndReceiveResponseWithOutputSupport) {
   ASSERT_EQ("OK", response.GetStringRef());
   ASSERT_EQ("Hello, world", command_output.GetString().str());
 }
+
+TEST_F(GDBRemoteClientBaseTest, SendPacketsAndWaitForResponses) {
+  std::vector<std::string> packets = {"m1000,4", "m2000,4", "qC"};
+  std::vector<StringExtractorGDBRemote> responses;
+  const uint64_t round_trips = client.GetRoundTripCount();
+  std::future<PacketResult> async_result = std::async(std::launch::async, [&] {
+    return client.SendPacketsAndWaitForResponses(packets, responses, false);
+  });
+
+  // All packets are sent before the first response arrives.
+  StringExtractorGDBRemote request;
+  for (const std::string &packet : packets) {
+    ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+    ASSERT_EQ(packet, request.GetStringRef());
+  }
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("41424344"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("E01"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("QC47"));
+
+  ASSERT_EQ(PacketResult::Success, async_result.get());
+  ASSERT_EQ(3u, responses.size());
+  EXPECT_EQ("41424344", responses[0].GetStringRef());
+  EXPECT_EQ("E01", responses[1].GetStringRef());
+  EXPECT_EQ("QC47", responses[2].GetStringRef());
+  EXPECT_EQ(round_trips + 1, client.GetRoundTripCount());
+}
+
+TEST_F(GDBRemoteClientBaseTest, SendPacketsAndWaitForResponsesTimeout) {
+  std::vector<std::string> packets = {"m1000,4", "m2000,4", "qC"};
+  std::vector<StringExtractorGDBRemote> responses;
+  client.SetPacketTimeout(std::chrono::seconds(1));
+  std::future<PacketResult> async_result = std::async(std::launch::async, [&] {
+    return client.SendPacketsAndWaitForResponses(packets, responses, false);
+  });
+
+  StringExtractorGDBRemote request;
+  for (size_t i = 0; i < packets.size(); ++i)
+    ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("41424344"));
+
+  // The other responses never arrive. They must not be taken for the
+  // responses of later packets, so the client has to drop the connection.
+  ASSERT_EQ(PacketResult::ErrorReplyTimeout, async_result.get());
+  ASSERT_EQ(1u, responses.size());
+  EXPECT_EQ("41424344", responses[0].GetStringRef());
+  EXPECT_FALSE(client.IsConnected());
+}
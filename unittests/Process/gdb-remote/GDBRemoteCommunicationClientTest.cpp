@@ -225,6 +225,43 @@ TEST_F(GDBRemoteCommunicationClientTest, GetModulesInfo_UUID20) {
   EXPECT_EQ(1234u, result.getValue()[0].GetObjectSize());
 }
 
+TEST_F(GDBRemoteCommunicationClientTest, GetModulesInfo_qModuleInfo) {
+  llvm::Triple triple("i386-pc-linux");
+
+  FileSpec file_specs[] = {FileSpec("/foo/bar.so", FileSpec::Style::posix),
+                           FileSpec("/foo/baz.so", FileSpec::Style::posix)};
+  std::future<llvm::Optional<std::vector<ModuleSpec>>> async_result =
+      std::async(std::launch::async,
+                 [&] { return client.GetModulesInfo(file_specs, triple); });
+  HandlePacket(server, testing::StartsWith("jModulesInfo:"), "");
+
+  // Without jModulesInfo, the module info is requested with one qModuleInfo
+  // packet per module, all sent at once.
+  StringExtractorGDBRemote request;
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("qModuleInfo:2f666f6f2f6261722e736f;693338362d70632d6c696e7578",
+            request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("qModuleInfo:2f666f6f2f62617a2e736f;693338362d70632d6c696e7578",
+            request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success,
+            server.SendPacket("uuid:404142434445464748494a4b4c4d4e4f;"
+                              "triple:693338362d70632d6c696e7578;"
+                              "file_path:2f666f6f2f6261722e736f;"
+                              "file_offset:0;file_size:4d2;"));
+  ASSERT_EQ(PacketResult::Success, server.SendErrorResponse(0x01));
+
+  auto result = async_result.get();
+  ASSERT_TRUE(result.hasValue());
+  ASSERT_EQ(1u, result->size());
+  EXPECT_EQ("/foo/bar.so", result.getValue()[0].GetFileSpec().GetPath());
+  EXPECT_EQ(triple, result.getValue()[0].GetArchitecture().GetTriple());
+  EXPECT_EQ(UUID::fromData("@ABCDEFGHIJKLMNO", 16),
+            result.getValue()[0].GetUUID());
+  EXPECT_EQ(0u, result.getValue()[0].GetObjectOffset());
+  EXPECT_EQ(1234u, result.getValue()[0].GetObjectSize());
+}
+
 TEST_F(GDBRemoteCommunicationClientTest, GetModulesInfoInvalidResponse) {
   llvm::Triple triple("i386-pc-linux");
   FileSpec file_spec("/foo/bar.so", FileSpec::Style::posix);
@@ -362,6 +399,42 @@ TEST_F(GDBRemoteCommunicationClientTest, GetMemoryRegionInfoInvalidResponse) {
   EXPECT_FALSE(result.get().Success());
 }
 
+TEST_F(GDBRemoteCommunicationClientTest, ReadMemoryRanges) {
+  typedef Range<lldb::addr_t, lldb::addr_t> LoadRange;
+  std::vector<LoadRange> ranges = {LoadRange(0x1000, 4), LoadRange(0x2000, 2),
+                                   LoadRange(0x3000, 3)};
+  uint8_t buf[9] = {};
+  size_t bytes_read[3] = {};
+  const uint64_t round_trips = client.GetRoundTripCount();
+  std::future<bool> result = std::async(std::launch::async, [&] {
+    return client.ReadMemoryRanges(ranges, buf, bytes_read);
+  });
+
+  // The last range can only be read partially. The "#" in the data is
+  // escaped as "}" followed by "#" ^ 0x20.
+  HandlePacket(server, "MultiMemRead:ranges:1000,4,2000,2,3000,3;",
+               StringRef("4,2,1;ABCD}\x03\x02E", 14));
+  ASSERT_TRUE(result.get());
+  EXPECT_EQ(round_trips + 1, client.GetRoundTripCount());
+  EXPECT_THAT(bytes_read, testing::ElementsAre(4u, 2u, 1u));
+  EXPECT_THAT(llvm::makeArrayRef(buf, 7),
+              testing::ElementsAre('A', 'B', 'C', 'D', '#', '\x02', 'E'));
+
+  // A reply with more bytes than requested is rejected.
+  result = std::async(std::launch::async, [&] {
+    return client.ReadMemoryRanges(ranges, buf, bytes_read);
+  });
+  HandlePacket(server, testing::StartsWith("MultiMemRead:"), "5,0,0;ABCDE");
+  EXPECT_FALSE(result.get());
+
+  result = std::async(std::launch::async, [&] {
+    return client.ReadMemoryRanges(ranges, buf, bytes_read);
+  });
+  HandlePacket(server, testing::StartsWith("MultiMemRead:"), "");
+  EXPECT_FALSE(result.get());
+  EXPECT_FALSE(client.GetMultiMemReadSupported());
+}
+
 TEST_F(GDBRemoteCommunicationClientTest, SendStartTracePacket) {
   TraceOptions options;
   Status error;
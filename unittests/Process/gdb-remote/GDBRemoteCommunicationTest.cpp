@@ -24,6 +24,8 @@ public:
     return GDBRemoteCommunication::ReadPacket(response, std::chrono::seconds(1),
                                               /*sync_on_timeout*/ false);
   }
+
+  void SetCompressionType(CompressionType type) { m_compression_type = type; }
 };
 
 class GDBRemoteCommunicationTest : public GDBRemoteTest {
@@ -65,3 +67,22 @@ TEST_F(GDBRemoteCommunicationTest, ReadPacket_checksum) {
     ASSERT_EQ(PacketResult::Success, server.GetAck());
   }
 }
+
+TEST_F(GDBRemoteCommunicationTest, ReadPacket_lz4) {
+  client.SetCompressionType(CompressionType::LZ4);
+  server.EnableSendCompression(CompressionType::LZ4);
+
+  // Small payloads are sent uncompressed, large ones compressed.
+  std::string large;
+  for (int i = 0; i < 200; ++i)
+    large += "{\"tid\":" + std::to_string(1000 + i) + ",\"reason\":\"trace\"},";
+  for (llvm::StringRef payload :
+       {llvm::StringRef("OK"), llvm::StringRef(large)}) {
+    SCOPED_TRACE(payload.take_front(16).str());
+    ASSERT_EQ(PacketResult::Success, server.SendPacket(payload));
+    StringExtractorGDBRemote response;
+    ASSERT_EQ(PacketResult::Success, client.ReadPacket(response));
+    ASSERT_EQ(payload.str(), response.GetStringRef());
+    ASSERT_EQ(PacketResult::Success, server.GetAck());
+  }
+}
@@ -67,6 +67,7 @@ public:
                                sync_on_timeout);
   }
 
+  using GDBRemoteCommunicationServer::EnableSendCompression;
   using GDBRemoteCommunicationServer::SendErrorResponse;
   using GDBRemoteCommunicationServer::SendOKResponse;
   using GDBRemoteCommunicationServer::SendUnimplementedResponse;
@@ -0,0 +1,199 @@
+//===-- MemoryCacheTest.cpp -------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Target/Memory.h"
+#include "Plugins/Platform/Linux/PlatformLinux.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Target/Platform.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Utility/ArchSpec.h"
+#include "lldb/Utility/Reproducer.h"
+#include "gtest/gtest.h"
+
+using namespace lldb_private;
+using namespace lldb_private::repro;
+using namespace lldb;
+
+namespace {
+class MemoryCacheTest : public ::testing::Test {
+public:
+  void SetUp() override {
+    llvm::cantFail(Reproducer::Initialize(ReproducerMode::Off, llvm::None));
+    FileSystem::Initialize();
+    HostInfo::Initialize();
+    platform_linux::PlatformLinux::Initialize();
+
+    ArchSpec arch("x86_64-pc-linux");
+    Platform::SetHostPlatform(
+        platform_linux::PlatformLinux::CreateInstance(true, &arch));
+    m_debugger_sp = Debugger::CreateInstance();
+    PlatformSP platform_sp;
+    m_debugger_sp->GetTargetList().CreateTarget(
+        *m_debugger_sp, "", arch, eLoadDependentsNo, platform_sp, m_target_sp);
+  }
+  void TearDown() override {
+    m_target_sp.reset();
+    if (m_debugger_sp)
+      Debugger::Destroy(m_debugger_sp);
+    platform_linux::PlatformLinux::Terminate();
+    HostInfo::Terminate();
+    FileSystem::Terminate();
+    Reproducer::Terminate();
+  }
+
+protected:
+  DebuggerSP m_debugger_sp;
+  TargetSP m_target_sp;
+};
+
+// A process with kMemorySize readable bytes at kMemoryBase. Every byte holds
+// the low byte of its address.
+class DummyProcess : public Process {
+public:
+  static const addr_t kMemoryBase = 0x10000;
+  static const addr_t kMemorySize = 0x10000;
+
+  using Process::Process;
+
+  bool CanDebug(lldb::TargetSP target, bool plugin_specified_by_name) override {
+    return true;
+  }
+  Status DoDestroy() override { return {}; }
+  void RefreshStateAfterStop() override {}
+  size_t DoReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
+                      Status &error) override {
+    ++m_num_reads;
+    if (vm_addr < kMemoryBase || vm_addr >= kMemoryBase + kMemorySize) {
+      error.SetErrorString("invalid address");
+      return 0;
+    }
+    size = std::min<size_t>(size, kMemoryBase + kMemorySize - vm_addr);
+    uint8_t *bytes = static_cast<uint8_t *>(buf);
+    for (size_t i = 0; i < size; ++i)
+      bytes[i] = static_cast<uint8_t>(vm_addr + i);
+    return size;
+  }
+  bool UpdateThreadList(ThreadList &old_thread_list,
+                        ThreadList &new_thread_list) override {
+    return false;
+  }
+  ConstString GetPluginName() override { return ConstString("Dummy"); }
+  uint32_t GetPluginVersion() override { return 0; }
+
+  uint32_t m_num_reads = 0;
+};
+
+bool ReadAndCheck(MemoryCache &cache, addr_t addr, size_t size) {
+  std::vector<uint8_t> buffer(size);
+  Status error;
+  if (cache.Read(addr, buffer.data(), size, error) != size || error.Fail())
+    return false;
+  for (size_t i = 0; i < size; ++i) {
+    if (buffer[i] != static_cast<uint8_t>(addr + i))
+      return false;
+  }
+  return true;
+}
+} // namespace
+
+TEST_F(MemoryCacheTest, HitsAndMisses) {
+  ASSERT_TRUE(m_target_sp);
+  ListenerSP listener_sp(Listener::MakeListener("dummy"));
+  auto process_sp = std::make_shared<DummyProcess>(m_target_sp, listener_sp);
+  const addr_t line_size = process_sp->GetMemoryCacheLineSize();
+  MemoryCache cache(*process_sp);
+
+  EXPECT_TRUE(ReadAndCheck(cache, DummyProcess::kMemoryBase + 4, 8));
+  EXPECT_EQ(1u, process_sp->m_num_reads);
+  EXPECT_TRUE(ReadAndCheck(cache, DummyProcess::kMemoryBase + 16, 8));
+  EXPECT_EQ(1u, process_sp->m_num_reads);
+
+  MemoryCache::Statistics stats = cache.GetStatistics();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+  EXPECT_EQ(1u, stats.process_reads);
+  EXPECT_EQ(line_size, stats.process_bytes_read);
+
+  // A read that crosses the end of the readable memory returns what could be
+  // read.
+  const addr_t end = DummyProcess::kMemoryBase + DummyProcess::kMemorySize;
+  uint8_t buffer[8];
+  Status error;
+  EXPECT_EQ(4u, cache.Read(end - 4, buffer, sizeof(buffer), error));
+
+  // Lines don't survive a stop unless they are part of a loaded read-only
+  // section.
+  cache.ClearWritableMemory();
+  const uint32_t num_reads = process_sp->m_num_reads;
+  EXPECT_TRUE(ReadAndCheck(cache, DummyProcess::kMemoryBase + 4, 8));
+  EXPECT_EQ(num_reads + 1, process_sp->m_num_reads);
+  EXPECT_EQ(0u, cache.GetStatistics().retained_lines);
+}
+
+TEST_F(MemoryCacheTest, PrefetchSequentialReads) {
+  ASSERT_TRUE(m_target_sp);
+  ListenerSP listener_sp(Listener::MakeListener("dummy"));
+  auto process_sp = std::make_shared<DummyProcess>(m_target_sp, listener_sp);
+  const addr_t line_size = process_sp->GetMemoryCacheLineSize();
+  MemoryCache cache(*process_sp);
+
+  // Walking the memory one line at a time doubles the number of lines read
+  // ahead on every miss.
+  const uint32_t num_lines = 64;
+  for (uint32_t i = 0; i < num_lines; ++i)
+    ASSERT_TRUE(
+        ReadAndCheck(cache, DummyProcess::kMemoryBase + i * line_size, 8));
+
+  MemoryCache::Statistics stats = cache.GetStatistics();
+  EXPECT_LT(stats.process_reads, 10u);
+  EXPECT_EQ(stats.process_reads, stats.misses);
+  EXPECT_LE(num_lines, stats.misses + stats.prefetched_lines);
+  EXPECT_EQ(num_lines - stats.misses, stats.hits);
+
+  // A read far away from the previous ones starts over with a single line.
+  const uint64_t bytes_read = stats.process_bytes_read;
+  ASSERT_TRUE(ReadAndCheck(cache, DummyProcess::kMemoryBase + 0xfe00, 8));
+  EXPECT_EQ(bytes_read + line_size, cache.GetStatistics().process_bytes_read);
+}
+
+TEST_F(MemoryCacheTest, EvictLeastRecentlyUsed) {
+  ASSERT_TRUE(m_target_sp);
+  ListenerSP listener_sp(Listener::MakeListener("dummy"));
+  auto process_sp = std::make_shared<DummyProcess>(m_target_sp, listener_sp);
+  const addr_t line_size = process_sp->GetMemoryCacheLineSize();
+  ASSERT_TRUE(process_sp
+                  ->SetPropertyValue(nullptr, eVarSetOperationAssign,
+                                     "memory-cache-max-byte-size",
+                                     std::to_string(4 * line_size))
+                  .Success());
+  MemoryCache cache(*process_sp);
+
+  // Reads larger than a quarter of the cache are not cached.
+  EXPECT_TRUE(ReadAndCheck(cache, DummyProcess::kMemoryBase, 2 * line_size));
+  EXPECT_EQ(0u, cache.GetStatistics().misses);
+
+  const addr_t base = DummyProcess::kMemoryBase + 0x1000;
+  for (addr_t i = 0; i < 4; ++i)
+    ASSERT_TRUE(ReadAndCheck(cache, base + i * 2 * line_size, 8));
+  EXPECT_EQ(0u, cache.GetStatistics().evictions);
+
+  // Using the first line makes the second one the least recently used.
+  const uint32_t num_reads = process_sp->m_num_reads;
+  ASSERT_TRUE(ReadAndCheck(cache, base, 8));
+  ASSERT_TRUE(ReadAndCheck(cache, base + 0x2000, 8));
+  EXPECT_EQ(num_reads + 1, process_sp->m_num_reads);
+  EXPECT_EQ(1u, cache.GetStatistics().evictions);
+
+  ASSERT_TRUE(ReadAndCheck(cache, base, 8));
+  EXPECT_EQ(num_reads + 1, process_sp->m_num_reads);
+  ASSERT_TRUE(ReadAndCheck(cache, base + 2 * line_size, 8));
+  EXPECT_EQ(num_reads + 2, process_sp->m_num_reads);
+}
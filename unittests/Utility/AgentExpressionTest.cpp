@@ -0,0 +1,140 @@
+//===-- AgentExpressionTest.cpp ---------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Utility/AgentExpression.h"
+#include "llvm/Testing/Support/Error.h"
+
+#include <map>
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+struct FakeTarget {
+  std::map<uint32_t, uint64_t> registers;
+  std::map<addr_t, uint64_t> memory;
+
+  llvm::Expected<uint64_t> Evaluate(const AgentExpression &expr) {
+    return expr.Evaluate(
+        [this](uint32_t reg_num) -> llvm::Expected<uint64_t> {
+          auto pos = registers.find(reg_num);
+          if (pos == registers.end())
+            return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                           "bad register");
+          return pos->second;
+        },
+        [this](addr_t addr, uint32_t size) -> llvm::Expected<uint64_t> {
+          auto pos = memory.find(addr);
+          if (pos == memory.end())
+            return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                           "bad address");
+          if (size == 8)
+            return pos->second;
+          return pos->second & ((1ull << (size * 8)) - 1);
+        });
+  }
+};
+} // namespace
+
+static AgentExpression Binary(uint64_t a, uint64_t b,
+                              AgentExpression::Opcode op) {
+  AgentExpression expr;
+  expr.AppendConstant(a);
+  expr.AppendConstant(b);
+  expr.AppendOpcode(op);
+  expr.AppendOpcode(AgentExpression::eOpEnd);
+  return expr;
+}
+
+TEST(AgentExpressionTest, AppendConstant) {
+  AgentExpression expr;
+  expr.AppendConstant(0x12);
+  expr.AppendConstant(0x1234);
+  expr.AppendConstant(0x12345678);
+  expr.AppendConstant(0x123456789aull);
+  EXPECT_EQ(
+      std::vector<uint8_t>({0x22, 0x12, 0x23, 0x12, 0x34, 0x24, 0x12, 0x34,
+                            0x56, 0x78, 0x25, 0x00, 0x00, 0x00, 0x12, 0x34,
+                            0x56, 0x78, 0x9a}),
+      expr.GetBytecode().vec());
+}
+
+TEST(AgentExpressionTest, Arithmetic) {
+  FakeTarget target;
+  EXPECT_THAT_EXPECTED(target.Evaluate(Binary(3, 4, AgentExpression::eOpAdd)),
+                       llvm::HasValue(7u));
+  EXPECT_THAT_EXPECTED(target.Evaluate(Binary(3, 4, AgentExpression::eOpSub)),
+                       llvm::HasValue(uint64_t(-1)));
+  EXPECT_THAT_EXPECTED(target.Evaluate(Binary(3, 4, AgentExpression::eOpMul)),
+                       llvm::HasValue(12u));
+  EXPECT_THAT_EXPECTED(
+      target.Evaluate(Binary(uint64_t(-7), 2, AgentExpression::eOpDivSigned)),
+      llvm::HasValue(uint64_t(-3)));
+  EXPECT_THAT_EXPECTED(
+      target.Evaluate(Binary(1999, 1000, AgentExpression::eOpRemUnsigned)),
+      llvm::HasValue(999u));
+  EXPECT_THAT_EXPECTED(
+      target.Evaluate(Binary(uint64_t(-1), 0, AgentExpression::eOpLessSigned)),
+      llvm::HasValue(1u));
+  EXPECT_THAT_EXPECTED(
+      target.Evaluate(
+          Binary(uint64_t(-1), 0, AgentExpression::eOpLessUnsigned)),
+      llvm::HasValue(0u));
+  EXPECT_THAT_EXPECTED(
+      target.Evaluate(Binary(1, 0, AgentExpression::eOpDivUnsigned)),
+      llvm::Failed());
+}
+
+TEST(AgentExpressionTest, RegistersAndMemory) {
+  FakeTarget target;
+  target.registers[7] = 0x1000;
+  target.memory[0x1010] = 0xfffffffe;
+
+  // *(int *)($r7 + 0x10) == -2
+  AgentExpression expr;
+  expr.AppendRegister(7);
+  expr.AppendConstant(0x10);
+  expr.AppendOpcode(AgentExpression::eOpAdd);
+  ASSERT_TRUE(expr.AppendMemoryRead(4, true));
+  expr.AppendConstant(uint64_t(-2));
+  expr.AppendOpcode(AgentExpression::eOpEqual);
+  expr.AppendOpcode(AgentExpression::eOpEnd);
+  EXPECT_THAT_EXPECTED(target.Evaluate(expr), llvm::HasValue(1u));
+
+  EXPECT_FALSE(expr.AppendMemoryRead(3, false));
+
+  AgentExpression bad_reg;
+  bad_reg.AppendRegister(8);
+  bad_reg.AppendOpcode(AgentExpression::eOpEnd);
+  EXPECT_THAT_EXPECTED(target.Evaluate(bad_reg), llvm::Failed());
+}
+
+TEST(AgentExpressionTest, Branches) {
+  FakeTarget target;
+  // if (1) goto 7; push 1; end; 7: push 2; end
+  AgentExpression expr(
+      {0x22, 0x01, 0x20, 0x00, 0x08, 0x22, 0x01, 0x27, 0x22, 0x02, 0x27});
+  EXPECT_THAT_EXPECTED(target.Evaluate(expr), llvm::HasValue(2u));
+
+  // An infinite loop is stopped eventually.
+  AgentExpression loop({0x21, 0x00, 0x00});
+  EXPECT_THAT_EXPECTED(target.Evaluate(loop), llvm::Failed());
+}
+
+TEST(AgentExpressionTest, Malformed) {
+  FakeTarget target;
+  EXPECT_THAT_EXPECTED(target.Evaluate(AgentExpression()), llvm::Failed());
+  EXPECT_THAT_EXPECTED(target.Evaluate(AgentExpression({0x27})),
+                       llvm::Failed());
+  EXPECT_THAT_EXPECTED(target.Evaluate(AgentExpression({0x24, 0x01})),
+                       llvm::Failed());
+  EXPECT_THAT_EXPECTED(target.Evaluate(AgentExpression({0x22, 0x01, 0xff})),
+                       llvm::Failed());
+}
@@ -7,9 +7,16 @@
 //===----------------------------------------------------------------------===//
 
 #include "lldb/Utility/ConstString.h"
+#include "llvm/Object/ELFObjectFile.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
 
+#include <chrono>
+#include <string>
+#include <thread>
+
 using namespace lldb_private;
 
 TEST(ConstStringTest, format_provider) {
@@ -137,3 +144,176 @@ TEST(ConstStringTest, CompareStringRef) {
   EXPECT_TRUE(null == static_cast<const char *>(nullptr));
   EXPECT_TRUE(null != "bar");
 }
+
+TEST(ConstStringTest, FromStrings) {
+  const char *buffer = "abcabc";
+  std::vector<llvm::StringRef> strings = {
+      "foo", llvm::StringRef(buffer, 3), "", llvm::StringRef(),
+      llvm::StringRef(buffer + 3, 3), "foo"};
+  std::vector<ConstString> interned = ConstString::FromStrings(strings);
+  ASSERT_EQ(strings.size(), interned.size());
+
+  EXPECT_EQ(ConstString("foo"), interned[0]);
+  EXPECT_EQ(ConstString("abc"), interned[1]);
+  EXPECT_EQ(ConstString(""), interned[2]);
+  EXPECT_TRUE(interned[3].IsNull());
+  EXPECT_EQ(interned[1].GetCString(), interned[4].GetCString());
+  EXPECT_EQ(interned[0].GetCString(), interned[5].GetCString());
+
+  EXPECT_TRUE(ConstString::FromStrings({}).empty());
+}
+
+TEST(ConstStringTest, Batch) {
+  ConstStringBatch batch;
+  EXPECT_TRUE(batch.IsEmpty());
+  EXPECT_EQ(0u, batch.Add("batch_first"));
+  EXPECT_EQ(1u, batch.Add("batch_second"));
+  EXPECT_EQ(2u, batch.Add("batch_first"));
+  EXPECT_EQ(3u, batch.GetSize());
+
+  std::vector<ConstString> interned = batch.Flush();
+  EXPECT_TRUE(batch.IsEmpty());
+  ASSERT_EQ(3u, interned.size());
+  EXPECT_EQ(ConstString("batch_first"), interned[0]);
+  EXPECT_EQ(ConstString("batch_second"), interned[1]);
+  EXPECT_EQ(interned[0], interned[2]);
+
+  EXPECT_EQ(0u, batch.Add("batch_third"));
+  interned = batch.Flush();
+  ASSERT_EQ(1u, interned.size());
+  EXPECT_EQ(ConstString("batch_third"), interned[0]);
+}
+
+TEST(ConstStringTest, PoolStatistics) {
+  // The strings must be new to the pool every time the test runs.
+  static unsigned g_run = 0;
+  const std::string suffix = std::to_string(g_run++);
+  const std::string new_string = "pool_statistics_new_string" + suffix;
+  const std::string batch_a = "pool_statistics_batch_a" + suffix;
+  const std::string batch_b = "pool_statistics_batch_b" + suffix;
+
+  ConstString::PoolStatistics before = ConstString::GetPoolStatistics();
+  ConstString(new_string.c_str());
+  ConstString(new_string.c_str());
+  ConstString::FromStrings({batch_a, batch_b, new_string});
+  ConstString::PoolStatistics after = ConstString::GetPoolStatistics();
+
+  EXPECT_EQ(before.lookups + 5, after.lookups);
+  EXPECT_EQ(before.insertions + 3, after.insertions);
+  EXPECT_EQ(before.num_strings + 3, after.num_strings);
+  EXPECT_LT(before.memory_size, after.memory_size);
+  EXPECT_LT(before.lock_acquisitions, after.lock_acquisitions);
+}
+
+TEST(ConstStringTest, PoolStatisticsOfOtherThreads) {
+  static unsigned g_run = 0;
+  const std::string name = "pool_statistics_thread" + std::to_string(g_run++);
+
+  // The counts of a thread stay in the totals after it exits.
+  ConstString::PoolStatistics before = ConstString::GetPoolStatistics();
+  std::thread([&name]() { ConstString(name.c_str()); }).join();
+  ConstString::PoolStatistics after = ConstString::GetPoolStatistics();
+
+  EXPECT_EQ(before.lookups + 1, after.lookups);
+  EXPECT_EQ(before.insertions + 1, after.insertions);
+}
+
+// Returns the names in the symbol tables of the ELF file at \a path.
+static std::vector<std::string> ReadELFSymbolNames(llvm::StringRef path) {
+  std::vector<std::string> names;
+  auto binary = llvm::object::ObjectFile::createObjectFile(path);
+  if (!binary) {
+    llvm::consumeError(binary.takeError());
+    return names;
+  }
+  auto *elf =
+      llvm::dyn_cast<llvm::object::ELFObjectFileBase>(binary->getBinary());
+  if (!elf)
+    return names;
+  auto add_names = [&names](
+      llvm::object::ELFObjectFileBase::elf_symbol_iterator_range symbols) {
+    for (const llvm::object::ELFSymbolRef &symbol : symbols) {
+      llvm::Expected<llvm::StringRef> name = symbol.getName();
+      if (!name)
+        llvm::consumeError(name.takeError());
+      else if (!name->empty())
+        names.push_back(name->str());
+    }
+  };
+  add_names(elf->symbols());
+  add_names(elf->getDynamicSymbolIterators());
+  return names;
+}
+
+// Compares interning the names of the symbol tables of real ELF files one by
+// one to interning them in batches from several threads, like the DWARF
+// indexer does. The files are read from the colon separated list in
+// LLDB_CONSTSTRING_BENCHMARK_FILES, this test binary by default.
+TEST(ConstStringTest, DISABLED_BenchmarkFromStrings) {
+  static int g_main_address;
+  std::string files =
+      llvm::sys::fs::getMainExecutable(nullptr, &g_main_address);
+  if (const char *env = getenv("LLDB_CONSTSTRING_BENCHMARK_FILES"))
+    files = env;
+  llvm::SmallVector<llvm::StringRef, 8> paths;
+  llvm::StringRef(files).split(paths, ':', -1, false);
+  std::vector<std::string> symbol_names;
+  for (llvm::StringRef path : paths) {
+    std::vector<std::string> names = ReadELFSymbolNames(path);
+    symbol_names.insert(symbol_names.end(), names.begin(), names.end());
+  }
+  ASSERT_FALSE(symbol_names.empty()) << "no ELF symbols in " << files;
+
+  const size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+  const size_t strings_per_thread =
+      (symbol_names.size() + num_threads - 1) / num_threads;
+  const size_t batch_size = 1000;
+
+  // Every pass gets its own prefix so that all of its strings are new to the
+  // pool, like they are when a module is loaded for the first time.
+  auto measure = [&](const char *prefix, auto intern_fn) {
+    std::vector<std::vector<std::string>> names(num_threads);
+    for (size_t i = 0; i < symbol_names.size(); ++i)
+      names[i / strings_per_thread].push_back(prefix + symbol_names[i]);
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < num_threads; ++t)
+      threads.emplace_back([&, t]() {
+        for (size_t i = 0; i < names[t].size(); i += batch_size) {
+          size_t end = std::min(names[t].size(), i + batch_size);
+          std::vector<llvm::StringRef> batch(names[t].begin() + i,
+                                             names[t].begin() + end);
+          intern_fn(batch);
+        }
+      });
+    for (std::thread &thread : threads)
+      thread.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                         start)
+        .count();
+  };
+
+  ConstString::PoolStatistics before = ConstString::GetPoolStatistics();
+  double single_seconds =
+      measure("single:", [](llvm::ArrayRef<llvm::StringRef> strings) {
+        for (llvm::StringRef s : strings)
+          ConstString cs(s);
+      });
+  ConstString::PoolStatistics middle = ConstString::GetPoolStatistics();
+  double batch_seconds =
+      measure("batch:", [](llvm::ArrayRef<llvm::StringRef> strings) {
+        ConstString::FromStrings(strings);
+      });
+  ConstString::PoolStatistics after = ConstString::GetPoolStatistics();
+
+  llvm::outs() << llvm::formatv(
+      "{0} symbol names from {1} files on {2} threads\n"
+      "one by one: {3:f3} sec, {4} lock acquisitions, {5} contentions\n"
+      "batched:    {6:f3} sec, {7} lock acquisitions, {8} contentions\n",
+      symbol_names.size(), paths.size(), num_threads, single_seconds,
+      middle.lock_acquisitions - before.lock_acquisitions,
+      middle.lock_contentions - before.lock_contentions, batch_seconds,
+      after.lock_acquisitions - middle.lock_acquisitions,
+      after.lock_contentions - middle.lock_contentions);
+}
@@ -0,0 +1,79 @@
+//===-- LZ4Test.cpp ---------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Utility/LZ4.h"
+#include "llvm/Testing/Support/Error.h"
+
+#include <string>
+
+using namespace lldb_private;
+
+static std::vector<uint8_t> RoundTrip(llvm::ArrayRef<uint8_t> input) {
+  std::vector<uint8_t> compressed;
+  lz4::Compress(input, compressed);
+  std::vector<uint8_t> output(input.size());
+  llvm::Expected<size_t> size = lz4::Decompress(compressed, output);
+  EXPECT_THAT_EXPECTED(size, llvm::HasValue(input.size()));
+  return output;
+}
+
+TEST(LZ4Test, RoundTrip) {
+  std::vector<uint8_t> empty;
+  EXPECT_EQ(empty, RoundTrip(empty));
+
+  std::vector<uint8_t> small = {'a', 'b', 'c'};
+  EXPECT_EQ(small, RoundTrip(small));
+
+  // Long runs exercise the overlapping matches and the length continuation
+  // bytes.
+  std::vector<uint8_t> zeros(100000, 0);
+  EXPECT_EQ(zeros, RoundTrip(zeros));
+
+  std::vector<uint8_t> mixed;
+  for (uint32_t i = 0; i < 70000; ++i)
+    mixed.push_back(i % 7 == 0 ? (i * 2654435761u) >> 24 : 'x' + i % 3);
+  EXPECT_EQ(mixed, RoundTrip(mixed));
+}
+
+TEST(LZ4Test, CompressesRepetitiveData) {
+  std::string json;
+  for (int i = 0; i < 1000; ++i)
+    json += "{\"tid\":" + std::to_string(1000 + i) + ",\"reason\":\"signal\"},";
+  std::vector<uint8_t> input(json.begin(), json.end());
+  std::vector<uint8_t> compressed;
+  lz4::Compress(input, compressed);
+  EXPECT_LT(compressed.size(), input.size() / 4);
+}
+
+TEST(LZ4Test, Decompress) {
+  // One literal 'a' followed by a match of length 6 at offset 1, then the
+  // final five literals.
+  std::vector<uint8_t> block = {0x12, 'a', 1, 0, 0x50, 'b', 'c', 'd', 'e', 'f'};
+  std::vector<uint8_t> output(12);
+  EXPECT_THAT_EXPECTED(lz4::Decompress(block, output), llvm::HasValue(12u));
+  EXPECT_EQ(std::string("aaaaaaabcdef"),
+            std::string(output.begin(), output.end()));
+}
+
+TEST(LZ4Test, DecompressMalformed) {
+  std::vector<uint8_t> output(16);
+
+  // The offset points before the start of the output.
+  std::vector<uint8_t> bad_offset = {0x10, 'a', 2, 0, 0x00};
+  EXPECT_THAT_EXPECTED(lz4::Decompress(bad_offset, output), llvm::Failed());
+
+  // The literals run past the end of the input.
+  std::vector<uint8_t> truncated = {0x40, 'a', 'b'};
+  EXPECT_THAT_EXPECTED(lz4::Decompress(truncated, output), llvm::Failed());
+
+  // The output doesn't fit.
+  std::vector<uint8_t> too_long = {0x1f, 'a', 1, 0, 20};
+  EXPECT_THAT_EXPECTED(lz4::Decompress(too_long, output), llvm::Failed());
+}